@@ -230,6 +230,18 @@ else ()
   add_definitions (-DWASM_ENABLE_BULK_MEMORY=0)
   message ("     Bulk memory feature disabled")
 endif ()
+if (NOT DEFINED WAMR_BUILD_QUICK_AOT_ENTRY)
+  # Enable quick AOT entry by default, which adds the entry stubs and
+  # the export hash index to the default builds
+  set (WAMR_BUILD_QUICK_AOT_ENTRY 1)
+endif ()
+if (WAMR_BUILD_QUICK_AOT_ENTRY EQUAL 1)
+  add_definitions (-DWASM_ENABLE_QUICK_AOT_ENTRY=1)
+  message ("     Quick AOT entry enabled")
+else ()
+  add_definitions (-DWASM_ENABLE_QUICK_AOT_ENTRY=0)
+  message ("     Quick AOT entry disabled")
+endif ()
 if (WAMR_BUILD_SHARED_MEMORY EQUAL 1)
   add_definitions (-DWASM_ENABLE_SHARED_MEMORY=1)
   message ("     Shared memory enabled")
@@ -296,6 +308,14 @@ if (WAMR_BUILD_JIT_STACK_FRAME EQUAL 1)
   add_definitions (-DWASM_ENABLE_JIT_STACK_FRAME=1)
   message ("     JIT stack frame enabled")
 endif ()
+if (WAMR_BUILD_IO_URING EQUAL 1)
+  if (WAMR_BUILD_PLATFORM STREQUAL "linux")
+    add_definitions (-DWASM_ENABLE_IO_URING=1)
+    message ("     io_uring for WASI I/O enabled")
+  else ()
+    message ("     io_uring for WASI I/O disabled, only supported on Linux")
+  endif ()
+endif ()
 if (WAMR_BUILD_CHECKPOINT_RESTORE EQUAL 1)
   add_definitions (-DWASM_ENABLE_CHECKPOINT_RESTORE=1)
   message ("     Checkpoint Restore enabled")
@@ -398,6 +418,14 @@ if (WAMR_BUILD_WASI_NN EQUAL 1)
       message ("     WASI-NN: External Delegation enabled")
       add_definitions (-DWASM_ENABLE_WASI_NN_EXTERNAL_DELEGATE=1)
   endif ()
+  if (WAMR_BUILD_WASI_NN_ZERO_COPY EQUAL 1)
+      message ("     WASI-NN: Zero-copy input tensors enabled (experimental, untested)")
+      add_definitions (-DWASM_ENABLE_WASI_NN_ZERO_COPY=1)
+  endif ()
+  if (WAMR_BUILD_WASI_NN_BATCHING EQUAL 1)
+      message ("     WASI-NN: Request batching enabled (experimental, untested)")
+      add_definitions (-DWASM_ENABLE_WASI_NN_BATCHING=1)
+  endif ()
   if (DEFINED WAMR_BUILD_WASI_NN_EXTERNAL_DELEGATE_PATH)
       add_definitions (-DWASM_WASI_NN_EXTERNAL_DELEGATE_PATH="${WAMR_BUILD_WASI_NN_EXTERNAL_DELEGATE_PATH}")
   endif ()
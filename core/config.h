@@ -70,6 +70,12 @@
 #define WASM_ENABLE_AOT 0
 #endif
 
+/* Call the AOT functions of the common signatures from the runtime with
+   precompiled entry stubs instead of the generic invokeNative */
+#ifndef WASM_ENABLE_QUICK_AOT_ENTRY
+#define WASM_ENABLE_QUICK_AOT_ENTRY 1
+#endif
+
 #ifndef WASM_ENABLE_WORD_ALIGN_READ
 #define WASM_ENABLE_WORD_ALIGN_READ 0
 #endif
@@ -103,6 +109,16 @@
 #error "WASM_ORC_JIT_COMPILE_THREAD_NUM must be greater than 0"
 #endif
 
+/* The number of calls and loop iterations counted by the Fast JIT jitted
+   code of a function before it is compiled by the LLVM JIT tier-up */
+#ifndef LLVM_JIT_TIERUP_THRESHOLD
+#define LLVM_JIT_TIERUP_THRESHOLD 1000
+#endif
+
+#if LLVM_JIT_TIERUP_THRESHOLD < 1
+#error "LLVM_JIT_TIERUP_THRESHOLD must be greater than 0"
+#endif
+
 #if (WASM_ENABLE_AOT == 0) && (WASM_ENABLE_JIT != 0)
 /* LLVM JIT can only be enabled when AOT is enabled */
 #undef WASM_ENABLE_JIT
@@ -120,10 +136,39 @@
 #define WASM_ENABLE_FAST_JIT_DUMP 0
 #endif
 
+/* Persistent Fast JIT code cache on the disk */
+#ifndef WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE
+#define WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE 0
+#endif
+
+/* Tier up the functions run by the classic interpreter to the Fast JIT,
+   and enter the jitted code at the loop headers (on-stack replacement) */
+#ifndef WASM_ENABLE_FAST_JIT_OSR
+#define WASM_ENABLE_FAST_JIT_OSR 0
+#endif
+
+/* The number of loop back-edges taken by the interpreter in a function
+   before the function is compiled and run with the Fast JIT */
+#ifndef FAST_JIT_OSR_THRESHOLD
+#define FAST_JIT_OSR_THRESHOLD 10000
+#endif
+
+/* The max number of hot functions waiting to be compiled by the Fast JIT
+   compilation threads before the other functions */
+#ifndef FAST_JIT_OSR_HOT_FUNC_NUM
+#define FAST_JIT_OSR_HOT_FUNC_NUM 16
+#endif
+
 #ifndef FAST_JIT_DEFAULT_CODE_CACHE_SIZE
 #define FAST_JIT_DEFAULT_CODE_CACHE_SIZE 10 * 1024 * 1024
 #endif
 
+/* The Fast JIT code cache grows with chunks of this size until it reaches
+   the code cache size */
+#ifndef FAST_JIT_CODE_CACHE_CHUNK_SIZE
+#define FAST_JIT_CODE_CACHE_CHUNK_SIZE 1024 * 1024
+#endif
+
 #ifndef WASM_ENABLE_WAMR_COMPILER
 #define WASM_ENABLE_WAMR_COMPILER 0
 #endif
@@ -152,6 +197,25 @@
 #define WASM_ENABLE_WASI_NN_EXTERNAL_DELEGATE 0
 #endif
 
+#ifndef WASM_ENABLE_WASI_NN_ZERO_COPY
+#define WASM_ENABLE_WASI_NN_ZERO_COPY 0
+#endif
+
+#ifndef WASM_ENABLE_WASI_NN_BATCHING
+#define WASM_ENABLE_WASI_NN_BATCHING 0
+#endif
+
+/* Maximum number of wasi-nn computes merged into one inference */
+#ifndef WASM_WASI_NN_MAX_BATCH_SIZE
+#define WASM_WASI_NN_MAX_BATCH_SIZE 8
+#endif
+
+/* Maximum time in microseconds a wasi-nn compute waits for other
+   computes of the same model to batch with */
+#ifndef WASM_WASI_NN_BATCH_DELAY_US
+#define WASM_WASI_NN_BATCH_DELAY_US 1000
+#endif
+
 /* Default disable libc emcc */
 #ifndef WASM_ENABLE_LIBC_EMCC
 #define WASM_ENABLE_LIBC_EMCC 0
@@ -1181,6 +1181,10 @@ load_func_types(const uint8 **p_buf, const uint8 *buf_end, AOTModule *module,
 
         func_types[i]->param_cell_num = (uint16)param_cell_num;
         func_types[i]->ret_cell_num = (uint16)ret_cell_num;
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+        func_types[i]->quick_aot_entry =
+            (void *)aot_lookup_quick_entry(func_types[i]);
+#endif
     }
 
     *p_buf = buf;
@@ -1653,6 +1657,26 @@ fail:
     return false;
 }
 
+/* Get the pages of the aot text, which starts in the middle of a page
+   when it is mapped from the aot file */
+static uint8 *
+get_text_pages(AOTModule *module, uint8 *text, uint32 *p_size)
+{
+#ifdef OS_ENABLE_MMAP_FILE
+    uint32 page_offset;
+
+    if (module->file_map) {
+        page_offset =
+            (uint32)((uintptr_t)text & ((uintptr_t)os_getpagesize() - 1));
+        *p_size += page_offset;
+        return text - page_offset;
+    }
+#endif
+    (void)module;
+    (void)p_size;
+    return text;
+}
+
 static bool
 load_text_section(const uint8 *buf, const uint8 *buf_end, AOTModule *module,
                   char *error_buf, uint32 error_buf_size)
@@ -1861,6 +1885,12 @@ load_export_section(const uint8 *buf, const uint8 *buf_end, AOTModule *module,
                          error_buf_size))
         return false;
 
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+    if (module->export_count > 0
+        && !aot_create_export_func_hash(module, error_buf, error_buf_size))
+        return false;
+#endif
+
     if (p != p_end) {
         set_error_buf(error_buf, error_buf_size, "invalid export section size");
         return false;
@@ -2725,9 +2755,10 @@ load_relocation_section(const uint8 *buf, const uint8 *buf_end,
 
     if (module->code) {
         /* The layout is: literal size + literal + code (with plt table) */
-        uint8 *mmap_addr = module->literal - sizeof(uint32);
         uint32 total_size =
             sizeof(uint32) + module->literal_size + module->code_size;
+        uint8 *mmap_addr =
+            get_text_pages(module, module->literal - sizeof(uint32), &total_size);
         os_mprotect(mmap_addr, total_size, map_prot);
     }
 
@@ -2979,6 +3010,15 @@ create_module(char *error_buf, uint32 error_buf_size)
 #endif
     (void)ret;
 
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+    if (os_mutex_init(&module->checkpoint_profile_lock) != 0) {
+        set_error_buf(error_buf, error_buf_size,
+                      "init checkpoint profile lock failed");
+        wasm_runtime_free(module);
+        return NULL;
+    }
+#endif
+
     return module;
 }
 
@@ -3002,15 +3042,21 @@ aot_load_from_sections(AOTSection *section_list, char *error_buf,
 }
 
 static void
-destroy_sections(AOTSection *section_list, bool destroy_aot_text)
+destroy_sections(AOTModule *module, AOTSection *section_list,
+                 bool destroy_aot_text)
 {
     AOTSection *section = section_list, *next;
+    uint32 size;
+
     while (section) {
         next = section->next;
         if (destroy_aot_text && section->section_type == AOT_SECTION_TYPE_TEXT
-            && section->section_body)
-            os_munmap((uint8 *)section->section_body,
-                      section->section_body_size);
+            && section->section_body) {
+            size = section->section_body_size;
+            os_munmap(get_text_pages(module, (uint8 *)section->section_body,
+                                     &size),
+                      size);
+        }
         wasm_runtime_free(section);
         section = next;
     }
@@ -3056,10 +3102,42 @@ fail:
     return false;
 }
 
+#ifdef OS_ENABLE_MMAP_FILE
+/* Map the text section from the aot file, followed by anonymous pages up
+   to total_size for the plt table, so that only the pages written by the
+   relocations are copied and the others are shared with the page cache */
+static uint8 *
+map_text_section(os_file_handle file, uint64 offset, uint32 section_size,
+                 uint32 total_size, int map_prot, int map_flags)
+{
+    uint64 page_size = (uint64)os_getpagesize();
+    uint32 page_offset = (uint32)(offset & (page_size - 1));
+    uint64 map_size = (uint64)page_offset + total_size;
+    uint64 file_map_size =
+        ((uint64)page_offset + section_size + page_size - 1)
+        & ~(page_size - 1);
+    uint8 *map_addr;
+
+    if (map_size >= UINT32_MAX
+        || !(map_addr = os_mmap(NULL, (uint32)map_size, map_prot, map_flags,
+                                os_get_invalid_handle())))
+        return NULL;
+
+    if (!os_mmap_file(map_addr, (size_t)file_map_size, map_prot,
+                      map_flags | MMAP_MAP_FIXED, file,
+                      offset - page_offset)) {
+        os_munmap(map_addr, (uint32)map_size);
+        return NULL;
+    }
+
+    return map_addr + page_offset;
+}
+#endif
+
 static bool
 create_sections(AOTModule *module, const uint8 *buf, uint32 size,
-                AOTSection **p_section_list, char *error_buf,
-                uint32 error_buf_size)
+                os_file_handle file, AOTSection **p_section_list,
+                char *error_buf, uint32 error_buf_size)
 {
     AOTSection *section_list = NULL, *section_list_end = NULL, *section;
     const uint8 *p = buf, *p_end = buf + size;
@@ -3079,6 +3157,9 @@ create_sections(AOTModule *module, const uint8 *buf, uint32 size,
     }
 
     module->is_indirect_mode = is_indirect_mode;
+#ifndef OS_ENABLE_MMAP_FILE
+    (void)file;
+#endif
 
     p += 8;
     while (p < p_end) {
@@ -3114,14 +3195,31 @@ create_sections(AOTModule *module, const uint8 *buf, uint32 size,
                     total_size =
                         (uint64)section_size + aot_get_plt_table_size();
                     total_size = (total_size + 3) & ~((uint64)3);
-                    if (total_size >= UINT32_MAX
-                        || !(aot_text =
-                                 os_mmap(NULL, (uint32)total_size, map_prot,
-                                         map_flags, os_get_invalid_handle()))) {
-                        wasm_runtime_free(section);
-                        set_error_buf(error_buf, error_buf_size,
-                                      "mmap memory failed");
-                        goto fail;
+#ifdef OS_ENABLE_MMAP_FILE
+                    if (module->file_map) {
+                        if (total_size >= UINT32_MAX
+                            || !(aot_text = map_text_section(
+                                     file, (uint64)(p - buf), section_size,
+                                     (uint32)total_size, map_prot,
+                                     map_flags))) {
+                            wasm_runtime_free(section);
+                            set_error_buf(error_buf, error_buf_size,
+                                          "mmap aot file failed");
+                            goto fail;
+                        }
+                    }
+                    else
+#endif
+                    {
+                        if (total_size >= UINT32_MAX
+                            || !(aot_text = os_mmap(
+                                     NULL, (uint32)total_size, map_prot,
+                                     map_flags, os_get_invalid_handle()))) {
+                            wasm_runtime_free(section);
+                            set_error_buf(error_buf, error_buf_size,
+                                          "mmap memory failed");
+                            goto fail;
+                        }
                     }
 #if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64)
 #if !defined(BH_PLATFORM_LINUX_SGX) && !defined(BH_PLATFORM_WINDOWS) \
@@ -3139,8 +3237,15 @@ create_sections(AOTModule *module, const uint8 *buf, uint32 size,
                                 section->section_body, (uint32)section_size);
                     os_dcache_flush();
 #else
-                    bh_memcpy_s(aot_text, (uint32)total_size,
-                                section->section_body, (uint32)section_size);
+#ifdef OS_ENABLE_MMAP_FILE
+                    /* The text is already mapped from the file */
+                    if (!module->file_map)
+#endif
+                    {
+                        bh_memcpy_s(aot_text, (uint32)total_size,
+                                    section->section_body,
+                                    (uint32)section_size);
+                    }
 #endif
                     section->section_body = aot_text;
                     destroy_aot_text = true;
@@ -3177,20 +3282,28 @@ create_sections(AOTModule *module, const uint8 *buf, uint32 size,
     return true;
 fail:
     if (section_list)
-        destroy_sections(section_list, destroy_aot_text);
+        destroy_sections(module, section_list, destroy_aot_text);
     return false;
 }
 
 static bool
-load(const uint8 *buf, uint32 size, AOTModule *module, char *error_buf,
-     uint32 error_buf_size)
+load(const uint8 *buf, uint32 size, AOTModule *module, os_file_handle file,
+     char *error_buf, uint32 error_buf_size)
 {
     const uint8 *buf_end = buf + size;
     const uint8 *p = buf, *p_end = buf_end;
     uint32 magic_number, version;
     AOTSection *section_list = NULL;
+    bool is_load_from_file_buf = true;
     bool ret;
 
+#ifdef OS_ENABLE_MMAP_FILE
+    /* The pages of the text may be set read only when running it in place,
+       don't adjust the strings in the mapped file */
+    if (module->file_map)
+        is_load_from_file_buf = false;
+#endif
+
     read_uint32(p, p_end, magic_number);
     if (magic_number != AOT_MAGIC_NUMBER) {
         set_error_buf(error_buf, error_buf_size, "magic header not detected");
@@ -3203,23 +3316,24 @@ load(const uint8 *buf, uint32 size, AOTModule *module, char *error_buf,
         return false;
     }
 
-    if (!create_sections(module, buf, size, &section_list, error_buf,
+    if (!create_sections(module, buf, size, file, &section_list, error_buf,
                          error_buf_size))
         return false;
 
-    ret = load_from_sections(module, section_list, true, error_buf,
-                             error_buf_size);
+    ret = load_from_sections(module, section_list, is_load_from_file_buf,
+                             error_buf, error_buf_size);
     if (!ret) {
         /* If load_from_sections() fails, then aot text is destroyed
            in destroy_sections() */
-        destroy_sections(section_list, module->is_indirect_mode ? false : true);
+        destroy_sections(module, section_list,
+                         module->is_indirect_mode ? false : true);
         /* aot_unload() won't destroy aot text again */
         module->code = NULL;
     }
     else {
         /* If load_from_sections() succeeds, then aot text is set to
            module->code and will be destroyed in aot_unload() */
-        destroy_sections(section_list, false);
+        destroy_sections(module, section_list, false);
     }
 
 #if 0
@@ -3246,7 +3360,8 @@ aot_load_from_aot_file(const uint8 *buf, uint32 size, char *error_buf,
         return NULL;
 
     os_thread_jit_write_protect_np(false); /* Make memory writable */
-    if (!load(buf, size, module, error_buf, error_buf_size)) {
+    if (!load(buf, size, module, os_get_invalid_handle(), error_buf,
+              error_buf_size)) {
         aot_unload(module);
         return NULL;
     }
@@ -3257,6 +3372,75 @@ aot_load_from_aot_file(const uint8 *buf, uint32 size, char *error_buf,
     return module;
 }
 
+#ifdef OS_ENABLE_MMAP_FILE
+AOTModule *
+aot_load_from_aot_file_mapped(const char *file_path, char *error_buf,
+                              uint32 error_buf_size)
+{
+    AOTModule *module;
+    os_file_handle file;
+    uint64 file_size;
+    uint8 *file_map;
+#if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64) \
+    || defined(BUILD_TARGET_RISCV64_LP64D)                       \
+    || defined(BUILD_TARGET_RISCV64_LP64)
+    /* the code of indirect mode runs in place, it must be in range 0 to 2G
+       as the text mapped from the file */
+    int map_flags = MMAP_MAP_32BIT;
+#else
+    int map_flags = MMAP_MAP_NONE;
+#endif
+    bool ret;
+
+    file = os_mmap_file_open(file_path, &file_size);
+    if (file == os_get_invalid_handle()) {
+        set_error_buf_v(error_buf, error_buf_size, "open aot file %s failed",
+                        file_path);
+        return NULL;
+    }
+
+    if (file_size == 0 || file_size >= UINT32_MAX) {
+        set_error_buf(error_buf, error_buf_size, "invalid aot file size");
+        goto fail1;
+    }
+
+    /* The loader writes to the mapped file, e.g. when applying relocations
+       in indirect mode, the pages written are copied */
+    if (!(file_map = os_mmap_file(NULL, (size_t)file_size,
+                                  MMAP_PROT_READ | MMAP_PROT_WRITE, map_flags,
+                                  file, 0))) {
+        set_error_buf(error_buf, error_buf_size, "mmap aot file failed");
+        goto fail1;
+    }
+
+    if (!(module = create_module(error_buf, error_buf_size))) {
+        os_munmap(file_map, (uint32)file_size);
+        goto fail1;
+    }
+    /* Unmapped by aot_unload */
+    module->file_map = file_map;
+    module->file_map_size = (uint32)file_size;
+
+    os_thread_jit_write_protect_np(false); /* Make memory writable */
+    ret = load(file_map, (uint32)file_size, module, file, error_buf,
+               error_buf_size);
+    os_mmap_file_close(file);
+    if (!ret) {
+        aot_unload(module);
+        return NULL;
+    }
+    os_thread_jit_write_protect_np(true); /* Make memory executable */
+    os_icache_flush(module->code, module->code_size);
+
+    LOG_VERBOSE("Load module from mapped file success.\n");
+    return module;
+
+fail1:
+    os_mmap_file_close(file);
+    return NULL;
+}
+#endif
+
 void
 aot_unload(AOTModule *module)
 {
@@ -3298,6 +3482,11 @@ aot_unload(AOTModule *module)
     if (module->exports)
         destroy_exports(module->exports);
 
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+    if (module->export_func_hash)
+        wasm_runtime_free(module->export_func_hash);
+#endif
+
     if (module->func_type_indexes)
         wasm_runtime_free(module->func_type_indexes);
 
@@ -3313,6 +3502,11 @@ aot_unload(AOTModule *module)
 
     if (module->const_str_set)
         bh_hash_map_destroy(module->const_str_set);
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+    if (module->checkpoint_profile)
+        wasm_checkpoint_profile_destroy(module->checkpoint_profile);
+    os_mutex_destroy(&module->checkpoint_profile_lock);
+#endif
 #if WASM_ENABLE_MULTI_MODULE != 0
     /* just release the sub module list */
     if (module->import_module_list) {
@@ -3329,9 +3523,10 @@ aot_unload(AOTModule *module)
 
     if (module->code && !module->is_indirect_mode) {
         /* The layout is: literal size + literal + code (with plt table) */
-        uint8 *mmap_addr = module->literal - sizeof(uint32);
         uint32 total_size =
             sizeof(uint32) + module->literal_size + module->code_size;
+        uint8 *mmap_addr =
+            get_text_pages(module, module->literal - sizeof(uint32), &total_size);
         os_munmap(mmap_addr, total_size);
     }
 
@@ -3396,6 +3591,11 @@ aot_unload(AOTModule *module)
     wasm_runtime_destroy_custom_sections(module->custom_section_list);
 #endif
 
+#ifdef OS_ENABLE_MMAP_FILE
+    if (module->file_map)
+        os_munmap(module->file_map, module->file_map_size);
+#endif
+
     wasm_runtime_free(module);
 }
 
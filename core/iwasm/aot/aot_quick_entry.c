@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "aot_runtime.h"
+
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+
+/*
+ * The entry stubs of the AOT functions of the common signatures: each
+ * stub calls the AOT function through a C function pointer of its exact
+ * type, so that the C compiler loads the arguments from argv into the
+ * registers of the calling convention directly, instead of going
+ * through the generic invokeNative assembly which copies all of them
+ * into a temporary buffer and then into registers and stack.
+ *
+ * The stubs of a parameter list are named quick_entry_<params>_<result>,
+ * in which i, I, f and F stand for i32, i64, f32 and f64, and v for no
+ * parameter or no result.
+ */
+
+#define ARG_I32(n) argv[n]
+#define ARG_I64(n) GET_I64_FROM_ADDR(argv + n)
+#define ARG_F32(n) (*(float32 *)(argv + n))
+#define ARG_F64(n) GET_F64_FROM_ADDR(argv + n)
+
+#define DEFINE_QUICK_ENTRY(name, ret_type, proto, args, set_ret)           \
+    static void quick_entry_##name(void *func_ptr, WASMExecEnv *exec_env, \
+                                   uint32 *argv, uint32 *argv_ret)        \
+    {                                                                     \
+        ret_type(*native_code) proto = (ret_type(*) proto)func_ptr;       \
+        (void)argv;                                                       \
+        (void)argv_ret;                                                   \
+        set_ret(native_code args);                                        \
+    }
+
+#define SET_RET_V(value) value
+#define SET_RET_I32(value) argv_ret[0] = value
+#define SET_RET_I64(value) PUT_I64_TO_ADDR(argv_ret, value)
+#define SET_RET_F32(value) *(float32 *)argv_ret = value
+#define SET_RET_F64(value) PUT_F64_TO_ADDR(argv_ret, value)
+
+#define DEFINE_QUICK_ENTRIES(params, proto, args)                        \
+    DEFINE_QUICK_ENTRY(params##_v, void, proto, args, SET_RET_V)         \
+    DEFINE_QUICK_ENTRY(params##_i, uint32, proto, args, SET_RET_I32)     \
+    DEFINE_QUICK_ENTRY(params##_I, uint64, proto, args, SET_RET_I64)     \
+    DEFINE_QUICK_ENTRY(params##_f, float32, proto, args, SET_RET_F32)    \
+    DEFINE_QUICK_ENTRY(params##_F, float64, proto, args, SET_RET_F64)
+
+/* clang-format off */
+DEFINE_QUICK_ENTRIES(v, (WASMExecEnv *), (exec_env))
+DEFINE_QUICK_ENTRIES(i, (WASMExecEnv *, uint32), (exec_env, ARG_I32(0)))
+DEFINE_QUICK_ENTRIES(I, (WASMExecEnv *, uint64), (exec_env, ARG_I64(0)))
+DEFINE_QUICK_ENTRIES(f, (WASMExecEnv *, float32), (exec_env, ARG_F32(0)))
+DEFINE_QUICK_ENTRIES(F, (WASMExecEnv *, float64), (exec_env, ARG_F64(0)))
+DEFINE_QUICK_ENTRIES(ii, (WASMExecEnv *, uint32, uint32),
+                     (exec_env, ARG_I32(0), ARG_I32(1)))
+DEFINE_QUICK_ENTRIES(iI, (WASMExecEnv *, uint32, uint64),
+                     (exec_env, ARG_I32(0), ARG_I64(1)))
+DEFINE_QUICK_ENTRIES(if, (WASMExecEnv *, uint32, float32),
+                     (exec_env, ARG_I32(0), ARG_F32(1)))
+DEFINE_QUICK_ENTRIES(iF, (WASMExecEnv *, uint32, float64),
+                     (exec_env, ARG_I32(0), ARG_F64(1)))
+DEFINE_QUICK_ENTRIES(Ii, (WASMExecEnv *, uint64, uint32),
+                     (exec_env, ARG_I64(0), ARG_I32(2)))
+DEFINE_QUICK_ENTRIES(II, (WASMExecEnv *, uint64, uint64),
+                     (exec_env, ARG_I64(0), ARG_I64(2)))
+DEFINE_QUICK_ENTRIES(If, (WASMExecEnv *, uint64, float32),
+                     (exec_env, ARG_I64(0), ARG_F32(2)))
+DEFINE_QUICK_ENTRIES(IF, (WASMExecEnv *, uint64, float64),
+                     (exec_env, ARG_I64(0), ARG_F64(2)))
+DEFINE_QUICK_ENTRIES(fi, (WASMExecEnv *, float32, uint32),
+                     (exec_env, ARG_F32(0), ARG_I32(1)))
+DEFINE_QUICK_ENTRIES(fI, (WASMExecEnv *, float32, uint64),
+                     (exec_env, ARG_F32(0), ARG_I64(1)))
+DEFINE_QUICK_ENTRIES(ff, (WASMExecEnv *, float32, float32),
+                     (exec_env, ARG_F32(0), ARG_F32(1)))
+DEFINE_QUICK_ENTRIES(fF, (WASMExecEnv *, float32, float64),
+                     (exec_env, ARG_F32(0), ARG_F64(1)))
+DEFINE_QUICK_ENTRIES(Fi, (WASMExecEnv *, float64, uint32),
+                     (exec_env, ARG_F64(0), ARG_I32(2)))
+DEFINE_QUICK_ENTRIES(FI, (WASMExecEnv *, float64, uint64),
+                     (exec_env, ARG_F64(0), ARG_I64(2)))
+DEFINE_QUICK_ENTRIES(Ff, (WASMExecEnv *, float64, float32),
+                     (exec_env, ARG_F64(0), ARG_F32(2)))
+DEFINE_QUICK_ENTRIES(FF, (WASMExecEnv *, float64, float64),
+                     (exec_env, ARG_F64(0), ARG_F64(2)))
+DEFINE_QUICK_ENTRIES(iii, (WASMExecEnv *, uint32, uint32, uint32),
+                     (exec_env, ARG_I32(0), ARG_I32(1), ARG_I32(2)))
+DEFINE_QUICK_ENTRIES(iiI, (WASMExecEnv *, uint32, uint32, uint64),
+                     (exec_env, ARG_I32(0), ARG_I32(1), ARG_I64(2)))
+DEFINE_QUICK_ENTRIES(iIi, (WASMExecEnv *, uint32, uint64, uint32),
+                     (exec_env, ARG_I32(0), ARG_I64(1), ARG_I32(3)))
+DEFINE_QUICK_ENTRIES(iII, (WASMExecEnv *, uint32, uint64, uint64),
+                     (exec_env, ARG_I32(0), ARG_I64(1), ARG_I64(3)))
+DEFINE_QUICK_ENTRIES(Iii, (WASMExecEnv *, uint64, uint32, uint32),
+                     (exec_env, ARG_I64(0), ARG_I32(2), ARG_I32(3)))
+DEFINE_QUICK_ENTRIES(IiI, (WASMExecEnv *, uint64, uint32, uint64),
+                     (exec_env, ARG_I64(0), ARG_I32(2), ARG_I64(3)))
+DEFINE_QUICK_ENTRIES(IIi, (WASMExecEnv *, uint64, uint64, uint32),
+                     (exec_env, ARG_I64(0), ARG_I64(2), ARG_I32(4)))
+DEFINE_QUICK_ENTRIES(III, (WASMExecEnv *, uint64, uint64, uint64),
+                     (exec_env, ARG_I64(0), ARG_I64(2), ARG_I64(4)))
+DEFINE_QUICK_ENTRIES(iiii, (WASMExecEnv *, uint32, uint32, uint32, uint32),
+                     (exec_env, ARG_I32(0), ARG_I32(1), ARG_I32(2), ARG_I32(3)))
+DEFINE_QUICK_ENTRIES(iiiii,
+                     (WASMExecEnv *, uint32, uint32, uint32, uint32, uint32),
+                     (exec_env, ARG_I32(0), ARG_I32(1), ARG_I32(2), ARG_I32(3),
+                      ARG_I32(4)))
+DEFINE_QUICK_ENTRIES(iiiiii,
+                     (WASMExecEnv *, uint32, uint32, uint32, uint32, uint32,
+                      uint32),
+                     (exec_env, ARG_I32(0), ARG_I32(1), ARG_I32(2), ARG_I32(3),
+                      ARG_I32(4), ARG_I32(5)))
+/* clang-format on */
+
+typedef struct QuickEntryItem {
+    /* the types of the params and the result, e.g. "iI" and 'i' */
+    const char *params;
+    char result;
+    AOTQuickEntry entry;
+} QuickEntryItem;
+
+/* clang-format off */
+#define QUICK_ENTRY_ITEMS(params, params_str)      \
+    { params_str, 'v', quick_entry_##params##_v }, \
+    { params_str, 'i', quick_entry_##params##_i }, \
+    { params_str, 'I', quick_entry_##params##_I }, \
+    { params_str, 'f', quick_entry_##params##_f }, \
+    { params_str, 'F', quick_entry_##params##_F }
+
+static const QuickEntryItem quick_entries[] = {
+    QUICK_ENTRY_ITEMS(v, ""),
+    QUICK_ENTRY_ITEMS(i, "i"),
+    QUICK_ENTRY_ITEMS(I, "I"),
+    QUICK_ENTRY_ITEMS(f, "f"),
+    QUICK_ENTRY_ITEMS(F, "F"),
+    QUICK_ENTRY_ITEMS(ii, "ii"),
+    QUICK_ENTRY_ITEMS(iI, "iI"),
+    QUICK_ENTRY_ITEMS(if, "if"),
+    QUICK_ENTRY_ITEMS(iF, "iF"),
+    QUICK_ENTRY_ITEMS(Ii, "Ii"),
+    QUICK_ENTRY_ITEMS(II, "II"),
+    QUICK_ENTRY_ITEMS(If, "If"),
+    QUICK_ENTRY_ITEMS(IF, "IF"),
+    QUICK_ENTRY_ITEMS(fi, "fi"),
+    QUICK_ENTRY_ITEMS(fI, "fI"),
+    QUICK_ENTRY_ITEMS(ff, "ff"),
+    QUICK_ENTRY_ITEMS(fF, "fF"),
+    QUICK_ENTRY_ITEMS(Fi, "Fi"),
+    QUICK_ENTRY_ITEMS(FI, "FI"),
+    QUICK_ENTRY_ITEMS(Ff, "Ff"),
+    QUICK_ENTRY_ITEMS(FF, "FF"),
+    QUICK_ENTRY_ITEMS(iii, "iii"),
+    QUICK_ENTRY_ITEMS(iiI, "iiI"),
+    QUICK_ENTRY_ITEMS(iIi, "iIi"),
+    QUICK_ENTRY_ITEMS(iII, "iII"),
+    QUICK_ENTRY_ITEMS(Iii, "Iii"),
+    QUICK_ENTRY_ITEMS(IiI, "IiI"),
+    QUICK_ENTRY_ITEMS(IIi, "IIi"),
+    QUICK_ENTRY_ITEMS(III, "III"),
+    QUICK_ENTRY_ITEMS(iiii, "iiii"),
+    QUICK_ENTRY_ITEMS(iiiii, "iiiii"),
+    QUICK_ENTRY_ITEMS(iiiiii, "iiiiii"),
+};
+/* clang-format on */
+
+static char
+get_type_char(uint8 type)
+{
+    switch (type) {
+        case VALUE_TYPE_I32:
+            return 'i';
+        case VALUE_TYPE_I64:
+            return 'I';
+        case VALUE_TYPE_F32:
+            return 'f';
+        case VALUE_TYPE_F64:
+            return 'F';
+        default:
+            return '\0';
+    }
+}
+
+AOTQuickEntry
+aot_lookup_quick_entry(const AOTFuncType *func_type)
+{
+    char params[8], result = 'v';
+    uint32 i;
+
+    if (func_type->param_count >= sizeof(params) || func_type->result_count > 1)
+        return NULL;
+
+    for (i = 0; i < func_type->param_count; i++) {
+        if (!(params[i] = get_type_char(func_type->types[i])))
+            return NULL;
+    }
+    params[i] = '\0';
+
+    if (func_type->result_count > 0
+        && !(result = get_type_char(func_type->types[i])))
+        return NULL;
+
+    for (i = 0; i < sizeof(quick_entries) / sizeof(QuickEntryItem); i++) {
+        if (quick_entries[i].result == result
+            && !strcmp(quick_entries[i].params, params))
+            return quick_entries[i].entry;
+    }
+    return NULL;
+}
+
+uint32
+aot_hash_export_name(const char *name)
+{
+    /* FNV-1a */
+    uint32 hash = 2166136261u;
+
+    while (*name) {
+        hash ^= (uint8)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool
+aot_create_export_func_hash(AOTModule *module, char *error_buf,
+                            uint32 error_buf_size)
+{
+    AOTExport *exports = module->exports;
+    uint32 export_func_count = 0, hash_size = 4, order = 0, slot, i;
+    uint64 size;
+
+    for (i = 0; i < module->export_count; i++) {
+        if (exports[i].kind == EXPORT_KIND_FUNC)
+            export_func_count++;
+    }
+
+    /* Linear search is as fast as hashing for a few exports */
+    if (export_func_count <= 4)
+        return true;
+
+    /* Keep the load factor of the table no more than 1/2 */
+    while (hash_size < export_func_count * 2)
+        hash_size <<= 1;
+
+    size = sizeof(uint32) * (uint64)hash_size;
+    if (size >= UINT32_MAX
+        || !(module->export_func_hash = wasm_runtime_malloc((uint32)size))) {
+        if (error_buf != NULL)
+            snprintf(error_buf, error_buf_size,
+                     "AOT module load failed: allocate memory failed");
+        return false;
+    }
+    memset(module->export_func_hash, 0, (uint32)size);
+    module->export_func_hash_size = hash_size;
+
+    for (i = 0; i < module->export_count; i++) {
+        if (exports[i].kind == EXPORT_KIND_FUNC) {
+            slot = aot_hash_export_name(exports[i].name) & (hash_size - 1);
+            while (module->export_func_hash[slot] != 0)
+                slot = (slot + 1) & (hash_size - 1);
+            module->export_func_hash[slot] = ++order;
+        }
+    }
+    return true;
+}
+
+#endif /* end of WASM_ENABLE_QUICK_AOT_ENTRY != 0 */
@@ -40,6 +40,8 @@ bh_static_assert(offsetof(WASMExecEnv, aux_stack_bottom)
 bh_static_assert(offsetof(WASMExecEnv, native_symbol) == 8 * sizeof(uintptr_t));
 bh_static_assert(offsetof(WASMExecEnv, native_stack_top_min)
                  == 9 * sizeof(uintptr_t));
+bh_static_assert(offsetof(WASMExecEnv, checkpoint_loop_period)
+                 == 10 * sizeof(uintptr_t));
 
 bh_static_assert(offsetof(AOTModuleInstance, memories) == 1 * sizeof(uint64));
 bh_static_assert(offsetof(AOTModuleInstance, func_ptrs) == 5 * sizeof(uint64));
@@ -47,6 +49,8 @@ bh_static_assert(offsetof(AOTModuleInstance, func_type_indexes)
                  == 6 * sizeof(uint64));
 bh_static_assert(offsetof(AOTModuleInstance, cur_exception)
                  == 13 * sizeof(uint64));
+bh_static_assert(offsetof(AOTModuleInstance, import_func_ptrs)
+                 == 13 * sizeof(uint64) + 128 + 3 * sizeof(uint64));
 bh_static_assert(offsetof(AOTModuleInstance, global_table_data)
                  == 13 * sizeof(uint64) + 128 + 11 * sizeof(uint64));
 
@@ -365,6 +369,9 @@ memories_deinstantiate(AOTModuleInstance *module_inst)
                 wasm_runtime_free(memory_inst->heap_handle);
             }
 
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+            wasm_memory_dirty_tracker_destroy(memory_inst);
+#endif
             if (memory_inst->memory_data) {
 #ifndef OS_ENABLE_HW_BOUND_CHECK
                 wasm_runtime_free(memory_inst->memory_data);
@@ -652,10 +659,63 @@ aot_get_default_memory(AOTModuleInstance *module_inst)
         return NULL;
 }
 
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && defined(OS_ENABLE_MMAP_FILE)
+static void
+set_memory_from_template(AOTMemoryInstance *memory_inst, uint8 *memory_data,
+                         const AOTInstanceTemplate *tmpl)
+{
+    memory_inst->num_bytes_per_page = tmpl->num_bytes_per_page;
+    memory_inst->cur_page_count = tmpl->cur_page_count;
+    memory_inst->max_page_count = tmpl->max_page_count;
+    memory_inst->memory_data_size = tmpl->memory_data_size;
+
+    memory_inst->memory_data = memory_data;
+    memory_inst->memory_data_end = memory_data + tmpl->memory_data_size;
+    memory_inst->heap_data = memory_data + tmpl->heap_offset;
+    memory_inst->heap_data_end = memory_inst->heap_data;
+
+    if (tmpl->memory_data_size > 0) {
+        wasm_runtime_set_mem_bound_check_bytes(memory_inst,
+                                               tmpl->memory_data_size);
+    }
+}
+
+static AOTMemoryInstance *
+memory_instantiate_from_template(AOTMemoryInstance *memory_inst,
+                                 const AOTInstanceTemplate *tmpl,
+                                 char *error_buf, uint32 error_buf_size)
+{
+    uint64 map_size = 8 * (uint64)BH_GB;
+    uint8 *p;
+
+    /* Reserve the 8G range like memory_instantiate does */
+    if (!(p = os_mmap(NULL, map_size, MMAP_PROT_NONE, MMAP_MAP_NONE,
+                      os_get_invalid_handle()))) {
+        set_error_buf(error_buf, error_buf_size, "mmap memory failed");
+        return NULL;
+    }
+
+    /* Map the memory image over the head of the range, its pages are
+       shared with the template until the instance writes them */
+    if (tmpl->memory_data_size > 0
+        && !os_mmap_file(p, tmpl->memory_data_size,
+                         MMAP_PROT_READ | MMAP_PROT_WRITE, MMAP_MAP_FIXED,
+                         tmpl->memory_file, 0)) {
+        set_error_buf(error_buf, error_buf_size, "mmap memory image failed");
+        os_munmap(p, map_size);
+        return NULL;
+    }
+
+    memory_inst->module_type = Wasm_Module_AoT;
+    set_memory_from_template(memory_inst, p, tmpl);
+    return memory_inst;
+}
+#endif
+
 static bool
 memories_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
-                     AOTModule *module, uint32 heap_size, char *error_buf,
-                     uint32 error_buf_size)
+                     AOTModule *module, const AOTInstanceTemplate *tmpl,
+                     uint32 heap_size, char *error_buf, uint32 error_buf_size)
 {
     uint32 global_index, global_data_offset, base_offset, length;
     uint32 i, memory_count = module->memory_count;
@@ -675,9 +735,15 @@ memories_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
 
     memories = module_inst->global_table_data.memory_instances;
     for (i = 0; i < memory_count; i++, memories++) {
-        memory_inst = memory_instantiate(module_inst, parent, module, memories,
-                                         &module->memories[i], i, heap_size,
-                                         error_buf, error_buf_size);
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && defined(OS_ENABLE_MMAP_FILE)
+        if (tmpl)
+            memory_inst = memory_instantiate_from_template(
+                memories, tmpl, error_buf, error_buf_size);
+        else
+#endif
+            memory_inst = memory_instantiate(
+                module_inst, parent, module, memories, &module->memories[i], i,
+                heap_size, error_buf, error_buf_size);
         if (!memory_inst) {
             return false;
         }
@@ -692,6 +758,11 @@ memories_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
         return true;
     }
 
+    if (tmpl) {
+        /* The memory image of the template has been initialized */
+        return true;
+    }
+
 #if WASM_ENABLE_SHARED_MEMORY != 0
     /* Currently we have only one memory instance */
     is_shared_memory = module->memories[0].memory_flags & 0x02 ? true : false;
@@ -784,6 +855,38 @@ memories_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
     return true;
 }
 
+/**
+ * Whether the import function is linked to a native which can be called
+ * by the AOT code directly with `ret func(exec_env, params...)`: it must
+ * neither be a raw or wasm-c-api native, nor need the app address to
+ * native address conversion of its signature, nor have an attachment,
+ * which is only set to exec_env by wasm_runtime_invoke_native.
+ */
+static bool
+is_direct_callable_import_func(const AOTImportFunc *import_func)
+{
+    const char *p;
+
+    if (!import_func->func_ptr_linked || import_func->call_conv_raw
+        || import_func->call_conv_wasm_c_api || import_func->attachment)
+        return false;
+
+#if WASM_ENABLE_MULTI_MODULE != 0
+    /* The function of a sub module is also linked without signature
+       and must be called with the sub module's exec_env */
+    if (!import_func->signature)
+        return false;
+#endif
+
+    if (import_func->signature) {
+        for (p = import_func->signature; *p; p++) {
+            if (*p == '*' || *p == '~' || *p == '$')
+                return false;
+        }
+    }
+    return true;
+}
+
 static bool
 init_func_ptrs(AOTModuleInstance *module_inst, AOTModule *module,
                char *error_buf, uint32 error_buf_size)
@@ -802,6 +905,16 @@ init_func_ptrs(AOTModuleInstance *module_inst, AOTModule *module,
         return false;
     }
 
+    /* The AOT code calls an import function directly through
+       import_func_ptrs[i] if it isn't NULL, and falls back to
+       aot_invoke_native otherwise */
+    if (module->import_func_count > 0
+        && !(module_inst->import_func_ptrs = runtime_malloc(
+                 sizeof(void *) * (uint64)module->import_func_count,
+                 error_buf, error_buf_size))) {
+        return false;
+    }
+
     /* Set import function pointers */
     func_ptrs = (void **)module_inst->func_ptrs;
     for (i = 0; i < module->import_func_count; i++, func_ptrs++) {
@@ -812,6 +925,8 @@ init_func_ptrs(AOTModuleInstance *module_inst, AOTModule *module,
             LOG_WARNING("warning: failed to link import function (%s, %s)",
                         module_name, field_name);
         }
+        if (is_direct_callable_import_func(module->import_funcs + i))
+            module_inst->import_func_ptrs[i] = *func_ptrs;
     }
 
     /* Set defined function pointers */
@@ -1117,10 +1232,41 @@ check_linked_symbol(AOTModule *module, char *error_buf, uint32 error_buf_size)
     return true;
 }
 
-AOTModuleInstance *
-aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
-                WASMExecEnv *exec_env_main, uint32 stack_size, uint32 heap_size,
-                char *error_buf, uint32 error_buf_size)
+#if WASM_ENABLE_LIBC_WASI != 0
+static bool
+init_wasi(AOTModuleInstance *module_inst, AOTModule *module, char *error_buf,
+          uint32 error_buf_size)
+{
+    return wasm_runtime_init_wasi(
+        (WASMModuleInstanceCommon *)module_inst, module->wasi_args.dir_list,
+        module->wasi_args.dir_count, module->wasi_args.map_dir_list,
+        module->wasi_args.map_dir_count, module->wasi_args.env,
+        module->wasi_args.env_count, module->wasi_args.addr_pool,
+        module->wasi_args.addr_count, module->wasi_args.ns_lookup_pool,
+        module->wasi_args.ns_lookup_count, module->wasi_args.argv,
+        module->wasi_args.argc, module->wasi_args.stdio[0],
+        module->wasi_args.stdio[1], module->wasi_args.stdio[2], error_buf,
+        error_buf_size);
+}
+#endif
+
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && defined(OS_ENABLE_MMAP_FILE)
+static void
+copy_bitmap(bh_bitmap *dst, const bh_bitmap *src)
+{
+    uint32 size = (uint32)((src->end_index - src->begin_index + 7) / 8);
+
+    bh_assert(dst->end_index - dst->begin_index
+              == src->end_index - src->begin_index);
+    bh_memcpy_s(dst->map, size, src->map, size);
+}
+#endif
+
+static AOTModuleInstance *
+instantiate(AOTModule *module, AOTModuleInstance *parent,
+            WASMExecEnv *exec_env_main, const AOTInstanceTemplate *tmpl,
+            uint32 stack_size, uint32 heap_size, char *error_buf,
+            uint32 error_buf_size)
 {
     AOTModuleInstance *module_inst;
 #if WASM_ENABLE_BULK_MEMORY != 0 || WASM_ENABLE_REF_TYPES != 0
@@ -1179,6 +1325,8 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
     module_inst->module = (void *)module;
     module_inst->e =
         (WASMModuleInstanceExtra *)((uint8 *)module_inst + extra_info_offset);
+    ((AOTModuleInstanceExtra *)module_inst->e)->common.module_inst_id =
+        wasm_runtime_new_module_inst_id();
 
 #if WASM_ENABLE_MULTI_MODULE != 0
     ((AOTModuleInstanceExtra *)module_inst->e)->sub_module_inst_list =
@@ -1233,9 +1381,25 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
                             error_buf, error_buf_size))
         goto fail;
 
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && defined(OS_ENABLE_MMAP_FILE)
+    if (tmpl) {
+        /* Take the globals and tables as the start functions left them */
+        bh_memcpy_s(module_inst->global_data, tmpl->global_table_data_size,
+                    tmpl->global_table_data, tmpl->global_table_data_size);
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (common->data_dropped)
+            copy_bitmap(common->data_dropped, tmpl->data_dropped);
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+        if (common->elem_dropped)
+            copy_bitmap(common->elem_dropped, tmpl->elem_dropped);
+#endif
+    }
+#endif
+
     /* Initialize memory space */
-    if (!memories_instantiate(module_inst, parent, module, heap_size, error_buf,
-                              error_buf_size))
+    if (!memories_instantiate(module_inst, parent, module, tmpl, heap_size,
+                              error_buf, error_buf_size))
         goto fail;
 
     /* Initialize function pointers */
@@ -1254,17 +1418,7 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
 
 #if WASM_ENABLE_LIBC_WASI != 0
     if (!is_sub_inst) {
-        if (!wasm_runtime_init_wasi(
-                (WASMModuleInstanceCommon *)module_inst,
-                module->wasi_args.dir_list, module->wasi_args.dir_count,
-                module->wasi_args.map_dir_list, module->wasi_args.map_dir_count,
-                module->wasi_args.env, module->wasi_args.env_count,
-                module->wasi_args.addr_pool, module->wasi_args.addr_count,
-                module->wasi_args.ns_lookup_pool,
-                module->wasi_args.ns_lookup_count, module->wasi_args.argv,
-                module->wasi_args.argc, module->wasi_args.stdio[0],
-                module->wasi_args.stdio[1], module->wasi_args.stdio[2],
-                error_buf, error_buf_size))
+        if (!init_wasi(module_inst, module, error_buf, error_buf_size))
             goto fail;
     }
 #endif
@@ -1297,8 +1451,10 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
     }
 #endif
 
-    if (!execute_post_instantiate_functions(module_inst, is_sub_inst,
-                                            exec_env_main)) {
+    /* The start functions of a template have already been executed */
+    if (!tmpl
+        && !execute_post_instantiate_functions(module_inst, is_sub_inst,
+                                               exec_env_main)) {
         set_error_buf(error_buf, error_buf_size, module_inst->cur_exception);
         goto fail;
     }
@@ -1315,6 +1471,15 @@ fail:
     return NULL;
 }
 
+AOTModuleInstance *
+aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
+                WASMExecEnv *exec_env_main, uint32 stack_size, uint32 heap_size,
+                char *error_buf, uint32 error_buf_size)
+{
+    return instantiate(module, parent, exec_env_main, NULL, stack_size,
+                       heap_size, error_buf, error_buf_size);
+}
+
 #if WASM_ENABLE_DUMP_CALL_STACK != 0
 static void
 destroy_c_api_frames(Vector *frames)
@@ -1383,6 +1548,9 @@ aot_deinstantiate(AOTModuleInstance *module_inst, bool is_sub_inst)
     if (module_inst->func_ptrs)
         wasm_runtime_free(module_inst->func_ptrs);
 
+    if (module_inst->import_func_ptrs)
+        wasm_runtime_free(module_inst->import_func_ptrs);
+
     if (module_inst->func_type_indexes)
         wasm_runtime_free(module_inst->func_type_indexes);
 
@@ -1408,6 +1576,214 @@ aot_deinstantiate(AOTModuleInstance *module_inst, bool is_sub_inst)
 #endif
 }
 
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && defined(OS_ENABLE_MMAP_FILE)
+AOTInstanceTemplate *
+aot_create_instance_template(AOTModuleInstance *module_inst, char *error_buf,
+                             uint32 error_buf_size)
+{
+    AOTModule *module = (AOTModule *)module_inst->module;
+#if WASM_ENABLE_BULK_MEMORY != 0 || WASM_ENABLE_REF_TYPES != 0
+    WASMModuleInstanceExtraCommon *common =
+        &((AOTModuleInstanceExtra *)module_inst->e)->common;
+#endif
+    AOTMemoryInstance *memory_inst = aot_get_default_memory(module_inst);
+    AOTInstanceTemplate *tmpl;
+    uint32 global_table_data_size =
+        (uint32)((uint8 *)module_inst->e - module_inst->global_data);
+
+    if (module_inst->memory_count > 1) {
+        set_error_buf(error_buf, error_buf_size,
+                      "multiple memories aren't supported by instance "
+                      "template");
+        return NULL;
+    }
+
+    if (memory_inst) {
+#if WASM_ENABLE_SHARED_MEMORY != 0
+        if (shared_memory_is_shared(memory_inst)) {
+            set_error_buf(error_buf, error_buf_size,
+                          "shared memory isn't supported by instance "
+                          "template");
+            return NULL;
+        }
+#endif
+        /* The app heap keeps native pointers to the memory of the
+           instance, which can't be shared by other instances */
+        if (memory_inst->heap_handle) {
+            set_error_buf(error_buf, error_buf_size,
+                          "app heap isn't supported by instance template, "
+                          "try instantiating with heap size 0");
+            return NULL;
+        }
+    }
+
+#if WASM_ENABLE_MULTI_MODULE != 0
+    if (bh_list_length(((AOTModuleInstanceExtra *)module_inst->e)
+                           ->sub_module_inst_list)
+        > 0) {
+        set_error_buf(error_buf, error_buf_size,
+                      "sub module instances aren't supported by instance "
+                      "template");
+        return NULL;
+    }
+#endif
+
+    if (!(tmpl = runtime_malloc(sizeof(AOTInstanceTemplate)
+                                    + (uint64)global_table_data_size,
+                                error_buf, error_buf_size))) {
+        return NULL;
+    }
+
+    tmpl->module = module;
+    tmpl->memory_file = os_get_invalid_handle();
+    tmpl->global_table_data = (uint8 *)(tmpl + 1);
+    tmpl->global_table_data_size = global_table_data_size;
+    bh_memcpy_s(tmpl->global_table_data, global_table_data_size,
+                module_inst->global_data, global_table_data_size);
+
+    if (memory_inst) {
+        tmpl->num_bytes_per_page = memory_inst->num_bytes_per_page;
+        tmpl->cur_page_count = memory_inst->cur_page_count;
+        tmpl->max_page_count = memory_inst->max_page_count;
+        tmpl->memory_data_size = memory_inst->memory_data_size;
+        tmpl->heap_offset =
+            (uint32)(memory_inst->heap_data - memory_inst->memory_data);
+
+        if (memory_inst->memory_data_size > 0) {
+            tmpl->memory_file = os_mmap_file_create(
+                "wamr-memory-image", memory_inst->memory_data,
+                memory_inst->memory_data_size);
+            if (tmpl->memory_file == os_get_invalid_handle()) {
+                set_error_buf(error_buf, error_buf_size,
+                              "create memory image failed");
+                goto fail;
+            }
+        }
+    }
+
+#if WASM_ENABLE_BULK_MEMORY != 0
+    if (common->data_dropped) {
+        if (!(tmpl->data_dropped =
+                  bh_bitmap_new(0, module->mem_init_data_count))) {
+            set_error_buf(error_buf, error_buf_size,
+                          "failed to allocate bitmaps");
+            goto fail;
+        }
+        copy_bitmap(tmpl->data_dropped, common->data_dropped);
+    }
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    if (common->elem_dropped) {
+        if (!(tmpl->elem_dropped =
+                  bh_bitmap_new(0, module->table_init_data_count))) {
+            set_error_buf(error_buf, error_buf_size,
+                          "failed to allocate bitmaps");
+            goto fail;
+        }
+        copy_bitmap(tmpl->elem_dropped, common->elem_dropped);
+    }
+#endif
+
+    return tmpl;
+
+fail:
+    aot_destroy_instance_template(tmpl);
+    return NULL;
+}
+
+void
+aot_destroy_instance_template(AOTInstanceTemplate *tmpl)
+{
+    if (tmpl->memory_file != os_get_invalid_handle())
+        os_mmap_file_close(tmpl->memory_file);
+#if WASM_ENABLE_BULK_MEMORY != 0
+    bh_bitmap_delete(tmpl->data_dropped);
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    bh_bitmap_delete(tmpl->elem_dropped);
+#endif
+    wasm_runtime_free(tmpl);
+}
+
+AOTModuleInstance *
+aot_instantiate_from_template(AOTInstanceTemplate *tmpl, uint32 stack_size,
+                              char *error_buf, uint32 error_buf_size)
+{
+    return instantiate(tmpl->module, NULL, NULL, tmpl, stack_size, 0,
+                       error_buf, error_buf_size);
+}
+
+bool
+aot_recycle_instance(AOTInstanceTemplate *tmpl, AOTModuleInstance *module_inst,
+                     char *error_buf, uint32 error_buf_size)
+{
+#if WASM_ENABLE_BULK_MEMORY != 0 || WASM_ENABLE_REF_TYPES != 0
+    WASMModuleInstanceExtraCommon *common =
+        &((AOTModuleInstanceExtra *)module_inst->e)->common;
+#endif
+    AOTMemoryInstance *memory_inst = aot_get_default_memory(module_inst);
+    uint8 *memory_data;
+    uint32 grown_size;
+
+    if ((AOTModule *)module_inst->module != tmpl->module) {
+        set_error_buf(error_buf, error_buf_size,
+                      "the instance isn't created from the template");
+        return false;
+    }
+
+    if (memory_inst) {
+        memory_data = memory_inst->memory_data;
+
+        /* Drop the pages grown after the instantiation and make them
+           inaccessible again */
+        if (memory_inst->memory_data_size > tmpl->memory_data_size) {
+            grown_size = memory_inst->memory_data_size - tmpl->memory_data_size;
+            if (os_mem_discard(memory_data + tmpl->memory_data_size, grown_size)
+                    != 0
+                || os_mprotect(memory_data + tmpl->memory_data_size,
+                               grown_size, MMAP_PROT_NONE)
+                       != 0) {
+                set_error_buf(error_buf, error_buf_size, "reset memory failed");
+                return false;
+            }
+        }
+
+        /* The written pages of the image get back the content of the
+           memory file, the others are still shared */
+        if (tmpl->memory_data_size > 0
+            && os_mem_discard(memory_data, tmpl->memory_data_size) != 0) {
+            set_error_buf(error_buf, error_buf_size, "reset memory failed");
+            return false;
+        }
+
+        set_memory_from_template(memory_inst, memory_data, tmpl);
+    }
+
+    bh_memcpy_s(module_inst->global_data, tmpl->global_table_data_size,
+                tmpl->global_table_data, tmpl->global_table_data_size);
+#if WASM_ENABLE_BULK_MEMORY != 0
+    if (common->data_dropped)
+        copy_bitmap(common->data_dropped, tmpl->data_dropped);
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    if (common->elem_dropped)
+        copy_bitmap(common->elem_dropped, tmpl->elem_dropped);
+#endif
+
+    aot_set_exception(module_inst, NULL);
+
+#if WASM_ENABLE_LIBC_WASI != 0
+    /* Reopen the preopened directories and reset the exit code */
+    wasm_runtime_destroy_wasi((WASMModuleInstanceCommon *)module_inst);
+    wasm_runtime_set_wasi_ctx((WASMModuleInstanceCommon *)module_inst, NULL);
+    if (!init_wasi(module_inst, tmpl->module, error_buf, error_buf_size))
+        return false;
+#endif
+
+    return true;
+}
+#endif /* end of OS_ENABLE_HW_BOUND_CHECK && OS_ENABLE_MMAP_FILE */
+
 AOTFunctionInstance *
 aot_lookup_function(const AOTModuleInstance *module_inst, const char *name,
                     const char *signature)
@@ -1415,6 +1791,23 @@ aot_lookup_function(const AOTModuleInstance *module_inst, const char *name,
     uint32 i;
     AOTFunctionInstance *export_funcs =
         (AOTFunctionInstance *)module_inst->export_functions;
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+    AOTModule *module = (AOTModule *)module_inst->module;
+    uint32 mask, slot, order;
+
+    if (module->export_func_hash) {
+        mask = module->export_func_hash_size - 1;
+        slot = aot_hash_export_name(name) & mask;
+        while ((order = module->export_func_hash[slot]) != 0) {
+            bh_assert(order <= module_inst->export_func_count);
+            if (!strcmp(export_funcs[order - 1].func_name, name))
+                return &export_funcs[order - 1];
+            slot = (slot + 1) & mask;
+        }
+        (void)signature;
+        return NULL;
+    }
+#endif
 
     for (i = 0; i < module_inst->export_func_count; i++)
         if (!strcmp(export_funcs[i].func_name, name))
@@ -1436,9 +1829,11 @@ invoke_native_with_hw_bound_check(WASMExecEnv *exec_env, void *func_ptr,
     WASMJmpBuf jmpbuf_node = { 0 }, *jmpbuf_node_pop;
     uint32 page_size = os_getpagesize();
     uint32 guard_page_count = STACK_OVERFLOW_CHECK_GUARD_PAGE_COUNT;
+#if WASM_ENABLE_QUICK_AOT_ENTRY == 0
     uint16 param_count = func_type->param_count;
     uint16 result_count = func_type->result_count;
     const uint8 *types = func_type->types;
+#endif
 #ifdef BH_PLATFORM_WINDOWS
     int result;
     bool has_exception;
@@ -1470,6 +1865,14 @@ invoke_native_with_hw_bound_check(WASMExecEnv *exec_env, void *func_ptr,
 
     wasm_runtime_set_exec_env_tls(exec_env);
     if (os_setjmp(jmpbuf_node.jmpbuf) == 0) {
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+        /* Quick call with the entry stub of the function signature */
+        if (!signature && !attachment && func_type->quick_aot_entry) {
+            AOTQuickEntry quick_entry = func_type->quick_aot_entry;
+            quick_entry(func_ptr, exec_env, argv, argv_ret);
+            ret = aot_copy_exception(module_inst, NULL) ? false : true;
+        }
+#else
         /* Quick call with func_ptr if the function signature is simple */
         if (!signature && param_count == 1 && types[0] == VALUE_TYPE_I32) {
             if (result_count == 0) {
@@ -1491,6 +1894,7 @@ invoke_native_with_hw_bound_check(WASMExecEnv *exec_env, void *func_ptr,
                                                  argc, argv_ret);
             }
         }
+#endif
         else {
             ret = wasm_runtime_invoke_native(exec_env, func_ptr, func_type,
                                              signature, attachment, argv, argc,
@@ -1525,6 +1929,26 @@ invoke_native_with_hw_bound_check(WASMExecEnv *exec_env, void *func_ptr,
 }
 
 #define invoke_native_internal invoke_native_with_hw_bound_check
+#elif WASM_ENABLE_QUICK_AOT_ENTRY != 0
+static bool
+invoke_native_internal(WASMExecEnv *exec_env, void *func_ptr,
+                       const WASMType *func_type, const char *signature,
+                       void *attachment, uint32 *argv, uint32 argc,
+                       uint32 *argv_ret)
+{
+    /* Quick call with the entry stub of the function signature */
+    if (!signature && !attachment && func_type->quick_aot_entry) {
+        AOTQuickEntry quick_entry = func_type->quick_aot_entry;
+        quick_entry(func_ptr, exec_env, argv, argv_ret);
+        return aot_copy_exception((AOTModuleInstance *)exec_env->module_inst,
+                                  NULL)
+                   ? false
+                   : true;
+    }
+
+    return wasm_runtime_invoke_native(exec_env, func_ptr, func_type, signature,
+                                      attachment, argv, argc, argv_ret);
+}
 #else /* else of OS_ENABLE_HW_BOUND_CHECK */
 #define invoke_native_internal wasm_runtime_invoke_native
 #endif /* end of OS_ENABLE_HW_BOUND_CHECK */
@@ -2233,13 +2657,12 @@ aot_call_indirect(WASMExecEnv *exec_env, uint32 tbl_idx, uint32 table_elem_idx,
     func_idx = tbl_inst->elems[table_elem_idx];
 #if WASM_ENABLE_CHECKPOINT_RESTORE != 0
     if (exec_env->is_restore && exec_env->restore_call_chain) {
-        struct AOTFrame *rcc = *(exec_env->restore_call_chain);
-        while (rcc->prev_frame) {
-            rcc = rcc->prev_frame;
-        }
+        /* Call the function of the next frame to be restored */
+        AOTFrame *rcc =
+            exec_env->restore_call_chain[exec_env->call_chain_size - 1];
         LOG_DEBUG("func_idx: %d instead of %d of thread %ld\n", rcc->func_index,
                   func_idx, exec_env->handle);
-        func_idx = rcc->func_index;
+        func_idx = (uint32)rcc->func_index;
     }
 #endif
     if (func_idx == NULL_REF) {
@@ -2569,6 +2992,9 @@ aot_get_module_mem_consumption(const AOTModule *module,
     mem_conspn->memories_size = sizeof(AOTMemory) * module->memory_count;
     mem_conspn->globals_size = sizeof(AOTGlobal) * module->global_count;
     mem_conspn->exports_size = sizeof(AOTExport) * module->export_count;
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+    mem_conspn->exports_size += sizeof(uint32) * module->export_func_hash_size;
+#endif
 
     mem_conspn->table_segs_size =
         sizeof(AOTTableInitData *) * module->table_init_data_count;
@@ -2656,6 +3082,9 @@ aot_get_module_inst_mem_consumption(const AOTModuleInstance *module_inst,
         (sizeof(void *) + sizeof(uint32))
         * (((AOTModule *)module_inst->module)->import_func_count
            + ((AOTModule *)module_inst->module)->func_count);
+    /* import_func_ptrs */
+    mem_conspn->functions_size +=
+        sizeof(void *) * ((AOTModule *)module_inst->module)->import_func_count;
 
     mem_conspn->globals_size = module_inst->global_data_size;
 
@@ -2879,6 +3308,34 @@ aot_raise(WASMExecEnv *exec_env, int sig)
 {
     raise(sig);
 }
+
+static void
+get_frame_cell_nums(const AOTModule *module, uint32 func_index,
+                    uint32 *p_max_local_cell_num, uint32 *p_max_stack_cell_num)
+{
+    if (func_index >= module->import_func_count) {
+        uint32 aot_func_idx = func_index - module->import_func_count;
+        *p_max_local_cell_num = module->max_local_cell_nums[aot_func_idx];
+        *p_max_stack_cell_num = module->max_stack_cell_nums[aot_func_idx];
+    }
+    else {
+        AOTFuncType *func_type = module->import_funcs[func_index].func_type;
+        *p_max_local_cell_num =
+            func_type->param_cell_num > 2 ? func_type->param_cell_num : 2;
+        *p_max_stack_cell_num = 0;
+    }
+}
+
+static inline uint32
+get_frame_size(uint32 all_cell_num)
+{
+#if WASM_ENABLE_GC == 0
+    return (uint32)offsetof(AOTFrame, lp) + all_cell_num * 4;
+#else
+    return (uint32)offsetof(AOTFrame, lp) + align_uint(all_cell_num * 5, 4);
+#endif
+}
+
 bool
 aot_alloc_frame(WASMExecEnv *exec_env, uint32 func_index)
 {
@@ -2893,7 +3350,7 @@ aot_alloc_frame(WASMExecEnv *exec_env, uint32 func_index)
 #endif
     AOTFrame *frame;
     uint32 max_local_cell_num, max_stack_cell_num, all_cell_num;
-    uint32 aot_func_idx, frame_size;
+    uint32 frame_size;
 #if WASM_ENABLE_CHECKPOINT_RESTORE != 0
     if (exec_env->restore_call_chain) {
         frame = exec_env->restore_call_chain[exec_env->call_chain_size - 1];
@@ -2902,39 +3359,28 @@ aot_alloc_frame(WASMExecEnv *exec_env, uint32 func_index)
         frame->prev_frame = (AOTFrame *)exec_env->cur_frame;
         exec_env->cur_frame = (struct WASMInterpFrame *)frame;
         if (exec_env->call_chain_size == 0) {
-            // TODO: fix memory leak
+            /* The frames live on the wasm stack, only the array of the
+               chain is to be freed, and only if the runtime allocated it */
+            if (exec_env->restore_call_chain_owned)
+                wasm_runtime_free(exec_env->restore_call_chain);
             exec_env->restore_call_chain = NULL;
-                    }
+            exec_env->restore_call_chain_owned = false;
+        }
         LOG_DEBUG("restore call chain %zu==%u, %p, %p, %d\n",
                 ((AOTFrame *)exec_env->cur_frame)->func_index, func_index,
                 exec_env, exec_env->restore_call_chain, exec_env->handle);
         if (((AOTFrame *)exec_env->cur_frame)->func_index != func_index) {
-            LOG_DEBUG("NOT MATCH!!!\n");
-            exit(1);
+            aot_set_exception(module_inst, "restored frame mismatch");
+            return false;
         }
         return true;
     }
 #endif
 
-    if (func_index >= module->import_func_count) {
-        aot_func_idx = func_index - module->import_func_count;
-        max_local_cell_num = module->max_local_cell_nums[aot_func_idx];
-        max_stack_cell_num = module->max_stack_cell_nums[aot_func_idx];
-    }
-    else {
-        AOTFuncType *func_type = module->import_funcs[func_index].func_type;
-        max_local_cell_num =
-            func_type->param_cell_num > 2 ? func_type->param_cell_num : 2;
-        max_stack_cell_num = 0;
-    }
-
+    get_frame_cell_nums(module, func_index, &max_local_cell_num,
+                        &max_stack_cell_num);
     all_cell_num = max_local_cell_num + max_stack_cell_num;
-#if WASM_ENABLE_GC == 0
-    frame_size = (uint32)offsetof(AOTFrame, lp) + all_cell_num * 4;
-#else
-    frame_size =
-        (uint32)offsetof(AOTFrame, lp) + align_uint(all_cell_num * 5, 4);
-#endif
+    frame_size = get_frame_size(all_cell_num);
     frame = wasm_exec_env_alloc_wasm_frame(exec_env, frame_size);
 
     if (!frame) {
@@ -2988,6 +3434,84 @@ aot_free_frame(WASMExecEnv *exec_env)
     }
 #endif
 }
+
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+bool
+aot_restore_call_chain(WASMExecEnv *exec_env,
+                       const wasm_restore_frame_t *frames, uint32 frame_count)
+{
+    AOTModuleInstance *module_inst = (AOTModuleInstance *)exec_env->module_inst;
+    AOTModule *module = (AOTModule *)module_inst->module;
+    uint8 *prev_top = wasm_exec_env_wasm_stack_top(exec_env);
+    AOTFrame **chain, *frame, *prev_frame = NULL;
+    uint32 max_local_cell_num, max_stack_cell_num, all_cell_num;
+    uint32 frame_size, i;
+    uint64 total_size = sizeof(AOTFrame *) * (uint64)frame_count;
+
+    if (exec_env->restore_call_chain) {
+        aot_set_exception(module_inst, "call chain already restored");
+        return false;
+    }
+    if (frame_count == 0)
+        return true;
+
+    if (total_size >= UINT32_MAX
+        || !(chain = wasm_runtime_malloc((uint32)total_size))) {
+        aot_set_exception(module_inst, "allocate memory failed");
+        return false;
+    }
+
+    /* Allocate the frames outermost first as the calls would do, the
+       chain is popped from its end */
+    for (i = 0; i < frame_count; i++) {
+        if (frames[i].func_index
+            >= module->import_func_count + module->func_count) {
+            aot_set_exception(module_inst, "invalid restore frame");
+            goto fail;
+        }
+
+        get_frame_cell_nums(module, frames[i].func_index, &max_local_cell_num,
+                            &max_stack_cell_num);
+        all_cell_num = max_local_cell_num + max_stack_cell_num;
+        if (frames[i].cell_num > all_cell_num
+            || frames[i].sp_offset > all_cell_num) {
+            aot_set_exception(module_inst, "invalid restore frame");
+            goto fail;
+        }
+
+        frame_size = get_frame_size(all_cell_num);
+        if (!(frame = wasm_exec_env_alloc_wasm_frame(exec_env, frame_size))) {
+            aot_set_exception(module_inst, "wasm operand stack overflow");
+            goto fail;
+        }
+        memset(frame, 0, frame_size);
+        if (frames[i].cell_num > 0)
+            bh_memcpy_s(frame->lp, all_cell_num * 4, frames[i].cells,
+                        frames[i].cell_num * 4);
+
+        frame->prev_frame = prev_frame;
+        frame->func_index = frames[i].func_index;
+        frame->ip_offset = frames[i].ip_offset;
+        frame->sp = frame->lp + frames[i].sp_offset;
+#if WASM_ENABLE_GC != 0
+        frame->frame_ref = (uint8 *)(frame->lp + all_cell_num);
+#endif
+        chain[frame_count - 1 - i] = frame;
+        prev_frame = frame;
+    }
+
+    exec_env->restore_call_chain = chain;
+    exec_env->restore_call_chain_owned = true;
+    exec_env->call_chain_size = frame_count;
+    exec_env->is_restore = true;
+    return true;
+
+fail:
+    wasm_exec_env_free_wasm_frame(exec_env, prev_top);
+    wasm_runtime_free(chain);
+    return false;
+}
+#endif /* end of WASM_ENABLE_CHECKPOINT_RESTORE != 0 */
 #endif /* end of WASM_ENABLE_AOT_STACK_FRAME != 0 */
 
 #if WASM_ENABLE_DUMP_CALL_STACK != 0
@@ -3693,3 +4217,46 @@ aot_dump_pgo_prof_data_to_buf(AOTModuleInstance *module_inst, char *buf,
     return total_size;
 }
 #endif /* end of WASM_ENABLE_STATIC_PGO != 0 */
+
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+bool
+aot_checkpoint_profile_record(WASMExecEnv *exec_env)
+{
+    AOTModuleInstance *module_inst = (AOTModuleInstance *)exec_env->module_inst;
+    AOTModule *module = (AOTModule *)module_inst->module;
+    AOTFrame *frame = (AOTFrame *)exec_env->cur_frame;
+    bool ret = false;
+
+    if (!frame || frame->func_index < module->import_func_count)
+        return false;
+
+    os_mutex_lock(&module->checkpoint_profile_lock);
+    if (!module->checkpoint_profile)
+        module->checkpoint_profile =
+            wasm_checkpoint_profile_create(CHECKPOINT_LOOP_COUNTER_PERIOD);
+    if (module->checkpoint_profile)
+        /* The profile is keyed by the non-imported function index */
+        ret = wasm_checkpoint_profile_add(
+            module->checkpoint_profile,
+            (uint32)(frame->func_index - module->import_func_count),
+            (uint64)frame->ip_offset, 1);
+    os_mutex_unlock(&module->checkpoint_profile_lock);
+    return ret;
+}
+
+bool
+aot_checkpoint_profile_save(AOTModule *module, const char *file_name)
+{
+    WASMCheckpointProfile *profile;
+    bool ret;
+
+    os_mutex_lock(&module->checkpoint_profile_lock);
+    if (!(profile = module->checkpoint_profile))
+        /* No loop ran long enough, save an empty profile */
+        profile = module->checkpoint_profile =
+            wasm_checkpoint_profile_create(CHECKPOINT_LOOP_COUNTER_PERIOD);
+    ret = profile && wasm_checkpoint_profile_save(profile, file_name);
+    os_mutex_unlock(&module->checkpoint_profile_lock);
+    return ret;
+}
+#endif /* end of WASM_ENABLE_CHECKPOINT_RESTORE != 0 */
@@ -10,6 +10,9 @@
 #include "../common/wasm_runtime_common.h"
 #include "../interpreter/wasm_runtime.h"
 #include "../compilation/aot.h"
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+#include "../common/wasm_checkpoint_profile.h"
+#endif
 
 #if WASM_ENABLE_WASI_NN != 0
 #include "../libraries/wasi-nn/src/wasi_nn_private.h"
@@ -168,6 +171,13 @@ typedef struct AOTModule {
     /* export info */
     uint32 export_count;
     AOTExport *exports;
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+    /* open addressing hash index of the exported functions by name,
+       each slot holds the order of the function in the exported
+       functions plus one, and 0 denotes an empty slot */
+    uint32 export_func_hash_size;
+    uint32 *export_func_hash;
+#endif
 
     /* start function index, -1 denotes no start function */
     uint32 start_func_index;
@@ -235,6 +245,13 @@ typedef struct AOTModule {
     /* is indirect mode or not */
     bool is_indirect_mode;
 
+#ifdef OS_ENABLE_MMAP_FILE
+    /* the .aot file mapped by aot_load_from_aot_file_mapped, the module
+       refers to it until unloaded */
+    uint8 *file_map;
+    uint32 file_map_size;
+#endif
+
 #if WASM_ENABLE_LIBC_WASI != 0
     WASIArguments wasi_args;
     bool import_wasi_api;
@@ -257,6 +274,12 @@ typedef struct AOTModule {
 #if WASM_ENABLE_LOAD_CUSTOM_SECTION != 0
     WASMCustomSection *custom_section_list;
 #endif
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+    /* Loop safepoint hits collected for checkpoint PGO, created
+       on the first hit */
+    WASMCheckpointProfile *checkpoint_profile;
+    korp_mutex checkpoint_profile_lock;
+#endif
 } AOTModule;
 
 #define AOTMemoryInstance WASMMemoryInstance
@@ -267,6 +290,37 @@ typedef struct AOTModule {
 #define AOTSubModInstNode WASMSubModInstNode
 #endif
 
+typedef struct AOTInstanceTemplate AOTInstanceTemplate;
+
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && defined(OS_ENABLE_MMAP_FILE)
+/* Snapshot of an initialized module instance, from which new instances
+   are created without running the data segments and start functions */
+struct AOTInstanceTemplate {
+    AOTModule *module;
+
+    /* the image of the linear memory, mapped copy-on-write by the
+       instances, invalid if the module has no memory */
+    os_file_handle memory_file;
+    uint32 num_bytes_per_page;
+    uint32 cur_page_count;
+    uint32 max_page_count;
+    /* page aligned size of the image */
+    uint32 memory_data_size;
+    uint32 heap_offset;
+
+    /* copy of the global data and the table data */
+    uint8 *global_table_data;
+    uint32 global_table_data_size;
+
+#if WASM_ENABLE_BULK_MEMORY != 0
+    bh_bitmap *data_dropped;
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    bh_bitmap *elem_dropped;
+#endif
+};
+#endif
+
 /* Target info, read from ELF header of object file */
 typedef struct AOTTargetInfo {
     /* Binary type, elf32l/elf32b/elf64l/elf64b */
@@ -388,6 +442,22 @@ AOTModule *
 aot_load_from_aot_file(const uint8 *buf, uint32 size, char *error_buf,
                        uint32 error_buf_size);
 
+#ifdef OS_ENABLE_MMAP_FILE
+/**
+ * Load a AOT module from aot file, the file is mapped copy-on-write
+ * instead of being read, so the pages of the text section which aren't
+ * relocated are shared with the page cache of the file
+ * @param file_path the path of the AOT file
+ * @param error_buf output of the error info
+ * @param error_buf_size the size of the error string
+ *
+ * @return return AOT module loaded, NULL if failed
+ */
+AOTModule *
+aot_load_from_aot_file_mapped(const char *file_path, char *error_buf,
+                              uint32 error_buf_size);
+#endif
+
 /**
  * Load a AOT module from a specified AOT section list.
  *
@@ -428,6 +498,56 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
                 WASMExecEnv *exec_env_main, uint32 stack_size, uint32 heap_size,
                 char *error_buf, uint32 error_buf_size);
 
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && defined(OS_ENABLE_MMAP_FILE)
+/**
+ * Create a template from an instantiated AOT module instance, the memory,
+ * globals and tables of the instance are copied, so it can be used or
+ * deinstantiated afterwards.
+ *
+ * @param module_inst the AOT module instance, which mustn't have an app heap
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return return the template created, NULL if failed
+ */
+AOTInstanceTemplate *
+aot_create_instance_template(AOTModuleInstance *module_inst, char *error_buf,
+                             uint32 error_buf_size);
+
+void
+aot_destroy_instance_template(AOTInstanceTemplate *tmpl);
+
+/**
+ * Instantiate a AOT module from a template, the linear memory is mapped
+ * copy-on-write from the memory image of the template.
+ *
+ * @param tmpl the template to instantiate
+ * @param stack_size the default wasm stack size of the instance
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return return the instantiated AOT module instance, NULL if failed
+ */
+AOTModuleInstance *
+aot_instantiate_from_template(AOTInstanceTemplate *tmpl, uint32 stack_size,
+                              char *error_buf, uint32 error_buf_size);
+
+/**
+ * Reset an instance created from a template to the state of the template,
+ * the pages written by the instance are dropped instead of being freed.
+ *
+ * @param tmpl the template the instance was created from
+ * @param module_inst the instance to reset, no thread may be running it
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return true if success, false otherwise
+ */
+bool
+aot_recycle_instance(AOTInstanceTemplate *tmpl, AOTModuleInstance *module_inst,
+                     char *error_buf, uint32 error_buf_size);
+#endif
+
 /**
  * Deinstantiate a AOT module instance, destroy the resources.
  *
@@ -437,6 +557,43 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
 void
 aot_deinstantiate(AOTModuleInstance *module_inst, bool is_sub_inst);
 
+#if WASM_ENABLE_QUICK_AOT_ENTRY != 0
+/* The precompiled entry stub to call an AOT function of some signature */
+typedef void (*AOTQuickEntry)(void *func_ptr, WASMExecEnv *exec_env,
+                              uint32 *argv, uint32 *argv_ret);
+
+/**
+ * Lookup the precompiled entry stub of a function type.
+ *
+ * @param func_type the function type
+ *
+ * @return the entry stub, or NULL if the signature of the function type
+ *         has no stub and the function must be called with invokeNative
+ */
+AOTQuickEntry
+aot_lookup_quick_entry(const AOTFuncType *func_type);
+
+/**
+ * Hash the name of an exported function for the export hash index.
+ */
+uint32
+aot_hash_export_name(const char *name);
+
+/**
+ * Create the hash index of the exported functions of an AOT module,
+ * which is used by aot_lookup_function to find a function by name.
+ *
+ * @param module the AOT module whose exports have been loaded
+ * @param error_buf output of the error info
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return true if success, false otherwise
+ */
+bool
+aot_create_export_func_hash(AOTModule *module, char *error_buf,
+                            uint32 error_buf_size);
+#endif
+
 /**
  * Lookup an exported function in the AOT module instance.
  *
@@ -678,6 +835,25 @@ void
 aot_exchange_uint64(uint8 *p_data);
 #endif /* end of WASM_ENABLE_STATIC_PGO != 0 */
 
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+bool
+aot_checkpoint_profile_record(WASMExecEnv *exec_env);
+
+bool
+aot_checkpoint_profile_save(AOTModule *module, const char *file_name);
+
+#if WASM_ENABLE_AOT_STACK_FRAME != 0
+/**
+ * Allocate the frames of a checkpointed call chain on the wasm stack,
+ * they are popped by aot_alloc_frame, outermost first. The array of the
+ * chain is owned by the exec_env.
+ */
+bool
+aot_restore_call_chain(WASMExecEnv *exec_env,
+                       const wasm_restore_frame_t *frames, uint32 frame_count);
+#endif
+#endif
+
 #ifdef __cplusplus
 } /* end of extern "C" */
 #endif
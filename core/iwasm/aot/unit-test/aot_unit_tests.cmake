@@ -0,0 +1,38 @@
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# The AOT files are compiled from wasm-apps by wamrc, which has to be built
+# first, see wamr-compiler/README.md
+find_program (WAMRC_BIN wamrc
+    HINTS ${WAMR_ROOT_DIR}/wamr-compiler/build
+)
+
+if (NOT WAMRC_BIN)
+    message (WARNING "wamrc not found, skip the AOT unit tests")
+    return ()
+endif ()
+
+set (AOT_TEST_WASM ${CMAKE_CURRENT_LIST_DIR}/wasm-apps/template.wasm)
+
+add_custom_command (
+    OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/template.aot
+           ${CMAKE_CURRENT_BINARY_DIR}/template_xip.aot
+    COMMAND ${WAMRC_BIN} -o template.aot ${AOT_TEST_WASM}
+    COMMAND ${WAMRC_BIN} --xip -o template_xip.aot ${AOT_TEST_WASM}
+    DEPENDS ${AOT_TEST_WASM}
+    WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}
+)
+add_custom_target (aot_unit_test_files
+    DEPENDS ${CMAKE_CURRENT_BINARY_DIR}/template.aot
+            ${CMAKE_CURRENT_BINARY_DIR}/template_xip.aot
+)
+
+create_wamr_unit_test(aot
+    ${CMAKE_CURRENT_LIST_DIR}/test_aot_file_mapped.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/test_call_wasm_cached.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/test_instance_template.cpp
+)
+add_dependencies (aot aot_unit_test_files)
+target_compile_definitions (aot PRIVATE
+    AOT_TEST_DIR="${CMAKE_CURRENT_BINARY_DIR}"
+)
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <gtest/gtest.h>
+
+#include "wasm_export.h"
+
+#include <fstream>
+#include <string>
+
+/*
+ * wasm_runtime_load_aot_file_mapped runs the code of the AOT text mapped
+ * from the file, the tests check that it runs the same as a module loaded
+ * from a buffer and that the code pages come from the file.
+ */
+class AotFileMappedTest : public ::testing::TestWithParam<const char *>
+{
+  protected:
+    void TearDown() override
+    {
+        if (_exec_env)
+            wasm_runtime_destroy_exec_env(_exec_env);
+        if (_inst)
+            wasm_runtime_deinstantiate(_inst);
+        if (_module)
+            wasm_runtime_unload(_module);
+    }
+
+    void load_and_instantiate(const std::string &path)
+    {
+        _module = wasm_runtime_load_aot_file_mapped(path.c_str(), _error_buf,
+                                                    sizeof(_error_buf));
+        ASSERT_NE(_module, nullptr) << _error_buf;
+        _inst = wasm_runtime_instantiate(_module, 8192, 0, _error_buf,
+                                         sizeof(_error_buf));
+        ASSERT_NE(_inst, nullptr) << _error_buf;
+        _exec_env = wasm_runtime_create_exec_env(_inst, 8192);
+        ASSERT_NE(_exec_env, nullptr);
+    }
+
+    bool call(const char *name, uint32_t argc, uint32_t argv[])
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(_inst, name, NULL);
+
+        return func && wasm_runtime_call_wasm(_exec_env, func, argc, argv);
+    }
+
+    /* Whether an executable mapping of the process comes from path */
+    static bool is_code_mapped_from(const std::string &path)
+    {
+        std::ifstream maps("/proc/self/maps");
+        std::string line;
+
+        while (std::getline(maps, line)) {
+            /* e.g. "7f0000000000-7f0000001000 r-xp 00001000 08:01 42 path" */
+            size_t perms = line.find(' ') + 1;
+            if (line.size() > path.size()
+                && line.compare(line.size() - path.size(), path.size(), path)
+                       == 0
+                && line[perms + 2] == 'x')
+                return true;
+        }
+        return false;
+    }
+
+    wasm_module_t _module = nullptr;
+    wasm_module_inst_t _inst = nullptr;
+    wasm_exec_env_t _exec_env = nullptr;
+    char _error_buf[128];
+};
+
+TEST_P(AotFileMappedTest, RunsCodeMappedFromFile)
+{
+    std::string path = std::string(AOT_TEST_DIR "/") + GetParam();
+    uint32_t argv[2];
+
+    load_and_instantiate(path);
+    EXPECT_TRUE(is_code_mapped_from(path));
+
+    /* The data segment and the start function have run */
+    argv[0] = 16;
+    ASSERT_TRUE(call("load", 1, argv)) << wasm_runtime_get_exception(_inst);
+    EXPECT_EQ(argv[0], 42u);
+    argv[0] = 32;
+    ASSERT_TRUE(call("load", 1, argv));
+    EXPECT_EQ(argv[0], 99u);
+    ASSERT_TRUE(call("get_g", 0, argv));
+    EXPECT_EQ(argv[0], 7u);
+
+    /* Calls through the table reach the relocated function pointers */
+    argv[0] = 1;
+    ASSERT_TRUE(call("call", 1, argv));
+    EXPECT_EQ(argv[0], 2u);
+
+    argv[0] = 64;
+    argv[1] = 0x12345678;
+    ASSERT_TRUE(call("store", 2, argv));
+    argv[0] = 64;
+    ASSERT_TRUE(call("load", 1, argv));
+    EXPECT_EQ(argv[0], 0x12345678u);
+
+    /* Traps still work with the code outside the anonymous mappings */
+    argv[0] = 65536;
+    EXPECT_FALSE(call("load", 1, argv));
+    EXPECT_NE(strstr(wasm_runtime_get_exception(_inst),
+                     "out of bounds memory access"),
+              nullptr);
+}
+
+TEST_P(AotFileMappedTest, FileCanBeLoadedTwice)
+{
+    std::string path = std::string(AOT_TEST_DIR "/") + GetParam();
+    wasm_module_t module2;
+    uint32_t argv[1];
+
+    load_and_instantiate(path);
+    module2 = wasm_runtime_load_aot_file_mapped(path.c_str(), _error_buf,
+                                                sizeof(_error_buf));
+    ASSERT_NE(module2, nullptr) << _error_buf;
+    wasm_runtime_unload(module2);
+
+    /* Unloading the second module leaves the first one mapped */
+    argv[0] = 0;
+    ASSERT_TRUE(call("call", 1, argv));
+    EXPECT_EQ(argv[0], 1u);
+}
+
+INSTANTIATE_TEST_SUITE_P(AotFile, AotFileMappedTest,
+                         ::testing::Values("template.aot", "template_xip.aot"));
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <gtest/gtest.h>
+
+#include "wasm_export.h"
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+/*
+ * A wasm_func_cache_t resolved in an instance must not be used for
+ * another one, even when it is created at the same address.
+ */
+class CallWasmCachedTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        std::ifstream file(AOT_TEST_DIR "/template.aot", std::ios::binary);
+
+        _buf.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+        _module = wasm_runtime_load(_buf.data(), (uint32_t)_buf.size(),
+                                    _error_buf, sizeof(_error_buf));
+        ASSERT_NE(_module, nullptr) << _error_buf;
+    }
+
+    void TearDown() override
+    {
+        if (_module)
+            wasm_runtime_unload(_module);
+    }
+
+    wasm_module_inst_t instantiate()
+    {
+        wasm_module_inst_t inst = wasm_runtime_instantiate(
+            _module, 8192, 0, _error_buf, sizeof(_error_buf));
+
+        EXPECT_NE(inst, nullptr) << _error_buf;
+        return inst;
+    }
+
+    static bool call(wasm_module_inst_t inst, wasm_func_cache_t *cache,
+                     const char *name, uint32_t argc, uint32_t argv[])
+    {
+        wasm_exec_env_t exec_env = wasm_runtime_get_exec_env_singleton(inst);
+
+        return exec_env
+               && wasm_runtime_call_wasm_cached(exec_env, cache, name, argc,
+                                                argv);
+    }
+
+    std::vector<uint8_t> _buf;
+    wasm_module_t _module = nullptr;
+    char _error_buf[128];
+};
+
+TEST_F(CallWasmCachedTest, ResolvesAgainForNewInstance)
+{
+    wasm_func_cache_t cache = { 0 };
+    wasm_module_inst_t inst;
+    uint32_t argv[2], prev_id = 0;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        ASSERT_NE(inst = instantiate(), nullptr);
+
+        argv[0] = 64;
+        argv[1] = (uint32_t)i + 1;
+        ASSERT_TRUE(call(inst, &cache, "store", 2, argv))
+            << wasm_runtime_get_exception(inst);
+
+        /* The cache resolved in the previous instance is replaced, even
+           if the new instance has the same address */
+        EXPECT_NE(cache.module_inst_id, prev_id);
+        EXPECT_EQ(cache.function,
+                  wasm_runtime_lookup_function(inst, "store", NULL));
+        prev_id = cache.module_inst_id;
+
+        wasm_runtime_deinstantiate(inst);
+    }
+}
+
+TEST_F(CallWasmCachedTest, CachesPerInstance)
+{
+    wasm_func_cache_t cache1 = { 0 }, cache2 = { 0 };
+    wasm_module_inst_t inst1, inst2;
+    uint32_t argv[1];
+
+    ASSERT_NE(inst1 = instantiate(), nullptr);
+    ASSERT_NE(inst2 = instantiate(), nullptr);
+
+    argv[0] = 16;
+    ASSERT_TRUE(call(inst1, &cache1, "load", 1, argv));
+    EXPECT_EQ(argv[0], 42u);
+    argv[0] = 1;
+    ASSERT_TRUE(call(inst2, &cache2, "call", 1, argv));
+    EXPECT_EQ(argv[0], 2u);
+    EXPECT_NE(cache1.module_inst_id, cache2.module_inst_id);
+
+    /* The resolved cache is used by the later calls */
+    argv[0] = 32;
+    ASSERT_TRUE(call(inst1, &cache1, "load", 1, argv));
+    EXPECT_EQ(argv[0], 99u);
+
+    wasm_runtime_deinstantiate(inst2);
+    wasm_runtime_deinstantiate(inst1);
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <gtest/gtest.h>
+
+#include "aot_runtime.h"
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#define PAGE_SIZE 65536
+
+/*
+ * Instances created from a template start in the state the source instance
+ * had when the template was created, and wasm_runtime_recycle_instance
+ * brings a used instance back to that state.
+ */
+class InstanceTemplateTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        _module = load(_buf);
+        ASSERT_NE(_module, nullptr);
+        _src = wasm_runtime_instantiate(_module, 8192, 0, _error_buf,
+                                        sizeof(_error_buf));
+        ASSERT_NE(_src, nullptr) << _error_buf;
+        _tmpl = wasm_runtime_create_instance_template(_src, _error_buf,
+                                                      sizeof(_error_buf));
+        ASSERT_NE(_tmpl, nullptr) << _error_buf;
+    }
+
+    void TearDown() override
+    {
+        for (wasm_module_inst_t inst : _insts)
+            wasm_runtime_deinstantiate(inst);
+        if (_tmpl)
+            wasm_runtime_destroy_instance_template(_tmpl);
+        if (_src)
+            wasm_runtime_deinstantiate(_src);
+        if (_module)
+            wasm_runtime_unload(_module);
+    }
+
+    /* The loader modifies the buffer, which must be kept until the module
+       is unloaded */
+    wasm_module_t load(std::vector<uint8_t> &buf)
+    {
+        std::ifstream file(AOT_TEST_DIR "/template.aot", std::ios::binary);
+        wasm_module_t module;
+
+        buf.assign(std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>());
+        module = wasm_runtime_load(buf.data(), (uint32_t)buf.size(),
+                                   _error_buf, sizeof(_error_buf));
+        EXPECT_NE(module, nullptr) << _error_buf;
+        return module;
+    }
+
+    wasm_module_inst_t instantiate()
+    {
+        wasm_module_inst_t inst = wasm_runtime_instantiate_from_template(
+            _tmpl, 8192, _error_buf, sizeof(_error_buf));
+
+        if (inst)
+            _insts.push_back(inst);
+        return inst;
+    }
+
+    static bool call(wasm_module_inst_t inst, const char *name,
+                     std::vector<uint32_t> args, uint32_t *p_ret = nullptr)
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(inst, name, NULL);
+        wasm_exec_env_t exec_env = wasm_runtime_get_exec_env_singleton(inst);
+        bool ret;
+
+        args.resize(2);
+        ret = func && exec_env
+              && wasm_runtime_call_wasm(exec_env, func,
+                                        wasm_func_get_param_count(func, inst),
+                                        args.data());
+        if (ret && p_ret)
+            *p_ret = args[0];
+        return ret;
+    }
+
+    static uint32_t get(wasm_module_inst_t inst, const char *name,
+                        std::vector<uint32_t> args = {})
+    {
+        uint32_t ret = 0xFFFFFFFF;
+
+        EXPECT_TRUE(call(inst, name, args, &ret))
+            << wasm_runtime_get_exception(inst);
+        return ret;
+    }
+
+    /* There is no API to change a table without reference types */
+    static uint32_t *table_elems(wasm_module_inst_t inst)
+    {
+        return ((AOTModuleInstance *)inst)->tables[0]->elems;
+    }
+
+    std::vector<uint8_t> _buf;
+    wasm_module_t _module = nullptr;
+    wasm_module_inst_t _src = nullptr;
+    wasm_instance_template_t _tmpl = nullptr;
+    std::vector<wasm_module_inst_t> _insts;
+    char _error_buf[128];
+};
+
+TEST_F(InstanceTemplateTest, StartsInStateOfTemplate)
+{
+    wasm_module_inst_t inst;
+
+    /* Changes of the source after the template is created are not seen */
+    ASSERT_TRUE(call(_src, "store", { 32, 5 }));
+    ASSERT_TRUE(call(_src, "set_g", { 8 }));
+
+    ASSERT_NE(inst = instantiate(), nullptr) << _error_buf;
+    EXPECT_EQ(get(inst, "size"), 1u);
+    EXPECT_EQ(get(inst, "load", { 16 }), 42u);
+    EXPECT_EQ(get(inst, "load", { 32 }), 99u);
+    EXPECT_EQ(get(inst, "get_g"), 7u);
+    EXPECT_EQ(get(inst, "call", { 0 }), 1u);
+    EXPECT_EQ(get(inst, "call", { 1 }), 2u);
+}
+
+TEST_F(InstanceTemplateTest, InstancesDontShareWrites)
+{
+    wasm_module_inst_t inst1, inst2;
+
+    ASSERT_NE(inst1 = instantiate(), nullptr) << _error_buf;
+    ASSERT_NE(inst2 = instantiate(), nullptr) << _error_buf;
+
+    ASSERT_TRUE(call(inst1, "store", { 32, 5 }));
+    ASSERT_TRUE(call(inst1, "set_g", { 8 }));
+    EXPECT_EQ(get(inst2, "load", { 32 }), 99u);
+    EXPECT_EQ(get(inst2, "get_g"), 7u);
+    EXPECT_EQ(get(_src, "load", { 32 }), 99u);
+}
+
+TEST_F(InstanceTemplateTest, RecycleResetsMemoryGlobalsAndTables)
+{
+    wasm_module_inst_t inst;
+    uint32_t *elems;
+
+    ASSERT_NE(inst = instantiate(), nullptr) << _error_buf;
+    elems = table_elems(inst);
+
+    ASSERT_TRUE(call(inst, "store", { 32, 5 }));
+    ASSERT_TRUE(call(inst, "store", { 100, 6 }));
+    EXPECT_EQ(get(inst, "grow", { 2 }), 1u);
+    ASSERT_TRUE(call(inst, "store", { 2 * PAGE_SIZE, 8 }));
+    ASSERT_TRUE(call(inst, "set_g", { 100 }));
+    elems[0] = elems[1];
+    EXPECT_EQ(get(inst, "call", { 0 }), 2u);
+
+    ASSERT_TRUE(wasm_runtime_recycle_instance(_tmpl, inst, _error_buf,
+                                              sizeof(_error_buf)))
+        << _error_buf;
+
+    EXPECT_EQ(get(inst, "load", { 32 }), 99u);
+    EXPECT_EQ(get(inst, "load", { 100 }), 0u);
+    EXPECT_EQ(get(inst, "get_g"), 7u);
+    EXPECT_EQ(get(inst, "call", { 0 }), 1u);
+
+    /* The grown pages are gone */
+    EXPECT_EQ(get(inst, "size"), 1u);
+    EXPECT_FALSE(call(inst, "load", { PAGE_SIZE }));
+    EXPECT_NE(strstr(wasm_runtime_get_exception(inst),
+                     "out of bounds memory access"),
+              nullptr);
+
+    /* Recycling clears the exception, and growing again gives zeroed
+       pages */
+    ASSERT_TRUE(wasm_runtime_recycle_instance(_tmpl, inst, _error_buf,
+                                              sizeof(_error_buf)))
+        << _error_buf;
+    EXPECT_EQ(wasm_runtime_get_exception(inst), nullptr);
+    EXPECT_EQ(get(inst, "grow", { 2 }), 1u);
+    EXPECT_EQ(get(inst, "load", { 2 * PAGE_SIZE }), 0u);
+}
+
+TEST_F(InstanceTemplateTest, RecycleRejectsOtherModules)
+{
+    std::vector<uint8_t> buf;
+    wasm_module_t module;
+    wasm_module_inst_t inst;
+
+    ASSERT_NE(module = load(buf), nullptr);
+    inst = wasm_runtime_instantiate(module, 8192, 0, _error_buf,
+                                    sizeof(_error_buf));
+    ASSERT_NE(inst, nullptr) << _error_buf;
+
+    EXPECT_FALSE(wasm_runtime_recycle_instance(_tmpl, inst, _error_buf,
+                                               sizeof(_error_buf)));
+
+    wasm_runtime_deinstantiate(inst);
+    wasm_runtime_unload(module);
+}
+
+TEST_F(InstanceTemplateTest, RejectsAppHeap)
+{
+    wasm_module_inst_t inst;
+
+    inst = wasm_runtime_instantiate(_module, 8192, 8192, _error_buf,
+                                    sizeof(_error_buf));
+    ASSERT_NE(inst, nullptr) << _error_buf;
+
+    EXPECT_EQ(wasm_runtime_create_instance_template(inst, _error_buf,
+                                                    sizeof(_error_buf)),
+              nullptr);
+    EXPECT_NE(strstr(_error_buf, "app heap"), nullptr);
+
+    wasm_runtime_deinstantiate(inst);
+}
@@ -0,0 +1,37 @@
+;; Copyright (C) 2019 Intel Corporation.  All rights reserved.
+;; SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+;; Source of template.wasm, the start function changes the memory and the
+;; global so that the tests can tell the state after the instantiation
+;; from the initial one.
+(module
+  (type $t (func (result i32)))
+  (memory 1 4)
+  (global $g (mut i32) (i32.const 0))
+  (table 2 funcref)
+  (elem (i32.const 0) $one $two)
+  (data (i32.const 16) "\2a\00\00\00")
+
+  (func $one (type $t) (i32.const 1))
+  (func $two (type $t) (i32.const 2))
+
+  (func $init
+    (global.set $g (i32.const 7))
+    (i32.store (i32.const 32) (i32.const 99)))
+  (start $init)
+
+  (func (export "load") (param i32) (result i32)
+    (i32.load (local.get 0)))
+  (func (export "store") (param i32 i32)
+    (i32.store (local.get 0) (local.get 1)))
+  (func (export "grow") (param i32) (result i32)
+    (memory.grow (local.get 0)))
+  (func (export "size") (result i32)
+    (memory.size))
+  (func (export "get_g") (result i32)
+    (global.get $g))
+  (func (export "set_g") (param i32)
+    (global.set $g (local.get 0)))
+  (func (export "call") (param i32) (result i32)
+    (call_indirect (type $t) (local.get 0)))
+)
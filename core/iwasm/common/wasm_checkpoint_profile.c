@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "wasm_checkpoint_profile.h"
+#include "wasm_runtime_common.h"
+
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0 || WASM_ENABLE_WAMR_COMPILER != 0 \
+    || WASM_ENABLE_JIT != 0
+
+#include <stdio.h>
+
+/* An empty slot has hit_count 0 and func_idx UINT32_MAX */
+#define EMPTY_FUNC_IDX ((uint32)-1)
+
+typedef struct CheckpointProfileHeader {
+    uint32 magic;
+    uint32 version;
+    uint32 counter_period;
+    uint32 entry_count;
+} CheckpointProfileHeader;
+
+static void
+set_error_buf(char *error_buf, uint32 error_buf_size, const char *string)
+{
+    if (error_buf != NULL) {
+        snprintf(error_buf, error_buf_size, "load checkpoint profile failed: %s",
+                 string);
+    }
+}
+
+static inline uint32
+hash_key(uint32 func_idx, uint64 ip_offset)
+{
+    uint64 key = ((uint64)func_idx << 40) ^ ip_offset;
+
+    key *= 0x9E3779B97F4A7C15ULL;
+    return (uint32)(key >> 32);
+}
+
+static WASMCheckpointProfileEntry *
+alloc_slots(uint32 slot_count)
+{
+    WASMCheckpointProfileEntry *slots;
+    uint64 total_size = sizeof(WASMCheckpointProfileEntry) * (uint64)slot_count;
+    uint32 i;
+
+    if (total_size >= UINT32_MAX
+        || !(slots = wasm_runtime_malloc((uint32)total_size)))
+        return NULL;
+
+    for (i = 0; i < slot_count; i++) {
+        slots[i].func_idx = EMPTY_FUNC_IDX;
+        slots[i].hit_count = 0;
+        slots[i].ip_offset = 0;
+    }
+    return slots;
+}
+
+static WASMCheckpointProfileEntry *
+find_slot(WASMCheckpointProfileEntry *slots, uint32 slot_count,
+          uint32 func_idx, uint64 ip_offset)
+{
+    uint32 mask = slot_count - 1, i = hash_key(func_idx, ip_offset) & mask;
+
+    /* The table is never full, so probing always terminates */
+    while (slots[i].func_idx != EMPTY_FUNC_IDX
+           && (slots[i].func_idx != func_idx
+               || slots[i].ip_offset != ip_offset))
+        i = (i + 1) & mask;
+    return &slots[i];
+}
+
+static bool
+resize_slots(WASMCheckpointProfile *profile, uint32 slot_count)
+{
+    WASMCheckpointProfileEntry *slots, *slot;
+    uint32 i;
+
+    if (!(slots = alloc_slots(slot_count)))
+        return false;
+
+    for (i = 0; i < profile->slot_count; i++) {
+        if (profile->slots[i].func_idx == EMPTY_FUNC_IDX)
+            continue;
+        slot = find_slot(slots, slot_count, profile->slots[i].func_idx,
+                         profile->slots[i].ip_offset);
+        *slot = profile->slots[i];
+    }
+
+    if (profile->slots)
+        wasm_runtime_free(profile->slots);
+    profile->slots = slots;
+    profile->slot_count = slot_count;
+    return true;
+}
+
+WASMCheckpointProfile *
+wasm_checkpoint_profile_create(uint32 counter_period)
+{
+    WASMCheckpointProfile *profile;
+
+    if (!(profile = wasm_runtime_malloc(sizeof(WASMCheckpointProfile))))
+        return NULL;
+
+    memset(profile, 0, sizeof(WASMCheckpointProfile));
+    profile->counter_period = counter_period;
+    if (!resize_slots(profile, 64)) {
+        wasm_runtime_free(profile);
+        return NULL;
+    }
+    return profile;
+}
+
+void
+wasm_checkpoint_profile_destroy(WASMCheckpointProfile *profile)
+{
+    if (!profile)
+        return;
+    if (profile->slots)
+        wasm_runtime_free(profile->slots);
+    wasm_runtime_free(profile);
+}
+
+WASMCheckpointProfileEntry *
+wasm_checkpoint_profile_lookup(const WASMCheckpointProfile *profile,
+                               uint32 func_idx, uint64 ip_offset)
+{
+    WASMCheckpointProfileEntry *slot;
+
+    if (!profile || func_idx == EMPTY_FUNC_IDX)
+        return NULL;
+
+    slot = find_slot(profile->slots, profile->slot_count, func_idx, ip_offset);
+    return slot->func_idx != EMPTY_FUNC_IDX ? slot : NULL;
+}
+
+bool
+wasm_checkpoint_profile_add(WASMCheckpointProfile *profile, uint32 func_idx,
+                            uint64 ip_offset, uint32 hit_count)
+{
+    WASMCheckpointProfileEntry *slot;
+
+    if (func_idx == EMPTY_FUNC_IDX)
+        return false;
+
+    /* Keep the load factor under 1/2 */
+    if ((profile->entry_count + 1) * 2 > profile->slot_count
+        && !resize_slots(profile, profile->slot_count * 2))
+        return false;
+
+    slot = find_slot(profile->slots, profile->slot_count, func_idx, ip_offset);
+    if (slot->func_idx == EMPTY_FUNC_IDX) {
+        slot->func_idx = func_idx;
+        slot->ip_offset = ip_offset;
+        profile->entry_count++;
+    }
+    if (slot->hit_count > UINT32_MAX - hit_count)
+        slot->hit_count = UINT32_MAX;
+    else
+        slot->hit_count += hit_count;
+    return true;
+}
+
+bool
+wasm_checkpoint_profile_is_cold_loop(const WASMCheckpointProfile *profile,
+                                     uint32 func_idx, uint64 ip_offset)
+{
+    WASMCheckpointProfileEntry *entry;
+
+    if (!profile)
+        return false;
+
+    entry = wasm_checkpoint_profile_lookup(profile, func_idx, ip_offset);
+    if (profile->is_legacy)
+        return entry != NULL;
+    return entry == NULL || entry->hit_count == 0;
+}
+
+static WASMCheckpointProfile *
+load_legacy_profile(FILE *file, char *error_buf, uint32 error_buf_size)
+{
+    WASMCheckpointProfile *profile;
+    unsigned long long ip_offset;
+    unsigned func_idx;
+    int count, i;
+
+    if (fscanf(file, "%d", &count) != 1 || count < 0) {
+        set_error_buf(error_buf, error_buf_size, "invalid entry count");
+        return NULL;
+    }
+
+    if (!(profile = wasm_checkpoint_profile_create(
+              CHECKPOINT_LOOP_COUNTER_PERIOD))) {
+        set_error_buf(error_buf, error_buf_size, "allocate memory failed");
+        return NULL;
+    }
+    profile->is_legacy = true;
+
+    for (i = 0; i < count; i++) {
+        if (fscanf(file, "%u %llu", &func_idx, &ip_offset) != 2) {
+            set_error_buf(error_buf, error_buf_size, "invalid entry");
+            goto fail;
+        }
+        if (!wasm_checkpoint_profile_add(profile, func_idx, ip_offset, 0)) {
+            set_error_buf(error_buf, error_buf_size, "allocate memory failed");
+            goto fail;
+        }
+    }
+    return profile;
+
+fail:
+    wasm_checkpoint_profile_destroy(profile);
+    return NULL;
+}
+
+WASMCheckpointProfile *
+wasm_checkpoint_profile_load(const char *file_name, char *error_buf,
+                             uint32 error_buf_size)
+{
+    WASMCheckpointProfile *profile = NULL;
+    CheckpointProfileHeader header;
+    WASMCheckpointProfileEntry entry;
+    FILE *file;
+    uint32 i;
+
+    if (!(file = fopen(file_name, "rb"))) {
+        set_error_buf(error_buf, error_buf_size, "open file failed");
+        return NULL;
+    }
+
+    if (fread(&header, sizeof(header), 1, file) != 1
+        || header.magic != CHECKPOINT_PROFILE_MAGIC) {
+        rewind(file);
+        profile = load_legacy_profile(file, error_buf, error_buf_size);
+        fclose(file);
+        return profile;
+    }
+
+    if (header.version != CHECKPOINT_PROFILE_VERSION) {
+        set_error_buf(error_buf, error_buf_size, "unsupported version");
+        goto fail;
+    }
+
+    if (!(profile = wasm_checkpoint_profile_create(header.counter_period))) {
+        set_error_buf(error_buf, error_buf_size, "allocate memory failed");
+        goto fail;
+    }
+
+    for (i = 0; i < header.entry_count; i++) {
+        if (fread(&entry, sizeof(entry), 1, file) != 1) {
+            set_error_buf(error_buf, error_buf_size, "unexpected end");
+            goto fail;
+        }
+        if (!wasm_checkpoint_profile_add(profile, entry.func_idx,
+                                         entry.ip_offset, entry.hit_count)) {
+            set_error_buf(error_buf, error_buf_size, "invalid entry");
+            goto fail;
+        }
+    }
+
+    fclose(file);
+    return profile;
+
+fail:
+    wasm_checkpoint_profile_destroy(profile);
+    fclose(file);
+    return NULL;
+}
+
+bool
+wasm_checkpoint_profile_save(const WASMCheckpointProfile *profile,
+                             const char *file_name)
+{
+    CheckpointProfileHeader header;
+    FILE *file;
+    uint32 i;
+    bool ret = true;
+
+    if (!(file = fopen(file_name, "wb")))
+        return false;
+
+    header.magic = CHECKPOINT_PROFILE_MAGIC;
+    header.version = CHECKPOINT_PROFILE_VERSION;
+    header.counter_period = profile->counter_period;
+    header.entry_count = profile->entry_count;
+    if (fwrite(&header, sizeof(header), 1, file) != 1)
+        ret = false;
+
+    for (i = 0; ret && i < profile->slot_count; i++) {
+        if (profile->slots[i].func_idx == EMPTY_FUNC_IDX)
+            continue;
+        if (fwrite(&profile->slots[i], sizeof(WASMCheckpointProfileEntry), 1,
+                   file)
+            != 1)
+            ret = false;
+    }
+
+    if (fclose(file) != 0)
+        ret = false;
+    return ret;
+}
+
+#endif /* end of WASM_ENABLE_CHECKPOINT_RESTORE != 0 \
+          || WASM_ENABLE_WAMR_COMPILER != 0 || WASM_ENABLE_JIT != 0 */
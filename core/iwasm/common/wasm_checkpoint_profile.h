@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _WASM_CHECKPOINT_PROFILE_H
+#define _WASM_CHECKPOINT_PROFILE_H
+
+#include "bh_platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Checkpoint PGO profile, stored in "<aot_file>.pgo".
+ *
+ * Binary layout (little endian):
+ *   uint32 magic            "WCPG"
+ *   uint32 version
+ *   uint32 counter_period   loop iterations between two counter safepoints
+ *   uint32 entry_count
+ *   entry_count * { uint32 func_idx; uint32 hit_count; uint64 ip_offset; }
+ *
+ * Each entry is a loop safepoint, keyed by the non-imported function index
+ * and the bytecode offset of the loop body, whose counter reached
+ * counter_period during a single activation hit_count times. Loops absent
+ * from a binary profile never ran that long, so the compiler may drop their
+ * safepoints.
+ *
+ * The legacy text format ("<count>" followed by "<func_idx> <ip_offset>"
+ * lines) is still accepted; it lists the loops whose safepoints are to be
+ * dropped.
+ */
+#define CHECKPOINT_PROFILE_MAGIC 0x47504357
+#define CHECKPOINT_PROFILE_VERSION 1
+
+/* Default loop iterations between two counter loop safepoints */
+#define CHECKPOINT_LOOP_COUNTER_PERIOD (1 << 20)
+
+typedef struct WASMCheckpointProfileEntry {
+    uint32 func_idx;
+    uint32 hit_count;
+    uint64 ip_offset;
+} WASMCheckpointProfileEntry;
+
+typedef struct WASMCheckpointProfile {
+    uint32 counter_period;
+    /* true if loaded from the legacy text format */
+    bool is_legacy;
+    uint32 entry_count;
+    /* open addressing hash table, always a power of 2 */
+    uint32 slot_count;
+    WASMCheckpointProfileEntry *slots;
+} WASMCheckpointProfile;
+
+WASMCheckpointProfile *
+wasm_checkpoint_profile_create(uint32 counter_period);
+
+void
+wasm_checkpoint_profile_destroy(WASMCheckpointProfile *profile);
+
+/**
+ * Load a profile from a file, either in the binary or the legacy text
+ * format. Returns NULL if the file doesn't exist or is malformed.
+ */
+WASMCheckpointProfile *
+wasm_checkpoint_profile_load(const char *file_name, char *error_buf,
+                             uint32 error_buf_size);
+
+bool
+wasm_checkpoint_profile_save(const WASMCheckpointProfile *profile,
+                             const char *file_name);
+
+WASMCheckpointProfileEntry *
+wasm_checkpoint_profile_lookup(const WASMCheckpointProfile *profile,
+                               uint32 func_idx, uint64 ip_offset);
+
+/**
+ * Add hit_count hits to the entry of a loop safepoint, creating it
+ * if needed.
+ */
+bool
+wasm_checkpoint_profile_add(WASMCheckpointProfile *profile, uint32 func_idx,
+                            uint64 ip_offset, uint32 hit_count);
+
+/**
+ * Whether the safepoint of the loop can be dropped according to the
+ * profile.
+ */
+bool
+wasm_checkpoint_profile_is_cold_loop(const WASMCheckpointProfile *profile,
+                                     uint32 func_idx, uint64 ip_offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _WASM_CHECKPOINT_PROFILE_H */
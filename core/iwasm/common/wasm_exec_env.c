@@ -14,6 +14,7 @@
 
 #if WASM_ENABLE_AOT != 0
 #include "aot_runtime.h"
+#include "wasm_checkpoint_profile.h"
 #endif
 
 #if WASM_ENABLE_THREAD_MGR != 0
@@ -23,6 +24,11 @@
 #endif
 #endif
 
+#if WASM_ENABLE_AOT != 0 || WASM_ENABLE_JIT != 0
+/* Checkpoint loop period of the exec_envs created from now on */
+static uint32 default_checkpoint_loop_period = CHECKPOINT_LOOP_COUNTER_PERIOD;
+#endif
+
 WASMExecEnv *
 wasm_exec_env_create_internal(struct WASMModuleInstanceCommon *module_inst,
                               uint32 stack_size)
@@ -77,6 +83,9 @@ wasm_exec_env_create_internal(struct WASMModuleInstanceCommon *module_inst,
         exec_env->native_symbol = m->native_symbol_list;
     }
 #endif
+#if WASM_ENABLE_AOT != 0 || WASM_ENABLE_JIT != 0
+    exec_env->checkpoint_loop_period.period = default_checkpoint_loop_period;
+#endif
 
 #if WASM_ENABLE_MEMORY_TRACING != 0
     wasm_runtime_dump_exec_env_mem_consumption(exec_env);
@@ -86,6 +95,7 @@ wasm_exec_env_create_internal(struct WASMModuleInstanceCommon *module_inst,
     exec_env->is_restore = false;
     exec_env->call_chain_size = 0;
     exec_env->restore_call_chain = NULL;
+    exec_env->restore_call_chain_owned = false;
     return exec_env;
 
 #ifdef OS_ENABLE_HW_BOUND_CHECK
@@ -127,6 +137,9 @@ wasm_exec_env_destroy_internal(WASMExecEnv *exec_env)
 #if WASM_ENABLE_AOT != 0
     wasm_runtime_free(exec_env->argv_buf);
 #endif
+    /* The thread exited before popping all the restored frames */
+    if (exec_env->restore_call_chain_owned)
+        wasm_runtime_free(exec_env->restore_call_chain);
     wasm_runtime_free(exec_env);
 }
 
@@ -287,6 +300,41 @@ wasm_exec_env_set_thread_arg(WASMExecEnv *exec_env, void *thread_arg)
 }
 #endif
 
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+void
+wasm_exec_env_request_checkpoint(WASMExecEnv *exec_env)
+{
+    exec_env->is_checkpoint = true;
+    /* The running thread polls this flag at its safepoints and only
+       syncs its frame state when the flag is set */
+    WASM_SUSPEND_FLAGS_FETCH_OR(exec_env->suspend_flags,
+                                WASM_SUSPEND_FLAG_CHECKPOINT);
+}
+
+void
+wasm_exec_env_clear_checkpoint(WASMExecEnv *exec_env)
+{
+    WASM_SUSPEND_FLAGS_FETCH_AND(exec_env->suspend_flags,
+                                 ~WASM_SUSPEND_FLAG_CHECKPOINT);
+    exec_env->is_checkpoint = false;
+}
+#endif
+
+#if WASM_ENABLE_AOT != 0 || WASM_ENABLE_JIT != 0
+void
+wasm_exec_env_set_default_checkpoint_loop_period(uint32 period)
+{
+    default_checkpoint_loop_period = period > 0 ? period : 1;
+}
+
+void
+wasm_exec_env_set_checkpoint_loop_period(WASMExecEnv *exec_env, uint32 period)
+{
+    /* Takes effect at the next loop entry or checkpoint of the thread */
+    exec_env->checkpoint_loop_period.period = period > 0 ? period : 1;
+}
+#endif
+
 #ifdef OS_ENABLE_HW_BOUND_CHECK
 void
 wasm_exec_env_push_jmpbuf(WASMExecEnv *exec_env, WASMJmpBuf *jmpbuf)
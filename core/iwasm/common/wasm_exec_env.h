@@ -42,9 +42,9 @@ typedef struct WASMExecEnv {
     struct WASMInterpFrame *cur_frame;
 
     /* Note: field module_inst, argv_buf, native_stack_boundary,
-       suspend_flags, aux_stack_boundary, aux_stack_bottom, and
-       native_symbol are used by AOTed code, don't change the
-       places of them */
+       suspend_flags, aux_stack_boundary, aux_stack_bottom,
+       native_symbol and checkpoint_loop_period are used by AOTed
+       code, don't change the places of them */
 
     /* The WASM module instance of current thread */
     struct WASMModuleInstanceCommon *module_inst;
@@ -84,6 +84,15 @@ typedef struct WASMExecEnv {
      */
     uint8 *native_stack_top_min;
 
+#if WASM_ENABLE_AOT != 0 || WASM_ENABLE_JIT != 0
+    /* Loop iterations between two counter loop checkpoints, read by
+       AOTed and LLVM JITed code when entering a loop and after each checkpoint */
+    union {
+        uint32 period;
+        uintptr_t __padding__;
+    } checkpoint_loop_period;
+#endif
+
 #if WASM_ENABLE_FAST_JIT != 0
     /**
      * Cache for
@@ -148,8 +157,14 @@ typedef struct WASMExecEnv {
     bool is_checkpoint;
     /* Whether is restore */
     bool is_restore;
+    /* Frames of a checkpointed call chain not yet popped by the AOT code,
+       the last one is the outermost */
     size_t call_chain_size;
     struct AOTFrame **restore_call_chain;
+    /* Whether restore_call_chain was allocated by aot_restore_call_chain,
+       only then the runtime frees it. A chain installed directly by the
+       embedder stays owned by the embedder */
+    bool restore_call_chain_owned;
 
     /* The WASM stack of current thread */
     union {
@@ -309,6 +324,35 @@ void
 wasm_exec_env_set_thread_arg(WASMExecEnv *exec_env, void *thread_arg);
 #endif
 
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+/**
+ * Request a checkpoint of the exec env, the thread running it takes the
+ * checkpoint when it reaches its next safepoint (loop back-edge, call or
+ * return).
+ *
+ * @param exec_env the execution environment to checkpoint
+ */
+void
+wasm_exec_env_request_checkpoint(WASMExecEnv *exec_env);
+
+/**
+ * Clear a pending checkpoint request of the exec env.
+ *
+ * @param exec_env the execution environment
+ */
+void
+wasm_exec_env_clear_checkpoint(WASMExecEnv *exec_env);
+#endif
+
+#if WASM_ENABLE_AOT != 0 || WASM_ENABLE_JIT != 0
+void
+wasm_exec_env_set_default_checkpoint_loop_period(uint32 period);
+
+void
+wasm_exec_env_set_checkpoint_loop_period(WASMExecEnv *exec_env,
+                                         uint32 period);
+#endif
+
 #ifdef OS_ENABLE_HW_BOUND_CHECK
 void
 wasm_exec_env_push_jmpbuf(WASMExecEnv *exec_env, WASMJmpBuf *jmpbuf);
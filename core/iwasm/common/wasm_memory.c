@@ -51,6 +51,9 @@ wasm_memory_init_with_pool(void *mem, unsigned int bytes)
         memory_mode = MEMORY_MODE_POOL;
         pool_allocator = _allocator;
         global_pool_size = bytes;
+        /* Let the small runtime allocations of each thread bypass the
+           pool lock when possible */
+        mem_allocator_enable_thread_cache(_allocator);
         return true;
     }
     LOG_ERROR("Init memory with pool (%p, %u) failed.\n", mem, bytes);
@@ -150,6 +153,13 @@ wasm_runtime_memory_destroy()
     memory_mode = MEMORY_MODE_UNKNOWN;
 }
 
+void
+wasm_runtime_memory_flush_thread_cache()
+{
+    if (memory_mode == MEMORY_MODE_POOL)
+        mem_allocator_flush_thread_cache(pool_allocator);
+}
+
 unsigned
 wasm_runtime_memory_pool_size()
 {
@@ -916,3 +926,318 @@ wasm_enlarge_memory(WASMModuleInstance *module, uint32 inc_page_count)
 
     return ret;
 }
+
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+/* "WMSN" */
+#define MEMORY_SNAPSHOT_MAGIC 0x4e534d57
+#define MEMORY_SNAPSHOT_VERSION 1
+
+enum {
+    MEMORY_SNAPSHOT_BASE = 0,
+    MEMORY_SNAPSHOT_DELTA = 1,
+};
+
+typedef struct MemorySnapshotHeader {
+    uint32 magic;
+    uint32 version;
+    /* MEMORY_SNAPSHOT_BASE or MEMORY_SNAPSHOT_DELTA */
+    uint32 kind;
+    /* Granularity of the page records */
+    uint32 page_size;
+    /* Page layout of the linear memory */
+    uint32 num_bytes_per_page;
+    uint32 cur_page_count;
+    uint32 memory_data_size;
+    /* Number of the page records following the header, each record is
+       a uint32 page index followed by the content of the page */
+    uint32 record_count;
+} MemorySnapshotHeader;
+
+#define BITMAP_IS_SET(bitmap, i) ((bitmap)[(i) >> 3] & (1 << ((i)&7)))
+
+/* Number of the OS pages covering the given size */
+static uint32
+os_page_count(uint64 size)
+{
+    uint32 page_size = (uint32)os_getpagesize();
+    return (uint32)((size + page_size - 1) / page_size);
+}
+
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && defined(OS_ENABLE_MEM_SOFT_DIRTY)
+/**
+ * Dirty page tracker of a linear memory. As the memory is reserved by
+ * os_mmap and never moves, the pages written are reported by the
+ * soft-dirty bits. Clearing them is process wide, so before clearing, the
+ * bits of the other tracked memories are saved into their bitmaps.
+ */
+typedef struct MemoryDirtyTracker {
+    struct MemoryDirtyTracker *next;
+    WASMMemoryInstance *memory;
+    /* Pages written before the last clear of the soft-dirty bits */
+    uint8 *bitmap;
+    /* Bitmap size in bytes, covering the max page count of the memory */
+    uint32 bitmap_size;
+} MemoryDirtyTracker;
+
+static MemoryDirtyTracker *dirty_trackers = NULL;
+static korp_mutex dirty_trackers_lock = OS_THREAD_MUTEX_INITIALIZER;
+
+static MemoryDirtyTracker *
+find_dirty_tracker(WASMMemoryInstance *memory)
+{
+    MemoryDirtyTracker *tracker = dirty_trackers;
+
+    while (tracker && tracker->memory != memory)
+        tracker = tracker->next;
+    return tracker;
+}
+
+static void
+remove_dirty_tracker(MemoryDirtyTracker *tracker)
+{
+    MemoryDirtyTracker **p_tracker = &dirty_trackers;
+
+    while (*p_tracker != tracker)
+        p_tracker = &(*p_tracker)->next;
+    *p_tracker = tracker->next;
+    wasm_runtime_free(tracker);
+}
+
+/**
+ * Get the pages of the memory written since its previous snapshot and
+ * restart the tracking, the returned bitmap is NULL if the written pages
+ * can't be told apart, and then all the pages are treated as written.
+ */
+static bool
+take_dirty_pages(WASMMemoryInstance *memory, bool incremental,
+                 uint8 **p_bitmap)
+{
+    MemoryDirtyTracker *tracker, *other;
+    uint64 max_data_size, total_size;
+    uint32 page_size = (uint32)os_getpagesize(), page_count, bitmap_size;
+    uint8 *bitmap = NULL;
+
+    *p_bitmap = NULL;
+    page_count = os_page_count(memory->memory_data_size);
+
+    os_mutex_lock(&dirty_trackers_lock);
+
+    if (!(tracker = find_dirty_tracker(memory))) {
+        max_data_size =
+            (uint64)memory->num_bytes_per_page * memory->max_page_count;
+        bitmap_size = (os_page_count(max_data_size) + 7) / 8;
+        total_size = sizeof(MemoryDirtyTracker) + (uint64)bitmap_size;
+        if (total_size >= UINT32_MAX
+            || !(tracker = wasm_runtime_malloc((uint32)total_size))) {
+            os_mutex_unlock(&dirty_trackers_lock);
+            return false;
+        }
+        tracker->memory = memory;
+        tracker->bitmap = (uint8 *)(tracker + 1);
+        tracker->bitmap_size = bitmap_size;
+        tracker->next = dirty_trackers;
+        dirty_trackers = tracker;
+        /* No previous snapshot, all the pages must be taken */
+        incremental = false;
+    }
+
+    if (incremental) {
+        bitmap_size = (page_count + 7) / 8;
+        bh_assert(bitmap_size <= tracker->bitmap_size);
+        if ((bitmap = wasm_runtime_malloc(bitmap_size ? bitmap_size : 1))) {
+            bh_memcpy_s(bitmap, bitmap_size, tracker->bitmap, bitmap_size);
+            if (os_mem_get_soft_dirty(memory->memory_data,
+                                      (size_t)page_count * page_size, bitmap)
+                != 0) {
+                wasm_runtime_free(bitmap);
+                bitmap = NULL;
+            }
+        }
+    }
+
+    /* Save the pages written in the other memories before their
+       soft-dirty bits are cleared, conservatively treat all of their
+       pages as written if that fails */
+    for (other = dirty_trackers; other; other = other->next) {
+        if (other == tracker)
+            continue;
+        if (os_mem_get_soft_dirty(
+                other->memory->memory_data,
+                (size_t)os_page_count(other->memory->memory_data_size)
+                    * page_size,
+                other->bitmap)
+            != 0)
+            memset(other->bitmap, 0xFF, other->bitmap_size);
+    }
+
+    if (os_mem_clear_soft_dirty() != 0) {
+        /* Soft-dirty bits aren't available, stop tracking so that all
+           the later snapshots are base images */
+        remove_dirty_tracker(tracker);
+        if (bitmap)
+            wasm_runtime_free(bitmap);
+        bitmap = NULL;
+    }
+    else {
+        memset(tracker->bitmap, 0, tracker->bitmap_size);
+    }
+
+    os_mutex_unlock(&dirty_trackers_lock);
+
+    *p_bitmap = bitmap;
+    return true;
+}
+
+void
+wasm_memory_dirty_tracker_destroy(WASMMemoryInstance *memory)
+{
+    MemoryDirtyTracker *tracker;
+
+    os_mutex_lock(&dirty_trackers_lock);
+    if ((tracker = find_dirty_tracker(memory)))
+        remove_dirty_tracker(tracker);
+    os_mutex_unlock(&dirty_trackers_lock);
+}
+#else
+static bool
+take_dirty_pages(WASMMemoryInstance *memory, bool incremental,
+                 uint8 **p_bitmap)
+{
+    (void)memory;
+    (void)incremental;
+    *p_bitmap = NULL;
+    return true;
+}
+
+void
+wasm_memory_dirty_tracker_destroy(WASMMemoryInstance *memory)
+{
+    (void)memory;
+}
+#endif /* end of OS_ENABLE_HW_BOUND_CHECK && OS_ENABLE_MEM_SOFT_DIRTY */
+
+bool
+wasm_runtime_snapshot_memory(WASMModuleInstanceCommon *module_inst_comm,
+                             bool incremental,
+                             wasm_memory_snapshot_write_func_t write_func,
+                             void *user_data)
+{
+    WASMModuleInstance *module_inst = (WASMModuleInstance *)module_inst_comm;
+    WASMMemoryInstance *memory;
+    MemorySnapshotHeader header = { 0 };
+    uint32 page_size = (uint32)os_getpagesize(), page_count, i;
+    uint64 offset;
+    uint8 *bitmap = NULL;
+    bool ret = false;
+
+    bh_assert(module_inst_comm->module_type == Wasm_Module_Bytecode
+              || module_inst_comm->module_type == Wasm_Module_AoT);
+
+    if (!(memory = wasm_get_default_memory(module_inst)))
+        return false;
+
+    if (!take_dirty_pages(memory, incremental, &bitmap))
+        return false;
+
+    page_count = os_page_count(memory->memory_data_size);
+
+    header.magic = MEMORY_SNAPSHOT_MAGIC;
+    header.version = MEMORY_SNAPSHOT_VERSION;
+    header.kind = bitmap ? MEMORY_SNAPSHOT_DELTA : MEMORY_SNAPSHOT_BASE;
+    header.page_size = page_size;
+    header.num_bytes_per_page = memory->num_bytes_per_page;
+    header.cur_page_count = memory->cur_page_count;
+    header.memory_data_size = memory->memory_data_size;
+    if (bitmap) {
+        for (i = 0; i < page_count; i++) {
+            if (BITMAP_IS_SET(bitmap, i))
+                header.record_count++;
+        }
+    }
+    else {
+        header.record_count = page_count;
+    }
+
+    if (!write_func(user_data, &header, sizeof(header)))
+        goto fail;
+
+    for (i = 0; i < page_count; i++) {
+        if (bitmap && !BITMAP_IS_SET(bitmap, i))
+            continue;
+        offset = (uint64)i * page_size;
+        if (!write_func(user_data, &i, sizeof(uint32))
+            || !write_func(user_data, memory->memory_data + offset,
+                           (uint32)(memory->memory_data_size - offset
+                                            < page_size
+                                        ? memory->memory_data_size - offset
+                                        : page_size)))
+            goto fail;
+    }
+
+    ret = true;
+fail:
+    if (bitmap)
+        wasm_runtime_free(bitmap);
+    return ret;
+}
+
+bool
+wasm_runtime_restore_memory_snapshot(
+    WASMModuleInstanceCommon *module_inst_comm,
+    wasm_memory_snapshot_read_func_t read_func, void *user_data)
+{
+    WASMModuleInstance *module_inst = (WASMModuleInstance *)module_inst_comm;
+    WASMMemoryInstance *memory;
+    MemorySnapshotHeader header;
+    uint32 i, page_index, size;
+    uint64 offset;
+
+    bh_assert(module_inst_comm->module_type == Wasm_Module_Bytecode
+              || module_inst_comm->module_type == Wasm_Module_AoT);
+
+    if (!(memory = wasm_get_default_memory(module_inst)))
+        return false;
+
+    if (!read_func(user_data, &header, sizeof(header)))
+        return false;
+
+    if (header.magic != MEMORY_SNAPSHOT_MAGIC
+        || header.version != MEMORY_SNAPSHOT_VERSION
+        || (header.kind != MEMORY_SNAPSHOT_BASE
+            && header.kind != MEMORY_SNAPSHOT_DELTA)
+        || header.page_size == 0
+        || header.num_bytes_per_page != memory->num_bytes_per_page) {
+        LOG_ERROR("invalid linear memory snapshot");
+        return false;
+    }
+
+    /* The memory can only grow */
+    if (header.cur_page_count < memory->cur_page_count) {
+        LOG_ERROR("linear memory snapshot is smaller than the memory");
+        return false;
+    }
+    if (header.cur_page_count > memory->cur_page_count
+        && !wasm_enlarge_memory(module_inst, header.cur_page_count
+                                                 - memory->cur_page_count)) {
+        LOG_ERROR("failed to enlarge memory for the snapshot");
+        return false;
+    }
+
+    for (i = 0; i < header.record_count; i++) {
+        if (!read_func(user_data, &page_index, sizeof(uint32)))
+            return false;
+        offset = (uint64)page_index * header.page_size;
+        if (offset >= memory->memory_data_size) {
+            LOG_ERROR("invalid page index in linear memory snapshot");
+            return false;
+        }
+        size = (uint32)(memory->memory_data_size - offset < header.page_size
+                            ? memory->memory_data_size - offset
+                            : header.page_size);
+        if (!read_func(user_data, memory->memory_data + offset, size))
+            return false;
+    }
+
+    return true;
+}
+#endif /* end of WASM_ENABLE_CHECKPOINT_RESTORE != 0 */
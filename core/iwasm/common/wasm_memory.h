@@ -21,6 +21,11 @@ wasm_runtime_memory_init(mem_alloc_type_t mem_alloc_type,
 void
 wasm_runtime_memory_destroy();
 
+/* Return the pool memory cached by the calling thread, called when a
+   thread exits */
+void
+wasm_runtime_memory_flush_thread_cache();
+
 unsigned
 wasm_runtime_memory_pool_size();
 
@@ -28,6 +33,11 @@ void
 wasm_runtime_set_mem_bound_check_bytes(WASMMemoryInstance *memory,
                                        uint64 memory_data_size);
 
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+void
+wasm_memory_dirty_tracker_destroy(WASMMemoryInstance *memory);
+#endif
+
 void
 wasm_runtime_set_enlarge_mem_error_callback(
     const enlarge_memory_error_callback_t callback, void *user_data);
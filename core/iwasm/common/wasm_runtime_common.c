@@ -498,6 +498,14 @@ wasm_runtime_env_init()
     os_end_blocking_op();
 #endif
 
+#if WASM_ENABLE_LIBC_WASI != 0 && defined(OS_ENABLE_IO_URING)
+    /* WASI keeps using the synchronous I/O if io_uring isn't available,
+       e.g. disabled by seccomp */
+    if (os_io_uring_init() != BHT_OK) {
+        LOG_VERBOSE("io_uring isn't available for WASI I/O");
+    }
+#endif
+
     return true;
 
 #if WASM_ENABLE_THREAD_MGR != 0 && defined(OS_ENABLE_WAKEUP_BLOCKING_OP)
@@ -631,6 +639,10 @@ wasm_runtime_destroy()
     thread_manager_destroy();
 #endif
 
+#if WASM_ENABLE_LIBC_WASI != 0 && defined(OS_ENABLE_IO_URING)
+    os_io_uring_destroy();
+#endif
+
     wasm_native_destroy();
     bh_platform_destroy();
 
@@ -665,6 +677,9 @@ wasm_runtime_full_init(RuntimeInitArgs *init_args)
 
 #if WASM_ENABLE_FAST_JIT != 0
     jit_options.code_cache_size = init_args->fast_jit_code_cache_size;
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    jit_options.cache_dir = init_args->fast_jit_cache_dir;
+#endif
 #endif
 
 #if WASM_ENABLE_JIT != 0
@@ -1262,6 +1277,29 @@ wasm_runtime_load(uint8 *buf, uint32 size, char *error_buf,
                                           error_buf_size);
 }
 
+WASMModuleCommon *
+wasm_runtime_load_aot_file_mapped(const char *file_path, char *error_buf,
+                                  uint32 error_buf_size)
+{
+#if WASM_ENABLE_AOT != 0 && defined(OS_ENABLE_MMAP_FILE)
+    WASMModuleCommon *module_common =
+        (WASMModuleCommon *)aot_load_from_aot_file_mapped(
+            file_path, error_buf, error_buf_size);
+
+    if (!module_common) {
+        LOG_DEBUG("AOT module load failed from mapped file");
+        return NULL;
+    }
+    return register_module_with_null_name(module_common, error_buf,
+                                          error_buf_size);
+#else
+    (void)file_path;
+    set_error_buf(error_buf, error_buf_size,
+                  "WASM module load failed: mapping aot file isn't supported");
+    return NULL;
+#endif
+}
+
 WASMModuleCommon *
 wasm_runtime_load_from_sections(WASMSection *section_list, bool is_aot,
                                 char *error_buf, uint32 error_buf_size)
@@ -1359,6 +1397,71 @@ wasm_runtime_instantiate(WASMModuleCommon *module, uint32 stack_size,
         module, NULL, NULL, stack_size, heap_size, error_buf, error_buf_size);
 }
 
+wasm_instance_template_t
+wasm_runtime_create_instance_template(WASMModuleInstanceCommon *module_inst,
+                                      char *error_buf, uint32 error_buf_size)
+{
+#if WASM_ENABLE_AOT != 0 && defined(OS_ENABLE_HW_BOUND_CHECK) \
+    && defined(OS_ENABLE_MMAP_FILE)
+    if (module_inst->module_type == Wasm_Module_AoT)
+        return (wasm_instance_template_t)aot_create_instance_template(
+            (AOTModuleInstance *)module_inst, error_buf, error_buf_size);
+#endif
+    (void)module_inst;
+    set_error_buf(error_buf, error_buf_size,
+                  "Create instance template failed: unsupported module type");
+    return NULL;
+}
+
+void
+wasm_runtime_destroy_instance_template(wasm_instance_template_t tmpl)
+{
+#if WASM_ENABLE_AOT != 0 && defined(OS_ENABLE_HW_BOUND_CHECK) \
+    && defined(OS_ENABLE_MMAP_FILE)
+    aot_destroy_instance_template((AOTInstanceTemplate *)tmpl);
+#else
+    (void)tmpl;
+#endif
+}
+
+WASMModuleInstanceCommon *
+wasm_runtime_instantiate_from_template(wasm_instance_template_t tmpl,
+                                       uint32 default_stack_size,
+                                       char *error_buf, uint32 error_buf_size)
+{
+#if WASM_ENABLE_AOT != 0 && defined(OS_ENABLE_HW_BOUND_CHECK) \
+    && defined(OS_ENABLE_MMAP_FILE)
+    return (WASMModuleInstanceCommon *)aot_instantiate_from_template(
+        (AOTInstanceTemplate *)tmpl, default_stack_size, error_buf,
+        error_buf_size);
+#else
+    (void)tmpl;
+    (void)default_stack_size;
+    set_error_buf(error_buf, error_buf_size,
+                  "Instantiate module failed: unsupported template");
+    return NULL;
+#endif
+}
+
+bool
+wasm_runtime_recycle_instance(wasm_instance_template_t tmpl,
+                              WASMModuleInstanceCommon *module_inst,
+                              char *error_buf, uint32 error_buf_size)
+{
+#if WASM_ENABLE_AOT != 0 && defined(OS_ENABLE_HW_BOUND_CHECK) \
+    && defined(OS_ENABLE_MMAP_FILE)
+    if (module_inst->module_type == Wasm_Module_AoT)
+        return aot_recycle_instance((AOTInstanceTemplate *)tmpl,
+                                    (AOTModuleInstance *)module_inst,
+                                    error_buf, error_buf_size);
+#endif
+    (void)tmpl;
+    (void)module_inst;
+    set_error_buf(error_buf, error_buf_size,
+                  "Recycle instance failed: unsupported module type");
+    return false;
+}
+
 void
 wasm_runtime_deinstantiate_internal(WASMModuleInstanceCommon *module_inst,
                                     bool is_sub_inst)
@@ -1464,6 +1567,8 @@ wasm_runtime_init_thread_env(void)
 void
 wasm_runtime_destroy_thread_env(void)
 {
+    wasm_runtime_memory_flush_thread_cache();
+
 #ifdef OS_ENABLE_HW_BOUND_CHECK
     runtime_signal_destroy();
 #endif
@@ -2062,6 +2167,111 @@ wasm_runtime_call_wasm(WASMExecEnv *exec_env,
     return ret;
 }
 
+static bh_atomic_32_t next_module_inst_id = 1;
+
+uint32
+wasm_runtime_new_module_inst_id(void)
+{
+    uint32 id;
+
+    /* Skip 0 when the counter wraps around */
+    while ((id = BH_ATOMIC_32_FETCH_ADD(next_module_inst_id, 1)) == 0)
+        ;
+    return id;
+}
+
+static uint32
+get_module_inst_id(WASMModuleInstanceCommon *module_inst)
+{
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        return ((WASMModuleInstanceExtra *)((WASMModuleInstance *)module_inst)
+                    ->e)
+            ->common.module_inst_id;
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT)
+        return ((AOTModuleInstanceExtra *)((AOTModuleInstance *)module_inst)
+                    ->e)
+            ->common.module_inst_id;
+#endif
+    return 0;
+}
+
+bool
+wasm_runtime_call_wasm_cached(WASMExecEnv *exec_env, wasm_func_cache_t *cache,
+                              const char *name, uint32 argc, uint32 argv[])
+{
+    WASMModuleInstanceCommon *module_inst;
+    uint32 module_inst_id;
+    WASMFunctionInstanceCommon *function;
+    WASMType *func_type;
+#if WASM_ENABLE_REF_TYPES != 0
+    uint32 i;
+#endif
+
+    if (!wasm_runtime_exec_env_check(exec_env)) {
+        LOG_ERROR("Invalid exec env stack info.");
+        return false;
+    }
+
+    module_inst = exec_env->module_inst;
+    module_inst_id = get_module_inst_id(module_inst);
+    if (cache->module_inst_id != module_inst_id) {
+        if (!(function =
+                  wasm_runtime_lookup_function(module_inst, name, NULL))) {
+            wasm_runtime_set_exception(module_inst, "lookup function failed");
+            return false;
+        }
+
+        func_type =
+            wasm_runtime_get_function_type(function, module_inst->module_type);
+        bh_assert(func_type);
+
+        if (argc < func_type->param_cell_num) {
+            char buf[108];
+            snprintf(buf, sizeof(buf),
+                     "invalid argument count %" PRIu32
+                     ", must be no smaller than %u",
+                     argc, func_type->param_cell_num);
+            wasm_runtime_set_exception(module_inst, buf);
+            return false;
+        }
+
+        cache->need_conversion = false;
+#if WASM_ENABLE_REF_TYPES != 0
+        for (i = 0; i < (uint32)func_type->param_count
+                            + (uint32)func_type->result_count;
+             i++) {
+            if (func_type->types[i] == VALUE_TYPE_EXTERNREF)
+                cache->need_conversion = true;
+        }
+#endif
+        cache->param_cell_num = func_type->param_cell_num;
+        cache->function = function;
+        cache->module_inst_id = module_inst_id;
+    }
+
+    /* Let the slow path convert the externref arguments and report
+       the invalid argument count of the later calls */
+    if (cache->need_conversion || argc < cache->param_cell_num)
+        return wasm_runtime_call_wasm(exec_env, cache->function, argc, argv);
+
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        return wasm_call_function(exec_env,
+                                  (WASMFunctionInstance *)cache->function,
+                                  cache->param_cell_num, argv);
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT)
+        return aot_call_function(exec_env,
+                                 (AOTFunctionInstance *)cache->function,
+                                 cache->param_cell_num, argv);
+#endif
+    return false;
+}
+
 static void
 parse_args_to_uint32_array(WASMType *type, wasm_val_t *args, uint32 *out_argv)
 {
@@ -4800,6 +5010,7 @@ wasm_runtime_thread_routine(void *arg)
 
     wasm_runtime_destroy_spawned_exec_env(thread_arg->new_exec_env);
     wasm_runtime_free(thread_arg);
+    wasm_runtime_memory_flush_thread_cache();
 
     os_thread_exit(ret);
     return ret;
@@ -6170,3 +6381,76 @@ wasm_runtime_invoke_native_shim(WASMExecEnv *exec_env, void *func_ptr,
     return ret;
 }
 #endif
+
+void
+wasm_runtime_set_default_checkpoint_loop_period(uint32 period)
+{
+#if WASM_ENABLE_AOT != 0 || WASM_ENABLE_JIT != 0
+    wasm_exec_env_set_default_checkpoint_loop_period(period);
+#else
+    (void)period;
+#endif
+}
+
+void
+wasm_runtime_set_checkpoint_loop_period(WASMExecEnv *exec_env, uint32 period)
+{
+#if WASM_ENABLE_AOT != 0 || WASM_ENABLE_JIT != 0
+    wasm_exec_env_set_checkpoint_loop_period(exec_env, period);
+#else
+    (void)exec_env;
+    (void)period;
+#endif
+}
+
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+bool
+wasm_runtime_record_checkpoint_profile(WASMExecEnv *exec_env)
+{
+#if WASM_ENABLE_AOT != 0
+    if (exec_env->module_inst->module_type == Wasm_Module_AoT)
+        return aot_checkpoint_profile_record(exec_env);
+#endif
+    return false;
+}
+
+bool
+wasm_runtime_save_checkpoint_profile(WASMModuleCommon *module,
+                                     const char *file_name)
+{
+#if WASM_ENABLE_AOT != 0
+    if (module->module_type == Wasm_Module_AoT)
+        return aot_checkpoint_profile_save((AOTModule *)module, file_name);
+#endif
+    return false;
+}
+
+bool
+wasm_runtime_restore_call_chain(WASMExecEnv *exec_env,
+                                const wasm_restore_frame_t *frames,
+                                uint32 frame_count)
+{
+#if WASM_ENABLE_AOT != 0 && WASM_ENABLE_AOT_STACK_FRAME != 0
+    if (exec_env->module_inst->module_type == Wasm_Module_AoT)
+        return aot_restore_call_chain(exec_env, frames, frame_count);
+#endif
+    wasm_runtime_set_exception(exec_env->module_inst,
+                               "restoring call chain isn't supported");
+    return false;
+}
+
+int32
+wasm_runtime_restore_threads(WASMExecEnv *exec_env,
+                             const wasm_thread_restore_info_t *infos,
+                             uint32 count)
+{
+#if WASM_ENABLE_THREAD_MGR != 0
+    return wasm_cluster_restore_threads(exec_env, infos, count);
+#else
+    (void)exec_env;
+    (void)infos;
+    (void)count;
+    return -1;
+#endif
+}
+#endif /* end of WASM_ENABLE_CHECKPOINT_RESTORE != 0 */
@@ -505,6 +505,11 @@ WASM_RUNTIME_API_EXTERN WASMModuleCommon *
 wasm_runtime_load_from_sections(WASMSection *section_list, bool is_aot,
                                 char *error_buf, uint32 error_buf_size);
 
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN WASMModuleCommon *
+wasm_runtime_load_aot_file_mapped(const char *file_path, char *error_buf,
+                                  uint32 error_buf_size);
+
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_unload(WASMModuleCommon *module);
@@ -528,6 +533,28 @@ wasm_runtime_instantiate(WASMModuleCommon *module, uint32 default_stack_size,
                          uint32 host_managed_heap_size, char *error_buf,
                          uint32 error_buf_size);
 
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN wasm_instance_template_t
+wasm_runtime_create_instance_template(WASMModuleInstanceCommon *module_inst,
+                                      char *error_buf, uint32 error_buf_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_destroy_instance_template(wasm_instance_template_t tmpl);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN WASMModuleInstanceCommon *
+wasm_runtime_instantiate_from_template(wasm_instance_template_t tmpl,
+                                       uint32 default_stack_size,
+                                       char *error_buf,
+                                       uint32 error_buf_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_recycle_instance(wasm_instance_template_t tmpl,
+                              WASMModuleInstanceCommon *module_inst,
+                              char *error_buf, uint32 error_buf_size);
+
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_set_running_mode(wasm_module_inst_t module_inst,
@@ -630,6 +657,18 @@ wasm_runtime_call_wasm(WASMExecEnv *exec_env,
                        WASMFunctionInstanceCommon *function, uint32 argc,
                        uint32 argv[]);
 
+/**
+ * Get a new id for a module instance, 0 isn't returned so that it doesn't
+ * match a zeroed wasm_func_cache_t
+ */
+uint32
+wasm_runtime_new_module_inst_id(void);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_call_wasm_cached(WASMExecEnv *exec_env, wasm_func_cache_t *cache,
+                              const char *name, uint32 argc, uint32 argv[]);
+
 WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_call_wasm_a(WASMExecEnv *exec_env,
                          WASMFunctionInstanceCommon *function,
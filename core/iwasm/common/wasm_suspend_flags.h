@@ -22,6 +22,8 @@ extern "C" {
 #define WASM_SUSPEND_FLAG_EXIT 0x8
 /* The thread might be blocking */
 #define WASM_SUSPEND_FLAG_BLOCKING 0x10
+/* Need to take a checkpoint at the next safepoint */
+#define WASM_SUSPEND_FLAG_CHECKPOINT 0x20
 
 typedef union WASMSuspendFlags {
     bh_atomic_32_t flags;
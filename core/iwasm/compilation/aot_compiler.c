@@ -438,92 +438,6 @@ aot_gen_commit_values(AOTCompFrame *frame, bool reset_dirty_bit)
 }
 
 
-bool
-aot_gen_commit_all_locals(AOTCompFrame *frame)
-{
-    AOTCompContext *comp_ctx = frame->comp_ctx;
-    AOTFuncContext *func_ctx = frame->func_ctx;
-    AOTValueSlot *p;
-    uint32 local_idx;
-    LLVMValueRef value;
-    LLVMTypeRef llvm_value_type;
-    uint32 n;
-    uint32 total_locals = func_ctx->aot_func->func_type->param_count + func_ctx->aot_func->local_count;
-
-    for (
-        p = frame->lp, local_idx = 0;
-        local_idx < total_locals;
-        p++, local_idx++) {
-
-        n = (p) - frame->lp;
-        llvm_value_type = TO_LLVM_TYPE(p->type);
-        if (llvm_value_type == NULL) {
-            fprintf(stderr, "gen value %d type error\n", (p)->type);
-            fprintf(stderr, "local_idx %d n %d\n", local_idx, n);
-            return false;
-        }
-        value = LLVMBuildLoad2(comp_ctx->builder, llvm_value_type,
-                        func_ctx->locals[local_idx],
-                        "commit_stack_load");
-        if (value == NULL) {
-            fprintf(stderr, "gen value load error\n");
-            return false;
-        }
-        switch ((p)->type) {
-            case VALUE_TYPE_I32:
-            case VALUE_TYPE_FUNCREF:
-            case VALUE_TYPE_EXTERNREF:
-                if (!store_value(comp_ctx, value, VALUE_TYPE_I32,
-                                    func_ctx->cur_frame,
-                                    offset_of_local(comp_ctx, n)))
-                    return false;
-                break;
-            case VALUE_TYPE_I64:
-                if (!store_value(comp_ctx, value, VALUE_TYPE_I64,
-                                    func_ctx->cur_frame,
-                                    offset_of_local(comp_ctx, n)))
-                    return false;
-                break;
-            case VALUE_TYPE_F32:
-                if (!store_value(comp_ctx, value, VALUE_TYPE_F32,
-                                    func_ctx->cur_frame,
-                                    offset_of_local(comp_ctx, n)))
-                    return false;
-                break;
-            case VALUE_TYPE_F64:
-                (p) += 1;
-                if (!store_value(comp_ctx, value, VALUE_TYPE_F64,
-                                    func_ctx->cur_frame,
-                                    offset_of_local(comp_ctx, n)))
-                    return false;
-                break;
-            case VALUE_TYPE_V128:
-                (p) += 3;
-                if (!store_value(comp_ctx, value, VALUE_TYPE_V128,
-                                    func_ctx->cur_frame,
-                                    offset_of_local(comp_ctx, n)))
-                    return false;
-                break;
-            case VALUE_TYPE_I1:
-                if (!(value = LLVMBuildZExt(comp_ctx->builder, value, I32_TYPE,
-                                            "i32_val"))) {
-                    aot_set_last_error("llvm build bit cast failed");
-                    return false;
-                }
-                if (!store_value(comp_ctx, value, VALUE_TYPE_I32,
-                                    func_ctx->cur_frame,
-                                    offset_of_local(comp_ctx, n)))
-                    return false;
-                break;
-            default:
-                bh_assert(0);
-                break;
-        }
-    }
-
-    return true;
-}
-
 static LLVMValueRef
 load_value(AOTCompContext *comp_ctx, uint8 value_type, LLVMValueRef cur_frame,
            uint32 offset)
@@ -928,9 +842,15 @@ init_comp_frame(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     return true;
 }
 
+/**
+ * Generate a checkpoint site: commit sp/ip and the dirty values, trap, and
+ * register the restore entry. reset_dirty_bit must be false if the site is
+ * not on the path of the code after it, e.g. the cold block of the counter
+ * loop checkpoint, since the values are then not committed on that path.
+ */
 bool
 aot_gen_checkpoint(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
-                   const uint8 *frame_ip)
+                   const uint8 *frame_ip, bool reset_dirty_bit)
 {
     comp_ctx->inst_checkpointed = true;
 
@@ -943,7 +863,7 @@ aot_gen_checkpoint(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         if (!aot_gen_commit_sp_ip(comp_ctx->aot_frame, comp_ctx->aot_frame->sp,
                                 frame_ip))
             return false;
-        if (!aot_gen_commit_values(comp_ctx->aot_frame, false))
+        if (!aot_gen_commit_values(comp_ctx->aot_frame, reset_dirty_bit))
             return false;
     }
     if (disable_gen_fence_int3) {
@@ -1002,34 +922,255 @@ aot_gen_checkpoint(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     return true;
 }
 
-static bool pgo_skip_loop(const char *aot_file_name, uint32 func_idx, uint64 ip) {
-    static uint32* func_list = NULL;
-    static uint64* ip_list = NULL;
-    static int n = -1;
-    if (n == -1) {
-        n = 0;
-        // f"{aot_file_name}.pgo"
-        char *pgo_file_name = (char*)malloc(strlen(aot_file_name) + 5);
-        strcpy(pgo_file_name, aot_file_name);
-        strcat(pgo_file_name, ".pgo");
-        FILE* f = fopen(pgo_file_name, "r");
-        if (!f) {
-            return false;
-        }
-        fscanf(f, "%d", &n);
-        func_list = (uint32*)malloc(n * sizeof(uint32));
-        ip_list = (uint64*)malloc(n * sizeof(uint64));
-        for (int i = 0; i < n; i++) {
-            fscanf(f, "%d %lu", &func_list[i], &ip_list[i]);
+/**
+ * Collect the locals written by local.set/local.tee in the code range, to
+ * know which locals may be dirty when a loop jumps back to its header.
+ * Returns false if the code contains an opcode not handled here.
+ */
+static bool
+scan_set_locals(const uint8 *frame_ip, const uint8 *frame_ip_end,
+                uint32 local_count, uint8 *set_locals)
+{
+    uint32 opcode1, count, u32;
+    int32 i32_const;
+    int64 i64_const;
+    uint8 opcode;
+
+    while (frame_ip < frame_ip_end) {
+        opcode = *frame_ip++;
+        switch (opcode) {
+            case WASM_OP_UNREACHABLE:
+            case WASM_OP_NOP:
+            case WASM_OP_ELSE:
+            case WASM_OP_END:
+            case WASM_OP_RETURN:
+            case WASM_OP_DROP:
+            case WASM_OP_SELECT:
+            case WASM_OP_DROP_64:
+            case WASM_OP_SELECT_64:
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_DROP_128:
+            case WASM_OP_SELECT_128:
+#endif
+            case WASM_OP_REF_IS_NULL:
+                break;
+
+            case WASM_OP_SET_LOCAL:
+            case WASM_OP_TEE_LOCAL:
+                read_leb_uint32(frame_ip, frame_ip_end, u32);
+                if (u32 < local_count)
+                    set_locals[u32] = 1;
+                break;
+
+            /* Value type or type index, both are leb encoded */
+            case WASM_OP_BLOCK:
+            case WASM_OP_LOOP:
+            case WASM_OP_IF:
+            case WASM_OP_BR:
+            case WASM_OP_BR_IF:
+            case WASM_OP_CALL:
+            case WASM_OP_RETURN_CALL:
+            case WASM_OP_TABLE_GET:
+            case WASM_OP_TABLE_SET:
+            case WASM_OP_REF_NULL:
+            case WASM_OP_REF_FUNC:
+            case WASM_OP_GET_LOCAL:
+            case WASM_OP_GET_GLOBAL:
+            case WASM_OP_SET_GLOBAL:
+            case WASM_OP_GET_GLOBAL_64:
+            case WASM_OP_SET_GLOBAL_64:
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_GET_GLOBAL_128:
+            case WASM_OP_SET_GLOBAL_128:
+#endif
+            case WASM_OP_SET_GLOBAL_AUX_STACK:
+            case WASM_OP_MEMORY_SIZE:
+            case WASM_OP_MEMORY_GROW:
+                read_leb_uint32(frame_ip, frame_ip_end, u32);
+                break;
+
+            case WASM_OP_CALL_INDIRECT:
+            case WASM_OP_RETURN_CALL_INDIRECT:
+                read_leb_uint32(frame_ip, frame_ip_end, u32);
+                read_leb_uint32(frame_ip, frame_ip_end, u32);
+                break;
+
+            case WASM_OP_BR_TABLE:
+                read_leb_uint32(frame_ip, frame_ip_end, count);
+#if WASM_ENABLE_FAST_INTERP != 0
+                for (u32 = 0; u32 <= count; u32++)
+                    read_leb_uint32(frame_ip, frame_ip_end, opcode1);
+#else
+                /* The loader stores each depth in one byte */
+                frame_ip += count + 1;
+#endif
+                break;
+
+#if WASM_ENABLE_FAST_INTERP == 0
+            case EXT_OP_BR_TABLE_CACHE:
+                /* The depths are followed by nops */
+                read_leb_uint32(frame_ip, frame_ip_end, count);
+                break;
+#endif
+
+            case WASM_OP_SELECT_T:
+                read_leb_uint32(frame_ip, frame_ip_end, count);
+                frame_ip += count;
+                break;
+
+            case WASM_OP_I32_CONST:
+                read_leb_int32(frame_ip, frame_ip_end, i32_const);
+                (void)i32_const;
+                break;
+
+            case WASM_OP_I64_CONST:
+                read_leb_int64(frame_ip, frame_ip_end, i64_const);
+                (void)i64_const;
+                break;
+
+            case WASM_OP_F32_CONST:
+                frame_ip += sizeof(float32);
+                break;
+
+            case WASM_OP_F64_CONST:
+                frame_ip += sizeof(float64);
+                break;
+
+            case WASM_OP_MISC_PREFIX:
+                read_leb_uint32(frame_ip, frame_ip_end, opcode1);
+                switch (opcode1) {
+                    case WASM_OP_MEMORY_INIT:
+                        read_leb_uint32(frame_ip, frame_ip_end, u32);
+                        frame_ip++;
+                        break;
+                    case WASM_OP_MEMORY_COPY:
+                        frame_ip += 2;
+                        break;
+                    case WASM_OP_MEMORY_FILL:
+                        frame_ip++;
+                        break;
+                    case WASM_OP_TABLE_INIT:
+                    case WASM_OP_TABLE_COPY:
+                        read_leb_uint32(frame_ip, frame_ip_end, u32);
+                        read_leb_uint32(frame_ip, frame_ip_end, u32);
+                        break;
+                    case WASM_OP_DATA_DROP:
+                    case WASM_OP_ELEM_DROP:
+                    case WASM_OP_TABLE_GROW:
+                    case WASM_OP_TABLE_SIZE:
+                    case WASM_OP_TABLE_FILL:
+                        read_leb_uint32(frame_ip, frame_ip_end, u32);
+                        break;
+                    default:
+                        if (opcode1 > WASM_OP_I64_TRUNC_SAT_U_F64)
+                            return false;
+                        break;
+                }
+                break;
+
+            default:
+                /* Memory access opcodes have the align and offset */
+                if (opcode >= WASM_OP_I32_LOAD && opcode <= WASM_OP_I64_STORE32) {
+                    read_leb_uint32(frame_ip, frame_ip_end, u32);
+                    read_leb_uint32(frame_ip, frame_ip_end, u32);
+                    break;
+                }
+                /* Numeric opcodes have no immediates, the others (SIMD,
+                   atomics, ...) aren't scanned */
+                if (opcode < WASM_OP_I32_EQZ || opcode > WASM_OP_I64_EXTEND32_S)
+                    return false;
+                break;
         }
-        free(pgo_file_name);
     }
-    for (int i = 0; i < n; i++) {
-        if (func_list[i] == func_idx && ip_list[i] == ip) {
-            return true;
-        }
+
+    return true;
+}
+
+/**
+ * Mark the locals which may be set in the loop dirty at the loop header,
+ * since the header is also reached from the back edges. Locals not set in
+ * the loop keep the dirty bits of the loop entry.
+ */
+static bool
+mark_loop_locals_dirty(AOTCompFrame *frame, const uint8 *frame_ip,
+                       const uint8 *frame_ip_end)
+{
+    AOTFuncContext *func_ctx = frame->func_ctx;
+    uint32 local_count = func_ctx->aot_func->func_type->param_count
+                         + func_ctx->aot_func->local_count;
+    uint32 i, j, n, cell_num;
+    uint8 *set_locals;
+    bool scanned;
+
+    if (local_count == 0)
+        return true;
+
+    if (!(set_locals = wasm_runtime_malloc(local_count))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
     }
-    return false;
+    memset(set_locals, 0, local_count);
+    scanned = scan_set_locals(frame_ip, frame_ip_end, local_count, set_locals);
+
+    for (i = 0; i < local_count; i++) {
+        if (scanned && !set_locals[i])
+            continue;
+        n = frame->cur_wasm_func->local_offsets[i];
+        cell_num = wasm_value_type_cell_num(frame->lp[n].type);
+        for (j = 0; j < cell_num; j++)
+            frame->lp[n + j].dirty = 1;
+    }
+
+    wasm_runtime_free(set_locals);
+    return true;
+}
+
+#if WASM_ENABLE_AOT != 0
+/* The slot of exec_env read by load_checkpoint_loop_period() for AOT */
+bh_static_assert(offsetof(WASMExecEnv, checkpoint_loop_period)
+                 == 10 * sizeof(uintptr_t));
+#endif
+
+/* Load the checkpoint loop period of the current thread from exec_env */
+static LLVMValueRef
+load_checkpoint_loop_period(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+{
+    LLVMValueRef offset, period_addr, period;
+    uint32 period_offset = 10 * comp_ctx->pointer_size;
+
+#if WASM_ENABLE_JIT != 0
+    /* JITed code runs against the exec_env of this very build, take the
+       offset from its layout instead of assuming the AOT one */
+    if (comp_ctx->is_jit_mode)
+        period_offset = (uint32)offsetof(WASMExecEnv, checkpoint_loop_period);
+#endif
+
+    if (!(offset = I32_CONST(period_offset))) {
+        aot_set_last_error("llvm build const failed");
+        return NULL;
+    }
+
+    if (!(period_addr = LLVMBuildInBoundsGEP2(
+              comp_ctx->builder, INT8_TYPE, func_ctx->exec_env, &offset, 1,
+              "checkpoint_loop_period_addr"))) {
+        aot_set_last_error("llvm build in bounds gep failed");
+        return NULL;
+    }
+
+    if (!(period_addr = LLVMBuildBitCast(comp_ctx->builder, period_addr,
+                                         INT32_PTR_TYPE,
+                                         "checkpoint_loop_period_ptr"))) {
+        aot_set_last_error("llvm build bit cast failed");
+        return NULL;
+    }
+
+    if (!(period = LLVMBuildLoad2(comp_ctx->builder, I32_TYPE, period_addr,
+                                  "checkpoint_loop_period"))) {
+        aot_set_last_error("llvm build load failed");
+        return NULL;
+    }
+
+    return period;
 }
 
 static bool
@@ -1130,27 +1271,32 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
         if (comp_ctx->enable_every_checkpoint) {
             bh_assert(comp_ctx->aot_frame);
             comp_ctx->checkpoint_type = 3;
-            aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip);
+            aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip, true);
         }
         if (comp_ctx->enable_loop_checkpoint && last_op_is_loop) {
             bh_assert(comp_ctx->aot_frame);
 
             uint64 ip_offset = (uint64)(uintptr_t)(frame_ip - func_ctx->aot_func->code);
-            bool skip_loop = pgo_skip_loop(comp_ctx->aot_file_name, func_index, ip_offset);
-            if (skip_loop && comp_ctx->enable_checkpoint_pgo) {
-                fprintf(stderr, "skip loop %zu\n", ip_offset);
+            if (wasm_checkpoint_profile_is_cold_loop(
+                    comp_ctx->checkpoint_profile, func_index, ip_offset)) {
+                LOG_VERBOSE("skip cold loop safepoint %u:%" PRIu64,
+                            func_index, ip_offset);
             } else {
                 if (comp_ctx->enable_counter_loop_checkpoint) {
-                    // counter = counter + 1
-                    LLVMValueRef counter = LLVMBuildLoad2(
-                        comp_ctx->builder, I32_TYPE, last_loop_counter, "counter");
-                    LLVMValueRef counter_inc = LLVMBuildAdd(
-                        comp_ctx->builder, counter,  I32_CONST(1), "counter_inc");
-                    LLVMBuildStore(comp_ctx->builder, counter_inc, last_loop_counter);
-                    const int threshold = 1 << 20;
-
+                    LLVMValueRef counter, cond, cond_br, period;
                     LLVMBasicBlockRef normal_block, ckpt_block;
                     char name[32];
+
+                    /* counter = counter - 1, checkpoint when it reaches 0 */
+                    counter = LLVMBuildLoad2(comp_ctx->builder, I32_TYPE,
+                                             last_loop_counter, "counter");
+                    counter = LLVMBuildSub(comp_ctx->builder, counter,
+                                           I32_ONE, "counter_dec");
+                    LLVMBuildStore(comp_ctx->builder, counter,
+                                   last_loop_counter);
+
+                    /* Leave the checkpoint block where it is appended, at
+                       the end of the function, out of the loop body */
                     snprintf(name, sizeof(name), "loop-ckpt-%zu",
                             (uint64)(uintptr_t)(frame_ip - 1 - func_ctx->aot_func->code));
                     if (!(ckpt_block = LLVMAppendBasicBlockInContext(
@@ -1158,9 +1304,7 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                         aot_set_last_error("add LLVM basic block failed.");
                         goto fail;
                     }
-                    LLVMMoveBasicBlockAfter(ckpt_block,
-                                            LLVMGetInsertBlock(comp_ctx->builder));
-                    
+
                     snprintf(name, sizeof(name), "loop-normal-%zu",
                                 (uint64)(uintptr_t)(frame_ip - 1 - func_ctx->aot_func->code));
                     if (!(normal_block = LLVMAppendBasicBlockInContext(
@@ -1168,28 +1312,41 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                         aot_set_last_error("add LLVM basic block failed.");
                         goto fail;
                     }
+                    LLVMMoveBasicBlockAfter(normal_block,
+                                            LLVMGetInsertBlock(comp_ctx->builder));
 
-                    LLVMValueRef andvar = LLVMBuildAnd(comp_ctx->builder, counter, I32_CONST(threshold-1), "andvar");
-                    LLVMValueRef cond = LLVMBuildICmp(comp_ctx->builder, LLVMIntEQ, andvar, I32_CONST(0), "cond");
-
-                    LLVMBuildCondBr(comp_ctx->builder, cond, ckpt_block, normal_block);
+                    cond = LLVMBuildICmp(comp_ctx->builder, LLVMIntEQ, counter,
+                                         I32_ZERO, "cond");
+                    if (!(cond_br = LLVMBuildCondBr(comp_ctx->builder, cond,
+                                                    ckpt_block, normal_block))) {
+                        aot_set_last_error("llvm build cond br failed.");
+                        goto fail;
+                    }
+                    /* Let LLVM lay the checkpoint path out of line */
+                    aot_set_cond_br_weights(comp_ctx, cond_br, 1, 2000);
                     LLVMPositionBuilderAtEnd(comp_ctx->builder, ckpt_block);
 
-                    // TODO(huab): find a better way to commit locals
-                    aot_gen_commit_all_locals(comp_ctx->aot_frame);
-
-                    // checkpoint
+                    /* The dirty bits at the loop header cover all the
+                       locals set in the loop, keep them for the hot path */
                     comp_ctx->checkpoint_type = 1;
-                    aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip);
+                    if (!aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip,
+                                            false))
+                        goto fail;
 
+                    /* Reached both after a checkpoint and after a restore,
+                       the period may have changed meanwhile */
+                    if (!(period = load_checkpoint_loop_period(comp_ctx,
+                                                               func_ctx)))
+                        goto fail;
+                    LLVMBuildStore(comp_ctx->builder, period,
+                                   last_loop_counter);
                     LLVMBuildBr(comp_ctx->builder, normal_block);
 
                     // normal
-                    LLVMMoveBasicBlockAfter(normal_block, LLVMGetInsertBlock(comp_ctx->builder));
                     LLVMPositionBuilderAtEnd(comp_ctx->builder, normal_block);
                 } else {
                     comp_ctx->checkpoint_type = 1;
-                    aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip);
+                    aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip, true);
                 }
             }
 
@@ -1224,12 +1381,26 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     } else {
                         aot_gen_commit_values(comp_ctx->aot_frame, true);
                     }
-                    if (comp_ctx->enable_counter_loop_checkpoint) {
+                    if (comp_ctx->enable_counter_loop_checkpoint
+                        && opcode == WASM_OP_LOOP) {
+                        LLVMValueRef period;
+
                         last_loop_counter = LLVMBuildAlloca(comp_ctx->aot_frame_alloca_builder,
                             I32_TYPE, "wasm_loop_ckpt_counter");
-                        LLVMBuildStore(comp_ctx->builder, I32_ZERO, last_loop_counter);
+                        if (!(period = load_checkpoint_loop_period(comp_ctx,
+                                                                   func_ctx)))
+                            return false;
+                        LLVMBuildStore(comp_ctx->builder, period,
+                                       last_loop_counter);
                     }
                 }
+                else if (comp_ctx->enable_br_checkpoint
+                         && opcode == WASM_OP_LOOP) {
+                    /* Commit the dirty values once before the loop, so
+                       that the back edges only commit what the loop sets */
+                    if (!aot_gen_commit_values(comp_ctx->aot_frame, true))
+                        return false;
+                }
                 value_type = *frame_ip++;
                 if (value_type == VALUE_TYPE_I32 || value_type == VALUE_TYPE_I64
                     || value_type == VALUE_TYPE_F32
@@ -1264,6 +1435,11 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                         (uint32)(LABEL_TYPE_BLOCK + opcode - WASM_OP_BLOCK),
                         param_count, param_types, result_count, result_types))
                     return false;
+                if (opcode == WASM_OP_LOOP && comp_ctx->aot_frame
+                    && !mark_loop_locals_dirty(
+                        comp_ctx->aot_frame, frame_ip,
+                        func_ctx->block_stack.block_list_end->wasm_code_end))
+                    return false;
                 break;
             }
 
@@ -1285,7 +1461,7 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                 if (comp_ctx->enable_checkpoint && !comp_ctx->inst_checkpointed) {
                     if (comp_ctx->enable_br_checkpoint) {
                         comp_ctx->checkpoint_type = 2;
-                        aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip);
+                        aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip, true);
                     } else {
                         if (comp_ctx->enable_aux_stack_dirty_bit) {
                             aot_gen_commit_values(comp_ctx->aot_frame, false);
@@ -1302,7 +1478,7 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                 if (comp_ctx->enable_checkpoint && !comp_ctx->inst_checkpointed) {
                     if (comp_ctx->enable_br_checkpoint) {
                         comp_ctx->checkpoint_type = 2;
-                        aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip);
+                        aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip, true);
                     } else {
                         if (comp_ctx->enable_aux_stack_dirty_bit) {
                             aot_gen_commit_values(comp_ctx->aot_frame, false);
@@ -1320,7 +1496,7 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                 if (comp_ctx->enable_checkpoint && !comp_ctx->inst_checkpointed) {
                     if (comp_ctx->enable_br_checkpoint) {
                         comp_ctx->checkpoint_type = 2;
-                        aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip);
+                        aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip, true);
                     } else {
                         if (comp_ctx->enable_aux_stack_dirty_bit) {
                             aot_gen_commit_values(comp_ctx->aot_frame, false);
@@ -1357,7 +1533,7 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                 if (comp_ctx->enable_checkpoint && !comp_ctx->inst_checkpointed) {
                     if (comp_ctx->enable_br_checkpoint) {
                         comp_ctx->checkpoint_type = 2;
-                        aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip);
+                        aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip, true);
                     } else {
                         if (comp_ctx->enable_aux_stack_dirty_bit) {
                             aot_gen_commit_values(comp_ctx->aot_frame, false);
@@ -1402,7 +1578,7 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                 if (comp_ctx->enable_checkpoint && !comp_ctx->inst_checkpointed) {
                     bh_assert(comp_ctx->aot_frame);
                     comp_ctx->checkpoint_type = 0;
-                    aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip_org);
+                    aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip_org, true);
                 }
 
                 read_leb_uint32(frame_ip, frame_ip_end, func_idx);
@@ -1420,7 +1596,7 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                 if (comp_ctx->enable_checkpoint && !comp_ctx->inst_checkpointed) {
                     bh_assert(comp_ctx->aot_frame);
                     comp_ctx->checkpoint_type = 0;
-                    aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip_org);
+                    aot_gen_checkpoint(comp_ctx, func_ctx, frame_ip_org, true);
                 }
 
                 read_leb_uint32(frame_ip, frame_ip_end, type_idx);
@@ -1511,6 +1687,18 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                     return false;
                 break;
 
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_DROP_128:
+                if (!aot_compile_op_drop(comp_ctx, func_ctx, true))
+                    return false;
+                break;
+
+            case WASM_OP_SELECT_128:
+                if (!aot_compile_op_select(comp_ctx, func_ctx, true))
+                    return false;
+                break;
+#endif
+
 #if WASM_ENABLE_REF_TYPES != 0
             case WASM_OP_SELECT_T:
             {
@@ -1606,40 +1794,19 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
                 read_leb_uint32(frame_ip, frame_ip_end, local_idx);
                 if (!aot_compile_op_set_local(comp_ctx, func_ctx, local_idx))
                     return false;
-                if (comp_ctx->enable_loop_checkpoint && !comp_ctx->enable_aux_stack_dirty_bit) {
-                    if (comp_ctx->enable_counter_loop_checkpoint) {
-                    } else {
-                        AOTValueSlot* p = comp_ctx->aot_frame->lp + comp_ctx->aot_frame->cur_wasm_func->local_offsets[local_idx];
-                        if (comp_ctx->exp_disable_local_commit) {
-                            fake_aot_gen_commit_value(comp_ctx->aot_frame, true, &p, local_idx);
-                        } else {
-                            if (!aot_gen_commit_value(comp_ctx->aot_frame, true, &p, local_idx))
-                                return false;
-                        }
-                    }
-                }
                 break;
 
             case WASM_OP_TEE_LOCAL:
                 read_leb_uint32(frame_ip, frame_ip_end, local_idx);
                 if (!aot_compile_op_tee_local(comp_ctx, func_ctx, local_idx))
                     return false;
-                if (comp_ctx->enable_loop_checkpoint && !comp_ctx->enable_aux_stack_dirty_bit) {
-                    if (comp_ctx->enable_counter_loop_checkpoint) {
-                    } else {
-                        AOTValueSlot* p = comp_ctx->aot_frame->lp + comp_ctx->aot_frame->cur_wasm_func->local_offsets[local_idx];
-                        if (comp_ctx->exp_disable_local_commit) {
-                            fake_aot_gen_commit_value(comp_ctx->aot_frame, true, &p, local_idx);
-                        } else {
-                            if (!aot_gen_commit_value(comp_ctx->aot_frame, true, &p, local_idx))
-                                return false;
-                        }
-                    }
-                }
                 break;
 
             case WASM_OP_GET_GLOBAL:
             case WASM_OP_GET_GLOBAL_64:
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_GET_GLOBAL_128:
+#endif
                 read_leb_uint32(frame_ip, frame_ip_end, global_idx);
                 if (!aot_compile_op_get_global(comp_ctx, func_ctx, global_idx))
                     return false;
@@ -1647,6 +1814,9 @@ aot_compile_func(AOTCompContext *comp_ctx, uint32 func_index)
 
             case WASM_OP_SET_GLOBAL:
             case WASM_OP_SET_GLOBAL_64:
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_SET_GLOBAL_128:
+#endif
             case WASM_OP_SET_GLOBAL_AUX_STACK:
                 read_leb_uint32(frame_ip, frame_ip_end, global_idx);
                 if (!aot_compile_op_set_global(
@@ -3713,17 +3883,18 @@ verify_module(AOTCompContext *comp_ctx)
     return true;
 }
 
-bool
-aot_compile_wasm(AOTCompContext *comp_ctx)
+/**
+ * Compile the functions of the context into its LLVM module and run the
+ * optimization passes on it
+ */
+static bool
+aot_compile_module(AOTCompContext *comp_ctx)
 {
     uint32 i;
 
-    if (!aot_validate_wasm(comp_ctx)) {
-        return false;
-    }
-
-    bh_print_time("Begin to compile WASM bytecode to LLVM IR");
-    for (i = 0; i < comp_ctx->func_ctx_count; i++) {
+    if (!comp_ctx->is_partition)
+        bh_print_time("Begin to compile WASM bytecode to LLVM IR");
+    for (i = comp_ctx->func_part_begin; i < comp_ctx->func_part_end; i++) {
         if (!aot_compile_func(comp_ctx, i)) {
             return false;
         }
@@ -3736,7 +3907,8 @@ aot_compile_wasm(AOTCompContext *comp_ctx)
     /* Disable LLVM module verification for jit mode to speedup
        the compilation process */
     if (!comp_ctx->is_jit_mode) {
-        bh_print_time("Begin to verify LLVM module");
+        if (!comp_ctx->is_partition)
+            bh_print_time("Begin to verify LLVM module");
         if (!verify_module(comp_ctx)) {
             return false;
         }
@@ -3752,9 +3924,160 @@ aot_compile_wasm(AOTCompContext *comp_ctx)
            speedup the launch process. Now there are two issues in the
            JIT: one is memory leak in do_ir_transform, the other is
            possible core dump. */
-        bh_print_time("Begin to run llvm optimization passes");
+        if (!comp_ctx->is_partition)
+            bh_print_time("Begin to run llvm optimization passes");
         aot_apply_llvm_new_pass_manager(comp_ctx, comp_ctx->module);
-        bh_print_time("Finish llvm optimization passes");
+        if (!comp_ctx->is_partition)
+            bh_print_time("Finish llvm optimization passes");
+    }
+
+    return true;
+}
+
+/* Stack size of the threads compiling the partitions */
+#define AOT_PARTITION_THREAD_STACK_SIZE (16 * 1024 * 1024)
+
+typedef struct AOTPartitionJobs {
+    AOTCompContext *comp_ctx;
+    korp_mutex lock;
+    uint32 next_partition;
+    bool failed;
+} AOTPartitionJobs;
+
+/**
+ * Compile a partition with its own LLVM context and emit its object file
+ * to comp_ctx->partition_objs[partition_idx]
+ */
+static bool
+aot_compile_partition(AOTCompContext *comp_ctx, uint32 partition_idx)
+{
+    AOTCompContext *part_ctx;
+    char *err = NULL;
+    bool ret = false;
+
+    if (!(part_ctx =
+              aot_create_partition_comp_context(comp_ctx, partition_idx)))
+        return false;
+
+    if (!aot_compile_module(part_ctx))
+        goto fail;
+
+    if (LLVMTargetMachineEmitToMemoryBuffer(
+            part_ctx->target_machine, part_ctx->module, LLVMObjectFile, &err,
+            &comp_ctx->partition_objs[partition_idx])
+        != 0) {
+        if (err) {
+            LLVMDisposeMessage(err);
+            err = NULL;
+        }
+        aot_set_last_error("llvm emit to memory buffer failed.");
+        goto fail;
+    }
+
+    ret = true;
+
+fail:
+    aot_destroy_comp_context(part_ctx);
+    return ret;
+}
+
+static void *
+aot_compile_partitions_routine(void *arg)
+{
+    AOTPartitionJobs *jobs = (AOTPartitionJobs *)arg;
+    uint32 partition_idx;
+
+    while (true) {
+        os_mutex_lock(&jobs->lock);
+        if (jobs->failed
+            || jobs->next_partition >= jobs->comp_ctx->partition_count) {
+            os_mutex_unlock(&jobs->lock);
+            break;
+        }
+        partition_idx = jobs->next_partition++;
+        os_mutex_unlock(&jobs->lock);
+
+        if (!aot_compile_partition(jobs->comp_ctx, partition_idx)) {
+            os_mutex_lock(&jobs->lock);
+            jobs->failed = true;
+            os_mutex_unlock(&jobs->lock);
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Compile the partitions of a partitioned compilation, the calling thread
+ * and up to thread_num - 1 extra threads take the partitions in order
+ */
+static bool
+aot_compile_partitions(AOTCompContext *comp_ctx)
+{
+    AOTPartitionJobs jobs = { 0 };
+    korp_tid *tids = NULL;
+    uint32 thread_num, created_num = 0, i;
+
+    thread_num = comp_ctx->thread_num;
+    if (thread_num > comp_ctx->partition_count)
+        thread_num = comp_ctx->partition_count;
+
+    LOG_VERBOSE("Compile %" PRIu32 " partitions with %" PRIu32 " threads",
+                comp_ctx->partition_count, thread_num);
+
+    jobs.comp_ctx = comp_ctx;
+    if (os_mutex_init(&jobs.lock) != 0) {
+        aot_set_last_error("init mutex failed.");
+        return false;
+    }
+
+    if (thread_num > 1
+        && !(tids = wasm_runtime_malloc(sizeof(korp_tid) * (thread_num - 1)))) {
+        aot_set_last_error("allocate memory failed.");
+        os_mutex_destroy(&jobs.lock);
+        return false;
+    }
+
+    bh_print_time("Begin to compile WASM bytecode to native code");
+
+    for (i = 0; i + 1 < thread_num; i++) {
+        if (os_thread_create(&tids[i], aot_compile_partitions_routine, &jobs,
+                             AOT_PARTITION_THREAD_STACK_SIZE)
+            != 0) {
+            /* The threads created and the calling thread do the work */
+            LOG_WARNING("Create compilation thread failed");
+            break;
+        }
+        created_num++;
+    }
+
+    aot_compile_partitions_routine(&jobs);
+
+    for (i = 0; i < created_num; i++)
+        os_thread_join(tids[i], NULL);
+
+    bh_print_time("Finish compiling WASM bytecode to native code");
+
+    if (tids)
+        wasm_runtime_free(tids);
+    os_mutex_destroy(&jobs.lock);
+
+    return !jobs.failed;
+}
+
+bool
+aot_compile_wasm(AOTCompContext *comp_ctx)
+{
+    if (!aot_validate_wasm(comp_ctx)) {
+        return false;
+    }
+
+    if (comp_ctx->partition_count > 0)
+        return aot_compile_partitions(comp_ctx);
+
+    if (!aot_compile_module(comp_ctx)) {
+        return false;
     }
 
 #ifdef DUMP_MODULE
@@ -147,6 +147,17 @@ typedef struct AOTObjectData {
     const char *stack_sizes_section_name;
     uint32 stack_sizes_offset;
     uint32 *stack_sizes;
+
+    /* Object data of the partitions merged into this one, they own the
+       names referred to by the merged sections and relocations */
+    struct AOTObjectData **partitions;
+    uint32 partition_count;
+    bool is_text_allocated;
+
+    /* For a partition, offsets of its text and of each of its data
+       sections in the merged object data */
+    uint32 merged_text_offset;
+    uint32 *merged_data_offsets;
 } AOTObjectData;
 
 #if 0
@@ -2882,7 +2893,6 @@ aot_resolve_functions(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
                 char *contain_section_name;
 
                 func = obj_data->funcs + func_index;
-                func->func_name = name;
 
                 if (!(contain_section = LLVMObjectFileCopySectionIterator(
                           obj_data->binary))) {
@@ -2891,10 +2901,19 @@ aot_resolve_functions(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
                     return false;
                 }
                 LLVMMoveToContainingSection(contain_section, sym_itr);
+                if (LLVMObjectFileIsSectionIteratorAtEnd(obj_data->binary,
+                                                         contain_section)) {
+                    /* Undefined, the function is compiled by another
+                       partition */
+                    LLVMDisposeSectionIterator(contain_section);
+                    LLVMMoveToNextSymbol(sym_itr);
+                    continue;
+                }
                 contain_section_name =
                     (char *)LLVMGetSectionName(contain_section);
                 LLVMDisposeSectionIterator(contain_section);
 
+                func->func_name = name;
                 if (!strcmp(contain_section_name, ".text.unlikely.")) {
                     func->text_offset = align_uint(obj_data->text_size, 4)
                                         + LLVMGetSymbolAddress(sym_itr);
@@ -2927,6 +2946,12 @@ aot_resolve_functions(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
                     return false;
                 }
                 LLVMMoveToContainingSection(contain_section, sym_itr);
+                if (LLVMObjectFileIsSectionIteratorAtEnd(obj_data->binary,
+                                                         contain_section)) {
+                    LLVMDisposeSectionIterator(contain_section);
+                    LLVMMoveToNextSymbol(sym_itr);
+                    continue;
+                }
                 contain_section_name =
                     (char *)LLVMGetSectionName(contain_section);
                 LLVMDisposeSectionIterator(contain_section);
@@ -3422,9 +3447,353 @@ aot_obj_data_destroy(AOTObjectData *obj_data)
         destroy_relocation_symbol_list(&obj_data->symbol_list);
     if (obj_data->stack_sizes)
         wasm_runtime_free(obj_data->stack_sizes);
+    if (obj_data->text && obj_data->is_text_allocated)
+        wasm_runtime_free(obj_data->text);
+    if (obj_data->merged_data_offsets)
+        wasm_runtime_free(obj_data->merged_data_offsets);
+    if (obj_data->partitions) {
+        uint32 i;
+        for (i = 0; i < obj_data->partition_count; i++)
+            if (obj_data->partitions[i])
+                aot_obj_data_destroy(obj_data->partitions[i]);
+        wasm_runtime_free(obj_data->partitions);
+    }
     wasm_runtime_free(obj_data);
 }
 
+static bool
+aot_resolve_obj_data(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
+{
+    char *err = NULL;
+
+    if (!(obj_data->binary = LLVMCreateBinary(obj_data->mem_buf, NULL, &err))) {
+        if (err) {
+            LLVMDisposeMessage(err);
+            err = NULL;
+        }
+        aot_set_last_error("llvm create binary failed.");
+        return false;
+    }
+
+    /* resolve target info/text/relocations/functions */
+    return aot_resolve_target_info(comp_ctx, obj_data)
+           && aot_resolve_text(obj_data) && aot_resolve_literal(obj_data)
+           && aot_resolve_object_data_sections(obj_data)
+           && aot_resolve_functions(comp_ctx, obj_data)
+           && aot_resolve_object_relocation_groups(obj_data);
+}
+
+/* Alignment of the text and the data of each partition once merged */
+#define AOT_PARTITION_SECTION_ALIGN 64
+
+static int32
+get_data_section_index(const AOTObjectData *obj_data, const char *name)
+{
+    uint32 i;
+
+    for (i = 0; i < obj_data->data_sections_count; i++) {
+        if (!strcmp(obj_data->data_sections[i].name, name))
+            return (int32)i;
+    }
+    return -1;
+}
+
+static bool
+aot_merge_partition_text(AOTObjectData *obj_data)
+{
+    AOTObjectData *part;
+    uint32 i, offset, size = 0;
+    uint8 *text;
+
+    /* Each partition keeps the text layout of aot_emit_text_section:
+       .text, .text.unlikely. and .text.hot. aligned to 4 bytes */
+    for (i = 0; i < obj_data->partition_count; i++) {
+        part = obj_data->partitions[i];
+        part->merged_text_offset =
+            align_uint(size, AOT_PARTITION_SECTION_ALIGN);
+        size = part->merged_text_offset + align_uint(part->text_size, 4)
+               + align_uint(part->text_unlikely_size, 4)
+               + align_uint(part->text_hot_size, 4);
+    }
+
+    if (size == 0)
+        return true;
+
+    if (!(text = wasm_runtime_malloc(size))) {
+        aot_set_last_error("allocate memory for text failed.");
+        return false;
+    }
+    memset(text, 0, size);
+    obj_data->text = text;
+    obj_data->text_size = size;
+    obj_data->is_text_allocated = true;
+
+    for (i = 0; i < obj_data->partition_count; i++) {
+        part = obj_data->partitions[i];
+        offset = part->merged_text_offset;
+        if (part->text_size > 0)
+            bh_memcpy_s(text + offset, size - offset, part->text,
+                        part->text_size);
+        offset += align_uint(part->text_size, 4);
+        if (part->text_unlikely_size > 0)
+            bh_memcpy_s(text + offset, size - offset, part->text_unlikely,
+                        part->text_unlikely_size);
+        offset += align_uint(part->text_unlikely_size, 4);
+        if (part->text_hot_size > 0)
+            bh_memcpy_s(text + offset, size - offset, part->text_hot,
+                        part->text_hot_size);
+    }
+
+    return true;
+}
+
+static bool
+aot_merge_partition_funcs(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
+{
+    AOTObjectData *part;
+    AOTObjectFunc *func;
+    uint32 i, j, total_size;
+
+    obj_data->func_count = comp_ctx->comp_data->func_count;
+    if (obj_data->func_count == 0)
+        return true;
+
+    total_size = (uint32)sizeof(AOTObjectFunc) * obj_data->func_count;
+    if (!(obj_data->funcs = wasm_runtime_malloc(total_size))) {
+        aot_set_last_error("allocate memory for functions failed.");
+        return false;
+    }
+    memset(obj_data->funcs, 0, total_size);
+
+    for (i = 0; i < obj_data->partition_count; i++) {
+        part = obj_data->partitions[i];
+        for (j = comp_ctx->partition_bounds[i];
+             j < comp_ctx->partition_bounds[i + 1]; j++) {
+            func = obj_data->funcs + j;
+            *func = part->funcs[j];
+            if (!func->func_name) {
+                aot_set_last_error_v("function %" PRIu32
+                                     " not found in the object file",
+                                     j);
+                return false;
+            }
+            func->text_offset += part->merged_text_offset;
+        }
+    }
+
+    return true;
+}
+
+static bool
+aot_merge_partition_data_sections(AOTObjectData *obj_data)
+{
+    AOTObjectData *part;
+    AOTObjectDataSection *data_section, *src;
+    uint32 total_count = 0, size, i, j;
+    int32 idx;
+
+    for (i = 0; i < obj_data->partition_count; i++)
+        total_count += obj_data->partitions[i]->data_sections_count;
+
+    if (total_count == 0)
+        return true;
+
+    size = (uint32)sizeof(AOTObjectDataSection) * total_count;
+    if (!(obj_data->data_sections = wasm_runtime_malloc(size))) {
+        aot_set_last_error("allocate memory for data sections failed.");
+        return false;
+    }
+    memset(obj_data->data_sections, 0, size);
+
+    /* The sections of the same name are laid out one after another, in
+       the order that they first appear in */
+    for (i = 0; i < obj_data->partition_count; i++) {
+        part = obj_data->partitions[i];
+        if (part->data_sections_count == 0)
+            continue;
+
+        if (!(part->merged_data_offsets = wasm_runtime_malloc(
+                  sizeof(uint32) * part->data_sections_count))) {
+            aot_set_last_error("allocate memory failed.");
+            return false;
+        }
+
+        for (j = 0; j < part->data_sections_count; j++) {
+            src = part->data_sections + j;
+            if ((idx = get_data_section_index(obj_data, src->name)) < 0) {
+                idx = (int32)obj_data->data_sections_count++;
+                obj_data->data_sections[idx].name = src->name;
+            }
+            data_section = obj_data->data_sections + idx;
+            part->merged_data_offsets[j] =
+                align_uint(data_section->size, AOT_PARTITION_SECTION_ALIGN);
+            data_section->size = part->merged_data_offsets[j] + src->size;
+        }
+    }
+
+    for (i = 0; i < obj_data->data_sections_count; i++) {
+        data_section = obj_data->data_sections + i;
+        if (data_section->size == 0)
+            continue;
+        if (!(data_section->data = wasm_runtime_malloc(data_section->size))) {
+            aot_set_last_error("allocate memory for data section failed.");
+            return false;
+        }
+        memset(data_section->data, 0, data_section->size);
+        data_section->is_data_allocated = true;
+    }
+
+    for (i = 0; i < obj_data->partition_count; i++) {
+        part = obj_data->partitions[i];
+        for (j = 0; j < part->data_sections_count; j++) {
+            src = part->data_sections + j;
+            if (src->size == 0)
+                continue;
+            data_section = obj_data->data_sections
+                           + get_data_section_index(obj_data, src->name);
+            bh_memcpy_s(data_section->data + part->merged_data_offsets[j],
+                        data_section->size - part->merged_data_offsets[j],
+                        src->data, src->size);
+        }
+    }
+
+    return true;
+}
+
+static bool
+aot_merge_partition_relocation_groups(AOTObjectData *obj_data)
+{
+    AOTObjectData *part;
+    AOTRelocationGroup *group, *src;
+    AOTRelocation *relocation;
+    uint32 total_count = 0, base, size, i, j, k;
+    int32 idx;
+
+    for (i = 0; i < obj_data->partition_count; i++)
+        total_count += obj_data->partitions[i]->relocation_group_count;
+
+    if (total_count == 0)
+        return true;
+
+    size = (uint32)sizeof(AOTRelocationGroup) * total_count;
+    if (!(group = obj_data->relocation_groups = wasm_runtime_malloc(size))) {
+        aot_set_last_error("allocate memory for relocation groups failed.");
+        return false;
+    }
+    memset(obj_data->relocation_groups, 0, size);
+    obj_data->relocation_group_count = total_count;
+
+    /* Keep the groups of each partition, rebasing the offsets and the
+       addends relative to a section onto the merged sections */
+    for (i = 0; i < obj_data->partition_count; i++) {
+        part = obj_data->partitions[i];
+        for (j = 0; j < part->relocation_group_count; j++, group++) {
+            src = part->relocation_groups + j;
+
+            if (!strcmp(src->section_name, ".rela.text")) {
+                base = part->merged_text_offset;
+            }
+            else if (str_starts_with(src->section_name, ".rela.")
+                     && (idx = get_data_section_index(
+                             part, src->section_name + strlen(".rela")))
+                            >= 0) {
+                base = part->merged_data_offsets[idx];
+            }
+            else {
+                aot_set_last_error_v("unsupported relocation section %s",
+                                     src->section_name);
+                return false;
+            }
+
+            size = (uint32)sizeof(AOTRelocation) * src->relocation_count;
+            if (!(group->relocations = wasm_runtime_malloc(size))) {
+                aot_set_last_error("allocate memory for relocations failed.");
+                return false;
+            }
+            bh_memcpy_s(group->relocations, size, src->relocations, size);
+            group->section_name = src->section_name;
+            group->relocation_count = src->relocation_count;
+
+            relocation = group->relocations;
+            for (k = 0; k < group->relocation_count; k++, relocation++) {
+                relocation->relocation_offset += base;
+                relocation->is_symbol_name_allocated = false;
+                if (!strcmp(relocation->symbol_name, ".text"))
+                    relocation->relocation_addend += part->merged_text_offset;
+                else if ((idx = get_data_section_index(
+                              part, relocation->symbol_name))
+                         >= 0)
+                    relocation->relocation_addend +=
+                        part->merged_data_offsets[idx];
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Resolve the object files emitted by the partitions of a partitioned
+ * compilation and merge them into one object data
+ */
+static AOTObjectData *
+aot_obj_data_create_partitions(AOTCompContext *comp_ctx)
+{
+    AOTObjectData *obj_data, *part;
+    uint32 i, size;
+
+    bh_print_time("Begin to resolve object files of the partitions");
+
+    if (!(obj_data = wasm_runtime_malloc(sizeof(AOTObjectData)))) {
+        aot_set_last_error("allocate memory failed.");
+        return NULL;
+    }
+    memset(obj_data, 0, sizeof(AOTObjectData));
+    obj_data->comp_ctx = comp_ctx;
+
+    size = (uint32)sizeof(AOTObjectData *) * comp_ctx->partition_count;
+    if (!(obj_data->partitions = wasm_runtime_malloc(size))) {
+        aot_set_last_error("allocate memory failed.");
+        goto fail;
+    }
+    memset(obj_data->partitions, 0, size);
+    obj_data->partition_count = comp_ctx->partition_count;
+
+    for (i = 0; i < comp_ctx->partition_count; i++) {
+        if (!comp_ctx->partition_objs[i]) {
+            aot_set_last_error("partition wasn't compiled.");
+            goto fail;
+        }
+        if (!(part = obj_data->partitions[i] =
+                  wasm_runtime_malloc(sizeof(AOTObjectData)))) {
+            aot_set_last_error("allocate memory failed.");
+            goto fail;
+        }
+        memset(part, 0, sizeof(AOTObjectData));
+        part->comp_ctx = comp_ctx;
+        /* The object data takes over the memory buffer */
+        part->mem_buf = comp_ctx->partition_objs[i];
+        comp_ctx->partition_objs[i] = NULL;
+
+        if (!aot_resolve_obj_data(comp_ctx, part))
+            goto fail;
+    }
+
+    obj_data->target_info = obj_data->partitions[0]->target_info;
+
+    if (!aot_merge_partition_text(obj_data)
+        || !aot_merge_partition_funcs(comp_ctx, obj_data)
+        || !aot_merge_partition_data_sections(obj_data)
+        || !aot_merge_partition_relocation_groups(obj_data))
+        goto fail;
+
+    return obj_data;
+
+fail:
+    aot_obj_data_destroy(obj_data);
+    return NULL;
+}
+
 static AOTObjectData *
 aot_obj_data_create(AOTCompContext *comp_ctx)
 {
@@ -3432,6 +3801,9 @@ aot_obj_data_create(AOTCompContext *comp_ctx)
     AOTObjectData *obj_data;
     LLVMTargetRef target = LLVMGetTargetMachineTarget(comp_ctx->target_machine);
 
+    if (comp_ctx->partition_count > 0)
+        return aot_obj_data_create_partitions(comp_ctx);
+
     bh_print_time("Begin to emit object file to buffer");
 
     if (!(obj_data = wasm_runtime_malloc(sizeof(AOTObjectData)))) {
@@ -3558,15 +3930,6 @@ aot_obj_data_create(AOTCompContext *comp_ctx)
         }
     }
 
-    if (!(obj_data->binary = LLVMCreateBinary(obj_data->mem_buf, NULL, &err))) {
-        if (err) {
-            LLVMDisposeMessage(err);
-            err = NULL;
-        }
-        aot_set_last_error("llvm create binary failed.");
-        goto fail;
-    }
-
     bh_print_time("Begin to resolve object file info");
 
     char *object_file_name =
@@ -3580,12 +3943,7 @@ aot_obj_data_create(AOTCompContext *comp_ctx)
     printf("Write object file to %s\n", object_file_name);
     free(object_file_name);
 
-    /* resolve target info/text/relocations/functions */
-    if (!aot_resolve_target_info(comp_ctx, obj_data)
-        || !aot_resolve_text(obj_data) || !aot_resolve_literal(obj_data)
-        || !aot_resolve_object_data_sections(obj_data)
-        || !aot_resolve_functions(comp_ctx, obj_data)
-        || !aot_resolve_object_relocation_groups(obj_data))
+    if (!aot_resolve_obj_data(comp_ctx, obj_data))
         goto fail;
 
     return obj_data;
@@ -170,6 +170,54 @@ restore_frame_sp(AOTBlock *block, AOTCompFrame *aot_frame)
     aot_frame->sp = block->frame_sp_begin;
 }
 
+/* Merge the dirty bits of the frame slots below the begin frame sp of the
+   block into *p_bits, only these slots survive when control leaves the
+   block through its end */
+static bool
+save_frame_dirty_bits(AOTCompFrame *aot_frame, AOTBlock *block,
+                      uint8 **p_bits)
+{
+    uint32 cell_num = (uint32)(block->frame_sp_begin - aot_frame->lp), i;
+
+    if (!*p_bits) {
+        if (!(*p_bits = wasm_runtime_malloc(cell_num + 1))) {
+            aot_set_last_error("allocate memory failed.");
+            return false;
+        }
+        memset(*p_bits, 0, cell_num + 1);
+    }
+
+    for (i = 0; i < cell_num; i++)
+        (*p_bits)[i] |= aot_frame->lp[i].dirty;
+    return true;
+}
+
+/* Set the dirty bits of the frame slots below the begin frame sp of the
+   block, all of them are dirty if no state was saved */
+static void
+load_frame_dirty_bits(AOTCompFrame *aot_frame, AOTBlock *block,
+                      const uint8 *bits)
+{
+    uint32 cell_num = (uint32)(block->frame_sp_begin - aot_frame->lp), i;
+
+    for (i = 0; i < cell_num; i++)
+        aot_frame->lp[i].dirty = bits ? bits[i] : 1;
+}
+
+/* Record the dirty bits of a branch to the end of the target block, so
+   that the checkpoints after the block end only commit the slots which
+   may be dirty on any incoming path */
+static bool
+record_branch_dirty_bits(AOTCompContext *comp_ctx, AOTBlock *block_dst)
+{
+    if (!comp_ctx->aot_frame || block_dst->label_type == LABEL_TYPE_LOOP
+        || block_dst->label_type == LABEL_TYPE_FUNCTION)
+        return true;
+
+    return save_frame_dirty_bits(comp_ctx->aot_frame, block_dst,
+                                 &block_dst->frame_dirty_end);
+}
+
 static bool
 handle_next_reachable_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                             uint8 **p_frame_ip)
@@ -200,8 +248,9 @@ handle_next_reachable_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         aot_value_stack_destroy(comp_ctx, &block->value_stack);
 
         if (aot_frame) {
-            /* Restore the frame sp */
+            /* Restore the frame sp and the dirty bits */
             restore_frame_sp(block, aot_frame);
+            load_frame_dirty_bits(aot_frame, block, block->frame_dirty_begin);
         }
 
         /* Recover parameters of else branch */
@@ -226,6 +275,9 @@ handle_next_reachable_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                 && *p_frame_ip <= block->wasm_code_else) {
                 /* Clear value stack and start to translate else branch */
                 aot_value_stack_destroy(comp_ctx, &block->value_stack);
+                if (aot_frame)
+                    load_frame_dirty_bits(aot_frame, block,
+                                          block->frame_dirty_begin);
                 SET_BUILDER_POS(block->llvm_else_block);
                 *p_frame_ip = block->wasm_code_else + 1;
                 /* Push back the block */
@@ -257,6 +309,10 @@ handle_next_reachable_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         && *p_frame_ip <= block->wasm_code_else) {
         /* Clear value stack and start to translate else branch */
         aot_value_stack_destroy(comp_ctx, &block->value_stack);
+        if (aot_frame) {
+            restore_frame_sp(block, aot_frame);
+            load_frame_dirty_bits(aot_frame, block, block->frame_dirty_begin);
+        }
         /* Recover parameters of else branch */
         for (i = 0; i < block->param_count; i++)
             PUSH(block->else_param_phis[i], block->param_types[i]);
@@ -272,8 +328,11 @@ handle_next_reachable_block(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     block = aot_block_stack_pop(&func_ctx->block_stack);
 
     if (aot_frame) {
-        /* Restore the frame sp */
+        /* Restore the frame sp, and merge the dirty bits of all the
+           branches to the block end */
         restore_frame_sp(block, aot_frame);
+        if (block->label_type != LABEL_TYPE_FUNCTION)
+            load_frame_dirty_bits(aot_frame, block, block->frame_dirty_end);
     }
 
     func_type = func_ctx->aot_func->func_type;
@@ -419,6 +478,18 @@ push_aot_block_to_stack_and_pass_params(AOTCompContext *comp_ctx,
     aot_block_stack_push(&func_ctx->block_stack, block);
     if (comp_ctx->aot_frame) {
         block->frame_sp_begin = comp_ctx->aot_frame->sp;
+        if (block->label_type == LABEL_TYPE_IF
+            && !block->skip_wasm_code_else) {
+            if (block->llvm_else_block && block->llvm_entry_block
+                && !save_frame_dirty_bits(comp_ctx->aot_frame, block,
+                                          &block->frame_dirty_begin))
+                goto fail;
+            /* The false branch of IF without else goes to the end */
+            if (!block->llvm_else_block
+                && !save_frame_dirty_bits(comp_ctx->aot_frame, block,
+                                          &block->frame_dirty_end))
+                goto fail;
+        }
     }
 
     /* Push param phis to the new block */
@@ -690,6 +761,10 @@ aot_compile_op_else(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     //     aot_gen_commit_values(aot_frame);
     // }
 
+    if (aot_frame
+        && !save_frame_dirty_bits(aot_frame, block, &block->frame_dirty_end))
+        return false;
+
     /* Jump to end block */
     BUILD_BR(block->llvm_end_block);
 
@@ -698,8 +773,9 @@ aot_compile_op_else(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
            and start to translate else branch. */
         aot_value_stack_destroy(comp_ctx, &block->value_stack);
 
-        if (comp_ctx->aot_frame) {
-            comp_ctx->aot_frame->sp = block->frame_sp_begin;
+        if (aot_frame) {
+            restore_frame_sp(block, aot_frame);
+            load_frame_dirty_bits(aot_frame, block, block->frame_dirty_begin);
         }
 
         for (i = 0; i < block->param_count; i++)
@@ -760,6 +836,10 @@ aot_compile_op_end(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     if (comp_ctx->aot_frame) {
         restore_frame_sp(block, comp_ctx->aot_frame);
+        if (block->label_type != LABEL_TYPE_FUNCTION
+            && !save_frame_dirty_bits(comp_ctx->aot_frame, block,
+                                      &block->frame_dirty_end))
+            return false;
     }
 
     /* Jump to the end block */
@@ -900,6 +980,8 @@ aot_compile_op_br(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         }
 
         block_dst->is_reachable = true;
+        if (!record_branch_dirty_bits(comp_ctx, block_dst))
+            return false;
 
         /* Handle result values */
         CREATE_RESULT_VALUE_PHIS(block_dst);
@@ -1023,6 +1105,8 @@ aot_compile_op_br_if(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
             /* Set reachable flag and create condition br IR */
             block_dst->is_reachable = true;
+            if (!record_branch_dirty_bits(comp_ctx, block_dst))
+                goto fail;
 
             /* Handle result values */
             if (block_dst->result_count) {
@@ -1167,6 +1251,8 @@ aot_compile_op_br_table(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                     wasm_runtime_free(values);
                 }
                 target_block->is_reachable = true;
+                if (!record_branch_dirty_bits(comp_ctx, target_block))
+                    goto fail;
                 if (i == br_count)
                     default_llvm_block = target_block->llvm_end_block;
             }
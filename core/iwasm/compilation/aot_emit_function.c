@@ -290,6 +290,171 @@ call_aot_invoke_native_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     return true;
 }
 
+/* Whether the import function's wasm type maps one to one to the C ABI
+   of a native `ret func(exec_env, params...)`, so that it can be called
+   directly instead of packing the arguments into argv */
+static bool
+is_direct_callable_import_type(const AOTFuncType *func_type)
+{
+    uint32 i;
+
+    if (func_type->result_count > 1)
+        return false;
+
+    for (i = 0; i < func_type->param_count + func_type->result_count; i++) {
+        switch (func_type->types[i]) {
+            case VALUE_TYPE_I32:
+            case VALUE_TYPE_I64:
+            case VALUE_TYPE_F32:
+            case VALUE_TYPE_F64:
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+/* Call an import function whose signature isn't known at compile time:
+   if the runtime resolved it to a plain native function, the entry of
+   module_inst->import_func_ptrs is set at instantiation and the native
+   is called directly, otherwise fall back to aot_invoke_native() */
+static bool
+call_import_func_direct_or_invoke_native(
+    AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+    LLVMValueRef import_func_idx, AOTFuncType *aot_func_type,
+    LLVMTypeRef *param_types, LLVMValueRef *param_values, uint32 param_count,
+    uint32 param_cell_num, LLVMTypeRef ret_type, uint8 wasm_ret_type,
+    LLVMValueRef *p_value_ret)
+{
+    LLVMBasicBlockRef block_direct_call, block_invoke_native, block_call_end;
+    LLVMBasicBlockRef block_curr;
+    LLVMTypeRef native_func_type, func_ptr_type;
+    LLVMValueRef offset, import_func_ptrs, func_ptr, cmp, res;
+    LLVMValueRef value_ret = NULL, value_ret_native = NULL, phi = NULL;
+
+    /* Load module_inst->import_func_ptrs[import_func_idx] */
+    offset = I32_CONST(offsetof(AOTModuleInstance, import_func_ptrs));
+    if (!offset) {
+        aot_set_last_error("llvm create const failed.");
+        return false;
+    }
+    if (!(import_func_ptrs = LLVMBuildInBoundsGEP2(
+              comp_ctx->builder, INT8_TYPE, func_ctx->aot_inst, &offset, 1,
+              "import_func_ptrs_offset"))
+        || !(import_func_ptrs = LLVMBuildBitCast(
+                 comp_ctx->builder, import_func_ptrs, comp_ctx->exec_env_type,
+                 "import_func_ptrs_tmp"))
+        || !(import_func_ptrs =
+                 LLVMBuildLoad2(comp_ctx->builder, OPQ_PTR_TYPE,
+                                import_func_ptrs, "import_func_ptrs"))) {
+        aot_set_last_error("llvm build load failed.");
+        return false;
+    }
+    if (!(func_ptr = LLVMBuildInBoundsGEP2(comp_ctx->builder, OPQ_PTR_TYPE,
+                                           import_func_ptrs, &import_func_idx,
+                                           1, "direct_func_ptr_tmp"))
+        || !(func_ptr = LLVMBuildLoad2(comp_ctx->builder, OPQ_PTR_TYPE,
+                                       func_ptr, "direct_func_ptr"))) {
+        aot_set_last_error("llvm build load failed.");
+        return false;
+    }
+
+    if (!(cmp = LLVMBuildIsNotNull(comp_ctx->builder, func_ptr,
+                                   "is_direct_callable"))) {
+        aot_set_last_error("llvm build icmp failed.");
+        return false;
+    }
+
+    /* Add basic blocks */
+    block_curr = LLVMGetInsertBlock(comp_ctx->builder);
+    block_direct_call = LLVMAppendBasicBlockInContext(
+        comp_ctx->context, func_ctx->func, "call_native_direct");
+    block_invoke_native = LLVMAppendBasicBlockInContext(
+        comp_ctx->context, func_ctx->func, "call_invoke_native");
+    block_call_end = LLVMAppendBasicBlockInContext(
+        comp_ctx->context, func_ctx->func, "call_native_end");
+    if (!block_direct_call || !block_invoke_native || !block_call_end) {
+        aot_set_last_error("llvm add basic block failed.");
+        return false;
+    }
+    LLVMMoveBasicBlockAfter(block_direct_call, block_curr);
+    LLVMMoveBasicBlockAfter(block_invoke_native, block_direct_call);
+    LLVMMoveBasicBlockAfter(block_call_end, block_invoke_native);
+
+    if (!LLVMBuildCondBr(comp_ctx->builder, cmp, block_direct_call,
+                         block_invoke_native)) {
+        aot_set_last_error("llvm build cond br failed.");
+        return false;
+    }
+
+    /* Translate direct call block: the native's C ABI is exactly the
+       wasm function type with exec_env as the first argument */
+    LLVMPositionBuilderAtEnd(comp_ctx->builder, block_direct_call);
+    if (!(native_func_type = LLVMFunctionType(ret_type, param_types,
+                                              param_count + 1, false))) {
+        aot_set_last_error("llvm add function type failed.");
+        return false;
+    }
+    if (!(func_ptr_type = LLVMPointerType(native_func_type, 0))) {
+        aot_set_last_error("create LLVM function type failed.");
+        return false;
+    }
+    if (!(func_ptr = LLVMBuildBitCast(comp_ctx->builder, func_ptr,
+                                      func_ptr_type, "direct_func"))) {
+        aot_set_last_error("llvm bit cast failed.");
+        return false;
+    }
+    if (!(value_ret = LLVMBuildCall2(
+              comp_ctx->builder, native_func_type, func_ptr, param_values,
+              param_count + 1,
+              (wasm_ret_type != VALUE_TYPE_VOID ? "direct_call" : "")))) {
+        aot_set_last_error("llvm build call failed.");
+        return false;
+    }
+    if (!check_exception_thrown(comp_ctx, func_ctx))
+        return false;
+    block_curr = LLVMGetInsertBlock(comp_ctx->builder);
+    if (!LLVMBuildBr(comp_ctx->builder, block_call_end)) {
+        aot_set_last_error("llvm build br failed.");
+        return false;
+    }
+
+    if (wasm_ret_type != VALUE_TYPE_VOID) {
+        LLVMPositionBuilderAtEnd(comp_ctx->builder, block_call_end);
+        if (!(phi = LLVMBuildPhi(comp_ctx->builder, ret_type, "phi"))) {
+            aot_set_last_error("llvm build phi failed.");
+            return false;
+        }
+        LLVMAddIncoming(phi, &value_ret, &block_curr, 1);
+    }
+
+    /* Translate invoke native block */
+    LLVMPositionBuilderAtEnd(comp_ctx->builder, block_invoke_native);
+    if (!call_aot_invoke_native_func(
+            comp_ctx, func_ctx, import_func_idx, aot_func_type,
+            param_types + 1, param_values + 1, param_count, param_cell_num,
+            ret_type, wasm_ret_type, &value_ret_native, &res))
+        return false;
+    /* Check whether there was exception thrown when executing
+       the function */
+    if ((comp_ctx->enable_bound_check || is_win_platform(comp_ctx))
+        && !check_call_return(comp_ctx, func_ctx, res))
+        return false;
+    block_curr = LLVMGetInsertBlock(comp_ctx->builder);
+    if (!LLVMBuildBr(comp_ctx->builder, block_call_end)) {
+        aot_set_last_error("llvm build br failed.");
+        return false;
+    }
+
+    if (phi)
+        LLVMAddIncoming(phi, &value_ret_native, &block_curr, 1);
+
+    LLVMPositionBuilderAtEnd(comp_ctx->builder, block_call_end);
+    *p_value_ret = phi;
+    return true;
+}
+
 #if (WASM_ENABLE_DUMP_CALL_STACK != 0) || (WASM_ENABLE_PERF_PROFILING != 0)
 bool
 call_aot_alloc_frame_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
@@ -690,7 +855,17 @@ aot_compile_op_call(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             ret_type = VOID_TYPE;
         }
 
-        if (!signature) {
+        if (!signature && !comp_ctx->is_jit_mode
+            && is_direct_callable_import_type(func_type)) {
+            /* call the native func directly if the runtime links it to
+               a plain native, otherwise call aot_invoke_native() */
+            if (!call_import_func_direct_or_invoke_native(
+                    comp_ctx, func_ctx, import_func_idx, func_type,
+                    param_types, param_values, param_count, param_cell_num,
+                    ret_type, wasm_ret_type, &value_ret))
+                goto fail;
+        }
+        else if (!signature) {
             /* call aot_invoke_native() */
             if (!call_aot_invoke_native_func(
                     comp_ctx, func_ctx, import_func_idx, func_type,
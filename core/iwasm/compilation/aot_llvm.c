@@ -1668,6 +1668,37 @@ fail:
     return NULL;
 }
 
+/**
+ * Create the context of a function which is compiled by another partition,
+ * only the LLVM function declaration is added so that it can be called
+ */
+static AOTFuncContext *
+aot_create_func_decl_context(const AOTCompData *comp_data,
+                             AOTCompContext *comp_ctx, AOTFunc *func,
+                             uint32 func_index)
+{
+    AOTFuncContext *func_ctx;
+    AOTFuncType *aot_func_type = comp_data->func_types[func->func_type_index];
+
+    if (!(func_ctx = wasm_runtime_malloc(sizeof(AOTFuncContext)))) {
+        aot_set_last_error("allocate memory failed.");
+        return NULL;
+    }
+
+    memset(func_ctx, 0, sizeof(AOTFuncContext));
+    func_ctx->aot_func = func;
+    func_ctx->module = comp_ctx->module;
+
+    if (!(func_ctx->func = aot_add_llvm_func(
+              comp_ctx, func_ctx->module, aot_func_type, func_index,
+              &func_ctx->func_type, &func_ctx->precheck_func))) {
+        wasm_runtime_free(func_ctx);
+        return NULL;
+    }
+
+    return func_ctx;
+}
+
 static void
 aot_destroy_func_contexts(AOTCompContext *comp_ctx, AOTFuncContext **func_ctxes,
                           uint32 count)
@@ -1713,8 +1744,13 @@ aot_create_func_contexts(const AOTCompData *comp_data, AOTCompContext *comp_ctx)
     /* Create each function context */
     for (i = 0; i < comp_data->func_count; i++) {
         AOTFunc *func = comp_data->funcs[i];
-        if (!(func_ctxes[i] =
-                  aot_create_func_context(comp_data, comp_ctx, func, i))) {
+        if (i < comp_ctx->func_part_begin || i >= comp_ctx->func_part_end)
+            func_ctxes[i] =
+                aot_create_func_decl_context(comp_data, comp_ctx, func, i);
+        else
+            func_ctxes[i] =
+                aot_create_func_context(comp_data, comp_ctx, func, i);
+        if (!func_ctxes[i]) {
             aot_destroy_func_contexts(comp_ctx, func_ctxes,
                                       comp_data->func_count);
             return NULL;
@@ -2284,8 +2320,104 @@ aot_compiler_destroy(void)
     LLVMShutdown();
 }
 
-AOTCompContext *
-aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
+/* Size of the wasm bytecode compiled by one partition, the partitions
+   only depend on the module so the output doesn't vary with the number
+   of threads */
+#define AOT_PARTITION_CODE_SIZE (64 * 1024)
+#define AOT_PARTITION_MAX_COUNT 128
+
+/**
+ * Split the functions into partitions which are compiled to separate
+ * object files by several threads. The partitions are contiguous ranges
+ * of function indexes balanced by their bytecode size: functions of the
+ * same source file are usually adjacent in the module, so most calls stay
+ * inside a partition where they can be inlined.
+ */
+static bool
+aot_create_partitions(const AOTCompData *comp_data, AOTCompContext *comp_ctx,
+                      aot_comp_option_t option)
+{
+    const char *reason = NULL;
+    char *triple;
+    uint64 total_size = 0, size = 0;
+    uint32 count, i, j;
+
+    triple = LLVMGetTargetMachineTriple(comp_ctx->target_machine);
+
+    if (option->output_format != AOT_FORMAT_FILE)
+        reason = "the output format isn't AOT file";
+    else if (comp_ctx->is_indirect_mode)
+        reason = "indirect mode is enabled";
+    else if (comp_ctx->enable_llvm_pgo)
+        reason = "LLVM PGO is enabled";
+    else if (comp_ctx->enable_stack_bound_check
+             || comp_ctx->enable_stack_estimation)
+        reason = "native stack check or estimation is enabled";
+    else if (comp_ctx->external_llc_compiler
+             || comp_ctx->external_asm_compiler)
+        reason = "an external compiler is used";
+    /* The object files are merged by rebasing their ELF RELA relocations */
+    else if ((strcmp(comp_ctx->target_arch, "x86_64")
+              && strncmp(comp_ctx->target_arch, "aarch64", 7))
+             || !triple || strstr(triple, "windows") || strstr(triple, "win32")
+             || strstr(triple, "darwin"))
+        reason = "the target isn't supported";
+#if WASM_ENABLE_DEBUG_AOT != 0
+    else
+        reason = "debug info is generated";
+#endif
+
+    if (triple)
+        LLVMDisposeMessage(triple);
+
+    if (reason) {
+        LOG_WARNING("Compile with one thread as %s", reason);
+        return true;
+    }
+
+    for (i = 0; i < comp_data->func_count; i++)
+        total_size += comp_data->funcs[i]->code_size;
+
+    count = (uint32)((total_size + AOT_PARTITION_CODE_SIZE - 1)
+                     / AOT_PARTITION_CODE_SIZE);
+    if (count > AOT_PARTITION_MAX_COUNT)
+        count = AOT_PARTITION_MAX_COUNT;
+    if (count > comp_data->func_count)
+        count = comp_data->func_count;
+    if (count <= 1)
+        return true;
+
+    if (!(comp_ctx->partition_bounds =
+              wasm_runtime_malloc(sizeof(uint32) * (count + 1)))
+        || !(comp_ctx->partition_objs =
+                 wasm_runtime_malloc(sizeof(LLVMMemoryBufferRef) * count))
+        || !(comp_ctx->partition_option =
+                 wasm_runtime_malloc(sizeof(AOTCompOption)))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    memset(comp_ctx->partition_objs, 0, sizeof(LLVMMemoryBufferRef) * count);
+    bh_memcpy_s(comp_ctx->partition_option, sizeof(AOTCompOption), option,
+                sizeof(AOTCompOption));
+
+    /* Close a partition each time the accumulated size passes the next
+       multiple of total_size / count, never leave a partition empty */
+    comp_ctx->partition_bounds[0] = 0;
+    for (i = 0, j = 1; i + 1 < comp_data->func_count && j < count; i++) {
+        size += comp_data->funcs[i]->code_size;
+        if (size * count >= total_size * j)
+            comp_ctx->partition_bounds[j++] = i + 1;
+    }
+    comp_ctx->partition_bounds[j] = comp_data->func_count;
+    comp_ctx->partition_count = j;
+    comp_ctx->thread_num = option->thread_num;
+
+    return true;
+}
+
+static AOTCompContext *
+create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option,
+                    const AOTCompContext *parent, uint32 partition_idx)
 {
     AOTCompContext *comp_ctx, *ret = NULL;
     LLVMTargetRef target;
@@ -2308,6 +2440,15 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
     memset(comp_ctx, 0, sizeof(AOTCompContext));
     comp_ctx->comp_data = comp_data;
 
+    if (parent) {
+        comp_ctx->is_partition = true;
+        comp_ctx->func_part_begin = parent->partition_bounds[partition_idx];
+        comp_ctx->func_part_end = parent->partition_bounds[partition_idx + 1];
+    }
+    else {
+        comp_ctx->func_part_end = comp_data->func_count;
+    }
+
     /* Create LLVM context, module and builder */
     comp_ctx->orc_thread_safe_context = LLVMOrcCreateNewThreadSafeContext();
     if (!comp_ctx->orc_thread_safe_context) {
@@ -2417,6 +2558,18 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
 
     comp_ctx->aot_file_name = option->aot_file_name;
 
+    if (comp_ctx->enable_checkpoint_pgo && comp_ctx->aot_file_name) {
+        char pgo_file_name[256], error_buf[128];
+
+        snprintf(pgo_file_name, sizeof(pgo_file_name), "%s.pgo",
+                 comp_ctx->aot_file_name);
+        /* Without a profile every loop keeps its safepoint */
+        if (!(comp_ctx->checkpoint_profile = wasm_checkpoint_profile_load(
+                  pgo_file_name, error_buf, sizeof(error_buf)))
+            && !comp_ctx->is_partition)
+            LOG_WARNING("%s, ignore %s", error_buf, pgo_file_name);
+    }
+
     if (option->exp_disable_commit_sp_ip)
         comp_ctx->exp_disable_commit_sp_ip = true;
 
@@ -2842,26 +2995,28 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
             comp_ctx->stack_usage_file = option->stack_usage_file;
         }
 
-        os_printf("Create AoT compiler with:\n");
-        os_printf("  target:        %s\n", comp_ctx->target_arch);
-        os_printf("  target cpu:    %s\n", cpu);
-        os_printf("  target triple: %s\n", triple_norm);
-        os_printf("  cpu features:  %s\n", features);
-        os_printf("  opt level:     %d\n", opt_level);
-        os_printf("  size level:    %d\n", size_level);
-        switch (option->output_format) {
-            case AOT_LLVMIR_UNOPT_FILE:
-                os_printf("  output format: unoptimized LLVM IR\n");
-                break;
-            case AOT_LLVMIR_OPT_FILE:
-                os_printf("  output format: optimized LLVM IR\n");
-                break;
-            case AOT_FORMAT_FILE:
-                os_printf("  output format: AoT file\n");
-                break;
-            case AOT_OBJECT_FILE:
-                os_printf("  output format: native object file\n");
-                break;
+        if (!comp_ctx->is_partition) {
+            os_printf("Create AoT compiler with:\n");
+            os_printf("  target:        %s\n", comp_ctx->target_arch);
+            os_printf("  target cpu:    %s\n", cpu);
+            os_printf("  target triple: %s\n", triple_norm);
+            os_printf("  cpu features:  %s\n", features);
+            os_printf("  opt level:     %d\n", opt_level);
+            os_printf("  size level:    %d\n", size_level);
+            switch (option->output_format) {
+                case AOT_LLVMIR_UNOPT_FILE:
+                    os_printf("  output format: unoptimized LLVM IR\n");
+                    break;
+                case AOT_LLVMIR_OPT_FILE:
+                    os_printf("  output format: optimized LLVM IR\n");
+                    break;
+                case AOT_FORMAT_FILE:
+                    os_printf("  output format: AoT file\n");
+                    break;
+                case AOT_OBJECT_FILE:
+                    os_printf("  output format: native object file\n");
+                    break;
+            }
         }
 
         LLVMSetTarget(comp_ctx->module, triple_norm);
@@ -3013,9 +3168,14 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
     /* set aot_inst data type to int8* */
     comp_ctx->aot_inst_type = INT8_PTR_TYPE;
 
-    /* Create function context for each function */
+    if (!parent && option->thread_num > 0
+        && !aot_create_partitions(comp_data, comp_ctx, option))
+        goto fail;
+
+    /* Create function context for each function, the functions of a
+       partitioned compilation are compiled by the partition contexts */
     comp_ctx->func_ctx_count = comp_data->func_count;
-    if (comp_data->func_count > 0
+    if (comp_data->func_count > 0 && comp_ctx->partition_count == 0
         && !(comp_ctx->func_ctxes =
                  aot_create_func_contexts(comp_data, comp_ctx)))
         goto fail;
@@ -3048,6 +3208,25 @@ fail:
     return ret;
 }
 
+AOTCompContext *
+aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
+{
+    return create_comp_context(comp_data, option, NULL, 0);
+}
+
+AOTCompContext *
+aot_create_partition_comp_context(const AOTCompContext *comp_ctx,
+                                  uint32 partition_idx)
+{
+    /* Creating a context may adjust the option, use a copy so that the
+       partition contexts can be created by several threads at a time */
+    AOTCompOption option = *comp_ctx->partition_option;
+
+    bh_assert(partition_idx < comp_ctx->partition_count);
+    return create_comp_context(comp_ctx->comp_data, &option, comp_ctx,
+                               partition_idx);
+}
+
 void
 aot_destroy_comp_context(AOTCompContext *comp_ctx)
 {
@@ -3088,6 +3267,9 @@ aot_destroy_comp_context(AOTCompContext *comp_ctx)
         }
     }
 
+    if (comp_ctx->checkpoint_profile)
+        wasm_checkpoint_profile_destroy(comp_ctx->checkpoint_profile);
+
     if (comp_ctx->target_cpu) {
         wasm_runtime_free(comp_ctx->target_cpu);
     }
@@ -3096,6 +3278,20 @@ aot_destroy_comp_context(AOTCompContext *comp_ctx)
         wasm_runtime_free(comp_ctx->aot_frame);
     }
 
+    if (comp_ctx->partition_objs) {
+        uint32 i;
+        for (i = 0; i < comp_ctx->partition_count; i++)
+            if (comp_ctx->partition_objs[i])
+                LLVMDisposeMemoryBuffer(comp_ctx->partition_objs[i]);
+        wasm_runtime_free(comp_ctx->partition_objs);
+    }
+
+    if (comp_ctx->partition_bounds)
+        wasm_runtime_free(comp_ctx->partition_bounds);
+
+    if (comp_ctx->partition_option)
+        wasm_runtime_free(comp_ctx->partition_option);
+
     wasm_runtime_free(comp_ctx);
 }
 
@@ -3383,6 +3579,10 @@ aot_block_destroy(AOTCompContext *comp_ctx, AOTBlock *block)
         wasm_runtime_free(block->result_types);
     if (block->result_phis)
         wasm_runtime_free(block->result_phis);
+    if (block->frame_dirty_begin)
+        wasm_runtime_free(block->frame_dirty_begin);
+    if (block->frame_dirty_end)
+        wasm_runtime_free(block->frame_dirty_end);
     wasm_runtime_free(block);
 }
 
@@ -7,6 +7,7 @@
 #define _AOT_LLVM_H_
 
 #include "aot.h"
+#include "../common/wasm_checkpoint_profile.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm-c/Types.h"
 #include "llvm-c/Target.h"
@@ -176,6 +177,13 @@ typedef struct AOTBlock {
 
     /* The begin frame stack pointer of this block */
     AOTValueSlot *frame_sp_begin;
+
+    /* Dirty bits of the frame slots below frame_sp_begin when entering
+       the block, only kept for IF block to translate its else branch */
+    uint8 *frame_dirty_begin;
+    /* Union of the dirty bits of the frame slots below frame_sp_begin
+       over all the branches to the end of this block */
+    uint8 *frame_dirty_end;
 } AOTBlock;
 
 /**
@@ -404,6 +412,8 @@ typedef struct AOTCompContext {
     bool enable_counter_loop_checkpoint;
     bool enable_checkpoint_pgo;
     const char *aot_file_name;
+    /* Loaded from "<aot_file_name>.pgo" if checkpoint PGO is enabled */
+    WASMCheckpointProfile *checkpoint_profile;
     bool exp_disable_stack_commit_before_block;
     bool exp_disable_gen_fence_int3;
     bool exp_disable_commit_sp_ip;
@@ -494,6 +504,22 @@ typedef struct AOTCompContext {
     const char *llvm_passes;
     const char *builtin_intrinsics;
 
+    /* Partitioned compilation, see aot_compile_wasm. Functions with index
+       in [func_part_begin, func_part_end) are compiled by this context, the
+       others are only declared so that they can be called */
+    bool is_partition;
+    uint32 func_part_begin;
+    uint32 func_part_end;
+    /* The following are only set in the parent context: the worker thread
+       number, the partition bounds (partition_count + 1 function indexes),
+       the option to create the partition contexts with and the object
+       file emitted for each partition */
+    uint32 thread_num;
+    uint32 partition_count;
+    uint32 *partition_bounds;
+    struct AOTCompOption *partition_option;
+    LLVMMemoryBufferRef *partition_objs;
+
     /* Current frame information for translation */
     AOTCompFrame *aot_frame;
     LLVMBuilderRef aot_frame_alloca_builder;
@@ -552,6 +578,7 @@ typedef struct AOTCompOption {
     const char *stack_usage_file;
     const char *llvm_passes;
     const char *builtin_intrinsics;
+    uint32 thread_num;
 } AOTCompOption, *aot_comp_option_t;
 
 bool
@@ -563,6 +590,10 @@ aot_compiler_destroy(void);
 AOTCompContext *
 aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option);
 
+AOTCompContext *
+aot_create_partition_comp_context(const AOTCompContext *comp_ctx,
+                                  uint32 partition_idx);
+
 void
 aot_destroy_comp_context(AOTCompContext *comp_ctx);
 
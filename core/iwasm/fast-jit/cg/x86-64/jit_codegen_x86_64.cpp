@@ -1367,6 +1367,34 @@ mov_r_to_r_i64(x86::Assembler &a, int32 reg_no_dst, int32 reg_no_src)
     return true;
 }
 
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+/**
+ * Encode moving an absolute address to a register, always with an 8-byte
+ * immediate so that the persistent code cache can relocate it
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param reg_no the no of dst register
+ * @param addr the absolute address
+ *
+ * @return true if success, false otherwise
+ */
+static bool
+mov_abs_addr_to_r_i64(JitCompContext *cc, x86::Assembler &a, int32 reg_no,
+                      uintptr_t addr)
+{
+    Imm imm(INT64_MAX);
+    uint32 offset;
+
+    a.mov(regs_i64[reg_no], imm);
+
+    offset = a.code()->sectionById(0)->buffer().size() - sizeof(uint64);
+    *(uint64 *)(a.code()->sectionById(0)->buffer().data() + offset) =
+        (uint64)addr;
+    return jit_cc_add_reloc(cc, offset, JIT_RELOC_ABS, (uint64)addr);
+}
+#endif
+
 /**
  * Encode moving immediate float data to register
  *
@@ -5881,7 +5909,9 @@ lower_callnative(JitCompContext *cc, x86::Assembler &a, JitInsn *insn)
     /* the index of callee saved registers in regs_i64 */
     uint8 regs_arg_idx[] = { REG_RDI_IDX, REG_RSI_IDX, REG_RDX_IDX,
                              REG_RCX_IDX, REG_R8_IDX,  REG_R9_IDX };
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE == 0
     Imm imm;
+#endif
     uint32 i, opnd_num;
     int32 integer_reg_index = 0, floatpoint_reg_index = 0;
 
@@ -5969,8 +5999,13 @@ lower_callnative(JitCompContext *cc, x86::Assembler &a, JitInsn *insn)
         }
     }
 
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    if (!mov_abs_addr_to_r_i64(cc, a, REG_RAX_IDX, (uintptr_t)func_ptr))
+        GOTO_FAIL;
+#else
     imm.setValue((uint64)func_ptr);
     a.mov(regs_i64[REG_RAX_IDX], imm);
+#endif
     a.call(regs_i64[REG_RAX_IDX]);
 
     if (ret_reg) {
@@ -6151,8 +6186,15 @@ lower_return(JitCompContext *cc, x86::Assembler &a, JitInsn *insn)
         Imm imm(act);
         a.mov(x86::eax, imm);
 
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+        if (!mov_abs_addr_to_r_i64(
+                cc, a, REG_I64_FREE_IDX,
+                (uintptr_t)code_block_return_to_interp_from_jitted))
+            GOTO_FAIL;
+#else
         imm.setValue((uintptr_t)code_block_return_to_interp_from_jitted);
         a.mov(regs_i64[REG_I64_FREE_IDX], imm);
+#endif
         a.jmp(regs_i64[REG_I64_FREE_IDX]);
     }
     return true;
@@ -6166,26 +6208,31 @@ fail:
  *
  * @param cc compiler context containting the allocated code cacha info
  * @param jmp_info_list the jmp info list
+ * @param code_buf the code to patch, which is copied to the allocated
+ * code cache afterwards
  */
 static void
-patch_jmp_info_list(JitCompContext *cc, bh_list *jmp_info_list)
+patch_jmp_info_list(JitCompContext *cc, bh_list *jmp_info_list,
+                    char *code_buf)
 {
     JmpInfo *jmp_info, *jmp_info_next;
     JitReg reg_dst;
-    char *stream;
+    char *stream, *buf;
 
     jmp_info = (JmpInfo *)bh_list_first_elem(jmp_info_list);
 
     while (jmp_info) {
         jmp_info_next = (JmpInfo *)bh_list_elem_next(jmp_info);
 
+        /* The addresses are calculated with the allocated code cache */
         stream = (char *)cc->jitted_addr_begin + jmp_info->offset;
+        buf = code_buf + jmp_info->offset;
 
         if (jmp_info->type == JMP_DST_LABEL_REL) {
             /* Jmp with relative address */
             reg_dst =
                 jit_reg_new(JIT_REG_KIND_L32, jmp_info->dst_info.label_dst);
-            *(int32 *)stream =
+            *(int32 *)buf =
                 (int32)((uintptr_t)*jit_annl_jitted_addr(cc, reg_dst)
                         - (uintptr_t)stream)
                 - 4;
@@ -6194,22 +6241,58 @@ patch_jmp_info_list(JitCompContext *cc, bh_list *jmp_info_list)
             /* Jmp with absolute address */
             reg_dst =
                 jit_reg_new(JIT_REG_KIND_L32, jmp_info->dst_info.label_dst);
-            *(uintptr_t *)stream =
-                (uintptr_t)*jit_annl_jitted_addr(cc, reg_dst);
+            *(uintptr_t *)buf = (uintptr_t)*jit_annl_jitted_addr(cc, reg_dst);
         }
         else if (jmp_info->type == JMP_END_OF_CALLBC) {
             /* 7 is the size of mov and jmp instruction */
-            *(uintptr_t *)stream = (uintptr_t)stream + sizeof(uintptr_t) + 7;
+            *(uintptr_t *)buf = (uintptr_t)stream + sizeof(uintptr_t) + 7;
         }
         else if (jmp_info->type == JMP_LOOKUPSWITCH_BASE) {
             /* 11 is the size of 8-byte addr and 3-byte jmp instruction */
-            *(uintptr_t *)stream = (uintptr_t)stream + 11;
+            *(uintptr_t *)buf = (uintptr_t)stream + 11;
         }
 
         jmp_info = jmp_info_next;
     }
 }
 
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+/**
+ * Record the absolute addresses in the jitted code which will be patched
+ * with the jmp info list, as offsets to the beginning of the code
+ *
+ * @param cc compiler context
+ * @param jmp_info_list the jmp info list
+ * @param label_offsets the offsets of each label
+ *
+ * @return true if success, false if failed
+ */
+static bool
+record_jmp_info_relocs(JitCompContext *cc, bh_list *jmp_info_list,
+                       uint32 *label_offsets)
+{
+    JmpInfo *jmp_info;
+    uint64 value;
+
+    jmp_info = (JmpInfo *)bh_list_first_elem(jmp_info_list);
+
+    for (; jmp_info; jmp_info = (JmpInfo *)bh_list_elem_next(jmp_info)) {
+        if (jmp_info->type == JMP_DST_LABEL_ABS)
+            value = label_offsets[jmp_info->dst_info.label_dst];
+        else if (jmp_info->type == JMP_END_OF_CALLBC)
+            value = jmp_info->offset + sizeof(uintptr_t) + 7;
+        else if (jmp_info->type == JMP_LOOKUPSWITCH_BASE)
+            value = jmp_info->offset + 11;
+        else
+            continue;
+
+        if (!jit_cc_add_reloc(cc, jmp_info->offset, JIT_RELOC_CODE, value))
+            return false;
+    }
+    return true;
+}
+#endif
+
 /* Free the jmp info list */
 static void
 free_jmp_info_list(bh_list *jmp_info_list)
@@ -8325,6 +8408,11 @@ jit_codegen_gen_native(JitCompContext *cc)
         }
     }
 
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    if (!record_jmp_info_relocs(cc, jmp_info_list, label_offsets))
+        goto fail;
+#endif
+
     code_buf = (char *)code.sectionById(0)->buffer().data();
     code_size = code.sectionById(0)->buffer().size();
     if (!(stream = (char *)jit_code_cache_alloc(code_size))) {
@@ -8332,7 +8420,6 @@ jit_codegen_gen_native(JitCompContext *cc)
         goto fail;
     }
 
-    bh_memcpy_s(stream, code_size, code_buf, code_size);
     cc->jitted_addr_begin = stream;
     cc->jitted_addr_end = stream + code_size;
 
@@ -8349,7 +8436,11 @@ jit_codegen_gen_native(JitCompContext *cc)
         *jitted_addr = stream + label_offsets[label_index];
     }
 
-    patch_jmp_info_list(cc, jmp_info_list);
+    /* Patch the code and then copy it to the code cache, which isn't
+       writable at the address of the jitted code */
+    patch_jmp_info_list(cc, jmp_info_list, code_buf);
+    bh_memcpy_s(jit_code_cache_writable(stream), code_size, code_buf,
+                code_size);
     return_value = true;
 
 fail:
@@ -8672,7 +8763,8 @@ jit_codegen_compile_call_to_llvm_jit(const WASMType *func_type)
     if (!stream)
         return NULL;
 
-    bh_memcpy_s(stream, code_size, code_buf, code_size);
+    bh_memcpy_s(jit_code_cache_writable(stream), code_size, code_buf,
+                code_size);
 
 #if 0
     dump_native(stream, code_size);
@@ -9101,7 +9193,8 @@ jit_codegen_compile_call_to_fast_jit(const WASMModule *module, uint32 func_idx)
     if (!stream)
         return NULL;
 
-    bh_memcpy_s(stream, code_size, code_buf, code_size);
+    bh_memcpy_s(jit_code_cache_writable(stream), code_size, code_buf,
+                code_size);
 
 #if 0
     printf("Code of call to fast jit of func %u:\n", func_idx);
@@ -9191,7 +9284,8 @@ jit_codegen_init()
     if (!stream)
         return false;
 
-    bh_memcpy_s(stream, code_size, code_buf, code_size);
+    bh_memcpy_s(jit_code_cache_writable(stream), code_size, code_buf,
+                code_size);
     code_block_switch_to_jitted_from_interp = stream;
 
 #if 0
@@ -9238,7 +9332,8 @@ jit_codegen_init()
     if (!stream)
         goto fail1;
 
-    bh_memcpy_s(stream, code_size, code_buf, code_size);
+    bh_memcpy_s(jit_code_cache_writable(stream), code_size, code_buf,
+                code_size);
     code_block_return_to_interp_from_jitted =
         jit_globals->return_to_interp_from_jitted = stream;
 
@@ -9343,7 +9438,8 @@ jit_codegen_init()
     if (!stream)
         goto fail2;
 
-    bh_memcpy_s(stream, code_size, code_buf, code_size);
+    bh_memcpy_s(jit_code_cache_writable(stream), code_size, code_buf,
+                code_size);
     code_block_compile_fast_jit_and_then_call =
         jit_globals->compile_fast_jit_and_then_call = stream;
 
@@ -107,6 +107,19 @@ load_block_params(JitCompContext *cc, JitBlock *block)
                 value = gen_load_f64(jit_frame, offset);
                 offset += 2;
                 break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+            {
+                uint32 n;
+
+                /* The v128 value is already in the frame */
+                PUSH_V128(n);
+                bh_assert(n == offset);
+                (void)n;
+                offset += 4;
+                continue;
+            }
+#endif
             default:
                 bh_assert(0);
                 break;
@@ -153,6 +166,19 @@ load_block_results(JitCompContext *cc, JitBlock *block)
                 value = gen_load_f64(jit_frame, offset);
                 offset += 2;
                 break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+            {
+                uint32 n;
+
+                /* The v128 value is already in the frame */
+                PUSH_V128(n);
+                bh_assert(n == offset);
+                (void)n;
+                offset += 4;
+                continue;
+            }
+#endif
             default:
                 bh_assert(0);
                 break;
@@ -374,6 +400,17 @@ copy_block_arities(JitCompContext *cc, JitReg dst_frame_sp, uint8 *dst_types,
                 offset_src += 2;
                 offset_dst += 2;
                 break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                /* The v128 value is copied through memory, and a first
+                   result of the function is returned in the frame of
+                   the caller instead of a register */
+                gen_copy_v128(jit_frame, dst_frame_sp, offset_dst * 4,
+                              cc->fp_reg, offset_of_local(offset_src));
+                offset_src += 4;
+                offset_dst += 4;
+                break;
+#endif
             default:
                 bh_assert(0);
                 break;
@@ -799,11 +836,24 @@ jit_compile_op_block(JitCompContext *cc, uint8 **p_frame_ip,
         CREATE_BASIC_BLOCK(block->basic_block_entry);
         SET_BB_END_BCIP(cc->cur_basic_block, *p_frame_ip - 1);
         SET_BB_BEGIN_BCIP(block->basic_block_entry, *p_frame_ip);
+#if WASM_ENABLE_FAST_JIT_OSR != 0
+        /* All the values are in the frame when the loop body begins, the
+           interpreter can jump to it with its frame */
+        if (!jit_cc_add_osr_entry(
+                cc, *p_frame_ip,
+                jit_basic_block_label(block->basic_block_entry)))
+            goto fail;
+#endif
         /* Push the new jit block to block stack and continue to
            translate the new basic block */
         if (!push_jit_block_to_stack_and_pass_params(
                 cc, block, block->basic_block_entry, 0, false))
             goto fail;
+#if WASM_ENABLE_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
+        /* Count the loop iterations for the llvm jit tier-up */
+        if (!jit_emit_llvm_jit_hotness_count(cc))
+            goto fail;
+#endif
     }
     else if (label_type == LABEL_TYPE_IF) {
         POP_I32(value);
@@ -940,6 +990,61 @@ jit_check_suspend_flags(JitCompContext *cc)
 
 #endif
 
+#if WASM_ENABLE_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
+bool
+jit_emit_llvm_jit_hotness_count(JitCompContext *cc)
+{
+    WASMFunction *func = cc->cur_wasm_func;
+    JitFrame *jit_frame = cc->jit_frame;
+    JitBasicBlock *hot_block, *next_block;
+    JitReg hotness_addr = jit_cc_new_reg_ptr(cc);
+    JitReg hotness = jit_cc_new_reg_I32(cc);
+    JitReg increment = jit_cc_new_reg_I32(cc);
+    JitReg module;
+
+    /* func->llvm_jit_hotness++ unless it is UINT32_MAX, the increments may
+       be lost when several threads run the function, which is fine for a
+       hotness estimate */
+    GEN_INSN(MOV, hotness_addr,
+             NEW_CONST(PTR, (uintptr_t)&func->llvm_jit_hotness));
+    GEN_INSN(LDI32, hotness, hotness_addr, NEW_CONST(I32, 0));
+    GEN_INSN(CMP, cc->cmp_reg, hotness, NEW_CONST(I32, -1));
+    GEN_INSN(SELECTNE, increment, cc->cmp_reg, NEW_CONST(I32, 1),
+             NEW_CONST(I32, 0));
+    GEN_INSN(ADD, hotness, hotness, increment);
+    GEN_INSN(STI32, hotness, hotness_addr, NEW_CONST(I32, 0));
+
+    hot_block = jit_cc_new_basic_block(cc, 0);
+    next_block = jit_cc_new_basic_block(cc, 0);
+    if (!hot_block || !next_block) {
+        jit_set_last_error(cc, "create basic block failed");
+        return false;
+    }
+
+    /* Commit register values to locals and stacks */
+    gen_commit_values(jit_frame, jit_frame->lp, jit_frame->sp);
+    /* Clear frame values */
+    clear_values(jit_frame);
+
+    /* Wake up the backend threads when the function just got hot, the
+       counter goes up by one at a time so it can't skip the threshold */
+    GEN_INSN(CMP, cc->cmp_reg, hotness,
+             NEW_CONST(I32, LLVM_JIT_TIERUP_THRESHOLD));
+    GEN_INSN(BEQ, cc->cmp_reg, jit_basic_block_label(hot_block),
+             jit_basic_block_label(next_block));
+
+    cc->cur_basic_block = hot_block;
+    module = NEW_CONST(PTR, (uintptr_t)cc->cur_wasm_module);
+    if (!jit_emit_callnative(cc, jit_compiler_notify_llvm_jit_hot_func, 0,
+                             &module, 1))
+        return false;
+    GEN_INSN(JMP, jit_basic_block_label(next_block));
+
+    cc->cur_basic_block = next_block;
+    return true;
+}
+#endif
+
 static bool
 handle_op_br(JitCompContext *cc, uint32 br_depth, uint8 **p_frame_ip)
 {
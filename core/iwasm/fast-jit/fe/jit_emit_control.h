@@ -49,6 +49,11 @@ bool
 jit_check_suspend_flags(JitCompContext *cc);
 #endif
 
+#if WASM_ENABLE_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
+bool
+jit_emit_llvm_jit_hotness_count(JitCompContext *cc);
+#endif
+
 #ifdef __cplusplus
 } /* end of extern "C" */
 #endif
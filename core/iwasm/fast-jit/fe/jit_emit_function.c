@@ -51,6 +51,18 @@ pre_call(JitCompContext *cc, const WASMType *func_type)
                 outs_off -= 8;
                 GEN_INSN(STF64, value, cc->fp_reg, NEW_CONST(I32, outs_off));
                 break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+            {
+                uint32 n;
+
+                POP_V128(n);
+                outs_off -= 16;
+                gen_copy_v128(cc->jit_frame, cc->fp_reg, outs_off, cc->fp_reg,
+                              offset_of_local(n));
+                break;
+            }
+#endif
             default:
                 bh_assert(0);
                 goto fail;
@@ -132,6 +144,20 @@ post_return(JitCompContext *cc, const WASMType *func_type, JitReg first_res,
                 PUSH_F64(value);
                 n += 2;
                 break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+            {
+                uint32 n1;
+
+                /* The callee has stored the v128 result to the frame */
+                bh_assert(!(i == 0 && first_res));
+                PUSH_V128(n1);
+                bh_assert(n1 == n);
+                (void)n1;
+                n += 4;
+                break;
+            }
+#endif
             default:
                 bh_assert(0);
                 goto fail;
@@ -206,6 +232,11 @@ create_first_res_reg(JitCompContext *cc, const WASMType *func_type)
                 return jit_cc_new_reg_F32(cc);
             case VALUE_TYPE_F64:
                 return jit_cc_new_reg_F64(cc);
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                /* The v128 result is returned in the frame */
+                return 0;
+#endif
             default:
                 bh_assert(0);
                 return 0;
@@ -666,6 +697,12 @@ jit_compile_op_call_indirect(JitCompContext *cc, uint32 type_idx,
                 GEN_INSN(STF64, res, cc->fp_reg,
                          NEW_CONST(I32, offset_of_local(n)));
                 break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                gen_copy_v128(jit_frame, cc->fp_reg, offset_of_local(n), argv,
+                              0);
+                break;
+#endif
             default:
                 bh_assert(0);
                 goto fail;
@@ -720,6 +757,11 @@ jit_compile_op_call_indirect(JitCompContext *cc, uint32 type_idx,
             case VALUE_TYPE_F64:
                 res = jit_cc_new_reg_F64(cc);
                 break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                /* The v128 result is returned in the frame */
+                break;
+#endif
             default:
                 bh_assert(0);
                 goto fail;
@@ -751,6 +793,10 @@ jit_compile_op_call_indirect(JitCompContext *cc, uint32 type_idx,
                 GEN_INSN(STF64, res, cc->fp_reg,
                          NEW_CONST(I32, offset_of_local(n)));
                 break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                break;
+#endif
             default:
                 bh_assert(0);
                 goto fail;
@@ -10,6 +10,10 @@
 #include "../jit_codegen.h"
 #include "../../interpreter/wasm_runtime.h"
 #include "jit_emit_control.h"
+#if WASM_ENABLE_SIMD != 0
+#include "../../interpreter/wasm_opcode.h"
+#include "../../interpreter/wasm_simd.h"
+#endif
 
 #ifndef OS_ENABLE_HW_BOUND_CHECK
 static JitReg
@@ -577,6 +581,168 @@ fail:
     return false;
 }
 
+#if WASM_ENABLE_SIMD != 0
+/* Copy a lane of 1, 2, 4 or 8 bytes between memory addresses */
+static void
+copy_lane(JitCompContext *cc, JitReg dst_base, uint32 dst_offset,
+          JitReg src_base, uint32 src_offset, uint32 bytes)
+{
+    JitReg value;
+
+    if (bytes == 8) {
+        value = jit_cc_new_reg_I64(cc);
+        GEN_INSN(LDI64, value, src_base, NEW_CONST(I32, src_offset));
+        GEN_INSN(STI64, value, dst_base, NEW_CONST(I32, dst_offset));
+        return;
+    }
+
+    value = jit_cc_new_reg_I32(cc);
+    switch (bytes) {
+        case 1:
+            GEN_INSN(LDU8, value, src_base, NEW_CONST(I32, src_offset));
+            GEN_INSN(STI8, value, dst_base, NEW_CONST(I32, dst_offset));
+            break;
+        case 2:
+            GEN_INSN(LDU16, value, src_base, NEW_CONST(I32, src_offset));
+            GEN_INSN(STI16, value, dst_base, NEW_CONST(I32, dst_offset));
+            break;
+        case 4:
+            GEN_INSN(LDI32, value, src_base, NEW_CONST(I32, src_offset));
+            GEN_INSN(STI32, value, dst_base, NEW_CONST(I32, dst_offset));
+            break;
+        default:
+            bh_assert(0);
+            break;
+    }
+}
+
+static JitReg
+get_v128_maddr(JitCompContext *cc, JitReg addr, uint32 offset, uint32 bytes)
+{
+    JitReg offset1, memory_data, maddr;
+
+    offset1 = check_and_seek(cc, addr, offset, bytes);
+    if (!offset1)
+        return 0;
+
+    memory_data = get_memory_data_reg(cc->jit_frame, 0);
+
+    /* maddr = memory_data + offset1 */
+    maddr = jit_cc_new_reg_ptr(cc);
+    GEN_INSN(ADD, maddr, memory_data, offset1);
+    return maddr;
+}
+
+bool
+jit_compile_op_v128_load(JitCompContext *cc, uint8 opcode, uint32 align,
+                         uint32 offset)
+{
+    JitReg addr, maddr, args[3];
+    uint32 n;
+
+    POP_I32(addr);
+
+    maddr = get_v128_maddr(cc, addr, offset,
+                           wasm_simd_mem_access_size(opcode));
+    if (!maddr)
+        goto fail;
+
+    PUSH_V128(n);
+
+    if (opcode == SIMD_v128_load) {
+        gen_copy_v128(cc->jit_frame, cc->fp_reg, offset_of_local(n), maddr,
+                      0);
+    }
+    else {
+        /* Extend, splat or zero the loaded bytes into the slot */
+        args[0] = NEW_CONST(I32, opcode);
+        args[1] = maddr;
+        args[2] = jit_cc_new_reg_ptr(cc);
+        GEN_INSN(ADD, args[2], cc->fp_reg,
+                 NEW_CONST(PTR, offset_of_local(n)));
+        if (!jit_emit_callnative(cc, wasm_simd_load, 0, args, 3))
+            goto fail;
+    }
+
+    (void)align;
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_op_v128_store(JitCompContext *cc, uint32 align, uint32 offset)
+{
+    JitReg addr, maddr;
+    uint32 n;
+
+    POP_V128(n);
+    POP_I32(addr);
+
+    maddr = get_v128_maddr(cc, addr, offset, 16);
+    if (!maddr)
+        goto fail;
+
+    gen_copy_v128(cc->jit_frame, maddr, 0, cc->fp_reg, offset_of_local(n));
+
+    (void)align;
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_op_v128_load_lane(JitCompContext *cc, uint8 opcode, uint32 align,
+                              uint32 offset, uint8 lane)
+{
+    JitReg addr, maddr;
+    uint32 bytes = wasm_simd_mem_access_size(opcode), n, n1;
+
+    POP_V128(n);
+    POP_I32(addr);
+
+    maddr = get_v128_maddr(cc, addr, offset, bytes);
+    if (!maddr)
+        goto fail;
+
+    /* Move the vector down to the slot of addr, and then replace
+       the lane with the loaded bytes */
+    PUSH_V128(n1);
+    gen_copy_v128(cc->jit_frame, cc->fp_reg, offset_of_local(n1), cc->fp_reg,
+                  offset_of_local(n));
+    copy_lane(cc, cc->fp_reg, offset_of_local(n1) + lane * bytes, maddr, 0,
+              bytes);
+
+    (void)align;
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_op_v128_store_lane(JitCompContext *cc, uint8 opcode, uint32 align,
+                               uint32 offset, uint8 lane)
+{
+    JitReg addr, maddr;
+    uint32 bytes = wasm_simd_mem_access_size(opcode), n;
+
+    POP_V128(n);
+    POP_I32(addr);
+
+    maddr = get_v128_maddr(cc, addr, offset, bytes);
+    if (!maddr)
+        goto fail;
+
+    copy_lane(cc, maddr, 0, cc->fp_reg, offset_of_local(n) + lane * bytes,
+              bytes);
+
+    (void)align;
+    return true;
+fail:
+    return false;
+}
+#endif /* end of WASM_ENABLE_SIMD != 0 */
+
 bool
 jit_compile_op_memory_size(JitCompContext *cc, uint32 mem_idx)
 {
@@ -43,6 +43,23 @@ jit_compile_op_f32_store(JitCompContext *cc, uint32 align, uint32 offset);
 bool
 jit_compile_op_f64_store(JitCompContext *cc, uint32 align, uint32 offset);
 
+#if WASM_ENABLE_SIMD != 0
+bool
+jit_compile_op_v128_load(JitCompContext *cc, uint8 opcode, uint32 align,
+                         uint32 offset);
+
+bool
+jit_compile_op_v128_store(JitCompContext *cc, uint32 align, uint32 offset);
+
+bool
+jit_compile_op_v128_load_lane(JitCompContext *cc, uint8 opcode, uint32 align,
+                              uint32 offset, uint8 lane);
+
+bool
+jit_compile_op_v128_store_lane(JitCompContext *cc, uint8 opcode, uint32 align,
+                               uint32 offset, uint8 lane);
+#endif
+
 bool
 jit_compile_op_memory_size(JitCompContext *cc, uint32 mem_idx);
 
@@ -66,6 +66,13 @@ pop_value_from_wasm_stack(JitCompContext *cc, bool is_32bit, JitReg *p_value,
         case VALUE_TYPE_F64:
             value = pop_f64(cc->jit_frame);
             break;
+#if WASM_ENABLE_SIMD != 0
+        case VALUE_TYPE_V128:
+            /* The v128 value lives in the frame */
+            pop_v128(cc->jit_frame);
+            value = 0;
+            break;
+#endif
         default:
             bh_assert(0);
             return false;
@@ -103,6 +110,30 @@ jit_compile_op_select(JitCompContext *cc, bool is_select_32)
         return false;
     }
 
+#if WASM_ENABLE_SIMD != 0
+    if (val1_type == VALUE_TYPE_V128) {
+        /* val1 is in slot n and val2 in slot n + 4, select the 64-bit
+           halves of them into the slot of val1 */
+        uint32 n = (uint32)(cc->jit_frame->sp - cc->jit_frame->lp), i;
+
+        for (i = 0; i < 2; i++) {
+            val1 = jit_cc_new_reg_I64(cc);
+            val2 = jit_cc_new_reg_I64(cc);
+            selected = jit_cc_new_reg_I64(cc);
+            GEN_INSN(LDI64, val1, cc->fp_reg,
+                     NEW_CONST(I32, offset_of_local(n + i * 2)));
+            GEN_INSN(LDI64, val2, cc->fp_reg,
+                     NEW_CONST(I32, offset_of_local(n + 4 + i * 2)));
+            GEN_INSN(CMP, cc->cmp_reg, cond, NEW_CONST(I32, 0));
+            GEN_INSN(SELECTNE, selected, cc->cmp_reg, val1, val2);
+            GEN_INSN(STI64, selected, cc->fp_reg,
+                     NEW_CONST(I32, offset_of_local(n + i * 2)));
+        }
+        PUSH_V128(n);
+        return true;
+    }
+#endif
+
     switch (val1_type) {
         case VALUE_TYPE_I32:
             selected = jit_cc_new_reg_I32(cc);
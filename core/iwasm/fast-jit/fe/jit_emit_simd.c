@@ -0,0 +1,450 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "jit_emit_simd.h"
+#include "jit_emit_function.h"
+#include "../jit_frontend.h"
+#include "../../interpreter/wasm_opcode.h"
+#include "../../interpreter/wasm_simd.h"
+
+#if WASM_ENABLE_SIMD != 0
+
+/*
+ * The v128 values live in their slots of the frame (see push_v128), the
+ * bitwise operations and the lane accesses are generated as the 64-bit
+ * and lane-sized loads and stores of the slots, the other operations call
+ * the lane-wise helpers shared with the interpreters with the addresses
+ * of the slots.
+ *
+ * No V128 registers (jit_cc_new_reg_V128) are allocated yet, so none of
+ * the operations is lowered to XMM/NEON instructions by the backends.
+ * Doing so needs the V128 register kind to be handled in the register
+ * allocator and the codegen, which is left for later work.
+ */
+
+/* Get the address of the n-th slot of the frame */
+static JitReg
+get_slot_addr(JitCompContext *cc, uint32 n)
+{
+    JitReg addr = jit_cc_new_reg_ptr(cc);
+
+    GEN_INSN(ADD, addr, cc->fp_reg, NEW_CONST(PTR, offset_of_local(n)));
+    return addr;
+}
+
+static uint32
+get_lane_size(uint8 opcode)
+{
+    switch (opcode) {
+        case SIMD_i8x16_splat:
+        case SIMD_i8x16_extract_lane_s:
+        case SIMD_i8x16_extract_lane_u:
+        case SIMD_i8x16_replace_lane:
+            return 1;
+        case SIMD_i16x8_splat:
+        case SIMD_i16x8_extract_lane_s:
+        case SIMD_i16x8_extract_lane_u:
+        case SIMD_i16x8_replace_lane:
+            return 2;
+        case SIMD_i64x2_splat:
+        case SIMD_f64x2_splat:
+        case SIMD_i64x2_extract_lane:
+        case SIMD_f64x2_extract_lane:
+        case SIMD_i64x2_replace_lane:
+        case SIMD_f64x2_replace_lane:
+            return 8;
+        default:
+            return 4;
+    }
+}
+
+static bool
+is_f32_lane_op(uint8 opcode)
+{
+    return opcode == SIMD_f32x4_splat || opcode == SIMD_f32x4_extract_lane
+                   || opcode == SIMD_f32x4_replace_lane
+               ? true
+               : false;
+}
+
+static bool
+is_f64_lane_op(uint8 opcode)
+{
+    return opcode == SIMD_f64x2_splat || opcode == SIMD_f64x2_extract_lane
+                   || opcode == SIMD_f64x2_replace_lane
+               ? true
+               : false;
+}
+
+/* Pop the scalar operand of splat and replace_lane */
+static JitReg
+pop_lane_value(JitCompContext *cc, uint8 opcode)
+{
+    JitReg value = 0;
+
+    if (is_f32_lane_op(opcode))
+        POP_F32(value);
+    else if (is_f64_lane_op(opcode))
+        POP_F64(value);
+    else if (get_lane_size(opcode) == 8)
+        POP_I64(value);
+    else
+        POP_I32(value);
+
+    return value;
+fail:
+    return 0;
+}
+
+/* Store a lane of the v128 value at the offset to the frame pointer */
+static void
+store_lane(JitCompContext *cc, uint8 opcode, JitReg value, uint32 offset)
+{
+    JitReg offset_reg = NEW_CONST(I32, offset);
+
+    if (is_f32_lane_op(opcode)) {
+        GEN_INSN(STF32, value, cc->fp_reg, offset_reg);
+        return;
+    }
+    if (is_f64_lane_op(opcode)) {
+        GEN_INSN(STF64, value, cc->fp_reg, offset_reg);
+        return;
+    }
+
+    switch (get_lane_size(opcode)) {
+        case 1:
+            GEN_INSN(STI8, value, cc->fp_reg, offset_reg);
+            break;
+        case 2:
+            GEN_INSN(STI16, value, cc->fp_reg, offset_reg);
+            break;
+        case 4:
+            GEN_INSN(STI32, value, cc->fp_reg, offset_reg);
+            break;
+        default:
+            GEN_INSN(STI64, value, cc->fp_reg, offset_reg);
+            break;
+    }
+}
+
+bool
+jit_compile_op_v128_const(JitCompContext *cc, const uint8 *imm)
+{
+    uint64 lo, hi;
+    uint32 n;
+
+    bh_memcpy_s(&lo, sizeof(uint64), imm, sizeof(uint64));
+    bh_memcpy_s(&hi, sizeof(uint64), imm + 8, sizeof(uint64));
+
+    PUSH_V128(n);
+    GEN_INSN(STI64, NEW_CONST(I64, lo), cc->fp_reg,
+             NEW_CONST(I32, offset_of_local(n)));
+    GEN_INSN(STI64, NEW_CONST(I64, hi), cc->fp_reg,
+             NEW_CONST(I32, offset_of_local(n) + 8));
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_op_i8x16_shuffle(JitCompContext *cc, const uint8 *lanes)
+{
+    JitReg bytes[16];
+    uint32 n1, n2, i;
+
+    /* v2 is right after v1 in the frame, so the lane indexes are the
+       byte offsets to v1 */
+    POP_V128(n2);
+    POP_V128(n1);
+    bh_assert(n2 == n1 + 4);
+    (void)n2;
+
+    /* Load all the bytes before storing them, as the result overwrites
+       v1 */
+    for (i = 0; i < 16; i++) {
+        bytes[i] = jit_cc_new_reg_I32(cc);
+        GEN_INSN(LDU8, bytes[i], cc->fp_reg,
+                 NEW_CONST(I32, offset_of_local(n1) + (lanes[i] & 31)));
+    }
+    for (i = 0; i < 16; i++) {
+        GEN_INSN(STI8, bytes[i], cc->fp_reg,
+                 NEW_CONST(I32, offset_of_local(n1) + i));
+    }
+
+    PUSH_V128(n1);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_op_simd_splat(JitCompContext *cc, uint8 opcode)
+{
+    JitReg value, args[3];
+    uint32 lane_size = get_lane_size(opcode), n, i;
+
+    if (!(value = pop_lane_value(cc, opcode)))
+        return false;
+
+    PUSH_V128(n);
+
+    if (lane_size >= 4) {
+        for (i = 0; i < 16 / lane_size; i++)
+            store_lane(cc, opcode, value, offset_of_local(n) + i * lane_size);
+    }
+    else {
+        /* Store the scalar to the slot and splat it in place */
+        store_lane(cc, SIMD_i32x4_splat, value, offset_of_local(n));
+        args[0] = NEW_CONST(I32, opcode);
+        args[1] = get_slot_addr(cc, n);
+        args[2] = args[1];
+        if (!jit_emit_callnative(cc, wasm_simd_splat, 0, args, 3))
+            goto fail;
+    }
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_op_simd_extract_lane(JitCompContext *cc, uint8 opcode, uint8 lane)
+{
+    JitReg value, offset;
+    uint32 n;
+
+    POP_V128(n);
+    offset = NEW_CONST(I32, offset_of_local(n) + lane * get_lane_size(opcode));
+
+    switch (opcode) {
+        case SIMD_i8x16_extract_lane_s:
+            value = jit_cc_new_reg_I32(cc);
+            GEN_INSN(LDI8, value, cc->fp_reg, offset);
+            PUSH_I32(value);
+            break;
+        case SIMD_i8x16_extract_lane_u:
+            value = jit_cc_new_reg_I32(cc);
+            GEN_INSN(LDU8, value, cc->fp_reg, offset);
+            PUSH_I32(value);
+            break;
+        case SIMD_i16x8_extract_lane_s:
+            value = jit_cc_new_reg_I32(cc);
+            GEN_INSN(LDI16, value, cc->fp_reg, offset);
+            PUSH_I32(value);
+            break;
+        case SIMD_i16x8_extract_lane_u:
+            value = jit_cc_new_reg_I32(cc);
+            GEN_INSN(LDU16, value, cc->fp_reg, offset);
+            PUSH_I32(value);
+            break;
+        case SIMD_i32x4_extract_lane:
+            value = jit_cc_new_reg_I32(cc);
+            GEN_INSN(LDI32, value, cc->fp_reg, offset);
+            PUSH_I32(value);
+            break;
+        case SIMD_f32x4_extract_lane:
+            value = jit_cc_new_reg_F32(cc);
+            GEN_INSN(LDF32, value, cc->fp_reg, offset);
+            PUSH_F32(value);
+            break;
+        case SIMD_i64x2_extract_lane:
+            value = jit_cc_new_reg_I64(cc);
+            GEN_INSN(LDI64, value, cc->fp_reg, offset);
+            PUSH_I64(value);
+            break;
+        case SIMD_f64x2_extract_lane:
+            value = jit_cc_new_reg_F64(cc);
+            GEN_INSN(LDF64, value, cc->fp_reg, offset);
+            PUSH_F64(value);
+            break;
+        default:
+            bh_assert(0);
+            goto fail;
+    }
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_op_simd_replace_lane(JitCompContext *cc, uint8 opcode, uint8 lane)
+{
+    JitReg value;
+    uint32 lane_size = get_lane_size(opcode), n;
+
+    if (!(value = pop_lane_value(cc, opcode)))
+        return false;
+
+    POP_V128(n);
+    store_lane(cc, opcode, value, offset_of_local(n) + lane * lane_size);
+    PUSH_V128(n);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_op_v128_bitselect(JitCompContext *cc)
+{
+    JitReg v1, v2, c, res;
+    uint32 n1, n2, n3, i, offset;
+
+    POP_V128(n3);
+    POP_V128(n2);
+    POP_V128(n1);
+
+    /* res = v2 ^ ((v1 ^ v2) & c) for each 64-bit half */
+    for (i = 0; i < 2; i++) {
+        offset = i * 8;
+        v1 = jit_cc_new_reg_I64(cc);
+        v2 = jit_cc_new_reg_I64(cc);
+        c = jit_cc_new_reg_I64(cc);
+        res = jit_cc_new_reg_I64(cc);
+        GEN_INSN(LDI64, v1, cc->fp_reg,
+                 NEW_CONST(I32, offset_of_local(n1) + offset));
+        GEN_INSN(LDI64, v2, cc->fp_reg,
+                 NEW_CONST(I32, offset_of_local(n2) + offset));
+        GEN_INSN(LDI64, c, cc->fp_reg,
+                 NEW_CONST(I32, offset_of_local(n3) + offset));
+        GEN_INSN(XOR, res, v1, v2);
+        GEN_INSN(AND, res, res, c);
+        GEN_INSN(XOR, res, res, v2);
+        GEN_INSN(STI64, res, cc->fp_reg,
+                 NEW_CONST(I32, offset_of_local(n1) + offset));
+    }
+
+    PUSH_V128(n1);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_op_simd_shift(JitCompContext *cc, uint8 opcode)
+{
+    JitReg count, args[4];
+    uint32 n;
+
+    POP_I32(count);
+    POP_V128(n);
+
+    args[0] = NEW_CONST(I32, opcode);
+    args[1] = get_slot_addr(cc, n);
+    args[2] = count;
+    args[3] = args[1];
+    if (!jit_emit_callnative(cc, wasm_simd_shift, 0, args, 4))
+        goto fail;
+
+    PUSH_V128(n);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_op_simd_reduce(JitCompContext *cc, uint8 opcode)
+{
+    JitReg res, args[2];
+    uint32 n;
+
+    POP_V128(n);
+
+    res = jit_cc_new_reg_I32(cc);
+    args[0] = NEW_CONST(I32, opcode);
+    args[1] = get_slot_addr(cc, n);
+    if (!jit_emit_callnative(cc, wasm_simd_reduce, res, args, 2))
+        goto fail;
+
+    PUSH_I32(res);
+    return true;
+fail:
+    return false;
+}
+
+static bool
+compile_op_v128_bitwise(JitCompContext *cc, uint8 opcode)
+{
+    JitReg v1, v2 = 0, res;
+    uint32 n1, n2 = 0, i, offset;
+
+    if (opcode != SIMD_v128_not)
+        POP_V128(n2);
+    POP_V128(n1);
+
+    for (i = 0; i < 2; i++) {
+        offset = i * 8;
+        v1 = jit_cc_new_reg_I64(cc);
+        res = jit_cc_new_reg_I64(cc);
+        GEN_INSN(LDI64, v1, cc->fp_reg,
+                 NEW_CONST(I32, offset_of_local(n1) + offset));
+        if (opcode != SIMD_v128_not) {
+            v2 = jit_cc_new_reg_I64(cc);
+            GEN_INSN(LDI64, v2, cc->fp_reg,
+                     NEW_CONST(I32, offset_of_local(n2) + offset));
+        }
+
+        switch (opcode) {
+            case SIMD_v128_not:
+                GEN_INSN(XOR, res, v1, NEW_CONST(I64, -1));
+                break;
+            case SIMD_v128_and:
+                GEN_INSN(AND, res, v1, v2);
+                break;
+            case SIMD_v128_andnot:
+                GEN_INSN(XOR, v2, v2, NEW_CONST(I64, -1));
+                GEN_INSN(AND, res, v1, v2);
+                break;
+            case SIMD_v128_or:
+                GEN_INSN(OR, res, v1, v2);
+                break;
+            default:
+                GEN_INSN(XOR, res, v1, v2);
+                break;
+        }
+
+        GEN_INSN(STI64, res, cc->fp_reg,
+                 NEW_CONST(I32, offset_of_local(n1) + offset));
+    }
+
+    PUSH_V128(n1);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_op_simd_lane_op(JitCompContext *cc, uint8 opcode)
+{
+    JitReg args[4];
+    uint32 n1, n2;
+
+    if (opcode >= SIMD_v128_not && opcode <= SIMD_v128_xor)
+        return compile_op_v128_bitwise(cc, opcode);
+
+    args[0] = NEW_CONST(I32, opcode);
+
+    if (wasm_simd_is_unary_op(opcode)) {
+        POP_V128(n1);
+        args[1] = get_slot_addr(cc, n1);
+        args[2] = args[1];
+        if (!jit_emit_callnative(cc, wasm_simd_unary_op, 0, args, 3))
+            goto fail;
+    }
+    else {
+        POP_V128(n2);
+        POP_V128(n1);
+        args[1] = get_slot_addr(cc, n1);
+        args[2] = get_slot_addr(cc, n2);
+        args[3] = args[1];
+        if (!jit_emit_callnative(cc, wasm_simd_binary_op, 0, args, 4))
+            goto fail;
+    }
+
+    PUSH_V128(n1);
+    return true;
+fail:
+    return false;
+}
+
+#endif /* end of WASM_ENABLE_SIMD != 0 */
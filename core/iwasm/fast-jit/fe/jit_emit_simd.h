@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _JIT_EMIT_SIMD_H_
+#define _JIT_EMIT_SIMD_H_
+
+#include "../jit_compiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if WASM_ENABLE_SIMD != 0
+bool
+jit_compile_op_v128_const(JitCompContext *cc, const uint8 *imm);
+
+bool
+jit_compile_op_i8x16_shuffle(JitCompContext *cc, const uint8 *lanes);
+
+bool
+jit_compile_op_simd_splat(JitCompContext *cc, uint8 opcode);
+
+bool
+jit_compile_op_simd_extract_lane(JitCompContext *cc, uint8 opcode, uint8 lane);
+
+bool
+jit_compile_op_simd_replace_lane(JitCompContext *cc, uint8 opcode, uint8 lane);
+
+bool
+jit_compile_op_v128_bitselect(JitCompContext *cc);
+
+bool
+jit_compile_op_simd_shift(JitCompContext *cc, uint8 opcode);
+
+bool
+jit_compile_op_simd_reduce(JitCompContext *cc, uint8 opcode);
+
+bool
+jit_compile_op_simd_lane_op(JitCompContext *cc, uint8 opcode);
+#endif
+
+#ifdef __cplusplus
+} /* end of extern "C" */
+#endif
+
+#endif /* end of _JIT_EMIT_SIMD_H_ */
@@ -57,6 +57,17 @@ jit_compile_op_get_local(JitCompContext *cc, uint32 local_idx)
         case VALUE_TYPE_F64:
             value = local_f64(cc->jit_frame, local_offset);
             break;
+#if WASM_ENABLE_SIMD != 0
+        case VALUE_TYPE_V128:
+        {
+            uint32 n;
+
+            PUSH_V128(n);
+            gen_copy_v128(cc->jit_frame, cc->fp_reg, offset_of_local(n),
+                          cc->fp_reg, offset_of_local(local_offset));
+            return true;
+        }
+#endif
         default:
             bh_assert(0);
             break;
@@ -103,6 +114,19 @@ jit_compile_op_set_local(JitCompContext *cc, uint32 local_idx)
             POP_F64(value);
             set_local_f64(cc->jit_frame, local_offset, value);
             break;
+#if WASM_ENABLE_SIMD != 0
+        case VALUE_TYPE_V128:
+        {
+            uint32 n;
+
+            POP_V128(n);
+            gen_copy_v128(cc->jit_frame, cc->fp_reg,
+                          offset_of_local(local_offset), cc->fp_reg,
+                          offset_of_local(n));
+            set_local_v128(cc->jit_frame, local_offset);
+            break;
+        }
+#endif
         default:
             bh_assert(0);
             break;
@@ -152,6 +176,20 @@ jit_compile_op_tee_local(JitCompContext *cc, uint32 local_idx)
             set_local_f64(cc->jit_frame, local_offset, value);
             PUSH_F64(value);
             break;
+#if WASM_ENABLE_SIMD != 0
+        case VALUE_TYPE_V128:
+        {
+            uint32 n;
+
+            POP_V128(n);
+            gen_copy_v128(cc->jit_frame, cc->fp_reg,
+                          offset_of_local(local_offset), cc->fp_reg,
+                          offset_of_local(n));
+            set_local_v128(cc->jit_frame, local_offset);
+            PUSH_V128(n);
+            break;
+        }
+#endif
         default:
             bh_assert(0);
             goto fail;
@@ -224,6 +262,17 @@ jit_compile_op_get_global(JitCompContext *cc, uint32 global_idx)
                      NEW_CONST(I32, data_offset));
             break;
         }
+#if WASM_ENABLE_SIMD != 0
+        case VALUE_TYPE_V128:
+        {
+            uint32 n;
+
+            PUSH_V128(n);
+            gen_copy_v128(cc->jit_frame, cc->fp_reg, offset_of_local(n),
+                          get_module_inst_reg(cc->jit_frame), data_offset);
+            return true;
+        }
+#endif
         default:
         {
             jit_set_last_error(cc, "unexpected global type");
@@ -299,6 +348,17 @@ jit_compile_op_set_global(JitCompContext *cc, uint32 global_idx,
                      NEW_CONST(I32, data_offset));
             break;
         }
+#if WASM_ENABLE_SIMD != 0
+        case VALUE_TYPE_V128:
+        {
+            uint32 n;
+
+            POP_V128(n);
+            gen_copy_v128(cc->jit_frame, get_module_inst_reg(cc->jit_frame),
+                          data_offset, cc->fp_reg, offset_of_local(n));
+            break;
+        }
+#endif
         default:
         {
             jit_set_last_error(cc, "unexpected global type");
@@ -7,6 +7,25 @@ add_definitions(-DWASM_ENABLE_FAST_JIT=1)
 if (WAMR_BUILD_FAST_JIT_DUMP EQUAL 1)
     add_definitions(-DWASM_ENABLE_FAST_JIT_DUMP=1)
 endif ()
+if (WAMR_BUILD_FAST_JIT_PERSISTENT_CACHE EQUAL 1)
+    if (NOT WAMR_BUILD_PLATFORM STREQUAL "linux")
+        message (WARNING "Fast JIT persistent code cache is only supported on linux")
+    elseif (WAMR_BUILD_JIT EQUAL 1)
+        message (WARNING "Fast JIT persistent code cache isn't supported with multi-tier JIT")
+    else ()
+        add_definitions(-DWASM_ENABLE_FAST_JIT_PERSISTENT_CACHE=1)
+        message ("     Fast JIT persistent code cache enabled (experimental, untested)")
+    endif ()
+endif ()
+
+if (WAMR_BUILD_FAST_JIT_OSR EQUAL 1)
+    if (WAMR_BUILD_DEBUG_INTERP EQUAL 1)
+        message (WARNING "Fast JIT tier-up isn't supported with the source debugging")
+    else ()
+        add_definitions(-DWASM_ENABLE_FAST_JIT_OSR=1)
+        message ("     Fast JIT tier-up from the interpreter enabled (experimental, untested)")
+    endif ()
+endif ()
 
 include_directories (${IWASM_FAST_JIT_DIR})
 
@@ -6,51 +6,234 @@
 #include "jit_codecache.h"
 #include "mem_alloc.h"
 #include "jit_compiler.h"
+#include "jit_persistent_cache.h"
+#include "jit_utils.h"
 
-static void *code_cache_pool = NULL;
-static uint32 code_cache_pool_size = 0;
-static mem_allocator_t code_cache_pool_allocator = NULL;
+/* Chunk sizes are rounded up to it, which is a multiple of page sizes */
+#define CODE_CACHE_CHUNK_ALIGN (64 * 1024)
+
+/**
+ * The code cache grows with chunks. When the platform supports it, each
+ * chunk is mapped twice: the code is written in the read-write view and
+ * executed in the read-execute view, so that no page is writable and
+ * executable at the same time. A chunk is returned to the system once
+ * all the code in it is freed, e.g. when the modules are unloaded, so
+ * the memory doesn't keep growing when modules are loaded and unloaded.
+ */
+typedef struct JitCodeCacheChunk {
+    struct JitCodeCacheChunk *next;
+    /* Read-execute view, the code addresses are in this view */
+    uint8 *rx_addr;
+    /* Read-write view, the same as rx_addr if there is only one view */
+    uint8 *rw_addr;
+    uint32 size;
+    /* Number of the code blocks allocated from the chunk */
+    uint32 alloc_count;
+    mem_allocator_t allocator;
+    /* Heap struct of the allocator, which is kept out of the chunk */
+    uint8 heap_struct[1];
+} JitCodeCacheChunk;
+
+/* The first chunk is never returned to the system */
+static JitCodeCacheChunk *code_cache_chunks = NULL;
+static uint32 code_cache_chunk_size = 0;
+/* Total size of the chunks and its limit */
+static uint64 code_cache_size = 0;
+static uint64 code_cache_max_size = 0;
+static korp_mutex code_cache_lock;
+
+static JitCodeCacheChunk *
+create_chunk(uint32 size)
+{
+    uint32 heap_struct_size = mem_allocator_get_heap_struct_size();
+    JitCodeCacheChunk *chunk;
+    void *rw_addr, *rx_addr;
+
+    if (!(chunk = jit_calloc(offsetof(JitCodeCacheChunk, heap_struct)
+                             + heap_struct_size)))
+        return NULL;
+
+#ifdef OS_ENABLE_MMAP_DUAL
+    if (os_mmap_dual(size, &rw_addr, &rx_addr) != 0) {
+        jit_free(chunk);
+        return NULL;
+    }
+#else
+    if (!(rw_addr = rx_addr = os_mmap(
+              NULL, size, MMAP_PROT_READ | MMAP_PROT_WRITE | MMAP_PROT_EXEC,
+              MMAP_MAP_NONE, os_get_invalid_handle()))) {
+        jit_free(chunk);
+        return NULL;
+    }
+#endif
+
+    if (!(chunk->allocator = mem_allocator_create_with_struct_and_pool(
+              chunk->heap_struct, heap_struct_size, rw_addr, size))) {
+#ifdef OS_ENABLE_MMAP_DUAL
+        os_munmap_dual(rw_addr, rx_addr, size);
+#else
+        os_munmap(rx_addr, size);
+#endif
+        jit_free(chunk);
+        return NULL;
+    }
+
+    chunk->rw_addr = rw_addr;
+    chunk->rx_addr = rx_addr;
+    chunk->size = size;
+    return chunk;
+}
+
+static void
+destroy_chunk(JitCodeCacheChunk *chunk)
+{
+    mem_allocator_destroy(chunk->allocator);
+#ifdef OS_ENABLE_MMAP_DUAL
+    os_munmap_dual(chunk->rw_addr, chunk->rx_addr, chunk->size);
+#else
+    os_munmap(chunk->rx_addr, chunk->size);
+#endif
+    jit_free(chunk);
+}
+
+/* Find the chunk containing the code, code_cache_lock must be held */
+static JitCodeCacheChunk *
+find_chunk(const void *ptr, JitCodeCacheChunk **p_prev)
+{
+    JitCodeCacheChunk *chunk = code_cache_chunks, *prev = NULL;
+
+    for (; chunk; prev = chunk, chunk = chunk->next) {
+        if ((const uint8 *)ptr >= chunk->rx_addr
+            && (const uint8 *)ptr < chunk->rx_addr + chunk->size) {
+            if (p_prev)
+                *p_prev = prev;
+            return chunk;
+        }
+    }
+    return NULL;
+}
 
 bool
-jit_code_cache_init(uint32 code_cache_size)
+jit_code_cache_init(uint32 max_size)
 {
-    int map_prot = MMAP_PROT_READ | MMAP_PROT_WRITE | MMAP_PROT_EXEC;
-    int map_flags = MMAP_MAP_NONE;
+    uint64 chunk_size = FAST_JIT_CODE_CACHE_CHUNK_SIZE;
 
-    if (!(code_cache_pool = os_mmap(NULL, code_cache_size, map_prot, map_flags,
-                                    os_get_invalid_handle()))) {
+    if (chunk_size > max_size)
+        chunk_size = max_size;
+    chunk_size = (chunk_size + CODE_CACHE_CHUNK_ALIGN - 1)
+                 & ~(uint64)(CODE_CACHE_CHUNK_ALIGN - 1);
+
+    if (os_mutex_init(&code_cache_lock) != 0)
         return false;
-    }
 
-    if (!(code_cache_pool_allocator =
-              mem_allocator_create(code_cache_pool, code_cache_size))) {
-        os_munmap(code_cache_pool, code_cache_size);
-        code_cache_pool = NULL;
+    if (!(code_cache_chunks = create_chunk((uint32)chunk_size))) {
+        os_mutex_destroy(&code_cache_lock);
         return false;
     }
 
-    code_cache_pool_size = code_cache_size;
+    code_cache_chunk_size = (uint32)chunk_size;
+    code_cache_size = chunk_size;
+    code_cache_max_size = max_size;
     return true;
 }
 
 void
 jit_code_cache_destroy()
 {
-    mem_allocator_destroy(code_cache_pool_allocator);
-    os_munmap(code_cache_pool, code_cache_pool_size);
+    JitCodeCacheChunk *chunk = code_cache_chunks, *next;
+
+    while (chunk) {
+        next = chunk->next;
+        destroy_chunk(chunk);
+        chunk = next;
+    }
+    code_cache_chunks = NULL;
+    code_cache_size = 0;
+
+    os_mutex_destroy(&code_cache_lock);
 }
 
 void *
 jit_code_cache_alloc(uint32 size)
 {
-    return mem_allocator_malloc(code_cache_pool_allocator, size);
+    JitCodeCacheChunk *chunk;
+    uint8 *ptr = NULL;
+    uint64 chunk_size;
+
+    os_mutex_lock(&code_cache_lock);
+
+    for (chunk = code_cache_chunks; chunk; chunk = chunk->next) {
+        if ((ptr = mem_allocator_malloc(chunk->allocator, size)))
+            break;
+    }
+
+    if (!ptr) {
+        /* Grow the code cache with a chunk which can hold the code */
+        chunk_size = ((uint64)size + CODE_CACHE_CHUNK_ALIGN * 2 - 1)
+                     & ~(uint64)(CODE_CACHE_CHUNK_ALIGN - 1);
+        if (chunk_size < code_cache_chunk_size)
+            chunk_size = code_cache_chunk_size;
+
+        if (code_cache_size + chunk_size <= code_cache_max_size
+            && (chunk = create_chunk((uint32)chunk_size))) {
+            if ((ptr = mem_allocator_malloc(chunk->allocator, size))) {
+                chunk->next = code_cache_chunks->next;
+                code_cache_chunks->next = chunk;
+                code_cache_size += chunk_size;
+            }
+            else {
+                destroy_chunk(chunk);
+            }
+        }
+    }
+
+    if (ptr) {
+        chunk->alloc_count++;
+        ptr = chunk->rx_addr + (ptr - chunk->rw_addr);
+    }
+
+    os_mutex_unlock(&code_cache_lock);
+    return ptr;
+}
+
+void *
+jit_code_cache_writable(void *ptr)
+{
+    JitCodeCacheChunk *chunk;
+    uint8 *ret = NULL;
+
+    os_mutex_lock(&code_cache_lock);
+    if ((chunk = find_chunk(ptr, NULL)))
+        ret = chunk->rw_addr + ((uint8 *)ptr - chunk->rx_addr);
+    os_mutex_unlock(&code_cache_lock);
+
+    bh_assert(ret);
+    return ret;
 }
 
 void
 jit_code_cache_free(void *ptr)
 {
-    if (ptr)
-        mem_allocator_free(code_cache_pool_allocator, ptr);
+    JitCodeCacheChunk *chunk, *prev = NULL;
+
+    if (!ptr)
+        return;
+
+    os_mutex_lock(&code_cache_lock);
+
+    if ((chunk = find_chunk(ptr, &prev))) {
+        mem_allocator_free(chunk->allocator,
+                           chunk->rw_addr + ((uint8 *)ptr - chunk->rx_addr));
+
+        /* Return the chunk to the system if all its code was freed */
+        if (--chunk->alloc_count == 0 && prev) {
+            prev->next = chunk->next;
+            code_cache_size -= chunk->size;
+            destroy_chunk(chunk);
+        }
+    }
+
+    os_mutex_unlock(&code_cache_lock);
 }
 
 bool
@@ -66,9 +249,37 @@ jit_pass_register_jitted_code(JitCompContext *cc)
     os_mutex_lock(&module->instance_list_lock);
 #endif
 
+#if WASM_ENABLE_FAST_JIT_OSR != 0
+    if (cc->osr_entry_num > 0) {
+        WASMFastJitOsrEntry *entries;
+        uint32 i;
+
+        /* Don't fail the compilation, the interpreter just can't enter
+           the jitted code at the loop headers */
+        if ((entries = jit_malloc((uint32)sizeof(WASMFastJitOsrEntry)
+                                  * cc->osr_entry_num))) {
+            for (i = 0; i < cc->osr_entry_num; i++) {
+                entries[i].ip = cc->osr_entries[i].ip;
+                entries[i].jitted_addr =
+                    *(jit_annl_jitted_addr(cc, cc->osr_entries[i].label));
+            }
+            func->fast_jit_frame_size = cc->total_frame_size;
+            func->fast_jit_osr_entries = entries;
+            func->fast_jit_osr_entry_count = cc->osr_entry_num;
+        }
+    }
+    /* Publish the entries before the jitted code, the interpreter reads
+       them after it sees the jitted code */
+    os_atomic_thread_fence(os_memory_order_release);
+#endif
+
     module->fast_jit_func_ptrs[jit_func_idx] = func->fast_jit_jitted_code =
         cc->jitted_addr_begin;
 
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    jit_persistent_cache_record(cc);
+#endif
+
 #if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
     && WASM_ENABLE_LAZY_JIT != 0
     instance = module->instance_list;
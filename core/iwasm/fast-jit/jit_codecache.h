@@ -21,6 +21,18 @@ jit_code_cache_destroy();
 void *
 jit_code_cache_alloc(uint32 size);
 
+/**
+ * Get the address to write the code allocated with jit_code_cache_alloc,
+ * the code isn't writable at the address returned by jit_code_cache_alloc
+ * when the code cache is mapped twice.
+ *
+ * @param ptr the code address returned by jit_code_cache_alloc
+ *
+ * @return the writable address of the code
+ */
+void *
+jit_code_cache_writable(void *ptr);
+
 void
 jit_code_cache_free(void *ptr);
 
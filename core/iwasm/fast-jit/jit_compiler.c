@@ -7,6 +7,7 @@
 #include "jit_ir.h"
 #include "jit_codegen.h"
 #include "jit_codecache.h"
+#include "jit_persistent_cache.h"
 #include "../interpreter/wasm.h"
 
 typedef struct JitCompilerPass {
@@ -93,8 +94,17 @@ jit_compiler_init(const JitCompOptions *options)
     if (!jit_codegen_init())
         goto fail1;
 
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    if (options->cache_dir && !jit_persistent_cache_init(options->cache_dir))
+        goto fail2;
+#endif
+
     return true;
 
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+fail2:
+    jit_codegen_destroy();
+#endif
 fail1:
     jit_code_cache_destroy();
     return false;
@@ -103,6 +113,10 @@ fail1:
 void
 jit_compiler_destroy()
 {
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    jit_persistent_cache_destroy();
+#endif
+
     jit_codegen_destroy();
 
     jit_code_cache_destroy();
@@ -196,6 +210,43 @@ jit_compiler_compile_all(WASMModule *module)
     return true;
 }
 
+#if WASM_ENABLE_FAST_JIT_OSR != 0 && WASM_ENABLE_LAZY_JIT != 0
+void
+jit_compiler_add_hot_function(WASMModule *module, uint32 func_idx)
+{
+    os_mutex_lock(&module->fast_jit_hot_func_lock);
+    /* Drop the request if there are too many hot functions, the function
+       will still be compiled with the other functions of its group */
+    if (module->fast_jit_hot_func_count < FAST_JIT_OSR_HOT_FUNC_NUM) {
+        module->fast_jit_hot_funcs[module->fast_jit_hot_func_count++] =
+            func_idx;
+    }
+    os_mutex_unlock(&module->fast_jit_hot_func_lock);
+}
+
+bool
+jit_compiler_compile_hot_functions(WASMModule *module)
+{
+    uint32 func_idx;
+
+    while (!module->orcjit_stop_compiling) {
+        os_mutex_lock(&module->fast_jit_hot_func_lock);
+        if (module->fast_jit_hot_func_count == 0) {
+            os_mutex_unlock(&module->fast_jit_hot_func_lock);
+            break;
+        }
+        module->fast_jit_hot_func_count--;
+        func_idx = module->fast_jit_hot_funcs[module->fast_jit_hot_func_count];
+        os_mutex_unlock(&module->fast_jit_hot_func_lock);
+
+        if (!jit_compiler_compile(module, func_idx))
+            return false;
+    }
+
+    return true;
+}
+#endif
+
 bool
 jit_compiler_is_compiled(const WASMModule *module, uint32 func_idx)
 {
@@ -281,6 +332,15 @@ jit_compiler_set_llvm_jit_func_ptr(WASMModule *module, uint32 func_idx,
     }
     os_mutex_unlock(&module->instance_list_lock);
 }
+
+void
+jit_compiler_notify_llvm_jit_hot_func(WASMModule *module)
+{
+    os_mutex_lock(&module->tierup_wait_lock);
+    module->llvm_jit_hot_func_count++;
+    os_cond_broadcast(&module->tierup_wait_cond);
+    os_mutex_unlock(&module->tierup_wait_lock);
+}
 #endif /* end of WASM_ENABLE_LAZY_JIT != 0 && WASM_ENABLE_JIT != 0 */
 
 int
@@ -70,6 +70,10 @@ typedef struct JitInterpSwitchInfo {
 typedef struct JitCompOptions {
     uint32 code_cache_size;
     uint32 opt_level;
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    /* Directory of the persistent code cache, NULL if disabled */
+    const char *cache_dir;
+#endif
 } JitCompOptions;
 
 bool
@@ -93,6 +97,29 @@ jit_compiler_compile_all(WASMModule *module);
 bool
 jit_compiler_is_compiled(const WASMModule *module, uint32 func_idx);
 
+#if WASM_ENABLE_FAST_JIT_OSR != 0 && WASM_ENABLE_LAZY_JIT != 0
+/**
+ * Request the backend compilation threads to compile a function that
+ * got hot in the interpreter before the remaining functions.
+ *
+ * @param module the wasm module
+ * @param func_idx the index of the function, including the imports
+ */
+void
+jit_compiler_add_hot_function(WASMModule *module, uint32 func_idx);
+
+/**
+ * Compile the hot functions requested by the interpreter, called by the
+ * backend compilation threads.
+ *
+ * @param module the wasm module
+ *
+ * @return true if succeeded; false if failed to compile one of them.
+ */
+bool
+jit_compiler_compile_hot_functions(WASMModule *module);
+#endif
+
 #if WASM_ENABLE_LAZY_JIT != 0 && WASM_ENABLE_JIT != 0
 bool
 jit_compiler_set_call_to_llvm_jit(WASMModule *module, uint32 func_idx);
@@ -103,6 +130,16 @@ jit_compiler_set_call_to_fast_jit(WASMModule *module, uint32 func_idx);
 void
 jit_compiler_set_llvm_jit_func_ptr(WASMModule *module, uint32 func_idx,
                                    void *func_ptr);
+
+/**
+ * Called by the jitted code when the hotness of a function reaches
+ * LLVM_JIT_TIERUP_THRESHOLD, wakes up the backend threads waiting for
+ * hot functions to compile with llvm jit.
+ *
+ * @param module the wasm module
+ */
+void
+jit_compiler_notify_llvm_jit_hot_func(WASMModule *module);
 #endif
 
 int
@@ -14,6 +14,7 @@
 #include "fe/jit_emit_memory.h"
 #include "fe/jit_emit_numberic.h"
 #include "fe/jit_emit_parametric.h"
+#include "fe/jit_emit_simd.h"
 #include "fe/jit_emit_table.h"
 #include "fe/jit_emit_variable.h"
 #include "../interpreter/wasm_interp.h"
@@ -600,6 +601,21 @@ gen_commit_values(JitFrame *frame, JitValueSlot *begin, JitValueSlot *end)
     }
 }
 
+#if WASM_ENABLE_SIMD != 0
+void
+gen_copy_v128(JitFrame *frame, JitReg dst_base, uint32 dst_offset,
+              JitReg src_base, uint32 src_offset)
+{
+    JitCompContext *cc = frame->cc;
+    JitReg lo = jit_cc_new_reg_I64(cc), hi = jit_cc_new_reg_I64(cc);
+
+    GEN_INSN(LDI64, lo, src_base, NEW_CONST(I32, src_offset));
+    GEN_INSN(LDI64, hi, src_base, NEW_CONST(I32, src_offset + 8));
+    GEN_INSN(STI64, lo, dst_base, NEW_CONST(I32, dst_offset));
+    GEN_INSN(STI64, hi, dst_base, NEW_CONST(I32, dst_offset + 8));
+}
+#endif
+
 /**
  * Generate instructions to commit SP and IP pointers to the frame.
  *
@@ -1386,6 +1402,18 @@ jit_compile_func(JitCompContext *cc)
                     return false;
                 break;
 
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_DROP_128:
+                if (!jit_compile_op_drop(cc, true))
+                    return false;
+                break;
+
+            case WASM_OP_SELECT_128:
+                if (!jit_compile_op_select(cc, true))
+                    return false;
+                break;
+#endif
+
 #if WASM_ENABLE_REF_TYPES != 0
             case WASM_OP_SELECT_T:
             {
@@ -1463,6 +1491,9 @@ jit_compile_func(JitCompContext *cc)
 
             case WASM_OP_GET_GLOBAL:
             case WASM_OP_GET_GLOBAL_64:
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_GET_GLOBAL_128:
+#endif
                 read_leb_uint32(frame_ip, frame_ip_end, global_idx);
                 if (!jit_compile_op_get_global(cc, global_idx))
                     return false;
@@ -1470,6 +1501,9 @@ jit_compile_func(JitCompContext *cc)
 
             case WASM_OP_SET_GLOBAL:
             case WASM_OP_SET_GLOBAL_64:
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_SET_GLOBAL_128:
+#endif
             case WASM_OP_SET_GLOBAL_AUX_STACK:
                 read_leb_uint32(frame_ip, frame_ip_end, global_idx);
                 if (!jit_compile_op_set_global(
@@ -2117,6 +2151,153 @@ jit_compile_func(JitCompContext *cc)
                 break;
             }
 
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_SIMD_PREFIX:
+            {
+                uint8 lane;
+
+                opcode = *frame_ip++;
+                switch (opcode) {
+                    case SIMD_v128_load:
+                    case SIMD_v128_load8x8_s:
+                    case SIMD_v128_load8x8_u:
+                    case SIMD_v128_load16x4_s:
+                    case SIMD_v128_load16x4_u:
+                    case SIMD_v128_load32x2_s:
+                    case SIMD_v128_load32x2_u:
+                    case SIMD_v128_load8_splat:
+                    case SIMD_v128_load16_splat:
+                    case SIMD_v128_load32_splat:
+                    case SIMD_v128_load64_splat:
+                    case SIMD_v128_load32_zero:
+                    case SIMD_v128_load64_zero:
+                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_uint32(frame_ip, frame_ip_end, offset);
+                        if (!jit_compile_op_v128_load(cc, opcode, align,
+                                                      offset))
+                            return false;
+                        break;
+
+                    case SIMD_v128_store:
+                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_uint32(frame_ip, frame_ip_end, offset);
+                        if (!jit_compile_op_v128_store(cc, align, offset))
+                            return false;
+                        break;
+
+                    case SIMD_v128_load8_lane:
+                    case SIMD_v128_load16_lane:
+                    case SIMD_v128_load32_lane:
+                    case SIMD_v128_load64_lane:
+                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_uint32(frame_ip, frame_ip_end, offset);
+                        lane = *frame_ip++;
+                        if (!jit_compile_op_v128_load_lane(cc, opcode, align,
+                                                           offset, lane))
+                            return false;
+                        break;
+
+                    case SIMD_v128_store8_lane:
+                    case SIMD_v128_store16_lane:
+                    case SIMD_v128_store32_lane:
+                    case SIMD_v128_store64_lane:
+                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_uint32(frame_ip, frame_ip_end, offset);
+                        lane = *frame_ip++;
+                        if (!jit_compile_op_v128_store_lane(cc, opcode, align,
+                                                            offset, lane))
+                            return false;
+                        break;
+
+                    case SIMD_v128_const:
+                        if (!jit_compile_op_v128_const(cc, frame_ip))
+                            return false;
+                        frame_ip += 16;
+                        break;
+
+                    case SIMD_v8x16_shuffle:
+                        if (!jit_compile_op_i8x16_shuffle(cc, frame_ip))
+                            return false;
+                        frame_ip += 16;
+                        break;
+
+                    case SIMD_i8x16_splat:
+                    case SIMD_i16x8_splat:
+                    case SIMD_i32x4_splat:
+                    case SIMD_i64x2_splat:
+                    case SIMD_f32x4_splat:
+                    case SIMD_f64x2_splat:
+                        if (!jit_compile_op_simd_splat(cc, opcode))
+                            return false;
+                        break;
+
+                    case SIMD_i8x16_extract_lane_s:
+                    case SIMD_i8x16_extract_lane_u:
+                    case SIMD_i16x8_extract_lane_s:
+                    case SIMD_i16x8_extract_lane_u:
+                    case SIMD_i32x4_extract_lane:
+                    case SIMD_i64x2_extract_lane:
+                    case SIMD_f32x4_extract_lane:
+                    case SIMD_f64x2_extract_lane:
+                        lane = *frame_ip++;
+                        if (!jit_compile_op_simd_extract_lane(cc, opcode, lane))
+                            return false;
+                        break;
+
+                    case SIMD_i8x16_replace_lane:
+                    case SIMD_i16x8_replace_lane:
+                    case SIMD_i32x4_replace_lane:
+                    case SIMD_i64x2_replace_lane:
+                    case SIMD_f32x4_replace_lane:
+                    case SIMD_f64x2_replace_lane:
+                        lane = *frame_ip++;
+                        if (!jit_compile_op_simd_replace_lane(cc, opcode, lane))
+                            return false;
+                        break;
+
+                    case SIMD_v128_bitselect:
+                        if (!jit_compile_op_v128_bitselect(cc))
+                            return false;
+                        break;
+
+                    case SIMD_i8x16_shl:
+                    case SIMD_i8x16_shr_s:
+                    case SIMD_i8x16_shr_u:
+                    case SIMD_i16x8_shl:
+                    case SIMD_i16x8_shr_s:
+                    case SIMD_i16x8_shr_u:
+                    case SIMD_i32x4_shl:
+                    case SIMD_i32x4_shr_s:
+                    case SIMD_i32x4_shr_u:
+                    case SIMD_i64x2_shl:
+                    case SIMD_i64x2_shr_s:
+                    case SIMD_i64x2_shr_u:
+                        if (!jit_compile_op_simd_shift(cc, opcode))
+                            return false;
+                        break;
+
+                    case SIMD_v128_any_true:
+                    case SIMD_i8x16_all_true:
+                    case SIMD_i8x16_bitmask:
+                    case SIMD_i16x8_all_true:
+                    case SIMD_i16x8_bitmask:
+                    case SIMD_i32x4_all_true:
+                    case SIMD_i32x4_bitmask:
+                    case SIMD_i64x2_all_true:
+                    case SIMD_i64x2_bitmask:
+                        if (!jit_compile_op_simd_reduce(cc, opcode))
+                            return false;
+                        break;
+
+                    default:
+                        if (!jit_compile_op_simd_lane_op(cc, opcode))
+                            return false;
+                        break;
+                }
+                break;
+            }
+#endif /* end of WASM_ENABLE_SIMD != 0 */
+
 #if WASM_ENABLE_SHARED_MEMORY != 0
             case WASM_OP_ATOMIC_PREFIX:
             {
@@ -2299,6 +2480,14 @@ jit_frontend_translate_func(JitCompContext *cc)
         return NULL;
     }
 
+#if WASM_ENABLE_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
+    /* Count the calls for the llvm jit tier-up, in the function block
+       since the entry block must end with the jump to it */
+    if (!jit_emit_llvm_jit_hotness_count(cc)) {
+        return NULL;
+    }
+#endif
+
     if (!jit_compile_func(cc)) {
         return NULL;
     }
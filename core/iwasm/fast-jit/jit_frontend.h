@@ -309,6 +309,22 @@ gen_commit_values(JitFrame *frame, JitValueSlot *begin, JitValueSlot *end);
 void
 gen_commit_sp_ip(JitFrame *frame);
 
+#if WASM_ENABLE_SIMD != 0
+/**
+ * Generate instructions to copy a v128 value in memory, e.g. between
+ * the slots of the frame, or between a slot and a global.
+ *
+ * @param frame the frame information
+ * @param dst_base the base address register of the destination
+ * @param dst_offset the offset of the destination to dst_base
+ * @param src_base the base address register of the source
+ * @param src_offset the offset of the source to src_base
+ */
+void
+gen_copy_v128(JitFrame *frame, JitReg dst_base, uint32 dst_offset,
+              JitReg src_base, uint32 src_offset);
+#endif
+
 /**
  * Generate commit instructions for the block end.
  *
@@ -421,6 +437,31 @@ pop(JitFrame *frame, int n)
     memset(frame->sp, 0, n * sizeof(*frame->sp));
 }
 
+#if WASM_ENABLE_SIMD != 0
+/*
+ * The v128 values are not held in registers, they always live in their
+ * slots of the frame and are accessed there through memory.
+ */
+static inline void
+push_v128(JitFrame *frame)
+{
+    memset(frame->sp, 0, 4 * sizeof(*frame->sp));
+    frame->sp += 4;
+}
+
+static inline void
+pop_v128(JitFrame *frame)
+{
+    pop(frame, 4);
+}
+
+static inline void
+set_local_v128(JitFrame *frame, int n)
+{
+    memset(frame->lp + n, 0, 4 * sizeof(*frame->lp));
+}
+#endif
+
 static inline JitReg
 local_i32(JitFrame *frame, int n)
 {
@@ -486,6 +527,17 @@ set_local_f64(JitFrame *frame, int n, JitReg val)
 #define POP_FUNCREF(v) POP(v, VALUE_TYPE_FUNCREF)
 #define POP_EXTERNREF(v) POP(v, VALUE_TYPE_EXTERNREF)
 
+#if WASM_ENABLE_SIMD != 0
+/* Pop a v128 value and get the slot index of it in the frame */
+#define POP_V128(n)                                             \
+    do {                                                        \
+        JitReg _v128_reg;                                       \
+        if (!jit_cc_pop_value(cc, VALUE_TYPE_V128, &_v128_reg)) \
+            goto fail;                                          \
+        n = (uint32)(cc->jit_frame->sp - cc->jit_frame->lp);    \
+    } while (0)
+#endif
+
 #define PUSH(jit_value, value_type)                        \
     do {                                                   \
         if (!jit_value)                                    \
@@ -501,6 +553,17 @@ set_local_f64(JitFrame *frame, int n, JitReg val)
 #define PUSH_FUNCREF(v) PUSH(v, VALUE_TYPE_FUNCREF)
 #define PUSH_EXTERNREF(v) PUSH(v, VALUE_TYPE_EXTERNREF)
 
+#if WASM_ENABLE_SIMD != 0
+/* Push a v128 value and get the slot index of it in the frame, the
+   value is then stored to the slot by the caller */
+#define PUSH_V128(n)                                          \
+    do {                                                      \
+        n = (uint32)(cc->jit_frame->sp - cc->jit_frame->lp);  \
+        if (!jit_cc_push_value(cc, VALUE_TYPE_V128, 0))       \
+            goto fail;                                        \
+    } while (0)
+#endif
+
 #ifdef __cplusplus
 }
 #endif
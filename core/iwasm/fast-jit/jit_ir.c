@@ -513,6 +513,13 @@ jit_cc_destroy(JitCompContext *cc)
         jit_free(cc->_const_val._next[i]);
     }
 
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    jit_free(cc->relocs);
+#endif
+#if WASM_ENABLE_FAST_JIT_OSR != 0
+    jit_free(cc->osr_entries);
+#endif
+
     /* Release storage of annotations.  */
 #define ANN_LABEL(TYPE, NAME) jit_annl_disable_##NAME(cc);
 #define ANN_INSN(TYPE, NAME) jit_anni_disable_##NAME(cc);
@@ -556,6 +563,59 @@ _jit_realloc(void *ptr, unsigned new_size, unsigned old_size)
     return new_ptr;
 }
 
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+bool
+jit_cc_add_reloc(JitCompContext *cc, uint32 offset, JitRelocType type,
+                 uint64 value)
+{
+    if (cc->reloc_num == cc->reloc_capacity) {
+        uint32 capacity = cc->reloc_capacity > 0 ? cc->reloc_capacity * 2 : 16;
+        JitReloc *relocs =
+            _jit_realloc(cc->relocs, (unsigned)sizeof(JitReloc) * capacity,
+                         (unsigned)sizeof(JitReloc) * cc->reloc_capacity);
+
+        if (!relocs) {
+            jit_set_last_error(cc, "allocate memory failed");
+            return false;
+        }
+        cc->relocs = relocs;
+        cc->reloc_capacity = capacity;
+    }
+
+    cc->relocs[cc->reloc_num].offset = offset;
+    cc->relocs[cc->reloc_num].type = type;
+    cc->relocs[cc->reloc_num].value = value;
+    cc->reloc_num++;
+    return true;
+}
+#endif
+
+#if WASM_ENABLE_FAST_JIT_OSR != 0
+bool
+jit_cc_add_osr_entry(JitCompContext *cc, const uint8 *ip, JitReg label)
+{
+    if (cc->osr_entry_num == cc->osr_entry_capacity) {
+        uint32 capacity =
+            cc->osr_entry_capacity > 0 ? cc->osr_entry_capacity * 2 : 4;
+        JitOsrEntry *entries = _jit_realloc(
+            cc->osr_entries, (unsigned)sizeof(JitOsrEntry) * capacity,
+            (unsigned)sizeof(JitOsrEntry) * cc->osr_entry_capacity);
+
+        if (!entries) {
+            jit_set_last_error(cc, "allocate memory failed");
+            return false;
+        }
+        cc->osr_entries = entries;
+        cc->osr_entry_capacity = capacity;
+    }
+
+    cc->osr_entries[cc->osr_entry_num].ip = ip;
+    cc->osr_entries[cc->osr_entry_num].label = label;
+    cc->osr_entry_num++;
+    return true;
+}
+#endif
+
 static unsigned
 hash_of_const(unsigned kind, unsigned size, void *val)
 {
@@ -1308,6 +1368,12 @@ jit_cc_pop_value(JitCompContext *cc, uint8 type, JitReg *p_value)
         case VALUE_TYPE_F64:
             value = pop_f64(cc->jit_frame);
             break;
+#if WASM_ENABLE_SIMD != 0
+        case VALUE_TYPE_V128:
+            /* The v128 value lives in the frame */
+            pop_v128(cc->jit_frame);
+            break;
+#endif
         default:
             bh_assert(0);
             break;
@@ -1335,7 +1401,7 @@ jit_cc_push_value(JitCompContext *cc, uint8 type, JitReg value)
         return false;
     }
 
-    bh_assert(value);
+    bh_assert(value || type == VALUE_TYPE_V128);
 
     jit_value->type = to_stack_value_type(type);
     jit_value->value = cc->jit_frame->sp;
@@ -1355,6 +1421,11 @@ jit_cc_push_value(JitCompContext *cc, uint8 type, JitReg value)
         case VALUE_TYPE_F64:
             push_f64(cc->jit_frame, value);
             break;
+#if WASM_ENABLE_SIMD != 0
+        case VALUE_TYPE_V128:
+            push_v128(cc->jit_frame);
+            break;
+#endif
     }
 
     return true;
@@ -990,6 +990,39 @@ typedef struct JitBlockStack {
     JitBlock *block_list_end;
 } JitBlockStack;
 
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+typedef enum JitRelocType {
+    /* Address in the jitted code of the compilation unit,
+       the value is its offset to the beginning of the code */
+    JIT_RELOC_CODE,
+    /* Address out of the jitted code, the value is the address */
+    JIT_RELOC_ABS,
+} JitRelocType;
+
+/**
+ * An 8-byte address in the jitted code, which must be changed when the
+ * code is loaded into another process by the persistent code cache.
+ */
+typedef struct JitReloc {
+    /* Offset of the address to the beginning of the jitted code */
+    uint32 offset;
+    uint32 type;
+    uint64 value;
+} JitReloc;
+#endif
+
+#if WASM_ENABLE_FAST_JIT_OSR != 0
+/**
+ * A loop header at which the interpreter can enter the jitted code.
+ */
+typedef struct JitOsrEntry {
+    /* The bytecode address of the loop body */
+    const uint8 *ip;
+    /* The label of the basic block of the loop body */
+    JitReg label;
+} JitOsrEntry;
+#endif
+
 /**
  * The JIT compilation context for one compilation process of a
  * compilation unit.
@@ -1067,6 +1100,20 @@ typedef struct JitCompContext {
     void *jitted_addr_begin;
     void *jitted_addr_end;
 
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    /* Relocations of the jitted code recorded by the pass codegen */
+    JitReloc *relocs;
+    uint32 reloc_num;
+    uint32 reloc_capacity;
+#endif
+
+#if WASM_ENABLE_FAST_JIT_OSR != 0
+    /* Loop headers recorded by the pass frontend */
+    JitOsrEntry *osr_entries;
+    uint32 osr_entry_num;
+    uint32 osr_entry_capacity;
+#endif
+
     char last_error[128];
 
     /* Below fields are all private.  Don't access them directly. */
@@ -1276,6 +1323,38 @@ jit_cc_inc_ref(JitCompContext *cc)
 void
 jit_cc_delete(JitCompContext *cc);
 
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+/**
+ * Record an address in the jitted code to relocate when the code is
+ * loaded from the persistent code cache.
+ *
+ * @param cc the compilation context
+ * @param offset offset of the 8-byte address in the jitted code
+ * @param type the relocation type
+ * @param value the offset in the jitted code or the absolute address
+ *
+ * @return true if succeeds, false otherwise
+ */
+bool
+jit_cc_add_reloc(JitCompContext *cc, uint32 offset, JitRelocType type,
+                 uint64 value);
+#endif
+
+#if WASM_ENABLE_FAST_JIT_OSR != 0
+/**
+ * Record a loop header at which the interpreter can enter the jitted
+ * code with the on-stack replacement.
+ *
+ * @param cc the compilation context
+ * @param ip the bytecode address of the loop body
+ * @param label the label of the basic block of the loop body
+ *
+ * @return true if succeeds, false otherwise
+ */
+bool
+jit_cc_add_osr_entry(JitCompContext *cc, const uint8 *ip, JitReg label);
+#endif
+
 char *
 jit_get_last_error(JitCompContext *cc);
 
@@ -0,0 +1,796 @@
+/*
+ * Copyright (C) 2021 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "jit_persistent_cache.h"
+#include "jit_compiler.h"
+#include "jit_codecache.h"
+#include "jit_utils.h"
+
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+
+#include <dlfcn.h>
+#include <link.h>
+#if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64)
+#include <cpuid.h>
+#endif
+
+/* "WFJC" */
+#define JIT_CACHE_MAGIC 0x434A4657
+#define JIT_CACHE_VERSION 1
+#define JIT_CACHE_BUILD_ID_MAX_SIZE 32
+
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+#define ALIGN_UP(size, align) (((size) + (align)-1) & ~((align)-1))
+
+/* Relocation types in the cache file */
+typedef enum JitCacheRelocType {
+    /* Offset to the beginning of the function's jitted code */
+    JIT_CACHE_RELOC_CODE = 0,
+    /* jit_globals->return_to_interp_from_jitted */
+    JIT_CACHE_RELOC_RETURN_TO_INTERP,
+    /* Offset to the load base of the runtime */
+    JIT_CACHE_RELOC_RUNTIME,
+    /* Linked native function of the import function of the index */
+    JIT_CACHE_RELOC_IMPORT,
+    /* Symbol of the name at the offset of the symbol table */
+    JIT_CACHE_RELOC_SYMBOL,
+} JitCacheRelocType;
+
+/**
+ * The cache file is the header followed by the payload: the symbol
+ * table padded to 8 bytes, and then for each function a JitCacheFuncHeader,
+ * the jitted code padded to 8 bytes and the JitReloc array, whose types
+ * are JitCacheRelocType.
+ */
+typedef struct JitCacheFileHeader {
+    uint32 magic;
+    uint32 version;
+    uint8 build_id[JIT_CACHE_BUILD_ID_MAX_SIZE];
+    uint32 build_id_size;
+    uint32 cpu_features[4];
+    uint32 func_count;
+    uint64 module_hash;
+    uint64 module_size;
+    uint64 import_hash;
+    uint32 symtab_size;
+    uint32 reserved;
+    uint64 payload_size;
+    uint64 payload_hash;
+} JitCacheFileHeader;
+
+typedef struct JitCacheFuncHeader {
+    uint32 code_size;
+    uint32 reloc_num;
+} JitCacheFuncHeader;
+
+/* Recorded jitted code info of a function */
+typedef struct JitCacheFuncRecord {
+    bool recorded;
+    uint32 code_size;
+    uint32 reloc_num;
+    JitReloc *relocs;
+} JitCacheFuncRecord;
+
+/* Recorded jitted code info of a module */
+typedef struct JitCacheModuleRecord {
+    korp_mutex lock;
+    uint64 module_hash;
+    uint64 import_hash;
+    /* Number of the compilation groups which haven't finished */
+    uint32 groups_left;
+    /* Whether any compilation group failed */
+    bool failed;
+    JitCacheFuncRecord funcs[1];
+} JitCacheModuleRecord;
+
+typedef struct JitCacheSymtab {
+    char *data;
+    uint32 size;
+    uint32 capacity;
+} JitCacheSymtab;
+
+static char *cache_dir = NULL;
+static uint8 build_id[JIT_CACHE_BUILD_ID_MAX_SIZE];
+static uint32 build_id_size = 0;
+static uint32 cpu_features[4];
+/* Load base of the image which contains the runtime */
+static uint8 *runtime_base = NULL;
+
+static uint64
+hash_bytes(uint64 hash, const void *data, uint64 size)
+{
+    const uint8 *p = (const uint8 *)data, *p_end = p + size;
+
+    for (; p < p_end; p++) {
+        hash ^= *p;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static bool
+find_note_build_id(struct dl_phdr_info *info, const ElfW(Phdr) * phdr)
+{
+    const uint8 *p = (const uint8 *)(info->dlpi_addr + phdr->p_vaddr);
+    const uint8 *p_end = p + phdr->p_memsz, *name, *desc;
+    const ElfW(Nhdr) * note;
+
+    while (p + sizeof(ElfW(Nhdr)) <= p_end) {
+        note = (const ElfW(Nhdr) *)p;
+        name = p + sizeof(ElfW(Nhdr));
+        desc = name + ALIGN_UP(note->n_namesz, 4);
+        p = desc + ALIGN_UP(note->n_descsz, 4);
+        if (p > p_end)
+            break;
+
+        if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4
+            && !memcmp(name, "GNU", 4) && note->n_descsz > 0
+            && note->n_descsz <= JIT_CACHE_BUILD_ID_MAX_SIZE) {
+            bh_memcpy_s(build_id, sizeof(build_id), desc, note->n_descsz);
+            build_id_size = note->n_descsz;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int
+find_runtime_build_id(struct dl_phdr_info *info, size_t size, void *data)
+{
+    uintptr_t addr = (uintptr_t)data;
+    const ElfW(Phdr) * phdr;
+    uint64 hash = FNV_OFFSET_BASIS;
+    bool found = false;
+    uint32 i;
+
+    for (i = 0; i < info->dlpi_phnum && !found; i++) {
+        phdr = &info->dlpi_phdr[i];
+        if (phdr->p_type == PT_LOAD
+            && addr >= info->dlpi_addr + phdr->p_vaddr
+            && addr < info->dlpi_addr + phdr->p_vaddr + phdr->p_memsz)
+            found = true;
+    }
+    if (!found)
+        return 0;
+
+    for (i = 0; i < info->dlpi_phnum; i++) {
+        phdr = &info->dlpi_phdr[i];
+        if (phdr->p_type == PT_NOTE && find_note_build_id(info, phdr))
+            return 1;
+    }
+
+    /* No build-id note, use the hash of the code segments instead */
+    for (i = 0; i < info->dlpi_phnum; i++) {
+        phdr = &info->dlpi_phdr[i];
+        if (phdr->p_type == PT_LOAD && (phdr->p_flags & PF_X))
+            hash = hash_bytes(hash,
+                              (const void *)(info->dlpi_addr + phdr->p_vaddr),
+                              phdr->p_memsz);
+    }
+    bh_memcpy_s(build_id, sizeof(build_id), &hash, sizeof(hash));
+    build_id_size = sizeof(hash);
+    return 1;
+}
+
+static void
+get_cpu_features()
+{
+#if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64)
+    unsigned int eax, ebx, ecx, edx;
+
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        cpu_features[0] = ecx;
+        cpu_features[1] = edx;
+    }
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        cpu_features[2] = ebx;
+        cpu_features[3] = ecx;
+    }
+#endif
+}
+
+bool
+jit_persistent_cache_init(const char *dir)
+{
+    void *anchor = (void *)(uintptr_t)jit_compiler_compile;
+    uint32 size = (uint32)strlen(dir) + 1;
+    Dl_info info;
+
+    /* The jitted code may reference any function of the runtime, it is
+       relocated with the offset to the load base of the runtime image,
+       and is only reused by the runtime of the same build */
+    if (!dladdr(anchor, &info) || !info.dli_fbase
+        || !dl_iterate_phdr(find_runtime_build_id, anchor)) {
+        LOG_WARNING("JIT: failed to find the runtime image, "
+                    "persistent code cache is disabled\n");
+        return true;
+    }
+    runtime_base = (uint8 *)info.dli_fbase;
+
+    get_cpu_features();
+
+    if (!(cache_dir = jit_malloc(size)))
+        return false;
+    bh_memcpy_s(cache_dir, size, dir, size);
+
+    LOG_VERBOSE("JIT: persistent code cache dir: %s\n", cache_dir);
+    return true;
+}
+
+void
+jit_persistent_cache_destroy()
+{
+    jit_free(cache_dir);
+    cache_dir = NULL;
+}
+
+static uint64
+hash_imports(const WASMModule *module)
+{
+    const WASMFunctionImport *import;
+    uint64 hash = FNV_OFFSET_BASIS;
+    uint8 flags[3];
+    uint32 i;
+
+    /* The jitted code of calling an import function depends on how it
+       was linked, but not on the address of the native function */
+    for (i = 0; i < module->import_function_count; i++) {
+        import = &module->import_functions[i].u.function;
+        flags[0] = import->func_ptr_linked ? 1 : 0;
+        flags[1] = import->call_conv_raw ? 1 : 0;
+        flags[2] = import->call_conv_wasm_c_api ? 1 : 0;
+        hash = hash_bytes(hash, flags, sizeof(flags));
+        if (import->signature)
+            hash = hash_bytes(hash, import->signature,
+                              strlen(import->signature) + 1);
+        else
+            hash = hash_bytes(hash, "", 1);
+    }
+    return hash;
+}
+
+static bool
+get_cache_path(char *buf, uint32 buf_size,
+               const JitCacheModuleRecord *record)
+{
+    uint64 hash = FNV_OFFSET_BASIS;
+    int n;
+
+    hash = hash_bytes(hash, &record->module_hash, sizeof(uint64));
+    hash = hash_bytes(hash, &record->import_hash, sizeof(uint64));
+    hash = hash_bytes(hash, build_id, build_id_size);
+    hash = hash_bytes(hash, cpu_features, sizeof(cpu_features));
+
+    n = snprintf(buf, buf_size, "%s/%016" PRIx64 ".fjc", cache_dir, hash);
+    return n > 0 && (uint32)n < buf_size;
+}
+
+static uint8 *
+read_cache_file(const char *path, uint32 *p_size)
+{
+    struct stat stat_buf;
+    uint8 *buf = NULL;
+    uint32 size, read_size = 0;
+    ssize_t n;
+    int fd;
+
+    if ((fd = open(path, O_RDONLY)) < 0)
+        return NULL;
+
+    if (fstat(fd, &stat_buf) != 0 || stat_buf.st_size <= 0
+        || (uint64)stat_buf.st_size >= UINT32_MAX)
+        goto fail;
+
+    size = (uint32)stat_buf.st_size;
+    if (!(buf = jit_malloc(size)))
+        goto fail;
+
+    while (read_size < size) {
+        n = read(fd, buf + read_size, size - read_size);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR)
+                continue;
+            goto fail;
+        }
+        read_size += (uint32)n;
+    }
+
+    close(fd);
+    *p_size = size;
+    return buf;
+
+fail:
+    jit_free(buf);
+    close(fd);
+    return NULL;
+}
+
+static bool
+write_cache_file(const char *path, const uint8 *buf, uint32 size)
+{
+    char tmp_path[PATH_MAX];
+    uint32 written_size = 0;
+    ssize_t n;
+    int fd;
+
+    /* Write to a temporary file and then rename it, so that the runtimes
+       loading the same module never see a partially written file */
+    n = snprintf(tmp_path, sizeof(tmp_path), "%s.tmp%d", path, (int)getpid());
+    if (n <= 0 || (uint32)n >= sizeof(tmp_path))
+        return false;
+
+    if ((fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+        return false;
+
+    while (written_size < size) {
+        n = write(fd, buf + written_size, size - written_size);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR)
+                continue;
+            goto fail;
+        }
+        written_size += (uint32)n;
+    }
+
+    if (close(fd) != 0) {
+        unlink(tmp_path);
+        return false;
+    }
+    if (rename(tmp_path, path) != 0) {
+        unlink(tmp_path);
+        return false;
+    }
+    return true;
+
+fail:
+    close(fd);
+    unlink(tmp_path);
+    return false;
+}
+
+static bool
+resolve_reloc(const WASMModule *module, const JitReloc *reloc,
+              const char *symtab, uint32 symtab_size, uint8 *code,
+              uint32 code_size, uint64 *p_value)
+{
+    JitGlobals *jit_globals = jit_compiler_get_jit_globals();
+    const WASMFunctionImport *import;
+    void *func_ptr;
+
+    if ((uint64)reloc->offset + sizeof(uint64) > code_size)
+        return false;
+
+    switch (reloc->type) {
+        case JIT_CACHE_RELOC_CODE:
+            if (reloc->value > code_size)
+                return false;
+            *p_value = (uint64)(uintptr_t)(code + reloc->value);
+            return true;
+        case JIT_CACHE_RELOC_RETURN_TO_INTERP:
+            *p_value = (uint64)(uintptr_t)
+                           jit_globals->return_to_interp_from_jitted;
+            return true;
+        case JIT_CACHE_RELOC_RUNTIME:
+            *p_value = (uint64)(uintptr_t)runtime_base + reloc->value;
+            return true;
+        case JIT_CACHE_RELOC_IMPORT:
+            if (reloc->value >= module->import_function_count)
+                return false;
+            import = &module->import_functions[reloc->value].u.function;
+            if (!(func_ptr = import->func_ptr_linked))
+                return false;
+            *p_value = (uint64)(uintptr_t)func_ptr;
+            return true;
+        case JIT_CACHE_RELOC_SYMBOL:
+            if (reloc->value >= symtab_size
+                || !(func_ptr = dlsym(RTLD_DEFAULT, symtab + reloc->value)))
+                return false;
+            *p_value = (uint64)(uintptr_t)func_ptr;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool
+load_cache_file(WASMModule *module, const JitCacheModuleRecord *record,
+                const uint8 *buf, uint32 size)
+{
+    const JitCacheFileHeader *header = (const JitCacheFileHeader *)buf;
+    const JitCacheFuncHeader *func_header;
+    const JitReloc *relocs;
+    const char *symtab;
+    const uint8 *p, *p_end = buf + size;
+    uint8 **codes, *code;
+    uint64 value;
+    uint32 i, j;
+
+    if (size < sizeof(JitCacheFileHeader) || header->magic != JIT_CACHE_MAGIC
+        || header->version != JIT_CACHE_VERSION
+        || header->build_id_size != build_id_size
+        || memcmp(header->build_id, build_id, build_id_size)
+        || memcmp(header->cpu_features, cpu_features, sizeof(cpu_features))
+        || header->func_count != module->function_count
+        || header->module_hash != record->module_hash
+        || header->module_size != module->load_size
+        || header->import_hash != record->import_hash
+        || header->payload_size != size - sizeof(JitCacheFileHeader)
+        || header->symtab_size > header->payload_size
+        || header->symtab_size % 8 != 0
+        || header->payload_hash
+               != hash_bytes(FNV_OFFSET_BASIS, buf + sizeof(JitCacheFileHeader),
+                             header->payload_size))
+        return false;
+
+    symtab = (const char *)(buf + sizeof(JitCacheFileHeader));
+    if (header->symtab_size > 0 && symtab[header->symtab_size - 1] != '\0')
+        return false;
+    p = (const uint8 *)symtab + header->symtab_size;
+
+    if (!(codes = jit_calloc(sizeof(uint8 *) * module->function_count)))
+        return false;
+
+    for (i = 0; i < module->function_count; i++) {
+        if ((uint64)(p_end - p) < sizeof(JitCacheFuncHeader))
+            goto fail;
+        func_header = (const JitCacheFuncHeader *)p;
+        p += sizeof(JitCacheFuncHeader);
+
+        if (func_header->code_size == 0
+            || ALIGN_UP((uint64)func_header->code_size, 8)
+                       + sizeof(JitReloc) * (uint64)func_header->reloc_num
+                   > (uint64)(p_end - p))
+            goto fail;
+
+        if (!(codes[i] = jit_code_cache_alloc(func_header->code_size)))
+            goto fail;
+        /* Relocate the code in the writable view of the code cache */
+        code = jit_code_cache_writable(codes[i]);
+        bh_memcpy_s(code, func_header->code_size, p, func_header->code_size);
+        p += ALIGN_UP((uint64)func_header->code_size, 8);
+
+        relocs = (const JitReloc *)p;
+        p += sizeof(JitReloc) * func_header->reloc_num;
+
+        for (j = 0; j < func_header->reloc_num; j++) {
+            if (!resolve_reloc(module, &relocs[j], symtab, header->symtab_size,
+                               codes[i], func_header->code_size, &value))
+                goto fail;
+            *(uint64 *)(code + relocs[j].offset) = value;
+        }
+    }
+
+    if (p != p_end)
+        goto fail;
+
+    for (i = 0; i < module->function_count; i++) {
+        module->fast_jit_func_ptrs[i] =
+            module->functions[i]->fast_jit_jitted_code = codes[i];
+    }
+
+    jit_free(codes);
+    return true;
+
+fail:
+    for (i = 0; i < module->function_count; i++)
+        jit_code_cache_free(codes[i]);
+    jit_free(codes);
+    return false;
+}
+
+bool
+jit_persistent_cache_load(WASMModule *module, uint32 group_num)
+{
+    JitCacheModuleRecord *record;
+    char path[PATH_MAX];
+    uint64 total_size;
+    uint8 *buf;
+    uint32 size;
+    bool ret;
+
+    if (!cache_dir || !module->function_count)
+        return false;
+
+    total_size = offsetof(JitCacheModuleRecord, funcs)
+                 + sizeof(JitCacheFuncRecord) * (uint64)module->function_count;
+    if (total_size >= UINT32_MAX
+        || !(record = jit_calloc((uint32)total_size)))
+        return false;
+
+    record->module_hash =
+        hash_bytes(FNV_OFFSET_BASIS, module->load_addr, module->load_size);
+    record->import_hash = hash_imports(module);
+    record->groups_left = group_num;
+
+    if (!get_cache_path(path, sizeof(path), record)) {
+        jit_free(record);
+        return false;
+    }
+
+    if ((buf = read_cache_file(path, &size))) {
+        ret = load_cache_file(module, record, buf, size);
+        jit_free(buf);
+        if (ret) {
+            LOG_VERBOSE("JIT: loaded jitted code from %s\n", path);
+            jit_free(record);
+            return true;
+        }
+        LOG_VERBOSE("JIT: ignore mismatched cache file %s\n", path);
+    }
+
+    if (os_mutex_init(&record->lock) != 0) {
+        jit_free(record);
+        return false;
+    }
+
+    module->fast_jit_cache_record = record;
+    return false;
+}
+
+void
+jit_persistent_cache_record(JitCompContext *cc)
+{
+    WASMModule *module = cc->cur_wasm_module;
+    JitCacheModuleRecord *record = module->fast_jit_cache_record;
+    JitCacheFuncRecord *func_record;
+
+    if (!record)
+        return;
+
+    func_record =
+        &record->funcs[cc->cur_wasm_func_idx - module->import_function_count];
+
+    os_mutex_lock(&record->lock);
+    jit_free(func_record->relocs);
+    func_record->relocs = cc->relocs;
+    func_record->reloc_num = cc->reloc_num;
+    func_record->code_size =
+        (uint32)((uint8 *)cc->jitted_addr_end - (uint8 *)cc->jitted_addr_begin);
+    func_record->recorded = true;
+    os_mutex_unlock(&record->lock);
+
+    cc->relocs = NULL;
+    cc->reloc_num = cc->reloc_capacity = 0;
+}
+
+static bool
+symtab_find_or_add(JitCacheSymtab *symtab, const char *name,
+                   uint32 *p_offset)
+{
+    uint32 offset = 0, len = (uint32)strlen(name) + 1, capacity;
+    char *data;
+
+    while (offset < symtab->size) {
+        if (!strcmp(symtab->data + offset, name)) {
+            *p_offset = offset;
+            return true;
+        }
+        offset += (uint32)strlen(symtab->data + offset) + 1;
+    }
+
+    if (symtab->size + len > symtab->capacity) {
+        capacity = symtab->capacity ? symtab->capacity * 2 : 256;
+        while (capacity < symtab->size + len)
+            capacity *= 2;
+        if (!(data = jit_malloc(capacity)))
+            return false;
+        if (symtab->data) {
+            bh_memcpy_s(data, capacity, symtab->data, symtab->size);
+            jit_free(symtab->data);
+        }
+        symtab->data = data;
+        symtab->capacity = capacity;
+    }
+
+    bh_memcpy_s(symtab->data + symtab->size, symtab->capacity - symtab->size,
+                name, len);
+    *p_offset = symtab->size;
+    symtab->size += len;
+    return true;
+}
+
+/* Convert an absolute address of the jitted code to a portable relocation,
+   return false if it can't be relocated in another process */
+static bool
+convert_reloc(const WASMModule *module, const JitReloc *reloc,
+              JitCacheSymtab *symtab, JitReloc *reloc_ret)
+{
+    JitGlobals *jit_globals = jit_compiler_get_jit_globals();
+    void *addr = (void *)(uintptr_t)reloc->value;
+    Dl_info info;
+    uint32 i, offset;
+
+    reloc_ret->offset = reloc->offset;
+
+    if (reloc->type == JIT_RELOC_CODE) {
+        reloc_ret->type = JIT_CACHE_RELOC_CODE;
+        reloc_ret->value = reloc->value;
+        return true;
+    }
+
+    if (addr == jit_globals->return_to_interp_from_jitted) {
+        reloc_ret->type = JIT_CACHE_RELOC_RETURN_TO_INTERP;
+        reloc_ret->value = 0;
+        return true;
+    }
+
+    for (i = 0; i < module->import_function_count; i++) {
+        if (addr == module->import_functions[i].u.function.func_ptr_linked) {
+            reloc_ret->type = JIT_CACHE_RELOC_IMPORT;
+            reloc_ret->value = i;
+            return true;
+        }
+    }
+
+    if (!dladdr(addr, &info))
+        return false;
+
+    if ((uint8 *)info.dli_fbase == runtime_base) {
+        reloc_ret->type = JIT_CACHE_RELOC_RUNTIME;
+        reloc_ret->value = (uint64)((uint8 *)addr - runtime_base);
+        return true;
+    }
+
+    /* A function of other shared libraries, e.g. libc */
+    if (info.dli_sname && dlsym(RTLD_DEFAULT, info.dli_sname) == addr) {
+        if (!symtab_find_or_add(symtab, info.dli_sname, &offset))
+            return false;
+        reloc_ret->type = JIT_CACHE_RELOC_SYMBOL;
+        reloc_ret->value = offset;
+        return true;
+    }
+
+    return false;
+}
+
+static bool
+save_cache_file(WASMModule *module, const JitCacheModuleRecord *record)
+{
+    JitCacheSymtab symtab = { 0 };
+    JitCacheFileHeader *header;
+    JitCacheFuncHeader *func_header;
+    const JitCacheFuncRecord *func_record;
+    JitReloc *relocs;
+    char path[PATH_MAX];
+    uint64 total_size;
+    uint8 *buf = NULL, *p, *code;
+    uint32 i, j;
+    bool ret = false;
+
+    total_size = sizeof(JitCacheFileHeader);
+    for (i = 0; i < module->function_count; i++) {
+        func_record = &record->funcs[i];
+        code = module->functions[i]->fast_jit_jitted_code;
+        if (!func_record->recorded || !code)
+            goto fail;
+
+        for (j = 0; j < func_record->reloc_num; j++) {
+            JitReloc reloc;
+            /* Collect the symbols, and check whether it can be relocated */
+            if (func_record->relocs[j].offset + sizeof(uint64)
+                    > func_record->code_size
+                || !convert_reloc(module, &func_record->relocs[j], &symtab,
+                                  &reloc)) {
+                LOG_VERBOSE("JIT: func %u can't be saved to the code cache\n",
+                            i);
+                goto fail;
+            }
+        }
+
+        total_size += sizeof(JitCacheFuncHeader)
+                      + ALIGN_UP((uint64)func_record->code_size, 8)
+                      + sizeof(JitReloc) * (uint64)func_record->reloc_num;
+    }
+    total_size += ALIGN_UP((uint64)symtab.size, 8);
+
+    if (total_size >= UINT32_MAX || !(buf = jit_calloc((uint32)total_size)))
+        goto fail;
+
+    p = buf + sizeof(JitCacheFileHeader);
+    if (symtab.size > 0)
+        bh_memcpy_s(p, symtab.size, symtab.data, symtab.size);
+    p += ALIGN_UP((uint64)symtab.size, 8);
+
+    for (i = 0; i < module->function_count; i++) {
+        func_record = &record->funcs[i];
+
+        func_header = (JitCacheFuncHeader *)p;
+        func_header->code_size = func_record->code_size;
+        func_header->reloc_num = func_record->reloc_num;
+        p += sizeof(JitCacheFuncHeader);
+
+        code = p;
+        bh_memcpy_s(code, func_record->code_size,
+                    module->functions[i]->fast_jit_jitted_code,
+                    func_record->code_size);
+        p += ALIGN_UP((uint64)func_record->code_size, 8);
+
+        relocs = (JitReloc *)p;
+        for (j = 0; j < func_record->reloc_num; j++) {
+            if (!convert_reloc(module, &func_record->relocs[j], &symtab,
+                               &relocs[j]))
+                goto fail;
+            /* Clear the absolute address so the file doesn't differ
+               between runs */
+            memset(code + relocs[j].offset, 0, sizeof(uint64));
+        }
+        p += sizeof(JitReloc) * func_record->reloc_num;
+    }
+    bh_assert(p == buf + total_size);
+
+    header = (JitCacheFileHeader *)buf;
+    header->magic = JIT_CACHE_MAGIC;
+    header->version = JIT_CACHE_VERSION;
+    bh_memcpy_s(header->build_id, sizeof(header->build_id), build_id,
+                build_id_size);
+    header->build_id_size = build_id_size;
+    bh_memcpy_s(header->cpu_features, sizeof(header->cpu_features),
+                cpu_features, sizeof(cpu_features));
+    header->func_count = module->function_count;
+    header->module_hash = record->module_hash;
+    header->module_size = module->load_size;
+    header->import_hash = record->import_hash;
+    header->symtab_size = (uint32)ALIGN_UP((uint64)symtab.size, 8);
+    header->payload_size = total_size - sizeof(JitCacheFileHeader);
+    header->payload_hash =
+        hash_bytes(FNV_OFFSET_BASIS, buf + sizeof(JitCacheFileHeader),
+                   header->payload_size);
+
+    if (!get_cache_path(path, sizeof(path), record)
+        || !write_cache_file(path, buf, (uint32)total_size)) {
+        LOG_WARNING("JIT: failed to save the persistent code cache\n");
+        goto fail;
+    }
+
+    LOG_VERBOSE("JIT: saved jitted code to %s\n", path);
+    ret = true;
+
+fail:
+    jit_free(symtab.data);
+    jit_free(buf);
+    return ret;
+}
+
+void
+jit_persistent_cache_group_done(WASMModule *module, bool succeeded)
+{
+    JitCacheModuleRecord *record = module->fast_jit_cache_record;
+
+    if (!record)
+        return;
+
+    os_mutex_lock(&record->lock);
+    if (!succeeded)
+        record->failed = true;
+    /* The last finished group saves the cache, all functions have been
+       compiled since a function is compiled only once under its lock */
+    if (--record->groups_left == 0 && !record->failed)
+        save_cache_file(module, record);
+    os_mutex_unlock(&record->lock);
+}
+
+void
+jit_persistent_cache_discard(WASMModule *module)
+{
+    JitCacheModuleRecord *record = module->fast_jit_cache_record;
+    uint32 i;
+
+    if (!record)
+        return;
+
+    for (i = 0; i < module->function_count; i++)
+        jit_free(record->funcs[i].relocs);
+    os_mutex_destroy(&record->lock);
+    jit_free(record);
+    module->fast_jit_cache_record = NULL;
+}
+
+#endif /* end of WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0 */
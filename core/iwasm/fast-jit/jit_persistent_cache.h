@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2021 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _JIT_PERSISTENT_CACHE_H_
+#define _JIT_PERSISTENT_CACHE_H_
+
+#include "bh_platform.h"
+#include "jit_ir.h"
+#include "../interpreter/wasm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+
+/**
+ * Initialize the persistent code cache, the jitted code of a module is
+ * saved to and loaded from a file of the cache directory.
+ *
+ * @param cache_dir the cache directory
+ *
+ * @return true if succeeded; false if failed.
+ */
+bool
+jit_persistent_cache_init(const char *cache_dir);
+
+/**
+ * Destroy the persistent code cache.
+ */
+void
+jit_persistent_cache_destroy();
+
+/**
+ * Load the jitted code of all the functions of a module from the cache.
+ * If the cache file doesn't exist or doesn't match the module and the
+ * runtime, prepare to record the jitted code of the module, which is
+ * saved after all the compilation groups finish.
+ *
+ * @param module the wasm module
+ * @param group_num the number of compilation groups
+ *
+ * @return true if all the functions were loaded; false otherwise.
+ */
+bool
+jit_persistent_cache_load(WASMModule *module, uint32 group_num);
+
+/**
+ * Record the relocations of the jitted code of the compiled function,
+ * the relocations of the compilation context are moved to the record.
+ *
+ * @param cc the compilation context
+ */
+void
+jit_persistent_cache_record(JitCompContext *cc);
+
+/**
+ * Notify that a compilation group of the module finished, the jitted
+ * code of the module is saved to the cache when all groups succeeded.
+ *
+ * @param module the wasm module
+ * @param succeeded whether all functions of the group were compiled
+ */
+void
+jit_persistent_cache_group_done(WASMModule *module, bool succeeded);
+
+/**
+ * Free the record of the module.
+ *
+ * @param module the wasm module
+ */
+void
+jit_persistent_cache_discard(WASMModule *module);
+
+#endif /* end of WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _JIT_PERSISTENT_CACHE_H_ */
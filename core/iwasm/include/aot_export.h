@@ -82,6 +82,7 @@ typedef struct AOTCompOption {
     const char *stack_usage_file;
     const char *llvm_passes;
     const char *builtin_intrinsics;
+    uint32_t thread_num;
 } AOTCompOption, *aot_comp_option_t;
 
 bool
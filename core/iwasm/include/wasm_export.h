@@ -67,6 +67,10 @@ typedef struct WASMModuleCommon *wasm_module_t;
 struct WASMModuleInstanceCommon;
 typedef struct WASMModuleInstanceCommon *wasm_module_inst_t;
 
+/* Snapshot of an instantiated WASM module to create instances from */
+struct WASMInstanceTemplate;
+typedef struct WASMInstanceTemplate *wasm_instance_template_t;
+
 /* Function instance */
 typedef void WASMFunctionInstanceCommon;
 typedef WASMFunctionInstanceCommon *wasm_function_inst_t;
@@ -158,7 +162,7 @@ typedef struct RuntimeInitArgs {
     int unused; /* was platform_port */
     int instance_port;
 
-    /* Fast JIT code cache size */
+    /* Fast JIT code cache size, the code cache grows up to it */
     uint32_t fast_jit_code_cache_size;
 
     /* Default running mode of the runtime */
@@ -169,6 +173,10 @@ typedef struct RuntimeInitArgs {
     uint32_t llvm_jit_size_level;
     /* Segue optimization flags for LLVM JIT */
     uint32_t segue_flags;
+
+    /* Directory of the persistent Fast JIT code cache, NULL to disable it,
+       only used when WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE is defined */
+    const char *fast_jit_cache_dir;
 } RuntimeInitArgs;
 
 #ifndef WASM_VALKIND_T_DEFINED
@@ -203,6 +211,19 @@ typedef struct wasm_val_t {
 } wasm_val_t;
 #endif
 
+/* The cache of a WASM function resolved by its name, which is used by
+   wasm_runtime_call_wasm_cached and must be zero-initialized before
+   the first call. It is keyed on an id given to each module instance
+   rather than on the instance address, so it is safe to keep it after
+   the instance is deinstantiated, the next call resolves the function
+   again */
+typedef struct wasm_func_cache_t {
+    uint32_t module_inst_id;
+    wasm_function_inst_t function;
+    uint32_t param_cell_num;
+    bool need_conversion;
+} wasm_func_cache_t;
+
 /**
  * Initialize the WASM runtime environment, and also initialize
  * the memory allocator with system allocator, which calls os_malloc
@@ -379,6 +400,25 @@ WASM_RUNTIME_API_EXTERN wasm_module_t
 wasm_runtime_load(uint8_t *buf, uint32_t size,
                   char *error_buf, uint32_t error_buf_size);
 
+/**
+ * Load an AOT module from a file by mapping the file copy-on-write instead
+ * of reading it into a buffer. The pages of the AOT text are shared with
+ * the page cache of the file, and so with the other processes loading the
+ * same file, except the pages written by relocations. Only the AOT file
+ * is supported, and only on the platforms which can map files, e.g. Linux.
+ * The pages of a file compiled by wamrc with "--xip" aren't relocated.
+ *
+ * @param file_path the path of the AOT file, which shouldn't be modified
+ *        until wasm_runtime_unload is called
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return return AOT module loaded, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_module_t
+wasm_runtime_load_aot_file_mapped(const char *file_path, char *error_buf,
+                                  uint32_t error_buf_size);
+
 /**
  * Load a WASM module from a specified WASM or AOT section list.
  *
@@ -497,6 +537,71 @@ wasm_runtime_instantiate(const wasm_module_t module,
                          uint32_t default_stack_size, uint32_t host_managed_heap_size,
                          char *error_buf, uint32_t error_buf_size);
 
+/**
+ * Create a template from a WASM module instance whose start functions
+ * have run, its linear memory is copied into an in-memory file and its
+ * globals and tables are copied, so the instance can be used or
+ * deinstantiated afterwards. Only instances of AOT modules without app
+ * heap, i.e. instantiated with host_managed_heap_size 0 or exporting
+ * malloc/free, are supported, and only on platforms with hardware bound
+ * check and copy-on-write file mapping, e.g. Linux.
+ *
+ * @param module_inst the WASM module instance to snapshot
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return return the template created, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_instance_template_t
+wasm_runtime_create_instance_template(wasm_module_inst_t module_inst,
+                                      char *error_buf, uint32_t error_buf_size);
+
+/**
+ * Destroy a template, the instances created from it remain valid.
+ *
+ * @param tmpl the template to destroy
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_destroy_instance_template(wasm_instance_template_t tmpl);
+
+/**
+ * Instantiate the module of a template in the state of the template: the
+ * linear memory is mapped copy-on-write from the memory image, so only the
+ * pages written by the new instance take memory, and the data segments and
+ * start functions aren't executed again.
+ *
+ * @param tmpl the template to instantiate
+ * @param default_stack_size the default stack size of the module instance,
+ *        see wasm_runtime_instantiate
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return return the instantiated WASM module instance, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_module_inst_t
+wasm_runtime_instantiate_from_template(wasm_instance_template_t tmpl,
+                                       uint32_t default_stack_size,
+                                       char *error_buf,
+                                       uint32_t error_buf_size);
+
+/**
+ * Reset an instance created by wasm_runtime_instantiate_from_template to
+ * the state of the template so it can be reused instead of being
+ * deinstantiated, the pages it wrote are dropped. No thread may be
+ * running the instance.
+ *
+ * @param tmpl the template the instance was created from
+ * @param module_inst the WASM module instance to reset
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_recycle_instance(wasm_instance_template_t tmpl,
+                              wasm_module_inst_t module_inst, char *error_buf,
+                              uint32_t error_buf_size);
+
 /**
  * Set the running mode of a WASM module instance, override the
  * default running mode of the runtime. Note that it only makes sense when
@@ -766,6 +871,36 @@ wasm_runtime_call_wasm(wasm_exec_env_t exec_env,
                        wasm_function_inst_t function,
                        uint32_t argc, uint32_t argv[]);
 
+/**
+ * Call the WASM function of the given name of a WASM module instance
+ * with arguments (bytecode and AoT), the function is resolved and argc
+ * is checked against its type in the first call, then the function and
+ * its parameter cell number are saved in the cache, so that the later
+ * calls with the same cache skip the name lookup and the parsing of the
+ * function type, only argc is compared with the cached parameter cell
+ * number before going to the function directly.
+ *
+ * @param exec_env the execution environment to call the function,
+ *   which must be created from wasm_create_exec_env()
+ * @param cache the cache of the function, it is re-resolved if the
+ *   module instance of exec_env is not the one it was resolved in,
+ *   including a new instance created at the address of a deinstantiated
+ *   one
+ * @param name the name of the function to call
+ * @param argc total cell number that the function parameters occupy,
+ *   see wasm_runtime_call_wasm
+ * @param argv the arguments and the return value,
+ *   see wasm_runtime_call_wasm
+ *
+ * @return true if success, false otherwise and exception will be thrown,
+ *   the caller can call wasm_runtime_get_exception to get the exception
+ *   info.
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_call_wasm_cached(wasm_exec_env_t exec_env,
+                              wasm_func_cache_t *cache, const char *name,
+                              uint32_t argc, uint32_t argv[]);
+
 /**
  * Call the given WASM function of a WASM module instance with
  * provided results space and arguments (bytecode and AoT).
@@ -1127,6 +1262,129 @@ wasm_runtime_get_native_addr_range(wasm_module_inst_t module_inst,
                                    uint8_t **p_native_start_addr,
                                    uint8_t **p_native_end_addr);
 
+/**
+ * Callback to output a piece of a linear memory snapshot
+ *
+ * @param user_data the user data passed to wasm_runtime_snapshot_memory
+ * @param buf the data to output
+ * @param size the size of the data
+ *
+ * @return true if success, false otherwise
+ */
+typedef bool (*wasm_memory_snapshot_write_func_t)(void *user_data,
+                                                  const void *buf,
+                                                  uint32_t size);
+
+/**
+ * Callback to input a piece of a linear memory snapshot
+ *
+ * @param user_data the user data passed to
+ *        wasm_runtime_restore_memory_snapshot
+ * @param buf the buffer to fill
+ * @param size the size of the data to read into the buffer
+ *
+ * @return true if success, false otherwise
+ */
+typedef bool (*wasm_memory_snapshot_read_func_t)(void *user_data, void *buf,
+                                                 uint32_t size);
+
+/**
+ * Take a snapshot of the default linear memory of a module instance,
+ * only available when checkpoint/restore is enabled.
+ *
+ * A base image holds all the pages of the memory, a delta image only
+ * holds the pages written since the previous snapshot of the memory, so
+ * its cost grows with the pages written rather than the memory size.
+ * A delta image is only taken when `incremental` is true, a previous
+ * snapshot exists and the platform can track the written pages (Linux
+ * soft-dirty bits with the hardware bound check reserved memory),
+ * otherwise a base image is taken.
+ *
+ * The threads running the module instance must be stopped during the
+ * snapshot.
+ *
+ * @param module_inst the module instance
+ * @param incremental whether to take a delta image if possible
+ * @param write_func the callback to output the image
+ * @param user_data the user data passed to write_func
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_snapshot_memory(wasm_module_inst_t module_inst, bool incremental,
+                             wasm_memory_snapshot_write_func_t write_func,
+                             void *user_data);
+
+/**
+ * Apply a base or delta image taken by wasm_runtime_snapshot_memory to the
+ * default linear memory of a module instance, the memory is enlarged if
+ * needed. To restore a chain of images, apply the base image first and
+ * then the delta images in the order they were taken.
+ *
+ * @param module_inst the module instance
+ * @param read_func the callback to input the image
+ * @param user_data the user data passed to read_func
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_restore_memory_snapshot(wasm_module_inst_t module_inst,
+                                     wasm_memory_snapshot_read_func_t read_func,
+                                     void *user_data);
+
+/**
+ * Set the number of loop iterations between two loop checkpoints of AOT
+ * code compiled with `--enable-counter-loop-checkpoint`, for the threads
+ * created afterwards. A smaller period lowers the checkpoint latency at
+ * the cost of more frequent safepoint overhead.
+ *
+ * @param period the loop iterations between two checkpoints, 0 is
+ *        treated as 1
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_default_checkpoint_loop_period(uint32_t period);
+
+/**
+ * Set the number of loop iterations between two loop checkpoints of a
+ * thread, it takes effect the next time the thread enters a loop or takes
+ * a loop checkpoint.
+ *
+ * @param exec_env the execution environment of the thread
+ * @param period the loop iterations between two checkpoints, 0 is
+ *        treated as 1
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_set_checkpoint_loop_period(wasm_exec_env_t exec_env,
+                                        uint32_t period);
+
+/**
+ * Record a hit of the AOT loop safepoint the current thread is stopped at,
+ * to be called from the checkpoint handler when the module was compiled
+ * with counter loop checkpoints. The hits of all the instances of a module
+ * are accumulated into its checkpoint profile.
+ *
+ * @param exec_env the execution environment stopped at the safepoint
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_record_checkpoint_profile(wasm_exec_env_t exec_env);
+
+/**
+ * Save the checkpoint profile collected for an AOT module, pass
+ * "<aot_file>.pgo" as the file name so that
+ * `wamrc --enable-checkpoint-pgo` drops the safepoints of the loops
+ * that were never hit.
+ *
+ * @param module the AOT module
+ * @param file_name the profile file to write
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_save_checkpoint_profile(wasm_module_t module,
+                                     const char *file_name);
+
 /**
  * Register native functions with same module name
  *
@@ -1304,6 +1562,75 @@ wasm_runtime_spawn_thread(wasm_exec_env_t exec_env, wasm_thread_t *tid,
 WASM_RUNTIME_API_EXTERN int32_t
 wasm_runtime_join_thread(wasm_thread_t tid, void **retval);
 
+/* A frame of a checkpointed AOT call chain */
+typedef struct wasm_restore_frame_t {
+    /* function index, including the imported functions */
+    uint32_t func_index;
+    /* the ip_offset of the AOTFrame when checkpointed */
+    uint32_t ip_offset;
+    /* operand stack top, in cells from the start of the locals */
+    uint32_t sp_offset;
+    /* the number of cells of the locals and operand stack to copy */
+    uint32_t cell_num;
+    const uint32_t *cells;
+} wasm_restore_frame_t;
+
+/* The checkpointed state of a thread to restore */
+typedef struct wasm_thread_restore_info_t {
+    /* the module instance the thread runs, owned by the thread once
+       restored */
+    wasm_module_inst_t module_inst;
+    /* the native thread handle recorded at checkpoint, mapped to the
+       new handle when the thread starts */
+    uint64_t handle;
+    /* the aux stack of the thread, size 0 disables the aux stack */
+    uint32_t aux_stack_start;
+    uint32_t aux_stack_size;
+    /* the call chain, outermost frame first */
+    const wasm_restore_frame_t *frames;
+    uint32_t frame_count;
+    /* called once all the threads are restored, it resumes the thread by
+       calling into the module */
+    wasm_thread_callback_t callback;
+    void *arg;
+} wasm_thread_restore_info_t;
+
+/**
+ * Rebuild a checkpointed AOT call chain on the wasm stack of an exec env,
+ * the frames are popped by the following calls into AOT code, outermost
+ * first. The runtime owns the chain built here and frees it once consumed
+ * or when the exec env is destroyed. A chain set on the exec env by other
+ * means stays owned by whoever set it.
+ *
+ * @param exec_env the execution environment, its wasm stack must be empty
+ * @param frames the frames of the call chain, outermost first
+ * @param frame_count the number of frames
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_restore_call_chain(wasm_exec_env_t exec_env,
+                                const wasm_restore_frame_t *frames,
+                                uint32_t frame_count);
+
+/**
+ * Restore the threads of a checkpointed cluster. Each thread rebuilds its
+ * exec env, aux stack and call chain on its own native thread in
+ * parallel, then all the threads are released together once every one is
+ * ready, and each calls its callback.
+ *
+ * @param exec_env the execution environment of the main thread
+ * @param infos the checkpointed state of the threads
+ * @param count the number of threads
+ *
+ * @return 0 if all the threads were restored, -1 otherwise, in which case
+ *         none of the callbacks is called
+ */
+WASM_RUNTIME_API_EXTERN int32_t
+wasm_runtime_restore_threads(wasm_exec_env_t exec_env,
+                             const wasm_thread_restore_info_t *infos,
+                             uint32_t count);
+
 /**
  * Map external object to an internal externref index: if the index
  *   has been created, return it, otherwise create the index.
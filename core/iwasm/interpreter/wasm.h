@@ -129,6 +129,11 @@ typedef struct WASMType {
     /* Code block to call llvm jit functions of this
        kind of function type from fast jit jitted code */
     void *call_to_llvm_jit_from_fast_jit;
+#endif
+#if WASM_ENABLE_AOT != 0 && WASM_ENABLE_QUICK_AOT_ENTRY != 0
+    /* Precompiled entry stub to call the AOT functions of this
+       kind of function type from the runtime, or NULL if none */
+    void *quick_aot_entry;
 #endif
     /* types of params and results */
     uint8 types[1];
@@ -231,6 +236,15 @@ typedef struct WASMImport {
     } u;
 } WASMImport;
 
+#if WASM_ENABLE_FAST_JIT_OSR != 0
+typedef struct WASMFastJitOsrEntry {
+    /* The bytecode address of the loop body */
+    const uint8 *ip;
+    /* The jitted code address of the loop body */
+    void *jitted_addr;
+} WASMFastJitOsrEntry;
+#endif
+
 struct WASMFunction {
 #if WASM_ENABLE_CUSTOM_NAME_SECTION != 0
     char *field_name;
@@ -280,12 +294,27 @@ struct WASMFunction {
 #if WASM_ENABLE_FAST_JIT != 0
     /* The compiled fast jit jitted code block of this function */
     void *fast_jit_jitted_code;
+#if WASM_ENABLE_FAST_JIT_OSR != 0
+    /* The number of loop back-edges taken by the interpreter */
+    uint32 fast_jit_hotness;
+    /* The frame size of the jitted code */
+    uint32 fast_jit_frame_size;
+    /* The loop headers at which the interpreter can enter the jitted
+       code, they are set before fast_jit_jitted_code */
+    WASMFastJitOsrEntry *fast_jit_osr_entries;
+    uint32 fast_jit_osr_entry_count;
+#endif
 #if WASM_ENABLE_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
     /* The compiled llvm jit func ptr of this function */
     void *llvm_jit_func_ptr;
     /* Code block to call fast jit jitted code of this function
        from the llvm jit jitted code */
     void *call_to_fast_jit_from_llvm_jit;
+    /* The number of calls and loop iterations counted by the fast jit
+       jitted code, saturated at UINT32_MAX. The functions which reach
+       LLVM_JIT_TIERUP_THRESHOLD are compiled by llvm jit, the hottest
+       ones firstly */
+    uint32 llvm_jit_hotness;
 #endif
 #endif
 };
@@ -556,6 +585,18 @@ struct WASMModule {
     /* locks for Fast JIT lazy compilation */
     korp_mutex fast_jit_thread_locks[WASM_ORC_JIT_BACKEND_THREAD_NUM];
     bool fast_jit_thread_locks_inited[WASM_ORC_JIT_BACKEND_THREAD_NUM];
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    /* jitted code info recorded to save the persistent code cache */
+    void *fast_jit_cache_record;
+#endif
+#if WASM_ENABLE_FAST_JIT_OSR != 0 && WASM_ENABLE_LAZY_JIT != 0
+    /* Functions got hot in the interpreter, the backend compilation
+       threads compile them before the remaining functions */
+    korp_mutex fast_jit_hot_func_lock;
+    bool fast_jit_hot_func_lock_inited;
+    uint32 fast_jit_hot_funcs[FAST_JIT_OSR_HOT_FUNC_NUM];
+    uint32 fast_jit_hot_func_count;
+#endif
 #endif
 
 #if WASM_ENABLE_JIT != 0
@@ -604,6 +645,10 @@ struct WASMModule {
     /* The count of groups which finish compiling the fast jit
        functions in that group */
     uint32 fast_jit_ready_groups;
+    /* The count of functions which reached LLVM_JIT_TIERUP_THRESHOLD,
+       the backend threads wait until it changes when no function of
+       their groups is hot */
+    uint32 llvm_jit_hot_func_count;
 #endif
 };
 
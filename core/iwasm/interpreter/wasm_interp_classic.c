@@ -8,6 +8,9 @@
 #include "wasm_runtime.h"
 #include "wasm_opcode.h"
 #include "wasm_loader.h"
+#if WASM_ENABLE_SIMD != 0
+#include "wasm_simd.h"
+#endif
 #include "wasm_memory.h"
 #include "../common/wasm_exec_env.h"
 #if WASM_ENABLE_SHARED_MEMORY != 0
@@ -25,9 +28,10 @@
 const char *func_to_stop = NULL;
 int func_to_stop_count = 0;
 int func_count_ = 0;
+/* Number of checkpoints taken at interpreter safepoints */
+uint64_t counter_ = 0;
 #endif
 
-uint64_t counter_ = 0;
 typedef int32 CellType_I32;
 typedef int64 CellType_I64;
 typedef float32 CellType_F32;
@@ -893,7 +897,7 @@ wasm_interp_call_func_native(WASMModuleInstance *module_inst,
     CApiFuncImport *c_api_func_import = NULL;
     unsigned local_cell_num = 2;
     WASMInterpFrame *frame;
-    uint32 argv_ret[2], cur_func_index;
+    uint32 argv_ret[4], cur_func_index;
     void *native_func_pointer = NULL;
     char buf[128];
     bool ret;
@@ -963,6 +967,12 @@ wasm_interp_call_func_native(WASMModuleInstance *module_inst,
         prev_frame->sp[1] = argv_ret[1];
         prev_frame->sp += 2;
     }
+#if WASM_ENABLE_SIMD != 0
+    else if (cur_func->ret_cell_num == 4) {
+        bh_memcpy_s(prev_frame->sp, sizeof(V128), argv_ret, sizeof(V128));
+        prev_frame->sp += 4;
+    }
+#endif
 
     FREE_FRAME(exec_env, frame);
     wasm_exec_env_set_cur_frame(exec_env, prev_frame);
@@ -982,6 +992,19 @@ fast_jit_invoke_native(WASMExecEnv *exec_env, uint32 func_idx,
 }
 #endif
 
+#if WASM_ENABLE_FAST_JIT_OSR != 0
+static void
+fast_jit_call_func_bytecode(WASMModuleInstance *module_inst,
+                            WASMExecEnv *exec_env,
+                            WASMFunctionInstance *function,
+                            WASMInterpFrame *frame);
+
+static bool
+fast_jit_osr(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
+             WASMFunctionInstance *function, WASMInterpFrame *frame,
+             const uint8 *ip);
+#endif
+
 #if WASM_ENABLE_MULTI_MODULE != 0
 static void
 wasm_interp_call_func_bytecode(WASMModuleInstance *module,
@@ -1097,6 +1120,28 @@ wasm_interp_call_func_import(WASMModuleInstance *module_inst,
 #endif /* WASM_ENABLE_DEBUG_INTERP */
 #endif /* WASM_ENABLE_THREAD_MGR */
 
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+/**
+ * Poll for a pending checkpoint request. This is only done at the
+ * safepoints (taken branches, calls and returns), where frame_ip is at
+ * an opcode boundary, and the frame state is only synced to the frame
+ * when a checkpoint was requested. A request is either made with
+ * wasm_exec_env_request_checkpoint() or by an external trigger setting
+ * exec_env->is_checkpoint directly.
+ */
+#define CHECK_CHECKPOINT()                                   \
+    do {                                                     \
+        if ((WASM_SUSPEND_FLAGS_GET(exec_env->suspend_flags) \
+             & WASM_SUSPEND_FLAG_CHECKPOINT)                 \
+            || exec_env->is_checkpoint) {                    \
+            SYNC_ALL_TO_FRAME();                             \
+            do_checkpoint(exec_env);                         \
+        }                                                    \
+    } while (0)
+#else
+#define CHECK_CHECKPOINT() (void)0
+#endif /* WASM_ENABLE_CHECKPOINT_RESTORE */
+
 #if WASM_ENABLE_LABELS_AS_VALUES != 0
 
 #define HANDLE_OP(opcode) HANDLE_##opcode:
@@ -1119,33 +1164,7 @@ wasm_interp_call_func_import(WASMModuleInstance *module_inst,
         goto *handle_table[*frame_ip++];                                  \
     } while (0)
 #else
-#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
-#define HANDLE_OP_END()                                                 \
-    do {                                                                \
-        SYNC_ALL_TO_FRAME();                                            \
-        if (!exec_env->is_restore) {                                    \
-            if (!exec_env->is_checkpoint && counter_ < SNAPSHOT_STEP) { \
-                counter_++;                                             \
-                FETCH_OPCODE_AND_DISPATCH();                            \
-            }                                                           \
-            else {                                                      \
-                LOG_DEBUG("[%s:%d]\n", __FILE__, __LINE__);             \
-                counter_++;                                             \
-                if (counter_ > SNAPSHOT_STEP + SNAPSHOT_DEBUG_STEP) {   \
-                    serialize_to_file(exec_env);                        \
-                }                                                       \
-                FETCH_OPCODE_AND_DISPATCH();                            \
-            }                                                           \
-        }                                                               \
-        else {                                                          \
-            LOG_DEBUG("[%s:%d]\n", __FILE__, __LINE__);                 \
-            counter_++;                                                 \
-            FETCH_OPCODE_AND_DISPATCH();                                \
-        }                                                               \
-    } while (0)
-#else
-#define HANDLE_OP_END() FETCH_OPCODE_AND_DISPATCH();
-#endif  
+#define HANDLE_OP_END() FETCH_OPCODE_AND_DISPATCH()
 #endif
 
 #else /* else of WASM_ENABLE_LABELS_AS_VALUES */
@@ -1162,31 +1181,7 @@ wasm_interp_call_func_import(WASMModuleInstance *module_inst,
     os_mutex_unlock(&exec_env->wait_lock);                         \
     continue
 #else
-#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
-#define HANDLE_OP_END()                                             \
-    SYNC_ALL_TO_FRAME();                                            \
-    if (!exec_env->is_restore) {                                    \
-        if (!exec_env->is_checkpoint && counter_ < SNAPSHOT_STEP) { \
-            counter_++;                                             \
-            continue;                                               \
-        }                                                           \
-        else {                                                      \
-            LOG_DEBUG("[%s:%d]\n", __FILE__, __LINE__);             \
-            counter_++;                                             \
-            if (counter_ > SNAPSHOT_STEP + SNAPSHOT_DEBUG_STEP) {   \
-                serialize_to_file(exec_env);                        \
-            }                                                       \
-        }                                                           \
-    }                                                               \
-    else {                                                          \
-        LOG_DEBUG("[%s:%d]\n", __FILE__, __LINE__);                 \
-        counter_++;                                                 \
-        continue;                                                   \
-    }
-#else
 #define HANDLE_OP_END() continue
-#endif
-
 #endif
 #endif /* end of WASM_ENABLE_LABELS_AS_VALUES */
 
@@ -1203,6 +1198,20 @@ get_global_addr(uint8 *global_data, WASMGlobalInstance *global)
 #endif
 }
 
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+static void
+do_checkpoint(WASMExecEnv *exec_env)
+{
+    /* Clear the request before serializing, so that a new request
+       arriving in the meantime is taken at the next safepoint */
+    WASM_SUSPEND_FLAGS_FETCH_AND(exec_env->suspend_flags,
+                                 ~WASM_SUSPEND_FLAG_CHECKPOINT);
+    exec_env->is_checkpoint = false;
+    counter_++;
+    serialize_to_file(exec_env);
+}
+#endif
+
 void
 wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                                WASMExecEnv *exec_env,
@@ -1442,6 +1451,24 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                     }
                     frame_ip = end_addr;
                 }
+#if WASM_ENABLE_FAST_JIT_OSR != 0
+                else if (frame_ip == (frame_csp - 1)->begin_addr
+                         && ++cur_func->u.func->fast_jit_hotness
+                                >= FAST_JIT_OSR_THRESHOLD) {
+                    /* Back-edge of a loop in a hot function, try to run the
+                       rest of the function with the jitted code */
+                    SYNC_ALL_TO_FRAME();
+                    if (fast_jit_osr(module, exec_env, cur_func, frame,
+                                     frame_ip)) {
+                        if (wasm_copy_exception(module, NULL))
+                            goto got_exception;
+                        /* The results have been copied to the previous
+                           frame */
+                        goto return_func;
+                    }
+                }
+#endif
+                CHECK_CHECKPOINT();
                 HANDLE_OP_END();
             }
 
@@ -1625,6 +1652,14 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_SIMD != 0
+            HANDLE_OP(WASM_OP_DROP_128)
+            {
+                frame_sp -= 4;
+                HANDLE_OP_END();
+            }
+#endif
+
             HANDLE_OP(WASM_OP_SELECT)
             {
                 cond = (uint32)POP_I32();
@@ -1645,6 +1680,18 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_SIMD != 0
+            HANDLE_OP(WASM_OP_SELECT_128)
+            {
+                cond = (uint32)POP_I32();
+                frame_sp -= 4;
+                if (!cond)
+                    bh_memcpy_s(frame_sp - 4, sizeof(V128), frame_sp,
+                                sizeof(V128));
+                HANDLE_OP_END();
+            }
+#endif
+
 #if WASM_ENABLE_REF_TYPES != 0
             HANDLE_OP(WASM_OP_SELECT_T)
             {
@@ -1662,6 +1709,14 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         *(frame_sp - 1) = *(frame_sp + 1);
                     }
                 }
+#if WASM_ENABLE_SIMD != 0
+                else if (type == VALUE_TYPE_V128) {
+                    frame_sp -= 4;
+                    if (!cond)
+                        bh_memcpy_s(frame_sp - 4, sizeof(V128), frame_sp,
+                                    sizeof(V128));
+                }
+#endif
                 else {
                     frame_sp--;
                     if (!cond)
@@ -1756,6 +1811,13 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                     case VALUE_TYPE_F64:
                         PUSH_I64(GET_I64_FROM_ADDR(frame_lp + local_offset));
                         break;
+#if WASM_ENABLE_SIMD != 0
+                    case VALUE_TYPE_V128:
+                        bh_memcpy_s(frame_sp, sizeof(V128),
+                                    frame_lp + local_offset, sizeof(V128));
+                        frame_sp += 4;
+                        break;
+#endif
                     default:
                         wasm_set_exception(module, "invalid local type");
                         goto got_exception;
@@ -1798,6 +1860,13 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         PUT_I64_TO_ADDR((uint32 *)(frame_lp + local_offset),
                                         POP_I64());
                         break;
+#if WASM_ENABLE_SIMD != 0
+                    case VALUE_TYPE_V128:
+                        frame_sp -= 4;
+                        bh_memcpy_s(frame_lp + local_offset, sizeof(V128),
+                                    frame_sp, sizeof(V128));
+                        break;
+#endif
                     default:
                         wasm_set_exception(module, "invalid local type");
                         goto got_exception;
@@ -1840,6 +1909,12 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         PUT_I64_TO_ADDR((uint32 *)(frame_lp + local_offset),
                                         GET_I64_FROM_ADDR(frame_sp - 2));
                         break;
+#if WASM_ENABLE_SIMD != 0
+                    case VALUE_TYPE_V128:
+                        bh_memcpy_s(frame_lp + local_offset, sizeof(V128),
+                                    frame_sp - 4, sizeof(V128));
+                        break;
+#endif
                     default:
                         wasm_set_exception(module, "invalid local type");
                         goto got_exception;
@@ -1881,6 +1956,19 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_SIMD != 0
+            HANDLE_OP(WASM_OP_GET_GLOBAL_128)
+            {
+                read_leb_uint32(frame_ip, frame_ip_end, global_idx);
+                bh_assert(global_idx < module->e->global_count);
+                global = globals + global_idx;
+                global_addr = get_global_addr(global_data, global);
+                bh_memcpy_s(frame_sp, sizeof(V128), global_addr, sizeof(V128));
+                frame_sp += 4;
+                HANDLE_OP_END();
+            }
+#endif
+
             HANDLE_OP(WASM_OP_SET_GLOBAL)
             {
                 read_leb_uint32(frame_ip, frame_ip_end, global_idx);
@@ -1937,6 +2025,19 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_SIMD != 0
+            HANDLE_OP(WASM_OP_SET_GLOBAL_128)
+            {
+                read_leb_uint32(frame_ip, frame_ip_end, global_idx);
+                bh_assert(global_idx < module->e->global_count);
+                global = globals + global_idx;
+                global_addr = get_global_addr(global_data, global);
+                frame_sp -= 4;
+                bh_memcpy_s(global_addr, sizeof(V128), frame_sp, sizeof(V128));
+                HANDLE_OP_END();
+            }
+#endif
+
             /* memory load instructions */
             HANDLE_OP(WASM_OP_I32_LOAD)
             HANDLE_OP(WASM_OP_F32_LOAD)
@@ -3522,6 +3623,252 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_SIMD != 0
+            HANDLE_OP(WASM_OP_SIMD_PREFIX)
+            {
+                uint32 offset, flags, addr, scalar[2], shift_count;
+                uint8 lane, *lanes;
+                V128 *vec;
+
+                opcode = *frame_ip++;
+
+                switch (opcode) {
+                    /* memory instructions */
+                    case SIMD_v128_load:
+                    case SIMD_v128_load8x8_s:
+                    case SIMD_v128_load8x8_u:
+                    case SIMD_v128_load16x4_s:
+                    case SIMD_v128_load16x4_u:
+                    case SIMD_v128_load32x2_s:
+                    case SIMD_v128_load32x2_u:
+                    case SIMD_v128_load8_splat:
+                    case SIMD_v128_load16_splat:
+                    case SIMD_v128_load32_splat:
+                    case SIMD_v128_load64_splat:
+                    case SIMD_v128_load32_zero:
+                    case SIMD_v128_load64_zero:
+                    {
+                        read_leb_uint32(frame_ip, frame_ip_end, flags);
+                        read_leb_uint32(frame_ip, frame_ip_end, offset);
+                        addr = POP_I32();
+                        CHECK_MEMORY_OVERFLOW(
+                            wasm_simd_mem_access_size(opcode));
+                        wasm_simd_load(opcode, maddr, (V128 *)frame_sp);
+                        frame_sp += 4;
+                        CHECK_READ_WATCHPOINT(addr, offset);
+                        (void)flags;
+                        break;
+                    }
+
+                    case SIMD_v128_store:
+                    {
+                        read_leb_uint32(frame_ip, frame_ip_end, flags);
+                        read_leb_uint32(frame_ip, frame_ip_end, offset);
+                        frame_sp -= 4;
+                        vec = (V128 *)frame_sp;
+                        addr = POP_I32();
+                        CHECK_MEMORY_OVERFLOW(16);
+                        bh_memcpy_s(maddr, sizeof(V128), vec, sizeof(V128));
+                        CHECK_WRITE_WATCHPOINT(addr, offset);
+                        (void)flags;
+                        break;
+                    }
+
+                    case SIMD_v128_load8_lane:
+                    case SIMD_v128_load16_lane:
+                    case SIMD_v128_load32_lane:
+                    case SIMD_v128_load64_lane:
+                    {
+                        V128 tmp;
+
+                        read_leb_uint32(frame_ip, frame_ip_end, flags);
+                        read_leb_uint32(frame_ip, frame_ip_end, offset);
+                        lane = *frame_ip++;
+                        frame_sp -= 4;
+                        bh_memcpy_s(&tmp, sizeof(V128), frame_sp,
+                                    sizeof(V128));
+                        addr = POP_I32();
+                        CHECK_MEMORY_OVERFLOW(
+                            wasm_simd_mem_access_size(opcode));
+                        wasm_simd_load_lane(opcode, maddr, lane, &tmp);
+                        bh_memcpy_s(frame_sp, sizeof(V128), &tmp,
+                                    sizeof(V128));
+                        frame_sp += 4;
+                        CHECK_READ_WATCHPOINT(addr, offset);
+                        (void)flags;
+                        break;
+                    }
+
+                    case SIMD_v128_store8_lane:
+                    case SIMD_v128_store16_lane:
+                    case SIMD_v128_store32_lane:
+                    case SIMD_v128_store64_lane:
+                    {
+                        read_leb_uint32(frame_ip, frame_ip_end, flags);
+                        read_leb_uint32(frame_ip, frame_ip_end, offset);
+                        lane = *frame_ip++;
+                        frame_sp -= 4;
+                        vec = (V128 *)frame_sp;
+                        addr = POP_I32();
+                        CHECK_MEMORY_OVERFLOW(
+                            wasm_simd_mem_access_size(opcode));
+                        wasm_simd_store_lane(opcode, maddr, lane, vec);
+                        CHECK_WRITE_WATCHPOINT(addr, offset);
+                        (void)flags;
+                        break;
+                    }
+
+                    /* basic operations */
+                    case SIMD_v128_const:
+                    {
+                        bh_memcpy_s(frame_sp, sizeof(V128), frame_ip,
+                                    sizeof(V128));
+                        frame_ip += sizeof(V128);
+                        frame_sp += 4;
+                        break;
+                    }
+
+                    case SIMD_v8x16_shuffle:
+                    {
+                        lanes = frame_ip;
+                        frame_ip += sizeof(V128);
+                        frame_sp -= 4;
+                        wasm_simd_shuffle((V128 *)(frame_sp - 4),
+                                          (V128 *)frame_sp, lanes,
+                                          (V128 *)(frame_sp - 4));
+                        break;
+                    }
+
+                    case SIMD_i8x16_splat:
+                    case SIMD_i16x8_splat:
+                    case SIMD_i32x4_splat:
+                    case SIMD_f32x4_splat:
+                    case SIMD_i64x2_splat:
+                    case SIMD_f64x2_splat:
+                    {
+                        if (opcode == SIMD_i64x2_splat
+                            || opcode == SIMD_f64x2_splat)
+                            frame_sp -= 2;
+                        else
+                            frame_sp--;
+                        wasm_simd_splat(opcode, frame_sp, (V128 *)frame_sp);
+                        frame_sp += 4;
+                        break;
+                    }
+
+                    /* lane operations */
+                    case SIMD_i8x16_extract_lane_s:
+                    case SIMD_i8x16_extract_lane_u:
+                    case SIMD_i16x8_extract_lane_s:
+                    case SIMD_i16x8_extract_lane_u:
+                    case SIMD_i32x4_extract_lane:
+                    case SIMD_f32x4_extract_lane:
+                    case SIMD_i64x2_extract_lane:
+                    case SIMD_f64x2_extract_lane:
+                    {
+                        V128 tmp;
+
+                        lane = *frame_ip++;
+                        frame_sp -= 4;
+                        bh_memcpy_s(&tmp, sizeof(V128), frame_sp,
+                                    sizeof(V128));
+                        wasm_simd_extract_lane(opcode, &tmp, lane, frame_sp);
+                        if (opcode == SIMD_i64x2_extract_lane
+                            || opcode == SIMD_f64x2_extract_lane)
+                            frame_sp += 2;
+                        else
+                            frame_sp++;
+                        break;
+                    }
+
+                    case SIMD_i8x16_replace_lane:
+                    case SIMD_i16x8_replace_lane:
+                    case SIMD_i32x4_replace_lane:
+                    case SIMD_f32x4_replace_lane:
+                    case SIMD_i64x2_replace_lane:
+                    case SIMD_f64x2_replace_lane:
+                    {
+                        lane = *frame_ip++;
+                        if (opcode == SIMD_i64x2_replace_lane
+                            || opcode == SIMD_f64x2_replace_lane) {
+                            frame_sp -= 2;
+                            scalar[1] = frame_sp[1];
+                        }
+                        else
+                            frame_sp--;
+                        scalar[0] = frame_sp[0];
+                        wasm_simd_replace_lane(opcode, lane, scalar,
+                                               (V128 *)(frame_sp - 4));
+                        break;
+                    }
+
+                    case SIMD_v128_bitselect:
+                    {
+                        frame_sp -= 8;
+                        wasm_simd_bitselect((V128 *)(frame_sp - 4),
+                                            (V128 *)frame_sp,
+                                            (V128 *)(frame_sp + 4),
+                                            (V128 *)(frame_sp - 4));
+                        break;
+                    }
+
+                    case SIMD_i8x16_shl:
+                    case SIMD_i8x16_shr_s:
+                    case SIMD_i8x16_shr_u:
+                    case SIMD_i16x8_shl:
+                    case SIMD_i16x8_shr_s:
+                    case SIMD_i16x8_shr_u:
+                    case SIMD_i32x4_shl:
+                    case SIMD_i32x4_shr_s:
+                    case SIMD_i32x4_shr_u:
+                    case SIMD_i64x2_shl:
+                    case SIMD_i64x2_shr_s:
+                    case SIMD_i64x2_shr_u:
+                    {
+                        shift_count = (uint32)POP_I32();
+                        wasm_simd_shift(opcode, (V128 *)(frame_sp - 4),
+                                        shift_count, (V128 *)(frame_sp - 4));
+                        break;
+                    }
+
+                    case SIMD_v128_any_true:
+                    case SIMD_i8x16_all_true:
+                    case SIMD_i8x16_bitmask:
+                    case SIMD_i16x8_all_true:
+                    case SIMD_i16x8_bitmask:
+                    case SIMD_i32x4_all_true:
+                    case SIMD_i32x4_bitmask:
+                    case SIMD_i64x2_all_true:
+                    case SIMD_i64x2_bitmask:
+                    {
+                        int32 reduced;
+
+                        frame_sp -= 4;
+                        reduced = wasm_simd_reduce(opcode, (V128 *)frame_sp);
+                        PUSH_I32(reduced);
+                        break;
+                    }
+
+                    default:
+                    {
+                        if (wasm_simd_is_unary_op(opcode)) {
+                            wasm_simd_unary_op(opcode, (V128 *)(frame_sp - 4),
+                                               (V128 *)(frame_sp - 4));
+                        }
+                        else {
+                            frame_sp -= 4;
+                            wasm_simd_binary_op(opcode,
+                                                (V128 *)(frame_sp - 4),
+                                                (V128 *)frame_sp,
+                                                (V128 *)(frame_sp - 4));
+                        }
+                        break;
+                    }
+                }
+                HANDLE_OP_END();
+            }
+#endif /* end of WASM_ENABLE_SIMD != 0 */
+
 #if WASM_ENABLE_SHARED_MEMORY != 0
             HANDLE_OP(WASM_OP_ATOMIC_PREFIX)
             {
@@ -3917,6 +4264,13 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 #if WASM_ENABLE_SHARED_MEMORY == 0
         HANDLE_OP(WASM_OP_ATOMIC_PREFIX)
 #endif
+#if WASM_ENABLE_SIMD == 0
+        HANDLE_OP(WASM_OP_SIMD_PREFIX)
+        HANDLE_OP(WASM_OP_DROP_128)
+        HANDLE_OP(WASM_OP_SELECT_128)
+        HANDLE_OP(WASM_OP_GET_GLOBAL_128)
+        HANDLE_OP(WASM_OP_SET_GLOBAL_128)
+#endif
 #if WASM_ENABLE_REF_TYPES == 0
         HANDLE_OP(WASM_OP_SELECT_T)
         HANDLE_OP(WASM_OP_TABLE_GET)
@@ -3937,7 +4291,25 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
         HANDLE_OP(EXT_OP_TEE_LOCAL_FAST_I64)
         HANDLE_OP(EXT_OP_COPY_STACK_TOP)
         HANDLE_OP(EXT_OP_COPY_STACK_TOP_I64)
+        HANDLE_OP(EXT_OP_COPY_STACK_TOP_V128)
         HANDLE_OP(EXT_OP_COPY_STACK_VALUES)
+        HANDLE_OP(EXT_OP_I32_EQZ_BR_IF)
+        HANDLE_OP(EXT_OP_I32_EQ_BR_IF)
+        HANDLE_OP(EXT_OP_I32_NE_BR_IF)
+        HANDLE_OP(EXT_OP_I32_LT_S_BR_IF)
+        HANDLE_OP(EXT_OP_I32_LT_U_BR_IF)
+        HANDLE_OP(EXT_OP_I32_GT_S_BR_IF)
+        HANDLE_OP(EXT_OP_I32_GT_U_BR_IF)
+        HANDLE_OP(EXT_OP_I32_LE_S_BR_IF)
+        HANDLE_OP(EXT_OP_I32_LE_U_BR_IF)
+        HANDLE_OP(EXT_OP_I32_GE_S_BR_IF)
+        HANDLE_OP(EXT_OP_I32_GE_U_BR_IF)
+        HANDLE_OP(EXT_OP_TEE_LOCAL_FAST_BR_IF)
+        HANDLE_OP(EXT_OP_I32_ADD_LOAD)
+        HANDLE_OP(EXT_OP_I32_ADD_BR_IF)
+        HANDLE_OP(EXT_OP_I32_ADD_NE_BR_IF)
+        HANDLE_OP(EXT_OP_I32_ADD_LT_S_BR_IF)
+        HANDLE_OP(EXT_OP_I32_ADD_LT_U_BR_IF)
         {
             wasm_set_exception(module, "unsupported opcode");
             goto got_exception;
@@ -3971,6 +4343,29 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
         if (cur_func->param_cell_num > 0) {
             word_copy(outs_area->lp, frame_sp, cur_func->param_cell_num);
         }
+#if WASM_ENABLE_FAST_JIT_OSR != 0
+        if (!cur_func->is_import_func
+            && cur_func->u.func->fast_jit_jitted_code) {
+            /* The callee has been tiered up, call its jitted code */
+            fast_jit_call_func_bytecode(module, exec_env, cur_func, frame);
+
+            cur_func = frame->function;
+            UPDATE_ALL_FROM_FRAME();
+
+            /* update memory size, no need to update memory ptr as
+               it isn't changed in wasm_enlarge_memory */
+#if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
+    || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
+    || WASM_ENABLE_BULK_MEMORY != 0
+            if (memory)
+                linear_mem_size = memory->memory_data_size;
+#endif
+            if (wasm_copy_exception(module, NULL))
+                goto got_exception;
+            CHECK_CHECKPOINT();
+            HANDLE_OP_END();
+        }
+#endif
         prev_frame = frame;
     }
 
@@ -4058,6 +4453,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 #if WASM_ENABLE_THREAD_MGR != 0
         CHECK_SUSPEND_FLAGS();
 #endif
+        CHECK_CHECKPOINT();
         HANDLE_OP_END();
     }
 
@@ -4069,18 +4465,8 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
         if (!prev_frame->ip)
             /* Called from native. */
             return;
-#if WASM_ENABLE_CHECKPOINT_RESTORE!=0
-        // LOG_DEBUG("return_func: %s %p",
-        //           prev_frame->function->u.func->field_name, prev_frame);
-        // if (func_to_stop && !strcmp(prev_frame->function->u.func->field_name, func_to_stop) ) {
-        //     if (func_to_stop_count > func_count_) {
-        //         func_count_++;
-        //     }else {
-        //         counter_ = INT_MAX;
-        //     }
-        // }
-#endif
         RECOVER_CONTEXT(prev_frame);
+        CHECK_CHECKPOINT();
         HANDLE_OP_END();
     }
 
@@ -4118,6 +4504,46 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 }
 
 #if WASM_ENABLE_FAST_JIT != 0
+/**
+ * The jitted code returns the first result of the function in
+ * info->out.ret, and the other results in the frame of the caller.
+ * Copy the first result to the frame of the caller, whose sp has already
+ * been moved past the results by the jitted code.
+ */
+static void
+fast_jit_copy_ret_value(WASMFunctionInstance *function, uint8 type,
+                        const JitInterpSwitchInfo *info, uint32 *frame_sp)
+{
+    uint32 *ret = frame_sp - function->ret_cell_num;
+
+    switch (type) {
+        case VALUE_TYPE_VOID:
+            break;
+        case VALUE_TYPE_I32:
+            *ret = info->out.ret.ival[0];
+            break;
+        case VALUE_TYPE_I64:
+            *ret = info->out.ret.ival[0];
+            *(ret + 1) = info->out.ret.ival[1];
+            break;
+        case VALUE_TYPE_F32:
+            *ret = info->out.ret.fval[0];
+            break;
+        case VALUE_TYPE_F64:
+            *ret = info->out.ret.fval[0];
+            *(ret + 1) = info->out.ret.fval[1];
+            break;
+#if WASM_ENABLE_SIMD != 0
+        case VALUE_TYPE_V128:
+            /* The jitted code has stored it to the frame */
+            break;
+#endif
+        default:
+            bh_assert(0);
+            break;
+    }
+}
+
 /*
  * ASAN is not designed to work with custom stack unwind or other low-level
  * things. Ignore a function that does some low-level magic. (e.g. walking
@@ -4169,33 +4595,102 @@ fast_jit_call_func_bytecode(WASMModuleInstance *module_inst,
                   && wasm_copy_exception(
                       (WASMModuleInstance *)exec_env->module_inst, NULL)));
 
-    /* Get the return values form info.out.ret */
-    if (func_type->result_count) {
-        switch (type) {
-            case VALUE_TYPE_I32:
-                *(frame->sp - function->ret_cell_num) = info.out.ret.ival[0];
-                break;
-            case VALUE_TYPE_I64:
-                *(frame->sp - function->ret_cell_num) = info.out.ret.ival[0];
-                *(frame->sp - function->ret_cell_num + 1) =
-                    info.out.ret.ival[1];
-                break;
-            case VALUE_TYPE_F32:
-                *(frame->sp - function->ret_cell_num) = info.out.ret.fval[0];
-                break;
-            case VALUE_TYPE_F64:
-                *(frame->sp - function->ret_cell_num) = info.out.ret.fval[0];
-                *(frame->sp - function->ret_cell_num + 1) =
-                    info.out.ret.fval[1];
-                break;
-            default:
-                bh_assert(0);
-                break;
+    fast_jit_copy_ret_value(function, type, &info, frame->sp);
+    (void)action;
+    (void)func_idx;
+}
+
+#if WASM_ENABLE_FAST_JIT_OSR != 0
+/**
+ * On-stack replacement: continue to run a hot loop of the interpreter
+ * frame with the jitted code of the function. The frame layout of the
+ * classic interpreter is the same as that of the jitted code, and all the
+ * values are in the frame at the loop header, so the jitted code enters
+ * the loop with the frame directly. When the function returns, the jitted
+ * code stores the results except the first one to the previous frame,
+ * and the first one is copied from the switch info like a call of the
+ * jitted function.
+ *
+ * @return true if the rest of the function was run by the jitted code,
+ *         false if the interpreter should continue to run it
+ */
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((no_sanitize_address))
+#endif
+static bool
+fast_jit_osr(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
+             WASMFunctionInstance *function, WASMInterpFrame *frame,
+             const uint8 *ip)
+{
+    JitGlobals *jit_globals = jit_compiler_get_jit_globals();
+    JitInterpSwitchInfo info;
+    WASMInterpFrame *prev_frame = frame->prev_frame;
+    WASMFunction *func = function->u.func;
+    WASMType *func_type = func->func_type;
+    uint8 type = func_type->result_count
+                     ? func_type->types[func_type->param_count]
+                     : VALUE_TYPE_VOID;
+    uint32 func_idx = (uint32)(function - module_inst->e->functions);
+    uint8 *frame_end;
+    void *jitted_addr = NULL;
+    uint32 i;
+    int32 action;
+
+#if WASM_ENABLE_LAZY_JIT != 0
+    if (func->fast_jit_hotness == FAST_JIT_OSR_THRESHOLD)
+        /* Just got hot, compile it before the other functions */
+        jit_compiler_add_hot_function(module_inst->module, func_idx);
+#endif
+    /* Stop counting, the counter is only checked against the threshold */
+    func->fast_jit_hotness = FAST_JIT_OSR_THRESHOLD + 1;
+
+    if (!func->fast_jit_jitted_code)
+        return false;
+    os_atomic_thread_fence(os_memory_order_acquire);
+
+    for (i = 0; i < func->fast_jit_osr_entry_count; i++) {
+        if (func->fast_jit_osr_entries[i].ip == ip) {
+            jitted_addr = func->fast_jit_osr_entries[i].jitted_addr;
+            break;
         }
     }
+    if (!jitted_addr)
+        return false;
+
+    /* The frame of the jitted code may be larger than the interpreter
+       frame, and the frames of its callees are placed right after it,
+       check the stack space like the prologue of the jitted code */
+    frame_end = (uint8 *)frame + func->fast_jit_frame_size;
+    if (frame_end + func->fast_jit_frame_size
+        > exec_env->wasm_stack.s.top_boundary)
+        return false;
+    exec_env->wasm_stack.s.top = frame_end;
+
+#if WASM_ENABLE_REF_TYPES != 0
+    if (type == VALUE_TYPE_EXTERNREF || type == VALUE_TYPE_FUNCREF)
+        type = VALUE_TYPE_I32;
+#endif
+
+    /* Switch to the jitted code at the loop header, it returns to the
+       interpreter when the function returns */
+    info.out.ret.last_return_type = type;
+    info.frame = frame;
+    prev_frame->jitted_return_addr =
+        (uint8 *)jit_globals->return_to_interp_from_jitted;
+    action = jit_interp_switch_to_jitted(exec_env, &info, func_idx,
+                                         jitted_addr);
+    bh_assert(action == JIT_INTERP_ACTION_NORMAL
+              || (action == JIT_INTERP_ACTION_THROWN
+                  && wasm_copy_exception(
+                      (WASMModuleInstance *)exec_env->module_inst, NULL)));
+
+    /* Like a call of the jitted function, the first result is returned
+       in info.out.ret and the others in the previous frame */
+    fast_jit_copy_ret_value(function, type, &info, prev_frame->sp);
     (void)action;
-    (void)func_idx;
+    return true;
 }
+#endif /* end of WASM_ENABLE_FAST_JIT_OSR != 0 */
 #endif /* end of WASM_ENABLE_FAST_JIT != 0 */
 
 #if WASM_ENABLE_JIT != 0
@@ -8,6 +8,9 @@
 #include "wasm_runtime.h"
 #include "wasm_opcode.h"
 #include "wasm_loader.h"
+#if WASM_ENABLE_SIMD != 0
+#include "wasm_simd.h"
+#endif
 #include "wasm_memory.h"
 #include "../common/wasm_exec_env.h"
 #if WASM_ENABLE_SHARED_MEMORY != 0
@@ -428,6 +431,35 @@ LOAD_PTR(void *addr)
         frame_ip += 6;                                               \
     } while (0)
 
+#if WASM_ENABLE_THREAD_MGR != 0
+#define CHECK_SUSPEND_FLAGS_OF_BR() CHECK_SUSPEND_FLAGS()
+#else
+#define CHECK_SUSPEND_FLAGS_OF_BR() (void)0
+#endif
+
+/* Superinstruction of i32 compare and br_if */
+#define DEF_OP_CMP_BR_IF(src_type, cond_op)   \
+    do {                                      \
+        src_type val1, val2;                  \
+        CHECK_SUSPEND_FLAGS_OF_BR();          \
+        val1 = GET_OPERAND(src_type, I32, 2); \
+        val2 = GET_OPERAND(src_type, I32, 0); \
+        frame_ip += 4;                        \
+        if (val1 cond_op val2)                \
+            goto recover_br_info;             \
+        SKIP_BR_INFO();                       \
+    } while (0)
+
+/* Superinstruction of i32.add, i32 compare and br_if */
+#define DEF_OP_ADD_CMP_BR_IF(src_type, cond_op)         \
+    do {                                                \
+        SET_OPERAND(I32, 4,                             \
+                    GET_OPERAND(uint32, I32, 2)         \
+                        + GET_OPERAND(uint32, I32, 0)); \
+        frame_ip += 6;                                  \
+        DEF_OP_CMP_BR_IF(src_type, cond_op);            \
+    } while (0)
+
 #define DEF_OP_BIT_COUNT(src_type, src_op_type, operation)               \
     do {                                                                 \
         SET_OPERAND(                                                     \
@@ -740,10 +772,14 @@ copy_stack_values(WASMModuleInstance *module, uint32 *frame_lp, uint32 arity,
         src = src_offsets[i];
         if (cell == 1)
             tmp_buf[buf_index] = frame_lp[src];
-        else {
+        else if (cell == 2) {
             tmp_buf[buf_index] = frame_lp[src];
             tmp_buf[buf_index + 1] = frame_lp[src + 1];
         }
+        else {
+            bh_memcpy_s(tmp_buf + buf_index, sizeof(uint32) * cell,
+                        frame_lp + src, sizeof(uint32) * cell);
+        }
         buf_index += cell;
     }
 
@@ -754,10 +790,14 @@ copy_stack_values(WASMModuleInstance *module, uint32 *frame_lp, uint32 arity,
         dst = dst_offsets[i];
         if (cell == 1)
             frame_lp[dst] = tmp_buf[buf_index];
-        else {
+        else if (cell == 2) {
             frame_lp[dst] = tmp_buf[buf_index];
             frame_lp[dst + 1] = tmp_buf[buf_index + 1];
         }
+        else {
+            bh_memcpy_s(frame_lp + dst, sizeof(uint32) * cell,
+                        tmp_buf + buf_index, sizeof(uint32) * cell);
+        }
         buf_index += cell;
     }
 
@@ -797,6 +837,11 @@ copy_stack_values(WASMModuleInstance *module, uint32 *frame_lp, uint32 arity,
                     frame_lp[dst_offsets[0] + 1] =                          \
                         frame_lp[src_offsets[0] + 1];                       \
                 }                                                           \
+                else if (cells[0] == 4) {                                   \
+                    /* the v128 slots may overlap */                        \
+                    bh_memmove_s(frame_lp + dst_offsets[0], sizeof(V128),   \
+                                 frame_lp + src_offsets[0], sizeof(V128));  \
+                }                                                           \
             }                                                               \
             else {                                                          \
                 if (!copy_stack_values(module, frame_lp, arity, total_cell, \
@@ -918,7 +963,7 @@ wasm_interp_call_func_native(WASMModuleInstance *module_inst,
     CApiFuncImport *c_api_func_import = NULL;
     unsigned local_cell_num = 2;
     WASMInterpFrame *frame;
-    uint32 argv_ret[2], cur_func_index;
+    uint32 argv_ret[4], cur_func_index;
     void *native_func_pointer = NULL;
     bool ret;
 
@@ -986,6 +1031,12 @@ wasm_interp_call_func_native(WASMModuleInstance *module_inst,
         prev_frame->lp[prev_frame->ret_offset] = argv_ret[0];
         prev_frame->lp[prev_frame->ret_offset + 1] = argv_ret[1];
     }
+#if WASM_ENABLE_SIMD != 0
+    else if (cur_func->ret_cell_num == 4) {
+        bh_memcpy_s(prev_frame->lp + prev_frame->ret_offset, sizeof(V128),
+                    argv_ret, sizeof(V128));
+    }
+#endif
 
     FREE_FRAME(exec_env, frame);
     wasm_exec_env_set_cur_frame(exec_env, prev_frame);
@@ -1089,20 +1140,67 @@ DEFINE_GOTO_TABLE(OpcodeInfo, opcode_table);
 #undef HANDLE_OPCODE
 /* clang-format on */
 
+/* The dispatch count of each pair of adjacent opcodes, the frequent pairs
+   are the candidates of the superinstructions fused by the loader */
+static uint64 opcode_pair_table[WASM_INSTRUCTION_NUM][WASM_INSTRUCTION_NUM];
+static uint8 last_counted_opcode;
+
+/* The number of the most frequent opcode pairs to dump */
+#define OPCODE_PAIR_DUMP_NUM 30
+
+static inline void
+count_opcode(uint8 opcode)
+{
+    opcode_table[opcode].count++;
+    opcode_pair_table[last_counted_opcode][opcode]++;
+    last_counted_opcode = opcode;
+}
+
+static void
+wasm_interp_dump_op_pair_count(uint64 total_count)
+{
+    bool dumped[WASM_INSTRUCTION_NUM][WASM_INSTRUCTION_NUM] = { 0 };
+    uint32 i, j, n, max_i, max_j;
+    uint64 max_count;
+
+    printf("top opcode pairs:\n");
+    for (n = 0; n < OPCODE_PAIR_DUMP_NUM; n++) {
+        max_count = max_i = max_j = 0;
+        for (i = 0; i < WASM_INSTRUCTION_NUM; i++)
+            for (j = 0; j < WASM_INSTRUCTION_NUM; j++)
+                if (!dumped[i][j] && opcode_pair_table[i][j] > max_count) {
+                    max_count = opcode_pair_table[i][j];
+                    max_i = i;
+                    max_j = j;
+                }
+        if (max_count == 0)
+            break;
+
+        dumped[max_i][max_j] = true;
+        printf("\t\t%s %s count:\t\t%" PRIu64 ",\t\t%.2f%%\n",
+               opcode_table[max_i].name, opcode_table[max_j].name, max_count,
+               max_count * 100.0f / total_count);
+    }
+}
+
 static void
 wasm_interp_dump_op_count()
 {
     uint32 i;
     uint64 total_count = 0;
-    for (i = 0; i < WASM_OP_IMPDEP; i++)
+    for (i = 0; i < WASM_INSTRUCTION_NUM; i++)
         total_count += opcode_table[i].count;
 
     printf("total opcode count: %ld\n", total_count);
-    for (i = 0; i < WASM_OP_IMPDEP; i++)
-        if (opcode_table[i].count > 0)
+    /* include the ext ops emitted by the loader */
+    for (i = 0; i < WASM_INSTRUCTION_NUM; i++)
+        if (opcode_table[i].name && opcode_table[i].count > 0)
             printf("\t\t%s count:\t\t%ld,\t\t%.2f%%\n", opcode_table[i].name,
                    opcode_table[i].count,
                    opcode_table[i].count * 100.0f / total_count);
+
+    if (total_count > 0)
+        wasm_interp_dump_op_pair_count(total_count);
 }
 #endif
 
@@ -1110,7 +1208,7 @@ wasm_interp_dump_op_count()
 
 /* #define HANDLE_OP(opcode) HANDLE_##opcode:printf(#opcode"\n"); */
 #if WASM_ENABLE_OPCODE_COUNTER != 0
-#define HANDLE_OP(opcode) HANDLE_##opcode : opcode_table[opcode].count++;
+#define HANDLE_OP(opcode) HANDLE_##opcode : count_opcode(opcode);
 #else
 #define HANDLE_OP(opcode) HANDLE_##opcode:
 #endif
@@ -1293,6 +1391,137 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+            /* Superinstructions fused with br_if by the loader */
+            HANDLE_OP(EXT_OP_I32_EQZ_BR_IF)
+            {
+                CHECK_SUSPEND_FLAGS_OF_BR();
+                cond = frame_lp[GET_OFFSET()];
+
+                if (!cond)
+                    goto recover_br_info;
+                else
+                    SKIP_BR_INFO();
+
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_EQ_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, ==);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_NE_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, !=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LT_S_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(int32, <);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LT_U_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, <);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_GT_S_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(int32, >);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_GT_U_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, >);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LE_S_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(int32, <=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LE_U_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, <=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_GE_S_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(int32, >=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_GE_U_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, >=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_TEE_LOCAL_FAST_BR_IF)
+            {
+                CHECK_SUSPEND_FLAGS_OF_BR();
+#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
+                local_offset = *frame_ip++;
+#else
+        /* clang-format off */
+                local_offset = *frame_ip;
+                frame_ip += 2;
+        /* clang-format on */
+#endif
+                cond = GET_OPERAND(uint32, I32, 0);
+                frame_ip += 2;
+                *(uint32 *)(frame_lp + local_offset) = cond;
+
+                if (cond)
+                    goto recover_br_info;
+                else
+                    SKIP_BR_INFO();
+
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_ADD_BR_IF)
+            {
+                CHECK_SUSPEND_FLAGS_OF_BR();
+                cond = GET_OPERAND(uint32, I32, 2)
+                       + GET_OPERAND(uint32, I32, 0);
+                SET_OPERAND(I32, 4, cond);
+                frame_ip += 6;
+
+                if (cond)
+                    goto recover_br_info;
+                else
+                    SKIP_BR_INFO();
+
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_ADD_NE_BR_IF)
+            {
+                DEF_OP_ADD_CMP_BR_IF(uint32, !=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_ADD_LT_S_BR_IF)
+            {
+                DEF_OP_ADD_CMP_BR_IF(int32, <);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_ADD_LT_U_BR_IF)
+            {
+                DEF_OP_ADD_CMP_BR_IF(uint32, <);
+                HANDLE_OP_END();
+            }
+
             HANDLE_OP(WASM_OP_BR_TABLE)
             {
                 uint32 arity, br_item_size;
@@ -1350,6 +1579,14 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                                         GET_OPERAND(uint64, I64, off));
                         ret_offset += 2;
                     }
+#if WASM_ENABLE_SIMD != 0
+                    else if (ret_types[ret_idx] == VALUE_TYPE_V128) {
+                        bh_memcpy_s(prev_frame->lp + ret_offset, sizeof(V128),
+                                    frame_lp + *(int16 *)(frame_ip + off),
+                                    sizeof(V128));
+                        ret_offset += 4;
+                    }
+#endif
                     else {
                         prev_frame->lp[ret_offset] =
                             GET_OPERAND(uint32, I32, off);
@@ -1466,6 +1703,28 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_SIMD != 0
+            HANDLE_OP(WASM_OP_SELECT_128)
+            {
+                cond = frame_lp[GET_OFFSET()];
+                addr1 = GET_OFFSET();
+                addr2 = GET_OFFSET();
+                addr_ret = GET_OFFSET();
+
+                if (!cond) {
+                    if (addr_ret != addr1)
+                        bh_memmove_s(frame_lp + addr_ret, sizeof(V128),
+                                     frame_lp + addr1, sizeof(V128));
+                }
+                else {
+                    if (addr_ret != addr2)
+                        bh_memmove_s(frame_lp + addr_ret, sizeof(V128),
+                                     frame_lp + addr2, sizeof(V128));
+                }
+                HANDLE_OP_END();
+            }
+#endif
+
 #if WASM_ENABLE_REF_TYPES != 0
             HANDLE_OP(WASM_OP_TABLE_GET)
             {
@@ -1588,6 +1847,20 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_SIMD != 0
+            HANDLE_OP(WASM_OP_GET_GLOBAL_128)
+            {
+                global_idx = read_uint32(frame_ip);
+                bh_assert(global_idx < module->e->global_count);
+                global = globals + global_idx;
+                global_addr = get_global_addr(global_data, global);
+                addr_ret = GET_OFFSET();
+                bh_memcpy_s(frame_lp + addr_ret, sizeof(V128), global_addr,
+                            sizeof(V128));
+                HANDLE_OP_END();
+            }
+#endif
+
             HANDLE_OP(WASM_OP_SET_GLOBAL)
             {
                 global_idx = read_uint32(frame_ip);
@@ -1641,6 +1914,20 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_SIMD != 0
+            HANDLE_OP(WASM_OP_SET_GLOBAL_128)
+            {
+                global_idx = read_uint32(frame_ip);
+                bh_assert(global_idx < module->e->global_count);
+                global = globals + global_idx;
+                global_addr = get_global_addr(global_data, global);
+                addr1 = GET_OFFSET();
+                bh_memcpy_s(global_addr, sizeof(V128), frame_lp + addr1,
+                            sizeof(V128));
+                HANDLE_OP_END();
+            }
+#endif
+
             /* memory load instructions */
             HANDLE_OP(WASM_OP_I32_LOAD)
             {
@@ -1654,6 +1941,20 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+            /* Superinstruction of i32.add and i32.load */
+            HANDLE_OP(EXT_OP_I32_ADD_LOAD)
+            {
+                uint32 offset, addr;
+                addr = GET_OPERAND(uint32, I32, 2)
+                       + GET_OPERAND(uint32, I32, 0);
+                frame_ip += 4;
+                offset = read_uint32(frame_ip);
+                addr_ret = GET_OFFSET();
+                CHECK_MEMORY_OVERFLOW(4);
+                frame_lp[addr_ret] = LOAD_I32(maddr);
+                HANDLE_OP_END();
+            }
+
             HANDLE_OP(WASM_OP_I64_LOAD)
             {
                 uint32 offset, addr;
@@ -2862,6 +3163,17 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_SIMD != 0
+            HANDLE_OP(EXT_OP_COPY_STACK_TOP_V128)
+            {
+                addr1 = GET_OFFSET();
+                addr2 = GET_OFFSET();
+                bh_memmove_s(frame_lp + addr2, sizeof(V128), frame_lp + addr1,
+                             sizeof(V128));
+                HANDLE_OP_END();
+            }
+#endif
+
             HANDLE_OP(EXT_OP_COPY_STACK_VALUES)
             {
                 uint32 values_count, total_cell;
@@ -3271,6 +3583,251 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_SIMD != 0
+            HANDLE_OP(WASM_OP_SIMD_PREFIX)
+            {
+                uint32 offset, addr, scalar[2];
+                int16 addr3;
+                uint8 lane, *lanes;
+
+                GET_OPCODE();
+
+                switch (opcode) {
+                    /* memory instructions */
+                    case SIMD_v128_load:
+                    case SIMD_v128_load8x8_s:
+                    case SIMD_v128_load8x8_u:
+                    case SIMD_v128_load16x4_s:
+                    case SIMD_v128_load16x4_u:
+                    case SIMD_v128_load32x2_s:
+                    case SIMD_v128_load32x2_u:
+                    case SIMD_v128_load8_splat:
+                    case SIMD_v128_load16_splat:
+                    case SIMD_v128_load32_splat:
+                    case SIMD_v128_load64_splat:
+                    case SIMD_v128_load32_zero:
+                    case SIMD_v128_load64_zero:
+                    {
+                        offset = read_uint32(frame_ip);
+                        addr = POP_I32();
+                        addr_ret = GET_OFFSET();
+                        CHECK_MEMORY_OVERFLOW(
+                            wasm_simd_mem_access_size(opcode));
+                        wasm_simd_load(opcode, maddr,
+                                       (V128 *)(frame_lp + addr_ret));
+                        break;
+                    }
+
+                    case SIMD_v128_store:
+                    {
+                        offset = read_uint32(frame_ip);
+                        addr1 = GET_OFFSET();
+                        addr = POP_I32();
+                        CHECK_MEMORY_OVERFLOW(16);
+                        bh_memcpy_s(maddr, sizeof(V128), frame_lp + addr1,
+                                    sizeof(V128));
+                        break;
+                    }
+
+                    case SIMD_v128_load8_lane:
+                    case SIMD_v128_load16_lane:
+                    case SIMD_v128_load32_lane:
+                    case SIMD_v128_load64_lane:
+                    {
+                        offset = read_uint32(frame_ip);
+                        lane = *frame_ip;
+                        frame_ip += CELL_SIZE;
+                        addr1 = GET_OFFSET();
+                        addr = POP_I32();
+                        addr_ret = GET_OFFSET();
+                        CHECK_MEMORY_OVERFLOW(
+                            wasm_simd_mem_access_size(opcode));
+                        if (addr_ret != addr1)
+                            bh_memmove_s(frame_lp + addr_ret, sizeof(V128),
+                                         frame_lp + addr1, sizeof(V128));
+                        wasm_simd_load_lane(opcode, maddr, lane,
+                                            (V128 *)(frame_lp + addr_ret));
+                        break;
+                    }
+
+                    case SIMD_v128_store8_lane:
+                    case SIMD_v128_store16_lane:
+                    case SIMD_v128_store32_lane:
+                    case SIMD_v128_store64_lane:
+                    {
+                        offset = read_uint32(frame_ip);
+                        lane = *frame_ip;
+                        frame_ip += CELL_SIZE;
+                        addr1 = GET_OFFSET();
+                        addr = POP_I32();
+                        CHECK_MEMORY_OVERFLOW(
+                            wasm_simd_mem_access_size(opcode));
+                        wasm_simd_store_lane(opcode, maddr, lane,
+                                             (V128 *)(frame_lp + addr1));
+                        break;
+                    }
+
+                    /* basic operations */
+                    case SIMD_v128_const:
+                    {
+                        uint8 *orig_ip = frame_ip;
+
+                        frame_ip += sizeof(V128);
+                        addr_ret = GET_OFFSET();
+                        bh_memcpy_s(frame_lp + addr_ret, sizeof(V128),
+                                    orig_ip, sizeof(V128));
+                        break;
+                    }
+
+                    case SIMD_v8x16_shuffle:
+                    {
+                        lanes = frame_ip;
+                        frame_ip += sizeof(V128);
+                        addr2 = GET_OFFSET();
+                        addr1 = GET_OFFSET();
+                        addr_ret = GET_OFFSET();
+                        wasm_simd_shuffle((V128 *)(frame_lp + addr1),
+                                          (V128 *)(frame_lp + addr2), lanes,
+                                          (V128 *)(frame_lp + addr_ret));
+                        break;
+                    }
+
+                    case SIMD_i8x16_splat:
+                    case SIMD_i16x8_splat:
+                    case SIMD_i32x4_splat:
+                    case SIMD_i64x2_splat:
+                    case SIMD_f32x4_splat:
+                    case SIMD_f64x2_splat:
+                    {
+                        addr1 = GET_OFFSET();
+                        addr_ret = GET_OFFSET();
+                        wasm_simd_splat(opcode, frame_lp + addr1,
+                                        (V128 *)(frame_lp + addr_ret));
+                        break;
+                    }
+
+                    /* lane operations */
+                    case SIMD_i8x16_extract_lane_s:
+                    case SIMD_i8x16_extract_lane_u:
+                    case SIMD_i16x8_extract_lane_s:
+                    case SIMD_i16x8_extract_lane_u:
+                    case SIMD_i32x4_extract_lane:
+                    case SIMD_i64x2_extract_lane:
+                    case SIMD_f32x4_extract_lane:
+                    case SIMD_f64x2_extract_lane:
+                    {
+                        lane = *frame_ip;
+                        frame_ip += CELL_SIZE;
+                        addr1 = GET_OFFSET();
+                        addr_ret = GET_OFFSET();
+                        wasm_simd_extract_lane(opcode,
+                                               (V128 *)(frame_lp + addr1),
+                                               lane, frame_lp + addr_ret);
+                        break;
+                    }
+
+                    case SIMD_i8x16_replace_lane:
+                    case SIMD_i16x8_replace_lane:
+                    case SIMD_i32x4_replace_lane:
+                    case SIMD_i64x2_replace_lane:
+                    case SIMD_f32x4_replace_lane:
+                    case SIMD_f64x2_replace_lane:
+                    {
+                        lane = *frame_ip;
+                        frame_ip += CELL_SIZE;
+                        addr2 = GET_OFFSET();
+                        addr1 = GET_OFFSET();
+                        addr_ret = GET_OFFSET();
+                        /* read the scalar first as the result slots may
+                           overlap with it */
+                        scalar[0] = frame_lp[addr2];
+                        scalar[1] = frame_lp[addr2 + 1];
+                        if (addr_ret != addr1)
+                            bh_memmove_s(frame_lp + addr_ret, sizeof(V128),
+                                         frame_lp + addr1, sizeof(V128));
+                        wasm_simd_replace_lane(opcode, lane, scalar,
+                                               (V128 *)(frame_lp + addr_ret));
+                        break;
+                    }
+
+                    case SIMD_v128_bitselect:
+                    {
+                        addr3 = GET_OFFSET();
+                        addr2 = GET_OFFSET();
+                        addr1 = GET_OFFSET();
+                        addr_ret = GET_OFFSET();
+                        wasm_simd_bitselect((V128 *)(frame_lp + addr1),
+                                            (V128 *)(frame_lp + addr2),
+                                            (V128 *)(frame_lp + addr3),
+                                            (V128 *)(frame_lp + addr_ret));
+                        break;
+                    }
+
+                    case SIMD_i8x16_shl:
+                    case SIMD_i8x16_shr_s:
+                    case SIMD_i8x16_shr_u:
+                    case SIMD_i16x8_shl:
+                    case SIMD_i16x8_shr_s:
+                    case SIMD_i16x8_shr_u:
+                    case SIMD_i32x4_shl:
+                    case SIMD_i32x4_shr_s:
+                    case SIMD_i32x4_shr_u:
+                    case SIMD_i64x2_shl:
+                    case SIMD_i64x2_shr_s:
+                    case SIMD_i64x2_shr_u:
+                    {
+                        uint32 shift_count = (uint32)POP_I32();
+
+                        addr1 = GET_OFFSET();
+                        addr_ret = GET_OFFSET();
+                        wasm_simd_shift(opcode, (V128 *)(frame_lp + addr1),
+                                        shift_count,
+                                        (V128 *)(frame_lp + addr_ret));
+                        break;
+                    }
+
+                    case SIMD_v128_any_true:
+                    case SIMD_i8x16_all_true:
+                    case SIMD_i8x16_bitmask:
+                    case SIMD_i16x8_all_true:
+                    case SIMD_i16x8_bitmask:
+                    case SIMD_i32x4_all_true:
+                    case SIMD_i32x4_bitmask:
+                    case SIMD_i64x2_all_true:
+                    case SIMD_i64x2_bitmask:
+                    {
+                        addr1 = GET_OFFSET();
+                        addr_ret = GET_OFFSET();
+                        frame_lp[addr_ret] = (uint32)wasm_simd_reduce(
+                            opcode, (V128 *)(frame_lp + addr1));
+                        break;
+                    }
+
+                    default:
+                    {
+                        if (wasm_simd_is_unary_op(opcode)) {
+                            addr1 = GET_OFFSET();
+                            addr_ret = GET_OFFSET();
+                            wasm_simd_unary_op(opcode,
+                                               (V128 *)(frame_lp + addr1),
+                                               (V128 *)(frame_lp + addr_ret));
+                        }
+                        else {
+                            addr2 = GET_OFFSET();
+                            addr1 = GET_OFFSET();
+                            addr_ret = GET_OFFSET();
+                            wasm_simd_binary_op(opcode,
+                                                (V128 *)(frame_lp + addr1),
+                                                (V128 *)(frame_lp + addr2),
+                                                (V128 *)(frame_lp + addr_ret));
+                        }
+                        break;
+                    }
+                }
+                HANDLE_OP_END();
+            }
+#endif /* end of WASM_ENABLE_SIMD != 0 */
+
 #if WASM_ENABLE_SHARED_MEMORY != 0
             HANDLE_OP(WASM_OP_ATOMIC_PREFIX)
             {
@@ -3682,6 +4239,13 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 #if WASM_ENABLE_SHARED_MEMORY == 0
         HANDLE_OP(WASM_OP_ATOMIC_PREFIX)
 #endif
+#if WASM_ENABLE_SIMD == 0
+        HANDLE_OP(WASM_OP_SIMD_PREFIX)
+        HANDLE_OP(WASM_OP_SELECT_128)
+        HANDLE_OP(WASM_OP_GET_GLOBAL_128)
+        HANDLE_OP(WASM_OP_SET_GLOBAL_128)
+        HANDLE_OP(EXT_OP_COPY_STACK_TOP_V128)
+#endif
 #if WASM_ENABLE_REF_TYPES == 0
         HANDLE_OP(WASM_OP_TABLE_GET)
         HANDLE_OP(WASM_OP_TABLE_SET)
@@ -3689,7 +4253,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
         HANDLE_OP(WASM_OP_REF_IS_NULL)
         HANDLE_OP(WASM_OP_REF_FUNC)
 #endif
-        /* SELECT_T is converted to SELECT or SELECT_64 */
+        /* SELECT_T is converted to SELECT, SELECT_64 or SELECT_128 */
         HANDLE_OP(WASM_OP_SELECT_T)
         HANDLE_OP(WASM_OP_UNUSED_0x14)
         HANDLE_OP(WASM_OP_UNUSED_0x15)
@@ -3707,6 +4271,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
         HANDLE_OP(WASM_OP_GET_LOCAL)
         HANDLE_OP(WASM_OP_DROP)
         HANDLE_OP(WASM_OP_DROP_64)
+        HANDLE_OP(WASM_OP_DROP_128)
         HANDLE_OP(WASM_OP_BLOCK)
         HANDLE_OP(WASM_OP_LOOP)
         HANDLE_OP(WASM_OP_END)
@@ -3747,6 +4312,17 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                                     2 * (cur_func->param_count - i - 1)));
                 lp += 2;
             }
+#if WASM_ENABLE_SIMD != 0
+            else if (cur_func->param_types[i] == VALUE_TYPE_V128) {
+                bh_memcpy_s(
+                    lp, sizeof(V128),
+                    frame_lp
+                        + *(int16 *)(frame_ip
+                                     + 2 * (cur_func->param_count - i - 1)),
+                    sizeof(V128));
+                lp += 4;
+            }
+#endif
             else {
                 *lp = GET_OPERAND(uint32, I32,
                                   (2 * (cur_func->param_count - i - 1)));
@@ -3799,6 +4375,17 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                                 2 * (cur_func->param_count - i - 1)));
                 outs_area->lp += 2;
             }
+#if WASM_ENABLE_SIMD != 0
+            else if (cur_func->param_types[i] == VALUE_TYPE_V128) {
+                bh_memcpy_s(
+                    outs_area->lp, sizeof(V128),
+                    frame_lp
+                        + *(int16 *)(frame_ip
+                                     + 2 * (cur_func->param_count - i - 1)),
+                    sizeof(V128));
+                outs_area->lp += 4;
+            }
+#endif
             else {
                 *outs_area->lp = GET_OPERAND(
                     uint32, I32, (2 * (cur_func->param_count - i - 1)));
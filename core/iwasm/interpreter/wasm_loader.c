@@ -17,6 +17,7 @@
 #if WASM_ENABLE_FAST_JIT != 0
 #include "../fast-jit/jit_compiler.h"
 #include "../fast-jit/jit_codecache.h"
+#include "../fast-jit/jit_persistent_cache.h"
 #endif
 #if WASM_ENABLE_JIT != 0
 #include "../compilation/aot_llvm.h"
@@ -245,9 +246,7 @@ is_value_type(uint8 type)
         || type == VALUE_TYPE_FUNCREF || type == VALUE_TYPE_EXTERNREF
 #endif
 #if WASM_ENABLE_SIMD != 0
-#if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0)
         || type == VALUE_TYPE_V128
-#endif
 #endif
     )
         return true;
@@ -261,7 +260,6 @@ is_byte_a_type(uint8 type)
 }
 
 #if WASM_ENABLE_SIMD != 0
-#if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0)
 static V128
 read_i8x16(uint8 *p_buf, char *error_buf, uint32 error_buf_size)
 {
@@ -274,7 +272,6 @@ read_i8x16(uint8 *p_buf, char *error_buf, uint32 error_buf_size)
 
     return result;
 }
-#endif /* end of (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) */
 #endif /* end of WASM_ENABLE_SIMD */
 
 static void *
@@ -481,7 +478,6 @@ load_init_expr(const uint8 **p_buf, const uint8 *buf_end,
                 *p_float++ = *p++;
             break;
 #if WASM_ENABLE_SIMD != 0
-#if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0)
         case INIT_EXPR_TYPE_V128_CONST:
         {
             uint64 high, low;
@@ -501,7 +497,6 @@ load_init_expr(const uint8 **p_buf, const uint8 *buf_end,
             init_expr->u.v128.i64x2[1] = low;
             break;
         }
-#endif /* end of (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) */
 #endif /* end of WASM_ENABLE_SIMD */
 #if WASM_ENABLE_REF_TYPES != 0
         case INIT_EXPR_TYPE_FUNCREF_CONST:
@@ -2084,10 +2079,8 @@ load_export_section(const uint8 *buf, const uint8 *buf_end, WASMModule *module,
                         return false;
                     }
 #if WASM_ENABLE_SIMD != 0
-#if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0)
                     /* TODO: check func type, if it has v128 param or result,
                              report error */
-#endif
 #endif
                     break;
                 /* table index */
@@ -2825,6 +2818,15 @@ init_fast_jit_functions(WASMModule *module, char *error_buf,
         module->fast_jit_thread_locks_inited[i] = true;
     }
 
+#if WASM_ENABLE_FAST_JIT_OSR != 0 && WASM_ENABLE_LAZY_JIT != 0
+    if (os_mutex_init(&module->fast_jit_hot_func_lock) != 0) {
+        set_error_buf(error_buf, error_buf_size,
+                      "init fast jit hot function lock failed");
+        return false;
+    }
+    module->fast_jit_hot_func_lock_inited = true;
+#endif
+
     return true;
 }
 #endif /* end of WASM_ENABLE_FAST_JIT != 0 */
@@ -2999,6 +3001,123 @@ init_llvm_jit_functions_stage2_callback(void *arg)
 }
 #endif
 
+#if WASM_ENABLE_JIT != 0
+/* Compile the llvm jit functions of the partition led by function i,
+   i.e. functions i + j * WASM_ORC_JIT_BACKEND_THREAD_NUM, in which j is
+   less than WASM_ORC_JIT_COMPILE_THREAD_NUM */
+static bool
+compile_llvm_jit_partition(WASMModule *module, AOTCompContext *comp_ctx,
+                           uint32 i)
+{
+    uint32 group_stride = WASM_ORC_JIT_BACKEND_THREAD_NUM;
+    uint32 func_count = module->function_count;
+    LLVMOrcJITTargetAddress func_addr = 0;
+    LLVMErrorRef error;
+    char func_name[48];
+    typedef void (*F)(void);
+    union {
+        F f;
+        void *v;
+    } u;
+    uint32 j;
+
+    snprintf(func_name, sizeof(func_name), "%s%d%s", AOT_FUNC_PREFIX, i,
+             "_wrapper");
+    LOG_DEBUG("compile llvm jit func %s", func_name);
+    error = LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr, func_name);
+    if (error != LLVMErrorSuccess) {
+        char *err_msg = LLVMGetErrorMessage(error);
+        os_printf("failed to compile llvm jit function %u: %s", i, err_msg);
+        LLVMDisposeErrorMessage(err_msg);
+        return false;
+    }
+
+    /* Call the jit wrapper function to trigger its compilation, so as
+       to compile the actual jit functions, since we add the latter to
+       function list in the PartitionFunction callback */
+    u.v = (void *)func_addr;
+    u.f();
+
+    for (j = 0; j < WASM_ORC_JIT_COMPILE_THREAD_NUM; j++) {
+        if (i + j * group_stride < func_count) {
+            module->func_ptrs_compiled[i + j * group_stride] = true;
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
+            snprintf(func_name, sizeof(func_name), "%s%d", AOT_FUNC_PREFIX,
+                     i + j * group_stride);
+            error = LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr,
+                                           func_name);
+            if (error != LLVMErrorSuccess) {
+                char *err_msg = LLVMGetErrorMessage(error);
+                os_printf("failed to compile llvm jit function %u: %s", i,
+                          err_msg);
+                LLVMDisposeErrorMessage(err_msg);
+                /* Ignore current llvm jit func, as its func ptr is
+                   previous set to call_to_fast_jit, which also works */
+                continue;
+            }
+
+            jit_compiler_set_llvm_jit_func_ptr(
+                module, i + j * group_stride + module->import_function_count,
+                (void *)func_addr);
+
+            /* Try to switch to call this llvm jit funtion instead of
+               fast jit function from fast jit jitted code */
+            jit_compiler_set_call_to_llvm_jit(
+                module, i + j * group_stride + module->import_function_count);
+#endif
+        }
+    }
+
+    return true;
+}
+#endif
+
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
+    && WASM_ENABLE_LAZY_JIT != 0
+/* Get the leader of the hottest partition of the group which hasn't been
+   compiled by llvm jit. A partition is hot once one of its functions
+   reaches LLVM_JIT_TIERUP_THRESHOLD, and its hotness is the sum of the
+   calls and loop iterations counted by the fast jit jitted code of its
+   functions. Return -1 if there is no hot partition to compile, and set
+   *p_all_done if all partitions of the group were compiled */
+static uint32
+get_hottest_llvm_jit_partition(WASMModule *module, uint32 group_idx,
+                               bool *p_all_done)
+{
+    uint32 group_stride = WASM_ORC_JIT_BACKEND_THREAD_NUM;
+    uint32 func_count = module->function_count;
+    uint32 i, j, func_hotness, hottest = (uint32)-1;
+    uint64 hotness, max_hotness = 0;
+    bool all_done = true, is_hot;
+
+    for (i = group_idx; i < func_count;
+         i += group_stride * WASM_ORC_JIT_COMPILE_THREAD_NUM) {
+        if (module->func_ptrs_compiled[i])
+            continue;
+
+        all_done = false;
+        hotness = 0;
+        is_hot = false;
+        for (j = 0; j < WASM_ORC_JIT_COMPILE_THREAD_NUM; j++) {
+            if (i + j * group_stride < func_count) {
+                func_hotness =
+                    module->functions[i + j * group_stride]->llvm_jit_hotness;
+                if (func_hotness >= LLVM_JIT_TIERUP_THRESHOLD)
+                    is_hot = true;
+                hotness += func_hotness;
+            }
+        }
+        if (is_hot && hotness > max_hotness) {
+            max_hotness = hotness;
+            hottest = i;
+        }
+    }
+
+    *p_all_done = all_done;
+    return hottest;
+}
+#endif
+
 #if WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0
 /* The callback function to compile jit functions */
 static void *
@@ -3013,10 +3132,20 @@ orcjit_thread_callback(void *arg)
     uint32 group_stride = WASM_ORC_JIT_BACKEND_THREAD_NUM;
     uint32 func_count = module->function_count;
     uint32 i;
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
+    && WASM_ENABLE_LAZY_JIT != 0
+    uint64 start_time = os_time_get_boot_microsecond();
+#endif
 
 #if WASM_ENABLE_FAST_JIT != 0
     /* Compile fast jit funcitons of this group */
     for (i = group_idx; i < func_count; i += group_stride) {
+#if WASM_ENABLE_FAST_JIT_OSR != 0 && WASM_ENABLE_LAZY_JIT != 0
+        /* Compile the functions got hot in the interpreter firstly */
+        if (!jit_compiler_compile_hot_functions(module)) {
+            os_printf("failed to compile hot fast jit function\n");
+        }
+#endif
         if (!jit_compiler_compile(module, i + module->import_function_count)) {
             os_printf("failed to compile fast jit function %u\n", i);
             break;
@@ -3026,6 +3155,9 @@ orcjit_thread_callback(void *arg)
             return NULL;
         }
     }
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    jit_persistent_cache_group_done(module, i >= func_count);
+#endif
 #if WASM_ENABLE_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
     os_mutex_lock(&module->tierup_wait_lock);
     module->fast_jit_ready_groups++;
@@ -3075,73 +3207,49 @@ orcjit_thread_callback(void *arg)
 #endif
 
 #if WASM_ENABLE_JIT != 0
-    /* Compile llvm jit functions of this group */
-    for (i = group_idx; i < func_count;
-         i += group_stride * WASM_ORC_JIT_COMPILE_THREAD_NUM) {
-        LLVMOrcJITTargetAddress func_addr = 0;
-        LLVMErrorRef error;
-        char func_name[48];
-        typedef void (*F)(void);
-        union {
-            F f;
-            void *v;
-        } u;
-        uint32 j;
-
-        snprintf(func_name, sizeof(func_name), "%s%d%s", AOT_FUNC_PREFIX, i,
-                 "_wrapper");
-        LOG_DEBUG("compile llvm jit func %s", func_name);
-        error =
-            LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr, func_name);
-        if (error != LLVMErrorSuccess) {
-            char *err_msg = LLVMGetErrorMessage(error);
-            os_printf("failed to compile llvm jit function %u: %s", i, err_msg);
-            LLVMDisposeErrorMessage(err_msg);
-            break;
-        }
-
-        /* Call the jit wrapper function to trigger its compilation, so as
-           to compile the actual jit functions, since we add the latter to
-           function list in the PartitionFunction callback */
-        u.v = (void *)func_addr;
-        u.f();
-
-        for (j = 0; j < WASM_ORC_JIT_COMPILE_THREAD_NUM; j++) {
-            if (i + j * group_stride < func_count) {
-                module->func_ptrs_compiled[i + j * group_stride] = true;
 #if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
-                snprintf(func_name, sizeof(func_name), "%s%d", AOT_FUNC_PREFIX,
-                         i + j * group_stride);
-                error = LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr,
-                                               func_name);
-                if (error != LLVMErrorSuccess) {
-                    char *err_msg = LLVMGetErrorMessage(error);
-                    os_printf("failed to compile llvm jit function %u: %s", i,
-                              err_msg);
-                    LLVMDisposeErrorMessage(err_msg);
-                    /* Ignore current llvm jit func, as its func ptr is
-                       previous set to call_to_fast_jit, which also works */
-                    continue;
-                }
-
-                jit_compiler_set_llvm_jit_func_ptr(
-                    module,
-                    i + j * group_stride + module->import_function_count,
-                    (void *)func_addr);
+    /* Compile llvm jit functions of this group, the hottest ones firstly,
+       the cold ones keep running the fast jit jitted code until they get
+       hot, so as to reach the peak performance earlier */
+    while (!module->orcjit_stop_compiling) {
+        uint32 hot_func_count;
+        bool all_done;
+
+        os_mutex_lock(&module->tierup_wait_lock);
+        hot_func_count = module->llvm_jit_hot_func_count;
+        os_mutex_unlock(&module->tierup_wait_lock);
+
+        i = get_hottest_llvm_jit_partition(module, group_idx, &all_done);
+        if (all_done)
+            break;
 
-                /* Try to switch to call this llvm jit funtion instead of
-                   fast jit function from fast jit jitted code */
-                jit_compiler_set_call_to_llvm_jit(
-                    module,
-                    i + j * group_stride + module->import_function_count);
-#endif
-            }
+        if (i == (uint32)-1) {
+            /* No hot function to compile, sleep until the jitted code
+               reports that another function got hot */
+            os_mutex_lock(&module->tierup_wait_lock);
+            while (hot_func_count == module->llvm_jit_hot_func_count
+                   && !module->orcjit_stop_compiling)
+                os_cond_wait(&module->tierup_wait_cond,
+                             &module->tierup_wait_lock);
+            os_mutex_unlock(&module->tierup_wait_lock);
+            continue;
         }
 
-        if (module->orcjit_stop_compiling) {
+        if (!compile_llvm_jit_partition(module, comp_ctx, i))
+            break;
+        LOG_VERBOSE("promoted llvm jit func %u in %" PRIu64 " ms", i,
+                    (os_time_get_boot_microsecond() - start_time) / 1000);
+    }
+#else
+    /* Compile llvm jit functions of this group */
+    for (i = group_idx; i < func_count;
+         i += group_stride * WASM_ORC_JIT_COMPILE_THREAD_NUM) {
+        if (!compile_llvm_jit_partition(module, comp_ctx, i)
+            || module->orcjit_stop_compiling) {
             break;
         }
     }
+#endif
 #endif
 
     return NULL;
@@ -3153,7 +3261,18 @@ orcjit_stop_compile_threads(WASMModule *module)
     uint32 i, thread_num = (uint32)(sizeof(module->orcjit_thread_args)
                                     / sizeof(OrcJitThreadArg));
 
-    module->orcjit_stop_compiling = true;
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
+    && WASM_ENABLE_LAZY_JIT != 0
+    if (module->tierup_wait_lock_inited) {
+        /* Wake up the threads waiting for hot functions */
+        os_mutex_lock(&module->tierup_wait_lock);
+        module->orcjit_stop_compiling = true;
+        os_cond_broadcast(&module->tierup_wait_cond);
+        os_mutex_unlock(&module->tierup_wait_lock);
+    }
+    else
+#endif
+        module->orcjit_stop_compiling = true;
     for (i = 0; i < thread_num; i++) {
         if (module->orcjit_threads[i])
             os_thread_join(module->orcjit_threads[i], NULL);
@@ -3170,6 +3289,16 @@ compile_jit_functions(WASMModule *module, char *error_buf,
 
     bh_print_time("Begin to compile jit functions");
 
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    /* No need to compile if all the functions are loaded from the cache */
+    if (jit_persistent_cache_load(
+            module, module->function_count < thread_num ? module->function_count
+                                                        : thread_num)) {
+        bh_print_time("End load jit functions from cache");
+        return true;
+    }
+#endif
+
     /* Create threads to compile the jit functions */
     for (i = 0; i < thread_num && i < module->function_count; i++) {
 #if WASM_ENABLE_JIT != 0
@@ -4174,6 +4303,12 @@ wasm_loader_unload(WASMModule *module)
                     jit_code_cache_free(
                         module->functions[i]->fast_jit_jitted_code);
                 }
+#if WASM_ENABLE_FAST_JIT_OSR != 0
+                if (module->functions[i]->fast_jit_osr_entries) {
+                    wasm_runtime_free(
+                        module->functions[i]->fast_jit_osr_entries);
+                }
+#endif
 #if WASM_ENABLE_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
                 if (module->functions[i]->call_to_fast_jit_from_llvm_jit) {
                     jit_code_cache_free(
@@ -4280,6 +4415,10 @@ wasm_loader_unload(WASMModule *module)
 #endif
 
 #if WASM_ENABLE_FAST_JIT != 0
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    jit_persistent_cache_discard(module);
+#endif
+
     if (module->fast_jit_func_ptrs) {
         wasm_runtime_free(module->fast_jit_func_ptrs);
     }
@@ -4289,6 +4428,12 @@ wasm_loader_unload(WASMModule *module)
             os_mutex_destroy(&module->fast_jit_thread_locks[i]);
         }
     }
+
+#if WASM_ENABLE_FAST_JIT_OSR != 0 && WASM_ENABLE_LAZY_JIT != 0
+    if (module->fast_jit_hot_func_lock_inited) {
+        os_mutex_destroy(&module->fast_jit_hot_func_lock);
+    }
+#endif
 #endif
 
     wasm_runtime_free(module);
@@ -4459,6 +4604,10 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
             case WASM_OP_SELECT:
             case WASM_OP_DROP_64:
             case WASM_OP_SELECT_64:
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_DROP_128:
+            case WASM_OP_SELECT_128:
+#endif
                 break;
 
 #if WASM_ENABLE_REF_TYPES != 0
@@ -4488,6 +4637,10 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
             case WASM_OP_SET_GLOBAL:
             case WASM_OP_GET_GLOBAL_64:
             case WASM_OP_SET_GLOBAL_64:
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_GET_GLOBAL_128:
+            case WASM_OP_SET_GLOBAL_128:
+#endif
             case WASM_OP_SET_GLOBAL_AUX_STACK:
                 skip_leb_uint32(p, p_end); /* local index */
                 break;
@@ -4732,7 +4885,6 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
             }
 
 #if WASM_ENABLE_SIMD != 0
-#if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0)
             case WASM_OP_SIMD_PREFIX:
             {
                 /* TODO: shall we ceate a table to be friendly to branch
@@ -4821,7 +4973,6 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
                 }
                 break;
             }
-#endif /* end of (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) */
 #endif /* end of WASM_ENABLE_SIMD */
 
 #if WASM_ENABLE_SHARED_MEMORY != 0
@@ -4978,6 +5129,11 @@ typedef struct WASMLoaderContext {
      * than the final code_compiled_size, we record the peak size to ensure
      * there will not be invalid memory access during second traverse */
     uint32 code_compiled_peak_size;
+    /* The end of the last emitted i32.add and local.tee in the compiled
+     * code, they are fused with the following ops into superinstructions,
+     * see wasm_loader_get_code_compiled_pos. 0 if there is none. */
+    uintptr_t i32_add_end;
+    uintptr_t tee_local_fast_end;
 #endif
 } WASMLoaderContext;
 
@@ -5109,9 +5265,7 @@ check_stack_top_values(uint8 *frame_ref, int32 stack_cell_num, uint8 type,
     if ((is_32bit_type(type) && stack_cell_num < 1)
         || (is_64bit_type(type) && stack_cell_num < 2)
 #if WASM_ENABLE_SIMD != 0
-#if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0)
         || (type == VALUE_TYPE_V128 && stack_cell_num < 4)
-#endif
 #endif
     ) {
         set_error_buf(error_buf, error_buf_size,
@@ -5123,12 +5277,10 @@ check_stack_top_values(uint8 *frame_ref, int32 stack_cell_num, uint8 type,
         || (is_64bit_type(type)
             && (*(frame_ref - 2) != type || *(frame_ref - 1) != type))
 #if WASM_ENABLE_SIMD != 0
-#if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0)
         || (type == VALUE_TYPE_V128
             && (*(frame_ref - 4) != REF_V128_1 || *(frame_ref - 3) != REF_V128_2
                 || *(frame_ref - 2) != REF_V128_3
                 || *(frame_ref - 1) != REF_V128_4))
-#endif
 #endif
     ) {
         set_error_buf_v(error_buf, error_buf_size, "%s%s%s",
@@ -5254,7 +5406,6 @@ wasm_loader_push_frame_ref(WASMLoaderContext *ctx, uint8 type, char *error_buf,
     ctx->stack_cell_num++;
 
 #if WASM_ENABLE_SIMD != 0
-#if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0)
     if (type == VALUE_TYPE_V128) {
         if (!check_stack_push(ctx, error_buf, error_buf_size))
             return false;
@@ -5266,7 +5417,6 @@ wasm_loader_push_frame_ref(WASMLoaderContext *ctx, uint8 type, char *error_buf,
         ctx->stack_cell_num++;
     }
 #endif
-#endif
 
 check_stack_and_return:
     if (ctx->stack_cell_num > ctx->max_stack_cell_num) {
@@ -5309,12 +5459,10 @@ wasm_loader_pop_frame_ref(WASMLoaderContext *ctx, uint8 type, char *error_buf,
     ctx->stack_cell_num--;
 
 #if WASM_ENABLE_SIMD != 0
-#if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0)
     if (type == VALUE_TYPE_V128) {
         ctx->frame_ref -= 2;
         ctx->stack_cell_num -= 2;
     }
-#endif
 #endif
     return true;
 }
@@ -5566,6 +5714,8 @@ wasm_loader_ctx_reinit(WASMLoaderContext *ctx)
     /* init preserved local offsets */
     ctx->preserved_local_offset = ctx->max_dynamic_offset;
 
+    ctx->i32_add_end = ctx->tee_local_fast_end = 0;
+
     /* const buf is reserved */
     return true;
 }
@@ -5698,6 +5848,162 @@ wasm_loader_emit_backspace(WASMLoaderContext *ctx, uint32 size)
     }
 }
 
+/* Get the current position of the compiled code, which is the code size in
+   the first traverse and the code address in the second traverse */
+static uintptr_t
+wasm_loader_get_code_compiled_pos(WASMLoaderContext *ctx)
+{
+    return ctx->p_code_compiled ? (uintptr_t)ctx->p_code_compiled
+                                : (uintptr_t)ctx->code_compiled_size;
+}
+
+/* Remove the last emitted bytes and copy them to the buffer, the buffer is
+   only filled in the second traverse */
+static void
+wasm_loader_pop_bytes(WASMLoaderContext *ctx, uint8 *buf, uint32 size)
+{
+    if (ctx->p_code_compiled)
+        bh_memcpy_s(buf, size, ctx->p_code_compiled - size, size);
+    wasm_loader_emit_backspace(ctx, size);
+}
+
+static void
+wasm_loader_emit_bytes(WASMLoaderContext *ctx, const uint8 *buf, uint32 size)
+{
+    if (ctx->p_code_compiled) {
+        bh_memcpy_s(ctx->p_code_compiled,
+                    (uint32)(ctx->p_code_compiled_end - ctx->p_code_compiled),
+                    buf, size);
+        ctx->p_code_compiled += size;
+    }
+    else {
+        increase_compiled_code_space(ctx, size);
+    }
+}
+
+/* Replace the label which ends at p_code_compiled with the label of
+   another opcode, e.g. select with select_64 once the operand type is known */
+static void
+wasm_loader_patch_label(uint8 *p_code_compiled, uint8 opcode)
+{
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
+    *(void **)(p_code_compiled - sizeof(void *)) = handle_table[opcode];
+#else
+#if UINTPTR_MAX == UINT64_MAX
+    /* emit int32 relative offset in 64-bit target */
+    int32 offset =
+        (int32)((uint8 *)handle_table[opcode] - (uint8 *)handle_table[0]);
+    *(int32 *)(p_code_compiled - sizeof(int32)) = offset;
+#else
+    /* emit uint32 label address in 32-bit target */
+    *(uint32 *)(p_code_compiled - sizeof(uint32)) =
+        (uint32)(uintptr_t)handle_table[opcode];
+#endif
+#endif /* end of WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS */
+#else  /* else of WASM_ENABLE_LABELS_AS_VALUES */
+#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
+    *(p_code_compiled - 1) = opcode;
+#else
+    *(p_code_compiled - 2) = opcode;
+#endif /* end of WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS */
+#endif /* end of WASM_ENABLE_LABELS_AS_VALUES */
+}
+
+/* Replace the label of the last emitted op with the label of a
+   superinstruction, and keep the operand_size bytes of its operands */
+#define replace_last_label(opcode, operand_size)                         \
+    do {                                                                 \
+        uint8 last_operands[8];                                          \
+        bh_assert(operand_size <= sizeof(last_operands));                \
+        wasm_loader_pop_bytes(loader_ctx, last_operands, operand_size);  \
+        skip_label();                                                    \
+        emit_label(opcode);                                              \
+        wasm_loader_emit_bytes(loader_ctx, last_operands, operand_size); \
+    } while (0)
+
+#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
+#define TEE_LOCAL_FAST_OPERAND_SIZE (sizeof(uint8) + sizeof(int16))
+#else
+/* the local offset byte is padded to keep the operands aligned */
+#define TEE_LOCAL_FAST_OPERAND_SIZE (sizeof(uint16) + sizeof(int16))
+#endif
+
+/* Fuse br_if with the op before it into a superinstruction, which
+   computes the condition and branches in one dispatch. The label of br_if
+   has been emitted and its condition hasn't been popped, return true if
+   fused, and then the condition operand shouldn't be emitted */
+static bool
+fuse_br_if_with_last_op(WASMLoaderContext *loader_ctx, uint8 last_op)
+{
+    uint8 operands[sizeof(int16) * 3];
+    uint8 fused_op;
+    uintptr_t code_pos;
+
+    if ((loader_ctx->frame_csp - 1)->is_stack_polymorphic)
+        return false;
+
+    skip_label();
+    code_pos = wasm_loader_get_code_compiled_pos(loader_ctx);
+
+    if (last_op == WASM_OP_I32_EQZ) {
+        /* i32.eqz src dst => i32.eqz_br_if src */
+        wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
+        replace_last_label(EXT_OP_I32_EQZ_BR_IF, sizeof(int16));
+        return true;
+    }
+
+    if (last_op >= WASM_OP_I32_EQ && last_op <= WASM_OP_I32_GE_U) {
+        /* i32.cmp src2 src1 dst => i32.cmp_br_if src2 src1 */
+        fused_op = EXT_OP_I32_EQ_BR_IF + (last_op - WASM_OP_I32_EQ);
+        wasm_loader_pop_bytes(loader_ctx, operands, sizeof(int16) * 3);
+        skip_label();
+
+        if (loader_ctx->i32_add_end != 0
+            && loader_ctx->i32_add_end
+                   == wasm_loader_get_code_compiled_pos(loader_ctx)
+            && (last_op == WASM_OP_I32_NE || last_op == WASM_OP_I32_LT_S
+                || last_op == WASM_OP_I32_LT_U)) {
+            /* The compare follows an i32.add, e.g. the increment and the
+               check of a loop counter, fuse the three of them:
+               i32.add_cmp_br_if add_src2 add_src1 add_dst src2 src1 */
+            if (last_op == WASM_OP_I32_NE)
+                fused_op = EXT_OP_I32_ADD_NE_BR_IF;
+            else if (last_op == WASM_OP_I32_LT_S)
+                fused_op = EXT_OP_I32_ADD_LT_S_BR_IF;
+            else
+                fused_op = EXT_OP_I32_ADD_LT_U_BR_IF;
+            replace_last_label(fused_op, sizeof(int16) * 3);
+        }
+        else {
+            emit_label(fused_op);
+        }
+        wasm_loader_emit_bytes(loader_ctx, operands, sizeof(int16) * 2);
+        return true;
+    }
+
+    if ((last_op == WASM_OP_I32_ADD || last_op == WASM_OP_TEE_LOCAL)
+        && loader_ctx->i32_add_end != 0
+        && loader_ctx->i32_add_end == code_pos) {
+        /* The condition is the result of i32.add, which may be teed to a
+           local: i32.add_br_if src2 src1 dst */
+        replace_last_label(EXT_OP_I32_ADD_BR_IF, sizeof(int16) * 3);
+        return true;
+    }
+
+    if (last_op == WASM_OP_TEE_LOCAL
+        && loader_ctx->tee_local_fast_end != 0
+        && loader_ctx->tee_local_fast_end == code_pos) {
+        /* local.tee local src => local.tee_br_if local src */
+        replace_last_label(EXT_OP_TEE_LOCAL_FAST_BR_IF,
+                           TEE_LOCAL_FAST_OPERAND_SIZE);
+        return true;
+    }
+
+    emit_label(WASM_OP_BR_IF);
+    return false;
+}
+
 static bool
 preserve_referenced_local(WASMLoaderContext *loader_ctx, uint8 opcode,
                           uint32 local_index, uint32 local_type,
@@ -5727,6 +6033,13 @@ preserve_referenced_local(WASMLoaderContext *loader_ctx, uint8 opcode,
                         loader_ctx->preserved_local_offset++;
                     emit_label(EXT_OP_COPY_STACK_TOP);
                 }
+#if WASM_ENABLE_SIMD != 0
+                else if (local_type == VALUE_TYPE_V128) {
+                    if (loader_ctx->p_code_compiled)
+                        loader_ctx->preserved_local_offset += 4;
+                    emit_label(EXT_OP_COPY_STACK_TOP_V128);
+                }
+#endif
                 else {
                     if (loader_ctx->p_code_compiled)
                         loader_ctx->preserved_local_offset += 2;
@@ -5741,6 +6054,10 @@ preserve_referenced_local(WASMLoaderContext *loader_ctx, uint8 opcode,
 
         if (is_32bit_type(cur_type))
             i++;
+#if WASM_ENABLE_SIMD != 0
+        else if (cur_type == VALUE_TYPE_V128)
+            i += 4;
+#endif
         else
             i += 2;
     }
@@ -5774,6 +6091,11 @@ preserve_local_for_block(WASMLoaderContext *loader_ctx, uint8 opcode,
         if (is_32bit_type(cur_type)) {
             i++;
         }
+#if WASM_ENABLE_SIMD != 0
+        else if (cur_type == VALUE_TYPE_V128) {
+            i += 4;
+        }
+#endif
         else {
             i += 2;
         }
@@ -5911,6 +6233,8 @@ wasm_loader_push_frame_offset(WASMLoaderContext *ctx, uint8 type,
                               bool disable_emit, int16 operand_offset,
                               char *error_buf, uint32 error_buf_size)
 {
+    uint32 cell_num = 2, i;
+
     if (type == VALUE_TYPE_VOID)
         return true;
 
@@ -5937,18 +6261,26 @@ wasm_loader_push_frame_offset(WASMLoaderContext *ctx, uint8 type,
     if (is_32bit_type(type))
         return true;
 
-    if (ctx->p_code_compiled == NULL) {
-        if (!check_offset_push(ctx, error_buf, error_buf_size))
-            return false;
-    }
+#if WASM_ENABLE_SIMD != 0
+    if (type == VALUE_TYPE_V128)
+        cell_num = 4;
+#endif
 
-    ctx->frame_offset++;
-    if (!disable_emit) {
-        ctx->dynamic_offset++;
-        if (ctx->dynamic_offset > ctx->max_dynamic_offset) {
-            ctx->max_dynamic_offset = ctx->dynamic_offset;
-            if (ctx->max_dynamic_offset >= INT16_MAX) {
-                goto fail;
+    /* the remaining cells of the value follow the first cell */
+    for (i = 1; i < cell_num; i++) {
+        if (ctx->p_code_compiled == NULL) {
+            if (!check_offset_push(ctx, error_buf, error_buf_size))
+                return false;
+        }
+
+        ctx->frame_offset++;
+        if (!disable_emit) {
+            ctx->dynamic_offset++;
+            if (ctx->dynamic_offset > ctx->max_dynamic_offset) {
+                ctx->max_dynamic_offset = ctx->dynamic_offset;
+                if (ctx->max_dynamic_offset >= INT16_MAX) {
+                    goto fail;
+                }
             }
         }
     }
@@ -5995,6 +6327,17 @@ wasm_loader_pop_frame_offset(WASMLoaderContext *ctx, uint8 type,
             && (*(ctx->frame_offset) < ctx->max_dynamic_offset))
             ctx->dynamic_offset -= 1;
     }
+#if WASM_ENABLE_SIMD != 0
+    else if (type == VALUE_TYPE_V128) {
+        if (!check_offset_pop(ctx, 4))
+            return true;
+
+        ctx->frame_offset -= 4;
+        if ((*(ctx->frame_offset) > ctx->start_dynamic_offset)
+            && (*(ctx->frame_offset) < ctx->max_dynamic_offset))
+            ctx->dynamic_offset -= 4;
+    }
+#endif
     else {
         if (!check_offset_pop(ctx, 2))
             return true;
@@ -6079,7 +6422,6 @@ wasm_loader_get_const_offset(WASMLoaderContext *ctx, uint8 type, void *value,
     /* Search existing constant */
     for (c = (Const *)ctx->const_buf;
          (uint8 *)c < ctx->const_buf + ctx->num_const * sizeof(Const); c++) {
-        /* TODO: handle v128 type? */
         if ((type == c->value_type)
             && ((type == VALUE_TYPE_I64 && *(int64 *)value == c->value.i64)
                 || (type == VALUE_TYPE_I32 && *(int32 *)value == c->value.i32)
@@ -6088,6 +6430,10 @@ wasm_loader_get_const_offset(WASMLoaderContext *ctx, uint8 type, void *value,
                     && *(int32 *)value == c->value.i32)
                 || (type == VALUE_TYPE_EXTERNREF
                     && *(int32 *)value == c->value.i32)
+#endif
+#if WASM_ENABLE_SIMD != 0
+                || (type == VALUE_TYPE_V128
+                    && (0 == memcmp(value, &(c->value.v128), sizeof(V128))))
 #endif
                 || (type == VALUE_TYPE_F64
                     && (0 == memcmp(value, &(c->value.f64), sizeof(float64))))
@@ -6097,20 +6443,12 @@ wasm_loader_get_const_offset(WASMLoaderContext *ctx, uint8 type, void *value,
             operand_offset = c->slot_index;
             break;
         }
-        if (is_32bit_type(c->value_type))
-            operand_offset += 1;
-        else
-            operand_offset += 2;
+        operand_offset += (int16)wasm_value_type_cell_num(c->value_type);
     }
 
     if ((uint8 *)c == ctx->const_buf + ctx->num_const * sizeof(Const)) {
         /* New constant, append to the const buffer */
-        if ((type == VALUE_TYPE_F64) || (type == VALUE_TYPE_I64)) {
-            bytes_to_increase = 2;
-        }
-        else {
-            bytes_to_increase = 1;
-        }
+        bytes_to_increase = (int8)wasm_value_type_cell_num(type);
 
         /* The max cell num of const buffer is 32768 since the valid index range
          * is -32768 ~ -1. Return an invalid index 0 to indicate the buffer is
@@ -6150,6 +6488,15 @@ wasm_loader_get_const_offset(WASMLoaderContext *ctx, uint8 type, void *value,
                 c->value.i32 = *(int32 *)value;
                 ctx->const_cell_num++;
                 break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                bh_memcpy_s(&(c->value.v128), sizeof(WASMValue), value,
+                            sizeof(V128));
+                ctx->const_cell_num += 4;
+                /* use the last cell like i64/f64 const */
+                operand_offset += 3;
+                break;
+#endif
 #if WASM_ENABLE_REF_TYPES != 0
             case VALUE_TYPE_EXTERNREF:
             case VALUE_TYPE_FUNCREF:
@@ -6305,17 +6652,21 @@ reserve_block_ret(WASMLoaderContext *loader_ctx, uint8 opcode,
 
     return_count = block_type_get_result_types(block_type, &return_types);
 
-    /* If there is only one return value, use EXT_OP_COPY_STACK_TOP/_I64 instead
-     * of EXT_OP_COPY_STACK_VALUES for interpreter performance. */
+    /* If there is only one return value, use EXT_OP_COPY_STACK_TOP/_I64/_V128
+     * instead of EXT_OP_COPY_STACK_VALUES for interpreter performance. */
     if (return_count == 1) {
         uint8 cell = (uint8)wasm_value_type_cell_num(return_types[0]);
-        if (cell <= 2 /* V128 isn't supported whose cell num is 4 */
-            && block->dynamic_offset != *(loader_ctx->frame_offset - cell)) {
+        if (block->dynamic_offset != *(loader_ctx->frame_offset - cell)) {
             /* insert op_copy before else opcode */
             if (opcode == WASM_OP_ELSE)
                 skip_label();
-            emit_label(cell == 1 ? EXT_OP_COPY_STACK_TOP
-                                 : EXT_OP_COPY_STACK_TOP_I64);
+#if WASM_ENABLE_SIMD != 0
+            if (cell == 4)
+                emit_label(EXT_OP_COPY_STACK_TOP_V128);
+            else
+#endif
+                emit_label(cell == 1 ? EXT_OP_COPY_STACK_TOP
+                                     : EXT_OP_COPY_STACK_TOP_I64);
             emit_operand(loader_ctx, *(loader_ctx->frame_offset - cell));
             emit_operand(loader_ctx, block->dynamic_offset);
 
@@ -6526,7 +6877,6 @@ check_memory_access_align(uint8 opcode, uint32 align, char *error_buf,
 }
 
 #if WASM_ENABLE_SIMD != 0
-#if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0)
 static bool
 check_simd_memory_access_align(uint8 opcode, uint32 align, char *error_buf,
                                uint32 error_buf_size)
@@ -6640,7 +6990,6 @@ check_simd_shuffle_mask(V128 mask, char *error_buf, uint32 error_buf_size)
     }
     return true;
 }
-#endif /* end of (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) */
 #endif /* end of WASM_ENABLE_SIMD */
 
 #if WASM_ENABLE_SHARED_MEMORY != 0
@@ -7053,7 +7402,7 @@ wasm_loader_prepare_bytecode(WASMModule *module, WASMFunction *func,
     uint8 *func_const_end, *func_const = NULL;
     int16 operand_offset = 0;
     uint8 last_op = 0;
-    bool disable_emit, preserve_local = false;
+    bool disable_emit, preserve_local = false, fuse_add_load;
     float32 f32_const;
     float64 f64_const;
 
@@ -7405,7 +7754,15 @@ re_scan:
 
             case WASM_OP_BR_IF:
             {
+#if WASM_ENABLE_FAST_INTERP != 0
+                bool fused = fuse_br_if_with_last_op(loader_ctx, last_op);
+#endif
                 POP_I32();
+#if WASM_ENABLE_FAST_INTERP != 0
+                /* The condition is computed by the superinstruction */
+                if (fused)
+                    wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
+#endif
 
                 if (!(frame_csp_tmp = check_branch_block(
                           loader_ctx, &p, p_end, error_buf, error_buf_size)))
@@ -7777,12 +8134,22 @@ re_scan:
 #endif
                     }
 #if WASM_ENABLE_SIMD != 0
-#if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0)
                     else if (*(loader_ctx->frame_ref - 1) == REF_V128_1) {
                         loader_ctx->frame_ref -= 4;
                         loader_ctx->stack_cell_num -= 4;
-                    }
+#if WASM_ENABLE_FAST_INTERP == 0
+                        *(p - 1) = WASM_OP_DROP_128;
+#endif
+#if WASM_ENABLE_FAST_INTERP != 0
+                        skip_label();
+                        loader_ctx->frame_offset -= 4;
+                        if ((*(loader_ctx->frame_offset)
+                             > loader_ctx->start_dynamic_offset)
+                            && (*(loader_ctx->frame_offset)
+                                < loader_ctx->max_dynamic_offset))
+                            loader_ctx->dynamic_offset -= 4;
 #endif
+                    }
 #endif
                     else {
                         set_error_buf(error_buf, error_buf_size,
@@ -7832,44 +8199,22 @@ re_scan:
                             *(p - 1) = WASM_OP_SELECT_64;
 #endif
 #if WASM_ENABLE_FAST_INTERP != 0
-                            if (loader_ctx->p_code_compiled) {
-                                uint8 opcode_tmp = WASM_OP_SELECT_64;
-#if WASM_ENABLE_LABELS_AS_VALUES != 0
-#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
-                                *(void **)(p_code_compiled_tmp
-                                           - sizeof(void *)) =
-                                    handle_table[opcode_tmp];
-#else
-#if UINTPTR_MAX == UINT64_MAX
-                                /* emit int32 relative offset in 64-bit target
-                                 */
-                                int32 offset =
-                                    (int32)((uint8 *)handle_table[opcode_tmp]
-                                            - (uint8 *)handle_table[0]);
-                                *(int32 *)(p_code_compiled_tmp
-                                           - sizeof(int32)) = offset;
-#else
-                                /* emit uint32 label address in 32-bit target */
-                                *(uint32 *)(p_code_compiled_tmp
-                                            - sizeof(uint32)) =
-                                    (uint32)(uintptr_t)handle_table[opcode_tmp];
+                            if (loader_ctx->p_code_compiled)
+                                wasm_loader_patch_label(p_code_compiled_tmp,
+                                                        WASM_OP_SELECT_64);
 #endif
-#endif /* end of WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS */
-#else  /* else of WASM_ENABLE_LABELS_AS_VALUES */
-#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
-                                *(p_code_compiled_tmp - 1) = opcode_tmp;
-#else
-                                *(p_code_compiled_tmp - 2) = opcode_tmp;
-#endif /* end of WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS */
-#endif /* end of WASM_ENABLE_LABELS_AS_VALUES */
-                            }
-#endif /* end of WASM_ENABLE_FAST_INTERP */
                             break;
 #if WASM_ENABLE_SIMD != 0
-#if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0)
                         case REF_V128_4:
+#if WASM_ENABLE_FAST_INTERP == 0
+                            *(p - 1) = WASM_OP_SELECT_128;
+#endif
+#if WASM_ENABLE_FAST_INTERP != 0
+                            if (loader_ctx->p_code_compiled)
+                                wasm_loader_patch_label(p_code_compiled_tmp,
+                                                        WASM_OP_SELECT_128);
+#endif
                             break;
-#endif /* (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) */
 #endif /* WASM_ENABLE_SIMD != 0 */
                         default:
                         {
@@ -7931,42 +8276,19 @@ re_scan:
                     uint8 opcode_tmp = WASM_OP_SELECT;
 
                     if (ref_type == VALUE_TYPE_V128) {
-#if (WASM_ENABLE_SIMD == 0) \
-    || ((WASM_ENABLE_WAMR_COMPILER == 0) && (WASM_ENABLE_JIT == 0))
+#if WASM_ENABLE_SIMD == 0
                         set_error_buf(error_buf, error_buf_size,
                                       "SIMD v128 type isn't supported");
                         goto fail;
-#endif
-                    }
-                    else {
-                        if (ref_type == VALUE_TYPE_F64
-                            || ref_type == VALUE_TYPE_I64)
-                            opcode_tmp = WASM_OP_SELECT_64;
-#if WASM_ENABLE_LABELS_AS_VALUES != 0
-#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
-                        *(void **)(p_code_compiled_tmp - sizeof(void *)) =
-                            handle_table[opcode_tmp];
-#else
-#if UINTPTR_MAX == UINT64_MAX
-                        /* emit int32 relative offset in 64-bit target */
-                        int32 offset = (int32)((uint8 *)handle_table[opcode_tmp]
-                                               - (uint8 *)handle_table[0]);
-                        *(int32 *)(p_code_compiled_tmp - sizeof(int32)) =
-                            offset;
 #else
-                        /* emit uint32 label address in 32-bit target */
-                        *(uint32 *)(p_code_compiled_tmp - sizeof(uint32)) =
-                            (uint32)(uintptr_t)handle_table[opcode_tmp];
+                        opcode_tmp = WASM_OP_SELECT_128;
 #endif
-#endif /* end of WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS */
-#else  /* else of WASM_ENABLE_LABELS_AS_VALUES */
-#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
-                        *(p_code_compiled_tmp - 1) = opcode_tmp;
-#else
-                        *(p_code_compiled_tmp - 2) = opcode_tmp;
-#endif /* end of WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS */
-#endif /* end of WASM_ENABLE_LABELS_AS_VALUES */
                     }
+                    else if (ref_type == VALUE_TYPE_F64
+                             || ref_type == VALUE_TYPE_I64) {
+                        opcode_tmp = WASM_OP_SELECT_64;
+                    }
+                    wasm_loader_patch_label(p_code_compiled_tmp, opcode_tmp);
                 }
 #endif /* WASM_ENABLE_FAST_INTERP != 0 */
 
@@ -8126,7 +8448,11 @@ re_scan:
 #else
 #if (WASM_ENABLE_WAMR_COMPILER == 0) && (WASM_ENABLE_JIT == 0) \
     && (WASM_ENABLE_FAST_JIT == 0) && (WASM_ENABLE_DEBUG_INTERP == 0)
-                if (local_offset < 0x80) {
+                if (local_offset < 0x80
+#if WASM_ENABLE_SIMD != 0
+                    && local_type != VALUE_TYPE_V128
+#endif
+                ) {
                     *p_org++ = EXT_OP_GET_LOCAL_FAST;
                     if (is_32bit_type(local_type)) {
                         *p_org++ = (uint8)local_offset;
@@ -8155,6 +8481,17 @@ re_scan:
                         &preserve_local, error_buf, error_buf_size)))
                     goto fail;
 
+#if WASM_ENABLE_SIMD != 0
+                if (local_type == VALUE_TYPE_V128) {
+                    /* copy the value from the stack top to the local */
+                    skip_label();
+                    emit_label(EXT_OP_COPY_STACK_TOP_V128);
+                    POP_OFFSET_TYPE(local_type);
+                    emit_operand(loader_ctx, local_offset);
+                    break;
+                }
+#endif
+
                 if (local_offset < 256) {
                     skip_label();
                     if ((!preserve_local) && (LAST_OP_OUTPUT_I32())) {
@@ -8190,7 +8527,11 @@ re_scan:
 #else
 #if (WASM_ENABLE_WAMR_COMPILER == 0) && (WASM_ENABLE_JIT == 0) \
     && (WASM_ENABLE_FAST_JIT == 0) && (WASM_ENABLE_DEBUG_INTERP == 0)
-                if (local_offset < 0x80) {
+                if (local_offset < 0x80
+#if WASM_ENABLE_SIMD != 0
+                    && local_type != VALUE_TYPE_V128
+#endif
+                ) {
                     *p_org++ = EXT_OP_SET_LOCAL_FAST;
                     if (is_32bit_type(local_type)) {
                         *p_org++ = (uint8)local_offset;
@@ -8230,6 +8571,38 @@ re_scan:
                         &preserve_local, error_buf, error_buf_size)))
                     goto fail;
 
+                loader_ctx->tee_local_fast_end = 0;
+#if WASM_ENABLE_SIMD != 0
+                if (local_type == VALUE_TYPE_V128) {
+                    /* copy the value from the stack top to the local */
+                    skip_label();
+                    emit_label(EXT_OP_COPY_STACK_TOP_V128);
+                    emit_operand(loader_ctx, *(loader_ctx->frame_offset - 4));
+                    emit_operand(loader_ctx, local_offset);
+                    break;
+                }
+#endif
+
+                if (local_offset < 256 && !preserve_local
+                    && !cur_block->is_stack_polymorphic
+                    && ((LAST_OP_OUTPUT_I32()) || (LAST_OP_OUTPUT_I64()))) {
+                    /* Fold local.tee into the last op: the op outputs to
+                       the local, which is pushed like local.get */
+                    skip_label();
+                    if (loader_ctx->p_code_compiled)
+                        STORE_U16(loader_ctx->p_code_compiled - 2,
+                                  local_offset);
+                    if (is_32bit_type(local_type)) {
+                        *(loader_ctx->frame_offset - 1) = (int16)local_offset;
+                        loader_ctx->dynamic_offset--;
+                    }
+                    else {
+                        *(loader_ctx->frame_offset - 2) = (int16)local_offset;
+                        loader_ctx->dynamic_offset -= 2;
+                    }
+                    break;
+                }
+
                 if (local_offset < 256) {
                     skip_label();
                     if (is_32bit_type(local_type)) {
@@ -8247,10 +8620,17 @@ re_scan:
                 emit_operand(loader_ctx,
                              *(loader_ctx->frame_offset
                                - wasm_value_type_cell_num(local_type)));
+                if (local_offset < 256 && is_32bit_type(local_type))
+                    loader_ctx->tee_local_fast_end =
+                        wasm_loader_get_code_compiled_pos(loader_ctx);
 #else
 #if (WASM_ENABLE_WAMR_COMPILER == 0) && (WASM_ENABLE_JIT == 0) \
     && (WASM_ENABLE_FAST_JIT == 0) && (WASM_ENABLE_DEBUG_INTERP == 0)
-                if (local_offset < 0x80) {
+                if (local_offset < 0x80
+#if WASM_ENABLE_SIMD != 0
+                    && local_type != VALUE_TYPE_V128
+#endif
+                ) {
                     *p_org++ = EXT_OP_TEE_LOCAL_FAST;
                     if (is_32bit_type(local_type)) {
                         *p_org++ = (uint8)local_offset;
@@ -8297,12 +8677,29 @@ re_scan:
 #endif
                     *p_org = WASM_OP_GET_GLOBAL_64;
                 }
+#if WASM_ENABLE_SIMD != 0
+                else if (global_type == VALUE_TYPE_V128) {
+#if WASM_ENABLE_DEBUG_INTERP != 0
+                    if (!record_fast_op(module, p_org, *p_org, error_buf,
+                                        error_buf_size)) {
+                        goto fail;
+                    }
+#endif
+                    *p_org = WASM_OP_GET_GLOBAL_128;
+                }
+#endif
 #else  /* else of WASM_ENABLE_FAST_INTERP */
                 if (global_type == VALUE_TYPE_I64
                     || global_type == VALUE_TYPE_F64) {
                     skip_label();
                     emit_label(WASM_OP_GET_GLOBAL_64);
                 }
+#if WASM_ENABLE_SIMD != 0
+                else if (global_type == VALUE_TYPE_V128) {
+                    skip_label();
+                    emit_label(WASM_OP_GET_GLOBAL_128);
+                }
+#endif
                 emit_uint32(loader_ctx, global_idx);
                 PUSH_OFFSET_TYPE(global_type);
 #endif /* end of WASM_ENABLE_FAST_INTERP */
@@ -8349,6 +8746,17 @@ re_scan:
 #endif
                     *p_org = WASM_OP_SET_GLOBAL_64;
                 }
+#if WASM_ENABLE_SIMD != 0
+                else if (global_type == VALUE_TYPE_V128) {
+#if WASM_ENABLE_DEBUG_INTERP != 0
+                    if (!record_fast_op(module, p_org, *p_org, error_buf,
+                                        error_buf_size)) {
+                        goto fail;
+                    }
+#endif
+                    *p_org = WASM_OP_SET_GLOBAL_128;
+                }
+#endif
                 else if (module->aux_stack_size > 0
                          && global_idx == module->aux_stack_top_global_index) {
 #if WASM_ENABLE_DEBUG_INTERP != 0
@@ -8368,6 +8776,12 @@ re_scan:
                     skip_label();
                     emit_label(WASM_OP_SET_GLOBAL_64);
                 }
+#if WASM_ENABLE_SIMD != 0
+                else if (global_type == VALUE_TYPE_V128) {
+                    skip_label();
+                    emit_label(WASM_OP_SET_GLOBAL_128);
+                }
+#endif
                 else if (module->aux_stack_size > 0
                          && global_idx == module->aux_stack_top_global_index) {
                     skip_label();
@@ -8423,6 +8837,17 @@ re_scan:
                     skip_label();
                     emit_label(WASM_OP_I64_STORE);
                 }
+
+                fuse_add_load = false;
+                if (opcode == WASM_OP_I32_LOAD && last_op == WASM_OP_I32_ADD
+                    && loader_ctx->i32_add_end != 0) {
+                    /* i32.add src2 src1 dst + i32.load offset dst dst2 =>
+                       i32.add_load src2 src1 offset dst2 */
+                    skip_label();
+                    wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
+                    replace_last_label(EXT_OP_I32_ADD_LOAD, sizeof(int16) * 2);
+                    fuse_add_load = true;
+                }
 #endif
                 CHECK_MEMORY();
                 read_leb_uint32(p, p_end, align);      /* align */
@@ -8486,6 +8911,18 @@ re_scan:
                     default:
                         break;
                 }
+#if WASM_ENABLE_FAST_INTERP != 0
+                if (fuse_add_load) {
+                    /* Remove the address operand, which is computed by the
+                       superinstruction */
+                    uint8 dst_operand[sizeof(int16)];
+                    wasm_loader_pop_bytes(loader_ctx, dst_operand,
+                                          sizeof(int16));
+                    wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
+                    wasm_loader_emit_bytes(loader_ctx, dst_operand,
+                                           sizeof(int16));
+                }
+#endif
                 break;
             }
 
@@ -9091,13 +9528,18 @@ re_scan:
             }
 
 #if WASM_ENABLE_SIMD != 0
-#if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0)
             case WASM_OP_SIMD_PREFIX:
             {
                 uint32 opcode1;
 
                 CHECK_BUF(p, p_end, 1);
                 opcode1 = read_uint8(p);
+#if WASM_ENABLE_FAST_INTERP != 0
+                /* v128.const is put into the const buffer like other consts
+                   and emits the sub opcode by itself if it can't be */
+                if (opcode1 != SIMD_v128_const)
+                    emit_byte(loader_ctx, ((uint8)opcode1));
+#endif
                 /* follow the order of enum WASMSimdEXTOpcode in wasm_opcode.h
                  */
                 switch (opcode1) {
@@ -9123,6 +9565,9 @@ re_scan:
                         }
 
                         read_leb_uint32(p, p_end, mem_offset); /* offset */
+#if WASM_ENABLE_FAST_INTERP != 0
+                        emit_uint32(loader_ctx, mem_offset);
+#endif
 
                         POP_AND_PUSH(VALUE_TYPE_I32, VALUE_TYPE_V128);
 #if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
@@ -9142,6 +9587,9 @@ re_scan:
                         }
 
                         read_leb_uint32(p, p_end, mem_offset); /* offset */
+#if WASM_ENABLE_FAST_INTERP != 0
+                        emit_uint32(loader_ctx, mem_offset);
+#endif
 
                         POP_V128();
                         POP_I32();
@@ -9154,7 +9602,24 @@ re_scan:
                     /* basic operation */
                     case SIMD_v128_const:
                     {
+#if WASM_ENABLE_FAST_INTERP != 0
+                        V128 v128_const;
+#endif
+
                         CHECK_BUF1(p, p_end, 16);
+#if WASM_ENABLE_FAST_INTERP != 0
+                        bh_memcpy_s(&v128_const, sizeof(V128), p, 16);
+                        skip_label();
+                        disable_emit = true;
+                        GET_CONST_OFFSET(VALUE_TYPE_V128, v128_const);
+
+                        if (operand_offset == 0) {
+                            disable_emit = false;
+                            emit_label(WASM_OP_SIMD_PREFIX);
+                            emit_byte(loader_ctx, SIMD_v128_const);
+                            wasm_loader_emit_bytes(loader_ctx, p, 16);
+                        }
+#endif
                         p += 16;
                         PUSH_V128();
                         break;
@@ -9171,6 +9636,10 @@ re_scan:
                                                      error_buf_size)) {
                             goto fail;
                         }
+#if WASM_ENABLE_FAST_INTERP != 0
+                        wasm_loader_emit_bytes(loader_ctx, (uint8 *)&mask,
+                                               sizeof(V128));
+#endif
 
                         POP2_AND_PUSH(VALUE_TYPE_V128, VALUE_TYPE_V128);
                         break;
@@ -9242,13 +9711,24 @@ re_scan:
                                                     error_buf_size)) {
                             goto fail;
                         }
+#if WASM_ENABLE_FAST_INTERP != 0
+                        emit_byte(loader_ctx, lane);
+#endif
 
                         if (replace[opcode1 - SIMD_i8x16_extract_lane_s]) {
+#if WASM_ENABLE_FAST_INTERP != 0
+                            if (!(wasm_loader_pop_frame_ref_offset(
+                                    loader_ctx,
+                                    replace[opcode1
+                                            - SIMD_i8x16_extract_lane_s],
+                                    error_buf, error_buf_size)))
+#else
                             if (!(wasm_loader_pop_frame_ref(
                                     loader_ctx,
                                     replace[opcode1
                                             - SIMD_i8x16_extract_lane_s],
                                     error_buf, error_buf_size)))
+#endif
                                 goto fail;
                         }
 
@@ -9367,6 +9847,10 @@ re_scan:
                                                     error_buf_size)) {
                             goto fail;
                         }
+#if WASM_ENABLE_FAST_INTERP != 0
+                        emit_uint32(loader_ctx, mem_offset);
+                        emit_byte(loader_ctx, lane);
+#endif
 
                         POP_V128();
                         POP_I32();
@@ -9391,6 +9875,9 @@ re_scan:
                         }
 
                         read_leb_uint32(p, p_end, mem_offset); /* offset */
+#if WASM_ENABLE_FAST_INTERP != 0
+                        emit_uint32(loader_ctx, mem_offset);
+#endif
 
                         POP_AND_PUSH(VALUE_TYPE_I32, VALUE_TYPE_V128);
 #if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
@@ -9750,7 +10237,6 @@ re_scan:
                 }
                 break;
             }
-#endif /* end of (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) */
 #endif /* end of WASM_ENABLE_SIMD */
 
 #if WASM_ENABLE_SHARED_MEMORY != 0
@@ -9909,6 +10395,16 @@ re_scan:
 
 #if WASM_ENABLE_FAST_INTERP != 0
         last_op = opcode;
+        /* Only the ops which emit no code may be between i32.add and the
+           op fused with it, so no branch target is in the superinstruction */
+        if (opcode == WASM_OP_I32_ADD
+            && !(loader_ctx->frame_csp - 1)->is_stack_polymorphic)
+            loader_ctx->i32_add_end =
+                wasm_loader_get_code_compiled_pos(loader_ctx);
+        else if (opcode != WASM_OP_GET_LOCAL && opcode != WASM_OP_SET_LOCAL
+                 && opcode != WASM_OP_TEE_LOCAL && opcode != WASM_OP_I32_CONST
+                 && !(opcode >= WASM_OP_I32_EQ && opcode <= WASM_OP_I32_GE_U))
+            loader_ctx->i32_add_end = 0;
 #endif
     }
 
@@ -9947,6 +10443,13 @@ re_scan:
                             &(c->value.f64), (uint32)sizeof(int64));
                 func_const += sizeof(int64);
             }
+#if WASM_ENABLE_SIMD != 0
+            else if (c->value_type == VALUE_TYPE_V128) {
+                bh_memcpy_s(func_const, (uint32)(func_const_end - func_const),
+                            &(c->value.v128), (uint32)sizeof(V128));
+                func_const += sizeof(V128);
+            }
+#endif
             else {
                 bh_memcpy_s(func_const, (uint32)(func_const_end - func_const),
                             &(c->value.f32), (uint32)sizeof(int32));
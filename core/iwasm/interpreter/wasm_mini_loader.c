@@ -14,6 +14,7 @@
 #if WASM_ENABLE_FAST_JIT != 0
 #include "../fast-jit/jit_compiler.h"
 #include "../fast-jit/jit_codecache.h"
+#include "../fast-jit/jit_persistent_cache.h"
 #endif
 #if WASM_ENABLE_JIT != 0
 #include "../compilation/aot_llvm.h"
@@ -75,6 +76,9 @@ is_value_type(uint8 type)
         || type == VALUE_TYPE_F32 || type == VALUE_TYPE_F64
 #if WASM_ENABLE_REF_TYPES != 0
         || type == VALUE_TYPE_FUNCREF || type == VALUE_TYPE_EXTERNREF
+#endif
+#if WASM_ENABLE_SIMD != 0
+        || type == VALUE_TYPE_V128
 #endif
     )
         return true;
@@ -180,6 +184,21 @@ read_leb(uint8 **p_buf, const uint8 *buf_end, uint32 maxbits, bool sign,
         res = (int32)res64;                                        \
     } while (0)
 
+#if WASM_ENABLE_SIMD != 0
+static V128
+read_i8x16(uint8 *p_buf)
+{
+    V128 result;
+    uint8 i;
+
+    for (i = 0; i != 16; ++i) {
+        result.i8x16[i] = read_uint8(p_buf);
+    }
+
+    return result;
+}
+#endif /* end of WASM_ENABLE_SIMD */
+
 static void *
 loader_malloc(uint64 size, char *error_buf, uint32 error_buf_size)
 {
@@ -310,6 +329,26 @@ load_init_expr(const uint8 **p_buf, const uint8 *buf_end,
             for (i = 0; i < sizeof(float64); i++)
                 *p_float++ = *p++;
             break;
+#if WASM_ENABLE_SIMD != 0
+        case INIT_EXPR_TYPE_V128_CONST:
+        {
+            uint64 high, low;
+
+            bh_assert(type == VALUE_TYPE_V128);
+
+            CHECK_BUF(p, p_end, 1);
+            flag = read_uint8(p);
+            (void)flag;
+
+            CHECK_BUF(p, p_end, 16);
+            wasm_runtime_read_v128(p, &high, &low);
+            p += 16;
+
+            init_expr->u.v128.i64x2[0] = high;
+            init_expr->u.v128.i64x2[1] = low;
+            break;
+        }
+#endif /* end of WASM_ENABLE_SIMD */
 #if WASM_ENABLE_REF_TYPES != 0
         case INIT_EXPR_TYPE_FUNCREF_CONST:
         {
@@ -1826,6 +1865,15 @@ init_fast_jit_functions(WASMModule *module, char *error_buf,
         module->fast_jit_thread_locks_inited[i] = true;
     }
 
+#if WASM_ENABLE_FAST_JIT_OSR != 0 && WASM_ENABLE_LAZY_JIT != 0
+    if (os_mutex_init(&module->fast_jit_hot_func_lock) != 0) {
+        set_error_buf(error_buf, error_buf_size,
+                      "init fast jit hot function lock failed");
+        return false;
+    }
+    module->fast_jit_hot_func_lock_inited = true;
+#endif
+
     return true;
 }
 #endif /* end of WASM_ENABLE_FAST_JIT != 0 */
@@ -2000,6 +2048,123 @@ init_llvm_jit_functions_stage2_callback(void *arg)
 }
 #endif
 
+#if WASM_ENABLE_JIT != 0
+/* Compile the llvm jit functions of the partition led by function i,
+   i.e. functions i + j * WASM_ORC_JIT_BACKEND_THREAD_NUM, in which j is
+   less than WASM_ORC_JIT_COMPILE_THREAD_NUM */
+static bool
+compile_llvm_jit_partition(WASMModule *module, AOTCompContext *comp_ctx,
+                           uint32 i)
+{
+    uint32 group_stride = WASM_ORC_JIT_BACKEND_THREAD_NUM;
+    uint32 func_count = module->function_count;
+    LLVMOrcJITTargetAddress func_addr = 0;
+    LLVMErrorRef error;
+    char func_name[48];
+    typedef void (*F)(void);
+    union {
+        F f;
+        void *v;
+    } u;
+    uint32 j;
+
+    snprintf(func_name, sizeof(func_name), "%s%d%s", AOT_FUNC_PREFIX, i,
+             "_wrapper");
+    LOG_DEBUG("compile llvm jit func %s", func_name);
+    error = LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr, func_name);
+    if (error != LLVMErrorSuccess) {
+        char *err_msg = LLVMGetErrorMessage(error);
+        os_printf("failed to compile llvm jit function %u: %s", i, err_msg);
+        LLVMDisposeErrorMessage(err_msg);
+        return false;
+    }
+
+    /* Call the jit wrapper function to trigger its compilation, so as
+       to compile the actual jit functions, since we add the latter to
+       function list in the PartitionFunction callback */
+    u.v = (void *)func_addr;
+    u.f();
+
+    for (j = 0; j < WASM_ORC_JIT_COMPILE_THREAD_NUM; j++) {
+        if (i + j * group_stride < func_count) {
+            module->func_ptrs_compiled[i + j * group_stride] = true;
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
+            snprintf(func_name, sizeof(func_name), "%s%d", AOT_FUNC_PREFIX,
+                     i + j * group_stride);
+            error = LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr,
+                                           func_name);
+            if (error != LLVMErrorSuccess) {
+                char *err_msg = LLVMGetErrorMessage(error);
+                os_printf("failed to compile llvm jit function %u: %s", i,
+                          err_msg);
+                LLVMDisposeErrorMessage(err_msg);
+                /* Ignore current llvm jit func, as its func ptr is
+                   previous set to call_to_fast_jit, which also works */
+                continue;
+            }
+
+            jit_compiler_set_llvm_jit_func_ptr(
+                module, i + j * group_stride + module->import_function_count,
+                (void *)func_addr);
+
+            /* Try to switch to call this llvm jit funtion instead of
+               fast jit function from fast jit jitted code */
+            jit_compiler_set_call_to_llvm_jit(
+                module, i + j * group_stride + module->import_function_count);
+#endif
+        }
+    }
+
+    return true;
+}
+#endif
+
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
+    && WASM_ENABLE_LAZY_JIT != 0
+/* Get the leader of the hottest partition of the group which hasn't been
+   compiled by llvm jit. A partition is hot once one of its functions
+   reaches LLVM_JIT_TIERUP_THRESHOLD, and its hotness is the sum of the
+   calls and loop iterations counted by the fast jit jitted code of its
+   functions. Return -1 if there is no hot partition to compile, and set
+   *p_all_done if all partitions of the group were compiled */
+static uint32
+get_hottest_llvm_jit_partition(WASMModule *module, uint32 group_idx,
+                               bool *p_all_done)
+{
+    uint32 group_stride = WASM_ORC_JIT_BACKEND_THREAD_NUM;
+    uint32 func_count = module->function_count;
+    uint32 i, j, func_hotness, hottest = (uint32)-1;
+    uint64 hotness, max_hotness = 0;
+    bool all_done = true, is_hot;
+
+    for (i = group_idx; i < func_count;
+         i += group_stride * WASM_ORC_JIT_COMPILE_THREAD_NUM) {
+        if (module->func_ptrs_compiled[i])
+            continue;
+
+        all_done = false;
+        hotness = 0;
+        is_hot = false;
+        for (j = 0; j < WASM_ORC_JIT_COMPILE_THREAD_NUM; j++) {
+            if (i + j * group_stride < func_count) {
+                func_hotness =
+                    module->functions[i + j * group_stride]->llvm_jit_hotness;
+                if (func_hotness >= LLVM_JIT_TIERUP_THRESHOLD)
+                    is_hot = true;
+                hotness += func_hotness;
+            }
+        }
+        if (is_hot && hotness > max_hotness) {
+            max_hotness = hotness;
+            hottest = i;
+        }
+    }
+
+    *p_all_done = all_done;
+    return hottest;
+}
+#endif
+
 #if WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0
 /* The callback function to compile jit functions */
 static void *
@@ -2014,10 +2179,20 @@ orcjit_thread_callback(void *arg)
     uint32 group_stride = WASM_ORC_JIT_BACKEND_THREAD_NUM;
     uint32 func_count = module->function_count;
     uint32 i;
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
+    && WASM_ENABLE_LAZY_JIT != 0
+    uint64 start_time = os_time_get_boot_microsecond();
+#endif
 
 #if WASM_ENABLE_FAST_JIT != 0
     /* Compile fast jit funcitons of this group */
     for (i = group_idx; i < func_count; i += group_stride) {
+#if WASM_ENABLE_FAST_JIT_OSR != 0 && WASM_ENABLE_LAZY_JIT != 0
+        /* Compile the functions got hot in the interpreter firstly */
+        if (!jit_compiler_compile_hot_functions(module)) {
+            os_printf("failed to compile hot fast jit function\n");
+        }
+#endif
         if (!jit_compiler_compile(module, i + module->import_function_count)) {
             os_printf("failed to compile fast jit function %u\n", i);
             break;
@@ -2027,6 +2202,9 @@ orcjit_thread_callback(void *arg)
             return NULL;
         }
     }
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    jit_persistent_cache_group_done(module, i >= func_count);
+#endif
 #if WASM_ENABLE_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
     os_mutex_lock(&module->tierup_wait_lock);
     module->fast_jit_ready_groups++;
@@ -2076,73 +2254,49 @@ orcjit_thread_callback(void *arg)
 #endif
 
 #if WASM_ENABLE_JIT != 0
-    /* Compile llvm jit functions of this group */
-    for (i = group_idx; i < func_count;
-         i += group_stride * WASM_ORC_JIT_COMPILE_THREAD_NUM) {
-        LLVMOrcJITTargetAddress func_addr = 0;
-        LLVMErrorRef error;
-        char func_name[48];
-        typedef void (*F)(void);
-        union {
-            F f;
-            void *v;
-        } u;
-        uint32 j;
-
-        snprintf(func_name, sizeof(func_name), "%s%d%s", AOT_FUNC_PREFIX, i,
-                 "_wrapper");
-        LOG_DEBUG("compile llvm jit func %s", func_name);
-        error =
-            LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr, func_name);
-        if (error != LLVMErrorSuccess) {
-            char *err_msg = LLVMGetErrorMessage(error);
-            os_printf("failed to compile llvm jit function %u: %s", i, err_msg);
-            LLVMDisposeErrorMessage(err_msg);
-            break;
-        }
-
-        /* Call the jit wrapper function to trigger its compilation, so as
-           to compile the actual jit functions, since we add the latter to
-           function list in the PartitionFunction callback */
-        u.v = (void *)func_addr;
-        u.f();
-
-        for (j = 0; j < WASM_ORC_JIT_COMPILE_THREAD_NUM; j++) {
-            if (i + j * group_stride < func_count) {
-                module->func_ptrs_compiled[i + j * group_stride] = true;
 #if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
-                snprintf(func_name, sizeof(func_name), "%s%d", AOT_FUNC_PREFIX,
-                         i + j * group_stride);
-                error = LLVMOrcLLLazyJITLookup(comp_ctx->orc_jit, &func_addr,
-                                               func_name);
-                if (error != LLVMErrorSuccess) {
-                    char *err_msg = LLVMGetErrorMessage(error);
-                    os_printf("failed to compile llvm jit function %u: %s", i,
-                              err_msg);
-                    LLVMDisposeErrorMessage(err_msg);
-                    /* Ignore current llvm jit func, as its func ptr is
-                       previous set to call_to_fast_jit, which also works */
-                    continue;
-                }
-
-                jit_compiler_set_llvm_jit_func_ptr(
-                    module,
-                    i + j * group_stride + module->import_function_count,
-                    (void *)func_addr);
+    /* Compile llvm jit functions of this group, the hottest ones firstly,
+       the cold ones keep running the fast jit jitted code until they get
+       hot, so as to reach the peak performance earlier */
+    while (!module->orcjit_stop_compiling) {
+        uint32 hot_func_count;
+        bool all_done;
+
+        os_mutex_lock(&module->tierup_wait_lock);
+        hot_func_count = module->llvm_jit_hot_func_count;
+        os_mutex_unlock(&module->tierup_wait_lock);
+
+        i = get_hottest_llvm_jit_partition(module, group_idx, &all_done);
+        if (all_done)
+            break;
 
-                /* Try to switch to call this llvm jit funtion instead of
-                   fast jit function from fast jit jitted code */
-                jit_compiler_set_call_to_llvm_jit(
-                    module,
-                    i + j * group_stride + module->import_function_count);
-#endif
-            }
+        if (i == (uint32)-1) {
+            /* No hot function to compile, sleep until the jitted code
+               reports that another function got hot */
+            os_mutex_lock(&module->tierup_wait_lock);
+            while (hot_func_count == module->llvm_jit_hot_func_count
+                   && !module->orcjit_stop_compiling)
+                os_cond_wait(&module->tierup_wait_cond,
+                             &module->tierup_wait_lock);
+            os_mutex_unlock(&module->tierup_wait_lock);
+            continue;
         }
 
-        if (module->orcjit_stop_compiling) {
+        if (!compile_llvm_jit_partition(module, comp_ctx, i))
+            break;
+        LOG_VERBOSE("promoted llvm jit func %u in %" PRIu64 " ms", i,
+                    (os_time_get_boot_microsecond() - start_time) / 1000);
+    }
+#else
+    /* Compile llvm jit functions of this group */
+    for (i = group_idx; i < func_count;
+         i += group_stride * WASM_ORC_JIT_COMPILE_THREAD_NUM) {
+        if (!compile_llvm_jit_partition(module, comp_ctx, i)
+            || module->orcjit_stop_compiling) {
             break;
         }
     }
+#endif
 #endif
 
     return NULL;
@@ -2154,7 +2308,18 @@ orcjit_stop_compile_threads(WASMModule *module)
     uint32 i, thread_num = (uint32)(sizeof(module->orcjit_thread_args)
                                     / sizeof(OrcJitThreadArg));
 
-    module->orcjit_stop_compiling = true;
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
+    && WASM_ENABLE_LAZY_JIT != 0
+    if (module->tierup_wait_lock_inited) {
+        /* Wake up the threads waiting for hot functions */
+        os_mutex_lock(&module->tierup_wait_lock);
+        module->orcjit_stop_compiling = true;
+        os_cond_broadcast(&module->tierup_wait_cond);
+        os_mutex_unlock(&module->tierup_wait_lock);
+    }
+    else
+#endif
+        module->orcjit_stop_compiling = true;
     for (i = 0; i < thread_num; i++) {
         if (module->orcjit_threads[i])
             os_thread_join(module->orcjit_threads[i], NULL);
@@ -2171,6 +2336,16 @@ compile_jit_functions(WASMModule *module, char *error_buf,
 
     bh_print_time("Begin to compile jit functions");
 
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    /* No need to compile if all the functions are loaded from the cache */
+    if (jit_persistent_cache_load(
+            module, module->function_count < thread_num ? module->function_count
+                                                        : thread_num)) {
+        bh_print_time("End load jit functions from cache");
+        return true;
+    }
+#endif
+
     /* Create threads to compile the jit functions */
     for (i = 0; i < thread_num && i < module->function_count; i++) {
 #if WASM_ENABLE_JIT != 0
@@ -3013,6 +3188,12 @@ wasm_loader_unload(WASMModule *module)
                     jit_code_cache_free(
                         module->functions[i]->fast_jit_jitted_code);
                 }
+#if WASM_ENABLE_FAST_JIT_OSR != 0
+                if (module->functions[i]->fast_jit_osr_entries) {
+                    wasm_runtime_free(
+                        module->functions[i]->fast_jit_osr_entries);
+                }
+#endif
 #if WASM_ENABLE_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
                 if (module->functions[i]->call_to_fast_jit_from_llvm_jit) {
                     jit_code_cache_free(
@@ -3081,6 +3262,10 @@ wasm_loader_unload(WASMModule *module)
 #endif
 
 #if WASM_ENABLE_FAST_JIT != 0
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    jit_persistent_cache_discard(module);
+#endif
+
     if (module->fast_jit_func_ptrs) {
         wasm_runtime_free(module->fast_jit_func_ptrs);
     }
@@ -3090,6 +3275,12 @@ wasm_loader_unload(WASMModule *module)
             os_mutex_destroy(&module->fast_jit_thread_locks[i]);
         }
     }
+
+#if WASM_ENABLE_FAST_JIT_OSR != 0 && WASM_ENABLE_LAZY_JIT != 0
+    if (module->fast_jit_hot_func_lock_inited) {
+        os_mutex_destroy(&module->fast_jit_hot_func_lock);
+    }
+#endif
 #endif
 
     wasm_runtime_free(module);
@@ -3258,6 +3449,10 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
             case WASM_OP_SELECT:
             case WASM_OP_DROP_64:
             case WASM_OP_SELECT_64:
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_DROP_128:
+            case WASM_OP_SELECT_128:
+#endif
                 break;
 #if WASM_ENABLE_REF_TYPES != 0
             case WASM_OP_SELECT_T:
@@ -3286,6 +3481,10 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
             case WASM_OP_SET_GLOBAL:
             case WASM_OP_GET_GLOBAL_64:
             case WASM_OP_SET_GLOBAL_64:
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_GET_GLOBAL_128:
+            case WASM_OP_SET_GLOBAL_128:
+#endif
             case WASM_OP_SET_GLOBAL_AUX_STACK:
                 skip_leb_uint32(p, p_end); /* localidx */
                 break;
@@ -3530,6 +3729,97 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
                 break;
             }
 
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_SIMD_PREFIX:
+            {
+                /* TODO: shall we ceate a table to be friendly to branch
+                 * prediction */
+                opcode = read_uint8(p);
+                /* follow the order of enum WASMSimdEXTOpcode in wasm_opcode.h
+                 */
+                switch (opcode) {
+                    case SIMD_v128_load:
+                    case SIMD_v128_load8x8_s:
+                    case SIMD_v128_load8x8_u:
+                    case SIMD_v128_load16x4_s:
+                    case SIMD_v128_load16x4_u:
+                    case SIMD_v128_load32x2_s:
+                    case SIMD_v128_load32x2_u:
+                    case SIMD_v128_load8_splat:
+                    case SIMD_v128_load16_splat:
+                    case SIMD_v128_load32_splat:
+                    case SIMD_v128_load64_splat:
+                    case SIMD_v128_store:
+                        /* memarg align */
+                        skip_leb_uint32(p, p_end);
+                        /* memarg offset*/
+                        skip_leb_uint32(p, p_end);
+                        break;
+
+                    case SIMD_v128_const:
+                    case SIMD_v8x16_shuffle:
+                        /* immByte[16] immLaneId[16] */
+                        CHECK_BUF1(p, p_end, 16);
+                        p += 16;
+                        break;
+
+                    case SIMD_i8x16_extract_lane_s:
+                    case SIMD_i8x16_extract_lane_u:
+                    case SIMD_i8x16_replace_lane:
+                    case SIMD_i16x8_extract_lane_s:
+                    case SIMD_i16x8_extract_lane_u:
+                    case SIMD_i16x8_replace_lane:
+                    case SIMD_i32x4_extract_lane:
+                    case SIMD_i32x4_replace_lane:
+                    case SIMD_i64x2_extract_lane:
+                    case SIMD_i64x2_replace_lane:
+                    case SIMD_f32x4_extract_lane:
+                    case SIMD_f32x4_replace_lane:
+                    case SIMD_f64x2_extract_lane:
+                    case SIMD_f64x2_replace_lane:
+                        /* ImmLaneId */
+                        CHECK_BUF(p, p_end, 1);
+                        p++;
+                        break;
+
+                    case SIMD_v128_load8_lane:
+                    case SIMD_v128_load16_lane:
+                    case SIMD_v128_load32_lane:
+                    case SIMD_v128_load64_lane:
+                    case SIMD_v128_store8_lane:
+                    case SIMD_v128_store16_lane:
+                    case SIMD_v128_store32_lane:
+                    case SIMD_v128_store64_lane:
+                        /* memarg align */
+                        skip_leb_uint32(p, p_end);
+                        /* memarg offset*/
+                        skip_leb_uint32(p, p_end);
+                        /* ImmLaneId */
+                        CHECK_BUF(p, p_end, 1);
+                        p++;
+                        break;
+
+                    case SIMD_v128_load32_zero:
+                    case SIMD_v128_load64_zero:
+                        /* memarg align */
+                        skip_leb_uint32(p, p_end);
+                        /* memarg offset*/
+                        skip_leb_uint32(p, p_end);
+                        break;
+
+                    default:
+                        /*
+                         * since latest SIMD specific used almost every value
+                         * from 0x00 to 0xff, the default branch will present
+                         * all opcodes without imm
+                         * https://github.com/WebAssembly/simd/blob/main/proposals/simd/NewOpcodes.md
+                         */
+                        break;
+                }
+                break;
+            }
+#endif /* end of WASM_ENABLE_SIMD */
+
 #if WASM_ENABLE_SHARED_MEMORY != 0
             case WASM_OP_ATOMIC_PREFIX:
             {
@@ -3563,6 +3853,10 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
 #define REF_I64_2 VALUE_TYPE_I64
 #define REF_F64_1 VALUE_TYPE_F64
 #define REF_F64_2 VALUE_TYPE_F64
+#define REF_V128_1 VALUE_TYPE_V128
+#define REF_V128_2 VALUE_TYPE_V128
+#define REF_V128_3 VALUE_TYPE_V128
+#define REF_V128_4 VALUE_TYPE_V128
 #define REF_ANY VALUE_TYPE_ANY
 
 #if WASM_ENABLE_FAST_INTERP != 0
@@ -3650,6 +3944,11 @@ typedef struct WASMLoaderContext {
      * than the final code_compiled_size, we record the peak size to ensure
      * there will not be invalid memory access during second traverse */
     uint32 code_compiled_peak_size;
+    /* The end of the last emitted i32.add and local.tee in the compiled
+     * code, they are fused with the following ops into superinstructions,
+     * see wasm_loader_get_code_compiled_pos. 0 if there is none. */
+    uintptr_t i32_add_end;
+    uintptr_t tee_local_fast_end;
 #endif
 } WASMLoaderContext;
 
@@ -3774,7 +4073,11 @@ check_stack_top_values(uint8 *frame_ref, int32 stack_cell_num, uint8 type,
                        char *error_buf, uint32 error_buf_size)
 {
     bh_assert(!((is_32bit_type(type) && stack_cell_num < 1)
-                || (is_64bit_type(type) && stack_cell_num < 2)));
+                || (is_64bit_type(type) && stack_cell_num < 2)
+#if WASM_ENABLE_SIMD != 0
+                || (type == VALUE_TYPE_V128 && stack_cell_num < 4)
+#endif
+                    ));
 
     bh_assert(!(
         (type == VALUE_TYPE_I32 && *(frame_ref - 1) != REF_I32)
@@ -3783,7 +4086,14 @@ check_stack_top_values(uint8 *frame_ref, int32 stack_cell_num, uint8 type,
             && (*(frame_ref - 2) != REF_I64_1 || *(frame_ref - 1) != REF_I64_2))
         || (type == VALUE_TYPE_F64
             && (*(frame_ref - 2) != REF_F64_1
-                || *(frame_ref - 1) != REF_F64_2))));
+                || *(frame_ref - 1) != REF_F64_2))
+#if WASM_ENABLE_SIMD != 0
+        || (type == VALUE_TYPE_V128
+            && (*(frame_ref - 4) != REF_V128_1 || *(frame_ref - 3) != REF_V128_2
+                || *(frame_ref - 2) != REF_V128_3
+                || *(frame_ref - 1) != REF_V128_4))
+#endif
+            ));
     return true;
 }
 
@@ -3901,6 +4211,20 @@ wasm_loader_push_frame_ref(WASMLoaderContext *ctx, uint8 type, char *error_buf,
         return false;
     *ctx->frame_ref++ = type;
     ctx->stack_cell_num++;
+
+#if WASM_ENABLE_SIMD != 0
+    if (type == VALUE_TYPE_V128) {
+        if (!check_stack_push(ctx, error_buf, error_buf_size))
+            return false;
+        *ctx->frame_ref++ = type;
+        ctx->stack_cell_num++;
+        if (!check_stack_push(ctx, error_buf, error_buf_size))
+            return false;
+        *ctx->frame_ref++ = type;
+        ctx->stack_cell_num++;
+    }
+#endif
+
     if (ctx->stack_cell_num > ctx->max_stack_cell_num) {
         ctx->max_stack_cell_num = ctx->stack_cell_num;
         bh_assert(ctx->max_stack_cell_num <= UINT16_MAX);
@@ -3935,6 +4259,13 @@ wasm_loader_pop_frame_ref(WASMLoaderContext *ctx, uint8 type, char *error_buf,
 
     ctx->frame_ref--;
     ctx->stack_cell_num--;
+
+#if WASM_ENABLE_SIMD != 0
+    if (type == VALUE_TYPE_V128) {
+        ctx->frame_ref -= 2;
+        ctx->stack_cell_num -= 2;
+    }
+#endif
     return true;
 }
 
@@ -4178,6 +4509,8 @@ wasm_loader_ctx_reinit(WASMLoaderContext *ctx)
     /* init preserved local offsets */
     ctx->preserved_local_offset = ctx->max_dynamic_offset;
 
+    ctx->i32_add_end = ctx->tee_local_fast_end = 0;
+
     /* const buf is reserved */
     return true;
 }
@@ -4310,6 +4643,162 @@ wasm_loader_emit_backspace(WASMLoaderContext *ctx, uint32 size)
     }
 }
 
+/* Get the current position of the compiled code, which is the code size in
+   the first traverse and the code address in the second traverse */
+static uintptr_t
+wasm_loader_get_code_compiled_pos(WASMLoaderContext *ctx)
+{
+    return ctx->p_code_compiled ? (uintptr_t)ctx->p_code_compiled
+                                : (uintptr_t)ctx->code_compiled_size;
+}
+
+/* Remove the last emitted bytes and copy them to the buffer, the buffer is
+   only filled in the second traverse */
+static void
+wasm_loader_pop_bytes(WASMLoaderContext *ctx, uint8 *buf, uint32 size)
+{
+    if (ctx->p_code_compiled)
+        bh_memcpy_s(buf, size, ctx->p_code_compiled - size, size);
+    wasm_loader_emit_backspace(ctx, size);
+}
+
+static void
+wasm_loader_emit_bytes(WASMLoaderContext *ctx, const uint8 *buf, uint32 size)
+{
+    if (ctx->p_code_compiled) {
+        bh_memcpy_s(ctx->p_code_compiled,
+                    (uint32)(ctx->p_code_compiled_end - ctx->p_code_compiled),
+                    buf, size);
+        ctx->p_code_compiled += size;
+    }
+    else {
+        increase_compiled_code_space(ctx, size);
+    }
+}
+
+/* Replace the label which ends at p_code_compiled with the label of
+   another opcode, e.g. select with select_64 once the operand type is known */
+static void
+wasm_loader_patch_label(uint8 *p_code_compiled, uint8 opcode)
+{
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
+    *(void **)(p_code_compiled - sizeof(void *)) = handle_table[opcode];
+#else
+#if UINTPTR_MAX == UINT64_MAX
+    /* emit int32 relative offset in 64-bit target */
+    int32 offset =
+        (int32)((uint8 *)handle_table[opcode] - (uint8 *)handle_table[0]);
+    *(int32 *)(p_code_compiled - sizeof(int32)) = offset;
+#else
+    /* emit uint32 label address in 32-bit target */
+    *(uint32 *)(p_code_compiled - sizeof(uint32)) =
+        (uint32)(uintptr_t)handle_table[opcode];
+#endif
+#endif /* end of WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS */
+#else  /* else of WASM_ENABLE_LABELS_AS_VALUES */
+#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
+    *(p_code_compiled - 1) = opcode;
+#else
+    *(p_code_compiled - 2) = opcode;
+#endif /* end of WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS */
+#endif /* end of WASM_ENABLE_LABELS_AS_VALUES */
+}
+
+/* Replace the label of the last emitted op with the label of a
+   superinstruction, and keep the operand_size bytes of its operands */
+#define replace_last_label(opcode, operand_size)                         \
+    do {                                                                 \
+        uint8 last_operands[8];                                          \
+        bh_assert(operand_size <= sizeof(last_operands));                \
+        wasm_loader_pop_bytes(loader_ctx, last_operands, operand_size);  \
+        skip_label();                                                    \
+        emit_label(opcode);                                              \
+        wasm_loader_emit_bytes(loader_ctx, last_operands, operand_size); \
+    } while (0)
+
+#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
+#define TEE_LOCAL_FAST_OPERAND_SIZE (sizeof(uint8) + sizeof(int16))
+#else
+/* the local offset byte is padded to keep the operands aligned */
+#define TEE_LOCAL_FAST_OPERAND_SIZE (sizeof(uint16) + sizeof(int16))
+#endif
+
+/* Fuse br_if with the op before it into a superinstruction, which
+   computes the condition and branches in one dispatch. The label of br_if
+   has been emitted and its condition hasn't been popped, return true if
+   fused, and then the condition operand shouldn't be emitted */
+static bool
+fuse_br_if_with_last_op(WASMLoaderContext *loader_ctx, uint8 last_op)
+{
+    uint8 operands[sizeof(int16) * 3];
+    uint8 fused_op;
+    uintptr_t code_pos;
+
+    if ((loader_ctx->frame_csp - 1)->is_stack_polymorphic)
+        return false;
+
+    skip_label();
+    code_pos = wasm_loader_get_code_compiled_pos(loader_ctx);
+
+    if (last_op == WASM_OP_I32_EQZ) {
+        /* i32.eqz src dst => i32.eqz_br_if src */
+        wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
+        replace_last_label(EXT_OP_I32_EQZ_BR_IF, sizeof(int16));
+        return true;
+    }
+
+    if (last_op >= WASM_OP_I32_EQ && last_op <= WASM_OP_I32_GE_U) {
+        /* i32.cmp src2 src1 dst => i32.cmp_br_if src2 src1 */
+        fused_op = EXT_OP_I32_EQ_BR_IF + (last_op - WASM_OP_I32_EQ);
+        wasm_loader_pop_bytes(loader_ctx, operands, sizeof(int16) * 3);
+        skip_label();
+
+        if (loader_ctx->i32_add_end != 0
+            && loader_ctx->i32_add_end
+                   == wasm_loader_get_code_compiled_pos(loader_ctx)
+            && (last_op == WASM_OP_I32_NE || last_op == WASM_OP_I32_LT_S
+                || last_op == WASM_OP_I32_LT_U)) {
+            /* The compare follows an i32.add, e.g. the increment and the
+               check of a loop counter, fuse the three of them:
+               i32.add_cmp_br_if add_src2 add_src1 add_dst src2 src1 */
+            if (last_op == WASM_OP_I32_NE)
+                fused_op = EXT_OP_I32_ADD_NE_BR_IF;
+            else if (last_op == WASM_OP_I32_LT_S)
+                fused_op = EXT_OP_I32_ADD_LT_S_BR_IF;
+            else
+                fused_op = EXT_OP_I32_ADD_LT_U_BR_IF;
+            replace_last_label(fused_op, sizeof(int16) * 3);
+        }
+        else {
+            emit_label(fused_op);
+        }
+        wasm_loader_emit_bytes(loader_ctx, operands, sizeof(int16) * 2);
+        return true;
+    }
+
+    if ((last_op == WASM_OP_I32_ADD || last_op == WASM_OP_TEE_LOCAL)
+        && loader_ctx->i32_add_end != 0
+        && loader_ctx->i32_add_end == code_pos) {
+        /* The condition is the result of i32.add, which may be teed to a
+           local: i32.add_br_if src2 src1 dst */
+        replace_last_label(EXT_OP_I32_ADD_BR_IF, sizeof(int16) * 3);
+        return true;
+    }
+
+    if (last_op == WASM_OP_TEE_LOCAL
+        && loader_ctx->tee_local_fast_end != 0
+        && loader_ctx->tee_local_fast_end == code_pos) {
+        /* local.tee local src => local.tee_br_if local src */
+        replace_last_label(EXT_OP_TEE_LOCAL_FAST_BR_IF,
+                           TEE_LOCAL_FAST_OPERAND_SIZE);
+        return true;
+    }
+
+    emit_label(WASM_OP_BR_IF);
+    return false;
+}
+
 static bool
 preserve_referenced_local(WASMLoaderContext *loader_ctx, uint8 opcode,
                           uint32 local_index, uint32 local_type,
@@ -4339,6 +4828,13 @@ preserve_referenced_local(WASMLoaderContext *loader_ctx, uint8 opcode,
                         loader_ctx->preserved_local_offset++;
                     emit_label(EXT_OP_COPY_STACK_TOP);
                 }
+#if WASM_ENABLE_SIMD != 0
+                else if (local_type == VALUE_TYPE_V128) {
+                    if (loader_ctx->p_code_compiled)
+                        loader_ctx->preserved_local_offset += 4;
+                    emit_label(EXT_OP_COPY_STACK_TOP_V128);
+                }
+#endif
                 else {
                     if (loader_ctx->p_code_compiled)
                         loader_ctx->preserved_local_offset += 2;
@@ -4353,6 +4849,10 @@ preserve_referenced_local(WASMLoaderContext *loader_ctx, uint8 opcode,
 
         if (is_32bit_type(cur_type))
             i++;
+#if WASM_ENABLE_SIMD != 0
+        else if (cur_type == VALUE_TYPE_V128)
+            i += 4;
+#endif
         else
             i += 2;
     }
@@ -4384,6 +4884,11 @@ preserve_local_for_block(WASMLoaderContext *loader_ctx, uint8 opcode,
         if (is_32bit_type(cur_type == VALUE_TYPE_I32)) {
             i++;
         }
+#if WASM_ENABLE_SIMD != 0
+        else if (cur_type == VALUE_TYPE_V128) {
+            i += 4;
+        }
+#endif
         else {
             i += 2;
         }
@@ -4522,6 +5027,8 @@ wasm_loader_push_frame_offset(WASMLoaderContext *ctx, uint8 type,
                               bool disable_emit, int16 operand_offset,
                               char *error_buf, uint32 error_buf_size)
 {
+    uint32 cell_num = 2, i;
+
     if (type == VALUE_TYPE_VOID)
         return true;
 
@@ -4546,17 +5053,25 @@ wasm_loader_push_frame_offset(WASMLoaderContext *ctx, uint8 type,
     if (is_32bit_type(type))
         return true;
 
-    if (ctx->p_code_compiled == NULL) {
-        if (!check_offset_push(ctx, error_buf, error_buf_size))
-            return false;
-    }
+#if WASM_ENABLE_SIMD != 0
+    if (type == VALUE_TYPE_V128)
+        cell_num = 4;
+#endif
 
-    ctx->frame_offset++;
-    if (!disable_emit) {
-        ctx->dynamic_offset++;
-        if (ctx->dynamic_offset > ctx->max_dynamic_offset) {
-            ctx->max_dynamic_offset = ctx->dynamic_offset;
-            bh_assert(ctx->max_dynamic_offset < INT16_MAX);
+    /* the remaining cells of the value follow the first cell */
+    for (i = 1; i < cell_num; i++) {
+        if (ctx->p_code_compiled == NULL) {
+            if (!check_offset_push(ctx, error_buf, error_buf_size))
+                return false;
+        }
+
+        ctx->frame_offset++;
+        if (!disable_emit) {
+            ctx->dynamic_offset++;
+            if (ctx->dynamic_offset > ctx->max_dynamic_offset) {
+                ctx->max_dynamic_offset = ctx->dynamic_offset;
+                bh_assert(ctx->max_dynamic_offset < INT16_MAX);
+            }
         }
     }
     return true;
@@ -4597,6 +5112,17 @@ wasm_loader_pop_frame_offset(WASMLoaderContext *ctx, uint8 type,
             && (*(ctx->frame_offset) < ctx->max_dynamic_offset))
             ctx->dynamic_offset -= 1;
     }
+#if WASM_ENABLE_SIMD != 0
+    else if (type == VALUE_TYPE_V128) {
+        if (!check_offset_pop(ctx, 4))
+            return true;
+
+        ctx->frame_offset -= 4;
+        if ((*(ctx->frame_offset) > ctx->start_dynamic_offset)
+            && (*(ctx->frame_offset) < ctx->max_dynamic_offset))
+            ctx->dynamic_offset -= 4;
+    }
+#endif
     else {
         if (!check_offset_pop(ctx, 2))
             return true;
@@ -4686,6 +5212,10 @@ wasm_loader_get_const_offset(WASMLoaderContext *ctx, uint8 type, void *value,
                     && *(int32 *)value == c->value.i32)
                 || (type == VALUE_TYPE_EXTERNREF
                     && *(int32 *)value == c->value.i32)
+#endif
+#if WASM_ENABLE_SIMD != 0
+                || (type == VALUE_TYPE_V128
+                    && (0 == memcmp(value, &(c->value.v128), sizeof(V128))))
 #endif
                 || (type == VALUE_TYPE_F64
                     && (0 == memcmp(value, &(c->value.f64), sizeof(float64))))
@@ -4695,20 +5225,12 @@ wasm_loader_get_const_offset(WASMLoaderContext *ctx, uint8 type, void *value,
             operand_offset = c->slot_index;
             break;
         }
-        if (c->value_type == VALUE_TYPE_I64 || c->value_type == VALUE_TYPE_F64)
-            operand_offset += 2;
-        else
-            operand_offset += 1;
+        operand_offset += (int16)wasm_value_type_cell_num(c->value_type);
     }
 
     if ((uint8 *)c == ctx->const_buf + ctx->num_const * sizeof(Const)) {
         /* New constant, append to the const buffer */
-        if ((type == VALUE_TYPE_F64) || (type == VALUE_TYPE_I64)) {
-            bytes_to_increase = 2;
-        }
-        else {
-            bytes_to_increase = 1;
-        }
+        bytes_to_increase = (int8)wasm_value_type_cell_num(type);
 
         /* The max cell num of const buffer is 32768 since the valid index range
          * is -32768 ~ -1. Return an invalid index 0 to indicate the buffer is
@@ -4748,6 +5270,15 @@ wasm_loader_get_const_offset(WASMLoaderContext *ctx, uint8 type, void *value,
                 c->value.i32 = *(int32 *)value;
                 ctx->const_cell_num++;
                 break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                bh_memcpy_s(&(c->value.v128), sizeof(WASMValue), value,
+                            sizeof(V128));
+                ctx->const_cell_num += 4;
+                /* use the last cell like i64/f64 const */
+                operand_offset += 3;
+                break;
+#endif
 #if WASM_ENABLE_REF_TYPES != 0
             case VALUE_TYPE_EXTERNREF:
             case VALUE_TYPE_FUNCREF:
@@ -4819,6 +5350,14 @@ fail:
             goto fail;                                                       \
     } while (0)
 
+#define PUSH_V128()                                                          \
+    do {                                                                     \
+        if (!wasm_loader_push_frame_ref_offset(loader_ctx, VALUE_TYPE_V128,  \
+                                               disable_emit, operand_offset, \
+                                               error_buf, error_buf_size))   \
+            goto fail;                                                       \
+    } while (0)
+
 #define PUSH_FUNCREF()                                                         \
     do {                                                                       \
         if (!wasm_loader_push_frame_ref_offset(loader_ctx, VALUE_TYPE_FUNCREF, \
@@ -4855,6 +5394,13 @@ fail:
             goto fail;                                                    \
     } while (0)
 
+#define POP_V128()                                                         \
+    do {                                                                   \
+        if (!wasm_loader_pop_frame_ref_offset(loader_ctx, VALUE_TYPE_V128, \
+                                              error_buf, error_buf_size))  \
+            goto fail;                                                     \
+    } while (0)
+
 #define PUSH_OFFSET_TYPE(type)                                              \
     do {                                                                    \
         if (!(wasm_loader_push_frame_offset(loader_ctx, type, disable_emit, \
@@ -4917,6 +5463,13 @@ fail:
             goto fail;                                                \
     } while (0)
 
+#define PUSH_V128()                                                   \
+    do {                                                              \
+        if (!(wasm_loader_push_frame_ref(loader_ctx, VALUE_TYPE_V128, \
+                                         error_buf, error_buf_size))) \
+            goto fail;                                                \
+    } while (0)
+
 #define PUSH_FUNCREF()                                                   \
     do {                                                                 \
         if (!(wasm_loader_push_frame_ref(loader_ctx, VALUE_TYPE_FUNCREF, \
@@ -4952,6 +5505,13 @@ fail:
             goto fail;                                                         \
     } while (0)
 
+#define POP_V128()                                                   \
+    do {                                                             \
+        if (!(wasm_loader_pop_frame_ref(loader_ctx, VALUE_TYPE_V128, \
+                                        error_buf, error_buf_size))) \
+            goto fail;                                               \
+    } while (0)
+
 #define POP_FUNCREF()                                                   \
     do {                                                                \
         if (!(wasm_loader_pop_frame_ref(loader_ctx, VALUE_TYPE_FUNCREF, \
@@ -4995,17 +5555,21 @@ reserve_block_ret(WASMLoaderContext *loader_ctx, uint8 opcode,
 
     return_count = block_type_get_result_types(block_type, &return_types);
 
-    /* If there is only one return value, use EXT_OP_COPY_STACK_TOP/_I64 instead
-     * of EXT_OP_COPY_STACK_VALUES for interpreter performance. */
+    /* If there is only one return value, use EXT_OP_COPY_STACK_TOP/_I64/_V128
+     * instead of EXT_OP_COPY_STACK_VALUES for interpreter performance. */
     if (return_count == 1) {
         uint8 cell = (uint8)wasm_value_type_cell_num(return_types[0]);
-        if (cell <= 2 /* V128 isn't supported whose cell num is 4 */
-            && block->dynamic_offset != *(loader_ctx->frame_offset - cell)) {
+        if (block->dynamic_offset != *(loader_ctx->frame_offset - cell)) {
             /* insert op_copy before else opcode */
             if (opcode == WASM_OP_ELSE)
                 skip_label();
-            emit_label(cell == 1 ? EXT_OP_COPY_STACK_TOP
-                                 : EXT_OP_COPY_STACK_TOP_I64);
+#if WASM_ENABLE_SIMD != 0
+            if (cell == 4)
+                emit_label(EXT_OP_COPY_STACK_TOP_V128);
+            else
+#endif
+                emit_label(cell == 1 ? EXT_OP_COPY_STACK_TOP
+                                     : EXT_OP_COPY_STACK_TOP_I64);
             emit_operand(loader_ctx, *(loader_ctx->frame_offset - cell));
             emit_operand(loader_ctx, block->dynamic_offset);
 
@@ -5498,7 +6062,7 @@ wasm_loader_prepare_bytecode(WASMModule *module, WASMFunction *func,
     uint8 *func_const_end, *func_const = NULL;
     int16 operand_offset = 0;
     uint8 last_op = 0;
-    bool disable_emit, preserve_local = false;
+    bool disable_emit, preserve_local = false, fuse_add_load;
     float32 f32_const;
     float64 f64_const;
 
@@ -5828,7 +6392,15 @@ re_scan:
 
             case WASM_OP_BR_IF:
             {
+#if WASM_ENABLE_FAST_INTERP != 0
+                bool fused = fuse_br_if_with_last_op(loader_ctx, last_op);
+#endif
                 POP_I32();
+#if WASM_ENABLE_FAST_INTERP != 0
+                /* The condition is computed by the superinstruction */
+                if (fused)
+                    wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
+#endif
 
                 if (!(frame_csp_tmp = check_branch_block(
                           loader_ctx, &p, p_end, error_buf, error_buf_size)))
@@ -6129,6 +6701,24 @@ re_scan:
                             loader_ctx->dynamic_offset -= 2;
 #endif
                     }
+#if WASM_ENABLE_SIMD != 0
+                    else if (*(loader_ctx->frame_ref - 1) == REF_V128_1) {
+                        loader_ctx->frame_ref -= 4;
+                        loader_ctx->stack_cell_num -= 4;
+#if WASM_ENABLE_FAST_INTERP == 0
+                        *(p - 1) = WASM_OP_DROP_128;
+#endif
+#if WASM_ENABLE_FAST_INTERP != 0
+                        skip_label();
+                        loader_ctx->frame_offset -= 4;
+                        if ((*(loader_ctx->frame_offset)
+                             > loader_ctx->start_dynamic_offset)
+                            && (*(loader_ctx->frame_offset)
+                                < loader_ctx->max_dynamic_offset))
+                            loader_ctx->dynamic_offset -= 4;
+#endif
+                    }
+#endif
                     else {
                         bh_assert(0);
                     }
@@ -6169,39 +6759,23 @@ re_scan:
                             *(p - 1) = WASM_OP_SELECT_64;
 #endif
 #if WASM_ENABLE_FAST_INTERP != 0
-                            if (loader_ctx->p_code_compiled) {
-                                uint8 opcode_tmp = WASM_OP_SELECT_64;
-#if WASM_ENABLE_LABELS_AS_VALUES != 0
-#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
-                                *(void **)(p_code_compiled_tmp
-                                           - sizeof(void *)) =
-                                    handle_table[opcode_tmp];
-#else
-#if UINTPTR_MAX == UINT64_MAX
-                                /* emit int32 relative offset in 64-bit target
-                                 */
-                                int32 offset =
-                                    (int32)((uint8 *)handle_table[opcode_tmp]
-                                            - (uint8 *)handle_table[0]);
-                                *(int32 *)(p_code_compiled_tmp
-                                           - sizeof(int32)) = offset;
-#else
-                                /* emit uint32 label address in 32-bit target */
-                                *(uint32 *)(p_code_compiled_tmp
-                                            - sizeof(uint32)) =
-                                    (uint32)(uintptr_t)handle_table[opcode_tmp];
+                            if (loader_ctx->p_code_compiled)
+                                wasm_loader_patch_label(p_code_compiled_tmp,
+                                                        WASM_OP_SELECT_64);
 #endif
-#endif /* end of WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS */
-#else  /* else of WASM_ENABLE_LABELS_AS_VALUES */
-#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
-                                *(p_code_compiled_tmp - 1) = opcode_tmp;
-#else
-                                *(p_code_compiled_tmp - 2) = opcode_tmp;
-#endif /* end of WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS */
-#endif /* end of WASM_ENABLE_LABELS_AS_VALUES */
-                            }
+                            break;
+#if WASM_ENABLE_SIMD != 0
+                        case REF_V128_4:
+#if WASM_ENABLE_FAST_INTERP == 0
+                            *(p - 1) = WASM_OP_SELECT_128;
+#endif
+#if WASM_ENABLE_FAST_INTERP != 0
+                            if (loader_ctx->p_code_compiled)
+                                wasm_loader_patch_label(p_code_compiled_tmp,
+                                                        WASM_OP_SELECT_128);
 #endif
                             break;
+#endif /* WASM_ENABLE_SIMD != 0 */
                     }
 
                     ref_type = *(loader_ctx->frame_ref - 1);
@@ -6260,30 +6834,12 @@ re_scan:
                     if (ref_type == VALUE_TYPE_F64
                         || ref_type == VALUE_TYPE_I64)
                         opcode_tmp = WASM_OP_SELECT_64;
-
-#if WASM_ENABLE_LABELS_AS_VALUES != 0
-#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
-                    *(void **)(p_code_compiled_tmp - sizeof(void *)) =
-                        handle_table[opcode_tmp];
-#else
-#if UINTPTR_MAX == UINT64_MAX
-                    /* emit int32 relative offset in 64-bit target */
-                    int32 offset = (int32)((uint8 *)handle_table[opcode_tmp]
-                                           - (uint8 *)handle_table[0]);
-                    *(int32 *)(p_code_compiled_tmp - sizeof(int32)) = offset;
-#else
-                    /* emit uint32 label address in 32-bit target */
-                    *(uint32 *)(p_code_compiled_tmp - sizeof(uint32)) =
-                        (uint32)(uintptr_t)handle_table[opcode_tmp];
+#if WASM_ENABLE_SIMD != 0
+                    else if (ref_type == VALUE_TYPE_V128)
+                        opcode_tmp = WASM_OP_SELECT_128;
 #endif
-#endif /* end of WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS */
-#else  /* else of WASM_ENABLE_LABELS_AS_VALUES */
-#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
-                    *(p_code_compiled_tmp - 1) = opcode_tmp;
-#else
-                    *(p_code_compiled_tmp - 2) = opcode_tmp;
-#endif /* end of WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS */
-#endif /* end of WASM_ENABLE_LABELS_AS_VALUES */
+
+                    wasm_loader_patch_label(p_code_compiled_tmp, opcode_tmp);
                 }
 #endif /* WASM_ENABLE_FAST_INTERP != 0 */
 
@@ -6441,7 +6997,11 @@ re_scan:
 #else
 #if (WASM_ENABLE_WAMR_COMPILER == 0) && (WASM_ENABLE_JIT == 0) \
     && (WASM_ENABLE_FAST_JIT == 0)
-                if (local_offset < 0x80) {
+                if (local_offset < 0x80
+#if WASM_ENABLE_SIMD != 0
+                    && local_type != VALUE_TYPE_V128
+#endif
+                ) {
                     *p_org++ = EXT_OP_GET_LOCAL_FAST;
                     if (is_32bit_type(local_type))
                         *p_org++ = (uint8)local_offset;
@@ -6467,6 +7027,17 @@ re_scan:
                         &preserve_local, error_buf, error_buf_size)))
                     goto fail;
 
+#if WASM_ENABLE_SIMD != 0
+                if (local_type == VALUE_TYPE_V128) {
+                    /* copy the value from the stack top to the local */
+                    skip_label();
+                    emit_label(EXT_OP_COPY_STACK_TOP_V128);
+                    POP_OFFSET_TYPE(local_type);
+                    emit_operand(loader_ctx, local_offset);
+                    break;
+                }
+#endif
+
                 if (local_offset < 256) {
                     skip_label();
                     if ((!preserve_local) && (LAST_OP_OUTPUT_I32())) {
@@ -6502,7 +7073,11 @@ re_scan:
 #else
 #if (WASM_ENABLE_WAMR_COMPILER == 0) && (WASM_ENABLE_JIT == 0) \
     && (WASM_ENABLE_FAST_JIT == 0)
-                if (local_offset < 0x80) {
+                if (local_offset < 0x80
+#if WASM_ENABLE_SIMD != 0
+                    && local_type != VALUE_TYPE_V128
+#endif
+                ) {
                     *p_org++ = EXT_OP_SET_LOCAL_FAST;
                     if (is_32bit_type(local_type))
                         *p_org++ = (uint8)local_offset;
@@ -6539,6 +7114,38 @@ re_scan:
                         &preserve_local, error_buf, error_buf_size)))
                     goto fail;
 
+                loader_ctx->tee_local_fast_end = 0;
+#if WASM_ENABLE_SIMD != 0
+                if (local_type == VALUE_TYPE_V128) {
+                    /* copy the value from the stack top to the local */
+                    skip_label();
+                    emit_label(EXT_OP_COPY_STACK_TOP_V128);
+                    emit_operand(loader_ctx, *(loader_ctx->frame_offset - 4));
+                    emit_operand(loader_ctx, local_offset);
+                    break;
+                }
+#endif
+
+                if (local_offset < 256 && !preserve_local
+                    && !cur_block->is_stack_polymorphic
+                    && ((LAST_OP_OUTPUT_I32()) || (LAST_OP_OUTPUT_I64()))) {
+                    /* Fold local.tee into the last op: the op outputs to
+                       the local, which is pushed like local.get */
+                    skip_label();
+                    if (loader_ctx->p_code_compiled)
+                        STORE_U16(loader_ctx->p_code_compiled - 2,
+                                  local_offset);
+                    if (is_32bit_type(local_type)) {
+                        *(loader_ctx->frame_offset - 1) = (int16)local_offset;
+                        loader_ctx->dynamic_offset--;
+                    }
+                    else {
+                        *(loader_ctx->frame_offset - 2) = (int16)local_offset;
+                        loader_ctx->dynamic_offset -= 2;
+                    }
+                    break;
+                }
+
                 if (local_offset < 256) {
                     skip_label();
                     if (is_32bit_type(local_type)) {
@@ -6556,10 +7163,17 @@ re_scan:
                 emit_operand(loader_ctx,
                              *(loader_ctx->frame_offset
                                - wasm_value_type_cell_num(local_type)));
+                if (local_offset < 256 && is_32bit_type(local_type))
+                    loader_ctx->tee_local_fast_end =
+                        wasm_loader_get_code_compiled_pos(loader_ctx);
 #else
 #if (WASM_ENABLE_WAMR_COMPILER == 0) && (WASM_ENABLE_JIT == 0) \
     && (WASM_ENABLE_FAST_JIT == 0)
-                if (local_offset < 0x80) {
+                if (local_offset < 0x80
+#if WASM_ENABLE_SIMD != 0
+                    && local_type != VALUE_TYPE_V128
+#endif
+                ) {
                     *p_org++ = EXT_OP_TEE_LOCAL_FAST;
                     if (is_32bit_type(local_type))
                         *p_org++ = (uint8)local_offset;
@@ -6594,11 +7208,22 @@ re_scan:
                     || global_type == VALUE_TYPE_F64) {
                     *p_org = WASM_OP_GET_GLOBAL_64;
                 }
+#if WASM_ENABLE_SIMD != 0
+                else if (global_type == VALUE_TYPE_V128) {
+                    *p_org = WASM_OP_GET_GLOBAL_128;
+                }
+#endif
 #else  /* else of WASM_ENABLE_FAST_INTERP */
                 if (is_64bit_type(global_type)) {
                     skip_label();
                     emit_label(WASM_OP_GET_GLOBAL_64);
                 }
+#if WASM_ENABLE_SIMD != 0
+                else if (global_type == VALUE_TYPE_V128) {
+                    skip_label();
+                    emit_label(WASM_OP_GET_GLOBAL_128);
+                }
+#endif
                 emit_uint32(loader_ctx, global_idx);
                 PUSH_OFFSET_TYPE(global_type);
 #endif /* end of WASM_ENABLE_FAST_INTERP */
@@ -6636,6 +7261,11 @@ re_scan:
                 if (is_64bit_type(global_type)) {
                     *p_org = WASM_OP_SET_GLOBAL_64;
                 }
+#if WASM_ENABLE_SIMD != 0
+                else if (global_type == VALUE_TYPE_V128) {
+                    *p_org = WASM_OP_SET_GLOBAL_128;
+                }
+#endif
                 else if (module->aux_stack_size > 0
                          && global_idx == module->aux_stack_top_global_index) {
                     *p_org = WASM_OP_SET_GLOBAL_AUX_STACK;
@@ -6648,6 +7278,12 @@ re_scan:
                     skip_label();
                     emit_label(WASM_OP_SET_GLOBAL_64);
                 }
+#if WASM_ENABLE_SIMD != 0
+                else if (global_type == VALUE_TYPE_V128) {
+                    skip_label();
+                    emit_label(WASM_OP_SET_GLOBAL_128);
+                }
+#endif
                 else if (module->aux_stack_size > 0
                          && global_idx == module->aux_stack_top_global_index) {
                     skip_label();
@@ -6705,6 +7341,17 @@ re_scan:
                     skip_label();
                     emit_label(WASM_OP_I64_STORE);
                 }
+
+                fuse_add_load = false;
+                if (opcode == WASM_OP_I32_LOAD && last_op == WASM_OP_I32_ADD
+                    && loader_ctx->i32_add_end != 0) {
+                    /* i32.add src2 src1 dst + i32.load offset dst dst2 =>
+                       i32.add_load src2 src1 offset dst2 */
+                    skip_label();
+                    wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
+                    replace_last_label(EXT_OP_I32_ADD_LOAD, sizeof(int16) * 2);
+                    fuse_add_load = true;
+                }
 #endif
                 CHECK_MEMORY();
                 read_leb_uint32(p, p_end, align);      /* align */
@@ -6764,6 +7411,18 @@ re_scan:
                     default:
                         break;
                 }
+#if WASM_ENABLE_FAST_INTERP != 0
+                if (fuse_add_load) {
+                    /* Remove the address operand, which is computed by the
+                       superinstruction */
+                    uint8 dst_operand[sizeof(int16)];
+                    wasm_loader_pop_bytes(loader_ctx, dst_operand,
+                                          sizeof(int16));
+                    wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
+                    wasm_loader_emit_bytes(loader_ctx, dst_operand,
+                                           sizeof(int16));
+                }
+#endif
                 break;
             }
 
@@ -7336,6 +7995,461 @@ re_scan:
                 break;
             }
 
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_SIMD_PREFIX:
+            {
+                uint32 opcode1;
+
+                opcode1 = read_uint8(p);
+#if WASM_ENABLE_FAST_INTERP != 0
+                /* v128.const is put into the const buffer like other consts
+                   and emits the sub opcode by itself if it can't be */
+                if (opcode1 != SIMD_v128_const)
+                    emit_byte(loader_ctx, ((uint8)opcode1));
+#endif
+                switch (opcode1) {
+                    /* memory instruction */
+                    case SIMD_v128_load:
+                    case SIMD_v128_load8x8_s:
+                    case SIMD_v128_load8x8_u:
+                    case SIMD_v128_load16x4_s:
+                    case SIMD_v128_load16x4_u:
+                    case SIMD_v128_load32x2_s:
+                    case SIMD_v128_load32x2_u:
+                    case SIMD_v128_load8_splat:
+                    case SIMD_v128_load16_splat:
+                    case SIMD_v128_load32_splat:
+                    case SIMD_v128_load64_splat:
+                    case SIMD_v128_load32_zero:
+                    case SIMD_v128_load64_zero:
+                    {
+                        CHECK_MEMORY();
+                        read_leb_uint32(p, p_end, align);      /* align */
+                        read_leb_uint32(p, p_end, mem_offset); /* offset */
+#if WASM_ENABLE_FAST_INTERP != 0
+                        emit_uint32(loader_ctx, mem_offset);
+#endif
+                        POP_AND_PUSH(VALUE_TYPE_I32, VALUE_TYPE_V128);
+#if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
+                        func->has_memory_operations = true;
+#endif
+                        break;
+                    }
+
+                    case SIMD_v128_store:
+                    {
+                        CHECK_MEMORY();
+                        read_leb_uint32(p, p_end, align);      /* align */
+                        read_leb_uint32(p, p_end, mem_offset); /* offset */
+#if WASM_ENABLE_FAST_INTERP != 0
+                        emit_uint32(loader_ctx, mem_offset);
+#endif
+                        POP_V128();
+                        POP_I32();
+#if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
+                        func->has_memory_operations = true;
+#endif
+                        break;
+                    }
+
+                    case SIMD_v128_load8_lane:
+                    case SIMD_v128_load16_lane:
+                    case SIMD_v128_load32_lane:
+                    case SIMD_v128_load64_lane:
+                    case SIMD_v128_store8_lane:
+                    case SIMD_v128_store16_lane:
+                    case SIMD_v128_store32_lane:
+                    case SIMD_v128_store64_lane:
+                    {
+                        uint8 lane;
+
+                        CHECK_MEMORY();
+                        read_leb_uint32(p, p_end, align);      /* align */
+                        read_leb_uint32(p, p_end, mem_offset); /* offset */
+                        lane = read_uint8(p);
+#if WASM_ENABLE_FAST_INTERP != 0
+                        emit_uint32(loader_ctx, mem_offset);
+                        emit_byte(loader_ctx, lane);
+#else
+                        (void)lane;
+#endif
+                        POP_V128();
+                        POP_I32();
+                        if (opcode1 < SIMD_v128_store8_lane) {
+                            PUSH_V128();
+                        }
+#if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
+                        func->has_memory_operations = true;
+#endif
+                        break;
+                    }
+
+                    /* basic operation */
+                    case SIMD_v128_const:
+                    {
+#if WASM_ENABLE_FAST_INTERP != 0
+                        V128 v128_const;
+#endif
+
+                        CHECK_BUF1(p, p_end, 16);
+#if WASM_ENABLE_FAST_INTERP != 0
+                        bh_memcpy_s(&v128_const, sizeof(V128), p, 16);
+                        skip_label();
+                        disable_emit = true;
+                        GET_CONST_OFFSET(VALUE_TYPE_V128, v128_const);
+
+                        if (operand_offset == 0) {
+                            disable_emit = false;
+                            emit_label(WASM_OP_SIMD_PREFIX);
+                            emit_byte(loader_ctx, SIMD_v128_const);
+                            wasm_loader_emit_bytes(loader_ctx, p, 16);
+                        }
+#endif
+                        p += 16;
+                        PUSH_V128();
+                        break;
+                    }
+
+                    case SIMD_v8x16_shuffle:
+                    {
+                        V128 mask;
+
+                        CHECK_BUF1(p, p_end, 16);
+                        mask = read_i8x16(p);
+                        p += 16;
+                        for (i = 0; i < 16; i++) {
+                            bh_assert((uint8)mask.i8x16[i] < 32);
+                        }
+#if WASM_ENABLE_FAST_INTERP != 0
+                        wasm_loader_emit_bytes(loader_ctx, (uint8 *)&mask,
+                                               sizeof(V128));
+#else
+                        (void)mask;
+#endif
+                        POP2_AND_PUSH(VALUE_TYPE_V128, VALUE_TYPE_V128);
+                        break;
+                    }
+
+                    /* splat operation */
+                    case SIMD_i8x16_splat:
+                    case SIMD_i16x8_splat:
+                    case SIMD_i32x4_splat:
+                    case SIMD_i64x2_splat:
+                    case SIMD_f32x4_splat:
+                    case SIMD_f64x2_splat:
+                    {
+                        uint8 pop_type[] = { VALUE_TYPE_I32, VALUE_TYPE_I32,
+                                             VALUE_TYPE_I32, VALUE_TYPE_I64,
+                                             VALUE_TYPE_F32, VALUE_TYPE_F64 };
+                        POP_AND_PUSH(pop_type[opcode1 - SIMD_i8x16_splat],
+                                     VALUE_TYPE_V128);
+                        break;
+                    }
+
+                    /* lane operation */
+                    case SIMD_i8x16_extract_lane_s:
+                    case SIMD_i8x16_extract_lane_u:
+                    case SIMD_i8x16_replace_lane:
+                    case SIMD_i16x8_extract_lane_s:
+                    case SIMD_i16x8_extract_lane_u:
+                    case SIMD_i16x8_replace_lane:
+                    case SIMD_i32x4_extract_lane:
+                    case SIMD_i32x4_replace_lane:
+                    case SIMD_i64x2_extract_lane:
+                    case SIMD_i64x2_replace_lane:
+                    case SIMD_f32x4_extract_lane:
+                    case SIMD_f32x4_replace_lane:
+                    case SIMD_f64x2_extract_lane:
+                    case SIMD_f64x2_replace_lane:
+                    {
+                        uint8 lane;
+                        /* clang-format off */
+                        uint8 replace[] = {
+                            /*i8x16*/ 0x0, 0x0, VALUE_TYPE_I32,
+                            /*i16x8*/ 0x0, 0x0, VALUE_TYPE_I32,
+                            /*i32x4*/ 0x0, VALUE_TYPE_I32,
+                            /*i64x2*/ 0x0, VALUE_TYPE_I64,
+                            /*f32x4*/ 0x0, VALUE_TYPE_F32,
+                            /*f64x2*/ 0x0, VALUE_TYPE_F64,
+                        };
+                        uint8 push_type[] = {
+                            /*i8x16*/ VALUE_TYPE_I32, VALUE_TYPE_I32,
+                                      VALUE_TYPE_V128,
+                            /*i16x8*/ VALUE_TYPE_I32, VALUE_TYPE_I32,
+                                      VALUE_TYPE_V128,
+                            /*i32x4*/ VALUE_TYPE_I32, VALUE_TYPE_V128,
+                            /*i64x2*/ VALUE_TYPE_I64, VALUE_TYPE_V128,
+                            /*f32x4*/ VALUE_TYPE_F32, VALUE_TYPE_V128,
+                            /*f64x2*/ VALUE_TYPE_F64, VALUE_TYPE_V128,
+                        };
+                        /* clang-format on */
+
+                        lane = read_uint8(p);
+#if WASM_ENABLE_FAST_INTERP != 0
+                        emit_byte(loader_ctx, lane);
+#else
+                        (void)lane;
+#endif
+
+                        if (replace[opcode1 - SIMD_i8x16_extract_lane_s]) {
+#if WASM_ENABLE_FAST_INTERP != 0
+                            if (!(wasm_loader_pop_frame_ref_offset(
+                                    loader_ctx,
+                                    replace[opcode1
+                                            - SIMD_i8x16_extract_lane_s],
+                                    error_buf, error_buf_size)))
+#else
+                            if (!(wasm_loader_pop_frame_ref(
+                                    loader_ctx,
+                                    replace[opcode1
+                                            - SIMD_i8x16_extract_lane_s],
+                                    error_buf, error_buf_size)))
+#endif
+                                goto fail;
+                        }
+
+                        POP_AND_PUSH(
+                            VALUE_TYPE_V128,
+                            push_type[opcode1 - SIMD_i8x16_extract_lane_s]);
+                        break;
+                    }
+
+                    /* v128 -> i32 */
+                    case SIMD_v128_any_true:
+                    case SIMD_i8x16_all_true:
+                    case SIMD_i8x16_bitmask:
+                    case SIMD_i16x8_all_true:
+                    case SIMD_i16x8_bitmask:
+                    case SIMD_i32x4_all_true:
+                    case SIMD_i32x4_bitmask:
+                    case SIMD_i64x2_all_true:
+                    case SIMD_i64x2_bitmask:
+                    {
+                        POP_AND_PUSH(VALUE_TYPE_V128, VALUE_TYPE_I32);
+                        break;
+                    }
+
+                    /* v128, i32 -> v128 */
+                    case SIMD_i8x16_shl:
+                    case SIMD_i8x16_shr_s:
+                    case SIMD_i8x16_shr_u:
+                    case SIMD_i16x8_shl:
+                    case SIMD_i16x8_shr_s:
+                    case SIMD_i16x8_shr_u:
+                    case SIMD_i32x4_shl:
+                    case SIMD_i32x4_shr_s:
+                    case SIMD_i32x4_shr_u:
+                    case SIMD_i64x2_shl:
+                    case SIMD_i64x2_shr_s:
+                    case SIMD_i64x2_shr_u:
+                    {
+                        POP_I32();
+                        POP_AND_PUSH(VALUE_TYPE_V128, VALUE_TYPE_V128);
+                        break;
+                    }
+
+                    case SIMD_v128_bitselect:
+                    {
+                        POP_V128();
+                        POP2_AND_PUSH(VALUE_TYPE_V128, VALUE_TYPE_V128);
+                        break;
+                    }
+
+                    /* v128 -> v128 */
+                    case SIMD_v128_not:
+                    case SIMD_f32x4_demote_f64x2_zero:
+                    case SIMD_f64x2_promote_low_f32x4_zero:
+                    case SIMD_i8x16_abs:
+                    case SIMD_i8x16_neg:
+                    case SIMD_i8x16_popcnt:
+                    case SIMD_f32x4_ceil:
+                    case SIMD_f32x4_floor:
+                    case SIMD_f32x4_trunc:
+                    case SIMD_f32x4_nearest:
+                    case SIMD_f64x2_ceil:
+                    case SIMD_f64x2_floor:
+                    case SIMD_f64x2_trunc:
+                    case SIMD_f64x2_nearest:
+                    case SIMD_i16x8_extadd_pairwise_i8x16_s:
+                    case SIMD_i16x8_extadd_pairwise_i8x16_u:
+                    case SIMD_i32x4_extadd_pairwise_i16x8_s:
+                    case SIMD_i32x4_extadd_pairwise_i16x8_u:
+                    case SIMD_i16x8_abs:
+                    case SIMD_i16x8_neg:
+                    case SIMD_i16x8_extend_low_i8x16_s:
+                    case SIMD_i16x8_extend_high_i8x16_s:
+                    case SIMD_i16x8_extend_low_i8x16_u:
+                    case SIMD_i16x8_extend_high_i8x16_u:
+                    case SIMD_i32x4_abs:
+                    case SIMD_i32x4_neg:
+                    case SIMD_i32x4_extend_low_i16x8_s:
+                    case SIMD_i32x4_extend_high_i16x8_s:
+                    case SIMD_i32x4_extend_low_i16x8_u:
+                    case SIMD_i32x4_extend_high_i16x8_u:
+                    case SIMD_i64x2_abs:
+                    case SIMD_i64x2_neg:
+                    case SIMD_i64x2_extend_low_i32x4_s:
+                    case SIMD_i64x2_extend_high_i32x4_s:
+                    case SIMD_i64x2_extend_low_i32x4_u:
+                    case SIMD_i64x2_extend_high_i32x4_u:
+                    case SIMD_f32x4_abs:
+                    case SIMD_f32x4_neg:
+                    case SIMD_f32x4_round:
+                    case SIMD_f32x4_sqrt:
+                    case SIMD_f64x2_abs:
+                    case SIMD_f64x2_neg:
+                    case SIMD_f64x2_round:
+                    case SIMD_f64x2_sqrt:
+                    case SIMD_i32x4_trunc_sat_f32x4_s:
+                    case SIMD_i32x4_trunc_sat_f32x4_u:
+                    case SIMD_f32x4_convert_i32x4_s:
+                    case SIMD_f32x4_convert_i32x4_u:
+                    case SIMD_i32x4_trunc_sat_f64x2_s_zero:
+                    case SIMD_i32x4_trunc_sat_f64x2_u_zero:
+                    case SIMD_f64x2_convert_low_i32x4_s:
+                    case SIMD_f64x2_convert_low_i32x4_u:
+                    {
+                        POP_AND_PUSH(VALUE_TYPE_V128, VALUE_TYPE_V128);
+                        break;
+                    }
+
+                    /* v128, v128 -> v128 */
+                    case SIMD_v8x16_swizzle:
+                    case SIMD_i8x16_eq:
+                    case SIMD_i8x16_ne:
+                    case SIMD_i8x16_lt_s:
+                    case SIMD_i8x16_lt_u:
+                    case SIMD_i8x16_gt_s:
+                    case SIMD_i8x16_gt_u:
+                    case SIMD_i8x16_le_s:
+                    case SIMD_i8x16_le_u:
+                    case SIMD_i8x16_ge_s:
+                    case SIMD_i8x16_ge_u:
+                    case SIMD_i16x8_eq:
+                    case SIMD_i16x8_ne:
+                    case SIMD_i16x8_lt_s:
+                    case SIMD_i16x8_lt_u:
+                    case SIMD_i16x8_gt_s:
+                    case SIMD_i16x8_gt_u:
+                    case SIMD_i16x8_le_s:
+                    case SIMD_i16x8_le_u:
+                    case SIMD_i16x8_ge_s:
+                    case SIMD_i16x8_ge_u:
+                    case SIMD_i32x4_eq:
+                    case SIMD_i32x4_ne:
+                    case SIMD_i32x4_lt_s:
+                    case SIMD_i32x4_lt_u:
+                    case SIMD_i32x4_gt_s:
+                    case SIMD_i32x4_gt_u:
+                    case SIMD_i32x4_le_s:
+                    case SIMD_i32x4_le_u:
+                    case SIMD_i32x4_ge_s:
+                    case SIMD_i32x4_ge_u:
+                    case SIMD_f32x4_eq:
+                    case SIMD_f32x4_ne:
+                    case SIMD_f32x4_lt:
+                    case SIMD_f32x4_gt:
+                    case SIMD_f32x4_le:
+                    case SIMD_f32x4_ge:
+                    case SIMD_f64x2_eq:
+                    case SIMD_f64x2_ne:
+                    case SIMD_f64x2_lt:
+                    case SIMD_f64x2_gt:
+                    case SIMD_f64x2_le:
+                    case SIMD_f64x2_ge:
+                    case SIMD_v128_and:
+                    case SIMD_v128_andnot:
+                    case SIMD_v128_or:
+                    case SIMD_v128_xor:
+                    case SIMD_i8x16_narrow_i16x8_s:
+                    case SIMD_i8x16_narrow_i16x8_u:
+                    case SIMD_i8x16_add:
+                    case SIMD_i8x16_add_sat_s:
+                    case SIMD_i8x16_add_sat_u:
+                    case SIMD_i8x16_sub:
+                    case SIMD_i8x16_sub_sat_s:
+                    case SIMD_i8x16_sub_sat_u:
+                    case SIMD_i8x16_min_s:
+                    case SIMD_i8x16_min_u:
+                    case SIMD_i8x16_max_s:
+                    case SIMD_i8x16_max_u:
+                    case SIMD_i8x16_avgr_u:
+                    case SIMD_i16x8_q15mulr_sat_s:
+                    case SIMD_i16x8_narrow_i32x4_s:
+                    case SIMD_i16x8_narrow_i32x4_u:
+                    case SIMD_i16x8_add:
+                    case SIMD_i16x8_add_sat_s:
+                    case SIMD_i16x8_add_sat_u:
+                    case SIMD_i16x8_sub:
+                    case SIMD_i16x8_sub_sat_s:
+                    case SIMD_i16x8_sub_sat_u:
+                    case SIMD_i16x8_mul:
+                    case SIMD_i16x8_min_s:
+                    case SIMD_i16x8_min_u:
+                    case SIMD_i16x8_max_s:
+                    case SIMD_i16x8_max_u:
+                    case SIMD_i16x8_avgr_u:
+                    case SIMD_i16x8_extmul_low_i8x16_s:
+                    case SIMD_i16x8_extmul_high_i8x16_s:
+                    case SIMD_i16x8_extmul_low_i8x16_u:
+                    case SIMD_i16x8_extmul_high_i8x16_u:
+                    case SIMD_i32x4_narrow_i64x2_s:
+                    case SIMD_i32x4_narrow_i64x2_u:
+                    case SIMD_i32x4_add:
+                    case SIMD_i32x4_sub:
+                    case SIMD_i32x4_mul:
+                    case SIMD_i32x4_min_s:
+                    case SIMD_i32x4_min_u:
+                    case SIMD_i32x4_max_s:
+                    case SIMD_i32x4_max_u:
+                    case SIMD_i32x4_dot_i16x8_s:
+                    case SIMD_i32x4_avgr_u:
+                    case SIMD_i32x4_extmul_low_i16x8_s:
+                    case SIMD_i32x4_extmul_high_i16x8_s:
+                    case SIMD_i32x4_extmul_low_i16x8_u:
+                    case SIMD_i32x4_extmul_high_i16x8_u:
+                    case SIMD_i64x2_add:
+                    case SIMD_i64x2_sub:
+                    case SIMD_i64x2_mul:
+                    case SIMD_i64x2_eq:
+                    case SIMD_i64x2_ne:
+                    case SIMD_i64x2_lt_s:
+                    case SIMD_i64x2_gt_s:
+                    case SIMD_i64x2_le_s:
+                    case SIMD_i64x2_ge_s:
+                    case SIMD_i64x2_extmul_low_i32x4_s:
+                    case SIMD_i64x2_extmul_high_i32x4_s:
+                    case SIMD_i64x2_extmul_low_i32x4_u:
+                    case SIMD_i64x2_extmul_high_i32x4_u:
+                    case SIMD_f32x4_add:
+                    case SIMD_f32x4_sub:
+                    case SIMD_f32x4_mul:
+                    case SIMD_f32x4_div:
+                    case SIMD_f32x4_min:
+                    case SIMD_f32x4_max:
+                    case SIMD_f32x4_pmin:
+                    case SIMD_f32x4_pmax:
+                    case SIMD_f64x2_add:
+                    case SIMD_f64x2_sub:
+                    case SIMD_f64x2_mul:
+                    case SIMD_f64x2_div:
+                    case SIMD_f64x2_min:
+                    case SIMD_f64x2_max:
+                    case SIMD_f64x2_pmin:
+                    case SIMD_f64x2_pmax:
+                    {
+                        POP2_AND_PUSH(VALUE_TYPE_V128, VALUE_TYPE_V128);
+                        break;
+                    }
+
+                    default:
+                        bh_assert(0);
+                        break;
+                }
+                break;
+            }
+#endif /* end of WASM_ENABLE_SIMD */
+
 #if WASM_ENABLE_SHARED_MEMORY != 0
             case WASM_OP_ATOMIC_PREFIX:
             {
@@ -7479,6 +8593,16 @@ re_scan:
 
 #if WASM_ENABLE_FAST_INTERP != 0
         last_op = opcode;
+        /* Only the ops which emit no code may be between i32.add and the
+           op fused with it, so no branch target is in the superinstruction */
+        if (opcode == WASM_OP_I32_ADD
+            && !(loader_ctx->frame_csp - 1)->is_stack_polymorphic)
+            loader_ctx->i32_add_end =
+                wasm_loader_get_code_compiled_pos(loader_ctx);
+        else if (opcode != WASM_OP_GET_LOCAL && opcode != WASM_OP_SET_LOCAL
+                 && opcode != WASM_OP_TEE_LOCAL && opcode != WASM_OP_I32_CONST
+                 && !(opcode >= WASM_OP_I32_EQ && opcode <= WASM_OP_I32_GE_U))
+            loader_ctx->i32_add_end = 0;
 #endif
     }
 
@@ -7510,6 +8634,13 @@ re_scan:
                             &(c->value.f64), (uint32)sizeof(int64));
                 func_const += sizeof(int64);
             }
+#if WASM_ENABLE_SIMD != 0
+            else if (c->value_type == VALUE_TYPE_V128) {
+                bh_memcpy_s(func_const, (uint32)(func_const_end - func_const),
+                            &(c->value.v128), (uint32)sizeof(V128));
+                func_const += sizeof(V128);
+            }
+#endif
             else {
                 bh_memcpy_s(func_const, (uint32)(func_const_end - func_const),
                             &(c->value.f32), (uint32)sizeof(int32));
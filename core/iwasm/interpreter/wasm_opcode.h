@@ -272,6 +272,32 @@ typedef enum WASMOpcode {
     DEBUG_OP_BREAK = 0xd7, /* debug break point */
 #endif
 
+    /* superinstructions fused by the fast interpreter loader */
+    EXT_OP_I32_EQZ_BR_IF = 0xd8,        /* i32.eqz + br_if */
+    EXT_OP_I32_EQ_BR_IF = 0xd9,         /* i32.eq + br_if */
+    EXT_OP_I32_NE_BR_IF = 0xda,         /* i32.ne + br_if */
+    EXT_OP_I32_LT_S_BR_IF = 0xdb,       /* i32.lt_s + br_if */
+    EXT_OP_I32_LT_U_BR_IF = 0xdc,       /* i32.lt_u + br_if */
+    EXT_OP_I32_GT_S_BR_IF = 0xdd,       /* i32.gt_s + br_if */
+    EXT_OP_I32_GT_U_BR_IF = 0xde,       /* i32.gt_u + br_if */
+    EXT_OP_I32_LE_S_BR_IF = 0xdf,       /* i32.le_s + br_if */
+    EXT_OP_I32_LE_U_BR_IF = 0xe0,       /* i32.le_u + br_if */
+    EXT_OP_I32_GE_S_BR_IF = 0xe1,       /* i32.ge_s + br_if */
+    EXT_OP_I32_GE_U_BR_IF = 0xe2,       /* i32.ge_u + br_if */
+    EXT_OP_TEE_LOCAL_FAST_BR_IF = 0xe3, /* local.tee + br_if */
+    EXT_OP_I32_ADD_LOAD = 0xe4,         /* i32.add + i32.load */
+    EXT_OP_I32_ADD_BR_IF = 0xe5,        /* i32.add + br_if */
+    EXT_OP_I32_ADD_NE_BR_IF = 0xe6,     /* i32.add + i32.ne + br_if */
+    EXT_OP_I32_ADD_LT_S_BR_IF = 0xe7,   /* i32.add + i32.lt_s + br_if */
+    EXT_OP_I32_ADD_LT_U_BR_IF = 0xe8,   /* i32.add + i32.lt_u + br_if */
+
+    /* v128 variants of the parametric and variable instructions */
+    EXT_OP_COPY_STACK_TOP_V128 = 0xe9,
+    WASM_OP_DROP_128 = 0xea,
+    WASM_OP_SELECT_128 = 0xeb,
+    WASM_OP_GET_GLOBAL_128 = 0xec,
+    WASM_OP_SET_GLOBAL_128 = 0xed,
+
     /* Post-MVP extend op prefix */
     WASM_OP_MISC_PREFIX = 0xfc,
     WASM_OP_SIMD_PREFIX = 0xfd,
@@ -905,7 +931,30 @@ typedef enum WASMAtomicEXTOpcode {
         HANDLE_OPCODE(EXT_OP_LOOP),                  /* 0xd4 */ \
         HANDLE_OPCODE(EXT_OP_IF),                    /* 0xd5 */ \
         HANDLE_OPCODE(EXT_OP_BR_TABLE_CACHE),        /* 0xd6 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_EQZ_BR_IF),   /* 0xd8 */ \
+        HANDLE_OPCODE(EXT_OP_I32_EQ_BR_IF),          /* 0xd9 */ \
+        HANDLE_OPCODE(EXT_OP_I32_NE_BR_IF),          /* 0xda */ \
+        HANDLE_OPCODE(EXT_OP_I32_LT_S_BR_IF),        /* 0xdb */ \
+        HANDLE_OPCODE(EXT_OP_I32_LT_U_BR_IF),        /* 0xdc */ \
+        HANDLE_OPCODE(EXT_OP_I32_GT_S_BR_IF),        /* 0xdd */ \
+        HANDLE_OPCODE(EXT_OP_I32_GT_U_BR_IF),        /* 0xde */ \
+        HANDLE_OPCODE(EXT_OP_I32_LE_S_BR_IF),        /* 0xdf */ \
+        HANDLE_OPCODE(EXT_OP_I32_LE_U_BR_IF),        /* 0xe0 */ \
+        HANDLE_OPCODE(EXT_OP_I32_GE_S_BR_IF),        /* 0xe1 */ \
+        HANDLE_OPCODE(EXT_OP_I32_GE_U_BR_IF),        /* 0xe2 */ \
+        HANDLE_OPCODE(EXT_OP_TEE_LOCAL_FAST_BR_IF),  /* 0xe3 */ \
+        HANDLE_OPCODE(EXT_OP_I32_ADD_LOAD),          /* 0xe4 */ \
+        HANDLE_OPCODE(EXT_OP_I32_ADD_BR_IF),         /* 0xe5 */ \
+        HANDLE_OPCODE(EXT_OP_I32_ADD_NE_BR_IF),      /* 0xe6 */ \
+        HANDLE_OPCODE(EXT_OP_I32_ADD_LT_S_BR_IF),    /* 0xe7 */ \
+        HANDLE_OPCODE(EXT_OP_I32_ADD_LT_U_BR_IF),    /* 0xe8 */ \
+        HANDLE_OPCODE(EXT_OP_COPY_STACK_TOP_V128),   /* 0xe9 */ \
+        HANDLE_OPCODE(WASM_OP_DROP_128),             /* 0xea */ \
+        HANDLE_OPCODE(WASM_OP_SELECT_128),           /* 0xeb */ \
+        HANDLE_OPCODE(WASM_OP_GET_GLOBAL_128),       /* 0xec */ \
+        HANDLE_OPCODE(WASM_OP_SET_GLOBAL_128),       /* 0xed */ \
         SET_GOTO_TABLE_ELEM(WASM_OP_MISC_PREFIX),    /* 0xfc */ \
+        SET_GOTO_TABLE_ELEM(WASM_OP_SIMD_PREFIX),    /* 0xfd */ \
         SET_GOTO_TABLE_ELEM(WASM_OP_ATOMIC_PREFIX),  /* 0xfe */ \
         DEF_DEBUG_BREAK_HANDLE()                                \
     };
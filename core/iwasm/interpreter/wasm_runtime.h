@@ -242,6 +242,8 @@ typedef struct WASMModuleInstanceExtraCommon {
 #if WASM_ENABLE_REF_TYPES != 0
     bh_bitmap *elem_dropped;
 #endif
+    /* Unique id of the instance, see wasm_runtime_new_module_inst_id */
+    uint32 module_inst_id;
 } WASMModuleInstanceExtraCommon;
 
 /* Extra info of WASM module instance for interpreter/jit mode */
@@ -325,8 +327,9 @@ struct WASMModuleInstance {
     DefPointer(void *, used_to_be_wasi_ctx); /* unused */
 
     DefPointer(WASMExecEnv *, exec_env_singleton);
-    /* Array of function pointers to import functions,
-       not available in AOTModuleInstance */
+    /* Array of function pointers to import functions, for
+       AOTModuleInstance, it only holds the natives which the AOT
+       code can call directly, and NULL for the others */
     DefPointer(void **, import_func_ptrs);
     /* Array of function pointers to fast jit functions,
        not available in AOTModuleInstance:
@@ -0,0 +1,1170 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "wasm_simd.h"
+#include "wasm_opcode.h"
+
+#if WASM_ENABLE_SIMD != 0
+
+/*
+ * The operations are written as plain loops over the lanes, which the
+ * compiler turns into the host vector instructions where it can, and
+ * which keep the results identical to the AOT/JIT compiled code on all
+ * the targets.
+ */
+
+typedef union SIMDLanes {
+    int8 i8[16];
+    uint8 u8[16];
+    int16 i16[8];
+    uint16 u16[8];
+    int32 i32[4];
+    uint32 u32[4];
+    int64 i64[2];
+    uint64 u64[2];
+    float32 f32[4];
+    float64 f64[2];
+} SIMDLanes;
+
+#define LANE_LOOP(n) for (i = 0; i < n; i++)
+
+static inline int8
+sat_i8(int32 v)
+{
+    return (int8)(v < INT8_MIN ? INT8_MIN : (v > INT8_MAX ? INT8_MAX : v));
+}
+
+static inline uint8
+sat_u8(int32 v)
+{
+    return (uint8)(v < 0 ? 0 : (v > UINT8_MAX ? UINT8_MAX : v));
+}
+
+static inline int16
+sat_i16(int32 v)
+{
+    return (int16)(v < INT16_MIN ? INT16_MIN : (v > INT16_MAX ? INT16_MAX : v));
+}
+
+static inline uint16
+sat_u16(int32 v)
+{
+    return (uint16)(v < 0 ? 0 : (v > UINT16_MAX ? UINT16_MAX : v));
+}
+
+static inline int32
+sat_i32(int64 v)
+{
+    return (int32)(v < INT32_MIN ? INT32_MIN : (v > INT32_MAX ? INT32_MAX : v));
+}
+
+static inline uint32
+sat_u32(int64 v)
+{
+    return (uint32)(v < 0 ? 0 : (v > (int64)UINT32_MAX ? UINT32_MAX : v));
+}
+
+static inline float32
+simd_f32_min(float32 a, float32 b)
+{
+    if (isnan(a) || isnan(b))
+        return NAN;
+    else if (a == 0 && a == b)
+        return signbit(a) ? a : b;
+    else
+        return a > b ? b : a;
+}
+
+static inline float32
+simd_f32_max(float32 a, float32 b)
+{
+    if (isnan(a) || isnan(b))
+        return NAN;
+    else if (a == 0 && a == b)
+        return signbit(a) ? b : a;
+    else
+        return a > b ? a : b;
+}
+
+static inline float64
+simd_f64_min(float64 a, float64 b)
+{
+    if (isnan(a) || isnan(b))
+        return NAN;
+    else if (a == 0 && a == b)
+        return signbit(a) ? a : b;
+    else
+        return a > b ? b : a;
+}
+
+static inline float64
+simd_f64_max(float64 a, float64 b)
+{
+    if (isnan(a) || isnan(b))
+        return NAN;
+    else if (a == 0 && a == b)
+        return signbit(a) ? b : a;
+    else
+        return a > b ? a : b;
+}
+
+/* Round half away from zero, the platform libm may not provide round() */
+static inline float32
+simd_f32_round(float32 a)
+{
+    float32 t = truncf(a);
+
+    if (fabsf(a - t) >= 0.5f)
+        t += signbit(a) ? -1.0f : 1.0f;
+    return t;
+}
+
+static inline float64
+simd_f64_round(float64 a)
+{
+    float64 t = trunc(a);
+
+    if (fabs(a - t) >= 0.5)
+        t += signbit(a) ? -1.0 : 1.0;
+    return t;
+}
+
+static inline int32
+trunc_sat_f64_to_i32(float64 a)
+{
+    if (isnan(a))
+        return 0;
+    if (a <= (float64)INT32_MIN)
+        return INT32_MIN;
+    if (a >= (float64)INT32_MAX)
+        return INT32_MAX;
+    return (int32)a;
+}
+
+static inline uint32
+trunc_sat_f64_to_u32(float64 a)
+{
+    if (isnan(a) || a <= 0)
+        return 0;
+    if (a >= (float64)UINT32_MAX)
+        return UINT32_MAX;
+    return (uint32)a;
+}
+
+uint32
+wasm_simd_mem_access_size(uint8 opcode)
+{
+    switch (opcode) {
+        case SIMD_v128_load8x8_s:
+        case SIMD_v128_load8x8_u:
+        case SIMD_v128_load16x4_s:
+        case SIMD_v128_load16x4_u:
+        case SIMD_v128_load32x2_s:
+        case SIMD_v128_load32x2_u:
+        case SIMD_v128_load64_splat:
+        case SIMD_v128_load64_lane:
+        case SIMD_v128_store64_lane:
+        case SIMD_v128_load64_zero:
+            return 8;
+        case SIMD_v128_load8_splat:
+        case SIMD_v128_load8_lane:
+        case SIMD_v128_store8_lane:
+            return 1;
+        case SIMD_v128_load16_splat:
+        case SIMD_v128_load16_lane:
+        case SIMD_v128_store16_lane:
+            return 2;
+        case SIMD_v128_load32_splat:
+        case SIMD_v128_load32_lane:
+        case SIMD_v128_store32_lane:
+        case SIMD_v128_load32_zero:
+            return 4;
+        default:
+            return 16;
+    }
+}
+
+void
+wasm_simd_load(uint8 opcode, const uint8 *maddr, V128 *result)
+{
+    SIMDLanes a, r;
+    uint32 i;
+
+    memset(&a, 0, sizeof(a));
+    memcpy(&a, maddr, wasm_simd_mem_access_size(opcode));
+
+    switch (opcode) {
+        case SIMD_v128_load:
+        case SIMD_v128_load32_zero:
+        case SIMD_v128_load64_zero:
+            r = a;
+            break;
+        case SIMD_v128_load8x8_s:
+            LANE_LOOP(8) r.i16[i] = a.i8[i];
+            break;
+        case SIMD_v128_load8x8_u:
+            LANE_LOOP(8) r.u16[i] = a.u8[i];
+            break;
+        case SIMD_v128_load16x4_s:
+            LANE_LOOP(4) r.i32[i] = a.i16[i];
+            break;
+        case SIMD_v128_load16x4_u:
+            LANE_LOOP(4) r.u32[i] = a.u16[i];
+            break;
+        case SIMD_v128_load32x2_s:
+            LANE_LOOP(2) r.i64[i] = a.i32[i];
+            break;
+        case SIMD_v128_load32x2_u:
+            LANE_LOOP(2) r.u64[i] = a.u32[i];
+            break;
+        case SIMD_v128_load8_splat:
+            LANE_LOOP(16) r.u8[i] = a.u8[0];
+            break;
+        case SIMD_v128_load16_splat:
+            LANE_LOOP(8) r.u16[i] = a.u16[0];
+            break;
+        case SIMD_v128_load32_splat:
+            LANE_LOOP(4) r.u32[i] = a.u32[0];
+            break;
+        case SIMD_v128_load64_splat:
+            LANE_LOOP(2) r.u64[i] = a.u64[0];
+            break;
+        default:
+            bh_assert(0);
+            return;
+    }
+
+    memcpy(result, &r, sizeof(V128));
+}
+
+void
+wasm_simd_load_lane(uint8 opcode, const uint8 *maddr, uint8 lane, V128 *vec)
+{
+    uint32 size = wasm_simd_mem_access_size(opcode);
+
+    bh_assert(lane < 16 / size);
+    memcpy((uint8 *)vec + lane * size, maddr, size);
+}
+
+void
+wasm_simd_store_lane(uint8 opcode, uint8 *maddr, uint8 lane, const V128 *vec)
+{
+    uint32 size = wasm_simd_mem_access_size(opcode);
+
+    bh_assert(lane < 16 / size);
+    memcpy(maddr, (const uint8 *)vec + lane * size, size);
+}
+
+void
+wasm_simd_splat(uint8 opcode, const uint32 *scalar, V128 *result)
+{
+    SIMDLanes r;
+    uint64 u64;
+    uint32 i;
+
+    switch (opcode) {
+        case SIMD_i8x16_splat:
+            LANE_LOOP(16) r.u8[i] = (uint8)scalar[0];
+            break;
+        case SIMD_i16x8_splat:
+            LANE_LOOP(8) r.u16[i] = (uint16)scalar[0];
+            break;
+        case SIMD_i32x4_splat:
+        case SIMD_f32x4_splat:
+            LANE_LOOP(4) r.u32[i] = scalar[0];
+            break;
+        case SIMD_i64x2_splat:
+        case SIMD_f64x2_splat:
+            memcpy(&u64, scalar, sizeof(uint64));
+            LANE_LOOP(2) r.u64[i] = u64;
+            break;
+        default:
+            bh_assert(0);
+            return;
+    }
+
+    memcpy(result, &r, sizeof(V128));
+}
+
+void
+wasm_simd_extract_lane(uint8 opcode, const V128 *vec, uint8 lane,
+                       uint32 *result)
+{
+    SIMDLanes a;
+
+    memcpy(&a, vec, sizeof(V128));
+
+    switch (opcode) {
+        case SIMD_i8x16_extract_lane_s:
+            result[0] = (uint32)(int32)a.i8[lane & 15];
+            break;
+        case SIMD_i8x16_extract_lane_u:
+            result[0] = a.u8[lane & 15];
+            break;
+        case SIMD_i16x8_extract_lane_s:
+            result[0] = (uint32)(int32)a.i16[lane & 7];
+            break;
+        case SIMD_i16x8_extract_lane_u:
+            result[0] = a.u16[lane & 7];
+            break;
+        case SIMD_i32x4_extract_lane:
+        case SIMD_f32x4_extract_lane:
+            result[0] = a.u32[lane & 3];
+            break;
+        case SIMD_i64x2_extract_lane:
+        case SIMD_f64x2_extract_lane:
+            memcpy(result, &a.u64[lane & 1], sizeof(uint64));
+            break;
+        default:
+            bh_assert(0);
+            break;
+    }
+}
+
+void
+wasm_simd_replace_lane(uint8 opcode, uint8 lane, const uint32 *scalar,
+                       V128 *vec)
+{
+    SIMDLanes a;
+
+    memcpy(&a, vec, sizeof(V128));
+
+    switch (opcode) {
+        case SIMD_i8x16_replace_lane:
+            a.u8[lane & 15] = (uint8)scalar[0];
+            break;
+        case SIMD_i16x8_replace_lane:
+            a.u16[lane & 7] = (uint16)scalar[0];
+            break;
+        case SIMD_i32x4_replace_lane:
+        case SIMD_f32x4_replace_lane:
+            a.u32[lane & 3] = scalar[0];
+            break;
+        case SIMD_i64x2_replace_lane:
+        case SIMD_f64x2_replace_lane:
+            memcpy(&a.u64[lane & 1], scalar, sizeof(uint64));
+            break;
+        default:
+            bh_assert(0);
+            return;
+    }
+
+    memcpy(vec, &a, sizeof(V128));
+}
+
+void
+wasm_simd_shuffle(const V128 *v1, const V128 *v2, const uint8 *lanes,
+                  V128 *result)
+{
+    uint8 bytes[32], r[16];
+    uint32 i;
+
+    memcpy(bytes, v1, sizeof(V128));
+    memcpy(bytes + 16, v2, sizeof(V128));
+    LANE_LOOP(16) r[i] = bytes[lanes[i] & 31];
+    memcpy(result, r, sizeof(V128));
+}
+
+void
+wasm_simd_bitselect(const V128 *v1, const V128 *v2, const V128 *c,
+                    V128 *result)
+{
+    SIMDLanes a, b, m, r;
+    uint32 i;
+
+    memcpy(&a, v1, sizeof(V128));
+    memcpy(&b, v2, sizeof(V128));
+    memcpy(&m, c, sizeof(V128));
+    LANE_LOOP(2) r.u64[i] = (a.u64[i] & m.u64[i]) | (b.u64[i] & ~m.u64[i]);
+    memcpy(result, &r, sizeof(V128));
+}
+
+void
+wasm_simd_shift(uint8 opcode, const V128 *vec, uint32 count, V128 *result)
+{
+    SIMDLanes a, r;
+    uint32 i;
+
+    memcpy(&a, vec, sizeof(V128));
+
+    switch (opcode) {
+        case SIMD_i8x16_shl:
+            LANE_LOOP(16) r.u8[i] = (uint8)(a.u8[i] << (count & 7));
+            break;
+        case SIMD_i8x16_shr_s:
+            LANE_LOOP(16) r.i8[i] = (int8)(a.i8[i] >> (count & 7));
+            break;
+        case SIMD_i8x16_shr_u:
+            LANE_LOOP(16) r.u8[i] = (uint8)(a.u8[i] >> (count & 7));
+            break;
+        case SIMD_i16x8_shl:
+            LANE_LOOP(8) r.u16[i] = (uint16)(a.u16[i] << (count & 15));
+            break;
+        case SIMD_i16x8_shr_s:
+            LANE_LOOP(8) r.i16[i] = (int16)(a.i16[i] >> (count & 15));
+            break;
+        case SIMD_i16x8_shr_u:
+            LANE_LOOP(8) r.u16[i] = (uint16)(a.u16[i] >> (count & 15));
+            break;
+        case SIMD_i32x4_shl:
+            LANE_LOOP(4) r.u32[i] = a.u32[i] << (count & 31);
+            break;
+        case SIMD_i32x4_shr_s:
+            LANE_LOOP(4) r.i32[i] = a.i32[i] >> (count & 31);
+            break;
+        case SIMD_i32x4_shr_u:
+            LANE_LOOP(4) r.u32[i] = a.u32[i] >> (count & 31);
+            break;
+        case SIMD_i64x2_shl:
+            LANE_LOOP(2) r.u64[i] = a.u64[i] << (count & 63);
+            break;
+        case SIMD_i64x2_shr_s:
+            LANE_LOOP(2) r.i64[i] = a.i64[i] >> (count & 63);
+            break;
+        case SIMD_i64x2_shr_u:
+            LANE_LOOP(2) r.u64[i] = a.u64[i] >> (count & 63);
+            break;
+        default:
+            bh_assert(0);
+            return;
+    }
+
+    memcpy(result, &r, sizeof(V128));
+}
+
+int32
+wasm_simd_reduce(uint8 opcode, const V128 *vec)
+{
+    SIMDLanes a;
+    int32 res = 0;
+    uint32 i;
+
+    memcpy(&a, vec, sizeof(V128));
+
+    switch (opcode) {
+        case SIMD_v128_any_true:
+            return (a.u64[0] | a.u64[1]) ? 1 : 0;
+        case SIMD_i8x16_all_true:
+            LANE_LOOP(16) if (!a.u8[i]) return 0;
+            return 1;
+        case SIMD_i16x8_all_true:
+            LANE_LOOP(8) if (!a.u16[i]) return 0;
+            return 1;
+        case SIMD_i32x4_all_true:
+            LANE_LOOP(4) if (!a.u32[i]) return 0;
+            return 1;
+        case SIMD_i64x2_all_true:
+            LANE_LOOP(2) if (!a.u64[i]) return 0;
+            return 1;
+        case SIMD_i8x16_bitmask:
+            LANE_LOOP(16) res |= (a.i8[i] < 0 ? 1 : 0) << i;
+            return res;
+        case SIMD_i16x8_bitmask:
+            LANE_LOOP(8) res |= (a.i16[i] < 0 ? 1 : 0) << i;
+            return res;
+        case SIMD_i32x4_bitmask:
+            LANE_LOOP(4) res |= (a.i32[i] < 0 ? 1 : 0) << i;
+            return res;
+        case SIMD_i64x2_bitmask:
+            LANE_LOOP(2) res |= (a.i64[i] < 0 ? 1 : 0) << i;
+            return res;
+        default:
+            bh_assert(0);
+            return 0;
+    }
+}
+
+bool
+wasm_simd_is_unary_op(uint8 opcode)
+{
+    switch (opcode) {
+        case SIMD_v128_not:
+        case SIMD_f32x4_demote_f64x2_zero:
+        case SIMD_f64x2_promote_low_f32x4_zero:
+        case SIMD_i8x16_abs:
+        case SIMD_i8x16_neg:
+        case SIMD_i8x16_popcnt:
+        case SIMD_f32x4_ceil:
+        case SIMD_f32x4_floor:
+        case SIMD_f32x4_trunc:
+        case SIMD_f32x4_nearest:
+        case SIMD_f64x2_ceil:
+        case SIMD_f64x2_floor:
+        case SIMD_f64x2_trunc:
+        case SIMD_i16x8_extadd_pairwise_i8x16_s:
+        case SIMD_i16x8_extadd_pairwise_i8x16_u:
+        case SIMD_i32x4_extadd_pairwise_i16x8_s:
+        case SIMD_i32x4_extadd_pairwise_i16x8_u:
+        case SIMD_i16x8_abs:
+        case SIMD_i16x8_neg:
+        case SIMD_i16x8_extend_low_i8x16_s:
+        case SIMD_i16x8_extend_high_i8x16_s:
+        case SIMD_i16x8_extend_low_i8x16_u:
+        case SIMD_i16x8_extend_high_i8x16_u:
+        case SIMD_f64x2_nearest:
+        case SIMD_i32x4_abs:
+        case SIMD_i32x4_neg:
+        case SIMD_i32x4_extend_low_i16x8_s:
+        case SIMD_i32x4_extend_high_i16x8_s:
+        case SIMD_i32x4_extend_low_i16x8_u:
+        case SIMD_i32x4_extend_high_i16x8_u:
+        case SIMD_i64x2_abs:
+        case SIMD_i64x2_neg:
+        case SIMD_i64x2_extend_low_i32x4_s:
+        case SIMD_i64x2_extend_high_i32x4_s:
+        case SIMD_i64x2_extend_low_i32x4_u:
+        case SIMD_i64x2_extend_high_i32x4_u:
+        case SIMD_f32x4_abs:
+        case SIMD_f32x4_neg:
+        case SIMD_f32x4_round:
+        case SIMD_f32x4_sqrt:
+        case SIMD_f64x2_abs:
+        case SIMD_f64x2_neg:
+        case SIMD_f64x2_round:
+        case SIMD_f64x2_sqrt:
+        case SIMD_i32x4_trunc_sat_f32x4_s:
+        case SIMD_i32x4_trunc_sat_f32x4_u:
+        case SIMD_f32x4_convert_i32x4_s:
+        case SIMD_f32x4_convert_i32x4_u:
+        case SIMD_i32x4_trunc_sat_f64x2_s_zero:
+        case SIMD_i32x4_trunc_sat_f64x2_u_zero:
+        case SIMD_f64x2_convert_low_i32x4_s:
+        case SIMD_f64x2_convert_low_i32x4_u:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void
+wasm_simd_unary_op(uint8 opcode, const V128 *vec, V128 *result)
+{
+    SIMDLanes a, r;
+    uint32 i, j;
+
+    memcpy(&a, vec, sizeof(V128));
+    memset(&r, 0, sizeof(r));
+
+    switch (opcode) {
+        case SIMD_v128_not:
+            LANE_LOOP(2) r.u64[i] = ~a.u64[i];
+            break;
+        case SIMD_f32x4_demote_f64x2_zero:
+            LANE_LOOP(2) r.f32[i] = (float32)a.f64[i];
+            break;
+        case SIMD_f64x2_promote_low_f32x4_zero:
+            LANE_LOOP(2) r.f64[i] = (float64)a.f32[i];
+            break;
+
+        case SIMD_i8x16_abs:
+            LANE_LOOP(16)
+            r.u8[i] = a.i8[i] < 0 ? (uint8)(0 - a.u8[i]) : a.u8[i];
+            break;
+        case SIMD_i8x16_neg:
+            LANE_LOOP(16) r.u8[i] = (uint8)(0 - a.u8[i]);
+            break;
+        case SIMD_i8x16_popcnt:
+            LANE_LOOP(16)
+            {
+                for (j = 0; j < 8; j++)
+                    r.u8[i] += (a.u8[i] >> j) & 1;
+            }
+            break;
+        case SIMD_i16x8_abs:
+            LANE_LOOP(8)
+            r.u16[i] = a.i16[i] < 0 ? (uint16)(0 - a.u16[i]) : a.u16[i];
+            break;
+        case SIMD_i16x8_neg:
+            LANE_LOOP(8) r.u16[i] = (uint16)(0 - a.u16[i]);
+            break;
+        case SIMD_i32x4_abs:
+            LANE_LOOP(4) r.u32[i] = a.i32[i] < 0 ? 0 - a.u32[i] : a.u32[i];
+            break;
+        case SIMD_i32x4_neg:
+            LANE_LOOP(4) r.u32[i] = 0 - a.u32[i];
+            break;
+        case SIMD_i64x2_abs:
+            LANE_LOOP(2) r.u64[i] = a.i64[i] < 0 ? 0 - a.u64[i] : a.u64[i];
+            break;
+        case SIMD_i64x2_neg:
+            LANE_LOOP(2) r.u64[i] = 0 - a.u64[i];
+            break;
+
+        case SIMD_i16x8_extadd_pairwise_i8x16_s:
+            LANE_LOOP(8)
+            r.i16[i] = (int16)(a.i8[2 * i] + a.i8[2 * i + 1]);
+            break;
+        case SIMD_i16x8_extadd_pairwise_i8x16_u:
+            LANE_LOOP(8)
+            r.u16[i] = (uint16)(a.u8[2 * i] + a.u8[2 * i + 1]);
+            break;
+        case SIMD_i32x4_extadd_pairwise_i16x8_s:
+            LANE_LOOP(4)
+            r.i32[i] = (int32)a.i16[2 * i] + a.i16[2 * i + 1];
+            break;
+        case SIMD_i32x4_extadd_pairwise_i16x8_u:
+            LANE_LOOP(4)
+            r.u32[i] = (uint32)a.u16[2 * i] + a.u16[2 * i + 1];
+            break;
+
+        case SIMD_i16x8_extend_low_i8x16_s:
+            LANE_LOOP(8) r.i16[i] = a.i8[i];
+            break;
+        case SIMD_i16x8_extend_high_i8x16_s:
+            LANE_LOOP(8) r.i16[i] = a.i8[i + 8];
+            break;
+        case SIMD_i16x8_extend_low_i8x16_u:
+            LANE_LOOP(8) r.u16[i] = a.u8[i];
+            break;
+        case SIMD_i16x8_extend_high_i8x16_u:
+            LANE_LOOP(8) r.u16[i] = a.u8[i + 8];
+            break;
+        case SIMD_i32x4_extend_low_i16x8_s:
+            LANE_LOOP(4) r.i32[i] = a.i16[i];
+            break;
+        case SIMD_i32x4_extend_high_i16x8_s:
+            LANE_LOOP(4) r.i32[i] = a.i16[i + 4];
+            break;
+        case SIMD_i32x4_extend_low_i16x8_u:
+            LANE_LOOP(4) r.u32[i] = a.u16[i];
+            break;
+        case SIMD_i32x4_extend_high_i16x8_u:
+            LANE_LOOP(4) r.u32[i] = a.u16[i + 4];
+            break;
+        case SIMD_i64x2_extend_low_i32x4_s:
+            LANE_LOOP(2) r.i64[i] = a.i32[i];
+            break;
+        case SIMD_i64x2_extend_high_i32x4_s:
+            LANE_LOOP(2) r.i64[i] = a.i32[i + 2];
+            break;
+        case SIMD_i64x2_extend_low_i32x4_u:
+            LANE_LOOP(2) r.u64[i] = a.u32[i];
+            break;
+        case SIMD_i64x2_extend_high_i32x4_u:
+            LANE_LOOP(2) r.u64[i] = a.u32[i + 2];
+            break;
+
+        case SIMD_f32x4_abs:
+            LANE_LOOP(4) r.u32[i] = a.u32[i] & 0x7FFFFFFF;
+            break;
+        case SIMD_f32x4_neg:
+            LANE_LOOP(4) r.u32[i] = a.u32[i] ^ 0x80000000;
+            break;
+        case SIMD_f32x4_ceil:
+            LANE_LOOP(4) r.f32[i] = ceilf(a.f32[i]);
+            break;
+        case SIMD_f32x4_floor:
+            LANE_LOOP(4) r.f32[i] = floorf(a.f32[i]);
+            break;
+        case SIMD_f32x4_trunc:
+            LANE_LOOP(4) r.f32[i] = truncf(a.f32[i]);
+            break;
+        case SIMD_f32x4_nearest:
+            LANE_LOOP(4) r.f32[i] = rintf(a.f32[i]);
+            break;
+        case SIMD_f32x4_round:
+            LANE_LOOP(4) r.f32[i] = simd_f32_round(a.f32[i]);
+            break;
+        case SIMD_f32x4_sqrt:
+            LANE_LOOP(4) r.f32[i] = sqrtf(a.f32[i]);
+            break;
+        case SIMD_f64x2_abs:
+            LANE_LOOP(2) r.u64[i] = a.u64[i] & 0x7FFFFFFFFFFFFFFFLL;
+            break;
+        case SIMD_f64x2_neg:
+            LANE_LOOP(2) r.u64[i] = a.u64[i] ^ 0x8000000000000000ULL;
+            break;
+        case SIMD_f64x2_ceil:
+            LANE_LOOP(2) r.f64[i] = ceil(a.f64[i]);
+            break;
+        case SIMD_f64x2_floor:
+            LANE_LOOP(2) r.f64[i] = floor(a.f64[i]);
+            break;
+        case SIMD_f64x2_trunc:
+            LANE_LOOP(2) r.f64[i] = trunc(a.f64[i]);
+            break;
+        case SIMD_f64x2_nearest:
+            LANE_LOOP(2) r.f64[i] = rint(a.f64[i]);
+            break;
+        case SIMD_f64x2_round:
+            LANE_LOOP(2) r.f64[i] = simd_f64_round(a.f64[i]);
+            break;
+        case SIMD_f64x2_sqrt:
+            LANE_LOOP(2) r.f64[i] = sqrt(a.f64[i]);
+            break;
+
+        case SIMD_i32x4_trunc_sat_f32x4_s:
+            LANE_LOOP(4) r.i32[i] = trunc_sat_f64_to_i32((float64)a.f32[i]);
+            break;
+        case SIMD_i32x4_trunc_sat_f32x4_u:
+            LANE_LOOP(4) r.u32[i] = trunc_sat_f64_to_u32((float64)a.f32[i]);
+            break;
+        case SIMD_i32x4_trunc_sat_f64x2_s_zero:
+            LANE_LOOP(2) r.i32[i] = trunc_sat_f64_to_i32(a.f64[i]);
+            break;
+        case SIMD_i32x4_trunc_sat_f64x2_u_zero:
+            LANE_LOOP(2) r.u32[i] = trunc_sat_f64_to_u32(a.f64[i]);
+            break;
+        case SIMD_f32x4_convert_i32x4_s:
+            LANE_LOOP(4) r.f32[i] = (float32)a.i32[i];
+            break;
+        case SIMD_f32x4_convert_i32x4_u:
+            LANE_LOOP(4) r.f32[i] = (float32)a.u32[i];
+            break;
+        case SIMD_f64x2_convert_low_i32x4_s:
+            LANE_LOOP(2) r.f64[i] = (float64)a.i32[i];
+            break;
+        case SIMD_f64x2_convert_low_i32x4_u:
+            LANE_LOOP(2) r.f64[i] = (float64)a.u32[i];
+            break;
+
+        default:
+            bh_assert(0);
+            return;
+    }
+
+    memcpy(result, &r, sizeof(V128));
+}
+
+/* The lanes of the comparison result are all ones or all zeros */
+#define CMP_LANES(n, lane, res_lane, op) \
+    LANE_LOOP(n) r.res_lane[i] = (a.lane[i] op b.lane[i]) ? -1 : 0
+
+void
+wasm_simd_binary_op(uint8 opcode, const V128 *v1, const V128 *v2,
+                    V128 *result)
+{
+    SIMDLanes a, b, r;
+    uint32 i;
+
+    memcpy(&a, v1, sizeof(V128));
+    memcpy(&b, v2, sizeof(V128));
+
+    switch (opcode) {
+        case SIMD_v8x16_swizzle:
+            LANE_LOOP(16) r.u8[i] = b.u8[i] < 16 ? a.u8[b.u8[i]] : 0;
+            break;
+
+        /* comparison */
+        case SIMD_i8x16_eq:
+            CMP_LANES(16, i8, i8, ==);
+            break;
+        case SIMD_i8x16_ne:
+            CMP_LANES(16, i8, i8, !=);
+            break;
+        case SIMD_i8x16_lt_s:
+            CMP_LANES(16, i8, i8, <);
+            break;
+        case SIMD_i8x16_lt_u:
+            CMP_LANES(16, u8, i8, <);
+            break;
+        case SIMD_i8x16_gt_s:
+            CMP_LANES(16, i8, i8, >);
+            break;
+        case SIMD_i8x16_gt_u:
+            CMP_LANES(16, u8, i8, >);
+            break;
+        case SIMD_i8x16_le_s:
+            CMP_LANES(16, i8, i8, <=);
+            break;
+        case SIMD_i8x16_le_u:
+            CMP_LANES(16, u8, i8, <=);
+            break;
+        case SIMD_i8x16_ge_s:
+            CMP_LANES(16, i8, i8, >=);
+            break;
+        case SIMD_i8x16_ge_u:
+            CMP_LANES(16, u8, i8, >=);
+            break;
+        case SIMD_i16x8_eq:
+            CMP_LANES(8, i16, i16, ==);
+            break;
+        case SIMD_i16x8_ne:
+            CMP_LANES(8, i16, i16, !=);
+            break;
+        case SIMD_i16x8_lt_s:
+            CMP_LANES(8, i16, i16, <);
+            break;
+        case SIMD_i16x8_lt_u:
+            CMP_LANES(8, u16, i16, <);
+            break;
+        case SIMD_i16x8_gt_s:
+            CMP_LANES(8, i16, i16, >);
+            break;
+        case SIMD_i16x8_gt_u:
+            CMP_LANES(8, u16, i16, >);
+            break;
+        case SIMD_i16x8_le_s:
+            CMP_LANES(8, i16, i16, <=);
+            break;
+        case SIMD_i16x8_le_u:
+            CMP_LANES(8, u16, i16, <=);
+            break;
+        case SIMD_i16x8_ge_s:
+            CMP_LANES(8, i16, i16, >=);
+            break;
+        case SIMD_i16x8_ge_u:
+            CMP_LANES(8, u16, i16, >=);
+            break;
+        case SIMD_i32x4_eq:
+            CMP_LANES(4, i32, i32, ==);
+            break;
+        case SIMD_i32x4_ne:
+            CMP_LANES(4, i32, i32, !=);
+            break;
+        case SIMD_i32x4_lt_s:
+            CMP_LANES(4, i32, i32, <);
+            break;
+        case SIMD_i32x4_lt_u:
+            CMP_LANES(4, u32, i32, <);
+            break;
+        case SIMD_i32x4_gt_s:
+            CMP_LANES(4, i32, i32, >);
+            break;
+        case SIMD_i32x4_gt_u:
+            CMP_LANES(4, u32, i32, >);
+            break;
+        case SIMD_i32x4_le_s:
+            CMP_LANES(4, i32, i32, <=);
+            break;
+        case SIMD_i32x4_le_u:
+            CMP_LANES(4, u32, i32, <=);
+            break;
+        case SIMD_i32x4_ge_s:
+            CMP_LANES(4, i32, i32, >=);
+            break;
+        case SIMD_i32x4_ge_u:
+            CMP_LANES(4, u32, i32, >=);
+            break;
+        case SIMD_i64x2_eq:
+            CMP_LANES(2, i64, i64, ==);
+            break;
+        case SIMD_i64x2_ne:
+            CMP_LANES(2, i64, i64, !=);
+            break;
+        case SIMD_i64x2_lt_s:
+            CMP_LANES(2, i64, i64, <);
+            break;
+        case SIMD_i64x2_gt_s:
+            CMP_LANES(2, i64, i64, >);
+            break;
+        case SIMD_i64x2_le_s:
+            CMP_LANES(2, i64, i64, <=);
+            break;
+        case SIMD_i64x2_ge_s:
+            CMP_LANES(2, i64, i64, >=);
+            break;
+        case SIMD_f32x4_eq:
+            CMP_LANES(4, f32, i32, ==);
+            break;
+        case SIMD_f32x4_ne:
+            CMP_LANES(4, f32, i32, !=);
+            break;
+        case SIMD_f32x4_lt:
+            CMP_LANES(4, f32, i32, <);
+            break;
+        case SIMD_f32x4_gt:
+            CMP_LANES(4, f32, i32, >);
+            break;
+        case SIMD_f32x4_le:
+            CMP_LANES(4, f32, i32, <=);
+            break;
+        case SIMD_f32x4_ge:
+            CMP_LANES(4, f32, i32, >=);
+            break;
+        case SIMD_f64x2_eq:
+            CMP_LANES(2, f64, i64, ==);
+            break;
+        case SIMD_f64x2_ne:
+            CMP_LANES(2, f64, i64, !=);
+            break;
+        case SIMD_f64x2_lt:
+            CMP_LANES(2, f64, i64, <);
+            break;
+        case SIMD_f64x2_gt:
+            CMP_LANES(2, f64, i64, >);
+            break;
+        case SIMD_f64x2_le:
+            CMP_LANES(2, f64, i64, <=);
+            break;
+        case SIMD_f64x2_ge:
+            CMP_LANES(2, f64, i64, >=);
+            break;
+
+        /* bitwise */
+        case SIMD_v128_and:
+            LANE_LOOP(2) r.u64[i] = a.u64[i] & b.u64[i];
+            break;
+        case SIMD_v128_andnot:
+            LANE_LOOP(2) r.u64[i] = a.u64[i] & ~b.u64[i];
+            break;
+        case SIMD_v128_or:
+            LANE_LOOP(2) r.u64[i] = a.u64[i] | b.u64[i];
+            break;
+        case SIMD_v128_xor:
+            LANE_LOOP(2) r.u64[i] = a.u64[i] ^ b.u64[i];
+            break;
+
+        /* narrow */
+        case SIMD_i8x16_narrow_i16x8_s:
+            LANE_LOOP(8)
+            {
+                r.i8[i] = sat_i8(a.i16[i]);
+                r.i8[i + 8] = sat_i8(b.i16[i]);
+            }
+            break;
+        case SIMD_i8x16_narrow_i16x8_u:
+            LANE_LOOP(8)
+            {
+                r.u8[i] = sat_u8(a.i16[i]);
+                r.u8[i + 8] = sat_u8(b.i16[i]);
+            }
+            break;
+        case SIMD_i16x8_narrow_i32x4_s:
+            LANE_LOOP(4)
+            {
+                r.i16[i] = sat_i16(a.i32[i]);
+                r.i16[i + 4] = sat_i16(b.i32[i]);
+            }
+            break;
+        case SIMD_i16x8_narrow_i32x4_u:
+            LANE_LOOP(4)
+            {
+                r.u16[i] = sat_u16(a.i32[i]);
+                r.u16[i + 4] = sat_u16(b.i32[i]);
+            }
+            break;
+        case SIMD_i32x4_narrow_i64x2_s:
+            LANE_LOOP(2)
+            {
+                r.i32[i] = sat_i32(a.i64[i]);
+                r.i32[i + 2] = sat_i32(b.i64[i]);
+            }
+            break;
+        case SIMD_i32x4_narrow_i64x2_u:
+            LANE_LOOP(2)
+            {
+                r.u32[i] = sat_u32(a.i64[i]);
+                r.u32[i + 2] = sat_u32(b.i64[i]);
+            }
+            break;
+
+        /* i8x16 arithmetic */
+        case SIMD_i8x16_add:
+            LANE_LOOP(16) r.u8[i] = (uint8)(a.u8[i] + b.u8[i]);
+            break;
+        case SIMD_i8x16_add_sat_s:
+            LANE_LOOP(16) r.i8[i] = sat_i8(a.i8[i] + b.i8[i]);
+            break;
+        case SIMD_i8x16_add_sat_u:
+            LANE_LOOP(16) r.u8[i] = sat_u8(a.u8[i] + b.u8[i]);
+            break;
+        case SIMD_i8x16_sub:
+            LANE_LOOP(16) r.u8[i] = (uint8)(a.u8[i] - b.u8[i]);
+            break;
+        case SIMD_i8x16_sub_sat_s:
+            LANE_LOOP(16) r.i8[i] = sat_i8(a.i8[i] - b.i8[i]);
+            break;
+        case SIMD_i8x16_sub_sat_u:
+            LANE_LOOP(16) r.u8[i] = sat_u8(a.u8[i] - b.u8[i]);
+            break;
+        case SIMD_i8x16_min_s:
+            LANE_LOOP(16) r.i8[i] = a.i8[i] < b.i8[i] ? a.i8[i] : b.i8[i];
+            break;
+        case SIMD_i8x16_min_u:
+            LANE_LOOP(16) r.u8[i] = a.u8[i] < b.u8[i] ? a.u8[i] : b.u8[i];
+            break;
+        case SIMD_i8x16_max_s:
+            LANE_LOOP(16) r.i8[i] = a.i8[i] > b.i8[i] ? a.i8[i] : b.i8[i];
+            break;
+        case SIMD_i8x16_max_u:
+            LANE_LOOP(16) r.u8[i] = a.u8[i] > b.u8[i] ? a.u8[i] : b.u8[i];
+            break;
+        case SIMD_i8x16_avgr_u:
+            LANE_LOOP(16) r.u8[i] = (uint8)((a.u8[i] + b.u8[i] + 1) >> 1);
+            break;
+
+        /* i16x8 arithmetic */
+        case SIMD_i16x8_q15mulr_sat_s:
+            LANE_LOOP(8)
+            r.i16[i] = sat_i16((a.i16[i] * b.i16[i] + 0x4000) >> 15);
+            break;
+        case SIMD_i16x8_add:
+            LANE_LOOP(8) r.u16[i] = (uint16)(a.u16[i] + b.u16[i]);
+            break;
+        case SIMD_i16x8_add_sat_s:
+            LANE_LOOP(8) r.i16[i] = sat_i16(a.i16[i] + b.i16[i]);
+            break;
+        case SIMD_i16x8_add_sat_u:
+            LANE_LOOP(8) r.u16[i] = sat_u16(a.u16[i] + b.u16[i]);
+            break;
+        case SIMD_i16x8_sub:
+            LANE_LOOP(8) r.u16[i] = (uint16)(a.u16[i] - b.u16[i]);
+            break;
+        case SIMD_i16x8_sub_sat_s:
+            LANE_LOOP(8) r.i16[i] = sat_i16(a.i16[i] - b.i16[i]);
+            break;
+        case SIMD_i16x8_sub_sat_u:
+            LANE_LOOP(8) r.u16[i] = sat_u16(a.u16[i] - b.u16[i]);
+            break;
+        case SIMD_i16x8_mul:
+            LANE_LOOP(8) r.u16[i] = (uint16)((uint32)a.u16[i] * b.u16[i]);
+            break;
+        case SIMD_i16x8_min_s:
+            LANE_LOOP(8) r.i16[i] = a.i16[i] < b.i16[i] ? a.i16[i] : b.i16[i];
+            break;
+        case SIMD_i16x8_min_u:
+            LANE_LOOP(8) r.u16[i] = a.u16[i] < b.u16[i] ? a.u16[i] : b.u16[i];
+            break;
+        case SIMD_i16x8_max_s:
+            LANE_LOOP(8) r.i16[i] = a.i16[i] > b.i16[i] ? a.i16[i] : b.i16[i];
+            break;
+        case SIMD_i16x8_max_u:
+            LANE_LOOP(8) r.u16[i] = a.u16[i] > b.u16[i] ? a.u16[i] : b.u16[i];
+            break;
+        case SIMD_i16x8_avgr_u:
+            LANE_LOOP(8) r.u16[i] = (uint16)((a.u16[i] + b.u16[i] + 1) >> 1);
+            break;
+        case SIMD_i16x8_extmul_low_i8x16_s:
+            LANE_LOOP(8) r.i16[i] = (int16)(a.i8[i] * b.i8[i]);
+            break;
+        case SIMD_i16x8_extmul_high_i8x16_s:
+            LANE_LOOP(8) r.i16[i] = (int16)(a.i8[i + 8] * b.i8[i + 8]);
+            break;
+        case SIMD_i16x8_extmul_low_i8x16_u:
+            LANE_LOOP(8) r.u16[i] = (uint16)(a.u8[i] * b.u8[i]);
+            break;
+        case SIMD_i16x8_extmul_high_i8x16_u:
+            LANE_LOOP(8) r.u16[i] = (uint16)(a.u8[i + 8] * b.u8[i + 8]);
+            break;
+
+        /* i32x4 arithmetic */
+        case SIMD_i32x4_add:
+            LANE_LOOP(4) r.u32[i] = a.u32[i] + b.u32[i];
+            break;
+        case SIMD_i32x4_sub:
+            LANE_LOOP(4) r.u32[i] = a.u32[i] - b.u32[i];
+            break;
+        case SIMD_i32x4_mul:
+            LANE_LOOP(4) r.u32[i] = a.u32[i] * b.u32[i];
+            break;
+        case SIMD_i32x4_min_s:
+            LANE_LOOP(4) r.i32[i] = a.i32[i] < b.i32[i] ? a.i32[i] : b.i32[i];
+            break;
+        case SIMD_i32x4_min_u:
+            LANE_LOOP(4) r.u32[i] = a.u32[i] < b.u32[i] ? a.u32[i] : b.u32[i];
+            break;
+        case SIMD_i32x4_max_s:
+            LANE_LOOP(4) r.i32[i] = a.i32[i] > b.i32[i] ? a.i32[i] : b.i32[i];
+            break;
+        case SIMD_i32x4_max_u:
+            LANE_LOOP(4) r.u32[i] = a.u32[i] > b.u32[i] ? a.u32[i] : b.u32[i];
+            break;
+        case SIMD_i32x4_dot_i16x8_s:
+            LANE_LOOP(4)
+            r.u32[i] = (uint32)(a.i16[2 * i] * b.i16[2 * i])
+                       + (uint32)(a.i16[2 * i + 1] * b.i16[2 * i + 1]);
+            break;
+        case SIMD_i32x4_avgr_u:
+            LANE_LOOP(4)
+            r.u32[i] = (uint32)(((uint64)a.u32[i] + b.u32[i] + 1) >> 1);
+            break;
+        case SIMD_i32x4_extmul_low_i16x8_s:
+            LANE_LOOP(4) r.i32[i] = (int32)a.i16[i] * b.i16[i];
+            break;
+        case SIMD_i32x4_extmul_high_i16x8_s:
+            LANE_LOOP(4) r.i32[i] = (int32)a.i16[i + 4] * b.i16[i + 4];
+            break;
+        case SIMD_i32x4_extmul_low_i16x8_u:
+            LANE_LOOP(4) r.u32[i] = (uint32)a.u16[i] * b.u16[i];
+            break;
+        case SIMD_i32x4_extmul_high_i16x8_u:
+            LANE_LOOP(4) r.u32[i] = (uint32)a.u16[i + 4] * b.u16[i + 4];
+            break;
+
+        /* i64x2 arithmetic */
+        case SIMD_i64x2_add:
+            LANE_LOOP(2) r.u64[i] = a.u64[i] + b.u64[i];
+            break;
+        case SIMD_i64x2_sub:
+            LANE_LOOP(2) r.u64[i] = a.u64[i] - b.u64[i];
+            break;
+        case SIMD_i64x2_mul:
+            LANE_LOOP(2) r.u64[i] = a.u64[i] * b.u64[i];
+            break;
+        case SIMD_i64x2_extmul_low_i32x4_s:
+            LANE_LOOP(2) r.i64[i] = (int64)a.i32[i] * b.i32[i];
+            break;
+        case SIMD_i64x2_extmul_high_i32x4_s:
+            LANE_LOOP(2) r.i64[i] = (int64)a.i32[i + 2] * b.i32[i + 2];
+            break;
+        case SIMD_i64x2_extmul_low_i32x4_u:
+            LANE_LOOP(2) r.u64[i] = (uint64)a.u32[i] * b.u32[i];
+            break;
+        case SIMD_i64x2_extmul_high_i32x4_u:
+            LANE_LOOP(2) r.u64[i] = (uint64)a.u32[i + 2] * b.u32[i + 2];
+            break;
+
+        /* f32x4 arithmetic */
+        case SIMD_f32x4_add:
+            LANE_LOOP(4) r.f32[i] = a.f32[i] + b.f32[i];
+            break;
+        case SIMD_f32x4_sub:
+            LANE_LOOP(4) r.f32[i] = a.f32[i] - b.f32[i];
+            break;
+        case SIMD_f32x4_mul:
+            LANE_LOOP(4) r.f32[i] = a.f32[i] * b.f32[i];
+            break;
+        case SIMD_f32x4_div:
+            LANE_LOOP(4) r.f32[i] = a.f32[i] / b.f32[i];
+            break;
+        case SIMD_f32x4_min:
+            LANE_LOOP(4) r.f32[i] = simd_f32_min(a.f32[i], b.f32[i]);
+            break;
+        case SIMD_f32x4_max:
+            LANE_LOOP(4) r.f32[i] = simd_f32_max(a.f32[i], b.f32[i]);
+            break;
+        case SIMD_f32x4_pmin:
+            LANE_LOOP(4) r.f32[i] = b.f32[i] < a.f32[i] ? b.f32[i] : a.f32[i];
+            break;
+        case SIMD_f32x4_pmax:
+            LANE_LOOP(4) r.f32[i] = a.f32[i] < b.f32[i] ? b.f32[i] : a.f32[i];
+            break;
+
+        /* f64x2 arithmetic */
+        case SIMD_f64x2_add:
+            LANE_LOOP(2) r.f64[i] = a.f64[i] + b.f64[i];
+            break;
+        case SIMD_f64x2_sub:
+            LANE_LOOP(2) r.f64[i] = a.f64[i] - b.f64[i];
+            break;
+        case SIMD_f64x2_mul:
+            LANE_LOOP(2) r.f64[i] = a.f64[i] * b.f64[i];
+            break;
+        case SIMD_f64x2_div:
+            LANE_LOOP(2) r.f64[i] = a.f64[i] / b.f64[i];
+            break;
+        case SIMD_f64x2_min:
+            LANE_LOOP(2) r.f64[i] = simd_f64_min(a.f64[i], b.f64[i]);
+            break;
+        case SIMD_f64x2_max:
+            LANE_LOOP(2) r.f64[i] = simd_f64_max(a.f64[i], b.f64[i]);
+            break;
+        case SIMD_f64x2_pmin:
+            LANE_LOOP(2) r.f64[i] = b.f64[i] < a.f64[i] ? b.f64[i] : a.f64[i];
+            break;
+        case SIMD_f64x2_pmax:
+            LANE_LOOP(2) r.f64[i] = a.f64[i] < b.f64[i] ? b.f64[i] : a.f64[i];
+            break;
+
+        default:
+            bh_assert(0);
+            return;
+    }
+
+    memcpy(result, &r, sizeof(V128));
+}
+
+#endif /* end of WASM_ENABLE_SIMD != 0 */
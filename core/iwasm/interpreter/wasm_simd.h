@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _WASM_SIMD_H
+#define _WASM_SIMD_H
+
+#include "wasm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if WASM_ENABLE_SIMD != 0
+
+/*
+ * The lane-wise semantics of the SIMD instructions, shared by the
+ * interpreters and the Fast JIT. The v128 operands are read before the
+ * result is written, so the result may alias any of the operands, e.g.
+ * the slots of the operand stack.
+ */
+
+/**
+ * Return the byte count accessed in the linear memory by a SIMD load
+ * or store opcode.
+ */
+uint32
+wasm_simd_mem_access_size(uint8 opcode);
+
+/**
+ * v128.load, v128.loadNxM_s/u, v128.loadN_splat and v128.loadN_zero
+ */
+void
+wasm_simd_load(uint8 opcode, const uint8 *maddr, V128 *result);
+
+/**
+ * v128.loadN_lane, the lane of vec is replaced in place
+ */
+void
+wasm_simd_load_lane(uint8 opcode, const uint8 *maddr, uint8 lane, V128 *vec);
+
+/**
+ * v128.storeN_lane
+ */
+void
+wasm_simd_store_lane(uint8 opcode, uint8 *maddr, uint8 lane, const V128 *vec);
+
+/**
+ * iNxM.splat and fNxM.splat, the scalar is one or two cells
+ */
+void
+wasm_simd_splat(uint8 opcode, const uint32 *scalar, V128 *result);
+
+/**
+ * iNxM.extract_lane_s/u and fNxM.extract_lane, the result is one or two
+ * cells
+ */
+void
+wasm_simd_extract_lane(uint8 opcode, const V128 *vec, uint8 lane,
+                       uint32 *result);
+
+/**
+ * iNxM.replace_lane and fNxM.replace_lane, the lane of vec is replaced
+ * in place
+ */
+void
+wasm_simd_replace_lane(uint8 opcode, uint8 lane, const uint32 *scalar,
+                       V128 *vec);
+
+/**
+ * i8x16.shuffle
+ */
+void
+wasm_simd_shuffle(const V128 *v1, const V128 *v2, const uint8 *lanes,
+                  V128 *result);
+
+/**
+ * v128.bitselect
+ */
+void
+wasm_simd_bitselect(const V128 *v1, const V128 *v2, const V128 *c,
+                    V128 *result);
+
+/**
+ * iNxM.shl and iNxM.shr_s/u
+ */
+void
+wasm_simd_shift(uint8 opcode, const V128 *vec, uint32 count, V128 *result);
+
+/**
+ * v128.any_true, iNxM.all_true and iNxM.bitmask
+ */
+int32
+wasm_simd_reduce(uint8 opcode, const V128 *vec);
+
+/**
+ * Whether the opcode is one of the v128 -> v128 operations handled by
+ * wasm_simd_unary_op, the other opcodes of wasm_simd_unary_op and
+ * wasm_simd_binary_op are the (v128, v128) -> v128 operations.
+ */
+bool
+wasm_simd_is_unary_op(uint8 opcode);
+
+void
+wasm_simd_unary_op(uint8 opcode, const V128 *vec, V128 *result);
+
+void
+wasm_simd_binary_op(uint8 opcode, const V128 *v1, const V128 *v2,
+                    V128 *result);
+
+#endif /* end of WASM_ENABLE_SIMD != 0 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _WASM_SIMD_H */
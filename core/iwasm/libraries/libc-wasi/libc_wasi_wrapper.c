@@ -112,6 +112,69 @@ wasi_ctx_get_ns_lookup_list(wasi_ctx_t wasi_ctx)
     return wasi_ctx->ns_lookup_list;
 }
 
+/* Max number of iovecs converted into an array on the stack, the larger
+   arrays are allocated */
+#define IOVEC_STACK_NUM 16
+
+/**
+ * Convert the iovecs of the app into native iovecs, looking up the linear
+ * memory once to validate the iovec array and all the buffers. The native
+ * iovecs are stored in iovec_stack if there are at most IOVEC_STACK_NUM of
+ * them, otherwise *p_iovec is allocated and must be freed by the caller.
+ */
+static bool
+convert_iovec_app(wasm_module_inst_t module_inst, const iovec_app_t *iovec_app,
+                  uint32 iovs_len, wasi_iovec_t *iovec_stack,
+                  wasi_iovec_t **p_iovec, uint64 *p_total_len)
+{
+    uint64 total_size = sizeof(iovec_app_t) * (uint64)iovs_len;
+    uint64 total_len = 0;
+    uint8 *mem_start, *mem_end;
+    wasi_iovec_t *iovec = iovec_stack;
+    uint32 i;
+
+    if (!wasm_runtime_get_native_addr_range(module_inst, (uint8 *)iovec_app,
+                                            &mem_start, &mem_end)
+        || total_size > (uint64)(mem_end - (uint8 *)iovec_app))
+        goto fail;
+
+    if (iovs_len > IOVEC_STACK_NUM) {
+        total_size = sizeof(wasi_iovec_t) * (uint64)iovs_len;
+        if (total_size >= UINT32_MAX
+            || !(iovec = wasm_runtime_malloc((uint32)total_size)))
+            return false;
+    }
+
+    for (i = 0; i < iovs_len; i++, iovec_app++) {
+#ifndef OS_ENABLE_HW_BOUND_CHECK
+        /* Accessing the guard pages after the linear memory traps or
+           fails with EFAULT if the hardware bound check is enabled */
+        if ((uint64)iovec_app->buf_offset + iovec_app->buf_len
+                > (uint64)(mem_end - mem_start)
+#if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
+            && wasm_runtime_is_bounds_checks_enabled(module_inst)
+#endif
+        ) {
+            if (iovec != iovec_stack)
+                wasm_runtime_free(iovec);
+            goto fail;
+        }
+#endif
+        iovec[i].buf = mem_start + iovec_app->buf_offset;
+        iovec[i].buf_len = iovec_app->buf_len;
+        total_len += iovec_app->buf_len;
+    }
+
+    *p_iovec = iovec;
+    if (p_total_len)
+        *p_total_len = total_len;
+    return true;
+
+fail:
+    wasm_runtime_set_exception(module_inst, "out of bounds memory access");
+    return false;
+}
+
 static wasi_errno_t
 wasi_args_get(wasm_exec_env_t exec_env, uint32 *argv_offsets, char *argv_buf)
 {
@@ -373,39 +436,20 @@ wasi_fd_pread(wasm_exec_env_t exec_env, wasi_fd_t fd, iovec_app_t *iovec_app,
     wasm_module_inst_t module_inst = get_module_inst(exec_env);
     wasi_ctx_t wasi_ctx = get_wasi_ctx(module_inst);
     struct fd_table *curfds = wasi_ctx_get_curfds(module_inst, wasi_ctx);
-    wasi_iovec_t *iovec, *iovec_begin;
-    uint64 total_size;
+    wasi_iovec_t iovec_stack[IOVEC_STACK_NUM], *iovec;
     size_t nread;
-    uint32 i;
     wasi_errno_t err;
 
     if (!wasi_ctx)
         return (wasi_errno_t)-1;
 
-    total_size = sizeof(iovec_app_t) * (uint64)iovs_len;
     if (!validate_native_addr(nread_app, (uint32)sizeof(uint32))
-        || total_size >= UINT32_MAX
-        || !validate_native_addr(iovec_app, (uint32)total_size))
-        return (wasi_errno_t)-1;
-
-    total_size = sizeof(wasi_iovec_t) * (uint64)iovs_len;
-    if (total_size >= UINT32_MAX
-        || !(iovec_begin = wasm_runtime_malloc((uint32)total_size)))
+        || !convert_iovec_app(module_inst, iovec_app, iovs_len, iovec_stack,
+                              &iovec, NULL))
         return (wasi_errno_t)-1;
 
-    iovec = iovec_begin;
-
-    for (i = 0; i < iovs_len; i++, iovec_app++, iovec++) {
-        if (!validate_app_addr(iovec_app->buf_offset, iovec_app->buf_len)) {
-            err = (wasi_errno_t)-1;
-            goto fail;
-        }
-        iovec->buf = (void *)addr_app_to_native(iovec_app->buf_offset);
-        iovec->buf_len = iovec_app->buf_len;
-    }
-
-    err = wasmtime_ssp_fd_pread(exec_env, curfds, fd, iovec_begin, iovs_len,
-                                offset, &nread);
+    err = wasmtime_ssp_fd_pread(exec_env, curfds, fd, iovec, iovs_len, offset,
+                                &nread);
     if (err)
         goto fail;
 
@@ -416,7 +460,8 @@ wasi_fd_pread(wasm_exec_env_t exec_env, wasi_fd_t fd, iovec_app_t *iovec_app,
     LOG_DEBUG("wasi_fd_pread exec_env=%d, fd=%d \n", exec_env, fd);
 
 fail:
-    wasm_runtime_free(iovec_begin);
+    if (iovec != iovec_stack)
+        wasm_runtime_free(iovec);
     return err;
 }
 
@@ -428,39 +473,21 @@ wasi_fd_pwrite(wasm_exec_env_t exec_env, wasi_fd_t fd,
     wasm_module_inst_t module_inst = get_module_inst(exec_env);
     wasi_ctx_t wasi_ctx = get_wasi_ctx(module_inst);
     struct fd_table *curfds = wasi_ctx_get_curfds(module_inst, wasi_ctx);
-    wasi_ciovec_t *ciovec, *ciovec_begin;
-    uint64 total_size;
+    wasi_iovec_t iovec_stack[IOVEC_STACK_NUM], *iovec;
     size_t nwritten;
-    uint32 i;
     wasi_errno_t err;
 
     if (!wasi_ctx)
         return (wasi_errno_t)-1;
 
-    total_size = sizeof(iovec_app_t) * (uint64)iovs_len;
     if (!validate_native_addr(nwritten_app, (uint32)sizeof(uint32))
-        || total_size >= UINT32_MAX
-        || !validate_native_addr((void *)iovec_app, (uint32)total_size))
-        return (wasi_errno_t)-1;
-
-    total_size = sizeof(wasi_ciovec_t) * (uint64)iovs_len;
-    if (total_size >= UINT32_MAX
-        || !(ciovec_begin = wasm_runtime_malloc((uint32)total_size)))
+        || !convert_iovec_app(module_inst, iovec_app, iovs_len, iovec_stack,
+                              &iovec, NULL))
         return (wasi_errno_t)-1;
 
-    ciovec = ciovec_begin;
-
-    for (i = 0; i < iovs_len; i++, iovec_app++, ciovec++) {
-        if (!validate_app_addr(iovec_app->buf_offset, iovec_app->buf_len)) {
-            err = (wasi_errno_t)-1;
-            goto fail;
-        }
-        ciovec->buf = (char *)addr_app_to_native(iovec_app->buf_offset);
-        ciovec->buf_len = iovec_app->buf_len;
-    }
-
-    err = wasmtime_ssp_fd_pwrite(exec_env, curfds, fd, ciovec_begin, iovs_len,
-                                 offset, &nwritten);
+    err = wasmtime_ssp_fd_pwrite(exec_env, curfds, fd,
+                                 (const wasi_ciovec_t *)iovec, iovs_len, offset,
+                                 &nwritten);
     if (err)
         goto fail;
 
@@ -473,7 +500,8 @@ wasi_fd_pwrite(wasm_exec_env_t exec_env, wasi_fd_t fd,
               exec_env, fd, iovec_app, iovs_len, offset, nwritten_app);
 
 fail:
-    wasm_runtime_free(ciovec_begin);
+    if (iovec != iovec_stack)
+        wasm_runtime_free(iovec);
     return err;
 }
 
@@ -484,39 +512,19 @@ wasi_fd_read(wasm_exec_env_t exec_env, wasi_fd_t fd,
     wasm_module_inst_t module_inst = get_module_inst(exec_env);
     wasi_ctx_t wasi_ctx = get_wasi_ctx(module_inst);
     struct fd_table *curfds = wasi_ctx_get_curfds(module_inst, wasi_ctx);
-    wasi_iovec_t *iovec, *iovec_begin;
-    uint64 total_size;
+    wasi_iovec_t iovec_stack[IOVEC_STACK_NUM], *iovec;
     size_t nread;
-    uint32 i;
     wasi_errno_t err;
 
     if (!wasi_ctx)
         return (wasi_errno_t)-1;
 
-    total_size = sizeof(iovec_app_t) * (uint64)iovs_len;
     if (!validate_native_addr(nread_app, (uint32)sizeof(uint32))
-        || total_size >= UINT32_MAX
-        || !validate_native_addr((void *)iovec_app, (uint32)total_size))
-        return (wasi_errno_t)-1;
-
-    total_size = sizeof(wasi_iovec_t) * (uint64)iovs_len;
-    if (total_size >= UINT32_MAX
-        || !(iovec_begin = wasm_runtime_malloc((uint32)total_size)))
+        || !convert_iovec_app(module_inst, iovec_app, iovs_len, iovec_stack,
+                              &iovec, NULL))
         return (wasi_errno_t)-1;
 
-    iovec = iovec_begin;
-
-    for (i = 0; i < iovs_len; i++, iovec_app++, iovec++) {
-        if (!validate_app_addr(iovec_app->buf_offset, iovec_app->buf_len)) {
-            err = (wasi_errno_t)-1;
-            goto fail;
-        }
-        iovec->buf = (void *)addr_app_to_native(iovec_app->buf_offset);
-        iovec->buf_len = iovec_app->buf_len;
-    }
-
-    err = wasmtime_ssp_fd_read(exec_env, curfds, fd, iovec_begin, iovs_len,
-                               &nread);
+    err = wasmtime_ssp_fd_read(exec_env, curfds, fd, iovec, iovs_len, &nread);
     if (err)
         goto fail;
 
@@ -527,13 +535,14 @@ wasi_fd_read(wasm_exec_env_t exec_env, wasi_fd_t fd,
 
 #if WASM_ENABLE_CHECKPOINT_RESTORE != 0
     LOG_DEBUG("wasi_fd_read exec_env=%d, fd=%d, iovec_app=%d, iovs_len=%d, "
-              "nread_app=%d %d\n",
-              exec_env, fd, iovec_app, iovs_len, nread, total_size);
+              "nread_app=%d\n",
+              exec_env, fd, iovec_app, iovs_len, nread);
     insert_fd(fd, "", 0, nread, MVVM_FREAD);
 #endif
 
 fail:
-    wasm_runtime_free(iovec_begin);
+    if (iovec != iovec_stack)
+        wasm_runtime_free(iovec);
     return err;
 }
 
@@ -688,38 +697,20 @@ wasi_fd_write(wasm_exec_env_t exec_env, wasi_fd_t fd,
     wasm_module_inst_t module_inst = get_module_inst(exec_env);
     wasi_ctx_t wasi_ctx = get_wasi_ctx(module_inst);
     struct fd_table *curfds = wasi_ctx_get_curfds(module_inst, wasi_ctx);
-    wasi_ciovec_t *ciovec, *ciovec_begin;
-    uint64 total_size;
+    wasi_iovec_t iovec_stack[IOVEC_STACK_NUM], *iovec;
     size_t nwritten;
-    uint32 i;
     wasi_errno_t err;
 
     if (!wasi_ctx)
         return (wasi_errno_t)-1;
 
-    total_size = sizeof(iovec_app_t) * (uint64)iovs_len;
     if (!validate_native_addr(nwritten_app, (uint32)sizeof(uint32))
-        || total_size >= UINT32_MAX
-        || !validate_native_addr((void *)iovec_app, (uint32)total_size))
-        return (wasi_errno_t)-1;
-
-    total_size = sizeof(wasi_ciovec_t) * (uint64)iovs_len;
-    if (total_size >= UINT32_MAX
-        || !(ciovec_begin = wasm_runtime_malloc((uint32)total_size)))
+        || !convert_iovec_app(module_inst, iovec_app, iovs_len, iovec_stack,
+                              &iovec, NULL))
         return (wasi_errno_t)-1;
 
-    ciovec = ciovec_begin;
-
-    for (i = 0; i < iovs_len; i++, iovec_app++, ciovec++) {
-        if (!validate_app_addr(iovec_app->buf_offset, iovec_app->buf_len)) {
-            err = (wasi_errno_t)-1;
-            goto fail;
-        }
-        ciovec->buf = (char *)addr_app_to_native(iovec_app->buf_offset);
-        ciovec->buf_len = iovec_app->buf_len;
-    }
-
-    err = wasmtime_ssp_fd_write(exec_env, curfds, fd, ciovec_begin, iovs_len,
+    err = wasmtime_ssp_fd_write(exec_env, curfds, fd,
+                                (const wasi_ciovec_t *)iovec, iovs_len,
                                 &nwritten);
     if (err)
         goto fail;
@@ -735,7 +726,8 @@ wasi_fd_write(wasm_exec_env_t exec_env, wasi_fd_t fd,
 #endif
 
 fail:
-    wasm_runtime_free(ciovec_begin);
+    if (iovec != iovec_stack)
+        wasm_runtime_free(iovec);
     return err;
 }
 
@@ -2399,85 +2391,34 @@ wasi_sock_set_ipv6_only(wasm_exec_env_t exec_env, wasi_fd_t fd, bool is_enabled)
     return wasmtime_ssp_sock_set_ipv6_only(exec_env, curfds, fd, is_enabled);
 }
 
+/* Allocate a buffer to receive the data of the scattered iovecs */
 static wasi_errno_t
-allocate_iovec_app_buffer(wasm_module_inst_t module_inst,
-                          const iovec_app_t *data, uint32 data_len,
-                          uint8 **buf_ptr, uint64 *buf_len)
+allocate_iovec_buffer(uint64 total_len, uint8 **p_buf)
 {
-    uint64 total_size = 0;
-    uint32 i;
-    uint8 *buf_begin = NULL;
-
-    if (data_len == 0) {
-        return __WASI_EINVAL;
-    }
-
-    total_size = sizeof(iovec_app_t) * (uint64)data_len;
-    if (total_size >= UINT32_MAX
-        || !validate_native_addr((void *)data, (uint32)total_size))
-        return __WASI_EINVAL;
-
-    for (total_size = 0, i = 0; i < data_len; i++, data++) {
-        total_size += data->buf_len;
-    }
-
-    if (total_size == 0) {
+    if (total_len == 0)
         return __WASI_EINVAL;
-    }
 
-    if (total_size >= UINT32_MAX
-        || !(buf_begin = wasm_runtime_malloc((uint32)total_size))) {
+    if (total_len >= UINT32_MAX
+        || !(*p_buf = wasm_runtime_malloc((uint32)total_len)))
         return __WASI_ENOMEM;
-    }
-
-    *buf_len = total_size;
-    *buf_ptr = buf_begin;
 
     return __WASI_ESUCCESS;
 }
 
-static wasi_errno_t
-copy_buffer_to_iovec_app(wasm_module_inst_t module_inst, uint8 *buf_begin,
-                         uint32 buf_size, iovec_app_t *data, uint32 data_len,
-                         uint32 size_to_copy)
+static void
+copy_buffer_to_iovec(const uint8 *buf, size_t size, wasi_iovec_t *iovec,
+                     uint32 iovs_len)
 {
-    uint8 *buf = buf_begin;
+    size_t size_to_copy;
     uint32 i;
-    uint32 size_to_copy_into_iovec;
-
-    if (buf_size < size_to_copy) {
-        return __WASI_EINVAL;
-    }
-
-    for (i = 0; i < data_len; data++, i++) {
-        char *native_addr;
-
-        if (!validate_app_addr(data->buf_offset, data->buf_len)) {
-            return __WASI_EINVAL;
-        }
 
-        if (buf >= buf_begin + buf_size
-            || buf + data->buf_len < buf /* integer overflow */
-            || buf + data->buf_len > buf_begin + buf_size
-            || size_to_copy == 0) {
-            break;
-        }
-
-        /**
-         * If our app buffer size is smaller than the amount to be copied,
-         * only copy the amount in the app buffer. Otherwise, we fill the iovec
-         * buffer and reduce size to copy on the next iteration
-         */
-        size_to_copy_into_iovec = min_uint32(data->buf_len, size_to_copy);
-
-        native_addr = (void *)addr_app_to_native(data->buf_offset);
-        bh_memcpy_s(native_addr, size_to_copy_into_iovec, buf,
-                    size_to_copy_into_iovec);
-        buf += size_to_copy_into_iovec;
-        size_to_copy -= size_to_copy_into_iovec;
+    for (i = 0; i < iovs_len && size > 0; i++, iovec++) {
+        size_to_copy = iovec->buf_len < size ? iovec->buf_len : size;
+        bh_memcpy_s(iovec->buf, (uint32)size_to_copy, buf,
+                    (uint32)size_to_copy);
+        buf += size_to_copy;
+        size -= size_to_copy;
     }
-
-    return __WASI_ESUCCESS;
 }
 
 static wasi_errno_t
@@ -2493,6 +2434,7 @@ wasi_sock_recv_from(wasm_exec_env_t exec_env, wasi_fd_t sock,
     wasm_module_inst_t module_inst = get_module_inst(exec_env);
     wasi_ctx_t wasi_ctx = get_wasi_ctx(module_inst);
     struct fd_table *curfds = wasi_ctx_get_curfds(module_inst, wasi_ctx);
+    wasi_iovec_t iovec_stack[IOVEC_STACK_NUM], *iovec;
     uint64 total_size;
     uint8 *buf_begin = NULL;
     wasi_errno_t err;
@@ -2502,16 +2444,26 @@ wasi_sock_recv_from(wasm_exec_env_t exec_env, wasi_fd_t sock,
         return __WASI_EINVAL;
     }
 
-    if (!validate_native_addr(ro_data_len, (uint32)sizeof(uint32)))
+    if (!validate_native_addr(ro_data_len, (uint32)sizeof(uint32))
+        || !convert_iovec_app(module_inst, ri_data, ri_data_len, iovec_stack,
+                              &iovec, &total_size))
         return __WASI_EINVAL;
 
-    err = allocate_iovec_app_buffer(module_inst, ri_data, ri_data_len,
-                                    &buf_begin, &total_size);
-    if (err != __WASI_ESUCCESS) {
-        goto fail;
+    /* Receive into the buffer of the app directly unless it's scattered.
+       The data replayed after a restore is always copied. */
+#if WASM_ENABLE_CHECKPOINT_RESTORE == 0
+    if (ri_data_len == 1 && total_size > 0) {
+        buf_begin = iovec->buf;
+    }
+    else
+#endif
+    {
+        err = allocate_iovec_buffer(total_size, &buf_begin);
+        if (err != __WASI_ESUCCESS) {
+            goto fail;
+        }
+        memset(buf_begin, 0, total_size);
     }
-
-    memset(buf_begin, 0, total_size);
     *ro_data_len = 0;
 
 #if WASM_ENABLE_CHECKPOINT_RESTORE != 0
@@ -2548,8 +2500,9 @@ wasi_sock_recv_from(wasm_exec_env_t exec_env, wasi_fd_t sock,
     }
     *ro_data_len = (uint32)recv_bytes;
 
-    err = copy_buffer_to_iovec_app(module_inst, buf_begin, (uint32)total_size,
-                                   ri_data, ri_data_len, (uint32)recv_bytes);
+    if (buf_begin != iovec->buf) {
+        copy_buffer_to_iovec(buf_begin, recv_bytes, iovec, ri_data_len);
+    }
 #if WASM_ENABLE_CHECKPOINT_RESTORE != 0
     LOG_DEBUG("wasi_sock_recv_from exec_env=%d, sock=%d, \n "
               "ri_data:buf-offset=%u,  ri_data:buf-len=%u, \n ri_data_len=%d, "
@@ -2565,9 +2518,12 @@ wasi_sock_recv_from(wasm_exec_env_t exec_env, wasi_fd_t sock,
               src_addr->addr.ip6.addr.h3, *ro_data_len);
 #endif
 fail:
-    if (buf_begin) {
+    if (buf_begin && buf_begin != iovec->buf) {
         wasm_runtime_free(buf_begin);
     }
+    if (iovec != iovec_stack) {
+        wasm_runtime_free(iovec);
+    }
     return err;
 }
 
@@ -2598,38 +2554,50 @@ wasi_sock_recv(wasm_exec_env_t exec_env, wasi_fd_t sock, iovec_app_t *ri_data,
     return error;
 }
 
+/**
+ * Get the data of the iovecs to send, the buffer of the app is used
+ * directly unless the data is scattered, in which case it's gathered into
+ * an allocated buffer.
+ */
 static wasi_errno_t
 convert_iovec_app_to_buffer(wasm_module_inst_t module_inst,
                             const iovec_app_t *si_data, uint32 si_data_len,
                             uint8 **buf_ptr, uint64 *buf_len)
 {
+    wasi_iovec_t iovec_stack[IOVEC_STACK_NUM], *iovec;
+    uint8 *buf;
     uint32 i;
-    const iovec_app_t *si_data_orig = si_data;
-    uint8 *buf = NULL;
     wasi_errno_t error;
 
-    error = allocate_iovec_app_buffer(module_inst, si_data, si_data_len,
-                                      buf_ptr, buf_len);
-    if (error != __WASI_ESUCCESS) {
-        return error;
-    }
+    if (!convert_iovec_app(module_inst, si_data, si_data_len, iovec_stack,
+                           &iovec, buf_len))
+        return __WASI_EINVAL;
 
-    buf = *buf_ptr;
-    si_data = si_data_orig;
-    for (i = 0; i < si_data_len; i++, si_data++) {
-        char *native_addr;
+    if (si_data_len == 1 && *buf_len > 0) {
+        *buf_ptr = iovec->buf;
+        return __WASI_ESUCCESS;
+    }
 
-        if (!validate_app_addr(si_data->buf_offset, si_data->buf_len)) {
-            wasm_runtime_free(*buf_ptr);
-            return __WASI_EINVAL;
+    error = allocate_iovec_buffer(*buf_len, buf_ptr);
+    if (error == __WASI_ESUCCESS) {
+        for (buf = *buf_ptr, i = 0; i < si_data_len; i++) {
+            bh_memcpy_s(buf, (uint32)iovec[i].buf_len, iovec[i].buf,
+                        (uint32)iovec[i].buf_len);
+            buf += iovec[i].buf_len;
         }
-
-        native_addr = (char *)addr_app_to_native(si_data->buf_offset);
-        bh_memcpy_s(buf, si_data->buf_len, native_addr, si_data->buf_len);
-        buf += si_data->buf_len;
     }
 
-    return __WASI_ESUCCESS;
+    if (iovec != iovec_stack)
+        wasm_runtime_free(iovec);
+    return error;
+}
+
+/* Free the buffer returned by convert_iovec_app_to_buffer() if allocated */
+static void
+free_iovec_app_buffer(uint32 si_data_len, uint8 *buf)
+{
+    if (si_data_len != 1)
+        wasm_runtime_free(buf);
 }
 
 static wasi_errno_t
@@ -2677,7 +2645,7 @@ wasi_sock_send(wasm_exec_env_t exec_env, wasi_fd_t sock,
                                  &send_bytes);
     *so_data_len = (uint32)send_bytes;
 
-    wasm_runtime_free(buf);
+    free_iovec_app_buffer(si_data_len, buf);
 
     return err;
 }
@@ -2735,7 +2703,7 @@ wasi_sock_send_to(wasm_exec_env_t exec_env, wasi_fd_t sock,
               so_data_len);
 #endif
 
-    wasm_runtime_free(buf);
+    free_iovec_app_buffer(si_data_len, buf);
 
     return err;
 }
@@ -7,6 +7,59 @@
 
 #include "ssp_config.h"
 #include "blocking_op.h"
+#include "posix.h"
+
+#ifdef OS_ENABLE_IO_URING
+/**
+ * Get the index of the linear memory in the registered buffers of
+ * io_uring if the buffer falls in it, the memory is registered at the
+ * first I/O and re-registered after it grows or moves.
+ */
+static int
+get_io_uring_buf_index(wasm_exec_env_t exec_env, struct fd_table *curfds,
+                       const void *buf, size_t len)
+{
+    uint8_t *start, *end;
+
+    if (curfds->io_uring_buf_index == -2
+        || !wasm_runtime_get_native_addr_range(
+            wasm_runtime_get_module_inst(exec_env), (uint8_t *)buf, &start,
+            &end)
+        || len > (size_t)(end - (uint8_t *)buf))
+        return -1;
+
+    return os_io_uring_register_buffer(&curfds->io_uring_buf_index, start,
+                                       (uint64)(end - start));
+}
+
+/**
+ * Only the reads into a registered fixed buffer go through io_uring,
+ * samples/io-uring-bench shows the other reads, the writes and the
+ * socket I/O are slower than the synchronous calls.
+ */
+static __wasi_errno_t
+io_uring_readv(wasm_exec_env_t exec_env, struct fd_table *curfds,
+               os_file_handle handle, const struct __wasi_iovec_t *iov,
+               int iovcnt, int64 offset, size_t *nread)
+{
+    int buf_index = -1;
+
+#if WASM_ENABLE_CHECKPOINT_RESTORE == 0
+    /* The kernel writes the pinned pages of a fixed buffer directly,
+       which bypasses the soft-dirty tracking of the memory snapshots */
+    if (iovcnt == 1)
+        buf_index =
+            get_io_uring_buf_index(exec_env, curfds, iov->buf, iov->buf_len);
+#endif
+
+    if (buf_index < 0)
+        return offset < 0 ? os_readv(handle, iov, iovcnt, nread)
+                          : os_preadv(handle, iov, iovcnt,
+                                      (__wasi_filesize_t)offset, nread);
+
+    return os_io_uring_readv(handle, iov, iovcnt, offset, buf_index, nread);
+}
+#endif /* end of OS_ENABLE_IO_URING */
 
 __wasi_errno_t
 blocking_op_close(wasm_exec_env_t exec_env, os_file_handle handle,
@@ -21,26 +74,42 @@ blocking_op_close(wasm_exec_env_t exec_env, os_file_handle handle,
 }
 
 __wasi_errno_t
-blocking_op_readv(wasm_exec_env_t exec_env, os_file_handle handle,
-                  const struct __wasi_iovec_t *iov, int iovcnt, size_t *nread)
+blocking_op_readv(wasm_exec_env_t exec_env, struct fd_table *curfds,
+                  os_file_handle handle, const struct __wasi_iovec_t *iov,
+                  int iovcnt, size_t *nread)
 {
     if (!wasm_runtime_begin_blocking_op(exec_env)) {
         return __WASI_EINTR;
     }
+#ifdef OS_ENABLE_IO_URING
+    __wasi_errno_t error =
+        os_io_uring_is_inited()
+            ? io_uring_readv(exec_env, curfds, handle, iov, iovcnt, -1, nread)
+            : os_readv(handle, iov, iovcnt, nread);
+#else
     __wasi_errno_t error = os_readv(handle, iov, iovcnt, nread);
+#endif
     wasm_runtime_end_blocking_op(exec_env);
     return error;
 }
 
 __wasi_errno_t
-blocking_op_preadv(wasm_exec_env_t exec_env, os_file_handle handle,
-                   const struct __wasi_iovec_t *iov, int iovcnt,
-                   __wasi_filesize_t offset, size_t *nread)
+blocking_op_preadv(wasm_exec_env_t exec_env, struct fd_table *curfds,
+                   os_file_handle handle, const struct __wasi_iovec_t *iov,
+                   int iovcnt, __wasi_filesize_t offset, size_t *nread)
 {
     if (!wasm_runtime_begin_blocking_op(exec_env)) {
         return __WASI_EINTR;
     }
+#ifdef OS_ENABLE_IO_URING
+    __wasi_errno_t ret =
+        os_io_uring_is_inited() && (int64)offset >= 0
+            ? io_uring_readv(exec_env, curfds, handle, iov, iovcnt,
+                             (int64)offset, nread)
+            : os_preadv(handle, iov, iovcnt, offset, nread);
+#else
     __wasi_errno_t ret = os_preadv(handle, iov, iovcnt, offset, nread);
+#endif
     wasm_runtime_end_blocking_op(exec_env);
     return ret;
 }
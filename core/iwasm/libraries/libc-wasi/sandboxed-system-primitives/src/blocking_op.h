@@ -6,16 +6,19 @@
 #include "bh_platform.h"
 #include "wasm_export.h"
 
+struct fd_table;
+
 __wasi_errno_t
 blocking_op_close(wasm_exec_env_t exec_env, os_file_handle handle,
                   bool is_stdio);
 __wasi_errno_t
-blocking_op_readv(wasm_exec_env_t exec_env, os_file_handle handle,
-                  const struct __wasi_iovec_t *iov, int iovcnt, size_t *nread);
+blocking_op_readv(wasm_exec_env_t exec_env, struct fd_table *curfds,
+                  os_file_handle handle, const struct __wasi_iovec_t *iov,
+                  int iovcnt, size_t *nread);
 __wasi_errno_t
-blocking_op_preadv(wasm_exec_env_t exec_env, os_file_handle handle,
-                   const struct __wasi_iovec_t *iov, int iovcnt,
-                   __wasi_filesize_t offset, size_t *nread);
+blocking_op_preadv(wasm_exec_env_t exec_env, struct fd_table *curfds,
+                   os_file_handle handle, const struct __wasi_iovec_t *iov,
+                   int iovcnt, __wasi_filesize_t offset, size_t *nread);
 __wasi_errno_t
 blocking_op_writev(wasm_exec_env_t exec_env, os_file_handle handle,
                    const struct __wasi_ciovec_t *iov, int iovcnt,
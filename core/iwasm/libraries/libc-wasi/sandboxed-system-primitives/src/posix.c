@@ -32,6 +32,10 @@
 #include <poll.h>
 #include <sys/ioctl.h>
 #include <termios.h>
+#if CONFIG_HAS_EPOLL
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#endif
 #include "random.h"
 #include "refcount.h"
 #include "rights.h"
@@ -351,6 +355,131 @@ struct fd_entry {
     __wasi_rights_t rights_inheriting;
 };
 
+#if CONFIG_HAS_LOCKLESS_FD_LOOKUP
+// fd_object_get() looks up file descriptors without taking the lock of
+// the table, so that threads doing I/O at the same time don't all write
+// to the cache line of the lock. Writers still hold the lock exclusively.
+// A writer detaching an object or replacing the entries waits for the
+// lookups that may still see them before dropping them, like RCU.
+//
+// Lookups in progress are counted in one of two phases, in slots spread
+// over the threads. A writer moves new lookups to the other phase and
+// waits for the counters of the previous one to drop to zero.
+#define FD_READER_SLOTS 32
+#define FD_READERS_ALIGN 64
+
+struct fd_readers {
+    // Each slot fills a cache line.
+    struct {
+        uint32 count[2];
+        uint8 padding[FD_READERS_ALIGN - 2 * sizeof(uint32)];
+    } slots[FD_READER_SLOTS];
+};
+
+// Rounds p up to the next cache line boundary.
+static void *
+fd_readers_align_up(void *p)
+{
+    return (void *)(((uintptr_t)p + FD_READERS_ALIGN - 1)
+                    & ~(uintptr_t)(FD_READERS_ALIGN - 1));
+}
+
+#define FD_TABLE_LOAD(v) __atomic_load_n(&(v), __ATOMIC_SEQ_CST)
+#define FD_TABLE_STORE(v, val) __atomic_store_n(&(v), (val), __ATOMIC_SEQ_CST)
+
+// Starts a lockless lookup and returns the counter to pass to
+// fd_readers_exit().
+static uint32 *
+fd_readers_enter(struct fd_table *ft)
+{
+    // Threads run on disjoint stacks, so the stack address picks a slot.
+    uintptr_t sp = (uintptr_t)&sp;
+    uint64 hash = (uint64)(sp >> 16) * 0x9E3779B97F4A7C15ULL;
+    uint32 *counts = ft->readers->slots[hash >> 59].count;
+
+    for (;;) {
+        uint32 phase = FD_TABLE_LOAD(ft->readers_phase);
+        __atomic_fetch_add(&counts[phase], 1, __ATOMIC_SEQ_CST);
+        // A writer that moved to the other phase meanwhile may have
+        // checked this counter already.
+        if (FD_TABLE_LOAD(ft->readers_phase) == phase)
+            return &counts[phase];
+        __atomic_fetch_sub(&counts[phase], 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+static void
+fd_readers_exit(uint32 *count)
+{
+    __atomic_fetch_sub(count, 1, __ATOMIC_RELEASE);
+}
+
+// Waits for the lockless lookups that may still see what the caller has
+// just detached or replaced.
+static void
+fd_readers_wait(struct fd_table *ft) REQUIRES_EXCLUSIVE(ft->lock)
+{
+    uint32 phase = ft->readers_phase;
+
+    FD_TABLE_STORE(ft->readers_phase, phase ^ 1);
+    for (uint32 i = 0; i < FD_READER_SLOTS; i++) {
+        while (FD_TABLE_LOAD(ft->readers->slots[i].count[phase]) != 0)
+            os_usleep(1);
+    }
+}
+#else
+#define FD_TABLE_LOAD(v) (v)
+#define FD_TABLE_STORE(v, val) (v) = (val)
+#endif
+
+#if CONFIG_HAS_EPOLL
+// Registration of a file descriptor in the epoll instance used by
+// poll_oneoff(), indexed by the file descriptor number.
+struct fd_poll_entry {
+    // Object registered, not referenced. Detaching it from the file
+    // descriptor table drops the registration.
+    struct fd_object *object;
+    // Events registered.
+    uint32 events;
+    // Events subscribed to and reported in the current call.
+    uint32 wanted;
+    uint32 revents;
+    uint64 epoch;
+    // epoll doesn't support regular files, which are always ready.
+    bool always_ready;
+};
+
+struct fd_poller {
+    struct mutex lock; // Lock to protect members below.
+    bool busy;         // Whether a thread is waiting on the instance.
+    int epoll_fd;
+    int timer_fd;
+    bool timer_armed;
+    uint64 epoch; // Incremented by every call.
+    struct fd_poll_entry *entries;
+    size_t size;
+};
+
+// Drops the registration of a file descriptor being detached, while
+// its handle is still open.
+static void
+fd_poller_forget(struct fd_table *ft, __wasi_fd_t fd, struct fd_object *fo)
+    REQUIRES_EXCLUSIVE(ft->lock)
+{
+    struct fd_poller *poller = ft->poller;
+    if (poller == NULL)
+        return;
+
+    mutex_lock(&poller->lock);
+    if (fd < poller->size && poller->entries[fd].object == fo) {
+        if (!poller->entries[fd].always_ready)
+            epoll_ctl(poller->epoll_fd, EPOLL_CTL_DEL, fo->file_handle, NULL);
+        poller->entries[fd].object = NULL;
+    }
+    mutex_unlock(&poller->lock);
+}
+#endif
+
 bool
 fd_table_init(struct fd_table *ft)
 {
@@ -359,6 +488,24 @@ fd_table_init(struct fd_table *ft)
     ft->entries = NULL;
     ft->size = 0;
     ft->used = 0;
+#if CONFIG_HAS_LOCKLESS_FD_LOOKUP
+    // Align the counters to cache lines.
+    ft->readers_buf =
+        wasm_runtime_malloc(sizeof(struct fd_readers) + FD_READERS_ALIGN - 1);
+    if (ft->readers_buf == NULL) {
+        rwlock_destroy(&ft->lock);
+        return false;
+    }
+    ft->readers = fd_readers_align_up(ft->readers_buf);
+    memset(ft->readers, 0, sizeof(struct fd_readers));
+    ft->readers_phase = 0;
+#endif
+#ifdef OS_ENABLE_IO_URING
+    ft->io_uring_buf_index = -1;
+#endif
+#if CONFIG_HAS_EPOLL
+    ft->poller = NULL;
+#endif
     return true;
 }
 
@@ -407,14 +554,21 @@ fd_table_grow(struct fd_table *ft, size_t min, size_t incr)
                         (uint32)(sizeof(*entries) * ft->size));
         }
 
-        if (ft->entries)
-            wasm_runtime_free(ft->entries);
-
         // Mark all new file descriptors as unused.
         for (size_t i = ft->size; i < size; ++i)
             entries[i].object = NULL;
-        ft->entries = entries;
-        ft->size = size;
+
+        // Publish the entries before the size, the size never shrinks.
+        struct fd_entry *old_entries = ft->entries;
+        FD_TABLE_STORE(ft->entries, entries);
+        FD_TABLE_STORE(ft->size, size);
+
+        if (old_entries) {
+#if CONFIG_HAS_LOCKLESS_FD_LOOKUP
+            fd_readers_wait(ft);
+#endif
+            wasm_runtime_free(old_entries);
+        }
     }
     return true;
 }
@@ -444,9 +598,9 @@ fd_table_attach(struct fd_table *ft, __wasi_fd_t fd, struct fd_object *fo,
     struct fd_entry *fe = &ft->entries[fd];
     assert(fe->object == NULL
            && "Attempted to overwrite an existing descriptor");
-    fe->object = fo;
     fe->rights_base = rights_base;
     fe->rights_inheriting = rights_inheriting;
+    FD_TABLE_STORE(fe->object, fo);
     ++ft->used;
     assert(ft->size >= ft->used * 2 && "File descriptor too full");
 }
@@ -460,7 +614,15 @@ fd_table_detach(struct fd_table *ft, __wasi_fd_t fd, struct fd_object **fo)
     struct fd_entry *fe = &ft->entries[fd];
     *fo = fe->object;
     assert(*fo != NULL && "Attempted to detach nonexistent descriptor");
-    fe->object = NULL;
+#if CONFIG_HAS_EPOLL
+    fd_poller_forget(ft, fd, *fo);
+#endif
+    FD_TABLE_STORE(fe->object, NULL);
+#if CONFIG_HAS_LOCKLESS_FD_LOOKUP
+    // The reference of the table is handed to the caller, which may drop
+    // it once no lookup can acquire the object anymore.
+    fd_readers_wait(ft);
+#endif
     assert(ft->used > 0 && "Reference count mismatch");
     --ft->used;
 }
@@ -807,6 +969,44 @@ fd_object_get_locked(struct fd_object **fo, struct fd_table *ft, __wasi_fd_t fd,
     return 0;
 }
 
+#if CONFIG_HAS_LOCKLESS_FD_LOOKUP
+// Looks up a file descriptor object without locking the file descriptor
+// table and increases its reference count.
+static __wasi_errno_t
+fd_object_get(struct fd_table *curfds, struct fd_object **fo, __wasi_fd_t fd,
+              __wasi_rights_t rights_base, __wasi_rights_t rights_inheriting)
+    TRYLOCKS_EXCLUSIVE(0, (*fo)->refcount) NO_LOCK_ANALYSIS
+{
+    struct fd_table *ft = curfds;
+    uint32 *count = fd_readers_enter(ft);
+    __wasi_errno_t error = __WASI_EBADF;
+
+    // The entries are at least as large as the size loaded before them.
+    size_t size = FD_TABLE_LOAD(ft->size);
+    struct fd_entry *entries = FD_TABLE_LOAD(ft->entries);
+    if (fd < size) {
+        struct fd_entry *fe = &entries[fd];
+        struct fd_object *object = FD_TABLE_LOAD(fe->object);
+        if (object != NULL) {
+            // The rights are only ever restricted in place, so even a torn
+            // read doesn't grant more than the entry had.
+            if ((~fe->rights_base & rights_base) != 0
+                || (~fe->rights_inheriting & rights_inheriting) != 0) {
+                error = __WASI_ENOTCAPABLE;
+            }
+            else {
+                // The table holds a reference until the lookup is done.
+                refcount_acquire(&object->refcount);
+                *fo = object;
+                error = 0;
+            }
+        }
+    }
+
+    fd_readers_exit(count);
+    return error;
+}
+#else
 // Temporarily locks the file descriptor table to look up a file
 // descriptor object, increases its reference count and drops the lock.
 static __wasi_errno_t
@@ -821,6 +1021,7 @@ fd_object_get(struct fd_table *curfds, struct fd_object **fo, __wasi_fd_t fd,
     rwlock_unlock(&ft->lock);
     return error;
 }
+#endif
 
 __wasi_errno_t
 wasmtime_ssp_fd_datasync(wasm_exec_env_t exec_env, struct fd_table *curfds,
@@ -854,8 +1055,8 @@ wasmtime_ssp_fd_pread(wasm_exec_env_t exec_env, struct fd_table *curfds,
     if (error != 0)
         return error;
 
-    error = blocking_op_preadv(exec_env, fo->file_handle, iov, (int)iovcnt,
-                               offset, nread);
+    error = blocking_op_preadv(exec_env, curfds, fo->file_handle, iov,
+                               (int)iovcnt, offset, nread);
 
     fd_object_release(exec_env, fo);
 
@@ -894,8 +1095,8 @@ wasmtime_ssp_fd_read(wasm_exec_env_t exec_env, struct fd_table *curfds,
     if (error != 0)
         return error;
 
-    error =
-        blocking_op_readv(exec_env, fo->file_handle, iov, (int)iovcnt, nread);
+    error = blocking_op_readv(exec_env, curfds, fo->file_handle, iov,
+                              (int)iovcnt, nread);
 
     fd_object_release(exec_env, fo);
 
@@ -2047,6 +2248,248 @@ wasmtime_ssp_path_remove_directory(wasm_exec_env_t exec_env,
     return error;
 }
 
+#if CONFIG_HAS_EPOLL
+// Data of the epoll event of the timer, file descriptors use their number.
+#define FD_POLLER_TIMER ((uint64)-1)
+
+static struct fd_poller *
+fd_poller_create(void)
+{
+    struct fd_poller *poller = wasm_runtime_malloc(sizeof(*poller));
+    if (poller == NULL)
+        return NULL;
+    memset(poller, 0, sizeof(*poller));
+
+    if (!mutex_init(&poller->lock))
+        goto fail1;
+    if ((poller->epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+        goto fail2;
+    if ((poller->timer_fd =
+             timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC))
+        < 0)
+        goto fail3;
+
+    struct epoll_event ev = { .events = EPOLLIN, .data.u64 = FD_POLLER_TIMER };
+    if (epoll_ctl(poller->epoll_fd, EPOLL_CTL_ADD, poller->timer_fd, &ev) != 0)
+        goto fail4;
+    return poller;
+
+fail4:
+    close(poller->timer_fd);
+fail3:
+    close(poller->epoll_fd);
+fail2:
+    mutex_destroy(&poller->lock);
+fail1:
+    wasm_runtime_free(poller);
+    return NULL;
+}
+
+static void
+fd_poller_destroy(struct fd_poller *poller)
+{
+    close(poller->timer_fd);
+    close(poller->epoll_fd);
+    mutex_destroy(&poller->lock);
+    if (poller->entries != NULL)
+        wasm_runtime_free(poller->entries);
+    wasm_runtime_free(poller);
+}
+
+static bool
+fd_poller_grow(struct fd_poller *poller, __wasi_fd_t fd)
+{
+    if (fd < poller->size)
+        return true;
+
+    size_t size = poller->size == 0 ? 16 : poller->size;
+    while (size <= fd)
+        size *= 2;
+    if (size * sizeof(struct fd_poll_entry) >= UINT32_MAX)
+        return false;
+
+    struct fd_poll_entry *entries =
+        wasm_runtime_malloc((uint32)(size * sizeof(*entries)));
+    if (entries == NULL)
+        return false;
+
+    memset(entries, 0, size * sizeof(*entries));
+    if (poller->entries != NULL) {
+        bh_memcpy_s(entries, (uint32)(size * sizeof(*entries)),
+                    poller->entries,
+                    (uint32)(poller->size * sizeof(*entries)));
+        wasm_runtime_free(poller->entries);
+    }
+    poller->entries = entries;
+    poller->size = size;
+    return true;
+}
+
+// Brings the registrations up to date with the subscriptions, only
+// adding or modifying the file descriptors whose objects or events
+// changed since the previous call. Returns false when the instance
+// can't be used, e.g. another thread is waiting on it, in which case
+// the caller falls back to poll().
+static bool
+fd_poller_begin(struct fd_poller *poller, const __wasi_subscription_t *in,
+                struct fd_object **fos, const struct pollfd *pfds,
+                size_t nsubscriptions)
+{
+    mutex_lock(&poller->lock);
+    if (poller->busy) {
+        mutex_unlock(&poller->lock);
+        return false;
+    }
+
+    ++poller->epoch;
+    for (size_t i = 0; i < nsubscriptions; ++i) {
+        if (fos[i] == NULL)
+            continue;
+        __wasi_fd_t fd = in[i].u.u.fd_readwrite.fd;
+        if (!fd_poller_grow(poller, fd))
+            goto fail;
+        struct fd_poll_entry *e = &poller->entries[fd];
+        if (e->epoch != poller->epoch) {
+            e->epoch = poller->epoch;
+            e->wanted = 0;
+            e->revents = 0;
+        }
+        e->wanted |= (uint32)pfds[i].events;
+    }
+
+    for (size_t i = 0; i < nsubscriptions; ++i) {
+        if (fos[i] == NULL)
+            continue;
+        struct fd_poll_entry *e = &poller->entries[in[i].u.u.fd_readwrite.fd];
+        struct epoll_event ev = { .events = e->wanted,
+                                  .data.u64 = in[i].u.u.fd_readwrite.fd };
+        if (e->object != fos[i]) {
+            e->object = NULL;
+            e->always_ready = false;
+            if (epoll_ctl(poller->epoll_fd, EPOLL_CTL_ADD, fos[i]->file_handle,
+                          &ev)
+                    != 0
+                && (errno != EEXIST
+                    || epoll_ctl(poller->epoll_fd, EPOLL_CTL_MOD,
+                                 fos[i]->file_handle, &ev)
+                           != 0)) {
+                if (errno != EPERM)
+                    goto fail;
+                e->always_ready = true;
+            }
+            e->object = fos[i];
+        }
+        else if (e->events != e->wanted && !e->always_ready) {
+            if (epoll_ctl(poller->epoll_fd, EPOLL_CTL_MOD, fos[i]->file_handle,
+                          &ev)
+                != 0)
+                goto fail;
+        }
+        e->events = e->wanted;
+    }
+
+    poller->busy = true;
+    mutex_unlock(&poller->lock);
+    return true;
+
+fail:
+    mutex_unlock(&poller->lock);
+    return false;
+}
+
+// Waits for the subscribed file descriptors like poll(), with the
+// relative clock subscription, if any, on the timer. The file
+// descriptors reported but not subscribed to anymore are disarmed.
+static int
+fd_poller_wait(struct fd_poller *poller, const __wasi_subscription_t *in,
+               struct fd_object **fos, struct pollfd *pfds,
+               size_t nsubscriptions,
+               const __wasi_subscription_t *clock_subscription, bool nowait)
+{
+    struct epoll_event events[64];
+    int timeout = nowait ? 0 : -1;
+    bool timed_out = false;
+    size_t nready = 0;
+
+    for (size_t i = 0; i < nsubscriptions; ++i) {
+        if (fos[i] != NULL
+            && poller->entries[in[i].u.u.fd_readwrite.fd].always_ready)
+            timeout = 0;
+    }
+
+    struct itimerspec its = { 0 };
+    if (timeout != 0 && clock_subscription != NULL) {
+        convert_timestamp(clock_subscription->u.u.clock.timeout,
+                          &its.it_value);
+        if (its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0)
+            timeout = 0;
+    }
+
+    // Arm the timer for the clock subscription. Otherwise disarm the
+    // timer of a previous call, which also discards an expiration that
+    // wasn't consumed, so that it can't end this wait.
+    bool arm_timer = its.it_value.tv_sec != 0 || its.it_value.tv_nsec != 0;
+    if (arm_timer || poller->timer_armed) {
+        if (timerfd_settime(poller->timer_fd, 0, &its, NULL) != 0)
+            return -1;
+        poller->timer_armed = arm_timer;
+    }
+
+    do {
+        int n = epoll_wait(poller->epoll_fd, events, 64, timeout);
+        if (n < 0)
+            return -1;
+
+        mutex_lock(&poller->lock);
+        for (int i = 0; i < n; ++i) {
+            if (events[i].data.u64 == FD_POLLER_TIMER) {
+                timed_out = true;
+                continue;
+            }
+            // Closed by another thread while waiting.
+            struct fd_poll_entry *e = &poller->entries[events[i].data.u64];
+            if (e->object == NULL)
+                continue;
+            if (e->epoch == poller->epoch) {
+                e->revents = events[i].events;
+                ++nready;
+            }
+            else {
+                // Errors and hangups are reported whatever the events
+                // registered, so unregister it until it's subscribed to
+                // again.
+                epoll_ctl(poller->epoll_fd, EPOLL_CTL_DEL,
+                          e->object->file_handle, NULL);
+                e->object = NULL;
+            }
+        }
+        mutex_unlock(&poller->lock);
+    } while (nready == 0 && !timed_out && timeout != 0);
+
+    int ret = 0;
+    for (size_t i = 0; i < nsubscriptions; ++i) {
+        if (fos[i] == NULL)
+            continue;
+        struct fd_poll_entry *e = &poller->entries[in[i].u.u.fd_readwrite.fd];
+        pfds[i].revents =
+            e->always_ready
+                ? pfds[i].events
+                : (short)(e->revents & (pfds[i].events | POLLERR | POLLHUP));
+        if (pfds[i].revents != 0)
+            ++ret;
+    }
+    return ret;
+}
+
+static void
+fd_poller_end(struct fd_poller *poller)
+{
+    mutex_lock(&poller->lock);
+    poller->busy = false;
+    mutex_unlock(&poller->lock);
+}
+#endif
+
 __wasi_errno_t
 wasmtime_ssp_poll_oneoff(wasm_exec_env_t exec_env, struct fd_table *curfds,
                          const __wasi_subscription_t *in, __wasi_event_t *out,
@@ -2212,6 +2655,15 @@ wasmtime_ssp_poll_oneoff(wasm_exec_env_t exec_env, struct fd_table *curfds,
                 break;
         }
     }
+#if CONFIG_HAS_EPOLL
+    // Keep the table locked so that no file descriptor can be detached
+    // before it's registered.
+    struct fd_poller *poller = ft->poller;
+    bool create_poller = poller == NULL;
+    if (poller != NULL
+        && !fd_poller_begin(poller, in, fos, pfds, nsubscriptions))
+        poller = NULL;
+#endif
     rwlock_unlock(&ft->lock);
 
     // Use a zero-second timeout in case we've already generated events in
@@ -2228,7 +2680,16 @@ wasmtime_ssp_poll_oneoff(wasm_exec_env_t exec_env, struct fd_table *curfds,
         timeout = -1;
     }
 
-    int ret = poll(pfds, nsubscriptions, timeout);
+    int ret;
+#if CONFIG_HAS_EPOLL
+    if (poller != NULL) {
+        ret = fd_poller_wait(poller, in, fos, pfds, nsubscriptions,
+                             clock_subscription, *nevents != 0);
+        fd_poller_end(poller);
+    }
+    else
+#endif
+        ret = poll(pfds, nsubscriptions, timeout);
 
     __wasi_errno_t error = 0;
     if (ret == -1) {
@@ -2244,7 +2705,7 @@ wasmtime_ssp_poll_oneoff(wasm_exec_env_t exec_env, struct fd_table *curfds,
     else {
         // Events got triggered. Don't trigger the clock event.
         for (size_t i = 0; i < nsubscriptions; ++i) {
-            if (pfds[i].fd >= 0) {
+            if (pfds[i].fd >= 0 && pfds[i].revents != 0) {
                 __wasi_filesize_t nbytes = 0;
                 if (in[i].u.type == __WASI_EVENTTYPE_FD_READ) {
                     int l;
@@ -2303,6 +2764,16 @@ wasmtime_ssp_poll_oneoff(wasm_exec_env_t exec_env, struct fd_table *curfds,
             fd_object_release(exec_env, fos[i]);
     wasm_runtime_free(fos);
     wasm_runtime_free(pfds);
+
+#if CONFIG_HAS_EPOLL
+    // The first call creates the epoll instance used by the next ones.
+    if (create_poller) {
+        rwlock_wrlock(&ft->lock);
+        if (ft->poller == NULL)
+            ft->poller = fd_poller_create();
+        rwlock_unlock(&ft->lock);
+    }
+#endif
     return error;
 #endif
 }
@@ -3001,6 +3472,16 @@ fd_table_destroy(struct fd_table *ft)
         rwlock_destroy(&ft->lock);
         wasm_runtime_free(ft->entries);
     }
+#if CONFIG_HAS_LOCKLESS_FD_LOOKUP
+    wasm_runtime_free(ft->readers_buf);
+#endif
+#ifdef OS_ENABLE_IO_URING
+    os_io_uring_unregister_buffer(ft->io_uring_buf_index);
+#endif
+#if CONFIG_HAS_EPOLL
+    if (ft->poller != NULL)
+        fd_poller_destroy(ft->poller);
+#endif
 }
 
 void
@@ -18,7 +18,9 @@
 #include "locking.h"
 
 struct fd_entry;
+struct fd_poller;
 struct fd_prestat;
+struct fd_readers;
 struct syscalls;
 
 struct fd_table {
@@ -26,6 +28,21 @@ struct fd_table {
     struct fd_entry *entries;
     size_t size;
     size_t used;
+#if CONFIG_HAS_LOCKLESS_FD_LOOKUP
+    /* Counters of the lockless lookups in progress, and the phase that
+       new lookups are counted in */
+    struct fd_readers *readers;
+    void *readers_buf;
+    uint32 readers_phase;
+#endif
+#ifdef OS_ENABLE_IO_URING
+    /* Index of the linear memory in the registered buffers of io_uring */
+    int io_uring_buf_index;
+#endif
+#if CONFIG_HAS_EPOLL
+    /* epoll instance kept across poll_oneoff calls, created on first use */
+    struct fd_poller *poller;
+#endif
 };
 
 struct fd_prestats {
@@ -47,6 +47,20 @@
 #define CONFIG_HAS_CLOCK_NANOSLEEP 0
 #endif
 
+#if defined(__linux__) && !defined(BH_PLATFORM_LINUX_SGX)
+#define CONFIG_HAS_EPOLL 1
+#else
+#define CONFIG_HAS_EPOLL 0
+#endif
+
+// Look up file descriptors without taking the lock of the table, which
+// relies on the atomic builtins of GCC and Clang.
+#if defined(__GNUC__) && !defined(BH_PLATFORM_LINUX_SGX)
+#define CONFIG_HAS_LOCKLESS_FD_LOOKUP 1
+#else
+#define CONFIG_HAS_LOCKLESS_FD_LOOKUP 0
+#endif
+
 #if defined(__APPLE__) || defined(__CloudABI__)
 #define CONFIG_HAS_PTHREAD_COND_TIMEDWAIT_RELATIVE_NP 1
 #else
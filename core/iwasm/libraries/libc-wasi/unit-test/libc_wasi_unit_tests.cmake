@@ -0,0 +1,6 @@
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+create_wamr_unit_test(libc_wasi
+    ${CMAKE_CURRENT_LIST_DIR}/test_poll_oneoff.cpp
+)
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "wasmtime_ssp.h"
+#include "posix.h"
+}
+
+#include <chrono>
+#include <thread>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define FD_A 3
+#define FD_B 4
+
+/* Nanoseconds of the clock subscriptions */
+#define MS(n) ((__wasi_timestamp_t)(n)*1000000)
+
+/*
+ * poll_oneoff keeps an epoll instance and a timerfd for the relative clock
+ * subscription across calls, the tests check that the state left by a call
+ * doesn't change the result of the next ones.
+ */
+class PollOneoffTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(fd_table_init(&_ft));
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, _a), 0);
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, _b), 0);
+        ASSERT_TRUE(fd_table_insert_existing(&_ft, FD_A, _a[0], false));
+        ASSERT_TRUE(fd_table_insert_existing(&_ft, FD_B, _b[0], false));
+
+        /* The first call creates the epoll instance used by the others */
+        write_byte(_b[1]);
+        ASSERT_EQ(poll({ fd_read(FD_B) }), 1u);
+        read_byte(_b[0]);
+    }
+
+    void TearDown() override
+    {
+        /* Closes _a[0] and _b[0] */
+        fd_table_destroy(&_ft);
+        close(_a[1]);
+        close(_b[1]);
+    }
+
+    static __wasi_subscription_t fd_read(__wasi_fd_t fd)
+    {
+        __wasi_subscription_t s;
+
+        memset(&s, 0, sizeof(s));
+        s.userdata = fd;
+        s.u.type = __WASI_EVENTTYPE_FD_READ;
+        s.u.u.fd_readwrite.fd = fd;
+        return s;
+    }
+
+    static __wasi_subscription_t clock(__wasi_timestamp_t timeout)
+    {
+        __wasi_subscription_t s;
+
+        memset(&s, 0, sizeof(s));
+        s.userdata = 100;
+        s.u.type = __WASI_EVENTTYPE_CLOCK;
+        s.u.u.clock.clock_id = __WASI_CLOCK_MONOTONIC;
+        s.u.u.clock.timeout = timeout;
+        return s;
+    }
+
+    size_t poll(std::vector<__wasi_subscription_t> in)
+    {
+        size_t nevents = 0;
+
+        _out.resize(in.size());
+        EXPECT_EQ(wasmtime_ssp_poll_oneoff(NULL, &_ft, in.data(), _out.data(),
+                                           in.size(), &nevents),
+                  __WASI_ESUCCESS);
+        return nevents;
+    }
+
+    static void write_byte(int fd) { ASSERT_EQ(write(fd, "x", 1), 1); }
+
+    static void read_byte(int fd)
+    {
+        char c;
+        ASSERT_EQ(read(fd, &c, 1), 1);
+    }
+
+    /* Waits for FD_A without clock, which is made readable after 200ms */
+    void wait_fd_a()
+    {
+        std::thread writer([this] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            write_byte(_a[1]);
+        });
+
+        EXPECT_EQ(poll({ fd_read(FD_A) }), 1u);
+        EXPECT_EQ(_out[0].type, __WASI_EVENTTYPE_FD_READ);
+        EXPECT_EQ(_out[0].userdata, (__wasi_userdata_t)FD_A);
+        writer.join();
+    }
+
+    struct fd_table _ft;
+    int _a[2], _b[2];
+    std::vector<__wasi_event_t> _out;
+};
+
+TEST_F(PollOneoffTest, ReportsReadableFd)
+{
+    write_byte(_b[1]);
+
+    ASSERT_EQ(poll({ fd_read(FD_A), fd_read(FD_B), clock(MS(1000)) }), 1u);
+    EXPECT_EQ(_out[0].type, __WASI_EVENTTYPE_FD_READ);
+    EXPECT_EQ(_out[0].userdata, (__wasi_userdata_t)FD_B);
+    EXPECT_EQ(_out[0].u.fd_readwrite.nbytes, 1u);
+}
+
+TEST_F(PollOneoffTest, ReportsClockWhenNoFdIsReady)
+{
+    auto begin = std::chrono::steady_clock::now();
+
+    ASSERT_EQ(poll({ fd_read(FD_A), clock(MS(50)) }), 1u);
+    EXPECT_EQ(_out[0].type, __WASI_EVENTTYPE_CLOCK);
+    EXPECT_GE(std::chrono::steady_clock::now() - begin,
+              std::chrono::milliseconds(50));
+}
+
+TEST_F(PollOneoffTest, ExpiredTimerDoesNotEndLaterWait)
+{
+    ASSERT_EQ(poll({ fd_read(FD_A), clock(MS(10)) }), 1u);
+    ASSERT_EQ(_out[0].type, __WASI_EVENTTYPE_CLOCK);
+
+    wait_fd_a();
+}
+
+TEST_F(PollOneoffTest, PendingTimerDoesNotEndLaterWait)
+{
+    /* Returns at once, leaving the timer armed */
+    write_byte(_b[1]);
+    ASSERT_EQ(poll({ fd_read(FD_B), clock(MS(50)) }), 1u);
+    read_byte(_b[0]);
+
+    wait_fd_a();
+}
+
+TEST_F(PollOneoffTest, PendingTimerDoesNotEndWaitAfterZeroTimeout)
+{
+    write_byte(_b[1]);
+    ASSERT_EQ(poll({ fd_read(FD_B), clock(MS(50)) }), 1u);
+    read_byte(_b[0]);
+
+    /* A zero timeout doesn't use the timer */
+    ASSERT_EQ(poll({ fd_read(FD_A), clock(0) }), 1u);
+    ASSERT_EQ(_out[0].type, __WASI_EVENTTYPE_CLOCK);
+
+    wait_fd_a();
+}
@@ -4,6 +4,7 @@
  */
 
 #include "thread_manager.h"
+#include "../common/wasm_memory.h"
 
 #if WASM_ENABLE_INTERP != 0
 #include "../interpreter/wasm_runtime.h"
@@ -584,33 +585,12 @@ wasm_cluster_destroy_spawned_exec_env(WASMExecEnv *exec_env)
     os_mutex_unlock(&cluster->lock);
 }
 
-/* start routine of thread manager */
+/* Release the resources of a thread once its routine exits */
 static void *
-thread_manager_start_routine(void *arg)
+thread_manager_exit_routine(WASMExecEnv *exec_env,
+                            WASMModuleInstanceCommon *module_inst, void *ret)
 {
-    void *ret;
-    WASMExecEnv *exec_env = (WASMExecEnv *)arg;
     WASMCluster *cluster = wasm_exec_env_get_cluster(exec_env);
-    WASMModuleInstanceCommon *module_inst =
-        wasm_exec_env_get_module_inst(exec_env);
-
-    bh_assert(cluster != NULL);
-    bh_assert(module_inst != NULL);
-
-    os_mutex_lock(&exec_env->wait_lock);
-#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
-    uint64_t old_handle = (uint64_t)exec_env->handle;
-#endif
-    exec_env->handle = os_self_thread();
-#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
-    wamr_handle_map(old_handle, (uint64_t)exec_env->handle);
-    //wamr_korp_tid_map(old_korp_tid, os_self_thread());
-#endif
-    /* Notify the parent thread to continue running */
-    os_cond_signal(&exec_env->wait_cond);
-    os_mutex_unlock(&exec_env->wait_lock);
-
-    ret = exec_env->thread_start_routine(exec_env);
 
 #ifdef OS_ENABLE_HW_BOUND_CHECK
     os_mutex_lock(&exec_env->wait_lock);
@@ -653,10 +633,44 @@ thread_manager_start_routine(void *arg)
 
     os_mutex_unlock(&cluster_list_lock);
 
+    wasm_runtime_memory_flush_thread_cache();
+
     os_thread_exit(ret);
     return ret;
 }
 
+/* start routine of thread manager */
+static void *
+thread_manager_start_routine(void *arg)
+{
+    void *ret;
+    WASMExecEnv *exec_env = (WASMExecEnv *)arg;
+    WASMCluster *cluster = wasm_exec_env_get_cluster(exec_env);
+    WASMModuleInstanceCommon *module_inst =
+        wasm_exec_env_get_module_inst(exec_env);
+
+    bh_assert(cluster != NULL);
+    bh_assert(module_inst != NULL);
+    (void)cluster;
+
+    os_mutex_lock(&exec_env->wait_lock);
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+    uint64_t old_handle = (uint64_t)exec_env->handle;
+#endif
+    exec_env->handle = os_self_thread();
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+    wamr_handle_map(old_handle, (uint64_t)exec_env->handle);
+    //wamr_korp_tid_map(old_korp_tid, os_self_thread());
+#endif
+    /* Notify the parent thread to continue running */
+    os_cond_signal(&exec_env->wait_cond);
+    os_mutex_unlock(&exec_env->wait_lock);
+
+    ret = exec_env->thread_start_routine(exec_env);
+
+    return thread_manager_exit_routine(exec_env, module_inst, ret);
+}
+
 // Explicitly define so it moves a pointer instead of int
 WASMExecEnv *restore_env(WASMModuleInstanceCommon* module_inst);
 
@@ -744,6 +758,9 @@ wasm_cluster_create_thread(WASMExecEnv *exec_env,
 #if WASM_ENABLE_CHECKPOINT_RESTORE != 0
     if (is_restore) {
         exec_env->restore_call_chain = save_restore_call_chain;
+        /* The chain was installed by restore_env(), not allocated by
+           aot_restore_call_chain(), so the runtime mustn't free it */
+        exec_env->restore_call_chain_owned = false;
         exec_env->is_restore = true;
     }
 #endif
@@ -779,6 +796,263 @@ fail1:
     return -1;
 }
 
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+/* Threads of a checkpointed cluster wait here once restored, until every
+   one is ready and the main thread releases them all together */
+typedef struct RestoreBarrier {
+    korp_mutex lock;
+    korp_cond cond;
+    /* threads that finished rebuilding, successfully or not */
+    uint32 ready_count;
+    /* threads still to leave the barrier once released */
+    uint32 waiting_count;
+    bool failed;
+    bool released;
+} RestoreBarrier;
+
+typedef struct RestoreThreadArg {
+    RestoreBarrier *barrier;
+    WASMCluster *cluster;
+    wasm_thread_restore_info_t info;
+    uint32 wasm_stack_size;
+    uint32 suspend_flags;
+} RestoreThreadArg;
+
+/* The caller must lock cluster->lock */
+static bool
+claim_aux_stack(WASMCluster *cluster, uint32 start)
+{
+#if WASM_ENABLE_HEAP_AUX_STACK_ALLOCATION != 0
+    /* The stack was allocated from the restored app heap */
+    (void)cluster;
+    (void)start;
+    return true;
+#else
+    uint32 i;
+
+    if (!cluster->stack_segment_occupied)
+        return false;
+
+    for (i = 0; i < cluster_max_thread_num; i++) {
+        if (start == cluster->stack_tops[i]) {
+            if (cluster->stack_segment_occupied[i])
+                return false;
+            cluster->stack_segment_occupied[i] = true;
+            return true;
+        }
+    }
+    return false;
+#endif
+}
+
+/* The caller must lock cluster->lock */
+static void
+unclaim_aux_stack(WASMCluster *cluster, uint32 start)
+{
+#if WASM_ENABLE_HEAP_AUX_STACK_ALLOCATION == 0
+    uint32 i;
+
+    for (i = 0; i < cluster_max_thread_num; i++) {
+        if (start == cluster->stack_tops[i]) {
+            cluster->stack_segment_occupied[i] = false;
+            return;
+        }
+    }
+#else
+    (void)cluster;
+    (void)start;
+#endif
+}
+
+/* Rebuild the exec_env, aux stack and call chain of a thread */
+static WASMExecEnv *
+restore_thread_exec_env(RestoreThreadArg *restore_arg)
+{
+    WASMCluster *cluster = restore_arg->cluster;
+    const wasm_thread_restore_info_t *info = &restore_arg->info;
+    WASMExecEnv *exec_env;
+
+    if (!(exec_env = wasm_exec_env_create_internal(
+              info->module_inst, restore_arg->wasm_stack_size)))
+        return NULL;
+
+    exec_env->handle = os_self_thread();
+    wamr_handle_map(info->handle, (uint64_t)exec_env->handle);
+
+    if (info->aux_stack_size > 0) {
+        if (!wasm_exec_env_set_aux_stack(exec_env, info->aux_stack_start,
+                                         info->aux_stack_size))
+            goto fail1;
+    }
+    else {
+        /* Disable aux stack */
+        exec_env->aux_stack_boundary.boundary = 0;
+        exec_env->aux_stack_bottom.bottom = UINT32_MAX;
+    }
+
+    if (!wasm_runtime_restore_call_chain(exec_env, info->frames,
+                                         info->frame_count))
+        goto fail1;
+
+    exec_env->suspend_flags.flags = restore_arg->suspend_flags;
+
+    os_mutex_lock(&cluster->lock);
+    if (info->aux_stack_size > 0
+        && !claim_aux_stack(cluster, info->aux_stack_start)) {
+        LOG_ERROR("thread manager error: "
+                  "aux stack of restored thread is unavailable");
+        goto fail2;
+    }
+    if (!wasm_cluster_add_exec_env(cluster, exec_env)) {
+        if (info->aux_stack_size > 0)
+            unclaim_aux_stack(cluster, info->aux_stack_start);
+        goto fail2;
+    }
+    os_mutex_unlock(&cluster->lock);
+
+    return exec_env;
+
+fail2:
+    os_mutex_unlock(&cluster->lock);
+fail1:
+    /* The module instance still belongs to the caller */
+    wasm_exec_env_destroy_internal(exec_env);
+    return NULL;
+}
+
+/* start routine of a restored thread */
+static void *
+thread_manager_restore_routine(void *arg)
+{
+    RestoreThreadArg *restore_arg = (RestoreThreadArg *)arg;
+    RestoreBarrier *barrier = restore_arg->barrier;
+    WASMCluster *cluster = restore_arg->cluster;
+    wasm_thread_restore_info_t info = restore_arg->info;
+    WASMExecEnv *exec_env;
+    bool resume;
+    void *ret;
+
+    exec_env = restore_thread_exec_env(restore_arg);
+
+    os_mutex_lock(&barrier->lock);
+    if (!exec_env)
+        barrier->failed = true;
+    barrier->ready_count++;
+    os_cond_broadcast(&barrier->cond);
+    while (!barrier->released)
+        os_cond_wait(&barrier->cond, &barrier->lock);
+    resume = exec_env && !barrier->failed;
+    /* restore_arg and barrier mustn't be accessed after leaving */
+    if (--barrier->waiting_count == 0)
+        os_cond_broadcast(&barrier->cond);
+    os_mutex_unlock(&barrier->lock);
+
+    if (!resume) {
+        if (exec_env) {
+            os_mutex_lock(&cluster->lock);
+            if (info.aux_stack_size > 0)
+                unclaim_aux_stack(cluster, info.aux_stack_start);
+            wasm_cluster_del_exec_env_internal(cluster, exec_env, false);
+            os_mutex_unlock(&cluster->lock);
+            wasm_exec_env_destroy_internal(exec_env);
+        }
+        wasm_runtime_memory_flush_thread_cache();
+        os_thread_detach(os_self_thread());
+        os_thread_exit(NULL);
+        return NULL;
+    }
+
+    ret = info.callback(exec_env, info.arg);
+
+    return thread_manager_exit_routine(exec_env, info.module_inst, ret);
+}
+
+int32
+wasm_cluster_restore_threads(WASMExecEnv *exec_env,
+                             const wasm_thread_restore_info_t *infos,
+                             uint32 count)
+{
+    WASMCluster *cluster = wasm_exec_env_get_cluster(exec_env);
+    RestoreBarrier barrier = { 0 };
+    RestoreThreadArg *restore_args;
+    uint64 total_size = sizeof(RestoreThreadArg) * (uint64)count;
+    uint32 created, i;
+    korp_tid tid;
+    bool failed;
+
+    bh_assert(cluster);
+
+    if (count == 0)
+        return 0;
+
+    os_mutex_lock(&cluster->lock);
+    failed = cluster->has_exception || cluster->processing;
+    os_mutex_unlock(&cluster->lock);
+    if (failed)
+        return -1;
+
+    for (i = 0; i < count; i++) {
+        if (!infos[i].module_inst || !infos[i].callback)
+            return -1;
+    }
+
+    if (total_size >= UINT32_MAX
+        || !(restore_args = wasm_runtime_malloc((uint32)total_size))) {
+        LOG_ERROR("thread manager error: failed to allocate memory");
+        return -1;
+    }
+
+    if (os_mutex_init(&barrier.lock) != 0)
+        goto fail1;
+    if (os_cond_init(&barrier.cond) != 0)
+        goto fail2;
+
+    /* Every thread rebuilds its own exec_env in parallel */
+    for (created = 0; created < count; created++) {
+        restore_args[created].barrier = &barrier;
+        restore_args[created].cluster = cluster;
+        restore_args[created].info = infos[created];
+        restore_args[created].wasm_stack_size = exec_env->wasm_stack_size;
+        restore_args[created].suspend_flags = exec_env->suspend_flags.flags;
+
+        if (0
+            != os_thread_create(&tid, thread_manager_restore_routine,
+                                &restore_args[created],
+                                APP_THREAD_STACK_SIZE_DEFAULT)) {
+            LOG_ERROR("thread manager error: "
+                      "failed to create restored thread");
+            break;
+        }
+    }
+
+    os_mutex_lock(&barrier.lock);
+    if (created < count)
+        barrier.failed = true;
+    while (barrier.ready_count < created)
+        os_cond_wait(&barrier.cond, &barrier.lock);
+    /* Release all the threads together, they exit if any failed */
+    failed = barrier.failed;
+    barrier.waiting_count = created;
+    barrier.released = true;
+    os_cond_broadcast(&barrier.cond);
+    while (barrier.waiting_count > 0)
+        os_cond_wait(&barrier.cond, &barrier.lock);
+    os_mutex_unlock(&barrier.lock);
+
+    os_cond_destroy(&barrier.cond);
+    os_mutex_destroy(&barrier.lock);
+    wasm_runtime_free(restore_args);
+
+    return failed ? -1 : 0;
+
+fail2:
+    os_mutex_destroy(&barrier.lock);
+fail1:
+    wasm_runtime_free(restore_args);
+    return -1;
+}
+#endif /* end of WASM_ENABLE_CHECKPOINT_RESTORE != 0 */
+
 bool
 wasm_cluster_dup_c_api_imports(WASMModuleInstanceCommon *module_inst_dst,
                                const WASMModuleInstanceCommon *module_inst_src)
@@ -1092,6 +1366,8 @@ wasm_cluster_exit_thread(WASMExecEnv *exec_env, void *retval)
 
     os_mutex_unlock(&cluster_list_lock);
 
+    wasm_runtime_memory_flush_thread_cache();
+
     os_thread_exit(retval);
 }
 
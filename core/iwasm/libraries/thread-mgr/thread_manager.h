@@ -84,6 +84,14 @@ wasm_cluster_create_thread(WASMExecEnv *exec_env,
                            wasm_module_inst_t module_inst, bool alloc_aux_stack,
                            void *(*thread_routine)(void *), void *arg);
 
+#if WASM_ENABLE_CHECKPOINT_RESTORE != 0
+/* Restore the threads of a checkpointed cluster in parallel */
+int32
+wasm_cluster_restore_threads(WASMExecEnv *exec_env,
+                             const wasm_thread_restore_info_t *infos,
+                             uint32 count);
+#endif
+
 int32
 wasm_cluster_join_thread(WASMExecEnv *exec_env, void **ret_val);
 
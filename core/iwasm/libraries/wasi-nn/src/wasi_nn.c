@@ -95,7 +95,7 @@ value_destroy_func(void *value)
 }
 
 static WASINNContext *
-wasi_nn_initialize_context()
+wasi_nn_initialize_context(wasm_module_inst_t instance)
 {
     NN_DBG_PRINTF("Initializing wasi-nn context");
     WASINNContext *wasi_nn_ctx =
@@ -105,7 +105,7 @@ wasi_nn_initialize_context()
         return NULL;
     }
     wasi_nn_ctx->is_model_loaded = false;
-    tensorflowlite_initialize(&wasi_nn_ctx->tflite_ctx);
+    tensorflowlite_initialize(&wasi_nn_ctx->tflite_ctx, instance);
     return wasi_nn_ctx;
 }
 
@@ -113,6 +113,10 @@ static bool
 wasi_nn_initialize()
 {
     NN_DBG_PRINTF("Initializing wasi-nn");
+    if (!tensorflowlite_startup()) {
+        NN_ERR_PRINTF("Error while initializing tensorflowlite");
+        return false;
+    }
     hashmap = bh_hash_map_create(HASHMAP_INITIAL_SIZE, true, hash_func,
                                  key_equal_func, key_destroy_func,
                                  value_destroy_func);
@@ -129,7 +133,7 @@ wasm_runtime_get_wasi_nn_ctx(wasm_module_inst_t instance)
     WASINNContext *wasi_nn_ctx =
         (WASINNContext *)bh_hash_map_find(hashmap, (void *)instance);
     if (wasi_nn_ctx == NULL) {
-        wasi_nn_ctx = wasi_nn_initialize_context();
+        wasi_nn_ctx = wasi_nn_initialize_context(instance);
         if (wasi_nn_ctx == NULL)
             return NULL;
         bool ok =
@@ -15,6 +15,9 @@
 #include <tensorflow/lite/model.h>
 #include <tensorflow/lite/optional_debug_tools.h>
 #include <tensorflow/lite/error_reporter.h>
+#include <tensorflow/lite/util.h>
+
+#include <vector>
 
 #if WASM_ENABLE_WASI_NN_GPU != 0
 #include <tensorflow/lite/delegates/gpu/delegate.h>
@@ -29,13 +32,77 @@
 /* Maximum number of graph execution context per WASM instance*/
 #define MAX_GRAPH_EXEC_CONTEXTS_PER_INST 10
 
+#if WASM_ENABLE_WASI_NN_BATCHING != 0
+typedef struct {
+    tflite::Interpreter *interpreter;
+    bool done;
+    error res;
+} BatchRequest;
+
+/* Merges the concurrent computes of the execution contexts of a model
+   into one invocation of an interpreter with a larger batch dimension */
+typedef struct {
+    korp_mutex lock;
+    korp_cond cond;
+    /* Requests waiting for the next batch */
+    BatchRequest *pending[WASM_WASI_NN_MAX_BATCH_SIZE];
+    uint32_t pending_count;
+    /* Execution contexts of all instances, no batch can be larger */
+    uint32_t context_count;
+    /* Whether a thread is collecting or running a batch */
+    bool running;
+    /* Whether the model turned out not to support batching */
+    bool disabled;
+    std::unique_ptr<tflite::Interpreter> interpreter;
+    /* Batch size the tensors of the interpreter are allocated for */
+    uint32_t batch_size;
+} Batcher;
+#endif
+
+/* A model loaded by any instance, shared with the other instances that
+   load the same model */
+typedef struct SharedModel {
+    struct SharedModel *next;
+    uint32_t hash;
+    uint32_t size;
+    uint32_t ref_count;
+    char *buf;
+    std::unique_ptr<tflite::FlatBufferModel> model;
+#if WASM_ENABLE_WASI_NN_BATCHING != 0
+    Batcher batcher;
+#endif
+} SharedModel;
+
+static SharedModel *shared_models;
+static korp_mutex shared_models_lock;
+
+#if WASM_ENABLE_WASI_NN_ZERO_COPY != 0
+/* An input tensor allocated in the linear memory of the app instead of
+   being copied into the arena of the interpreter */
+typedef struct {
+    /* Whether set_input has given a range of the linear memory */
+    bool is_set;
+    uint32_t app_offset;
+    uint32_t size;
+    /* Buffer the tensor is allocated in, NULL for the arena */
+    void *bound;
+    /* Aligned buffer the range is copied to when it isn't aligned after
+       the tensor has been bound, as it can't go back to the arena */
+    void *copy_buf;
+    void *copy;
+} InputBinding;
+#endif
+
 typedef struct {
     std::unique_ptr<tflite::Interpreter> interpreter;
+    SharedModel *model;
+#if WASM_ENABLE_WASI_NN_ZERO_COPY != 0
+    std::vector<InputBinding> inputs;
+#endif
 } Interpreter;
 
 typedef struct {
-    char *model_pointer;
-    std::unique_ptr<tflite::FlatBufferModel> model;
+    SharedModel *model;
     execution_target target;
 } Model;
 
@@ -46,6 +113,9 @@ typedef struct {
     Interpreter interpreters[MAX_GRAPH_EXEC_CONTEXTS_PER_INST];
     korp_mutex g_lock;
     TfLiteDelegate *delegate;
+#if WASM_ENABLE_WASI_NN_ZERO_COPY != 0
+    wasm_module_inst_t instance;
+#endif
 } TFLiteContext;
 
 /* Utils */
@@ -85,17 +155,114 @@ is_valid_graph(TFLiteContext *tfl_ctx, graph g)
         NN_ERR_PRINTF("Invalid graph: %d >= %d.", g, MAX_GRAPHS_PER_INST);
         return runtime_error;
     }
-    if (tfl_ctx->models[g].model_pointer == NULL) {
-        NN_ERR_PRINTF("Context (model) non-initialized.");
-        return runtime_error;
-    }
     if (tfl_ctx->models[g].model == NULL) {
-        NN_ERR_PRINTF("Context (tflite model) non-initialized.");
+        NN_ERR_PRINTF("Context (model) non-initialized.");
         return runtime_error;
     }
     return success;
 }
 
+static uint32_t
+hash_model(const uint8_t *buf, uint32_t size)
+{
+    // fnv1a_hash
+    uint32_t hash = 2166136261U;
+    for (uint32_t i = 0; i < size; i++) {
+        hash ^= buf[i];
+        hash *= 16777619;
+    }
+    return hash;
+}
+
+/* Finds a model loaded with the same content or loads it */
+static SharedModel *
+acquire_shared_model(const uint8_t *buf, uint32_t size)
+{
+    uint32_t hash = hash_model(buf, size);
+    SharedModel *shared;
+
+    os_mutex_lock(&shared_models_lock);
+    for (shared = shared_models; shared; shared = shared->next) {
+        if (shared->hash == hash && shared->size == size
+            && memcmp(shared->buf, buf, size) == 0) {
+            shared->ref_count++;
+            os_mutex_unlock(&shared_models_lock);
+            NN_DBG_PRINTF("Sharing a loaded model.");
+            return shared;
+        }
+    }
+
+    /* The app may change its buffer, keep a copy of the model */
+    shared = new (std::nothrow) SharedModel();
+    if (shared == NULL || !(shared->buf = (char *)wasm_runtime_malloc(size))) {
+        NN_ERR_PRINTF("Error when allocating memory for model.");
+        goto fail;
+    }
+    bh_memcpy_s(shared->buf, size, buf, size);
+
+    shared->model =
+        tflite::FlatBufferModel::BuildFromBuffer(shared->buf, size, NULL);
+    if (shared->model == NULL) {
+        NN_ERR_PRINTF("Loading model error.");
+        goto fail;
+    }
+
+#if WASM_ENABLE_WASI_NN_BATCHING != 0
+    if (os_mutex_init(&shared->batcher.lock) != 0) {
+        NN_ERR_PRINTF("Error while initializing the lock");
+        goto fail;
+    }
+    if (os_cond_init(&shared->batcher.cond) != 0) {
+        NN_ERR_PRINTF("Error while initializing the condition");
+        os_mutex_destroy(&shared->batcher.lock);
+        goto fail;
+    }
+#endif
+
+    shared->hash = hash;
+    shared->size = size;
+    shared->ref_count = 1;
+    shared->next = shared_models;
+    shared_models = shared;
+    os_mutex_unlock(&shared_models_lock);
+    return shared;
+
+fail:
+    if (shared) {
+        shared->model.reset();
+        if (shared->buf)
+            wasm_runtime_free(shared->buf);
+        delete shared;
+    }
+    os_mutex_unlock(&shared_models_lock);
+    return NULL;
+}
+
+static void
+release_shared_model(SharedModel *shared)
+{
+    SharedModel **p;
+
+    os_mutex_lock(&shared_models_lock);
+    if (--shared->ref_count > 0) {
+        os_mutex_unlock(&shared_models_lock);
+        return;
+    }
+    for (p = &shared_models; *p != shared; p = &(*p)->next)
+        ;
+    *p = shared->next;
+    os_mutex_unlock(&shared_models_lock);
+
+#if WASM_ENABLE_WASI_NN_BATCHING != 0
+    shared->batcher.interpreter.reset();
+    os_cond_destroy(&shared->batcher.cond);
+    os_mutex_destroy(&shared->batcher.lock);
+#endif
+    shared->model.reset();
+    wasm_runtime_free(shared->buf);
+    delete shared;
+}
+
 static error
 is_valid_graph_execution_context(TFLiteContext *tfl_ctx,
                                  graph_execution_context ctx)
@@ -112,6 +279,249 @@ is_valid_graph_execution_context(TFLiteContext *tfl_ctx,
     return success;
 }
 
+#if WASM_ENABLE_WASI_NN_ZERO_COPY != 0
+/* Allocates the input tensors given by set_input in the linear memory.
+   The memory may have moved since set_input, so the ranges are resolved
+   again before every inference and the interpreter only has to replan
+   when an address changed. */
+static error
+bind_input_tensors(TFLiteContext *tfl_ctx, Interpreter *interp)
+{
+    const std::vector<int> &indices = interp->interpreter->inputs();
+    bool changed = false;
+
+    for (uint32_t i = 0; i < interp->inputs.size(); i++) {
+        InputBinding *binding = &interp->inputs[i];
+        if (!binding->is_set)
+            continue;
+
+        if (!wasm_runtime_validate_app_addr(
+                tfl_ctx->instance, binding->app_offset, binding->size)) {
+            NN_ERR_PRINTF("Input tensor %d is out of the linear memory", i);
+            return invalid_argument;
+        }
+        void *data = wasm_runtime_addr_app_to_native(tfl_ctx->instance,
+                                                     binding->app_offset);
+
+        if ((uintptr_t)data % tflite::kDefaultTensorAlignment != 0) {
+            if (binding->bound == NULL) {
+                bh_memcpy_s(interp->interpreter->typed_input_tensor<float>(i),
+                            binding->size, data, binding->size);
+                continue;
+            }
+            if (binding->copy == NULL) {
+                binding->copy_buf = wasm_runtime_malloc(
+                    binding->size + tflite::kDefaultTensorAlignment - 1);
+                if (binding->copy_buf == NULL) {
+                    NN_ERR_PRINTF("Error when allocating input tensor %d", i);
+                    return missing_memory;
+                }
+                uintptr_t align = tflite::kDefaultTensorAlignment;
+                binding->copy = (void *)(((uintptr_t)binding->copy_buf
+                                          + align - 1)
+                                         & ~(align - 1));
+            }
+            bh_memcpy_s(binding->copy, binding->size, data, binding->size);
+            data = binding->copy;
+        }
+
+        if (data != binding->bound) {
+            TfLiteCustomAllocation allocation = { data, binding->size };
+            if (interp->interpreter->SetCustomAllocationForTensor(
+                    indices[i], allocation)
+                != kTfLiteOk) {
+                NN_ERR_PRINTF("Error when binding input tensor %d", i);
+                return runtime_error;
+            }
+            binding->bound = data;
+            changed = true;
+        }
+    }
+
+    if (changed && interp->interpreter->AllocateTensors() != kTfLiteOk) {
+        NN_ERR_PRINTF("Error when allocating tensors");
+        return runtime_error;
+    }
+    return success;
+}
+#endif
+
+#if WASM_ENABLE_WASI_NN_BATCHING != 0
+/* Prepares the batch interpreter of a model for a number of requests,
+   fails if the tensors of the requests aren't slices of a batch */
+static bool
+resize_batch(SharedModel *shared, tflite::Interpreter *request,
+             uint32_t batch_size)
+{
+    Batcher *batcher = &shared->batcher;
+    tflite::Interpreter *interp;
+    size_t i;
+
+    if (batcher->interpreter == NULL) {
+        tflite::ops::builtin::BuiltinOpResolver resolver;
+        tflite::InterpreterBuilder tflite_builder(*shared->model, resolver);
+        if (tflite_builder(&batcher->interpreter) != kTfLiteOk
+            || batcher->interpreter == NULL)
+            return false;
+    }
+    if (batcher->batch_size == batch_size)
+        return true;
+
+    interp = batcher->interpreter.get();
+    batcher->batch_size = 0;
+    for (i = 0; i < interp->inputs().size(); i++) {
+        TfLiteTensor *tensor = request->input_tensor(i);
+        if (tensor->dims->size < 1 || tensor->dims->data[0] != 1)
+            return false;
+
+        std::vector<int> dims(tensor->dims->data,
+                              tensor->dims->data + tensor->dims->size);
+        dims[0] = (int)batch_size;
+        if (interp->ResizeInputTensor(interp->inputs()[i], dims) != kTfLiteOk)
+            return false;
+    }
+    if (interp->AllocateTensors() != kTfLiteOk)
+        return false;
+
+    for (i = 0; i < interp->inputs().size(); i++) {
+        if (interp->input_tensor(i)->bytes
+            != request->input_tensor(i)->bytes * batch_size)
+            return false;
+    }
+    for (i = 0; i < interp->outputs().size(); i++) {
+        TfLiteTensor *tensor = interp->output_tensor(i);
+        if (tensor->dims->size < 1 || tensor->dims->data[0] != (int)batch_size
+            || tensor->bytes != request->output_tensor(i)->bytes * batch_size)
+            return false;
+    }
+    batcher->batch_size = batch_size;
+    return true;
+}
+
+static void
+run_batch(SharedModel *shared, BatchRequest **requests, uint32_t count)
+{
+    Batcher *batcher = &shared->batcher;
+    tflite::Interpreter *interp;
+    error res;
+    size_t i;
+    uint32_t j;
+
+    /* Only the thread running the batch changes disabled */
+    if (count > 1 && !batcher->disabled
+        && !resize_batch(shared, requests[0]->interpreter, count)) {
+        NN_WARN_PRINTF("The model can't be batched, computing one by one.");
+        batcher->interpreter.reset();
+        os_mutex_lock(&batcher->lock);
+        batcher->disabled = true;
+        os_mutex_unlock(&batcher->lock);
+    }
+
+    if (count == 1 || batcher->disabled) {
+        for (j = 0; j < count; j++)
+            requests[j]->res =
+                requests[j]->interpreter->Invoke() == kTfLiteOk ? success
+                                                                : runtime_error;
+        return;
+    }
+
+    interp = batcher->interpreter.get();
+    for (i = 0; i < interp->inputs().size(); i++) {
+        TfLiteTensor *tensor = interp->input_tensor(i);
+        for (j = 0; j < count; j++) {
+            TfLiteTensor *slice = requests[j]->interpreter->input_tensor(i);
+            bh_memcpy_s(tensor->data.raw + slice->bytes * j,
+                        (uint32_t)slice->bytes, slice->data.raw,
+                        (uint32_t)slice->bytes);
+        }
+    }
+
+    res = interp->Invoke() == kTfLiteOk ? success : runtime_error;
+    if (res == success) {
+        for (i = 0; i < interp->outputs().size(); i++) {
+            TfLiteTensor *tensor = interp->output_tensor(i);
+            for (j = 0; j < count; j++) {
+                TfLiteTensor *slice =
+                    requests[j]->interpreter->output_tensor(i);
+                bh_memcpy_s(slice->data.raw, (uint32_t)slice->bytes,
+                            tensor->data.raw + slice->bytes * j,
+                            (uint32_t)slice->bytes);
+            }
+        }
+    }
+    for (j = 0; j < count; j++)
+        requests[j]->res = res;
+}
+
+/* Runs an inference in the next batch of its model. The first request
+   waits up to WASM_WASI_NN_BATCH_DELAY_US for the other execution
+   contexts to join and runs the batch, the others wait for it. */
+static error
+compute_batched(SharedModel *shared, tflite::Interpreter *interpreter)
+{
+    Batcher *batcher = &shared->batcher;
+    BatchRequest request = { interpreter, false, success };
+    BatchRequest *batch[WASM_WASI_NN_MAX_BATCH_SIZE];
+    uint32_t count, max_count, i;
+    uint64 deadline, now;
+
+    os_mutex_lock(&batcher->lock);
+    if (batcher->disabled || batcher->context_count < 2) {
+        os_mutex_unlock(&batcher->lock);
+        return interpreter->Invoke() == kTfLiteOk ? success : runtime_error;
+    }
+
+    while (batcher->pending_count == WASM_WASI_NN_MAX_BATCH_SIZE)
+        os_cond_wait(&batcher->cond, &batcher->lock);
+    batcher->pending[batcher->pending_count++] = &request;
+    os_cond_broadcast(&batcher->cond);
+
+    while (!request.done) {
+        if (batcher->running) {
+            os_cond_wait(&batcher->cond, &batcher->lock);
+            continue;
+        }
+
+        /* Lead the next batch, stop waiting once every execution
+           context that could join has joined. Don't wait if no other
+           compute is queued, e.g. a thread running several execution
+           contexts by itself, the computes which come meanwhile are
+           queued for the next batch */
+        batcher->running = true;
+        deadline =
+            os_time_get_boot_microsecond() + WASM_WASI_NN_BATCH_DELAY_US;
+        while (batcher->pending_count > 1) {
+            max_count = batcher->context_count < WASM_WASI_NN_MAX_BATCH_SIZE
+                            ? batcher->context_count
+                            : WASM_WASI_NN_MAX_BATCH_SIZE;
+            now = os_time_get_boot_microsecond();
+            if (batcher->pending_count >= max_count || now >= deadline)
+                break;
+            os_cond_reltimedwait(&batcher->cond, &batcher->lock,
+                                 deadline - now);
+        }
+
+        count = batcher->pending_count;
+        for (i = 0; i < count; i++)
+            batch[i] = batcher->pending[i];
+        batcher->pending_count = 0;
+        /* Let in the requests waiting for room */
+        os_cond_broadcast(&batcher->cond);
+        os_mutex_unlock(&batcher->lock);
+
+        run_batch(shared, batch, count);
+
+        os_mutex_lock(&batcher->lock);
+        for (i = 0; i < count; i++)
+            batch[i]->done = true;
+        batcher->running = false;
+        os_cond_broadcast(&batcher->cond);
+    }
+    os_mutex_unlock(&batcher->lock);
+    return request.res;
+}
+#endif
+
 /* WASI-NN (tensorflow) implementation */
 
 error
@@ -139,29 +549,11 @@ tensorflowlite_load(void *tflite_ctx, graph_builder_array *builder,
     if (success != (res = initialize_g(tfl_ctx, g)))
         return res;
 
-    uint32_t size = builder->buf[0].size;
-
-    // Save model
-    tfl_ctx->models[*g].model_pointer = (char *)wasm_runtime_malloc(size);
-    if (tfl_ctx->models[*g].model_pointer == NULL) {
-        NN_ERR_PRINTF("Error when allocating memory for model.");
-        return missing_memory;
-    }
-
-    bh_memcpy_s(tfl_ctx->models[*g].model_pointer, size, builder->buf[0].buf,
-                size);
-
-    // Save model flatbuffer
+    // Save model, shared with the other instances that load it
     tfl_ctx->models[*g].model =
-        std::move(tflite::FlatBufferModel::BuildFromBuffer(
-            tfl_ctx->models[*g].model_pointer, size, NULL));
-
-    if (tfl_ctx->models[*g].model == NULL) {
-        NN_ERR_PRINTF("Loading model error.");
-        wasm_runtime_free(tfl_ctx->models[*g].model_pointer);
-        tfl_ctx->models[*g].model_pointer = NULL;
+        acquire_shared_model(builder->buf[0].buf, builder->buf[0].size);
+    if (tfl_ctx->models[*g].model == NULL)
         return missing_memory;
-    }
 
     // Save target
     tfl_ctx->models[*g].target = target;
@@ -183,13 +575,19 @@ tensorflowlite_init_execution_context(void *tflite_ctx, graph g,
 
     // Build the interpreter with the InterpreterBuilder.
     tflite::ops::builtin::BuiltinOpResolver resolver;
-    tflite::InterpreterBuilder tflite_builder(*tfl_ctx->models[g].model,
-                                              resolver);
+    tflite::InterpreterBuilder tflite_builder(
+        *tfl_ctx->models[g].model->model, resolver);
     tflite_builder(&tfl_ctx->interpreters[*ctx].interpreter);
     if (tfl_ctx->interpreters[*ctx].interpreter == NULL) {
         NN_ERR_PRINTF("Error when generating the interpreter.");
         return missing_memory;
     }
+    tfl_ctx->interpreters[*ctx].model = tfl_ctx->models[g].model;
+#if WASM_ENABLE_WASI_NN_BATCHING != 0
+    os_mutex_lock(&tfl_ctx->models[g].model->batcher.lock);
+    tfl_ctx->models[g].model->batcher.context_count++;
+    os_mutex_unlock(&tfl_ctx->models[g].model->batcher.lock);
+#endif
 
     bool use_default = false;
     switch (tfl_ctx->models[g].target) {
@@ -310,6 +708,28 @@ tensorflowlite_set_input(void *tflite_ctx, graph_execution_context ctx,
         return invalid_argument;
     }
 
+#if WASM_ENABLE_WASI_NN_ZERO_COPY != 0
+    /* Only float tensors are bound, the app changing them during the
+       inference can't make the kernels index out of bounds. With a
+       delegate the inputs are copied to the device anyway, but a tensor
+       bound before the delegate was created must stay bound. */
+    std::vector<InputBinding> &inputs = tfl_ctx->interpreters[ctx].inputs;
+    if ((index < inputs.size() && inputs[index].bound != NULL)
+        || (tensor->quantization.type == kTfLiteNoQuantization
+            && tensor->type == kTfLiteFloat32 && tfl_ctx->delegate == NULL)) {
+        if (inputs.size() < num_tensors)
+            inputs.resize(num_tensors, InputBinding());
+
+        /* Read during compute rather than now */
+        inputs[index].is_set = true;
+        inputs[index].app_offset =
+            wasm_runtime_addr_native_to_app(tfl_ctx->instance,
+                                            input_tensor->data);
+        inputs[index].size = model_tensor_size * sizeof(float);
+        return success;
+    }
+#endif
+
     if (tensor->quantization.type == kTfLiteNoQuantization) {
         NN_DBG_PRINTF("No quantization information. Using float as default");
         float *it =
@@ -353,6 +773,19 @@ tensorflowlite_compute(void *tflite_ctx, graph_execution_context ctx)
     if (success != (res = is_valid_graph_execution_context(tfl_ctx, ctx)))
         return res;
 
+#if WASM_ENABLE_WASI_NN_ZERO_COPY != 0
+    if (success
+        != (res = bind_input_tensors(tfl_ctx, &tfl_ctx->interpreters[ctx])))
+        return res;
+#endif
+
+#if WASM_ENABLE_WASI_NN_BATCHING != 0
+    /* A delegate runs the interpreter of the context on its device */
+    if (tfl_ctx->delegate == NULL)
+        return compute_batched(tfl_ctx->interpreters[ctx].model,
+                               tfl_ctx->interpreters[ctx].interpreter.get());
+#endif
+
     tfl_ctx->interpreters[ctx].interpreter->Invoke();
     return success;
 }
@@ -426,8 +859,23 @@ tensorflowlite_get_output(void *tflite_ctx, graph_execution_context ctx,
     return success;
 }
 
+bool
+tensorflowlite_startup(void)
+{
+    static bool started = false;
+
+    if (!started) {
+        if (os_mutex_init(&shared_models_lock) != 0) {
+            NN_ERR_PRINTF("Error while initializing the lock");
+            return false;
+        }
+        started = true;
+    }
+    return true;
+}
+
 void
-tensorflowlite_initialize(void **tflite_ctx)
+tensorflowlite_initialize(void **tflite_ctx, wasm_module_inst_t instance)
 {
     TFLiteContext *tfl_ctx = new TFLiteContext();
     if (tfl_ctx == NULL) {
@@ -438,7 +886,7 @@ tensorflowlite_initialize(void **tflite_ctx)
     NN_DBG_PRINTF("Initializing models.");
     tfl_ctx->current_models = 0;
     for (int i = 0; i < MAX_GRAPHS_PER_INST; ++i) {
-        tfl_ctx->models[i].model_pointer = NULL;
+        tfl_ctx->models[i].model = NULL;
     }
     NN_DBG_PRINTF("Initializing interpreters.");
     tfl_ctx->current_interpreters = 0;
@@ -448,6 +896,11 @@ tensorflowlite_initialize(void **tflite_ctx)
     }
 
     tfl_ctx->delegate = NULL;
+#if WASM_ENABLE_WASI_NN_ZERO_COPY != 0
+    tfl_ctx->instance = instance;
+#else
+    (void)instance;
+#endif
 
     *tflite_ctx = (void *)tfl_ctx;
 }
@@ -472,9 +925,26 @@ tensorflowlite_destroy(void *tflite_ctx)
     }
 
     NN_DBG_PRINTF("Freeing memory.");
+    // The interpreters refer to the models
+    for (int i = 0; i < MAX_GRAPH_EXEC_CONTEXTS_PER_INST; ++i) {
+#if WASM_ENABLE_WASI_NN_BATCHING != 0
+        SharedModel *shared = tfl_ctx->interpreters[i].model;
+        if (shared) {
+            os_mutex_lock(&shared->batcher.lock);
+            shared->batcher.context_count--;
+            os_mutex_unlock(&shared->batcher.lock);
+        }
+#endif
+        tfl_ctx->interpreters[i].interpreter.reset();
+#if WASM_ENABLE_WASI_NN_ZERO_COPY != 0
+        for (InputBinding &binding : tfl_ctx->interpreters[i].inputs) {
+            if (binding.copy_buf)
+                wasm_runtime_free(binding.copy_buf);
+        }
+#endif
+    }
     for (int i = 0; i < MAX_GRAPHS_PER_INST; ++i) {
-        tfl_ctx->models[i].model.reset();
-        if (tfl_ctx->models[i].model_pointer) {
+        if (tfl_ctx->models[i].model) {
             if (tfl_ctx->delegate) {
                 switch (tfl_ctx->models[i].target) {
                     case gpu:
@@ -498,12 +968,9 @@ tensorflowlite_destroy(void *tflite_ctx)
                     }
                 }
             }
-            wasm_runtime_free(tfl_ctx->models[i].model_pointer);
+            release_shared_model(tfl_ctx->models[i].model);
         }
-        tfl_ctx->models[i].model_pointer = NULL;
-    }
-    for (int i = 0; i < MAX_GRAPH_EXEC_CONTEXTS_PER_INST; ++i) {
-        tfl_ctx->interpreters[i].interpreter.reset();
+        tfl_ctx->models[i].model = NULL;
     }
     os_mutex_destroy(&tfl_ctx->g_lock);
     delete tfl_ctx;
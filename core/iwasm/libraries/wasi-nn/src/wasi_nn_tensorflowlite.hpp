@@ -7,6 +7,7 @@
 #define WASI_NN_TENSORFLOWLITE_HPP
 
 #include "wasi_nn.h"
+#include "wasm_export.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,8 +33,11 @@ tensorflowlite_get_output(void *tflite_ctx, graph_execution_context ctx,
                           uint32_t index, tensor_data output_tensor,
                           uint32_t *output_tensor_size);
 
+bool
+tensorflowlite_startup(void);
+
 void
-tensorflowlite_initialize(void **tflite_ctx);
+tensorflowlite_initialize(void **tflite_ctx, wasm_module_inst_t instance);
 
 void
 tensorflowlite_destroy(void *tflite_ctx);
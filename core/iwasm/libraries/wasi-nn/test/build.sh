@@ -23,6 +23,32 @@ python3 max.py
 python3 mult_dimension.py
 python3 mult_outputs.py
 python3 sum.py
+python3 image.py
+
+# Latency benchmark
+
+cd ${CURR_PATH}
+/opt/wasi-sdk/bin/clang \
+    -Wl,--allow-undefined \
+    -Wl,--strip-all,--no-entry \
+    --sysroot=/opt/wasi-sdk/share/wasi-sysroot \
+    -I../include -I../src/utils \
+    -o test_latency.wasm \
+    test_latency.c utils.c
+
+# Throughput benchmark, one instance per thread
+
+cd ${CURR_PATH}
+/opt/wasi-sdk/bin/clang \
+    --target=wasm32-wasi-threads -pthread \
+    -Wl,--allow-undefined \
+    -Wl,--import-memory,--export-memory,--shared-memory \
+    -Wl,--max-memory=1073741824 \
+    -Wl,--strip-all \
+    --sysroot=/opt/wasi-sdk/share/wasi-sysroot \
+    -I../include -I../src/utils \
+    -o test_throughput.wasm \
+    test_throughput.c utils.c
 
 # Specific tests for TPU
 
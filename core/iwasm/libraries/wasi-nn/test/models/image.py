@@ -0,0 +1,19 @@
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+import tensorflow as tf
+from utils import save_model
+
+# A small network on an image sized input, so that the cost of passing the
+# tensors between the app and the runtime shows next to the compute
+
+model = tf.keras.Sequential([
+    tf.keras.layers.InputLayer(input_shape=[224, 224, 3]),
+    tf.keras.layers.Conv2D(8, (3, 3), strides=(4, 4), activation="relu"),
+    tf.keras.layers.GlobalAveragePooling2D(),
+    tf.keras.layers.Dense(10)
+])
+
+# Export model to tflite
+
+save_model(model, "image.tflite")
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/*
+ * Measure the latency of an inference on an image sized input, including
+ * passing the input and output tensors between the app and the runtime.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "utils.h"
+#include "logger.h"
+
+#define ITERATIONS 1000
+/* The runtime may bind aligned input tensors instead of copying them */
+#define TENSOR_ALIGNMENT 64
+
+static uint64_t
+now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+int
+main()
+{
+    uint32_t dims[] = { 1, 224, 224, 3 };
+    uint32_t elements = 224 * 224 * 3;
+    uint32_t output_size;
+    uint64_t start, elapsed, min = UINT64_MAX, total = 0;
+    execution_target target = cpu;
+    graph_execution_context ctx;
+    graph graph;
+    float *input, output[10];
+    char *env = getenv("TARGET");
+
+    if (env != NULL && strcmp(env, "gpu") == 0)
+        target = gpu;
+
+    input = aligned_alloc(TENSOR_ALIGNMENT, elements * sizeof(float));
+    if (input == NULL) {
+        NN_ERR_PRINTF("Error when allocating the input tensor.");
+        return 1;
+    }
+    for (uint32_t i = 0; i < elements; i++)
+        input[i] = (float)(i % 256) / 255;
+
+    if (wasm_load("./models/image.tflite", &graph, target) != success
+        || wasm_init_execution_context(graph, &ctx) != success) {
+        NN_ERR_PRINTF("Error when loading model.");
+        return 1;
+    }
+
+    for (int i = 0; i < ITERATIONS; i++) {
+        start = now_us();
+        output_size = sizeof(output) / sizeof(float);
+        if (wasm_set_input(ctx, input, dims) != success
+            || wasm_compute(ctx) != success
+            || wasm_get_output(ctx, 0, output, &output_size) != success) {
+            NN_ERR_PRINTF("Error when running inference.");
+            return 1;
+        }
+        elapsed = now_us() - start;
+
+        total += elapsed;
+        if (elapsed < min)
+            min = elapsed;
+    }
+
+    printf("%d inferences: average %llu us, min %llu us\n", ITERATIONS,
+           (unsigned long long)(total / ITERATIONS), (unsigned long long)min);
+
+    free(input);
+    return 0;
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/*
+ * Measure the throughput and the tail latency of inferences run by several
+ * threads at the same time. Each thread of a wasi-threads app runs in its
+ * own instance, so the runtime sees concurrent clients of the same model.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "utils.h"
+#include "logger.h"
+
+#define ITERATIONS 200
+#define MAX_THREADS 32
+
+typedef struct {
+    pthread_t tid;
+    execution_target target;
+    uint64_t latencies[ITERATIONS];
+    int failed;
+} Client;
+
+static uint64_t
+now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static int
+compare_latency(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void *
+client(void *arg)
+{
+    Client *c = (Client *)arg;
+    uint32_t dims[] = { 1, 224, 224, 3 };
+    uint32_t elements = 224 * 224 * 3;
+    uint32_t output_size;
+    graph_execution_context ctx;
+    graph graph;
+    float *input, output[10];
+    uint64_t start;
+
+    c->failed = 1;
+    if (!(input = malloc(elements * sizeof(float)))) {
+        NN_ERR_PRINTF("Error when allocating the input tensor.");
+        return NULL;
+    }
+    for (uint32_t i = 0; i < elements; i++)
+        input[i] = (float)(i % 256) / 255;
+
+    if (wasm_load("./models/image.tflite", &graph, c->target) != success
+        || wasm_init_execution_context(graph, &ctx) != success) {
+        NN_ERR_PRINTF("Error when loading model.");
+        goto fail;
+    }
+
+    for (int i = 0; i < ITERATIONS; i++) {
+        start = now_us();
+        output_size = sizeof(output) / sizeof(float);
+        if (wasm_set_input(ctx, input, dims) != success
+            || wasm_compute(ctx) != success
+            || wasm_get_output(ctx, 0, output, &output_size) != success) {
+            NN_ERR_PRINTF("Error when running inference.");
+            goto fail;
+        }
+        c->latencies[i] = now_us() - start;
+    }
+    c->failed = 0;
+
+fail:
+    free(input);
+    return NULL;
+}
+
+int
+main(int argc, char **argv)
+{
+    static Client clients[MAX_THREADS];
+    static uint64_t latencies[MAX_THREADS * ITERATIONS];
+    int thread_num = argc > 1 ? atoi(argv[1]) : 4;
+    execution_target target = cpu;
+    char *env = getenv("TARGET");
+    uint64_t start, elapsed;
+    int i, count = 0;
+
+    if (thread_num < 1 || thread_num > MAX_THREADS) {
+        printf("Usage: %s [threads (1-%d)]\n", argv[0], MAX_THREADS);
+        return 1;
+    }
+    if (env != NULL && strcmp(env, "gpu") == 0)
+        target = gpu;
+
+    start = now_us();
+    for (i = 0; i < thread_num; i++) {
+        clients[i].target = target;
+        if (pthread_create(&clients[i].tid, NULL, client, &clients[i]) != 0) {
+            NN_ERR_PRINTF("Error when creating thread %d.", i);
+            return 1;
+        }
+    }
+    for (i = 0; i < thread_num; i++)
+        pthread_join(clients[i].tid, NULL);
+    elapsed = now_us() - start;
+
+    for (i = 0; i < thread_num; i++) {
+        if (clients[i].failed)
+            return 1;
+        memcpy(latencies + count, clients[i].latencies,
+               sizeof(clients[i].latencies));
+        count += ITERATIONS;
+    }
+    qsort(latencies, count, sizeof(uint64_t), compare_latency);
+
+    printf("%d threads, %d inferences: %.1f inferences/s, p50 %llu us, "
+           "p99 %llu us\n",
+           thread_num, count, (double)count * 1000000 / elapsed,
+           (unsigned long long)latencies[count / 2],
+           (unsigned long long)latencies[count * 99 / 100]);
+    return 0;
+}
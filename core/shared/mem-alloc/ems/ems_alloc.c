@@ -12,6 +12,111 @@ hmu_is_in_heap(void *hmu, gc_uint8 *heap_base_addr, gc_uint8 *heap_end_addr)
     return (addr >= heap_base_addr && addr < heap_end_addr) ? true : false;
 }
 
+static inline gc_uint32
+tree_node_height(hmu_tree_node_t *node)
+{
+    return node ? node->height : 0;
+}
+
+static void
+update_tree_node_height(hmu_tree_node_t *node)
+{
+    gc_uint32 left_height = tree_node_height(node->left);
+    gc_uint32 right_height = tree_node_height(node->right);
+
+    node->height = (left_height > right_height ? left_height : right_height) + 1;
+}
+
+/* Make @new take the place of @old as a child of @parent */
+static bool
+replace_tree_child(hmu_tree_node_t *parent, hmu_tree_node_t *old,
+                   hmu_tree_node_t *new)
+{
+    if (old == parent->right)
+        parent->right = new;
+    else if (old == parent->left)
+        parent->left = new;
+    else
+        return false;
+    return true;
+}
+
+/* Rotate the subtree of @p to the left, return the new subtree root */
+static hmu_tree_node_t *
+rotate_tree_left(hmu_tree_node_t *p)
+{
+    hmu_tree_node_t *q = p->right;
+
+    replace_tree_child(p->parent, p, q);
+    q->parent = p->parent;
+
+    p->right = q->left;
+    if (q->left)
+        q->left->parent = p;
+    q->left = p;
+    p->parent = q;
+
+    update_tree_node_height(p);
+    update_tree_node_height(q);
+    return q;
+}
+
+/* Rotate the subtree of @p to the right, return the new subtree root */
+static hmu_tree_node_t *
+rotate_tree_right(hmu_tree_node_t *p)
+{
+    hmu_tree_node_t *q = p->left;
+
+    replace_tree_child(p->parent, p, q);
+    q->parent = p->parent;
+
+    p->left = q->right;
+    if (q->right)
+        q->right->parent = p;
+    q->right = p;
+    p->parent = q;
+
+    update_tree_node_height(p);
+    update_tree_node_height(q);
+    return q;
+}
+
+/**
+ * Restore the AVL balance of the tree after a node was linked or unlinked
+ *
+ * @param root the ROOT node of the tree, which is the parent of the top
+ *        node and isn't balanced itself
+ * @param p the deepest node whose subtree was changed
+ */
+static void
+rebalance_tree(hmu_tree_node_t *root, hmu_tree_node_t *p)
+{
+    gc_uint32 left_height, right_height;
+
+    while (p != root) {
+        left_height = tree_node_height(p->left);
+        right_height = tree_node_height(p->right);
+
+        if (left_height > right_height + 1) {
+            if (tree_node_height(p->left->left)
+                < tree_node_height(p->left->right))
+                rotate_tree_left(p->left);
+            p = rotate_tree_right(p);
+        }
+        else if (right_height > left_height + 1) {
+            if (tree_node_height(p->right->right)
+                < tree_node_height(p->right->left))
+                rotate_tree_right(p->right);
+            p = rotate_tree_left(p);
+        }
+        else {
+            update_tree_node_height(p);
+        }
+
+        p = p->parent;
+    }
+}
+
 /**
  * Remove a node from the tree it belongs to
  *
@@ -19,22 +124,22 @@ hmu_is_in_heap(void *hmu, gc_uint8 *heap_base_addr, gc_uint8 *heap_end_addr)
  *        the node will be removed from the tree, and the left, right and
  *        parent pointers of the node @p will be set to be NULL. Other fields
  *        won't be touched. The tree will be re-organized so that the order
- *        conditions are still satisified.
+ *        conditions are still satisified and it is balanced again.
  */
 static bool
 remove_tree_node(gc_heap_t *heap, hmu_tree_node_t *p)
 {
-    hmu_tree_node_t *q = NULL, **slot = NULL;
+    hmu_tree_node_t *q = NULL, *child, *parent, *changed;
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
-    hmu_tree_node_t *root = heap->kfc_tree_root, *parent;
+    hmu_tree_node_t *root = heap->kfc_tree_root;
     gc_uint8 *base_addr = heap->base_addr;
     gc_uint8 *end_addr = base_addr + heap->current_size;
 #endif
 
     bh_assert(p);
 
-#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
     parent = p->parent;
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
     if (!parent || p == root /* p can not be the ROOT node */
         || !hmu_is_in_heap(p, base_addr, end_addr)
         || (parent != root && !hmu_is_in_heap(parent, base_addr, end_addr))) {
@@ -42,105 +147,79 @@ remove_tree_node(gc_heap_t *heap, hmu_tree_node_t *p)
     }
 #endif
 
-    /* get the slot which holds pointer to node p */
-    if (p == p->parent->right) {
-        /* Don't use `slot = &p->parent->right` to avoid compiler warning */
-        slot = (hmu_tree_node_t **)((uint8 *)p->parent
-                                    + offsetof(hmu_tree_node_t, right));
-    }
-    else if (p == p->parent->left) {
-        /* p should be a child of its parent */
-        /* Don't use `slot = &p->parent->left` to avoid compiler warning */
-        slot = (hmu_tree_node_t **)((uint8 *)p->parent
-                                    + offsetof(hmu_tree_node_t, left));
-    }
-    else {
-        goto fail;
-    }
-
     /**
      * algorithms used to remove node p
-     * case 1: if p has no left child, replace p with its right child
-     * case 2: if p has no right child, replace p with its left child
-     * case 3: otherwise, find p's predecessor, remove it from the tree
+     * case 1: if p has at most one child, replace p with the child
+     * case 2: otherwise, find p's predecessor, unlink it from its place
      *         and replace p with it.
      * use predecessor can keep the left <= root < right condition.
+     * then rebalance the tree from the deepest node whose subtree changed.
      */
 
-    if (!p->left) {
-        /* move right child up*/
-        *slot = p->right;
-        if (p->right) {
+    if (!p->left || !p->right) {
+        child = p->left ? p->left : p->right;
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
-            if (!hmu_is_in_heap(p->right, base_addr, end_addr)) {
-                goto fail;
-            }
-#endif
-            p->right->parent = p->parent;
+        if (child && !hmu_is_in_heap(child, base_addr, end_addr)) {
+            goto fail;
         }
-
-        p->left = p->right = p->parent = NULL;
-        return true;
+#endif
+        /* p should be a child of its parent */
+        if (!replace_tree_child(parent, p, child))
+            goto fail;
+        if (child)
+            child->parent = parent;
+        changed = parent;
     }
-
-    if (!p->right) {
-        /* move left child up*/
-        *slot = p->left;
+    else {
+        /* both left & right exist, find p's predecessor at first*/
+        q = p->left;
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
-        if (!hmu_is_in_heap(p->left, base_addr, end_addr)) {
+        if (!hmu_is_in_heap(q, base_addr, end_addr)
+            || !hmu_is_in_heap(p->right, base_addr, end_addr)) {
             goto fail;
         }
 #endif
-        /* p->left can never be NULL unless it is corrupted. */
-        p->left->parent = p->parent;
-
-        p->left = p->right = p->parent = NULL;
-        return true;
-    }
-
-    /* both left & right exist, find p's predecessor at first*/
-    q = p->left;
+        while (q->right) {
+            q = q->right;
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
-    if (!hmu_is_in_heap(q, base_addr, end_addr)) {
-        goto fail;
-    }
+            if (!hmu_is_in_heap(q, base_addr, end_addr)) {
+                goto fail;
+            }
 #endif
-    while (q->right) {
-        q = q->right;
-#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
-        if (!hmu_is_in_heap(q, base_addr, end_addr)) {
-            goto fail;
         }
-#endif
-    }
-
-    /* remove from the tree*/
-    if (!remove_tree_node(heap, q))
-        return false;
 
-    *slot = q;
-    q->parent = p->parent;
-    q->left = p->left;
-    q->right = p->right;
-    if (q->left) {
-#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
-        if (!hmu_is_in_heap(q->left, base_addr, end_addr)) {
+        if (!replace_tree_child(parent, p, q))
             goto fail;
+
+        if (q->parent == p) {
+            /* q is p's left child and keeps its left subtree */
+            changed = q;
         }
-#endif
-        q->left->parent = q;
-    }
-    if (q->right) {
+        else {
+            /* move q's left child up to q's place */
+            changed = q->parent;
+            changed->right = q->left;
+            if (q->left) {
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
-        if (!hmu_is_in_heap(q->right, base_addr, end_addr)) {
-            goto fail;
-        }
+                if (!hmu_is_in_heap(q->left, base_addr, end_addr)) {
+                    goto fail;
+                }
 #endif
+                q->left->parent = changed;
+            }
+            q->left = p->left;
+            q->left->parent = q;
+        }
+
+        q->right = p->right;
         q->right->parent = q;
+        q->parent = parent;
+        q->height = p->height;
     }
 
     p->left = p->right = p->parent = NULL;
 
+    rebalance_tree(heap->kfc_tree_root, changed);
     return true;
 fail:
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
@@ -149,6 +228,40 @@ fail:
     return false;
 }
 
+static inline void
+set_normal_list_bit(gc_heap_t *heap, uint32 node_idx)
+{
+    heap->kfc_normal_bitmap[node_idx >> 5] |= (gc_uint32)1 << (node_idx & 31);
+}
+
+static inline void
+clear_normal_list_bit(gc_heap_t *heap, uint32 node_idx)
+{
+    heap->kfc_normal_bitmap[node_idx >> 5] &=
+        ~((gc_uint32)1 << (node_idx & 31));
+}
+
+/**
+ * Find the first non-empty normal list from @node_idx
+ *
+ * @return the index of the list, HMU_NORMAL_NODE_CNT if not found
+ */
+static inline uint32
+find_normal_list(gc_heap_t *heap, uint32 node_idx)
+{
+    uint32 word_idx = node_idx >> 5;
+    gc_uint32 bits =
+        heap->kfc_normal_bitmap[word_idx] & ((gc_uint32)~0 << (node_idx & 31));
+
+    while (!bits) {
+        if (++word_idx >= HMU_NORMAL_BITMAP_CNT)
+            return HMU_NORMAL_NODE_CNT;
+        bits = heap->kfc_normal_bitmap[word_idx];
+    }
+
+    return (word_idx << 5) + gc_ctz32(bits);
+}
+
 static bool
 unlink_hmu(gc_heap_t *heap, hmu_t *hmu)
 {
@@ -176,31 +289,33 @@ unlink_hmu(gc_heap_t *heap, hmu_t *hmu)
 
     if (HMU_IS_FC_NORMAL(size)) {
         uint32 node_idx = size >> 3;
-        hmu_normal_node_t *node_prev = NULL, *node_next;
-        hmu_normal_node_t *node = heap->kfc_normal_list[node_idx].next;
+        hmu_normal_node_t *node = (hmu_normal_node_t *)hmu;
+        hmu_normal_node_t *node_prev = get_hmu_normal_node_prev(node);
+        hmu_normal_node_t *node_next = get_hmu_normal_node_next(node);
 
-        while (node) {
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
-            if (!hmu_is_in_heap(node, base_addr, end_addr)) {
-                heap->is_heap_corrupted = true;
-                return false;
-            }
+        if ((node_prev && !hmu_is_in_heap(node_prev, base_addr, end_addr))
+            || (node_next && !hmu_is_in_heap(node_next, base_addr, end_addr))) {
+            heap->is_heap_corrupted = true;
+            return false;
+        }
 #endif
-            node_next = get_hmu_normal_node_next(node);
-            if ((hmu_t *)node == hmu) {
-                if (!node_prev) /* list head */
-                    heap->kfc_normal_list[node_idx].next = node_next;
-                else
-                    set_hmu_normal_node_next(node_prev, node_next);
-                break;
+
+        if (!node_prev) { /* list head */
+            if (heap->kfc_normal_list[node_idx].next != node) {
+                os_printf(
+                    "[GC_ERROR]couldn't find the node in the normal list\n");
+                return true;
             }
-            node_prev = node;
-            node = node_next;
+            heap->kfc_normal_list[node_idx].next = node_next;
+            if (!node_next)
+                clear_normal_list_bit(heap, node_idx);
         }
+        else
+            set_hmu_normal_node_next(node_prev, node_next);
 
-        if (!node) {
-            os_printf("[GC_ERROR]couldn't find the node in the normal list\n");
-        }
+        if (node_next)
+            set_hmu_normal_node_prev(node_next, node_prev);
     }
     else {
         if (!remove_tree_node(heap, (hmu_tree_node_t *)hmu))
@@ -267,13 +382,18 @@ gci_add_fc(gc_heap_t *heap, hmu_t *hmu, gc_size_t size)
 
         node_idx = size >> 3;
         set_hmu_normal_node_next(np, heap->kfc_normal_list[node_idx].next);
+        set_hmu_normal_node_prev(np, NULL);
+        if (heap->kfc_normal_list[node_idx].next)
+            set_hmu_normal_node_prev(heap->kfc_normal_list[node_idx].next, np);
         heap->kfc_normal_list[node_idx].next = np;
+        set_normal_list_bit(heap, node_idx);
         return true;
     }
 
     /* big block */
     node = (hmu_tree_node_t *)hmu;
     node->size = size;
+    node->height = 1;
     node->left = node->right = node->parent = NULL;
 
     /* find proper node to link this new node to */
@@ -304,6 +424,8 @@ gci_add_fc(gc_heap_t *heap, hmu_t *hmu, gc_size_t size)
         }
 #endif
     }
+
+    rebalance_tree(root, node->parent);
     return true;
 }
 
@@ -342,13 +464,9 @@ alloc_hmu(gc_heap_t *heap, gc_size_t size)
     if (HMU_IS_FC_NORMAL(size)) {
         /* find a non-empty slot in normal_node_list with good size*/
         init_node_idx = (size >> 3);
-        for (node_idx = init_node_idx; node_idx < HMU_NORMAL_NODE_CNT;
-             node_idx++) {
+        node_idx = find_normal_list(heap, init_node_idx);
+        if (node_idx < HMU_NORMAL_NODE_CNT)
             normal_head = heap->kfc_normal_list + node_idx;
-            if (normal_head->next)
-                break;
-            normal_head = NULL;
-        }
 
         /* found in normal list*/
         if (normal_head) {
@@ -362,6 +480,17 @@ alloc_hmu(gc_heap_t *heap, gc_size_t size)
             }
 #endif
             normal_head->next = get_hmu_normal_node_next(p);
+            if (normal_head->next) {
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+                if (!hmu_is_in_heap(normal_head->next, base_addr, end_addr)) {
+                    heap->is_heap_corrupted = true;
+                    return NULL;
+                }
+#endif
+                set_hmu_normal_node_prev(normal_head->next, NULL);
+            }
+            else
+                clear_normal_list_bit(heap, node_idx);
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
             if (((gc_int32)(uintptr_t)hmu_to_obj(p) & 7) != 0) {
                 heap->is_heap_corrupted = true;
@@ -670,6 +799,65 @@ gci_is_heap_valid(gc_heap_t *heap)
     return GC_TRUE;
 }
 
+/**
+ * Free a VO heap unit and merge it with its free neighbours, the heap
+ * lock must be held by the caller
+ */
+static int
+free_vo_hmu(gc_heap_t *heap, hmu_t *hmu)
+{
+    gc_uint8 *base_addr = heap->base_addr;
+    gc_uint8 *end_addr = base_addr + heap->current_size;
+    hmu_t *prev = NULL;
+    hmu_t *next = NULL;
+    gc_size_t size = 0;
+
+    if (hmu_get_ut(hmu) != HMU_VO)
+        return GC_ERROR;
+
+    if (hmu_is_vo_freed(hmu)) {
+        bh_assert(0);
+        return GC_ERROR;
+    }
+
+    size = hmu_get_size(hmu);
+
+    g_total_free += size;
+
+    heap->total_free_size += size;
+
+    if (!hmu_get_pinuse(hmu)) {
+        prev = (hmu_t *)((char *)hmu - *((int *)hmu - 1));
+
+        if (hmu_is_in_heap(prev, base_addr, end_addr)
+            && hmu_get_ut(prev) == HMU_FC) {
+            size += hmu_get_size(prev);
+            hmu = prev;
+            if (!unlink_hmu(heap, prev))
+                return GC_ERROR;
+        }
+    }
+
+    next = (hmu_t *)((char *)hmu + size);
+    if (hmu_is_in_heap(next, base_addr, end_addr)) {
+        if (hmu_get_ut(next) == HMU_FC) {
+            size += hmu_get_size(next);
+            if (!unlink_hmu(heap, next))
+                return GC_ERROR;
+            next = (hmu_t *)((char *)hmu + size);
+        }
+    }
+
+    if (!gci_add_fc(heap, hmu, size))
+        return GC_ERROR;
+
+    if (hmu_is_in_heap(next, base_addr, end_addr)) {
+        hmu_unmark_pinuse(next);
+    }
+
+    return GC_SUCCESS;
+}
+
 #if BH_ENABLE_GC_VERIFY == 0
 int
 gc_free_vo(void *vheap, gc_object_t obj)
@@ -681,10 +869,6 @@ gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
     gc_heap_t *heap = (gc_heap_t *)vheap;
     gc_uint8 *base_addr, *end_addr;
     hmu_t *hmu = NULL;
-    hmu_t *prev = NULL;
-    hmu_t *next = NULL;
-    gc_size_t size = 0;
-    hmu_type_t ut;
     int ret = GC_SUCCESS;
 
     if (!obj) {
@@ -709,68 +893,137 @@ gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
 #if BH_ENABLE_GC_VERIFY != 0
         hmu_verify(heap, hmu);
 #endif
-        ut = hmu_get_ut(hmu);
-        if (ut == HMU_VO) {
-            if (hmu_is_vo_freed(hmu)) {
-                bh_assert(0);
-                ret = GC_ERROR;
-                goto out;
-            }
+        ret = free_vo_hmu(heap, hmu);
+    }
 
-            size = hmu_get_size(hmu);
+    os_mutex_unlock(&heap->lock);
+    return ret;
+}
 
-            g_total_free += size;
+gc_size_t
+gc_get_unit_size(gc_size_t size)
+{
+    gc_size_t tot_size = GC_ALIGN_8(OBJ_EXTRA_SIZE + size);
 
-            heap->total_free_size += size;
+    if (tot_size < size)
+        /* integer overflow */
+        return 0;
 
-            if (!hmu_get_pinuse(hmu)) {
-                prev = (hmu_t *)((char *)hmu - *((int *)hmu - 1));
+    return tot_size < GC_SMALLEST_SIZE ? GC_SMALLEST_SIZE : tot_size;
+}
 
-                if (hmu_is_in_heap(prev, base_addr, end_addr)
-                    && hmu_get_ut(prev) == HMU_FC) {
-                    size += hmu_get_size(prev);
-                    hmu = prev;
-                    if (!unlink_hmu(heap, prev)) {
-                        ret = GC_ERROR;
-                        goto out;
-                    }
-                }
-            }
+gc_size_t
+gc_get_obj_unit_size(void *vheap, gc_object_t obj)
+{
+    gc_heap_t *heap = (gc_heap_t *)vheap;
+    hmu_t *hmu = obj_to_hmu(obj);
 
-            next = (hmu_t *)((char *)hmu + size);
-            if (hmu_is_in_heap(next, base_addr, end_addr)) {
-                if (hmu_get_ut(next) == HMU_FC) {
-                    size += hmu_get_size(next);
-                    if (!unlink_hmu(heap, next)) {
-                        ret = GC_ERROR;
-                        goto out;
-                    }
-                    next = (hmu_t *)((char *)hmu + size);
-                }
-            }
+    if (!hmu_is_in_heap(hmu, heap->base_addr,
+                        heap->base_addr + heap->current_size)
+        || hmu_get_ut(hmu) != HMU_VO || hmu_is_vo_freed(hmu))
+        return 0;
 
-            if (!gci_add_fc(heap, hmu, size)) {
-                ret = GC_ERROR;
-                goto out;
-            }
+    return hmu_get_size(hmu);
+}
 
-            if (hmu_is_in_heap(next, base_addr, end_addr)) {
-                hmu_unmark_pinuse(next);
-            }
-        }
-        else {
+#if BH_ENABLE_GC_VERIFY == 0
+uint32
+gc_alloc_vo_batch(void *vheap, gc_size_t unit_size, gc_object_t *objs,
+                  uint32 count)
+{
+    gc_heap_t *heap = (gc_heap_t *)vheap;
+    hmu_t *hmu;
+    uint32 i;
+
+    bh_assert(unit_size == gc_get_unit_size(hmu_obj_size(unit_size)));
+
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+    if (heap->is_heap_corrupted) {
+        os_printf("[GC_ERROR]Heap is corrupted, allocate memory failed.\n");
+        return 0;
+    }
+#endif
+
+    os_mutex_lock(&heap->lock);
+
+    for (i = 0; i < count; i++) {
+        if (!(hmu = alloc_hmu_ex(heap, unit_size)))
+            break;
+
+        g_total_malloc += hmu_get_size(hmu);
+
+        hmu_set_ut(hmu, HMU_VO);
+        hmu_unfree_vo(hmu);
+        objs[i] = hmu_to_obj(hmu);
+    }
+
+    os_mutex_unlock(&heap->lock);
+    return i;
+}
+
+int
+gc_free_vo_batch(void *vheap, gc_object_t *objs, uint32 count)
+{
+    gc_heap_t *heap = (gc_heap_t *)vheap;
+    gc_uint8 *base_addr, *end_addr;
+    hmu_t *hmu;
+    uint32 i;
+    int ret = GC_SUCCESS;
+
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+    if (heap->is_heap_corrupted) {
+        os_printf("[GC_ERROR]Heap is corrupted, free memory failed.\n");
+        return GC_ERROR;
+    }
+#endif
+
+    base_addr = heap->base_addr;
+    end_addr = base_addr + heap->current_size;
+
+    os_mutex_lock(&heap->lock);
+
+    for (i = 0; i < count; i++) {
+        hmu = obj_to_hmu(objs[i]);
+        if (!hmu_is_in_heap(hmu, base_addr, end_addr)
+            || free_vo_hmu(heap, hmu) != GC_SUCCESS)
             ret = GC_ERROR;
-            goto out;
-        }
-        ret = GC_SUCCESS;
-        goto out;
     }
 
-out:
     os_mutex_unlock(&heap->lock);
     return ret;
 }
 
+gc_size_t
+gc_mark_vo_cached(void *vheap, gc_object_t obj)
+{
+    gc_heap_t *heap = (gc_heap_t *)vheap;
+    hmu_t *hmu = obj_to_hmu(obj);
+    gc_uint32 header;
+
+    if (!hmu_is_in_heap(hmu, heap->base_addr,
+                        heap->base_addr + heap->current_size)
+        || hmu_get_ut(hmu) != HMU_VO)
+        return 0;
+
+    header = BH_ATOMIC_32_FETCH_OR(hmu->header,
+                                   (uint32)1 << HMU_VO_FB_OFFSET);
+    if (GETBIT(header, HMU_VO_FB_OFFSET))
+        /* already freed or cached */
+        return 0;
+
+    return hmu_get_size(hmu);
+}
+
+void
+gc_unmark_vo_cached(gc_object_t obj)
+{
+    hmu_t *hmu = obj_to_hmu(obj);
+
+    bh_assert(hmu_get_ut(hmu) == HMU_VO && hmu_is_vo_freed(hmu));
+    BH_ATOMIC_32_FETCH_AND(hmu->header, ~((uint32)1 << HMU_VO_FB_OFFSET));
+}
+#endif /* end of BH_ENABLE_GC_VERIFY == 0 */
+
 void
 gc_dump_heap_stats(gc_heap_t *heap)
 {
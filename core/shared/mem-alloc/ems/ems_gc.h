@@ -125,6 +125,20 @@ gc_is_heap_corrupted(gc_handle_t handle);
 void *
 gc_heap_stats(void *heap, uint32 *stats, int size);
 
+/**
+ * Get the size of the heap unit that an allocation of the given size
+ * occupies, or 0 if the size overflows
+ */
+gc_size_t
+gc_get_unit_size(gc_size_t size);
+
+/**
+ * Get the size of the heap unit of an allocated object, or 0 if obj
+ * isn't an allocated object of the heap
+ */
+gc_size_t
+gc_get_obj_unit_size(void *heap, gc_object_t obj);
+
 #if BH_ENABLE_GC_VERIFY == 0
 
 gc_object_t
@@ -136,6 +150,45 @@ gc_realloc_vo(void *heap, void *ptr, gc_size_t size);
 int
 gc_free_vo(void *heap, gc_object_t obj);
 
+/**
+ * Allocate up to count objects of the same unit size with a single
+ * acquisition of the heap lock
+ *
+ * @param unit_size the unit size returned by gc_get_unit_size()
+ * @param objs [out] the objects allocated
+ *
+ * @return the number of objects allocated
+ */
+uint32
+gc_alloc_vo_batch(void *heap, gc_size_t unit_size, gc_object_t *objs,
+                  uint32 count);
+
+/**
+ * Free count objects with a single acquisition of the heap lock
+ *
+ * @return GC_SUCCESS if all objects were freed, GC_ERROR otherwise
+ */
+int
+gc_free_vo_batch(void *heap, gc_object_t *objs, uint32 count);
+
+/**
+ * Set the freed bit of an allocated object that is kept by a cache
+ * instead of being returned to the heap, so that freeing it again is
+ * detected. It is done atomically and doesn't take the heap lock.
+ *
+ * @return the unit size of the object, or 0 if obj isn't an allocated
+ * object of the heap or is already marked
+ */
+gc_size_t
+gc_mark_vo_cached(void *heap, gc_object_t obj);
+
+/**
+ * Clear the freed bit set by gc_mark_vo_cached() before the object is
+ * handed out again or returned to the heap
+ */
+void
+gc_unmark_vo_cached(gc_object_t obj);
+
 #else /* else of BH_ENABLE_GC_VERIFY */
 
 gc_object_t
@@ -11,6 +11,7 @@ extern "C" {
 #endif
 
 #include "bh_platform.h"
+#include "bh_atomic.h"
 #include "ems_gc.h"
 
 /* HMU (heap memory unit) basic block type */
@@ -131,8 +132,13 @@ hmu_verify(void *vheap, hmu_t *hmu);
 /* P in use bit means the previous chunk is in use */
 #define HMU_P_OFFSET 29
 
-#define hmu_mark_pinuse(hmu) SETBIT((hmu)->header, HMU_P_OFFSET)
-#define hmu_unmark_pinuse(hmu) CLRBIT((hmu)->header, HMU_P_OFFSET)
+/* The thread cache of mem_alloc.c sets and clears the freed bit of a
+   VO without the heap lock, so the pinuse bit that the heap changes in
+   the header of a neighbour VO is updated atomically */
+#define hmu_mark_pinuse(hmu) \
+    BH_ATOMIC_32_FETCH_OR((hmu)->header, (uint32)1 << HMU_P_OFFSET)
+#define hmu_unmark_pinuse(hmu) \
+    BH_ATOMIC_32_FETCH_AND((hmu)->header, ~((uint32)1 << HMU_P_OFFSET))
 #define hmu_get_pinuse(hmu) GETBIT((hmu)->header, HMU_P_OFFSET)
 
 #define HMU_JO_VT_SIZE 27
@@ -175,11 +181,37 @@ hmu_verify(void *vheap, hmu_t *hmu);
 #error "Too small GC_MAX_HEAP_SIZE"
 #endif
 
+/* Words of the bitmap of non-empty normal lists */
+#define HMU_NORMAL_BITMAP_CNT ((HMU_NORMAL_NODE_CNT + 31) >> 5)
+
+static inline uint32
+gc_ctz32(gc_uint32 v)
+{
+    bh_assert(v != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32)__builtin_ctz(v);
+#else
+    uint32 n = 0;
+    while (!(v & 1)) {
+        v >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
 typedef struct hmu_normal_node {
     hmu_t hmu_header;
     gc_int32 next_offset;
+    /* the list is doubly linked so a node is unlinked without walking
+       the list, 0 means the node is the list head */
+    gc_int32 prev_offset;
 } hmu_normal_node_t;
 
+/* The free size is stored at the end of the smallest free chunk */
+bh_static_assert(sizeof(hmu_normal_node_t) + sizeof(gc_uint32)
+                 <= GC_SMALLEST_SIZE);
+
 typedef struct hmu_normal_list {
     hmu_normal_node_t *next;
 } hmu_normal_list_t;
@@ -204,6 +236,26 @@ set_hmu_normal_node_next(hmu_normal_node_t *node, hmu_normal_node_t *next)
     }
 }
 
+static inline hmu_normal_node_t *
+get_hmu_normal_node_prev(hmu_normal_node_t *node)
+{
+    return node->prev_offset
+               ? (hmu_normal_node_t *)((uint8 *)node + node->prev_offset)
+               : NULL;
+}
+
+static inline void
+set_hmu_normal_node_prev(hmu_normal_node_t *node, hmu_normal_node_t *prev)
+{
+    if (prev) {
+        bh_assert((uint8 *)node - (uint8 *)prev < INT32_MAX);
+        node->prev_offset = (gc_int32)(intptr_t)((uint8 *)prev - (uint8 *)node);
+    }
+    else {
+        node->prev_offset = 0;
+    }
+}
+
 /**
  * Define hmu_tree_node as a packed struct, since it is at the 4-byte
  * aligned address and the size of hmu_head is 4, so in 64-bit target,
@@ -232,6 +284,8 @@ typedef struct hmu_tree_node {
     struct hmu_tree_node *right;
     struct hmu_tree_node *parent;
     gc_size_t size;
+    /* height of the subtree, the tree is kept AVL balanced */
+    gc_uint32 height;
 } __attr_packed __attr_aligned(4) hmu_tree_node_t;
 
 #if UINTPTR_MAX == UINT64_MAX
@@ -240,7 +294,7 @@ __pragma(pack(pop));
 #endif
 #endif
 
-bh_static_assert(sizeof(hmu_tree_node_t) == 8 + 3 * sizeof(void *));
+bh_static_assert(sizeof(hmu_tree_node_t) == 12 + 3 * sizeof(void *));
 bh_static_assert(offsetof(hmu_tree_node_t, left) == 4);
 
 #define ASSERT_TREE_NODE_ALIGNED_ACCESS(tree_node)                          \
@@ -271,6 +325,10 @@ typedef struct gc_heap_struct {
          size[left] <= size[cur] < size[right] */
     hmu_tree_node_t *kfc_tree_root;
 
+    /* bit i is set if kfc_normal_list[i] isn't empty, so that the
+       smallest non-empty list of a size is found with a ctz */
+    gc_uint32 kfc_normal_bitmap[HMU_NORMAL_BITMAP_CNT];
+
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
     /* whether heap is corrupted, e.g. the hmu nodes are modified
        by user */
@@ -45,6 +45,7 @@ gc_init_internal(gc_heap_t *heap, char *base_addr, gc_size_t heap_max_size)
     root->right = q;
     q->parent = root;
     q->size = heap->current_size;
+    q->height = 1;
 
     bh_assert(root->size <= HMU_FC_NORMAL_MAX_SIZE);
 
@@ -8,6 +8,202 @@
 #if DEFAULT_MEM_ALLOCATOR == MEM_ALLOCATOR_EMS
 
 #include "ems/ems_gc.h"
+#include "bh_atomic.h"
+
+/* The cached objects are marked freed in their headers without the heap
+   lock, which requires atomic operations */
+#if BH_ENABLE_GC_VERIFY == 0 && defined(os_thread_local_attribute) \
+    && BH_ATOMIC_32_IS_ATOMIC != 0
+#define MEM_ALLOC_THREAD_CACHE 1
+#else
+#define MEM_ALLOC_THREAD_CACHE 0
+#endif
+
+#if MEM_ALLOC_THREAD_CACHE != 0
+
+/* Unit sizes 16, 24, ..., 128 are cached, one bin for each */
+#define TCACHE_MIN_UNIT_SIZE 16
+#define TCACHE_MAX_UNIT_SIZE 128
+#define TCACHE_BIN_NUM ((TCACHE_MAX_UNIT_SIZE - TCACHE_MIN_UNIT_SIZE) / 8 + 1)
+/* Max objects kept in a bin */
+#define TCACHE_BIN_CAPACITY 16
+/* Objects taken from or returned to the heap at a time */
+#define TCACHE_BATCH_NUM (TCACHE_BIN_CAPACITY / 2)
+
+/* The objects in the bins are marked freed by gc_mark_vo_cached so that
+   a double free is caught, they are still in use for the heap */
+typedef struct mem_thread_cache {
+    struct mem_thread_cache *next;
+    uint32 counts[TCACHE_BIN_NUM];
+    void *bins[TCACHE_BIN_NUM][TCACHE_BIN_CAPACITY];
+} mem_thread_cache;
+
+/* The allocator with thread cache enabled, only one is supported */
+static mem_allocator_t tcache_allocator = NULL;
+/* Protects tcache_list, which links the caches of all threads */
+static korp_mutex tcache_list_lock;
+static mem_thread_cache *tcache_list = NULL;
+/* Bumped whenever tcache_allocator changes so that the caches left in
+   thread local storage by a previous allocator are dropped */
+static uint32 tcache_generation = 0;
+
+static os_thread_local_attribute mem_thread_cache *tcache_self = NULL;
+static os_thread_local_attribute uint32 tcache_self_generation = 0;
+
+static mem_thread_cache *
+get_thread_cache(mem_allocator_t allocator)
+{
+    mem_thread_cache *cache;
+
+    if (allocator != tcache_allocator)
+        return NULL;
+
+    if (tcache_self && tcache_self_generation == tcache_generation)
+        return tcache_self;
+
+    if (!(cache = gc_alloc_vo((gc_handle_t)allocator, sizeof(*cache))))
+        return NULL;
+
+    memset(cache, 0, sizeof(*cache));
+
+    os_mutex_lock(&tcache_list_lock);
+    cache->next = tcache_list;
+    tcache_list = cache;
+    os_mutex_unlock(&tcache_list_lock);
+
+    tcache_self = cache;
+    tcache_self_generation = tcache_generation;
+    return cache;
+}
+
+/* Return the first count objects of a bin to the heap */
+static void
+thread_cache_flush_bin(mem_allocator_t allocator, mem_thread_cache *cache,
+                       uint32 bin, uint32 count)
+{
+    void **objs = cache->bins[bin];
+    uint32 i;
+
+    for (i = 0; i < count; i++)
+        gc_unmark_vo_cached(objs[i]);
+
+    gc_free_vo_batch((gc_handle_t)allocator, objs, count);
+
+    cache->counts[bin] -= count;
+    memmove(objs, objs + count, sizeof(void *) * cache->counts[bin]);
+}
+
+static void
+thread_cache_flush(mem_allocator_t allocator, mem_thread_cache *cache)
+{
+    uint32 bin;
+
+    for (bin = 0; bin < TCACHE_BIN_NUM; bin++) {
+        if (cache->counts[bin] > 0)
+            thread_cache_flush_bin(allocator, cache, bin, cache->counts[bin]);
+    }
+}
+
+static void *
+thread_cache_alloc(mem_allocator_t allocator, mem_thread_cache *cache,
+                   uint32 size, uint32 unit_size)
+{
+    uint32 bin = (unit_size - TCACHE_MIN_UNIT_SIZE) >> 3, i;
+    void **objs = cache->bins[bin];
+    void *obj;
+
+    if (cache->counts[bin] == 0) {
+        cache->counts[bin] = gc_alloc_vo_batch((gc_handle_t)allocator,
+                                               unit_size, objs,
+                                               TCACHE_BATCH_NUM);
+        if (cache->counts[bin] == 0) {
+            /* The heap may be exhausted by the objects cached in other
+               bins, give them back and retry */
+            thread_cache_flush(allocator, cache);
+            return gc_alloc_vo((gc_handle_t)allocator, size);
+        }
+        obj = objs[--cache->counts[bin]];
+        /* The rest stay in the bin */
+        for (i = 0; i < cache->counts[bin]; i++)
+            gc_mark_vo_cached(allocator, objs[i]);
+        return obj;
+    }
+
+    obj = objs[--cache->counts[bin]];
+    gc_unmark_vo_cached(obj);
+    return obj;
+}
+
+static void
+thread_cache_free(mem_allocator_t allocator, mem_thread_cache *cache,
+                  void *obj, uint32 unit_size)
+{
+    uint32 bin = (unit_size - TCACHE_MIN_UNIT_SIZE) >> 3;
+
+    if (cache->counts[bin] == TCACHE_BIN_CAPACITY)
+        /* Keep the most recently freed objects which are likely
+           still in the CPU cache */
+        thread_cache_flush_bin(allocator, cache, bin, TCACHE_BATCH_NUM);
+
+    cache->bins[bin][cache->counts[bin]++] = obj;
+}
+
+bool
+mem_allocator_enable_thread_cache(mem_allocator_t allocator)
+{
+    if (tcache_allocator)
+        return tcache_allocator == allocator;
+
+    if (os_mutex_init(&tcache_list_lock) != 0)
+        return false;
+
+    tcache_allocator = allocator;
+    tcache_list = NULL;
+    tcache_generation++;
+    return true;
+}
+
+void
+mem_allocator_flush_thread_cache(mem_allocator_t allocator)
+{
+    mem_thread_cache *cache, **p_cache;
+
+    if (allocator != tcache_allocator || !tcache_self
+        || tcache_self_generation != tcache_generation)
+        return;
+
+    cache = tcache_self;
+    tcache_self = NULL;
+
+    os_mutex_lock(&tcache_list_lock);
+    for (p_cache = &tcache_list; *p_cache; p_cache = &(*p_cache)->next) {
+        if (*p_cache == cache) {
+            *p_cache = cache->next;
+            break;
+        }
+    }
+    os_mutex_unlock(&tcache_list_lock);
+
+    thread_cache_flush(allocator, cache);
+    gc_free_vo((gc_handle_t)allocator, cache);
+}
+
+#else /* else of MEM_ALLOC_THREAD_CACHE != 0 */
+
+bool
+mem_allocator_enable_thread_cache(mem_allocator_t allocator)
+{
+    (void)allocator;
+    return false;
+}
+
+void
+mem_allocator_flush_thread_cache(mem_allocator_t allocator)
+{
+    (void)allocator;
+}
+
+#endif /* end of MEM_ALLOC_THREAD_CACHE != 0 */
 
 mem_allocator_t
 mem_allocator_create(void *mem, uint32_t size)
@@ -28,6 +224,25 @@ mem_allocator_create_with_struct_and_pool(void *struct_buf,
 int
 mem_allocator_destroy(mem_allocator_t allocator)
 {
+#if MEM_ALLOC_THREAD_CACHE != 0
+    mem_thread_cache *cache, *next;
+
+    if (allocator == tcache_allocator) {
+        /* No thread may use the allocator any more, return the objects
+           cached by all threads */
+        for (cache = tcache_list; cache; cache = next) {
+            next = cache->next;
+            thread_cache_flush(allocator, cache);
+            gc_free_vo((gc_handle_t)allocator, cache);
+        }
+        tcache_list = NULL;
+        tcache_self = NULL;
+        tcache_allocator = NULL;
+        tcache_generation++;
+        os_mutex_destroy(&tcache_list_lock);
+    }
+#endif
+
     return gc_destroy_with_pool((gc_handle_t)allocator);
 }
 
@@ -40,6 +255,15 @@ mem_allocator_get_heap_struct_size()
 void *
 mem_allocator_malloc(mem_allocator_t allocator, uint32_t size)
 {
+#if MEM_ALLOC_THREAD_CACHE != 0
+    mem_thread_cache *cache;
+    uint32 unit_size = gc_get_unit_size(size);
+
+    if (unit_size > 0 && unit_size <= TCACHE_MAX_UNIT_SIZE
+        && (cache = get_thread_cache(allocator)))
+        return thread_cache_alloc(allocator, cache, size, unit_size);
+#endif
+
     return gc_alloc_vo((gc_handle_t)allocator, size);
 }
 
@@ -52,6 +276,26 @@ mem_allocator_realloc(mem_allocator_t allocator, void *ptr, uint32_t size)
 void
 mem_allocator_free(mem_allocator_t allocator, void *ptr)
 {
+#if MEM_ALLOC_THREAD_CACHE != 0
+    mem_thread_cache *cache;
+    uint32 unit_size;
+
+    /* A freed or cached object gets a unit size of 0 and goes to
+       gc_free_vo, which reports the double free */
+    if (ptr && allocator == tcache_allocator
+        && (unit_size = gc_get_obj_unit_size(allocator, ptr)) > 0
+        && unit_size <= TCACHE_MAX_UNIT_SIZE
+        && (cache = get_thread_cache(allocator))) {
+        if (!gc_mark_vo_cached(allocator, ptr)) {
+            /* Freed by another thread in the meantime */
+            bh_assert(0);
+            return;
+        }
+        thread_cache_free(allocator, cache, ptr, unit_size);
+        return;
+    }
+#endif
+
     if (ptr)
         gc_free_vo((gc_handle_t)allocator, ptr);
 }
@@ -72,6 +316,8 @@ mem_allocator_is_heap_corrupted(mem_allocator_t allocator)
 bool
 mem_allocator_get_alloc_info(mem_allocator_t allocator, void *mem_alloc_info)
 {
+    /* Objects held by the thread caches are reported as allocated, they
+       can't be handed out to other threads */
     gc_heap_stats((gc_handle_t)allocator, mem_alloc_info, 3);
     return true;
 }
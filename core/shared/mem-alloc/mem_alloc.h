@@ -48,6 +48,24 @@ mem_allocator_is_heap_corrupted(mem_allocator_t allocator);
 bool
 mem_allocator_get_alloc_info(mem_allocator_t allocator, void *mem_alloc_info);
 
+/**
+ * Serve the small allocations of each thread from a thread local cache
+ * to avoid taking the heap lock, objects are moved between the cache
+ * and the heap in batches. Only one allocator can enable it at a time.
+ *
+ * @return true if enabled, false if not supported or another allocator
+ *         has enabled it
+ */
+bool
+mem_allocator_enable_thread_cache(mem_allocator_t allocator);
+
+/**
+ * Return the objects cached by the calling thread to the heap, should be
+ * called before a thread which used the allocator exits
+ */
+void
+mem_allocator_flush_thread_cache(mem_allocator_t allocator);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,6 +3,9 @@
  * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include "platform_api_vmcore.h"
 
 #if (defined(__APPLE__) || defined(__MACH__)) && defined(__arm64__)
@@ -256,6 +259,257 @@ os_mprotect(void *addr, size_t size, int prot)
     return mprotect(addr, request_size, map_prot);
 }
 
+#ifdef OS_ENABLE_MMAP_FILE
+os_file_handle
+os_mmap_file_open(const char *path, uint64 *p_size)
+{
+    struct stat stat_buf;
+    int fd;
+
+    if ((fd = open(path, O_RDONLY, 0)) < 0)
+        return os_get_invalid_handle();
+
+    if (fstat(fd, &stat_buf) != 0 || !S_ISREG(stat_buf.st_mode)) {
+        close(fd);
+        return os_get_invalid_handle();
+    }
+
+    *p_size = (uint64)stat_buf.st_size;
+    return fd;
+}
+
+void
+os_mmap_file_close(os_file_handle file)
+{
+    close(file);
+}
+
+void *
+os_mmap_file(void *hint, size_t size, int prot, int flags, os_file_handle file,
+             uint64 offset)
+{
+    int map_prot = PROT_NONE;
+    /* Private file pages stay in the page cache until written */
+    int map_flags = MAP_PRIVATE;
+    uint8 *addr;
+
+    if (offset & ((uint64)getpagesize() - 1))
+        return NULL;
+
+    if (prot & MMAP_PROT_READ)
+        map_prot |= PROT_READ;
+
+    if (prot & MMAP_PROT_WRITE)
+        map_prot |= PROT_WRITE;
+
+    if (prot & MMAP_PROT_EXEC)
+        map_prot |= PROT_EXEC;
+
+#if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64)
+#ifndef __APPLE__
+    if (flags & MMAP_MAP_32BIT)
+        map_flags |= MAP_32BIT;
+#endif
+#endif
+
+    if (flags & MMAP_MAP_FIXED)
+        map_flags |= MAP_FIXED;
+
+    addr = mmap(hint, size, map_prot, map_flags, file, (off_t)offset);
+    if (addr == MAP_FAILED) {
+#if BH_ENABLE_TRACE_MMAP != 0
+        os_printf("mmap file failed\n");
+#endif
+        return NULL;
+    }
+
+    return addr;
+}
+
+os_file_handle
+os_mmap_file_create(const char *name, const void *data, uint64 size)
+{
+    uint64 page_size = (uint64)getpagesize(), offset, len, i;
+    const uint8 *page;
+    ssize_t written;
+    int fd;
+
+    if ((fd = memfd_create(name, MFD_CLOEXEC)) < 0)
+        return os_get_invalid_handle();
+
+    if (ftruncate(fd, (off_t)size) != 0)
+        goto fail;
+
+    /* Only write the non-zero pages, the others stay holes of the file
+       and are read as zero without taking any memory */
+    for (offset = 0; offset < size; offset += page_size) {
+        page = (const uint8 *)data + offset;
+        len = size - offset < page_size ? size - offset : page_size;
+        for (i = 0; i < len && !page[i]; i++)
+            ;
+        if (i == len)
+            continue;
+
+        for (i = 0; i < len; i += (uint64)written) {
+            written = pwrite(fd, page + i, (size_t)(len - i),
+                             (off_t)(offset + i));
+            if (written <= 0)
+                goto fail;
+        }
+    }
+
+    return fd;
+fail:
+    close(fd);
+    return os_get_invalid_handle();
+}
+
+int
+os_mem_discard(void *addr, size_t size)
+{
+    return madvise(addr, size, MADV_DONTNEED);
+}
+#endif /* end of OS_ENABLE_MMAP_FILE */
+
+#ifdef OS_ENABLE_MMAP_DUAL
+int
+os_mmap_dual(size_t size, void **p_rw_addr, void **p_rx_addr)
+{
+    void *rw_addr, *rx_addr;
+    int fd;
+
+    if ((fd = memfd_create("wamr-code", MFD_CLOEXEC)) < 0)
+        return -1;
+
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    /* Both views are shared mappings of the same file, the mappings
+       keep the file alive after it is closed */
+    rw_addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (rw_addr == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+
+    rx_addr = mmap(NULL, size, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+    if (rx_addr == MAP_FAILED) {
+        munmap(rw_addr, size);
+        close(fd);
+        return -1;
+    }
+
+    close(fd);
+    *p_rw_addr = rw_addr;
+    *p_rx_addr = rx_addr;
+    return 0;
+}
+
+void
+os_munmap_dual(void *rw_addr, void *rx_addr, size_t size)
+{
+    munmap(rw_addr, size);
+    munmap(rx_addr, size);
+}
+#endif /* end of OS_ENABLE_MMAP_DUAL */
+
+#ifdef OS_ENABLE_MEM_SOFT_DIRTY
+/* Bit 55 of a /proc/self/pagemap entry is the soft-dirty bit */
+#define PAGEMAP_SOFT_DIRTY ((uint64)1 << 55)
+/* Number of pagemap entries read at a time */
+#define PAGEMAP_BATCH_SIZE 512
+
+static int
+clear_soft_dirty_bits(void)
+{
+    int fd, ret = -1;
+
+    if ((fd = open("/proc/self/clear_refs", O_WRONLY)) < 0)
+        return -1;
+    /* "4" clears the soft-dirty bits of all the ptes of the process */
+    if (write(fd, "4", 1) == 1)
+        ret = 0;
+    close(fd);
+    return ret;
+}
+
+/* The soft-dirty bits are silently ignored by kernels built without
+   CONFIG_MEM_SOFT_DIRTY, so check that a written page is reported */
+static bool
+soft_dirty_probe(void)
+{
+    uint8 bitmap = 0, *page;
+    size_t page_size = (size_t)getpagesize();
+
+    page = mmap(NULL, page_size, PROT_READ | PROT_WRITE,
+                MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (page == MAP_FAILED)
+        return false;
+
+    page[0] = 1;
+    if (clear_soft_dirty_bits() == 0) {
+        *(volatile uint8 *)page = 2;
+        if (os_mem_get_soft_dirty(page, page_size, &bitmap) != 0)
+            bitmap = 0;
+    }
+    munmap(page, page_size);
+    return bitmap & 1 ? true : false;
+}
+
+int
+os_mem_clear_soft_dirty(void)
+{
+    /* 0: unknown, 1: supported, -1: unsupported */
+    static int supported = 0;
+
+    if (supported == 0)
+        supported = soft_dirty_probe() ? 1 : -1;
+    if (supported < 0)
+        return -1;
+    return clear_soft_dirty_bits();
+}
+
+int
+os_mem_get_soft_dirty(void *addr, size_t size, uint8 *bitmap)
+{
+    uint64 entries[PAGEMAP_BATCH_SIZE];
+    size_t page_size = (size_t)getpagesize();
+    size_t page_count = size / page_size, i, j, n;
+    off_t offset = (off_t)((uintptr_t)addr / page_size * sizeof(uint64));
+    ssize_t read_size;
+    int fd;
+
+    if (((uintptr_t)addr & (page_size - 1)) || (size & (page_size - 1)))
+        return -1;
+
+    if ((fd = open("/proc/self/pagemap", O_RDONLY)) < 0)
+        return -1;
+
+    for (i = 0; i < page_count; i += n) {
+        n = page_count - i;
+        if (n > PAGEMAP_BATCH_SIZE)
+            n = PAGEMAP_BATCH_SIZE;
+
+        read_size = pread(fd, entries, n * sizeof(uint64),
+                          offset + (off_t)(i * sizeof(uint64)));
+        if (read_size != (ssize_t)(n * sizeof(uint64))) {
+            close(fd);
+            return -1;
+        }
+
+        for (j = 0; j < n; j++) {
+            if (entries[j] & PAGEMAP_SOFT_DIRTY)
+                bitmap[(i + j) >> 3] |= (uint8)(1 << ((i + j) & 7));
+        }
+    }
+
+    close(fd);
+    return 0;
+}
+#endif /* end of OS_ENABLE_MEM_SOFT_DIRTY */
+
 void
 os_dcache_flush(void)
 {}
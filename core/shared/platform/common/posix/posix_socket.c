@@ -6,6 +6,7 @@
 #include "platform_api_vmcore.h"
 #include "platform_api_extension.h"
 #include "libc_errno.h"
+#include "posix_socket.h"
 
 #include <arpa/inet.h>
 #include <netdb.h>
@@ -44,7 +45,7 @@ textual_addr_to_sockaddr(const char *textual, int port, struct sockaddr *out,
     return false;
 }
 
-static int
+int
 sockaddr_to_bh_sockaddr(const struct sockaddr *sockaddr,
                         bh_sockaddr_t *bh_sockaddr)
 {
@@ -84,7 +85,7 @@ sockaddr_to_bh_sockaddr(const struct sockaddr *sockaddr,
     }
 }
 
-static void
+void
 bh_sockaddr_to_sockaddr(const bh_sockaddr_t *bh_sockaddr,
                         struct sockaddr_storage *sockaddr, socklen_t *socklen)
 {
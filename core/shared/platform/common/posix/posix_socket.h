@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2021 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _POSIX_SOCKET_H
+#define _POSIX_SOCKET_H
+
+#include "platform_api_extension.h"
+
+#include <sys/socket.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Converts a native socket address to bh_sockaddr_t, returns
+   BHT_OK or BHT_ERROR with errno set if the family isn't supported */
+int
+sockaddr_to_bh_sockaddr(const struct sockaddr *sockaddr,
+                        bh_sockaddr_t *bh_sockaddr);
+
+/* Converts bh_sockaddr_t to a native socket address */
+void
+bh_sockaddr_to_sockaddr(const bh_sockaddr_t *bh_sockaddr,
+                        struct sockaddr_storage *sockaddr, socklen_t *socklen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _POSIX_SOCKET_H */
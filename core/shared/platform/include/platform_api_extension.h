@@ -1632,6 +1632,98 @@ __wasi_errno_t
 os_clock_time_get(__wasi_clockid_t clock_id, __wasi_timestamp_t precision,
                   __wasi_timestamp_t *time);
 
+/****************************************************
+ *                     Section 5                    *
+ *                 Asynchronous I/O                 *
+ ****************************************************/
+
+#ifdef OS_ENABLE_IO_URING
+/**
+ * Set up the process-global io_uring instance which the blocking I/O of
+ * WASI can be submitted to. The os_io_uring_* functions below are only
+ * usable after it succeeds, otherwise the synchronous functions should
+ * be used. WASI only submits the reads into a registered buffer, the
+ * writes and the socket I/O are slower than the synchronous calls.
+ *
+ * @return BHT_OK if success, BHT_ERROR if io_uring isn't available
+ */
+int
+os_io_uring_init();
+
+/**
+ * Destroy the io_uring instance, no I/O may be in flight.
+ */
+void
+os_io_uring_destroy();
+
+/**
+ * Check whether os_io_uring_init() succeeded.
+ */
+bool
+os_io_uring_is_inited();
+
+/**
+ * Register [buf, buf + size) as a fixed buffer of the io_uring instance,
+ * so that the I/O falling in it doesn't need to map the user pages each
+ * time. The pages stay pinned until the buffer is unregistered.
+ *
+ * @param p_index the index of the buffer, -1 for a new buffer; it is
+ *        updated when the buffer is (re-)registered, and set to -2 if
+ *        the registration failed so that it isn't retried
+ * @param buf the start address of the buffer
+ * @param size the size of the buffer
+ *
+ * @return the index of the buffer if success, -1 otherwise
+ */
+int
+os_io_uring_register_buffer(int *p_index, void *buf, uint64 size);
+
+/**
+ * Unregister a buffer registered by os_io_uring_register_buffer().
+ */
+void
+os_io_uring_unregister_buffer(int index);
+
+/**
+ * Same as os_preadv() (or os_readv() if offset is -1), but the
+ * operation is submitted to io_uring, and the calling thread sleeps
+ * until it completes. Interrupted by os_wakeup_blocking_op(), the
+ * operation is cancelled and __WASI_EINTR is returned unless it has
+ * completed.
+ *
+ * @param buf_index the index of the registered buffer which iov[0] may
+ *        fall in, or -1
+ */
+__wasi_errno_t
+os_io_uring_readv(os_file_handle handle, const struct __wasi_iovec_t *iov,
+                  int iovcnt, int64 offset, int buf_index, size_t *nread);
+
+/**
+ * Same as os_pwritev() (or os_writev() if offset is -1), submitted to
+ * io_uring like os_io_uring_readv().
+ */
+__wasi_errno_t
+os_io_uring_writev(os_file_handle handle, const struct __wasi_ciovec_t *iov,
+                   int iovcnt, int64 offset, int buf_index, size_t *nwritten);
+
+/**
+ * Same as os_socket_recv_from(), submitted to io_uring like
+ * os_io_uring_readv(), errno is set on failure.
+ */
+int
+os_io_uring_socket_recv_from(bh_socket_t socket, void *buf, unsigned int len,
+                             int flags, bh_sockaddr_t *src_addr);
+
+/**
+ * Same as os_socket_send_to(), submitted to io_uring like
+ * os_io_uring_readv(), errno is set on failure.
+ */
+int
+os_io_uring_socket_send_to(bh_socket_t socket, const void *buf,
+                           unsigned int len, int flags,
+                           const bh_sockaddr_t *dest_addr);
+#endif /* end of OS_ENABLE_IO_URING */
+
 #ifdef __cplusplus
 }
 #endif
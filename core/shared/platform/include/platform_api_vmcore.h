@@ -141,6 +141,108 @@ void *
 os_get_dbus_mirror(void *ibus);
 #endif
 
+#ifdef OS_ENABLE_MMAP_FILE
+/**
+ * Open a file read-only to be mapped with os_mmap_file.
+ *
+ * @param path the path of the file
+ * @param p_size the size of the file
+ *
+ * @return the file handle, os_get_invalid_handle() if failed
+ */
+os_file_handle
+os_mmap_file_open(const char *path, uint64 *p_size);
+
+void
+os_mmap_file_close(os_file_handle file);
+
+/**
+ * Map a range of a file copy-on-write: the pages are shared with the page
+ * cache of the file until they are written. The mapping is released with
+ * os_munmap and remains valid after the file is closed.
+ *
+ * @param hint, size, prot and flags are the same as os_mmap's
+ * @param file the file opened by os_mmap_file_open
+ * @param offset offset of the range in the file, must be page aligned
+ *
+ * @return the mapped address, NULL if failed
+ */
+void *
+os_mmap_file(void *hint, size_t size, int prot, int flags, os_file_handle file,
+             uint64 offset);
+
+/**
+ * Create an anonymous in-memory file holding a copy of data, which can be
+ * mapped with os_mmap_file and is released with os_mmap_file_close.
+ *
+ * @param name the name of the file, only used for debugging
+ * @param data the initial content of the file
+ * @param size the size of data
+ *
+ * @return the file handle, os_get_invalid_handle() if failed
+ */
+os_file_handle
+os_mmap_file_create(const char *name, const void *data, uint64 size);
+
+/**
+ * Drop the pages of a mapped range: anonymous pages are read as zero
+ * again and private file pages get back the content of the file.
+ *
+ * @param addr the start address of the range, must be page aligned
+ * @param size the size of the range
+ *
+ * @return 0 if success, -1 otherwise
+ */
+int
+os_mem_discard(void *addr, size_t size);
+#endif
+
+#ifdef OS_ENABLE_MMAP_DUAL
+/**
+ * Map the same anonymous memory twice: a read-write view to write the
+ * code and a read-execute view to run it, so that no page is mapped
+ * writable and executable at the same time.
+ *
+ * @param size the size of the memory, must be a multiple of the page size
+ * @param p_rw_addr return the address of the read-write view
+ * @param p_rx_addr return the address of the read-execute view
+ *
+ * @return 0 if success, -1 otherwise
+ */
+int
+os_mmap_dual(size_t size, void **p_rw_addr, void **p_rx_addr);
+
+/**
+ * Unmap the two views mapped with os_mmap_dual.
+ */
+void
+os_munmap_dual(void *rw_addr, void *rx_addr, size_t size);
+#endif
+
+#ifdef OS_ENABLE_MEM_SOFT_DIRTY
+/**
+ * Clear the soft-dirty bits of all the pages of the current process, so
+ * that os_mem_get_soft_dirty only reports the pages written afterwards.
+ *
+ * @return 0 if success, -1 if soft-dirty tracking isn't available
+ */
+int
+os_mem_clear_soft_dirty(void);
+
+/**
+ * Get the pages written since the last call of os_mem_clear_soft_dirty.
+ *
+ * @param addr the start address of the range, must be page aligned
+ * @param size the size of the range, must be a multiple of the page size
+ * @param bitmap bit i is set if the i-th page of the range was written,
+ *        the bits already set in it are kept
+ *
+ * @return 0 if success, -1 otherwise
+ */
+int
+os_mem_get_soft_dirty(void *addr, size_t size, uint8 *bitmap);
+#endif
+
 /**
  * Flush cpu data cache, in some CPUs, after applying relocation to the
  * AOT code, the code may haven't been written back to the cpu data cache,
@@ -0,0 +1,616 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "platform_api_vmcore.h"
+#include "platform_api_extension.h"
+
+#ifdef OS_ENABLE_IO_URING
+
+#include "libc_errno.h"
+#include "../common/posix/posix_socket.h"
+
+#include <linux/futex.h>
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+
+/* Entries of the submission queue, the completion queue has twice as many */
+#define IO_URING_ENTRIES 256
+
+/* Slots of the registered buffer table */
+#define IO_URING_BUF_NUM 64
+
+/* Max size of a registered buffer accepted by the kernel */
+#define IO_URING_BUF_MAX_SIZE ((uint64)1 << 30)
+
+/* Set in io_uring_request.state once the result is valid, the other bits
+   count the wakeups for the waiter to become the leader */
+#define REQUEST_DONE 1
+#define REQUEST_WAKEUP 2
+
+/**
+ * An operation waited by a thread. The threads waiting for their
+ * operations elect a leader which sleeps in io_uring_enter and reaps the
+ * completions for all, the others sleep on the futex of their own
+ * request, so that no thread may miss its completion.
+ */
+typedef struct io_uring_request {
+    struct io_uring_request *prev;
+    struct io_uring_request *next;
+    uint32 state;
+    int32 res;
+    bool cancelled;
+} io_uring_request;
+
+static int ring_fd = -1;
+
+static void *ring_mem;
+static size_t ring_mem_size;
+static struct io_uring_sqe *sqes;
+static size_t sqes_size;
+
+static uint32 *sq_head, *sq_tail, *sq_array;
+static uint32 sq_mask, sq_entries;
+static uint32 *cq_head, *cq_tail;
+static uint32 cq_mask;
+static struct io_uring_cqe *cqes;
+
+/* Protects the fields below and the tail of the submission queue and
+   the head of the completion queue */
+static korp_mutex ring_lock;
+/* SQEs queued but not submitted yet */
+static uint32 sq_pending;
+/* Whether a thread is waiting in io_uring_enter for completions */
+static bool has_leader;
+/* Requests whose threads are waiting */
+static io_uring_request *waiting_list;
+
+static bool buf_registered;
+static struct {
+    void *buf;
+    uint64 size;
+} bufs[IO_URING_BUF_NUM];
+
+static int
+io_uring_setup(uint32 entries, struct io_uring_params *params)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int
+io_uring_enter(uint32 to_submit, uint32 min_complete, uint32 flags)
+{
+    return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete,
+                        flags, NULL, 0);
+}
+
+static int
+io_uring_register(uint32 opcode, const void *arg, uint32 nr_args)
+{
+    return (int)syscall(__NR_io_uring_register, ring_fd, opcode, arg,
+                        nr_args);
+}
+
+static int
+futex_wait(uint32 *addr, uint32 val)
+{
+    return (int)syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL,
+                        0);
+}
+
+static void
+futex_wake(uint32 *addr)
+{
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+static bool
+update_buffer(int index, void *buf, uint64 size)
+{
+    struct iovec iov = { buf, (size_t)size };
+    struct io_uring_rsrc_update2 update = { 0 };
+
+    update.offset = (uint32)index;
+    update.data = (uint64)(uintptr_t)&iov;
+    update.nr = 1;
+    if (io_uring_register(IORING_REGISTER_BUFFERS_UPDATE, &update,
+                          sizeof(update))
+        != 1)
+        return false;
+
+    bufs[index].buf = buf;
+    bufs[index].size = size;
+    return true;
+}
+
+int
+os_io_uring_init()
+{
+    struct io_uring_params params = { 0 };
+    struct io_uring_rsrc_register reg = { 0 };
+    uint8 *p;
+
+    if (ring_fd >= 0)
+        return BHT_OK;
+
+    if ((ring_fd = io_uring_setup(IO_URING_ENTRIES, &params)) < 0)
+        return BHT_ERROR;
+
+    /* Reading and writing at the current file position and not dropping
+       the completions on overflow are required */
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP)
+        || !(params.features & IORING_FEAT_NODROP)
+        || !(params.features & IORING_FEAT_RW_CUR_POS))
+        goto fail1;
+
+    ring_mem_size = params.sq_off.array + params.sq_entries * sizeof(uint32);
+    if (ring_mem_size
+        < params.cq_off.cqes
+              + params.cq_entries * sizeof(struct io_uring_cqe))
+        ring_mem_size = params.cq_off.cqes
+                        + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring_mem = mmap(NULL, ring_mem_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (ring_mem == MAP_FAILED)
+        goto fail1;
+
+    sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes = mmap(NULL, sqes_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+        goto fail2;
+
+    if (os_mutex_init(&ring_lock) != BHT_OK)
+        goto fail3;
+
+    p = (uint8 *)ring_mem;
+    sq_head = (uint32 *)(p + params.sq_off.head);
+    sq_tail = (uint32 *)(p + params.sq_off.tail);
+    sq_array = (uint32 *)(p + params.sq_off.array);
+    sq_mask = *(uint32 *)(p + params.sq_off.ring_mask);
+    sq_entries = params.sq_entries;
+    cq_head = (uint32 *)(p + params.cq_off.head);
+    cq_tail = (uint32 *)(p + params.cq_off.tail);
+    cq_mask = *(uint32 *)(p + params.cq_off.ring_mask);
+    cqes = (struct io_uring_cqe *)(p + params.cq_off.cqes);
+
+    sq_pending = 0;
+    has_leader = false;
+    waiting_list = NULL;
+
+    /* Fixed buffers are optional, they need a kernel with sparse buffer
+       tables (5.19+) */
+    memset(bufs, 0, sizeof(bufs));
+    reg.nr = IO_URING_BUF_NUM;
+    reg.flags = IORING_RSRC_REGISTER_SPARSE;
+    buf_registered =
+        io_uring_register(IORING_REGISTER_BUFFERS2, &reg, sizeof(reg)) == 0;
+
+    return BHT_OK;
+
+fail3:
+    munmap(sqes, sqes_size);
+fail2:
+    munmap(ring_mem, ring_mem_size);
+fail1:
+    close(ring_fd);
+    ring_fd = -1;
+    return BHT_ERROR;
+}
+
+void
+os_io_uring_destroy()
+{
+    if (ring_fd < 0)
+        return;
+
+    assert(!waiting_list);
+    os_mutex_destroy(&ring_lock);
+    munmap(sqes, sqes_size);
+    munmap(ring_mem, ring_mem_size);
+    /* Closing the ring also unregisters the buffers */
+    close(ring_fd);
+    ring_fd = -1;
+}
+
+bool
+os_io_uring_is_inited()
+{
+    return ring_fd >= 0;
+}
+
+int
+os_io_uring_register_buffer(int *p_index, void *buf, uint64 size)
+{
+    int index;
+
+    if (size > IO_URING_BUF_MAX_SIZE)
+        size = IO_URING_BUF_MAX_SIZE;
+
+    os_mutex_lock(&ring_lock);
+
+    index = *p_index;
+    if (index == -2 || !buf_registered) {
+        index = -1;
+        goto unlock;
+    }
+
+    if (index >= 0) {
+        if (bufs[index].buf == buf && bufs[index].size >= size)
+            goto unlock;
+    }
+    else {
+        for (index = 0; index < IO_URING_BUF_NUM; index++) {
+            if (!bufs[index].buf)
+                break;
+        }
+        if (index == IO_URING_BUF_NUM) {
+            index = -1;
+            goto unlock;
+        }
+    }
+
+    /* The pages are pinned, which may exceed RLIMIT_MEMLOCK */
+    if (!update_buffer(index, buf, size)) {
+        if (*p_index >= 0)
+            update_buffer(*p_index, NULL, 0);
+        *p_index = -2;
+        index = -1;
+        goto unlock;
+    }
+    *p_index = index;
+
+unlock:
+    os_mutex_unlock(&ring_lock);
+    return index;
+}
+
+void
+os_io_uring_unregister_buffer(int index)
+{
+    if (index < 0)
+        return;
+
+    os_mutex_lock(&ring_lock);
+    /* The operations in flight keep their references to the pages */
+    update_buffer(index, NULL, 0);
+    os_mutex_unlock(&ring_lock);
+}
+
+/* Get a free SQE, the ring lock must be held */
+static struct io_uring_sqe *
+get_sqe()
+{
+    uint32 n;
+    int ret;
+    struct io_uring_sqe *sqe;
+
+    while (*sq_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE)
+           >= sq_entries) {
+        /* The queue is full of the SQEs queued by the other threads */
+        if (sq_pending == 0)
+            return NULL;
+        n = sq_pending;
+        sq_pending = 0;
+        os_mutex_unlock(&ring_lock);
+        ret = io_uring_enter(n, 0, 0);
+        os_mutex_lock(&ring_lock);
+        if (ret > 0)
+            n -= (uint32)ret < n ? (uint32)ret : n;
+        sq_pending += n;
+        if (ret <= 0)
+            return NULL;
+    }
+
+    sqe = &sqes[*sq_tail & sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+/* Queue the SQE returned by get_sqe(), the ring lock must be held */
+static void
+queue_sqe(struct io_uring_sqe *sqe)
+{
+    uint32 tail = *sq_tail;
+
+    sq_array[tail & sq_mask] = (uint32)(sqe - sqes);
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+    sq_pending++;
+}
+
+/* Reap the completions and wake up their waiters, the ring lock must be
+   held and there must be no leader, return the number of CQEs reaped */
+static uint32
+reap_cqes(io_uring_request *self)
+{
+    uint32 head = *cq_head, start = head;
+    uint32 tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+    struct io_uring_cqe *cqe;
+    io_uring_request *request;
+
+    for (; head != tail; head++) {
+        cqe = &cqes[head & cq_mask];
+        /* The CQEs of the cancellations have no request */
+        if (!(request = (io_uring_request *)(uintptr_t)cqe->user_data))
+            continue;
+        request->res = cqe->res;
+        __atomic_fetch_or(&request->state, REQUEST_DONE, __ATOMIC_RELEASE);
+        /* The waiter can't leave before the lock is released */
+        if (request != self)
+            futex_wake(&request->state);
+    }
+    __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+    return head - start;
+}
+
+/* Ask the waiter whose operation isn't done yet to become the leader */
+static void
+wakeup_next_leader()
+{
+    io_uring_request *request = waiting_list;
+
+    while (request && (request->state & REQUEST_DONE))
+        request = request->next;
+
+    if (request) {
+        __atomic_fetch_add(&request->state, REQUEST_WAKEUP, __ATOMIC_RELEASE);
+        futex_wake(&request->state);
+    }
+}
+
+static void
+cancel_request(io_uring_request *request)
+{
+    struct io_uring_sqe *sqe;
+
+    if (request->cancelled || !(sqe = get_sqe()))
+        return;
+
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = (uint64)(uintptr_t)request;
+    queue_sqe(sqe);
+    request->cancelled = true;
+}
+
+/**
+ * Queue the SQE prepared for request and sleep until it completes, the
+ * ring lock must be held and is released on return.
+ *
+ * @return the result of the operation, -errno on failure
+ */
+static int32
+submit_and_wait(io_uring_request *request, struct io_uring_sqe *sqe)
+{
+    uint32 n, state;
+    int ret, error;
+
+    sqe->user_data = (uint64)(uintptr_t)request;
+    queue_sqe(sqe);
+
+    request->prev = NULL;
+    request->next = waiting_list;
+    if (waiting_list)
+        waiting_list->prev = request;
+    waiting_list = request;
+
+    while (!(request->state & REQUEST_DONE)) {
+        n = sq_pending;
+        sq_pending = 0;
+
+        if (!has_leader) {
+            /* Submit the queued SQEs of all threads and wait for the
+               completions in one call */
+            has_leader = true;
+            os_mutex_unlock(&ring_lock);
+            ret = io_uring_enter(n, 1, IORING_ENTER_GETEVENTS);
+            error = ret < 0 ? errno : 0;
+            os_mutex_lock(&ring_lock);
+            has_leader = false;
+            /* A signal interrupting the wait after the submission isn't
+               reported, but as only the leader reaps, waking up with no
+               completion means the wait was interrupted */
+            if (reap_cqes(request) == 0 && ret >= 0)
+                error = EINTR;
+        }
+        else {
+            if (n > 0) {
+                os_mutex_unlock(&ring_lock);
+                ret = io_uring_enter(n, 0, 0);
+                error = ret < 0 ? errno : 0;
+                os_mutex_lock(&ring_lock);
+            }
+            else {
+                ret = error = 0;
+            }
+            if (ret >= 0 && !(request->state & REQUEST_DONE) && has_leader) {
+                state = request->state;
+                os_mutex_unlock(&ring_lock);
+                if (futex_wait(&request->state, state) != 0)
+                    error = errno;
+                os_mutex_lock(&ring_lock);
+            }
+        }
+
+        if (ret >= 0)
+            n -= (uint32)ret < n ? (uint32)ret : n;
+        sq_pending += n;
+
+        if (!has_leader)
+            reap_cqes(request);
+
+        /* Interrupted by os_wakeup_blocking_op() */
+        if (error == EINTR && !(request->state & REQUEST_DONE))
+            cancel_request(request);
+    }
+
+    if (request->prev)
+        request->prev->next = request->next;
+    else
+        waiting_list = request->next;
+    if (request->next)
+        request->next->prev = request->prev;
+
+    if (!has_leader)
+        wakeup_next_leader();
+
+    os_mutex_unlock(&ring_lock);
+
+    if (request->cancelled && request->res == -ECANCELED)
+        return -EINTR;
+    return request->res;
+}
+
+/* Use the fixed buffer for a single buffer falling in it */
+static bool
+is_in_buffer(int buf_index, const void *buf, size_t len)
+{
+    return buf_index >= 0 && buf_index < IO_URING_BUF_NUM
+           && bufs[buf_index].buf
+           && (uint8 *)buf >= (uint8 *)bufs[buf_index].buf
+           && (uint8 *)buf + len
+                  <= (uint8 *)bufs[buf_index].buf + bufs[buf_index].size;
+}
+
+static int32
+submit_rw(uint8 opcode, uint8 fixed_opcode, os_file_handle handle,
+          const struct iovec *iov, int iovcnt, int64 offset, int buf_index)
+{
+    io_uring_request request = { 0 };
+    struct io_uring_sqe *sqe;
+
+    os_mutex_lock(&ring_lock);
+
+    if (!(sqe = get_sqe())) {
+        os_mutex_unlock(&ring_lock);
+        return -EAGAIN;
+    }
+
+    sqe->fd = handle;
+    /* -1 means the current file position */
+    sqe->off = (uint64)offset;
+    if (iovcnt == 1 && is_in_buffer(buf_index, iov->iov_base, iov->iov_len)) {
+        sqe->opcode = fixed_opcode;
+        sqe->addr = (uint64)(uintptr_t)iov->iov_base;
+        sqe->len = (uint32)iov->iov_len;
+        sqe->buf_index = (uint16)buf_index;
+    }
+    else {
+        sqe->opcode = opcode;
+        sqe->addr = (uint64)(uintptr_t)iov;
+        sqe->len = (uint32)iovcnt;
+    }
+
+    return submit_and_wait(&request, sqe);
+}
+
+__wasi_errno_t
+os_io_uring_readv(os_file_handle handle, const struct __wasi_iovec_t *iov,
+                  int iovcnt, int64 offset, int buf_index, size_t *nread)
+{
+    int32 res = submit_rw(IORING_OP_READV, IORING_OP_READ_FIXED, handle,
+                          (const struct iovec *)iov, iovcnt, offset, buf_index);
+
+    if (res < 0)
+        return convert_errno(-res);
+
+    *nread = (size_t)res;
+    return __WASI_ESUCCESS;
+}
+
+__wasi_errno_t
+os_io_uring_writev(os_file_handle handle, const struct __wasi_ciovec_t *iov,
+                   int iovcnt, int64 offset, int buf_index, size_t *nwritten)
+{
+    int32 res =
+        submit_rw(IORING_OP_WRITEV, IORING_OP_WRITE_FIXED, handle,
+                  (const struct iovec *)iov, iovcnt, offset, buf_index);
+
+    if (res < 0)
+        return convert_errno(-res);
+
+    *nwritten = (size_t)res;
+    return __WASI_ESUCCESS;
+}
+
+static int32
+submit_msg(uint8 opcode, bh_socket_t socket, struct msghdr *msg, int flags)
+{
+    io_uring_request request = { 0 };
+    struct io_uring_sqe *sqe;
+
+    os_mutex_lock(&ring_lock);
+
+    if (!(sqe = get_sqe())) {
+        os_mutex_unlock(&ring_lock);
+        return -EAGAIN;
+    }
+
+    sqe->opcode = opcode;
+    sqe->fd = socket;
+    sqe->addr = (uint64)(uintptr_t)msg;
+    sqe->len = 1;
+    sqe->msg_flags = (uint32)flags;
+
+    return submit_and_wait(&request, sqe);
+}
+
+int
+os_io_uring_socket_recv_from(bh_socket_t socket, void *buf, unsigned int len,
+                             int flags, bh_sockaddr_t *src_addr)
+{
+    struct sockaddr_storage sock_addr = { 0 };
+    struct iovec iov = { buf, len };
+    struct msghdr msg = { 0 };
+    int32 res;
+
+    msg.msg_name = &sock_addr;
+    msg.msg_namelen = sizeof(sock_addr);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    if ((res = submit_msg(IORING_OP_RECVMSG, socket, &msg, flags)) < 0) {
+        errno = -res;
+        return -1;
+    }
+
+    if (src_addr && msg.msg_namelen > 0) {
+        if (sockaddr_to_bh_sockaddr((struct sockaddr *)&sock_addr, src_addr)
+            == BHT_ERROR) {
+            return -1;
+        }
+    }
+    else if (src_addr) {
+        memset(src_addr, 0, sizeof(*src_addr));
+    }
+
+    return res;
+}
+
+int
+os_io_uring_socket_send_to(bh_socket_t socket, const void *buf,
+                           unsigned int len, int flags,
+                           const bh_sockaddr_t *dest_addr)
+{
+    struct sockaddr_storage sock_addr = { 0 };
+    socklen_t socklen = 0;
+    struct iovec iov = { (void *)buf, len };
+    struct msghdr msg = { 0 };
+    int32 res;
+
+    bh_sockaddr_to_sockaddr(dest_addr, &sock_addr, &socklen);
+
+    msg.msg_name = &sock_addr;
+    msg.msg_namelen = socklen;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    if ((res = submit_msg(IORING_OP_SENDMSG, socket, &msg, flags)) < 0) {
+        errno = -res;
+        return -1;
+    }
+
+    return res;
+}
+
+#endif /* end of OS_ENABLE_IO_URING */
@@ -95,8 +95,6 @@ typedef jmp_buf korp_jmpbuf;
 #define os_longjmp longjmp
 #define os_alloca alloca
 
-#define os_getpagesize getpagesize
-
 typedef void (*os_signal_handler)(void *sig_addr);
 
 int
@@ -119,6 +117,23 @@ os_sigreturn();
 #if WASM_DISABLE_WAKEUP_BLOCKING_OP == 0
 #define OS_ENABLE_WAKEUP_BLOCKING_OP
 #endif
+
+/* Written pages can be tracked with the soft-dirty bits of the page table */
+#define OS_ENABLE_MEM_SOFT_DIRTY
+
+/* Files can be mapped copy-on-write, e.g. to share the AOT code pages */
+#define OS_ENABLE_MMAP_FILE
+
+/* Memory can be mapped twice, e.g. to emit code without a RWX mapping */
+#define OS_ENABLE_MMAP_DUAL
+
+#if WASM_ENABLE_IO_URING != 0
+/* Blocking I/O can be submitted to io_uring */
+#define OS_ENABLE_IO_URING
+#endif
+
+#define os_getpagesize getpagesize
+
 void
 os_set_signal_number_for_blocking_op(int signo);
 
@@ -55,6 +55,10 @@ print_help()
     printf("  --jit-codecache-size=n   Set fast jit maximum code cache size in bytes,\n");
     printf("                           default is %u KB\n", FAST_JIT_DEFAULT_CODE_CACHE_SIZE / 1024);
 #endif
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    printf("  --jit-cache-dir=<dir>    Save the fast jit code of the wasm app to <dir> and\n");
+    printf("                           load it from there instead of compiling it again\n");
+#endif
 #if WASM_ENABLE_JIT != 0
     printf("  --llvm-jit-size-level=n  Set LLVM JIT size level, default is 3\n");
     printf("  --llvm-jit-opt-level=n   Set LLVM JIT optimization level, default is 3\n");
@@ -594,6 +598,9 @@ main(int argc, char *argv[])
 #if WASM_ENABLE_FAST_JIT != 0
     uint32 jit_code_cache_size = FAST_JIT_DEFAULT_CODE_CACHE_SIZE;
 #endif
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    const char *jit_cache_dir = NULL;
+#endif
 #if WASM_ENABLE_JIT != 0
     uint32 llvm_jit_size_level = 3;
     uint32 llvm_jit_opt_level = 3;
@@ -698,6 +705,13 @@ main(int argc, char *argv[])
             jit_code_cache_size = atoi(argv[0] + 21);
         }
 #endif
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+        else if (!strncmp(argv[0], "--jit-cache-dir=", 16)) {
+            if (argv[0][16] == '\0')
+                return print_help();
+            jit_cache_dir = argv[0] + 16;
+        }
+#endif
 #if WASM_ENABLE_JIT != 0
         else if (!strncmp(argv[0], "--llvm-jit-size-level=", 22)) {
             if (argv[0][22] == '\0')
@@ -847,6 +861,9 @@ main(int argc, char *argv[])
 #if WASM_ENABLE_FAST_JIT != 0
     init_args.fast_jit_code_cache_size = jit_code_cache_size;
 #endif
+#if WASM_ENABLE_FAST_JIT_PERSISTENT_CACHE != 0
+    init_args.fast_jit_cache_dir = jit_cache_dir;
+#endif
 
 #if WASM_ENABLE_JIT != 0
     init_args.llvm_jit_size_level = llvm_jit_size_level;
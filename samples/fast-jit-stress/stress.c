@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/*
+ * Load, run with the Fast JIT and unload many modules in a loop, and
+ * check that the memory usage doesn't grow, i.e. that the code cache
+ * memory of the unloaded modules is reclaimed.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wasm_export.h"
+
+/* Modules loaded at the same time */
+#define BATCH_SIZE 100
+/* Allowed growth of the resident memory after the first round */
+#define MAX_RSS_GROWTH_KB 1024
+
+/**
+ * (module
+ *   (func (export "run") (param i32) (result i32)
+ *     local.get 0
+ *     i32.const N
+ *     i32.add))
+ */
+static const uint8_t wasm_template[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, /* magic, version */
+    0x01, 0x06, 0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f, /* type section */
+    0x03, 0x02, 0x01, 0x00,                         /* function section */
+    0x07, 0x07, 0x01, 0x03, 'r',  'u',  'n',  0x00, /* export section */
+    0x00, 0x0a, 0x09, 0x01, 0x07, 0x00, 0x20, 0x00, /* code section */
+    0x41, 0x00, 0x6a, 0x0b,
+};
+
+/* Offset of N in the template, which is a 1-byte signed LEB128 */
+#define CONST_OFFSET 37
+
+static long
+get_rss_kb(void)
+{
+    long size = 0, resident = 0;
+    FILE *file = fopen("/proc/self/statm", "r");
+
+    if (!file)
+        return 0;
+    if (fscanf(file, "%ld %ld", &size, &resident) != 2)
+        resident = 0;
+    fclose(file);
+    return resident * 4;
+}
+
+static bool
+run_batch(uint8_t bufs[BATCH_SIZE][sizeof(wasm_template)], int round)
+{
+    wasm_module_t modules[BATCH_SIZE] = { 0 };
+    wasm_module_inst_t insts[BATCH_SIZE] = { 0 };
+    wasm_exec_env_t exec_env;
+    wasm_function_inst_t func;
+    char error_buf[128];
+    uint32_t argv[1];
+    int32_t n;
+    bool ret = false;
+    int i;
+
+    for (i = 0; i < BATCH_SIZE; i++) {
+        /* Each module adds a different number, the loader may modify the
+           buffer, so copy the template again */
+        n = (round * BATCH_SIZE + i) % 64;
+        memcpy(bufs[i], wasm_template, sizeof(wasm_template));
+        bufs[i][CONST_OFFSET] = (uint8_t)n;
+
+        if (!(modules[i] = wasm_runtime_load(bufs[i], sizeof(wasm_template),
+                                             error_buf, sizeof(error_buf)))) {
+            printf("load module failed: %s\n", error_buf);
+            goto fail;
+        }
+        if (!(insts[i] = wasm_runtime_instantiate(modules[i], 8192, 0,
+                                                  error_buf,
+                                                  sizeof(error_buf)))) {
+            printf("instantiate module failed: %s\n", error_buf);
+            goto fail;
+        }
+        if (!(func = wasm_runtime_lookup_function(insts[i], "run", NULL))
+            || !(exec_env = wasm_runtime_get_exec_env_singleton(insts[i]))) {
+            printf("lookup function failed\n");
+            goto fail;
+        }
+
+        argv[0] = (uint32_t)i;
+        if (!wasm_runtime_call_wasm(exec_env, func, 1, argv)
+            || argv[0] != (uint32_t)(i + n)) {
+            printf("call function failed\n");
+            goto fail;
+        }
+    }
+    ret = true;
+
+fail:
+    for (i = 0; i < BATCH_SIZE; i++) {
+        if (insts[i])
+            wasm_runtime_deinstantiate(insts[i]);
+        if (modules[i])
+            wasm_runtime_unload(modules[i]);
+    }
+    return ret;
+}
+
+int
+main(int argc, char **argv)
+{
+    static uint8_t bufs[BATCH_SIZE][sizeof(wasm_template)];
+    int module_num = argc > 1 ? atoi(argv[1]) : 10000;
+    RuntimeInitArgs init_args;
+    long rss_base = 0, rss;
+    int round, round_num;
+
+    if (module_num < BATCH_SIZE) {
+        printf("Usage: %s [modules (>= %d)]\n", argv[0], BATCH_SIZE);
+        return 1;
+    }
+
+    memset(&init_args, 0, sizeof(init_args));
+    init_args.mem_alloc_type = Alloc_With_System_Allocator;
+    init_args.running_mode = Mode_Fast_JIT;
+    if (!wasm_runtime_full_init(&init_args)) {
+        printf("init runtime failed\n");
+        return 1;
+    }
+
+    round_num = module_num / BATCH_SIZE;
+    for (round = 0; round < round_num; round++) {
+        if (!run_batch(bufs, round)) {
+            wasm_runtime_destroy();
+            return 1;
+        }
+
+        rss = get_rss_kb();
+        if (round == 0)
+            rss_base = rss;
+        if (round % 10 == 0 || round == round_num - 1)
+            printf("%6d modules, rss %ld KB\n", (round + 1) * BATCH_SIZE,
+                   rss);
+    }
+
+    wasm_runtime_destroy();
+
+    if (rss - rss_base > MAX_RSS_GROWTH_KB) {
+        printf("rss grew %ld KB\n", rss - rss_base);
+        return 1;
+    }
+    printf("rss is flat\n");
+    return 0;
+}
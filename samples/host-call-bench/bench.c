@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/*
+ * Measure small host calls from AOT code. The same native is imported
+ * twice: "host_add" is called by the AOT code directly, while
+ * "host_add_attached" has an attachment and so is still called through
+ * aot_invoke_native and wasm_runtime_invoke_native.
+ *
+ * It also measures the calls from the host into the module, in which
+ * run_direct(0) returns at once: "lookup" resolves the function by name
+ * for every call, while "cached" calls wasm_runtime_call_wasm_cached.
+ *
+ *   ./host_call_bench -o host_call.wasm
+ *   wamrc -o host_call.aot host_call.wasm
+ *   ./host_call_bench host_call.aot [calls]
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "wasm_export.h"
+#include "bh_read_file.h"
+
+#define CALL_NUM 10000000
+
+/*
+ * (module
+ *   (import "env" "host_add" (func $direct (param i32 i32) (result i32)))
+ *   (import "env" "host_add_attached"
+ *     (func $shim (param i32 i32) (result i32)))
+ *   (func (export "run_direct") (param $n i32) (result i32)
+ *     (local $acc i32)
+ *     (block
+ *       (loop
+ *         (br_if 1 (i32.eqz (local.get $n)))
+ *         (local.set $acc (call $direct (local.get $acc) (local.get $n)))
+ *         (local.set $n (i32.sub (local.get $n) (i32.const 1)))
+ *         (br 0)))
+ *     (local.get $acc))
+ *   (func (export "run_shim") (param $n i32) (result i32)
+ *     ;; the same as run_direct, but calls $shim
+ *     ...))
+ */
+static uint8_t wasm_file[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x02, 0x28,
+    0x02, 0x03, 0x65, 0x6e, 0x76, 0x08, 0x68, 0x6f, 0x73, 0x74, 0x5f, 0x61,
+    0x64, 0x64, 0x00, 0x00, 0x03, 0x65, 0x6e, 0x76, 0x11, 0x68, 0x6f, 0x73,
+    0x74, 0x5f, 0x61, 0x64, 0x64, 0x5f, 0x61, 0x74, 0x74, 0x61, 0x63, 0x68,
+    0x65, 0x64, 0x00, 0x00, 0x03, 0x03, 0x02, 0x01, 0x01, 0x07, 0x19, 0x02,
+    0x0a, 0x72, 0x75, 0x6e, 0x5f, 0x64, 0x69, 0x72, 0x65, 0x63, 0x74, 0x00,
+    0x02, 0x08, 0x72, 0x75, 0x6e, 0x5f, 0x73, 0x68, 0x69, 0x6d, 0x00, 0x03,
+    0x0a, 0x47, 0x02, 0x22, 0x01, 0x01, 0x7f, 0x02, 0x40, 0x03, 0x40, 0x20,
+    0x00, 0x45, 0x0d, 0x01, 0x20, 0x01, 0x20, 0x00, 0x10, 0x00, 0x21, 0x01,
+    0x20, 0x00, 0x41, 0x01, 0x6b, 0x21, 0x00, 0x0c, 0x00, 0x0b, 0x0b, 0x20,
+    0x01, 0x0b, 0x22, 0x01, 0x01, 0x7f, 0x02, 0x40, 0x03, 0x40, 0x20, 0x00,
+    0x45, 0x0d, 0x01, 0x20, 0x01, 0x20, 0x00, 0x10, 0x01, 0x21, 0x01, 0x20,
+    0x00, 0x41, 0x01, 0x6b, 0x21, 0x00, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x01,
+    0x0b,
+};
+
+static int32_t
+host_add(wasm_exec_env_t exec_env, int32_t a, int32_t b)
+{
+    return a + b;
+}
+
+static int attachment;
+
+static NativeSymbol native_symbols[] = {
+    { "host_add", host_add, "(ii)i", NULL },
+    { "host_add_attached", host_add, "(ii)i", &attachment },
+};
+
+static double
+now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static bool
+run(wasm_module_inst_t module_inst, const char *name, uint32_t call_num)
+{
+    wasm_exec_env_t exec_env;
+    wasm_function_inst_t func;
+    uint32_t argv[1], expected = 0, i;
+    double begin, end;
+
+    if (!(func = wasm_runtime_lookup_function(module_inst, name, NULL))
+        || !(exec_env = wasm_runtime_get_exec_env_singleton(module_inst))) {
+        printf("lookup function %s failed\n", name);
+        return false;
+    }
+
+    for (i = 1; i <= call_num; i++)
+        expected += i;
+
+    argv[0] = call_num;
+    begin = now_ms();
+    if (!wasm_runtime_call_wasm(exec_env, func, 1, argv)) {
+        printf("call %s failed: %s\n", name,
+               wasm_runtime_get_exception(module_inst));
+        return false;
+    }
+    end = now_ms();
+
+    if (argv[0] != expected) {
+        printf("%s returned %u, expected %u\n", name, argv[0], expected);
+        return false;
+    }
+    printf("%-10s %u calls in %.1f ms, %.2f ns/call\n", name, call_num,
+           end - begin, (end - begin) * 1000000.0 / call_num);
+    return true;
+}
+
+static bool
+run_entry(wasm_module_inst_t module_inst, bool cached, uint32_t call_num)
+{
+    wasm_exec_env_t exec_env;
+    wasm_function_inst_t func;
+    wasm_func_cache_t cache = { 0 };
+    uint32_t argv[1], i;
+    const char *name = cached ? "cached" : "lookup";
+    double begin, end;
+    bool ok;
+
+    if (!(exec_env = wasm_runtime_get_exec_env_singleton(module_inst))) {
+        printf("create exec env failed\n");
+        return false;
+    }
+
+    begin = now_ms();
+    for (i = 0; i < call_num; i++) {
+        argv[0] = 0;
+        if (cached) {
+            ok = wasm_runtime_call_wasm_cached(exec_env, &cache, "run_direct",
+                                               1, argv);
+        }
+        else {
+            func = wasm_runtime_lookup_function(module_inst, "run_direct",
+                                                NULL);
+            ok = func && wasm_runtime_call_wasm(exec_env, func, 1, argv);
+        }
+        if (!ok) {
+            printf("call run_direct failed: %s\n",
+                   wasm_runtime_get_exception(module_inst));
+            return false;
+        }
+    }
+    end = now_ms();
+
+    printf("%-10s %u calls in %.1f ms, %.2f ns/call\n", name, call_num,
+           end - begin, (end - begin) * 1000000.0 / call_num);
+    return true;
+}
+
+int
+main(int argc, char **argv)
+{
+    uint8_t *buf = wasm_file;
+    uint32_t size = sizeof(wasm_file), call_num = CALL_NUM;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t module_inst = NULL;
+    RuntimeInitArgs init_args;
+    char error_buf[128];
+    int ret = 1;
+
+    if (argc > 2 && !strcmp(argv[1], "-o")) {
+        FILE *file = fopen(argv[2], "wb");
+
+        if (!file || fwrite(wasm_file, 1, size, file) != size) {
+            printf("write %s failed\n", argv[2]);
+            if (file)
+                fclose(file);
+            return 1;
+        }
+        fclose(file);
+        return 0;
+    }
+
+    memset(&init_args, 0, sizeof(init_args));
+    init_args.mem_alloc_type = Alloc_With_System_Allocator;
+    init_args.native_module_name = "env";
+    init_args.native_symbols = native_symbols;
+    init_args.n_native_symbols =
+        sizeof(native_symbols) / sizeof(native_symbols[0]);
+    if (!wasm_runtime_full_init(&init_args)) {
+        printf("init runtime failed\n");
+        return 1;
+    }
+
+    if (argc > 1) {
+        if (!(buf = (uint8_t *)bh_read_file_to_buffer(argv[1], &size))) {
+            printf("read %s failed\n", argv[1]);
+            goto fail;
+        }
+        if (argc > 2)
+            call_num = (uint32_t)atoi(argv[2]);
+    }
+
+    if (!(module =
+              wasm_runtime_load(buf, size, error_buf, sizeof(error_buf)))) {
+        printf("load module failed: %s\n", error_buf);
+        goto fail;
+    }
+    if (!(module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                                 sizeof(error_buf)))) {
+        printf("instantiate module failed: %s\n", error_buf);
+        goto fail;
+    }
+
+    if (run(module_inst, "run_direct", call_num)
+        && run(module_inst, "run_shim", call_num)
+        && run_entry(module_inst, false, call_num / 10)
+        && run_entry(module_inst, true, call_num / 10))
+        ret = 0;
+
+fail:
+    if (module_inst)
+        wasm_runtime_deinstantiate(module_inst);
+    if (module)
+        wasm_runtime_unload(module);
+    if (buf != wasm_file)
+        BH_FREE(buf);
+    wasm_runtime_destroy();
+    return ret;
+}
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/*
+ * Compare the throughput of the synchronous file and socket functions
+ * used by WASI with their io_uring counterparts, with several threads
+ * doing I/O at the same time like the threads of a wasi-threads module.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include "platform_api_vmcore.h"
+#include "platform_api_extension.h"
+
+#define FILE_SIZE (64 * 1024 * 1024)
+#define BLOCK_SIZE (16 * 1024)
+#define FILE_OPS 20000
+#define SOCKET_CHUNK_SIZE (64 * 1024)
+#define SOCKET_BYTES (256 * 1024 * 1024)
+#define MAX_THREADS 64
+
+typedef enum Mode { MODE_SYNC, MODE_URING, MODE_URING_FIXED } Mode;
+
+static const char *mode_names[] = { "sync", "io_uring", "io_uring fixed" };
+
+typedef struct Worker {
+    pthread_t tid;
+    Mode mode;
+    bool write;
+    int fd;
+    uint8_t *buf;
+    uint32_t seed;
+} Worker;
+
+static int buf_index = -1;
+
+static uint64_t
+now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static void *
+file_worker(void *arg)
+{
+    Worker *worker = (Worker *)arg;
+    struct __wasi_iovec_t iov = { worker->buf, BLOCK_SIZE };
+    int index = worker->mode == MODE_URING_FIXED ? buf_index : -1;
+    __wasi_errno_t error;
+    size_t n;
+    uint64 offset;
+    int i;
+
+    for (i = 0; i < FILE_OPS; i++) {
+        worker->seed = worker->seed * 1103515245 + 12345;
+        offset = (uint64)(worker->seed % (FILE_SIZE / BLOCK_SIZE)) * BLOCK_SIZE;
+
+        if (worker->mode == MODE_SYNC)
+            error = worker->write
+                        ? os_pwritev(worker->fd,
+                                     (const struct __wasi_ciovec_t *)&iov, 1,
+                                     offset, &n)
+                        : os_preadv(worker->fd, &iov, 1, offset, &n);
+        else
+            error = worker->write
+                        ? os_io_uring_writev(
+                            worker->fd, (const struct __wasi_ciovec_t *)&iov,
+                            1, (int64)offset, index, &n)
+                        : os_io_uring_readv(worker->fd, &iov, 1,
+                                            (int64)offset, index, &n);
+
+        if (error != __WASI_ESUCCESS || n != BLOCK_SIZE) {
+            printf("file I/O failed: %d\n", error);
+            exit(1);
+        }
+    }
+    return NULL;
+}
+
+static void
+bench_file(int fd, uint8_t *bufs, int thread_num, bool write, Mode mode)
+{
+    Worker workers[MAX_THREADS];
+    uint64_t start = now_ns(), elapsed;
+    int i;
+
+    for (i = 0; i < thread_num; i++) {
+        workers[i].mode = mode;
+        workers[i].write = write;
+        workers[i].fd = fd;
+        workers[i].buf = bufs + (size_t)i * BLOCK_SIZE;
+        workers[i].seed = (uint32_t)i + 1;
+        pthread_create(&workers[i].tid, NULL, file_worker, &workers[i]);
+    }
+    for (i = 0; i < thread_num; i++)
+        pthread_join(workers[i].tid, NULL);
+
+    elapsed = now_ns() - start;
+    printf("file %-5s %-15s %8.1f MB/s %8.0f ops/s\n",
+           write ? "write" : "read", mode_names[mode],
+           (double)thread_num * FILE_OPS * BLOCK_SIZE * 1000 / elapsed,
+           (double)thread_num * FILE_OPS * 1e9 / elapsed);
+}
+
+static void *
+socket_worker(void *arg)
+{
+    Worker *worker = (Worker *)arg;
+    bh_sockaddr_t addr = { 0 };
+    uint64_t total = 0;
+    int ret;
+
+    addr.is_ipv4 = true;
+    addr.addr_buffer.ipv4 = 0x7f000001;
+
+    while (total < SOCKET_BYTES) {
+        if (worker->write)
+            ret = worker->mode == MODE_SYNC
+                      ? os_socket_send_to(worker->fd, worker->buf,
+                                          SOCKET_CHUNK_SIZE, 0, &addr)
+                      : os_io_uring_socket_send_to(worker->fd, worker->buf,
+                                                   SOCKET_CHUNK_SIZE, 0,
+                                                   &addr);
+        else
+            ret = worker->mode == MODE_SYNC
+                      ? os_socket_recv_from(worker->fd, worker->buf,
+                                            SOCKET_CHUNK_SIZE, 0, &addr)
+                      : os_io_uring_socket_recv_from(worker->fd, worker->buf,
+                                                     SOCKET_CHUNK_SIZE, 0,
+                                                     &addr);
+        if (ret <= 0) {
+            printf("socket I/O failed\n");
+            exit(1);
+        }
+        total += (uint64_t)ret;
+    }
+    return NULL;
+}
+
+static void
+connect_pair(int fds[2])
+{
+    struct sockaddr_in sin = { 0 };
+    socklen_t len = sizeof(sin);
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listener, (struct sockaddr *)&sin, sizeof(sin)) != 0
+        || listen(listener, 1) != 0
+        || getsockname(listener, (struct sockaddr *)&sin, &len) != 0) {
+        printf("listen failed\n");
+        exit(1);
+    }
+
+    fds[0] = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(fds[0], (struct sockaddr *)&sin, sizeof(sin)) != 0
+        || (fds[1] = accept(listener, NULL, NULL)) < 0) {
+        printf("connect failed\n");
+        exit(1);
+    }
+    close(listener);
+}
+
+static void
+bench_socket(uint8_t *bufs, int pair_num, Mode mode)
+{
+    Worker workers[MAX_THREADS];
+    int fds[MAX_THREADS];
+    uint64_t start, elapsed;
+    int i;
+
+    for (i = 0; i < pair_num; i++)
+        connect_pair(fds + i * 2);
+
+    start = now_ns();
+    for (i = 0; i < pair_num * 2; i++) {
+        workers[i].mode = mode;
+        workers[i].write = (i & 1) == 0;
+        workers[i].fd = fds[i];
+        workers[i].buf = bufs + (size_t)i * SOCKET_CHUNK_SIZE;
+        pthread_create(&workers[i].tid, NULL, socket_worker, &workers[i]);
+    }
+    for (i = 0; i < pair_num * 2; i++)
+        pthread_join(workers[i].tid, NULL);
+
+    elapsed = now_ns() - start;
+    printf("socket %-14s %8.1f MB/s\n", mode_names[mode],
+           (double)pair_num * SOCKET_BYTES * 1000 / elapsed);
+
+    for (i = 0; i < pair_num * 2; i++)
+        close(fds[i]);
+}
+
+int
+main(int argc, char **argv)
+{
+    int thread_num = argc > 1 ? atoi(argv[1]) : 4;
+    char path[] = "/tmp/io_uring_bench_XXXXXX";
+    size_t bufs_size;
+    uint8_t *bufs;
+    int fd, i;
+
+    if (thread_num < 1 || thread_num > MAX_THREADS / 2) {
+        printf("Usage: %s [threads (1-%d)]\n", argv[0], MAX_THREADS / 2);
+        return 1;
+    }
+
+    if (os_io_uring_init() != BHT_OK) {
+        printf("io_uring isn't available\n");
+        return 1;
+    }
+
+    /* One buffer for all threads, like a linear memory */
+    bufs_size = (size_t)MAX_THREADS * SOCKET_CHUNK_SIZE;
+    bufs = os_mmap(NULL, bufs_size, MMAP_PROT_READ | MMAP_PROT_WRITE,
+                   MMAP_MAP_NONE, os_get_invalid_handle());
+    if (!bufs) {
+        printf("allocate buffer failed\n");
+        return 1;
+    }
+    memset(bufs, 1, bufs_size);
+    if (os_io_uring_register_buffer(&buf_index, bufs, bufs_size) < 0)
+        printf("register buffer failed, fixed buffer isn't used\n");
+
+    if ((fd = mkstemp(path)) < 0) {
+        printf("create %s failed\n", path);
+        return 1;
+    }
+    unlink(path);
+    for (i = 0; i < FILE_SIZE / SOCKET_CHUNK_SIZE; i++) {
+        if (write(fd, bufs, SOCKET_CHUNK_SIZE) != SOCKET_CHUNK_SIZE) {
+            printf("write %s failed\n", path);
+            return 1;
+        }
+    }
+
+    printf("%d threads\n", thread_num);
+    bench_file(fd, bufs, thread_num, false, MODE_SYNC);
+    bench_file(fd, bufs, thread_num, false, MODE_URING);
+    bench_file(fd, bufs, thread_num, false, MODE_URING_FIXED);
+    bench_file(fd, bufs, thread_num, true, MODE_SYNC);
+    bench_file(fd, bufs, thread_num, true, MODE_URING);
+    bench_file(fd, bufs, thread_num, true, MODE_URING_FIXED);
+    bench_socket(bufs, thread_num, MODE_SYNC);
+    bench_socket(bufs, thread_num, MODE_URING);
+
+    close(fd);
+    os_io_uring_unregister_buffer(buf_index);
+    os_munmap(bufs, bufs_size);
+    os_io_uring_destroy();
+    return 0;
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/*
+ * Measure the average and worst-case latency of mem_allocator_malloc and
+ * mem_allocator_free with allocation patterns which stress the lookup of
+ * the small size classes and of the tree of large free chunks.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mem_alloc.h"
+
+#define POOL_SIZE (128 * 1024 * 1024)
+#define CHUNK_NUM 4096
+
+typedef struct Latency {
+    uint64_t total;
+    uint64_t max;
+    uint32_t count;
+} Latency;
+
+static char pool[POOL_SIZE];
+static void *chunks[CHUNK_NUM];
+static void *separators[CHUNK_NUM];
+
+static uint64_t
+now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static void
+record(Latency *latency, uint64_t start)
+{
+    uint64_t elapsed = now_ns() - start;
+
+    latency->total += elapsed;
+    latency->count++;
+    if (elapsed > latency->max)
+        latency->max = elapsed;
+}
+
+static void *
+timed_malloc(mem_allocator_t allocator, uint32_t size, Latency *latency)
+{
+    uint64_t start = now_ns();
+    void *p = mem_allocator_malloc(allocator, size);
+
+    record(latency, start);
+    if (!p) {
+        printf("malloc %u failed\n", size);
+        exit(1);
+    }
+    return p;
+}
+
+static void
+timed_free(mem_allocator_t allocator, void *p, Latency *latency)
+{
+    uint64_t start = now_ns();
+
+    mem_allocator_free(allocator, p);
+    record(latency, start);
+}
+
+static void
+print_latency(const char *name, const Latency *malloc_latency,
+              const Latency *free_latency)
+{
+    printf("%-24s malloc avg %6.1f ns max %8llu ns, "
+           "free avg %6.1f ns max %8llu ns\n",
+           name, (double)malloc_latency->total / malloc_latency->count,
+           (unsigned long long)malloc_latency->max,
+           (double)free_latency->total / free_latency->count,
+           (unsigned long long)free_latency->max);
+}
+
+/*
+ * Free chunks of increasing sizes which can't be merged, so that the large
+ * free chunks are inserted in sorted order, then allocate the largest ones
+ */
+static void
+bench_sorted_large(void)
+{
+    mem_allocator_t allocator = mem_allocator_create(pool, sizeof(pool));
+    Latency malloc_latency = { 0 }, free_latency = { 0 };
+    uint32_t i;
+
+    for (i = 0; i < CHUNK_NUM; i++) {
+        chunks[i] = timed_malloc(allocator, 256 + i * 8, &malloc_latency);
+        separators[i] = timed_malloc(allocator, 8, &malloc_latency);
+    }
+    for (i = 0; i < CHUNK_NUM; i++)
+        timed_free(allocator, chunks[i], &free_latency);
+    for (i = CHUNK_NUM; i > 0; i--)
+        chunks[i - 1] =
+            timed_malloc(allocator, 256 + (i - 1) * 8, &malloc_latency);
+    for (i = 0; i < CHUNK_NUM; i++) {
+        timed_free(allocator, chunks[i], &free_latency);
+        timed_free(allocator, separators[i], &free_latency);
+    }
+
+    print_latency("sorted large chunks", &malloc_latency, &free_latency);
+    mem_allocator_destroy(allocator);
+}
+
+/*
+ * Only keep free chunks of the largest small size class, so that the
+ * allocations of the smaller classes have to find it
+ */
+static void
+bench_sparse_small(void)
+{
+    mem_allocator_t allocator = mem_allocator_create(pool, sizeof(pool));
+    Latency malloc_latency = { 0 }, free_latency = { 0 };
+    uint32_t i;
+
+    for (i = 0; i < CHUNK_NUM; i++) {
+        chunks[i] = timed_malloc(allocator, 200, &malloc_latency);
+        separators[i] = timed_malloc(allocator, 8, &malloc_latency);
+    }
+    for (i = 0; i < CHUNK_NUM; i++)
+        timed_free(allocator, chunks[i], &free_latency);
+    for (i = 0; i < CHUNK_NUM; i++)
+        chunks[i] = timed_malloc(allocator, 8 + (i % 24) * 8, &malloc_latency);
+    for (i = 0; i < CHUNK_NUM; i++) {
+        timed_free(allocator, chunks[i], &free_latency);
+        timed_free(allocator, separators[i], &free_latency);
+    }
+
+    print_latency("sparse small classes", &malloc_latency, &free_latency);
+    mem_allocator_destroy(allocator);
+}
+
+/* Random sizes and random order, as a libc-heavy guest would do */
+static void
+bench_random(void)
+{
+    mem_allocator_t allocator = mem_allocator_create(pool, sizeof(pool));
+    Latency malloc_latency = { 0 }, free_latency = { 0 };
+    uint32_t i, j, size;
+
+    memset(chunks, 0, sizeof(chunks));
+    srand(1);
+    for (i = 0; i < CHUNK_NUM * 64; i++) {
+        j = (uint32_t)rand() % CHUNK_NUM;
+        if (chunks[j]) {
+            timed_free(allocator, chunks[j], &free_latency);
+            chunks[j] = NULL;
+        }
+        else {
+            size = rand() % 4 ? (uint32_t)rand() % 256 + 1
+                              : (uint32_t)rand() % 4096 + 1;
+            chunks[j] = timed_malloc(allocator, size, &malloc_latency);
+        }
+    }
+    for (i = 0; i < CHUNK_NUM; i++) {
+        if (chunks[i]) {
+            timed_free(allocator, chunks[i], &free_latency);
+            chunks[i] = NULL;
+        }
+    }
+
+    print_latency("random", &malloc_latency, &free_latency);
+    mem_allocator_destroy(allocator);
+}
+
+int
+main(int argc, char **argv)
+{
+    /* Fault the pool in so that page faults aren't measured */
+    memset(pool, 0, sizeof(pool));
+
+    bench_sorted_large();
+    bench_sparse_small();
+    bench_random();
+    return 0;
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/*
+ * Measure small WASI fd_read calls from /dev/zero with several threads
+ * of one instance, which share the file descriptor table like the
+ * threads of a wasi-threads module.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "wasm_export.h"
+
+#define POOL_SIZE (64 * 1024 * 1024)
+#define READ_NUM 1000000
+#define MAX_THREADS 64
+
+/*
+ * (module
+ *   (import "wasi_snapshot_preview1" "fd_read"
+ *     (func $fd_read (param i32 i32 i32 i32) (result i32)))
+ *   (memory (export "memory") 1)
+ *   ;; The auxiliary stack, divided among the spawned threads
+ *   (global $stack_pointer (mut i32) (i32.const 32768))
+ *   (global (export "__data_end") i32 (i32.const 1024))
+ *   (global (export "__heap_base") i32 (i32.const 32768))
+ *   (func (export "run") (param $fd i32) (param $n i32)
+ *     (i32.store (i32.const 0) (i32.const 16))
+ *     (i32.store (i32.const 4) (i32.const 8))
+ *     (block
+ *       (loop
+ *         (br_if 1 (i32.eqz (local.get $n)))
+ *         (drop (call $fd_read (local.get $fd) (i32.const 0)
+ *                              (i32.const 1) (i32.const 8)))
+ *         (local.set $n (i32.sub (local.get $n) (i32.const 1)))
+ *         (br 0))))
+ *   (func (export "_initialize")))
+ */
+static uint8_t wasm_file[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x11, 0x03, 0x60,
+    0x04, 0x7f, 0x7f, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7f, 0x00,
+    0x60, 0x00, 0x00, 0x02, 0x22, 0x01, 0x16, 0x77, 0x61, 0x73, 0x69, 0x5f,
+    0x73, 0x6e, 0x61, 0x70, 0x73, 0x68, 0x6f, 0x74, 0x5f, 0x70, 0x72, 0x65,
+    0x76, 0x69, 0x65, 0x77, 0x31, 0x07, 0x66, 0x64, 0x5f, 0x72, 0x65, 0x61,
+    0x64, 0x00, 0x00, 0x03, 0x03, 0x02, 0x01, 0x02, 0x05, 0x03, 0x01, 0x00,
+    0x01, 0x06, 0x15, 0x03, 0x7f, 0x01, 0x41, 0x80, 0x80, 0x02, 0x0b, 0x7f,
+    0x00, 0x41, 0x80, 0x08, 0x0b, 0x7f, 0x00, 0x41, 0x80, 0x80, 0x02, 0x0b,
+    0x07, 0x39, 0x05, 0x06, 0x6d, 0x65, 0x6d, 0x6f, 0x72, 0x79, 0x02, 0x00,
+    0x03, 0x72, 0x75, 0x6e, 0x00, 0x01, 0x0b, 0x5f, 0x69, 0x6e, 0x69, 0x74,
+    0x69, 0x61, 0x6c, 0x69, 0x7a, 0x65, 0x00, 0x02, 0x0a, 0x5f, 0x5f, 0x64,
+    0x61, 0x74, 0x61, 0x5f, 0x65, 0x6e, 0x64, 0x03, 0x01, 0x0b, 0x5f, 0x5f,
+    0x68, 0x65, 0x61, 0x70, 0x5f, 0x62, 0x61, 0x73, 0x65, 0x03, 0x02, 0x0a,
+    0x34, 0x02, 0x2f, 0x00, 0x41, 0x00, 0x41, 0x10, 0x36, 0x02, 0x00, 0x41,
+    0x04, 0x41, 0x08, 0x36, 0x02, 0x00, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01,
+    0x45, 0x0d, 0x01, 0x20, 0x00, 0x41, 0x00, 0x41, 0x01, 0x41, 0x08, 0x10,
+    0x00, 0x1a, 0x20, 0x01, 0x41, 0x01, 0x6b, 0x21, 0x01, 0x0c, 0x00, 0x0b,
+    0x0b, 0x0b, 0x02, 0x00, 0x0b
+};
+
+static char pool[POOL_SIZE];
+
+typedef struct Worker {
+    pthread_t tid;
+    wasm_exec_env_t exec_env;
+    uint32_t fd;
+} Worker;
+
+static uint64_t
+now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static void *
+run(void *arg)
+{
+    Worker *worker = (Worker *)arg;
+    wasm_module_inst_t module_inst =
+        wasm_runtime_get_module_inst(worker->exec_env);
+    wasm_function_inst_t func;
+    uint32_t argv[2];
+
+    wasm_runtime_init_thread_env();
+
+    if (!(func = wasm_runtime_lookup_function(module_inst, "run", NULL))) {
+        printf("lookup function failed\n");
+        exit(1);
+    }
+
+    argv[0] = worker->fd;
+    argv[1] = READ_NUM;
+    if (!wasm_runtime_call_wasm(worker->exec_env, func, 2, argv)) {
+        printf("call failed: %s\n", wasm_runtime_get_exception(module_inst));
+        exit(1);
+    }
+
+    wasm_runtime_destroy_thread_env();
+    return NULL;
+}
+
+int
+main(int argc, char **argv)
+{
+    int thread_num = argc > 1 ? atoi(argv[1]) : 1;
+    int fd_num = argc > 2 ? atoi(argv[2]) : 3;
+    RuntimeInitArgs init_args;
+    char error_buf[128];
+    wasm_module_t module;
+    wasm_module_inst_t module_inst;
+    wasm_exec_env_t exec_env;
+    Worker workers[MAX_THREADS];
+    uint64_t start, elapsed;
+    int zero_fds[3], i;
+
+    if (thread_num < 1 || thread_num > MAX_THREADS || fd_num < 1
+        || fd_num > 3) {
+        printf("Usage: %s [threads (1-%d)] [fds (1-3)]\n", argv[0],
+               MAX_THREADS);
+        return 1;
+    }
+
+    memset(&init_args, 0, sizeof(init_args));
+    init_args.mem_alloc_type = Alloc_With_Pool;
+    init_args.mem_alloc_option.pool.heap_buf = pool;
+    init_args.mem_alloc_option.pool.heap_size = sizeof(pool);
+    init_args.max_thread_num = MAX_THREADS + 1;
+    if (!wasm_runtime_full_init(&init_args)) {
+        printf("init runtime failed\n");
+        return 1;
+    }
+
+    if (!(module = wasm_runtime_load(wasm_file, sizeof(wasm_file), error_buf,
+                                     sizeof(error_buf)))) {
+        printf("load failed: %s\n", error_buf);
+        return 1;
+    }
+
+    /* Map the stdio of the app to /dev/zero, the threads read from the
+       first fds of them */
+    for (i = 0; i < 3; i++) {
+        if ((zero_fds[i] = open("/dev/zero", O_RDONLY)) < 0) {
+            printf("open /dev/zero failed\n");
+            return 1;
+        }
+    }
+    wasm_runtime_set_wasi_args_ex(module, NULL, 0, NULL, 0, NULL, 0, NULL, 0,
+                                  zero_fds[0], zero_fds[1], zero_fds[2]);
+
+    if (!(module_inst = wasm_runtime_instantiate(module, 64 * 1024, 0,
+                                                 error_buf, sizeof(error_buf)))
+        || !(exec_env = wasm_runtime_create_exec_env(module_inst, 64 * 1024))) {
+        printf("instantiate failed: %s\n", error_buf);
+        return 1;
+    }
+
+    for (i = 0; i < thread_num; i++) {
+        workers[i].fd = (uint32_t)(i % fd_num);
+        if (!(workers[i].exec_env = wasm_runtime_spawn_exec_env(exec_env))) {
+            printf("spawn exec_env failed\n");
+            return 1;
+        }
+    }
+
+    start = now_ns();
+    for (i = 0; i < thread_num; i++)
+        pthread_create(&workers[i].tid, NULL, run, &workers[i]);
+    for (i = 0; i < thread_num; i++)
+        pthread_join(workers[i].tid, NULL);
+    elapsed = now_ns() - start;
+
+    printf("%d threads, %d fds: %.1f ns/read, %.0f reads/s\n", thread_num,
+           fd_num, (double)elapsed / READ_NUM,
+           (double)thread_num * READ_NUM * 1e9 / elapsed);
+
+    for (i = 0; i < thread_num; i++)
+        wasm_runtime_destroy_spawned_exec_env(workers[i].exec_env);
+    wasm_runtime_destroy_exec_env(exec_env);
+    wasm_runtime_deinstantiate(module_inst);
+    for (i = 0; i < 3; i++)
+        close(zero_fds[i]);
+    wasm_runtime_unload(module);
+    wasm_runtime_destroy();
+    return 0;
+}
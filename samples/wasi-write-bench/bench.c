@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/*
+ * Measure the cost of small WASI fd_write calls to /dev/null, which is
+ * dominated by the translation of the iovecs of the app, with several
+ * threads each running its own instance.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "wasm_export.h"
+
+#define POOL_SIZE (64 * 1024 * 1024)
+#define WRITE_NUM 1000000
+#define MAX_THREADS 64
+#define MAX_IOVECS 64
+
+/*
+ * (module
+ *   (import "wasi_snapshot_preview1" "fd_write"
+ *     (func $fd_write (param i32 i32 i32 i32) (result i32)))
+ *   (memory (export "memory") 1)
+ *   (func (export "run") (param $fd i32) (param $n i32) (param $iovcnt i32)
+ *     (block
+ *       (loop
+ *         (br_if 1 (i32.eqz (local.get $n)))
+ *         (drop (call $fd_write (local.get $fd) (i32.const 0)
+ *                               (local.get $iovcnt) (i32.const 1024)))
+ *         (local.set $n (i32.sub (local.get $n) (i32.const 1)))
+ *         (br 0))))
+ *   (func (export "_initialize")))
+ */
+static uint8_t wasm_file[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x12, 0x03, 0x60,
+    0x04, 0x7f, 0x7f, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x03, 0x7f, 0x7f, 0x7f,
+    0x00, 0x60, 0x00, 0x00, 0x02, 0x23, 0x01, 0x16, 0x77, 0x61, 0x73, 0x69,
+    0x5f, 0x73, 0x6e, 0x61, 0x70, 0x73, 0x68, 0x6f, 0x74, 0x5f, 0x70, 0x72,
+    0x65, 0x76, 0x69, 0x65, 0x77, 0x31, 0x08, 0x66, 0x64, 0x5f, 0x77, 0x72,
+    0x69, 0x74, 0x65, 0x00, 0x00, 0x03, 0x03, 0x02, 0x01, 0x02, 0x05, 0x03,
+    0x01, 0x00, 0x01, 0x07, 0x1e, 0x03, 0x06, 0x6d, 0x65, 0x6d, 0x6f, 0x72,
+    0x79, 0x02, 0x00, 0x03, 0x72, 0x75, 0x6e, 0x00, 0x01, 0x0b, 0x5f, 0x69,
+    0x6e, 0x69, 0x74, 0x69, 0x61, 0x6c, 0x69, 0x7a, 0x65, 0x00, 0x02, 0x0a,
+    0x27, 0x02, 0x22, 0x00, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01, 0x45, 0x0d,
+    0x01, 0x20, 0x00, 0x41, 0x00, 0x20, 0x02, 0x41, 0x80, 0x08, 0x10, 0x00,
+    0x1a, 0x20, 0x01, 0x41, 0x01, 0x6b, 0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b,
+    0x0b, 0x02, 0x00, 0x0b
+};
+
+static char pool[POOL_SIZE];
+static wasm_module_t module;
+static uint32_t iovcnt;
+
+static uint64_t
+now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static void *
+run(void *arg)
+{
+    char error_buf[128];
+    wasm_module_inst_t module_inst = NULL;
+    wasm_exec_env_t exec_env = NULL;
+    wasm_function_inst_t func;
+    uint32_t argv[3], *iovecs, i;
+
+    wasm_runtime_init_thread_env();
+
+    if (!(module_inst = wasm_runtime_instantiate(module, 64 * 1024, 0,
+                                                 error_buf, sizeof(error_buf)))
+        || !(exec_env = wasm_runtime_create_exec_env(module_inst, 64 * 1024))
+        || !(func = wasm_runtime_lookup_function(module_inst, "run", NULL))) {
+        printf("instantiate failed: %s\n", error_buf);
+        exit(1);
+    }
+
+    /* The iovecs at offset 0 point to buffers of 8 bytes */
+    iovecs = wasm_runtime_addr_app_to_native(module_inst, 0);
+    for (i = 0; i < iovcnt; i++) {
+        iovecs[i * 2] = 2048 + i * 8;
+        iovecs[i * 2 + 1] = 8;
+    }
+
+    argv[0] = 1;
+    argv[1] = WRITE_NUM;
+    argv[2] = iovcnt;
+    if (!wasm_runtime_call_wasm(exec_env, func, 3, argv)) {
+        printf("call failed: %s\n", wasm_runtime_get_exception(module_inst));
+        exit(1);
+    }
+
+    wasm_runtime_destroy_exec_env(exec_env);
+    wasm_runtime_deinstantiate(module_inst);
+    wasm_runtime_destroy_thread_env();
+    return NULL;
+}
+
+int
+main(int argc, char **argv)
+{
+    int thread_num = argc > 1 ? atoi(argv[1]) : 1;
+    RuntimeInitArgs init_args;
+    char error_buf[128];
+    pthread_t tids[MAX_THREADS];
+    uint64_t start, elapsed;
+    int null_fd, i;
+
+    iovcnt = argc > 2 ? (uint32_t)atoi(argv[2]) : 1;
+    if (thread_num < 1 || thread_num > MAX_THREADS || iovcnt < 1
+        || iovcnt > MAX_IOVECS) {
+        printf("Usage: %s [threads (1-%d)] [iovecs (1-%d)]\n", argv[0],
+               MAX_THREADS, MAX_IOVECS);
+        return 1;
+    }
+
+    memset(&init_args, 0, sizeof(init_args));
+    init_args.mem_alloc_type = Alloc_With_Pool;
+    init_args.mem_alloc_option.pool.heap_buf = pool;
+    init_args.mem_alloc_option.pool.heap_size = sizeof(pool);
+    if (!wasm_runtime_full_init(&init_args)) {
+        printf("init runtime failed\n");
+        return 1;
+    }
+
+    if (!(module = wasm_runtime_load(wasm_file, sizeof(wasm_file), error_buf,
+                                     sizeof(error_buf)))) {
+        printf("load failed: %s\n", error_buf);
+        return 1;
+    }
+
+    if ((null_fd = open("/dev/null", O_WRONLY)) < 0) {
+        printf("open /dev/null failed\n");
+        return 1;
+    }
+    wasm_runtime_set_wasi_args_ex(module, NULL, 0, NULL, 0, NULL, 0, NULL, 0,
+                                  -1, null_fd, -1);
+
+    start = now_ns();
+    for (i = 0; i < thread_num; i++)
+        pthread_create(&tids[i], NULL, run, NULL);
+    for (i = 0; i < thread_num; i++)
+        pthread_join(tids[i], NULL);
+    elapsed = now_ns() - start;
+
+    printf("%d threads, %u iovecs: %.1f ns/write, %.0f writes/s\n", thread_num,
+           iovcnt, (double)elapsed / WRITE_NUM,
+           (double)thread_num * WRITE_NUM * 1e9 / elapsed);
+
+    close(null_fd);
+    wasm_runtime_unload(module);
+    wasm_runtime_destroy();
+    return 0;
+}
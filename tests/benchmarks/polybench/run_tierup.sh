@@ -0,0 +1,70 @@
+#!/bin/bash
+
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+CUR_DIR=$PWD
+OUT_DIR=$CUR_DIR/out
+REPORT=$CUR_DIR/report.txt
+TIME=/usr/bin/time
+LOG=$CUR_DIR/tierup.log
+
+PLATFORM=$(uname -s | tr A-Z a-z)
+IWASM_CMD=$CUR_DIR/../../../product-mini/platforms/${PLATFORM}/build/iwasm
+
+BENCH_NAME_MAX_LEN=20
+
+POLYBENCH_CASES="2mm 3mm adi atax bicg cholesky correlation covariance \
+                 deriche doitgen durbin fdtd-2d floyd-warshall gemm gemver \
+                 gesummv gramschmidt heat-3d jacobi-1d jacobi-2d ludcmp lu \
+                 mvt nussinov seidel-2d symm syr2k syrk trisolv trmm"
+
+rm -f $REPORT
+touch $REPORT
+
+function print_bench_name()
+{
+    name=$1
+    echo -en "$name" >> $REPORT
+    name_len=${#name}
+    if [ $name_len -lt $BENCH_NAME_MAX_LEN ]
+    then
+        spaces=$(( $BENCH_NAME_MAX_LEN - $name_len ))
+        for i in $(eval echo "{1..$spaces}"); do echo -n " " >> $REPORT; done
+    fi
+}
+
+echo "Start to run cases, the result is written to report.txt"
+echo "The tier-up time is the time when the multi-tier jit promotes its last"
+echo "hot function to llvm jit, iwasm should be built with"
+echo "cmake -DWAMR_BUILD_FAST_JIT=1 -DWAMR_BUILD_JIT=1 -DWAMR_BUILD_LAZY_JIT=1"
+
+#run benchmarks
+cd $OUT_DIR
+echo -en "\t\t\t\t\t  fast-jit\tllvm-jit\tmulti-tier\ttier-up\n" >> $REPORT
+
+for t in $POLYBENCH_CASES
+do
+    print_bench_name $t
+
+    echo "run $t with iwasm fast jit .."
+    echo -en "\t" >> $REPORT
+    $TIME -f "real-%e-time" $IWASM_CMD --fast-jit ${t}.wasm 2>&1 | grep "real-.*-time" | awk -F '-' '{ORS=""; print $2}' >> $REPORT
+
+    echo "run $t with iwasm llvm jit .."
+    echo -en "\t\t" >> $REPORT
+    $TIME -f "real-%e-time" $IWASM_CMD --llvm-jit ${t}.wasm 2>&1 | grep "real-.*-time" | awk -F '-' '{ORS=""; print $2}' >> $REPORT
+
+    echo "run $t with iwasm multi-tier jit .."
+    echo -en "\t\t" >> $REPORT
+    $TIME -f "real-%e-time" $IWASM_CMD --multi-tier-jit -v=4 ${t}.wasm > $LOG 2>&1
+    grep "real-.*-time" $LOG | awk -F '-' '{ORS=""; print $2}' >> $REPORT
+
+    # the time in seconds when the last hot function was promoted
+    echo -en "\t\t" >> $REPORT
+    grep "promoted llvm jit func" $LOG | awk '{ms = $(NF - 1)} END {ORS=""; printf "%.2f", ms / 1000}' >> $REPORT
+
+    echo -en "\n" >> $REPORT
+done
+
+rm -f $LOG
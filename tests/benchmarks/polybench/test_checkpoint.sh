@@ -0,0 +1,90 @@
+#!/bin/bash
+
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# Compare the overhead of the AOT loop checkpoint modes. The checkpointed
+# files trap at their safepoints, so IWASM_CMD must point to a runtime built
+# with -DWAMR_BUILD_CHECKPOINT_RESTORE=1 which handles the trap.
+
+CUR_DIR=$PWD
+OUT_DIR=$CUR_DIR/out
+REPORT=$CUR_DIR/report.txt
+TIME=/usr/bin/time
+
+PLATFORM=$(uname -s | tr A-Z a-z)
+IWASM_CMD=${IWASM_CMD:-"$CUR_DIR/../../../product-mini/platforms/${PLATFORM}/build/iwasm"}
+WAMRC_CMD=${WAMRC_CMD:-"$CUR_DIR/../../../wamr-compiler/build/wamrc"}
+
+BENCH_NAME_MAX_LEN=20
+
+POLYBENCH_CASES="2mm 3mm adi atax bicg cholesky correlation covariance \
+                 deriche doitgen durbin fdtd-2d floyd-warshall gemm gemver \
+                 gesummv gramschmidt heat-3d jacobi-1d jacobi-2d ludcmp lu \
+                 mvt nussinov seidel-2d symm syr2k syrk trisolv trmm"
+
+rm -f $REPORT
+touch $REPORT
+
+function print_bench_name()
+{
+    name=$1
+    echo -en "$name" >> $REPORT
+    name_len=${#name}
+    if [ $name_len -lt $BENCH_NAME_MAX_LEN ]
+    then
+        spaces=$(( $BENCH_NAME_MAX_LEN - $name_len ))
+        for i in $(eval echo "{1..$spaces}"); do echo -n " " >> $REPORT; done
+    fi
+}
+
+function run_case()
+{
+    echo -en "\t" >> $REPORT
+    $TIME -f "real-%e-time" $IWASM_CMD $1 2>&1 | grep "real-.*-time" | awk -F '-' '{ORS=""; print $2}' >> $REPORT
+}
+
+pushd $OUT_DIR > /dev/null 2>&1
+for t in $POLYBENCH_CASES
+do
+    if [ ! -e "${t}.wasm" ]; then
+        echo "${t}.wasm doesn't exist, please run build.sh first"
+        exit
+    fi
+
+    echo ""
+    echo "Compile ${t}.wasm to ${t}.aot .."
+    ${WAMRC_CMD} -o ${t}.aot ${t}.wasm
+
+    echo ""
+    echo "Compile ${t}.wasm to ${t}_loop_ckpt.aot .."
+    ${WAMRC_CMD} --enable-loop-checkpoint -o ${t}_loop_ckpt.aot ${t}.wasm
+
+    echo ""
+    echo "Compile ${t}.wasm to ${t}_counter_ckpt.aot .."
+    ${WAMRC_CMD} --enable-counter-loop-checkpoint \
+            -o ${t}_counter_ckpt.aot ${t}.wasm
+done
+popd > /dev/null 2>&1
+
+echo "Start to run cases, the result is written to report.txt"
+
+#run benchmarks
+cd $OUT_DIR
+echo -en "\t\t\t\t\t  iwasm-aot\tloop-ckpt\tcounter-ckpt\n" >> $REPORT
+
+for t in $POLYBENCH_CASES
+do
+    print_bench_name $t
+
+    echo "run $t with iwasm aot .."
+    run_case ${t}.aot
+
+    echo "run $t with iwasm aot loop checkpoint .."
+    run_case ${t}_loop_ckpt.aot
+
+    echo "run $t with iwasm aot counter loop checkpoint .."
+    run_case ${t}_counter_ckpt.aot
+
+    echo -en "\n" >> $REPORT
+done
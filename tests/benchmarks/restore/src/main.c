@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/*
+ * Measure the latency of wasm_runtime_restore_threads against the number
+ * of threads: every thread rebuilds its exec_env and a call chain of
+ * FRAME_NUM frames in parallel, then all are released at once.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "wasm_export.h"
+#include "bh_read_file.h"
+
+#define MAX_THREAD_NUM 64
+#define FRAME_NUM 16
+#define REPEAT_NUM 10
+
+static uint64
+time_now_us()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64)ts.tv_sec * 1000000 + (uint64)ts.tv_nsec / 1000;
+}
+
+static void *
+resume_cb(wasm_exec_env_t exec_env, void *arg)
+{
+    /* The restored frames are released with the exec_env */
+    (void)exec_env;
+    (void)arg;
+    return NULL;
+}
+
+/* Restore thread_num threads and get the latency in us */
+static bool
+restore_once(wasm_module_t module, uint32 thread_num, uint32 func_index,
+             uint32 stack_size, uint32 heap_size, uint64 *p_latency)
+{
+    wasm_thread_restore_info_t infos[MAX_THREAD_NUM];
+    wasm_restore_frame_t frames[FRAME_NUM];
+    wasm_module_inst_t module_inst, thread_insts[MAX_THREAD_NUM];
+    wasm_exec_env_t exec_env;
+    uint32 i, inst_num = 0;
+    uint64 begin;
+    bool ret = false;
+    char error_buf[128];
+
+    if (!(module_inst = wasm_runtime_instantiate(
+              module, stack_size, heap_size, error_buf, sizeof(error_buf)))) {
+        printf("%s\n", error_buf);
+        return false;
+    }
+    if (!(exec_env = wasm_runtime_create_exec_env(module_inst, stack_size))) {
+        printf("failed to create exec_env\n");
+        goto fail1;
+    }
+
+    memset(frames, 0, sizeof(frames));
+    for (i = 0; i < FRAME_NUM; i++)
+        frames[i].func_index = func_index;
+
+    /* Instantiating isn't part of the restore */
+    memset(infos, 0, sizeof(infos));
+    for (inst_num = 0; inst_num < thread_num; inst_num++) {
+        if (!(thread_insts[inst_num] = wasm_runtime_instantiate(
+                  module, stack_size, heap_size, error_buf,
+                  sizeof(error_buf)))) {
+            printf("%s\n", error_buf);
+            goto fail2;
+        }
+        infos[inst_num].module_inst = thread_insts[inst_num];
+        infos[inst_num].handle = inst_num + 1;
+        infos[inst_num].frames = frames;
+        infos[inst_num].frame_count = FRAME_NUM;
+        infos[inst_num].callback = resume_cb;
+    }
+
+    begin = time_now_us();
+    if (wasm_runtime_restore_threads(exec_env, infos, thread_num) != 0) {
+        printf("failed to restore threads: %s\n",
+               wasm_runtime_get_exception(module_inst));
+        goto fail2;
+    }
+    *p_latency = time_now_us() - begin;
+    /* The restored threads own their instances now */
+    inst_num = 0;
+    ret = true;
+
+fail2:
+    for (i = 0; i < inst_num; i++)
+        wasm_runtime_deinstantiate(thread_insts[i]);
+    /* Wait for the restored threads to exit */
+    wasm_runtime_destroy_exec_env(exec_env);
+fail1:
+    wasm_runtime_deinstantiate(module_inst);
+    return ret;
+}
+
+int
+main(int argc, char *argv[])
+{
+    char *aot_file;
+    uint8 *aot_file_buf = NULL;
+    uint32 aot_file_size, func_index = 0, thread_num, i;
+    uint32 stack_size = 64 * 1024, heap_size = 64 * 1024;
+    uint64 latency, min_latency, total_latency;
+    wasm_module_t module = NULL;
+    RuntimeInitArgs init_args;
+    char error_buf[128] = { 0 };
+    int ret = -1;
+
+    if (argc < 2) {
+        printf("Usage: %s <aot file> [func index of the frames]\n", argv[0]);
+        return -1;
+    }
+    aot_file = argv[1];
+    if (argc > 2)
+        func_index = (uint32)atoi(argv[2]);
+
+    memset(&init_args, 0, sizeof(RuntimeInitArgs));
+    init_args.mem_alloc_type = Alloc_With_Allocator;
+    init_args.mem_alloc_option.allocator.malloc_func = malloc;
+    init_args.mem_alloc_option.allocator.realloc_func = realloc;
+    init_args.mem_alloc_option.allocator.free_func = free;
+    init_args.max_thread_num = MAX_THREAD_NUM;
+
+    if (!wasm_runtime_full_init(&init_args)) {
+        printf("Init runtime environment failed.\n");
+        return -1;
+    }
+
+    if (!(aot_file_buf =
+              (uint8 *)bh_read_file_to_buffer(aot_file, &aot_file_size)))
+        goto fail1;
+
+    if (!(module = wasm_runtime_load(aot_file_buf, aot_file_size, error_buf,
+                                     sizeof(error_buf)))) {
+        printf("%s\n", error_buf);
+        goto fail2;
+    }
+
+    printf("threads\tmin(us)\tavg(us)\n");
+    for (thread_num = 1; thread_num <= MAX_THREAD_NUM; thread_num *= 2) {
+        min_latency = UINT64_MAX;
+        total_latency = 0;
+        for (i = 0; i < REPEAT_NUM; i++) {
+            if (!restore_once(module, thread_num, func_index, stack_size,
+                              heap_size, &latency))
+                goto fail3;
+            if (latency < min_latency)
+                min_latency = latency;
+            total_latency += latency;
+        }
+        printf("%u\t%llu\t%llu\n", thread_num,
+               (unsigned long long)min_latency,
+               (unsigned long long)(total_latency / REPEAT_NUM));
+    }
+    ret = 0;
+
+fail3:
+    wasm_runtime_unload(module);
+fail2:
+    wasm_runtime_free(aot_file_buf);
+fail1:
+    wasm_runtime_destroy();
+    return ret;
+}
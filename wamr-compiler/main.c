@@ -126,6 +126,9 @@ print_help()
     printf("                            Use --cpu-features=+help to list all the features supported\n");
     printf("  --opt-level=n             Set the optimization level (0 to 3, default is 3)\n");
     printf("  --size-level=n            Set the code size level (0 to 3, default is 3)\n");
+    printf("  --threads=n               Compile with n threads when generating AoT file, the functions are\n");
+    printf("                              split into partitions by the module size and each partition is\n");
+    printf("                              compiled separately, the result doesn't depend on n\n");
     printf("  -sgx                      Generate code for SGX platform (Intel Software Guard Extensions)\n");
     printf("  --bounds-checks=1/0       Enable or disable the bounds checks for memory access:\n");
     printf("                              by default it is disabled in all 64-bit platforms except SGX and\n");
@@ -393,6 +396,11 @@ main(int argc, char *argv[])
                 option.size_level = 3;
             size_level_set = true;
         }
+        else if (!strncmp(argv[0], "--threads=", 10)) {
+            if (argv[0][10] == '\0')
+                PRINT_HELP_AND_EXIT();
+            option.thread_num = (uint32)atoi(argv[0] + 10);
+        }
         else if (!strcmp(argv[0], "-sgx")) {
             sgx_mode = true;
         }